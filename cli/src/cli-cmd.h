@@ -62,6 +62,9 @@ struct cli_cmd_volume_get_ctx_ {
         int             flags;
 };
 
+/* latency percentiles reported by io-stats for each fop */
+#define CLI_PROFILE_PCT_MAX 4
+
 typedef struct cli_profile_info_ {
         uint64_t fop_hits;
         double min_latency;
@@ -69,6 +72,7 @@ typedef struct cli_profile_info_ {
         double avg_latency;
         char   *fop_name;
         double percentage_avg_latency;
+        double pct_latency[CLI_PROFILE_PCT_MAX];
 } cli_profile_info_t;
 
 typedef struct addrinfo_list {
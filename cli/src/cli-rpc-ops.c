@@ -58,6 +58,9 @@ extern rpc_clnt_prog_t *cli_rpc_prog;
 extern int              cli_op_ret;
 extern int              connected;
 
+static char *cli_profile_pct_name[CLI_PROFILE_PCT_MAX] = {"p50", "p90",
+                                                          "p99", "p999"};
+
 char *cli_volume_type[] = {"Distribute",
                            "Stripe",
                            "Replicate",
@@ -3708,6 +3711,63 @@ cli_profile_info_percentage_cmp (void *a, void *b)
 }
 
 
+static void
+cmd_profile_volume_clients_out (dict_t *dict, int count, int interval)
+{
+        char                    key[256] = {0};
+        char                   *id = NULL;
+        int32_t                 clients = 0;
+        uint64_t                hits = 0;
+        double                  pct[CLI_PROFILE_PCT_MAX] = {0};
+        int                     c = 0;
+        int                     i = 0;
+        int                     p = 0;
+        int                     ret = 0;
+
+        snprintf (key, sizeof (key), "%d-%d-client-count", count, interval);
+        ret = dict_get_int32 (dict, key, &clients);
+        if (ret || !clients)
+                return;
+
+        for (c = 1; c <= clients; c++) {
+                snprintf (key, sizeof (key), "%d-%d-client-%d-id", count,
+                          interval, c);
+                ret = dict_get_str (dict, key, &id);
+                if (ret)
+                        continue;
+
+                cli_out (" ");
+                cli_out ("Client: %s", id);
+                cli_out ("%14s %13s %13s %13s %13s %11s", "No. of calls",
+                         "P50-Latency", "P90-Latency", "P99-Latency",
+                         "P99.9-Latency", "Fop");
+                cli_out ("%14s %13s %13s %13s %13s %11s", "------------",
+                         "-----------", "-----------", "-----------",
+                         "-------------", "----");
+
+                for (i = 0; i < GF_FOP_MAXVALUE; i++) {
+                        snprintf (key, sizeof (key), "%d-%d-client-%d-%d-hits",
+                                  count, interval, c, i);
+                        ret = dict_get_uint64 (dict, key, &hits);
+                        if (ret || !hits)
+                                continue;
+
+                        for (p = 0; p < CLI_PROFILE_PCT_MAX; p++) {
+                                pct[p] = 0;
+                                snprintf (key, sizeof (key),
+                                          "%d-%d-client-%d-%d-%slatency",
+                                          count, interval, c, i,
+                                          cli_profile_pct_name[p]);
+                                ret = dict_get_double (dict, key, &pct[p]);
+                        }
+
+                        cli_out ("%14"PRId64" %10.2lf us %10.2lf us "
+                                 "%10.2lf us %10.2lf us %11s", hits, pct[0],
+                                 pct[1], pct[2], pct[3], gf_fop_list[i]);
+                }
+        }
+}
+
 void
 cmd_profile_volume_brick_out (dict_t *dict, int count, int interval)
 {
@@ -3726,6 +3786,8 @@ cmd_profile_volume_brick_out (dict_t *dict, int count, int interval)
         int                     index = 0;
         int                     is_header_printed = 0;
         int                     ret = 0;
+        int                     p = 0;
+        int                     has_pct = 0;
         double                  total_percentage_latency = 0;
 
         for (i = 0; i < 32; i++) {
@@ -3764,6 +3826,16 @@ cmd_profile_volume_brick_out (dict_t *dict, int count, int interval)
                 ret = dict_get_double (dict, key, &profile_info[i].max_latency);
                 profile_info[i].fop_name = gf_fop_list[i];
 
+                for (p = 0; p < CLI_PROFILE_PCT_MAX; p++) {
+                        memset (key, 0, sizeof (key));
+                        snprintf (key, sizeof (key), "%d-%d-%d-%slatency",
+                                  count, interval, i, cli_profile_pct_name[p]);
+                        ret = dict_get_double (dict, key,
+                                               &profile_info[i].pct_latency[p]);
+                        if (!ret)
+                                has_pct = 1;
+                }
+
                 total_percentage_latency +=
                        (profile_info[i].fop_hits * profile_info[i].avg_latency);
         }
@@ -3866,6 +3938,28 @@ cmd_profile_volume_brick_out (dict_t *dict, int count, int interval)
                                  profile_info[i].fop_name);
                 }
         }
+        if (has_pct) {
+                cli_out (" ");
+                cli_out ("%13s %13s %13s %13s %11s", "P50-Latency",
+                         "P90-Latency", "P99-Latency", "P99.9-Latency", "Fop");
+                cli_out ("%13s %13s %13s %13s %11s", "-----------",
+                         "-----------", "-----------", "-------------",
+                         "----");
+                for (i = 0; i < GF_FOP_MAXVALUE; i++) {
+                        if (profile_info[i].fop_hits == 0 ||
+                            profile_info[i].pct_latency[0] == 0)
+                                continue;
+                        cli_out ("%10.2lf us %10.2lf us %10.2lf us "
+                                 "%10.2lf us %11s",
+                                 profile_info[i].pct_latency[0],
+                                 profile_info[i].pct_latency[1],
+                                 profile_info[i].pct_latency[2],
+                                 profile_info[i].pct_latency[3],
+                                 profile_info[i].fop_name);
+                }
+        }
+        if (interval == -1)
+                cmd_profile_volume_clients_out (dict, count, interval);
         cli_out (" ");
         cli_out ("%12s: %"PRId64" seconds", "Duration", sec);
         cli_out ("%12s: %"PRId64" bytes", "Data Read", r_count);
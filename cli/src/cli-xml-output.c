@@ -19,6 +19,7 @@
 
 #include <stdlib.h>
 #include "cli.h"
+#include "cli-cmd.h"
 #include "cli1-xdr.h"
 #include "run.h"
 #include "compat.h"
@@ -1722,11 +1723,16 @@ cli_xml_output_vol_profile_stats (xmlTextWriterPtr writer, dict_t *dict,
         double                  avg_latency = 0.0;
         double                  max_latency = 0.0;
         double                  min_latency = 0.0;
+        double                  pct_latency = 0.0;
         uint64_t                duration = 0;
         uint64_t                total_read = 0;
         uint64_t                total_write = 0;
         char                    key[1024] = {0};
+        char                    elem[32] = {0};
         int                     i = 0;
+        int                     p = 0;
+        char                   *pct_name[CLI_PROFILE_PCT_MAX] = {"p50", "p90",
+                                                                "p99", "p999"};
 
         /* <cumulativeStats> || <intervalStats> */
         if (interval == -1)
@@ -1836,6 +1842,18 @@ cli_xml_output_vol_profile_stats (xmlTextWriterPtr writer, dict_t *dict,
                         (writer, (xmlChar *)"maxLatency", "%f", max_latency);
                 XML_RET_CHECK_AND_GOTO (ret, out);
 
+                for (p = 0; p < CLI_PROFILE_PCT_MAX; p++) {
+                        snprintf (key, sizeof (key), "%d-%d-%d-%slatency",
+                                  brick_index, interval, i, pct_name[p]);
+                        if (dict_get_double (dict, key, &pct_latency))
+                                continue;
+                        snprintf (elem, sizeof (elem), "%sLatency",
+                                  pct_name[p]);
+                        ret = xmlTextWriterWriteFormatElement
+                                (writer, (xmlChar *)elem, "%f", pct_latency);
+                        XML_RET_CHECK_AND_GOTO (ret, out);
+                }
+
                 /* </fop> */
                 ret = xmlTextWriterEndElement (writer);
                 XML_RET_CHECK_AND_GOTO (ret, out);
@@ -0,0 +1,189 @@
+/*
+  Copyright (c) 2012 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+/*
+ * cdc-bm: what features/cdc does to a 1MB payload, i.e. raw deflate in
+ * independent 64KB chunks, for the zlib levels it accepts.  Reports the
+ * ratio and the single-thread compress and decompress rates, to weigh
+ * against the link speed: compression only helps if it is faster than
+ * the wire.
+ *
+ *   gcc -O2 extras/benchmarking/cdc-bm.c -lz -o cdc-bm
+ *
+ *   ./cdc-bm [file]
+ *
+ * Without a file the payload is text-like (repeated words with numbers),
+ * with one its first 1MB is used.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <zlib.h>
+
+#define PAYLOAD_SIZE (1024 * 1024)
+#define CHUNK_SIZE   (64 * 1024)
+#define ROUNDS       20
+
+static char in[PAYLOAD_SIZE];
+static char out[PAYLOAD_SIZE + 4096];
+static char back[PAYLOAD_SIZE];
+static unsigned int lens[PAYLOAD_SIZE / CHUNK_SIZE];
+
+
+static double
+now_usec (void)
+{
+        struct timeval tv = {0, };
+
+        gettimeofday (&tv, NULL);
+        return (tv.tv_sec * 1e6) + tv.tv_usec;
+}
+
+
+static size_t
+fill (const char *path)
+{
+        FILE   *fp  = NULL;
+        size_t  len = 0;
+        int     i   = 0;
+
+        if (path) {
+                fp = fopen (path, "r");
+                if (!fp)
+                        return 0;
+                len = fread (in, 1, sizeof (in), fp);
+                fclose (fp);
+                return len;
+        }
+
+        for (i = 0; len + 64 < sizeof (in); i++)
+                len += snprintf (in + len, 64, "block %d of file-%d written "
+                                 "at offset %zu\n", i, i % 97, len);
+
+        return len;
+}
+
+
+static size_t
+compress_once (z_stream *zs, size_t size)
+{
+        size_t pos = 0;
+        size_t off = 0;
+        size_t len = 0;
+        int    i   = 0;
+
+        for (off = 0; off < size; off += CHUNK_SIZE, i++) {
+                len = (size - off < CHUNK_SIZE) ? size - off : CHUNK_SIZE;
+
+                deflateReset (zs);
+                zs->next_in = (Bytef *) in + off;
+                zs->avail_in = len;
+                zs->next_out = (Bytef *) out + pos;
+                zs->avail_out = len - (len >> 3);
+
+                if (deflate (zs, Z_FINISH) == Z_STREAM_END) {
+                        lens[i] = zs->total_out;
+                } else {
+                        memcpy (out + pos, in + off, len);
+                        lens[i] = len;
+                }
+                pos += lens[i];
+        }
+
+        return pos;
+}
+
+
+static int
+decompress_once (z_stream *zs, size_t size)
+{
+        size_t pos = 0;
+        size_t off = 0;
+        size_t len = 0;
+        int    i   = 0;
+
+        for (off = 0; off < size; off += CHUNK_SIZE, i++) {
+                len = (size - off < CHUNK_SIZE) ? size - off : CHUNK_SIZE;
+
+                if (lens[i] == len) {
+                        memcpy (back + off, out + pos, len);
+                } else {
+                        inflateReset (zs);
+                        zs->next_in = (Bytef *) out + pos;
+                        zs->avail_in = lens[i];
+                        zs->next_out = (Bytef *) back + off;
+                        zs->avail_out = len;
+                        if (inflate (zs, Z_FINISH) != Z_STREAM_END)
+                                return -1;
+                }
+                pos += lens[i];
+        }
+
+        return memcmp (in, back, size) ? -1 : 0;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+        z_stream def   = {0, };
+        z_stream inf   = {0, };
+        size_t   size  = 0;
+        size_t   clen  = 0;
+        double   start = 0;
+        double   ctime = 0;
+        double   dtime = 0;
+        int      level = 0;
+        int      n     = 0;
+
+        size = fill (argc > 1 ? argv[1] : NULL);
+        if (!size) {
+                fprintf (stderr, "no payload\n");
+                return 1;
+        }
+
+        if (inflateInit2 (&inf, -15) != Z_OK)
+                return 1;
+
+        printf ("%6s %8s %12s %12s\n", "level", "ratio", "comp MB/s",
+                "decomp MB/s");
+        for (level = 1; level <= 9; level++) {
+                if (deflateInit2 (&def, level, Z_DEFLATED, -15, 8,
+                                  Z_DEFAULT_STRATEGY) != Z_OK)
+                        return 1;
+
+                start = now_usec ();
+                for (n = 0; n < ROUNDS; n++)
+                        clen = compress_once (&def, size);
+                ctime = now_usec () - start;
+
+                start = now_usec ();
+                for (n = 0; n < ROUNDS; n++) {
+                        if (decompress_once (&inf, size)) {
+                                fprintf (stderr, "round trip failed\n");
+                                return 1;
+                        }
+                }
+                dtime = now_usec () - start;
+
+                printf ("%6d %8.2f %12.1f %12.1f\n", level,
+                        (double) size / clen,
+                        (double) size * ROUNDS / ctime,
+                        (double) size * ROUNDS / dtime);
+
+                deflateEnd (&def);
+        }
+
+        inflateEnd (&inf);
+
+        return 0;
+}
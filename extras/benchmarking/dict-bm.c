@@ -0,0 +1,145 @@
+/*
+  Copyright (c) 2012 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+/*
+ * dict-bm: time the dict_t life cycle seen on the fop path, i.e. build a
+ * dict of N xattr-like keys, look every key up, serialize it, unserialize
+ * it and destroy both, for N = 1 .. 64.
+ *
+ * Build from a configured source tree, against the installed library:
+ *
+ *   gcc -DHAVE_CONFIG_H -D_GNU_SOURCE -I. -Ilibglusterfs/src \
+ *       -Icontrib/uuid extras/benchmarking/dict-bm.c -lglusterfs \
+ *       -lpthread -o dict-bm
+ *
+ *   ./dict-bm [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "glusterfs.h"
+#include "globals.h"
+#include "dict.h"
+#include "mem-pool.h"
+
+#define MAX_KEYS 64
+
+static char keys[MAX_KEYS][64];
+
+
+static double
+now_usec (void)
+{
+        struct timeval tv = {0, };
+
+        gettimeofday (&tv, NULL);
+        return (tv.tv_sec * 1e6) + tv.tv_usec;
+}
+
+
+static int
+run_once (int nkeys)
+{
+        dict_t  *dict  = NULL;
+        dict_t  *copy  = NULL;
+        char    *buf   = NULL;
+        size_t   len   = 0;
+        uint64_t val   = 0;
+        int      i     = 0;
+        int      ret   = -1;
+
+        dict = dict_new ();
+        if (!dict)
+                goto out;
+
+        for (i = 0; i < nkeys; i++) {
+                if (dict_set_uint64 (dict, keys[i], i))
+                        goto out;
+        }
+
+        for (i = 0; i < nkeys; i++) {
+                if (dict_get_uint64 (dict, keys[i], &val) || val != i)
+                        goto out;
+        }
+
+        if (dict_allocate_and_serialize (dict, &buf, &len))
+                goto out;
+
+        copy = dict_new ();
+        if (!copy || dict_unserialize (buf, len, &copy))
+                goto out;
+
+        for (i = 0; i < nkeys; i++) {
+                if (!dict_get (copy, keys[i]))
+                        goto out;
+        }
+
+        ret = 0;
+out:
+        if (copy)
+                dict_unref (copy);
+        if (dict)
+                dict_unref (dict);
+        GF_FREE (buf);
+
+        return ret;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+        glusterfs_ctx_t *ctx        = NULL;
+        int              sizes[]    = {1, 2, 4, 8, 16, 32, 64};
+        long             iterations = 100000;
+        double           start      = 0;
+        double           elapsed    = 0;
+        long             n          = 0;
+        int              s          = 0;
+        int              i          = 0;
+
+        if (argc > 1)
+                iterations = strtol (argv[1], NULL, 0);
+
+        if (glusterfs_globals_init ())
+                return 1;
+
+        ctx = glusterfs_ctx_get ();
+        ctx->dict_pool = mem_pool_new (dict_t, 1024);
+        ctx->dict_pair_pool = mem_pool_new (data_pair_t, 1024);
+        ctx->dict_data_pool = mem_pool_new (data_t, 4096);
+        if (!ctx->dict_pool || !ctx->dict_pair_pool || !ctx->dict_data_pool)
+                return 1;
+
+        for (i = 0; i < MAX_KEYS; i++)
+                snprintf (keys[i], sizeof (keys[i]),
+                          "trusted.afr.bench-volume-client-%d", i);
+
+        printf ("%6s %12s %12s\n", "keys", "usec/dict", "usec/key");
+        for (s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++) {
+                start = now_usec ();
+                for (n = 0; n < iterations; n++) {
+                        if (run_once (sizes[s])) {
+                                fprintf (stderr, "dict operation failed\n");
+                                return 1;
+                        }
+                }
+                elapsed = now_usec () - start;
+
+                printf ("%6d %12.3f %12.3f\n", sizes[s],
+                        elapsed / iterations,
+                        elapsed / iterations / sizes[s]);
+        }
+
+        return 0;
+}
@@ -164,6 +164,9 @@ static struct argp_option gf_options[] = {
          "[default: \"off\"]"
 #endif
         },
+        {"event-threads", ARGP_EVENT_THREADS_KEY, "N", 0,
+         "Number of threads dispatching network events, overrides "
+         "the event-threads option of the volfile [default: 1]"},
         {"brick-name", ARGP_BRICK_NAME_KEY, "BRICK-NAME", OPTION_HIDDEN,
          "Brick name to be registered with Gluster portmapper" },
         {"brick-port", ARGP_BRICK_PORT_KEY, "BRICK-PORT", OPTION_HIDDEN,
@@ -185,6 +188,21 @@ static struct argp_option gf_options[] = {
          "replace USER with root in messages"},
         {"dump-fuse", ARGP_DUMP_FUSE_KEY, "PATH", 0,
          "Dump fuse traffic to PATH"},
+        {"reader-thread-count", ARGP_READER_THREAD_COUNT_KEY, "N", 0,
+         "Number of threads reading requests from /dev/fuse [default: 1]"},
+        {"max-write", ARGP_FUSE_MAX_WRITE_KEY, "SIZE", 0,
+         "Largest write request accepted from fuse kernel module "
+         "[default: 128KB]"},
+        {"max-readahead", ARGP_FUSE_MAX_READAHEAD_KEY, "SIZE", 0,
+         "Largest readahead the fuse kernel module may issue "
+         "[default: 128KB]"},
+        {"use-readdirp", ARGP_FUSE_USE_READDIRP_KEY, "BOOL",
+         OPTION_ARG_OPTIONAL,
+         "Return attributes along with directory entries when the fuse "
+         "kernel module supports it [default: \"on\"]"},
+        {"splice", ARGP_FUSE_SPLICE_KEY, "BOOL", OPTION_ARG_OPTIONAL,
+         "Send large replies to the fuse kernel module with splice(2) "
+         "[default: \"off\"]"},
         {"volfile-check", ARGP_VOLFILE_CHECK_KEY, 0, 0,
          "Enable strict volume file checking"},
         {"mem-accounting", ARGP_MEM_ACCOUNTING_KEY, 0, OPTION_HIDDEN,
@@ -319,6 +337,39 @@ create_fuse_mount (glusterfs_ctx_t *ctx)
                 }
         }
 
+        if (cmd_args->reader_thread_count) {
+                ret = dict_set_int32 (master->options, "reader-thread-count",
+                                      cmd_args->reader_thread_count);
+                if (ret < 0) {
+                        gf_log ("glusterfsd", GF_LOG_ERROR,
+                                "failed to set dict value for key %s",
+                                "reader-thread-count");
+                        goto err;
+                }
+        }
+
+        if (cmd_args->fuse_max_write) {
+                ret = dict_set_uint32 (master->options, "max-write",
+                                       cmd_args->fuse_max_write);
+                if (ret < 0) {
+                        gf_log ("glusterfsd", GF_LOG_ERROR,
+                                "failed to set dict value for key %s",
+                                "max-write");
+                        goto err;
+                }
+        }
+
+        if (cmd_args->fuse_max_readahead) {
+                ret = dict_set_uint32 (master->options, "max-readahead",
+                                       cmd_args->fuse_max_readahead);
+                if (ret < 0) {
+                        gf_log ("glusterfsd", GF_LOG_ERROR,
+                                "failed to set dict value for key %s",
+                                "max-readahead");
+                        goto err;
+                }
+        }
+
         if (cmd_args->volfile_check) {
                 ret = dict_set_int32 (master->options, ZR_STRICT_VOLFILE_CHECK,
                                       cmd_args->volfile_check);
@@ -368,6 +419,34 @@ create_fuse_mount (glusterfs_ctx_t *ctx)
                 }
         }
 
+        switch (cmd_args->fuse_use_readdirp) {
+        case GF_OPTION_DISABLE:
+                ret = dict_set_static_ptr (master->options, "use-readdirp",
+                                           "off");
+                break;
+        case GF_OPTION_ENABLE:
+                ret = dict_set_static_ptr (master->options, "use-readdirp",
+                                           "on");
+                break;
+        default:
+                ret = 0;
+                break;
+        }
+        if (ret < 0) {
+                gf_log ("glusterfsd", GF_LOG_ERROR,
+                        "failed to set dict value for key use-readdirp");
+                goto err;
+        }
+
+        if (cmd_args->fuse_splice) {
+                ret = dict_set_static_ptr (master->options, "splice", "on");
+                if (ret < 0) {
+                        gf_log ("glusterfsd", GF_LOG_ERROR,
+                                "failed to set dict value for key splice");
+                        goto err;
+                }
+        }
+
         switch (cmd_args->fuse_direct_io_mode) {
         case GF_OPTION_DISABLE: /* disable */
                 ret = dict_set_static_ptr (master->options, ZR_DIRECT_IO_OPT,
@@ -540,6 +619,7 @@ parse_opts (int key, char *arg, struct argp_state *state)
         glusterfs_ctx_t *ctx        = NULL;
         cmd_args_t   *cmd_args      = NULL;
         uint32_t      n             = 0;
+        uint64_t      size          = 0;
         double        d             = 0.0;
         gf_boolean_t  b             = _gf_false;
         char         *pwd           = NULL;
@@ -709,6 +789,34 @@ parse_opts (int key, char *arg, struct argp_state *state)
                               "unknown direct I/O mode setting \"%s\"", arg);
                 break;
 
+        case ARGP_FUSE_USE_READDIRP_KEY:
+                if (!arg)
+                        arg = "on";
+
+                if (gf_string2boolean (arg, &b) == 0) {
+                        cmd_args->fuse_use_readdirp = b;
+
+                        break;
+                }
+
+                argp_failure (state, -1, 0,
+                              "unknown use-readdirp setting \"%s\"", arg);
+                break;
+
+        case ARGP_FUSE_SPLICE_KEY:
+                if (!arg)
+                        arg = "on";
+
+                if (gf_string2boolean (arg, &b) == 0) {
+                        cmd_args->fuse_splice = b;
+
+                        break;
+                }
+
+                argp_failure (state, -1, 0,
+                              "unknown splice setting \"%s\"", arg);
+                break;
+
         case ARGP_ENTRY_TIMEOUT_KEY:
                 d = 0.0;
 
@@ -805,6 +913,45 @@ parse_opts (int key, char *arg, struct argp_state *state)
                               "unknown brick (listen) port %s", arg);
                 break;
 
+        case ARGP_EVENT_THREADS_KEY:
+                if (gf_string2int (arg, &cmd_args->event_threads) == 0 &&
+                    cmd_args->event_threads > 0)
+                        break;
+
+                argp_failure (state, -1, 0,
+                              "unknown event thread count %s", arg);
+                break;
+
+        case ARGP_READER_THREAD_COUNT_KEY:
+                if (gf_string2int (arg, &cmd_args->reader_thread_count) == 0 &&
+                    cmd_args->reader_thread_count > 0)
+                        break;
+
+                argp_failure (state, -1, 0,
+                              "unknown reader thread count %s", arg);
+                break;
+
+        case ARGP_FUSE_MAX_WRITE_KEY:
+                if (gf_string2bytesize (arg, &size) == 0 && size > 0 &&
+                    size <= UINT32_MAX) {
+                        cmd_args->fuse_max_write = size;
+                        break;
+                }
+
+                argp_failure (state, -1, 0, "unknown max-write size %s", arg);
+                break;
+
+        case ARGP_FUSE_MAX_READAHEAD_KEY:
+                if (gf_string2bytesize (arg, &size) == 0 && size > 0 &&
+                    size <= UINT32_MAX) {
+                        cmd_args->fuse_max_readahead = size;
+                        break;
+                }
+
+                argp_failure (state, -1, 0,
+                              "unknown max-readahead size %s", arg);
+                break;
+
         case ARGP_MEM_ACCOUNTING_KEY:
                 /* TODO: it should have got handled much earlier */
                 ctx = glusterfs_ctx_get ();
@@ -1117,6 +1264,7 @@ glusterfs_ctx_defaults_init (glusterfs_ctx_t *ctx)
 #endif
         cmd_args->fuse_attribute_timeout = -1;
         cmd_args->fuse_entry_timeout = -1;
+        cmd_args->fuse_use_readdirp = GF_OPTION_DEFERRED;
 
         INIT_LIST_HEAD (&cmd_args->xlator_options);
 
@@ -1720,6 +1868,12 @@ main (int argc, char *argv[])
         if (ret)
                 goto out;
 
+        /* left alone when not given, the event-threads option of the
+           volfile decides then */
+        if (ctx->cmd_args.event_threads)
+                event_reconfigure_threads (ctx->event_pool,
+                                           ctx->cmd_args.event_threads);
+
         ret = event_dispatch (ctx->event_pool);
 
 out:
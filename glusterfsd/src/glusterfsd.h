@@ -87,6 +87,12 @@ enum argp_option_keys {
         ARGP_USER_MAP_ROOT_KEY            = 156,
         ARGP_MEM_ACCOUNTING_KEY           = 157,
         ARGP_SELINUX_KEY                  = 158,
+        ARGP_EVENT_THREADS_KEY            = 159,
+        ARGP_READER_THREAD_COUNT_KEY      = 160,
+        ARGP_FUSE_MAX_WRITE_KEY           = 161,
+        ARGP_FUSE_MAX_READAHEAD_KEY       = 162,
+        ARGP_FUSE_USE_READDIRP_KEY        = 163,
+        ARGP_FUSE_SPLICE_KEY              = 164,
 };
 
 struct _gfd_vol_top_priv_t {
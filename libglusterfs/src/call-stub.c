@@ -2362,6 +2362,247 @@ out:
         return stub;
 }
 
+call_stub_t *
+fop_fallocate_stub (call_frame_t *frame,
+                    fop_fallocate_t fn,
+                    fd_t *fd,
+                    int32_t keep_size, off_t offset,
+                    size_t len, dict_t *xdata)
+{
+        call_stub_t *stub = NULL;
+
+        GF_VALIDATE_OR_GOTO ("call-stub", frame, out);
+        GF_VALIDATE_OR_GOTO ("call-stub", fn, out);
+
+        stub = stub_new (frame, 1, GF_FOP_FALLOCATE);
+        GF_VALIDATE_OR_GOTO ("call-stub", stub, out);
+
+        stub->args.fallocate.fn = fn;
+
+        if (fd)
+                stub->args.fallocate.fd = fd_ref (fd);
+
+        stub->args.fallocate.keep_size = keep_size;
+        stub->args.fallocate.offset = offset;
+        stub->args.fallocate.len = len;
+
+        if (xdata)
+                stub->xdata = dict_ref (xdata);
+
+out:
+        return stub;
+}
+
+call_stub_t *
+fop_fallocate_cbk_stub (call_frame_t *frame,
+                        fop_fallocate_cbk_t fn,
+                        int32_t op_ret,
+                        int32_t op_errno,
+                        struct iatt *statpre,
+                        struct iatt *statpost, dict_t *xdata)
+{
+        call_stub_t *stub = NULL;
+
+        GF_VALIDATE_OR_GOTO ("call-stub", frame, out);
+
+        stub = stub_new (frame, 0, GF_FOP_FALLOCATE);
+        GF_VALIDATE_OR_GOTO ("call-stub", stub, out);
+
+        stub->args.fallocate_cbk.fn = fn;
+
+        stub->args.fallocate_cbk.op_ret = op_ret;
+        stub->args.fallocate_cbk.op_errno = op_errno;
+
+        if (statpre)
+                stub->args.fallocate_cbk.statpre = *statpre;
+        if (statpost)
+                stub->args.fallocate_cbk.statpost = *statpost;
+        if (xdata)
+                stub->xdata = dict_ref (xdata);
+
+out:
+        return stub;
+}
+
+call_stub_t *
+fop_discard_stub (call_frame_t *frame,
+                  fop_discard_t fn,
+                  fd_t *fd,
+                  off_t offset,
+                  size_t len, dict_t *xdata)
+{
+        call_stub_t *stub = NULL;
+
+        GF_VALIDATE_OR_GOTO ("call-stub", frame, out);
+        GF_VALIDATE_OR_GOTO ("call-stub", fn, out);
+
+        stub = stub_new (frame, 1, GF_FOP_DISCARD);
+        GF_VALIDATE_OR_GOTO ("call-stub", stub, out);
+
+        stub->args.discard.fn = fn;
+
+        if (fd)
+                stub->args.discard.fd = fd_ref (fd);
+
+        stub->args.discard.offset = offset;
+        stub->args.discard.len = len;
+
+        if (xdata)
+                stub->xdata = dict_ref (xdata);
+
+out:
+        return stub;
+}
+
+call_stub_t *
+fop_discard_cbk_stub (call_frame_t *frame,
+                      fop_discard_cbk_t fn,
+                      int32_t op_ret,
+                      int32_t op_errno,
+                      struct iatt *statpre,
+                      struct iatt *statpost, dict_t *xdata)
+{
+        call_stub_t *stub = NULL;
+
+        GF_VALIDATE_OR_GOTO ("call-stub", frame, out);
+
+        stub = stub_new (frame, 0, GF_FOP_DISCARD);
+        GF_VALIDATE_OR_GOTO ("call-stub", stub, out);
+
+        stub->args.discard_cbk.fn = fn;
+
+        stub->args.discard_cbk.op_ret = op_ret;
+        stub->args.discard_cbk.op_errno = op_errno;
+
+        if (statpre)
+                stub->args.discard_cbk.statpre = *statpre;
+        if (statpost)
+                stub->args.discard_cbk.statpost = *statpost;
+        if (xdata)
+                stub->xdata = dict_ref (xdata);
+
+out:
+        return stub;
+}
+
+call_stub_t *
+fop_zerofill_stub (call_frame_t *frame,
+                   fop_zerofill_t fn,
+                   fd_t *fd,
+                   off_t offset,
+                   size_t len, dict_t *xdata)
+{
+        call_stub_t *stub = NULL;
+
+        GF_VALIDATE_OR_GOTO ("call-stub", frame, out);
+        GF_VALIDATE_OR_GOTO ("call-stub", fn, out);
+
+        stub = stub_new (frame, 1, GF_FOP_ZEROFILL);
+        GF_VALIDATE_OR_GOTO ("call-stub", stub, out);
+
+        stub->args.zerofill.fn = fn;
+
+        if (fd)
+                stub->args.zerofill.fd = fd_ref (fd);
+
+        stub->args.zerofill.offset = offset;
+        stub->args.zerofill.len = len;
+
+        if (xdata)
+                stub->xdata = dict_ref (xdata);
+
+out:
+        return stub;
+}
+
+call_stub_t *
+fop_zerofill_cbk_stub (call_frame_t *frame,
+                       fop_zerofill_cbk_t fn,
+                       int32_t op_ret,
+                       int32_t op_errno,
+                       struct iatt *statpre,
+                       struct iatt *statpost, dict_t *xdata)
+{
+        call_stub_t *stub = NULL;
+
+        GF_VALIDATE_OR_GOTO ("call-stub", frame, out);
+
+        stub = stub_new (frame, 0, GF_FOP_ZEROFILL);
+        GF_VALIDATE_OR_GOTO ("call-stub", stub, out);
+
+        stub->args.zerofill_cbk.fn = fn;
+
+        stub->args.zerofill_cbk.op_ret = op_ret;
+        stub->args.zerofill_cbk.op_errno = op_errno;
+
+        if (statpre)
+                stub->args.zerofill_cbk.statpre = *statpre;
+        if (statpost)
+                stub->args.zerofill_cbk.statpost = *statpost;
+        if (xdata)
+                stub->xdata = dict_ref (xdata);
+
+out:
+        return stub;
+}
+
+call_stub_t *
+fop_seek_stub (call_frame_t *frame,
+               fop_seek_t fn,
+               fd_t *fd,
+               off_t offset,
+               gf_seek_what_t what, dict_t *xdata)
+{
+        call_stub_t *stub = NULL;
+
+        GF_VALIDATE_OR_GOTO ("call-stub", frame, out);
+        GF_VALIDATE_OR_GOTO ("call-stub", fn, out);
+
+        stub = stub_new (frame, 1, GF_FOP_SEEK);
+        GF_VALIDATE_OR_GOTO ("call-stub", stub, out);
+
+        stub->args.seek.fn = fn;
+
+        if (fd)
+                stub->args.seek.fd = fd_ref (fd);
+
+        stub->args.seek.offset = offset;
+        stub->args.seek.what = what;
+
+        if (xdata)
+                stub->xdata = dict_ref (xdata);
+
+out:
+        return stub;
+}
+
+call_stub_t *
+fop_seek_cbk_stub (call_frame_t *frame,
+                   fop_seek_cbk_t fn,
+                   int32_t op_ret,
+                   int32_t op_errno,
+                   off_t offset, dict_t *xdata)
+{
+        call_stub_t *stub = NULL;
+
+        GF_VALIDATE_OR_GOTO ("call-stub", frame, out);
+
+        stub = stub_new (frame, 0, GF_FOP_SEEK);
+        GF_VALIDATE_OR_GOTO ("call-stub", stub, out);
+
+        stub->args.seek_cbk.fn = fn;
+
+        stub->args.seek_cbk.op_ret = op_ret;
+        stub->args.seek_cbk.op_errno = op_errno;
+        stub->args.seek_cbk.offset = offset;
+
+        if (xdata)
+                stub->xdata = dict_ref (xdata);
+
+out:
+        return stub;
+}
+
 static void
 call_resume_wind (call_stub_t *stub)
 {
@@ -2762,6 +3003,43 @@ call_resume_wind (call_stub_t *stub)
                                         stub->args.fsetattr.valid, stub->xdata);
                 break;
         }
+        case GF_FOP_FALLOCATE:
+        {
+                stub->args.fallocate.fn (stub->frame,
+                                         stub->frame->this,
+                                         stub->args.fallocate.fd,
+                                         stub->args.fallocate.keep_size,
+                                         stub->args.fallocate.offset,
+                                         stub->args.fallocate.len, stub->xdata);
+                break;
+        }
+        case GF_FOP_DISCARD:
+        {
+                stub->args.discard.fn (stub->frame,
+                                       stub->frame->this,
+                                       stub->args.discard.fd,
+                                       stub->args.discard.offset,
+                                       stub->args.discard.len, stub->xdata);
+                break;
+        }
+        case GF_FOP_ZEROFILL:
+        {
+                stub->args.zerofill.fn (stub->frame,
+                                        stub->frame->this,
+                                        stub->args.zerofill.fd,
+                                        stub->args.zerofill.offset,
+                                        stub->args.zerofill.len, stub->xdata);
+                break;
+        }
+        case GF_FOP_SEEK:
+        {
+                stub->args.seek.fn (stub->frame,
+                                    stub->frame->this,
+                                    stub->args.seek.fd,
+                                    stub->args.seek.offset,
+                                    stub->args.seek.what, stub->xdata);
+                break;
+        }
         default:
         {
                 gf_log_callingfn ("call-stub", GF_LOG_ERROR,
@@ -3569,6 +3847,84 @@ call_resume_unwind (call_stub_t *stub)
                                 &stub->args.fsetattr_cbk.statpost, stub->xdata);
                 break;
         }
+        case GF_FOP_FALLOCATE:
+        {
+                if (!stub->args.fallocate_cbk.fn)
+                        STACK_UNWIND (stub->frame,
+                                      stub->args.fallocate_cbk.op_ret,
+                                      stub->args.fallocate_cbk.op_errno,
+                                      &stub->args.fallocate_cbk.statpre,
+                                      &stub->args.fallocate_cbk.statpost,
+                                      stub->xdata);
+                else
+                        stub->args.fallocate_cbk.fn (
+                                stub->frame,
+                                stub->frame->cookie,
+                                stub->frame->this,
+                                stub->args.fallocate_cbk.op_ret,
+                                stub->args.fallocate_cbk.op_errno,
+                                &stub->args.fallocate_cbk.statpre,
+                                &stub->args.fallocate_cbk.statpost, stub->xdata);
+                break;
+        }
+        case GF_FOP_DISCARD:
+        {
+                if (!stub->args.discard_cbk.fn)
+                        STACK_UNWIND (stub->frame,
+                                      stub->args.discard_cbk.op_ret,
+                                      stub->args.discard_cbk.op_errno,
+                                      &stub->args.discard_cbk.statpre,
+                                      &stub->args.discard_cbk.statpost,
+                                      stub->xdata);
+                else
+                        stub->args.discard_cbk.fn (
+                                stub->frame,
+                                stub->frame->cookie,
+                                stub->frame->this,
+                                stub->args.discard_cbk.op_ret,
+                                stub->args.discard_cbk.op_errno,
+                                &stub->args.discard_cbk.statpre,
+                                &stub->args.discard_cbk.statpost, stub->xdata);
+                break;
+        }
+        case GF_FOP_ZEROFILL:
+        {
+                if (!stub->args.zerofill_cbk.fn)
+                        STACK_UNWIND (stub->frame,
+                                      stub->args.zerofill_cbk.op_ret,
+                                      stub->args.zerofill_cbk.op_errno,
+                                      &stub->args.zerofill_cbk.statpre,
+                                      &stub->args.zerofill_cbk.statpost,
+                                      stub->xdata);
+                else
+                        stub->args.zerofill_cbk.fn (
+                                stub->frame,
+                                stub->frame->cookie,
+                                stub->frame->this,
+                                stub->args.zerofill_cbk.op_ret,
+                                stub->args.zerofill_cbk.op_errno,
+                                &stub->args.zerofill_cbk.statpre,
+                                &stub->args.zerofill_cbk.statpost, stub->xdata);
+                break;
+        }
+        case GF_FOP_SEEK:
+        {
+                if (!stub->args.seek_cbk.fn)
+                        STACK_UNWIND (stub->frame,
+                                      stub->args.seek_cbk.op_ret,
+                                      stub->args.seek_cbk.op_errno,
+                                      stub->args.seek_cbk.offset,
+                                      stub->xdata);
+                else
+                        stub->args.seek_cbk.fn (stub->frame,
+                                                stub->frame->cookie,
+                                                stub->frame->this,
+                                                stub->args.seek_cbk.op_ret,
+                                                stub->args.seek_cbk.op_errno,
+                                                stub->args.seek_cbk.offset,
+                                                stub->xdata);
+                break;
+        }
         default:
         {
                 gf_log_callingfn ("call-stub", GF_LOG_ERROR,
@@ -3882,6 +4238,30 @@ call_stub_destroy_wind (call_stub_t *stub)
                         fd_unref (stub->args.fsetattr.fd);
                 break;
         }
+        case GF_FOP_FALLOCATE:
+        {
+                if (stub->args.fallocate.fd)
+                        fd_unref (stub->args.fallocate.fd);
+                break;
+        }
+        case GF_FOP_DISCARD:
+        {
+                if (stub->args.discard.fd)
+                        fd_unref (stub->args.discard.fd);
+                break;
+        }
+        case GF_FOP_ZEROFILL:
+        {
+                if (stub->args.zerofill.fd)
+                        fd_unref (stub->args.zerofill.fd);
+                break;
+        }
+        case GF_FOP_SEEK:
+        {
+                if (stub->args.seek.fd)
+                        fd_unref (stub->args.seek.fd);
+                break;
+        }
         default:
         {
                 gf_log_callingfn ("call-stub", GF_LOG_ERROR,
@@ -4106,6 +4486,26 @@ call_stub_destroy_unwind (call_stub_t *stub)
                 break;
         }
 
+        case GF_FOP_FALLOCATE:
+        {
+                break;
+        }
+
+        case GF_FOP_DISCARD:
+        {
+                break;
+        }
+
+        case GF_FOP_ZEROFILL:
+        {
+                break;
+        }
+
+        case GF_FOP_SEEK:
+        {
+                break;
+        }
+
         default:
         {
                 gf_log_callingfn ("call-stub", GF_LOG_ERROR,
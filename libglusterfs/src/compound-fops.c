@@ -0,0 +1,344 @@
+/*
+  Copyright (c) 2012 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+#ifndef _CONFIG_H
+#define _CONFIG_H
+#include "config.h"
+#endif
+
+#include "xlator.h"
+#include "mem-pool.h"
+
+compound_args_t *
+compound_args_new (int size, int flags)
+{
+        compound_args_t *args = NULL;
+
+        if (size <= 0 || size > GF_COMPOUND_MAX_FOPS)
+                return NULL;
+
+        args = GF_CALLOC (1, sizeof (*args), gf_common_mt_compound_t);
+        if (!args)
+                return NULL;
+
+        args->fops = GF_CALLOC (size, sizeof (*args->fops),
+                                gf_common_mt_compound_t);
+        if (!args->fops) {
+                GF_FREE (args);
+                return NULL;
+        }
+
+        args->size = size;
+        args->flags = flags;
+
+        return args;
+}
+
+
+void
+compound_args_destroy (compound_args_t *args)
+{
+        compound_fop_t *cfop = NULL;
+        int             i    = 0;
+
+        if (!args)
+                return;
+
+        for (i = 0; i < args->count; i++) {
+                cfop = &args->fops[i];
+
+                loc_wipe (&cfop->loc);
+                if (cfop->fd)
+                        fd_unref (cfop->fd);
+                if (cfop->dict)
+                        dict_unref (cfop->dict);
+                if (cfop->xdata)
+                        dict_unref (cfop->xdata);
+                if (cfop->iobref)
+                        iobref_unref (cfop->iobref);
+                GF_FREE (cfop->vector);
+                GF_FREE (cfop->volume);
+                GF_FREE (cfop->name);
+        }
+
+        GF_FREE (args->fops);
+        GF_FREE (args);
+}
+
+
+/* the next free slot, with the references common to all fops taken */
+static compound_fop_t *
+compound_args_next (compound_args_t *args, glusterfs_fop_t fop, loc_t *loc,
+                    fd_t *fd, const char *volume, dict_t *xdata)
+{
+        compound_fop_t *cfop = NULL;
+
+        if (!args || args->count == args->size)
+                return NULL;
+
+        cfop = &args->fops[args->count];
+
+        if (loc && loc_copy (&cfop->loc, loc) != 0)
+                return NULL;
+
+        if (volume) {
+                cfop->volume = gf_strdup (volume);
+                if (!cfop->volume) {
+                        loc_wipe (&cfop->loc);
+                        return NULL;
+                }
+        }
+
+        if (fd)
+                cfop->fd = fd_ref (fd);
+        if (xdata)
+                cfop->xdata = dict_ref (xdata);
+
+        cfop->fop = fop;
+        args->count++;
+
+        return cfop;
+}
+
+
+int
+compound_args_inodelk (compound_args_t *args, const char *volume, loc_t *loc,
+                       int32_t cmd, struct gf_flock *flock, dict_t *xdata)
+{
+        compound_fop_t *cfop = NULL;
+
+        cfop = compound_args_next (args, GF_FOP_INODELK, loc, NULL, volume,
+                                   xdata);
+        if (!cfop)
+                return -1;
+
+        cfop->cmd = cmd;
+        cfop->flock = *flock;
+
+        return 0;
+}
+
+
+int
+compound_args_finodelk (compound_args_t *args, const char *volume, fd_t *fd,
+                        int32_t cmd, struct gf_flock *flock, dict_t *xdata)
+{
+        compound_fop_t *cfop = NULL;
+
+        cfop = compound_args_next (args, GF_FOP_FINODELK, NULL, fd, volume,
+                                   xdata);
+        if (!cfop)
+                return -1;
+
+        cfop->cmd = cmd;
+        cfop->flock = *flock;
+
+        return 0;
+}
+
+
+int
+compound_args_entrylk (compound_args_t *args, const char *volume, loc_t *loc,
+                       const char *basename, entrylk_cmd cmd,
+                       entrylk_type type, dict_t *xdata)
+{
+        compound_fop_t *cfop = NULL;
+
+        cfop = compound_args_next (args, GF_FOP_ENTRYLK, loc, NULL, volume,
+                                   xdata);
+        if (!cfop)
+                return -1;
+
+        if (basename)
+                cfop->name = gf_strdup (basename);
+        cfop->entrylk_cmd = cmd;
+        cfop->entrylk_type = type;
+
+        return (basename && !cfop->name) ? -1 : 0;
+}
+
+
+int
+compound_args_fentrylk (compound_args_t *args, const char *volume, fd_t *fd,
+                        const char *basename, entrylk_cmd cmd,
+                        entrylk_type type, dict_t *xdata)
+{
+        compound_fop_t *cfop = NULL;
+
+        cfop = compound_args_next (args, GF_FOP_FENTRYLK, NULL, fd, volume,
+                                   xdata);
+        if (!cfop)
+                return -1;
+
+        if (basename)
+                cfop->name = gf_strdup (basename);
+        cfop->entrylk_cmd = cmd;
+        cfop->entrylk_type = type;
+
+        return (basename && !cfop->name) ? -1 : 0;
+}
+
+
+int
+compound_args_xattrop (compound_args_t *args, loc_t *loc,
+                       gf_xattrop_flags_t optype, dict_t *dict,
+                       dict_t *xdata)
+{
+        compound_fop_t *cfop = NULL;
+
+        cfop = compound_args_next (args, GF_FOP_XATTROP, loc, NULL, NULL,
+                                   xdata);
+        if (!cfop)
+                return -1;
+
+        cfop->optype = optype;
+        if (dict)
+                cfop->dict = dict_ref (dict);
+
+        return 0;
+}
+
+
+int
+compound_args_fxattrop (compound_args_t *args, fd_t *fd,
+                        gf_xattrop_flags_t optype, dict_t *dict,
+                        dict_t *xdata)
+{
+        compound_fop_t *cfop = NULL;
+
+        cfop = compound_args_next (args, GF_FOP_FXATTROP, NULL, fd, NULL,
+                                   xdata);
+        if (!cfop)
+                return -1;
+
+        cfop->optype = optype;
+        if (dict)
+                cfop->dict = dict_ref (dict);
+
+        return 0;
+}
+
+
+int
+compound_args_setxattr (compound_args_t *args, loc_t *loc, dict_t *dict,
+                        int32_t flags, dict_t *xdata)
+{
+        compound_fop_t *cfop = NULL;
+
+        cfop = compound_args_next (args, GF_FOP_SETXATTR, loc, NULL, NULL,
+                                   xdata);
+        if (!cfop)
+                return -1;
+
+        cfop->flags = flags;
+        if (dict)
+                cfop->dict = dict_ref (dict);
+
+        return 0;
+}
+
+
+int
+compound_args_fsetxattr (compound_args_t *args, fd_t *fd, dict_t *dict,
+                         int32_t flags, dict_t *xdata)
+{
+        compound_fop_t *cfop = NULL;
+
+        cfop = compound_args_next (args, GF_FOP_FSETXATTR, NULL, fd, NULL,
+                                   xdata);
+        if (!cfop)
+                return -1;
+
+        cfop->flags = flags;
+        if (dict)
+                cfop->dict = dict_ref (dict);
+
+        return 0;
+}
+
+
+int
+compound_args_writev (compound_args_t *args, fd_t *fd, struct iovec *vector,
+                      int32_t count, off_t offset, uint32_t flags,
+                      struct iobref *iobref, dict_t *xdata)
+{
+        compound_fop_t *cfop   = NULL;
+        struct iovec   *newvec = NULL;
+
+        /* the data itself is only referenced, through the iobref */
+        newvec = iov_dup (vector, count);
+        if (!newvec)
+                return -1;
+
+        cfop = compound_args_next (args, GF_FOP_WRITE, NULL, fd, NULL, xdata);
+        if (!cfop) {
+                GF_FREE (newvec);
+                return -1;
+        }
+
+        cfop->vector = newvec;
+        cfop->count = count;
+        cfop->offset = offset;
+        cfop->flags = flags;
+        if (iobref)
+                cfop->iobref = iobref_ref (iobref);
+
+        return 0;
+}
+
+
+compound_rsp_t *
+compound_rsp_new (int count)
+{
+        compound_rsp_t *rsp = NULL;
+        int             i   = 0;
+
+        if (count <= 0 || count > GF_COMPOUND_MAX_FOPS)
+                return NULL;
+
+        rsp = GF_CALLOC (1, sizeof (*rsp), gf_common_mt_compound_t);
+        if (!rsp)
+                return NULL;
+
+        rsp->rsps = GF_CALLOC (count, sizeof (*rsp->rsps),
+                               gf_common_mt_compound_t);
+        if (!rsp->rsps) {
+                GF_FREE (rsp);
+                return NULL;
+        }
+
+        rsp->count = count;
+        for (i = 0; i < count; i++) {
+                rsp->rsps[i].op_ret = -1;
+                rsp->rsps[i].op_errno = ECANCELED;
+        }
+
+        return rsp;
+}
+
+
+void
+compound_rsp_destroy (compound_rsp_t *rsp)
+{
+        int i = 0;
+
+        if (!rsp)
+                return;
+
+        for (i = 0; i < rsp->count; i++) {
+                if (rsp->rsps[i].dict)
+                        dict_unref (rsp->rsps[i].dict);
+                if (rsp->rsps[i].xdata)
+                        dict_unref (rsp->rsps[i].xdata);
+        }
+
+        GF_FREE (rsp->rsps);
+        GF_FREE (rsp);
+}
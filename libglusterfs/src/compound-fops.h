@@ -0,0 +1,145 @@
+/*
+  Copyright (c) 2012 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+#ifndef _COMPOUND_FOPS_H
+#define _COMPOUND_FOPS_H
+
+/* included from xlator.h, once loc_t is complete */
+
+/*
+ * A compound fop is a list of fops sent to a brick in one request and run
+ * there in order, the next one starting when the previous one returned.
+ * It lets a caller whose fops depend on each other, like a changelog
+ * update followed by a write or an unlock, pay a single round trip.
+ *
+ * A lock is not worth sending ahead of the fops it guards: with the
+ * blocking form the brick would sit on the request, with the non-blocking
+ * one the caller still has to be ready to back off on all of its bricks
+ * before anything runs, which is a round trip of its own.
+ *
+ * The members are [f]inodelk, [f]entrylk, [f]xattrop, [f]setxattr and
+ * writev, whose data is carried after the request.  They all run with the
+ * lk-owner of the compound's frame.  Fops that create an fd or an inode
+ * (open, create) or return data (readv) are not members: a later member
+ * could not refer to what an earlier one created, so there is nothing to
+ * fuse them with.
+ *
+ * Like any other fop argument the args only need to outlive the wind, and
+ * the rsp given to the callback is freed once it returns.  The callback
+ * gets no rsp at all when the request got no usable reply, in which case
+ * none of the fops is known to have run or not, except with ENOTSUP: the
+ * brick does not take compound fops (see "compound-fops" in the SETVOLUME
+ * reply) and nothing was sent.
+ */
+
+/* run the remaining fops even after one of them failed */
+#define GF_COMPOUND_CONTINUE    0x1
+
+/* arbitrary, keeps a request well within one iobuf; the wire format has
+   the same bound in glusterfs3-xdr.x */
+#define GF_COMPOUND_MAX_FOPS 16
+
+typedef struct {
+        glusterfs_fop_t      fop;
+        loc_t                loc;
+        fd_t                *fd;
+        char                *volume;        /* [f]inodelk, [f]entrylk */
+        char                *name;          /* [f]entrylk */
+        int32_t              cmd;           /* [f]inodelk */
+        struct gf_flock      flock;         /* [f]inodelk */
+        entrylk_cmd          entrylk_cmd;
+        entrylk_type         entrylk_type;
+        gf_xattrop_flags_t   optype;        /* [f]xattrop */
+        dict_t              *dict;          /* [f]xattrop, [f]setxattr */
+        int32_t              flags;         /* [f]setxattr, writev */
+        struct iovec        *vector;        /* writev */
+        int32_t              count;         /* writev */
+        off_t                offset;        /* writev */
+        struct iobref       *iobref;        /* writev */
+        dict_t              *xdata;
+} compound_fop_t;
+
+typedef struct {
+        int32_t              op_ret;
+        int32_t              op_errno;
+        dict_t              *dict;          /* [f]xattrop */
+        struct iatt          prebuf;        /* writev */
+        struct iatt          postbuf;       /* writev */
+        dict_t              *xdata;
+} compound_fop_rsp_t;
+
+typedef struct _compound_args {
+        int                  flags;
+        int                  count;
+        int                  size;
+        compound_fop_t      *fops;
+} compound_args_t;
+
+/* one entry per fop of the request, those that did not run because an
+   earlier one failed have op_errno ECANCELED */
+typedef struct _compound_rsp {
+        int                  count;
+        compound_fop_rsp_t  *rsps;
+} compound_rsp_t;
+
+compound_args_t *
+compound_args_new (int size, int flags);
+
+void
+compound_args_destroy (compound_args_t *args);
+
+int
+compound_args_inodelk (compound_args_t *args, const char *volume, loc_t *loc,
+                       int32_t cmd, struct gf_flock *flock, dict_t *xdata);
+
+int
+compound_args_finodelk (compound_args_t *args, const char *volume, fd_t *fd,
+                        int32_t cmd, struct gf_flock *flock, dict_t *xdata);
+
+int
+compound_args_entrylk (compound_args_t *args, const char *volume, loc_t *loc,
+                       const char *basename, entrylk_cmd cmd,
+                       entrylk_type type, dict_t *xdata);
+
+int
+compound_args_fentrylk (compound_args_t *args, const char *volume, fd_t *fd,
+                        const char *basename, entrylk_cmd cmd,
+                        entrylk_type type, dict_t *xdata);
+
+int
+compound_args_xattrop (compound_args_t *args, loc_t *loc,
+                       gf_xattrop_flags_t optype, dict_t *dict,
+                       dict_t *xdata);
+
+int
+compound_args_fxattrop (compound_args_t *args, fd_t *fd,
+                        gf_xattrop_flags_t optype, dict_t *dict,
+                        dict_t *xdata);
+
+int
+compound_args_setxattr (compound_args_t *args, loc_t *loc, dict_t *dict,
+                        int32_t flags, dict_t *xdata);
+
+int
+compound_args_fsetxattr (compound_args_t *args, fd_t *fd, dict_t *dict,
+                         int32_t flags, dict_t *xdata);
+
+int
+compound_args_writev (compound_args_t *args, fd_t *fd, struct iovec *vector,
+                      int32_t count, off_t offset, uint32_t flags,
+                      struct iobref *iobref, dict_t *xdata);
+
+compound_rsp_t *
+compound_rsp_new (int count);
+
+void
+compound_rsp_destroy (compound_rsp_t *rsp);
+
+#endif /* _COMPOUND_FOPS_H */
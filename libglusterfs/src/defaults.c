@@ -454,6 +454,54 @@ default_fsetattr_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
         return 0;
 }
 
+int32_t
+default_fallocate_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                       int32_t op_ret, int32_t op_errno, struct iatt *pre,
+                       struct iatt *post, dict_t *xdata)
+{
+        STACK_UNWIND_STRICT (fallocate, frame, op_ret, op_errno, pre,
+                             post, xdata);
+        return 0;
+}
+
+int32_t
+default_discard_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                     int32_t op_ret, int32_t op_errno, struct iatt *pre,
+                     struct iatt *post, dict_t *xdata)
+{
+        STACK_UNWIND_STRICT (discard, frame, op_ret, op_errno, pre,
+                             post, xdata);
+        return 0;
+}
+
+int32_t
+default_zerofill_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                      int32_t op_ret, int32_t op_errno, struct iatt *pre,
+                      struct iatt *post, dict_t *xdata)
+{
+        STACK_UNWIND_STRICT (zerofill, frame, op_ret, op_errno, pre,
+                             post, xdata);
+        return 0;
+}
+
+int32_t
+default_seek_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                  int32_t op_ret, int32_t op_errno, off_t offset,
+                  dict_t *xdata)
+{
+        STACK_UNWIND_STRICT (seek, frame, op_ret, op_errno, offset, xdata);
+        return 0;
+}
+
+int32_t
+default_compound_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                      int32_t op_ret, int32_t op_errno, compound_rsp_t *rsp,
+                      dict_t *xdata)
+{
+        STACK_UNWIND_STRICT (compound, frame, op_ret, op_errno, rsp, xdata);
+        return 0;
+}
+
 int32_t
 default_getspec_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
                      int32_t op_ret, int32_t op_errno, char *spec_data)
@@ -862,6 +910,46 @@ default_fsetattr_resume (call_frame_t *frame, xlator_t *this, fd_t *fd,
         return 0;
 }
 
+int32_t
+default_fallocate_resume (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                          int32_t keep_size, off_t offset, size_t len,
+                          dict_t *xdata)
+{
+        STACK_WIND (frame, default_fallocate_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->fallocate, fd, keep_size,
+                    offset, len, xdata);
+        return 0;
+}
+
+int32_t
+default_discard_resume (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                        off_t offset, size_t len, dict_t *xdata)
+{
+        STACK_WIND (frame, default_discard_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->discard, fd, offset, len,
+                    xdata);
+        return 0;
+}
+
+int32_t
+default_zerofill_resume (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                         off_t offset, size_t len, dict_t *xdata)
+{
+        STACK_WIND (frame, default_zerofill_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->zerofill, fd, offset, len,
+                    xdata);
+        return 0;
+}
+
+int32_t
+default_seek_resume (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                     off_t offset, gf_seek_what_t what, dict_t *xdata)
+{
+        STACK_WIND (frame, default_seek_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->seek, fd, offset, what, xdata);
+        return 0;
+}
+
 /* FOPS */
 
 int32_t
@@ -1252,6 +1340,63 @@ default_fsetattr (call_frame_t *frame, xlator_t *this, fd_t *fd,
         return 0;
 }
 
+int32_t
+default_fallocate (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                   int32_t keep_size, off_t offset, size_t len,
+                   dict_t *xdata)
+{
+        STACK_WIND (frame, default_fallocate_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->fallocate, fd, keep_size,
+                    offset, len, xdata);
+        return 0;
+}
+
+int32_t
+default_discard (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                 off_t offset, size_t len, dict_t *xdata)
+{
+        STACK_WIND (frame, default_discard_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->discard, fd, offset, len,
+                    xdata);
+        return 0;
+}
+
+int32_t
+default_zerofill (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                  off_t offset, size_t len, dict_t *xdata)
+{
+        STACK_WIND (frame, default_zerofill_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->zerofill, fd, offset, len,
+                    xdata);
+        return 0;
+}
+
+int32_t
+default_seek (call_frame_t *frame, xlator_t *this, fd_t *fd,
+              off_t offset, gf_seek_what_t what, dict_t *xdata)
+{
+        STACK_WIND (frame, default_seek_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->seek, fd, offset, what, xdata);
+        return 0;
+}
+
+int32_t
+default_compound (call_frame_t *frame, xlator_t *this, compound_args_t *args,
+                  dict_t *xdata)
+{
+        /* passing it on is only right with a single child, a cluster
+           xlator would have to split it */
+        if (!this->children || this->children->next) {
+                STACK_UNWIND_STRICT (compound, frame, -1, ENOTSUP, NULL,
+                                     NULL);
+                return 0;
+        }
+
+        STACK_WIND (frame, default_compound_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->compound, args, xdata);
+        return 0;
+}
+
 
 int32_t
 default_forget (xlator_t *this, inode_t *inode)
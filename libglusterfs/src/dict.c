@@ -43,44 +43,44 @@ get_new_data ()
         return data;
 }
 
+struct _dict_arena {
+        struct _dict_arena *next;
+        data_pair_t         pairs[DICT_ARENA_PAIRS];
+};
+
 dict_t *
 get_new_dict_full (int size_hint)
 {
-        dict_t *dict = mem_get0 (THIS->ctx->dict_pool);
+        dict_t  *dict = mem_get0 (THIS->ctx->dict_pool);
+        int32_t  size = DICT_MIN_HASH_SIZE;
+        int      i    = 0;
 
         if (!dict) {
                 return NULL;
         }
 
-        dict->hash_size = size_hint;
-        if (size_hint == 1) {
-                /*
-                 * This is the only case we ever see currently.  If we ever
-                 * need to support resizing the hash table, the resize function
-                 * will have to take into account the possibility that
-                 * "members" is not separately allocated (i.e. don't just call
-                 * realloc() blindly.
-                 */
-                dict->members = &dict->members_internal;
-        }
-        else {
-                /*
-                 * We actually need to allocate space for size_hint *pointers*
-                 * but we actually allocate space for one *structure*.  Since
-                 * a data_pair_t consists of five pointers, we're wasting four
-                 * pointers' worth for N=1, and will overrun what we allocated
-                 * for N>5.  If anybody ever starts using size_hint, we'll need
-                 * to fix this.
-                 */
-                GF_ASSERT (size_hint <=
-                           (sizeof(data_pair_t) / sizeof(data_pair_t *)));
-                dict->members = mem_get0 (THIS->ctx->dict_pair_pool);
+        /* size_hint is the number of slots wanted, dict_copy() passes the
+           size of the table it copies from */
+        while (size < size_hint)
+                size <<= 1;
+
+        dict->hash_size = size;
+        if (size == DICT_MIN_HASH_SIZE) {
+                dict->members = dict->members_internal;
+        } else {
+                dict->members = GF_CALLOC (size, sizeof (*dict->members),
+                                           gf_common_mt_dict_table);
                 if (!dict->members) {
                         mem_put (dict);
                         return NULL;
                 }
         }
 
+        for (i = 0; i < DICT_INTERNAL_PAIRS; i++) {
+                dict->pairs_internal[i].next = dict->free_pairs;
+                dict->free_pairs = &dict->pairs_internal[i];
+        }
+
         LOCK_INIT (&dict->lock);
 
         return dict;
@@ -132,12 +132,69 @@ is_data_equal (data_t *one,
         return 0;
 }
 
+/* a malloc()ed buffer shared by the values unserialized from it */
+struct _data_buf {
+        gf_lock_t  lock;
+        int32_t    refcount;
+        char      *buf;
+};
+
+static struct _data_buf *
+data_buf_new (char *buf)
+{
+        struct _data_buf *backing = NULL;
+
+        backing = GF_CALLOC (1, sizeof (*backing), gf_common_mt_data_buf);
+        if (!backing)
+                return NULL;
+
+        LOCK_INIT (&backing->lock);
+        backing->refcount = 1;
+        backing->buf = buf;
+
+        return backing;
+}
+
+static struct _data_buf *
+data_buf_ref (struct _data_buf *backing)
+{
+        LOCK (&backing->lock);
+        {
+                backing->refcount++;
+        }
+        UNLOCK (&backing->lock);
+
+        return backing;
+}
+
+static void
+data_buf_unref (struct _data_buf *backing)
+{
+        int32_t ref = 0;
+
+        LOCK (&backing->lock);
+        {
+                ref = --backing->refcount;
+        }
+        UNLOCK (&backing->lock);
+
+        if (ref)
+                return;
+
+        LOCK_DESTROY (&backing->lock);
+        free (backing->buf);
+        GF_FREE (backing);
+}
+
 void
 data_destroy (data_t *data)
 {
         if (data) {
                 LOCK_DESTROY (&data->lock);
 
+                if (data->backing)
+                        data_buf_unref (data->backing);
+
                 if (!data->is_static) {
                         if (data->data) {
                                 if (data->is_stdalloc)
@@ -188,6 +245,124 @@ err_out:
         return NULL;
 }
 
+static data_pair_t *
+__dict_pair_get (dict_t *this)
+{
+        struct _dict_arena *arena = NULL;
+        data_pair_t        *pair  = NULL;
+        int                 i     = 0;
+
+        if (!this->free_pairs) {
+                arena = GF_CALLOC (1, sizeof (*arena),
+                                   gf_common_mt_dict_arena);
+                if (!arena)
+                        return NULL;
+
+                arena->next = this->arena;
+                this->arena = arena;
+                for (i = 0; i < DICT_ARENA_PAIRS; i++) {
+                        arena->pairs[i].next = this->free_pairs;
+                        this->free_pairs = &arena->pairs[i];
+                }
+        }
+
+        pair = this->free_pairs;
+        this->free_pairs = pair->next;
+        pair->next = NULL;
+
+        return pair;
+}
+
+static void
+__dict_pair_put (dict_t *this, data_pair_t *pair)
+{
+        if (pair->key != pair->key_inline)
+                GF_FREE (pair->key);
+        pair->key = NULL;
+        pair->value = NULL;
+        pair->prev = NULL;
+
+        pair->next = this->free_pairs;
+        this->free_pairs = pair;
+}
+
+/* returns the pair for @key, or NULL with *slot set to where it goes */
+static data_pair_t *
+__dict_lookup (dict_t *this, char *key, uint32_t hash, uint32_t *slot)
+{
+        data_pair_t *pair = NULL;
+        uint32_t     mask = this->hash_size - 1;
+        uint32_t     idx  = hash & mask;
+
+        while ((pair = this->members[idx]) != NULL) {
+                if (pair->hash == hash && !strcmp (pair->key, key))
+                        break;
+                idx = (idx + 1) & mask;
+        }
+
+        if (slot)
+                *slot = idx;
+
+        return pair;
+}
+
+static int
+__dict_grow (dict_t *this)
+{
+        data_pair_t  **members = NULL;
+        data_pair_t   *pair    = NULL;
+        int32_t        size    = 0;
+        uint32_t       idx     = 0;
+
+        size = this->hash_size * 2;
+        members = GF_CALLOC (size, sizeof (*members), gf_common_mt_dict_table);
+        if (!members)
+                return -1;
+
+        for (pair = this->members_list; pair; pair = pair->next) {
+                idx = pair->hash & (size - 1);
+                while (members[idx])
+                        idx = (idx + 1) & (size - 1);
+                members[idx] = pair;
+        }
+
+        if (this->members != this->members_internal)
+                GF_FREE (this->members);
+
+        this->members = members;
+        this->hash_size = size;
+
+        return 0;
+}
+
+/* backward shift deletion, keeps probe sequences intact without
+   tombstones */
+static void
+__dict_unhash (dict_t *this, uint32_t slot)
+{
+        uint32_t mask = this->hash_size - 1;
+        uint32_t next = slot;
+        uint32_t home = 0;
+
+        this->members[slot] = NULL;
+
+        for (;;) {
+                next = (next + 1) & mask;
+                if (!this->members[next])
+                        break;
+
+                home = this->members[next]->hash & mask;
+                /* leave it if its home lies cyclically in (slot, next] */
+                if ((slot < next) ? (slot < home && home <= next)
+                                  : (slot < home || home <= next))
+                        continue;
+
+                this->members[slot] = this->members[next];
+                this->members[next] = NULL;
+                slot = next;
+        }
+}
+
 static data_pair_t *
 _dict_lookup (dict_t *this, char *key)
 {
@@ -197,15 +372,8 @@ _dict_lookup (dict_t *this, char *key)
                 return NULL;
         }
 
-        int hashval = SuperFastHash (key, strlen (key)) % this->hash_size;
-        data_pair_t *pair;
-
-        for (pair = this->members[hashval]; pair != NULL; pair = pair->hash_next) {
-                if (pair->key && !strcmp (pair->key, key))
-                        return pair;
-        }
-
-        return NULL;
+        return __dict_lookup (this, key, SuperFastHash (key, strlen (key)),
+                              NULL);
 }
 
 int32_t
@@ -234,70 +402,55 @@ _dict_set (dict_t *this,
            char *key,
            data_t *value)
 {
-        int hashval;
-        data_pair_t *pair;
-        char key_free = 0;
-        int tmp = 0;
-        int ret = 0;
+        data_pair_t *pair = NULL;
+        char         refkey[32] = {0,};
+        uint32_t     hash = 0;
+        uint32_t     slot = 0;
+        int          keylen = 0;
 
         if (!key) {
-                ret = gf_asprintf (&key, "ref:%p", value);
-                if (-1 == ret) {
-                        gf_log ("dict", GF_LOG_WARNING, "asprintf failed %s", key);
-                        return -1;
-                }
-                key_free = 1;
+                snprintf (refkey, sizeof (refkey), "ref:%p", value);
+                key = refkey;
         }
 
-        tmp = SuperFastHash (key, strlen (key));
-        hashval = (tmp % this->hash_size);
-        pair = _dict_lookup (this, key);
+        keylen = strlen (key);
+        hash = SuperFastHash (key, keylen);
+        pair = __dict_lookup (this, key, hash, &slot);
 
         if (pair) {
                 data_t *unref_data = pair->value;
                 pair->value = data_ref (value);
                 data_unref (unref_data);
-                if (key_free)
-                        GF_FREE (key);
                 /* Indicates duplicate key */
                 return 0;
         }
-        if (this->free_pair_in_use) {
-                pair = mem_get0 (THIS->ctx->dict_pair_pool);
-                if (!pair) {
-                        if (key_free)
-                                GF_FREE (key);
+
+        /* keep the load under 3/4, a full table only fails the insert */
+        if ((this->count + 1) * 4 > this->hash_size * 3) {
+                if (__dict_grow (this) == 0)
+                        __dict_lookup (this, key, hash, &slot);
+                else if (this->count + 1 >= this->hash_size)
                         return -1;
-                }
-        }
-        else {
-                pair = &this->free_pair;
-                this->free_pair_in_use = _gf_true;
         }
 
-        if (key_free) {
-                /* It's ours.  Use it. */
-                pair->key = key;
-                key_free = 0;
-        }
-        else {
-                pair->key = (char *) GF_CALLOC (1, strlen (key) + 1,
-                                                gf_common_mt_char);
+        pair = __dict_pair_get (this);
+        if (!pair)
+                return -1;
+
+        if (keylen < DICT_KEY_INLINE_LEN) {
+                pair->key = pair->key_inline;
+        } else {
+                pair->key = GF_CALLOC (1, keylen + 1, gf_common_mt_char);
                 if (!pair->key) {
-                        if (pair == &this->free_pair) {
-                                this->free_pair_in_use = _gf_false;
-                        }
-                        else {
-                                mem_put (pair);
-                        }
+                        __dict_pair_put (this, pair);
                         return -1;
                 }
-                strcpy (pair->key, key);
         }
+        memcpy (pair->key, key, keylen + 1);
+        pair->hash = hash;
         pair->value = data_ref (value);
 
-        pair->hash_next = this->members[hashval];
-        this->members[hashval] = pair;
+        this->members[slot] = pair;
 
         pair->next = this->members_list;
         pair->prev = NULL;
@@ -306,8 +459,6 @@ _dict_set (dict_t *this,
         this->members_list = pair;
         this->count++;
 
-        if (key_free)
-                GF_FREE (key);
         return 0;
 }
 
@@ -360,6 +511,9 @@ dict_get (dict_t *this, char *key)
 void
 dict_del (dict_t *this, char *key)
 {
+        data_pair_t *pair = NULL;
+        uint32_t     slot = 0;
+
         if (!this || !key) {
                 gf_log_callingfn ("dict", GF_LOG_WARNING,
                                   "!this || key=%s", key);
@@ -368,40 +522,23 @@ dict_del (dict_t *this, char *key)
 
         LOCK (&this->lock);
 
-        int hashval = SuperFastHash (key, strlen (key)) % this->hash_size;
-        data_pair_t *pair = this->members[hashval];
-        data_pair_t *prev = NULL;
-
-        while (pair) {
-                if (strcmp (pair->key, key) == 0) {
-                        if (prev)
-                                prev->hash_next = pair->hash_next;
-                        else
-                                this->members[hashval] = pair->hash_next;
-
-                        data_unref (pair->value);
+        pair = __dict_lookup (this, key, SuperFastHash (key, strlen (key)),
+                              &slot);
+        if (pair) {
+                __dict_unhash (this, slot);
 
-                        if (pair->prev)
-                                pair->prev->next = pair->next;
-                        else
-                                this->members_list = pair->next;
+                data_unref (pair->value);
 
-                        if (pair->next)
-                                pair->next->prev = pair->prev;
+                if (pair->prev)
+                        pair->prev->next = pair->next;
+                else
+                        this->members_list = pair->next;
 
-                        GF_FREE (pair->key);
-                        if (pair == &this->free_pair) {
-                                this->free_pair_in_use = _gf_false;
-                        }
-                        else {
-                                mem_put (pair);
-                        }
-                        this->count--;
-                        break;
-                }
+                if (pair->next)
+                        pair->next->prev = pair->prev;
 
-                prev = pair;
-                pair = pair->hash_next;
+                __dict_pair_put (this, pair);
+                this->count--;
         }
 
         UNLOCK (&this->lock);
@@ -412,6 +549,8 @@ dict_del (dict_t *this, char *key)
 void
 dict_destroy (dict_t *this)
 {
+        struct _dict_arena *arena = NULL;
+
         if (!this) {
                 gf_log_callingfn ("dict", GF_LOG_WARNING, "dict is NULL");
                 return;
@@ -425,17 +564,19 @@ dict_destroy (dict_t *this)
         while (prev) {
                 pair = pair->next;
                 data_unref (prev->value);
-                GF_FREE (prev->key);
-                if (prev != &this->free_pair) {
-                        mem_put (prev);
-                }
+                if (prev->key != prev->key_inline)
+                        GF_FREE (prev->key);
                 prev = pair;
         }
 
-        if (this->members != &this->members_internal) {
-                mem_put (this->members);
+        while ((arena = this->arena) != NULL) {
+                this->arena = arena->next;
+                GF_FREE (arena);
         }
 
+        if (this->members != this->members_internal)
+                GF_FREE (this->members);
+
         if (this->extra_free)
                 GF_FREE (this->extra_free);
         if (this->extra_stdfree)
@@ -523,22 +664,26 @@ data_ref (data_t *this)
         return this;
 }
 
+/* small values are printed into the data_t itself, data->data is not
+   separately allocated so it is flagged static */
+#define DATA_PRINTF_INLINE(data, fmt, value) do {                       \
+                (data)->len = snprintf ((data)->inline_data,            \
+                                        sizeof ((data)->inline_data),   \
+                                        fmt, value) + 1;                \
+                (data)->data = (data)->inline_data;                     \
+                (data)->is_static = 1;                                  \
+        } while (0)
+
 data_t *
 int_to_data (int64_t value)
 {
-        int     ret = 0;
         data_t *data = get_new_data ();
 
         if (!data) {
                 return NULL;
         }
 
-        ret = gf_asprintf (&data->data, "%"PRId64, value);
-        if (-1 == ret) {
-                gf_log ("dict", GF_LOG_DEBUG, "asprintf failed");
-                return NULL;
-        }
-        data->len = strlen (data->data) + 1;
+        DATA_PRINTF_INLINE (data, "%"PRId64, value);
 
         return data;
 }
@@ -546,18 +691,13 @@ int_to_data (int64_t value)
 data_t *
 data_from_int64 (int64_t value)
 {
-        int     ret = 0;
         data_t *data = get_new_data ();
 
         if (!data) {
                 return NULL;
         }
-        ret = gf_asprintf (&data->data, "%"PRId64, value);
-        if (-1 == ret) {
-                gf_log ("dict", GF_LOG_DEBUG, "asprintf failed");
-                return NULL;
-        }
-        data->len = strlen (data->data) + 1;
+
+        DATA_PRINTF_INLINE (data, "%"PRId64, value);
 
         return data;
 }
@@ -565,19 +705,13 @@ data_from_int64 (int64_t value)
 data_t *
 data_from_int32 (int32_t value)
 {
-        int     ret = 0;
         data_t *data = get_new_data ();
 
         if (!data) {
                 return NULL;
         }
-        ret = gf_asprintf (&data->data, "%"PRId32, value);
-        if (-1 == ret) {
-                gf_log ("dict", GF_LOG_DEBUG, "asprintf failed");
-                return NULL;
-        }
 
-        data->len = strlen (data->data) + 1;
+        DATA_PRINTF_INLINE (data, "%"PRId32, value);
 
         return data;
 }
@@ -585,19 +719,13 @@ data_from_int32 (int32_t value)
 data_t *
 data_from_int16 (int16_t value)
 {
-        int     ret = 0;
         data_t *data = get_new_data ();
 
         if (!data) {
                 return NULL;
         }
-        ret = gf_asprintf (&data->data, "%"PRId16, value);
-        if (-1 == ret) {
-                gf_log ("dict", GF_LOG_DEBUG, "asprintf failed");
-                return NULL;
-        }
 
-        data->len = strlen (data->data) + 1;
+        DATA_PRINTF_INLINE (data, "%"PRId16, value);
 
         return data;
 }
@@ -605,19 +733,13 @@ data_from_int16 (int16_t value)
 data_t *
 data_from_int8 (int8_t value)
 {
-        int     ret = 0;
         data_t *data = get_new_data ();
 
         if (!data) {
                 return NULL;
         }
-        ret = gf_asprintf (&data->data, "%d", value);
-        if (-1 == ret) {
-                gf_log ("dict", GF_LOG_DEBUG, "asprintf failed");
-                return NULL;
-        }
 
-        data->len = strlen (data->data) + 1;
+        DATA_PRINTF_INLINE (data, "%d", value);
 
         return data;
 }
@@ -625,19 +747,13 @@ data_from_int8 (int8_t value)
 data_t *
 data_from_uint64 (uint64_t value)
 {
-        int     ret = 0;
         data_t *data = get_new_data ();
 
         if (!data) {
                 return NULL;
         }
-        ret = gf_asprintf (&data->data, "%"PRIu64, value);
-        if (-1 == ret) {
-                gf_log ("dict", GF_LOG_DEBUG, "asprintf failed");
-                return NULL;
-        }
 
-        data->len = strlen (data->data) + 1;
+        DATA_PRINTF_INLINE (data, "%"PRIu64, value);
 
         return data;
 }
@@ -667,19 +783,13 @@ data_from_double (double value)
 data_t *
 data_from_uint32 (uint32_t value)
 {
-        int     ret = 0;
         data_t *data = get_new_data ();
 
         if (!data) {
                 return NULL;
         }
-        ret = gf_asprintf (&data->data, "%"PRIu32, value);
-        if (-1 == ret) {
-                gf_log ("dict", GF_LOG_DEBUG, "asprintf failed");
-                return NULL;
-        }
 
-        data->len = strlen (data->data) + 1;
+        DATA_PRINTF_INLINE (data, "%"PRIu32, value);
 
         return data;
 }
@@ -688,18 +798,13 @@ data_from_uint32 (uint32_t value)
 data_t *
 data_from_uint16 (uint16_t value)
 {
-        int     ret = 0;
         data_t *data = get_new_data ();
 
         if (!data) {
                 return NULL;
         }
-        ret = gf_asprintf (&data->data, "%"PRIu16, value);
-        if (-1 == ret) {
-                return NULL;
-        }
 
-        data->len = strlen (data->data) + 1;
+        DATA_PRINTF_INLINE (data, "%"PRIu16, value);
 
         return data;
 }
@@ -2344,19 +2449,9 @@ out:
 }
 
 
-/**
- * dict_unserialize - unserialize a buffer into a dict
- *
- * @buf:  buf containing serialized dict
- * @size: size of the @buf
- * @fill: dict to fill in
- *
- * @return: success: 0
- *          failure: -errno
- */
-
-int32_t
-dict_unserialize (char *orig_buf, int32_t size, dict_t **fill)
+static int32_t
+_dict_unserialize (char *orig_buf, int32_t size, dict_t **fill,
+                   struct _data_buf *backing)
 {
         char   *buf = NULL;
         int     ret   = -1;
@@ -2458,11 +2553,20 @@ dict_unserialize (char *orig_buf, int32_t size, dict_t **fill)
                                           "available (%lu) < required (%lu)",
                                           (long)(orig_buf + size),
                                           (long)(buf + vallen));
+                        goto out;
                 }
                 value = get_new_data ();
+                if (!value)
+                        goto out;
                 value->len  = vallen;
-                value->data = memdup (buf, vallen);
-                value->is_static = 0;
+                if (backing) {
+                        value->data = buf;
+                        value->is_static = 1;
+                        value->backing = data_buf_ref (backing);
+                } else {
+                        value->data = memdup (buf, vallen);
+                        value->is_static = 0;
+                }
                 buf += vallen;
 
                 dict_set (*fill, key, value);
@@ -2474,6 +2578,61 @@ out:
 }
 
 
+/**
+ * dict_unserialize - unserialize a buffer into a dict
+ *
+ * @buf:  buf containing serialized dict
+ * @size: size of the @buf
+ * @fill: dict to fill in
+ *
+ * @return: success: 0
+ *          failure: -errno
+ */
+
+int32_t
+dict_unserialize (char *orig_buf, int32_t size, dict_t **fill)
+{
+        return _dict_unserialize (orig_buf, size, fill, NULL);
+}
+
+
+/**
+ * dict_unserialize_stdbuf - unserialize without copying the values
+ *
+ * @buf:  malloc()ed buf containing serialized dict, always consumed
+ * @size: size of the @buf
+ * @fill: dict to fill in
+ *
+ * The values point into @buf, which is freed when the last of them goes
+ * away, so they stay valid when shared with other dicts.
+ *
+ * @return: success: 0
+ *          failure: -errno
+ */
+
+int32_t
+dict_unserialize_stdbuf (char *buf, int32_t size, dict_t **fill)
+{
+        struct _data_buf *backing = NULL;
+        int32_t           ret     = -1;
+
+        if (!buf)
+                return dict_unserialize (buf, size, fill);
+
+        backing = data_buf_new (buf);
+        if (!backing) {
+                free (buf);
+                return -1;
+        }
+
+        ret = _dict_unserialize (buf, size, fill, backing);
+
+        data_buf_unref (backing);
+
+        return ret;
+}
+
+
 /**
  * dict_allocate_and_serialize - serialize a dictionary into an allocated buffer
  *
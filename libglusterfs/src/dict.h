@@ -47,6 +47,8 @@ typedef struct _data_pair data_pair_t;
         } while (0)
 
 
+/* the dict takes over @buff, which xdr allocated with malloc(), and its
+   values point into it instead of getting copies */
 #define GF_PROTOCOL_DICT_UNSERIALIZE(xl,to,buff,len,ret,ope,labl) do {  \
                 char *buf = NULL;                                       \
                 if (!len)                                               \
@@ -54,23 +56,25 @@ typedef struct _data_pair data_pair_t;
                 to = dict_new();                                        \
                 GF_VALIDATE_OR_GOTO (xl->name, to, labl);               \
                                                                         \
-                buf = memdup (buff, len);                               \
-                GF_VALIDATE_OR_GOTO (xl->name, buf, labl);              \
-                                                                        \
-                ret = dict_unserialize (buf, len, &to);                 \
+                buf = buff;                                             \
+                buff = NULL;                                            \
+                ret = dict_unserialize_stdbuf (buf, len, &to);          \
                 if (ret < 0) {                                          \
                         gf_log (xl->name, GF_LOG_WARNING,               \
                                 "failed to unserialize dictionary (%s)", \
                                 (#to));                                 \
                                                                         \
                         ope = EINVAL;                                   \
-                        GF_FREE (buf);                                  \
                         goto labl;                                      \
                 }                                                       \
-                                                                        \
-                to->extra_free = buf;                                   \
         } while (0)
 
+#define DICT_MIN_HASH_SIZE    8    /* slots in dict->members_internal */
+#define DICT_INTERNAL_PAIRS   4    /* pairs embedded in the dict itself */
+#define DICT_ARENA_PAIRS      8    /* pairs per arena chunk beyond those */
+#define DICT_KEY_INLINE_LEN   48   /* shorter keys are stored in the pair */
+#define DATA_INLINE_LEN       24   /* fits any printed 64 bit integer */
+
 struct _data {
         unsigned char  is_static:1;
         unsigned char  is_const:1;
@@ -79,29 +83,33 @@ struct _data {
         char          *data;
         int32_t        refcount;
         gf_lock_t      lock;
+        char           inline_data[DATA_INLINE_LEN];
+        struct _data_buf *backing;  /* shared buffer data points into */
 };
 
 struct _data_pair {
-        struct _data_pair *hash_next;
         struct _data_pair *prev;
         struct _data_pair *next;
         data_t            *value;
         char              *key;
+        uint32_t           hash;
+        char               key_inline[DICT_KEY_INLINE_LEN];
 };
 
 struct _dict {
         unsigned char   is_static:1;
-        int32_t         hash_size;
+        int32_t         hash_size;  /* power of two */
         int32_t         count;
         int32_t         refcount;
-        data_pair_t   **members;
+        data_pair_t   **members;    /* open addressed, linear probing */
         data_pair_t    *members_list;
         char           *extra_free;
         char           *extra_stdfree;
         gf_lock_t       lock;
-        data_pair_t    *members_internal;
-        data_pair_t     free_pair;
-        gf_boolean_t    free_pair_in_use;
+        data_pair_t    *members_internal[DICT_MIN_HASH_SIZE];
+        data_pair_t    *free_pairs;
+        struct _dict_arena *arena;
+        data_pair_t     pairs_internal[DICT_INTERNAL_PAIRS];
 };
 
 
@@ -116,6 +124,7 @@ int dict_reset (dict_t *dict);
 int32_t dict_serialized_length (dict_t *dict);
 int32_t dict_serialize (dict_t *dict, char *buf);
 int32_t dict_unserialize (char *buf, int32_t size, dict_t **fill);
+int32_t dict_unserialize_stdbuf (char *buf, int32_t size, dict_t **fill);
 
 int32_t dict_allocate_and_serialize (dict_t *this, char **buf, size_t *length);
 
@@ -443,12 +443,26 @@ out:
 }
 
 
+static int
+event_reconfigure_threads_poll (struct event_pool *event_pool, int value)
+{
+        /* poll based dispatch is always single threaded */
+        if (value > 1)
+                gf_log ("poll", GF_LOG_INFO,
+                        "multi-threaded event dispatch is not supported "
+                        "with poll, using 1 thread");
+
+        return 0;
+}
+
+
 static struct event_ops event_ops_poll = {
         .new              = event_pool_new_poll,
         .event_register   = event_register_poll,
         .event_select_on  = event_select_on_poll,
         .event_unregister = event_unregister_poll,
-        .event_dispatch   = event_dispatch_poll
+        .event_dispatch   = event_dispatch_poll,
+        .event_reconfigure_threads = event_reconfigure_threads_poll
 };
 
 
@@ -495,6 +509,8 @@ event_pool_new_epoll (int count)
 
         event_pool->count = count;
 
+        event_pool->eventthreadcount = 1;
+
         pthread_mutex_init (&event_pool->mutex, NULL);
         pthread_cond_init (&event_pool->cond, NULL);
 
@@ -503,6 +519,65 @@ out:
 }
 
 
+/* Slots are never moved once handed out, so that the index stored in
+ * the epoll data stays valid while another thread may be running the
+ * handler. Freed slots are marked with fd == -1 and reused.
+ */
+static int
+__event_slot_alloc (struct event_pool *event_pool)
+{
+        int idx = -1;
+        int i = 0;
+
+        for (i = 0; i < event_pool->used; i++) {
+                if (event_pool->reg[i].fd == -1) {
+                        idx = i;
+                        goto out;
+                }
+        }
+
+        if (event_pool->count == event_pool->used) {
+                event_pool->count *= 2;
+
+                event_pool->reg = GF_REALLOC (event_pool->reg,
+                                              event_pool->count *
+                                              sizeof (*event_pool->reg));
+
+                if (!event_pool->reg) {
+                        gf_log ("epoll", GF_LOG_ERROR,
+                                "event registry re-allocation failed");
+                        goto out;
+                }
+
+                /* only the new slots start over, one given back by
+                   __event_slot_free keeps its generation */
+                memset (&event_pool->reg[event_pool->used], 0,
+                        (event_pool->count - event_pool->used) *
+                        sizeof (*event_pool->reg));
+        }
+
+        idx = event_pool->used;
+        event_pool->used++;
+
+out:
+        return idx;
+}
+
+
+static void
+__event_slot_free (struct event_pool *event_pool, int idx)
+{
+        event_pool->reg[idx].fd = -1;
+        event_pool->reg[idx].in_handler = 0;
+        event_pool->reg[idx].handler = NULL;
+        event_pool->reg[idx].data = NULL;
+
+        while (event_pool->used > 0 &&
+               event_pool->reg[event_pool->used - 1].fd == -1)
+                event_pool->used--;
+}
+
+
 int
 event_register_epoll (struct event_pool *event_pool, int fd,
                       event_handler_t handler,
@@ -518,27 +593,16 @@ event_register_epoll (struct event_pool *event_pool, int fd,
 
         pthread_mutex_lock (&event_pool->mutex);
         {
-                if (event_pool->count == event_pool->used) {
-                        event_pool->count *= 2;
-
-                        event_pool->reg = GF_REALLOC (event_pool->reg,
-                                                      event_pool->count *
-                                                      sizeof (*event_pool->reg));
-
-                        if (!event_pool->reg) {
-                                gf_log ("epoll", GF_LOG_ERROR,
-                                        "event registry re-allocation failed");
-                                goto unlock;
-                        }
-                }
-
-                idx = event_pool->used;
-                event_pool->used++;
+                idx = __event_slot_alloc (event_pool);
+                if (idx == -1)
+                        goto unlock;
 
                 event_pool->reg[idx].fd = fd;
                 event_pool->reg[idx].events = EPOLLPRI;
                 event_pool->reg[idx].handler = handler;
                 event_pool->reg[idx].data = data;
+                event_pool->reg[idx].in_handler = 0;
+                event_pool->reg[idx].gen++;
 
                 switch (poll_in) {
                 case 1:
@@ -574,9 +638,16 @@ event_register_epoll (struct event_pool *event_pool, int fd,
 
                 event_pool->changed = 1;
 
-                epoll_event.events = event_pool->reg[idx].events;
-                ev_data->fd = fd;
+                /* EPOLLONESHOT: the fd is disarmed as soon as one dispatcher
+                   thread picks up an event on it, and re-armed only after
+                   its handler returns. This keeps the events of a single
+                   connection serialized while different connections are
+                   served in parallel.
+                */
+                epoll_event.events = event_pool->reg[idx].events |
+                                     EPOLLONESHOT;
                 ev_data->idx = idx;
+                ev_data->gen = event_pool->reg[idx].gen;
 
                 ret = epoll_ctl (event_pool->fd, EPOLL_CTL_ADD, fd,
                                  &epoll_event);
@@ -585,6 +656,8 @@ event_register_epoll (struct event_pool *event_pool, int fd,
                         gf_log ("epoll", GF_LOG_ERROR,
                                 "failed to add fd(=%d) to epoll fd(=%d) (%s)",
                                 fd, event_pool->fd, strerror (errno));
+                        __event_slot_free (event_pool, idx);
+                        idx = -1;
                         goto unlock;
                 }
 
@@ -594,7 +667,7 @@ unlock:
         pthread_mutex_unlock (&event_pool->mutex);
 
 out:
-        return ret;
+        return idx;
 }
 
 
@@ -604,10 +677,6 @@ event_unregister_epoll (struct event_pool *event_pool, int fd, int idx_hint)
         int  idx = -1;
         int  ret = -1;
 
-        struct epoll_event epoll_event = {0, };
-        struct event_data *ev_data = (void *)&epoll_event.data;
-        int                lastidx = -1;
-
         GF_VALIDATE_OR_GOTO ("event", event_pool, out);
 
         pthread_mutex_lock (&event_pool->mutex);
@@ -624,13 +693,9 @@ event_unregister_epoll (struct event_pool *event_pool, int fd, int idx_hint)
 
                 ret = epoll_ctl (event_pool->fd, EPOLL_CTL_DEL, fd, NULL);
 
-                /* if ret is -1, this array member should never be accessed */
-                /* if it is 0, the array member might be used by idx_cache
-                 * in which case the member should not be accessed till
-                 * it is reallocated
-                 */
-
-                event_pool->reg[idx].fd = -1;
+                /* the slot is released even if the delete failed, the fd
+                   is about to be closed by the caller anyway */
+                __event_slot_free (event_pool, idx);
 
                 if (ret == -1) {
                         gf_log ("epoll", GF_LOG_ERROR,
@@ -638,30 +703,6 @@ event_unregister_epoll (struct event_pool *event_pool, int fd, int idx_hint)
                                 fd, event_pool->fd, strerror (errno));
                         goto unlock;
                 }
-
-                lastidx = event_pool->used - 1;
-                if (lastidx == idx) {
-                        event_pool->used--;
-                        goto unlock;
-                }
-
-                epoll_event.events = event_pool->reg[lastidx].events;
-                ev_data->fd = event_pool->reg[lastidx].fd;
-                ev_data->idx = idx;
-
-                ret = epoll_ctl (event_pool->fd, EPOLL_CTL_MOD, ev_data->fd,
-                                 &epoll_event);
-                if (ret == -1) {
-                        gf_log ("epoll", GF_LOG_ERROR,
-                                "fail to modify fd(=%d) index %d to %d (%s)",
-                                ev_data->fd, event_pool->used, idx,
-                                strerror (errno));
-                        goto unlock;
-                }
-
-                /* just replace the unregistered idx by last one */
-                event_pool->reg[idx] = event_pool->reg[lastidx];
-                event_pool->used--;
         }
 unlock:
         pthread_mutex_unlock (&event_pool->mutex);
@@ -728,9 +769,16 @@ event_select_on_epoll (struct event_pool *event_pool, int fd, int idx_hint,
                         break;
                 }
 
-                epoll_event.events = event_pool->reg[idx].events;
-                ev_data->fd = fd;
+                /* while a handler is running on this fd, only record the
+                   new interest set. event_handled_epoll() re-arms the fd
+                   with it once the handler returns. */
+                if (event_pool->reg[idx].in_handler)
+                        goto unlock;
+
+                epoll_event.events = event_pool->reg[idx].events |
+                                     EPOLLONESHOT;
                 ev_data->idx = idx;
+                ev_data->gen = event_pool->reg[idx].gen;
 
                 ret = epoll_ctl (event_pool->fd, EPOLL_CTL_MOD, fd,
                                  &epoll_event);
@@ -738,97 +786,153 @@ event_select_on_epoll (struct event_pool *event_pool, int fd, int idx_hint,
                         gf_log ("epoll", GF_LOG_ERROR,
                                 "failed to modify fd(=%d) events to %d",
                                 fd, epoll_event.events);
+                        idx = -1;
                 }
         }
 unlock:
         pthread_mutex_unlock (&event_pool->mutex);
 
 out:
-        return ret;
+        return idx;
+}
+
+
+static void
+event_handled_epoll (struct event_pool *event_pool, int idx, int gen)
+{
+        int                 ret = -1;
+        struct epoll_event  epoll_event = {0, };
+        struct event_data  *ev_data = (void *)&epoll_event.data;
+
+        pthread_mutex_lock (&event_pool->mutex);
+        {
+                /* the fd got unregistered (and the slot possibly reused)
+                   by the handler, nothing to re-arm */
+                if (event_pool->reg[idx].gen != gen ||
+                    event_pool->reg[idx].fd == -1)
+                        goto unlock;
+
+                event_pool->reg[idx].in_handler = 0;
+
+                epoll_event.events = event_pool->reg[idx].events |
+                                     EPOLLONESHOT;
+                ev_data->idx = idx;
+                ev_data->gen = gen;
+
+                ret = epoll_ctl (event_pool->fd, EPOLL_CTL_MOD,
+                                 event_pool->reg[idx].fd, &epoll_event);
+                if (ret == -1) {
+                        gf_log ("epoll", GF_LOG_ERROR,
+                                "failed to re-arm fd(=%d) (%s)",
+                                event_pool->reg[idx].fd, strerror (errno));
+                }
+        }
+unlock:
+        pthread_mutex_unlock (&event_pool->mutex);
 }
 
 
 static int
 event_dispatch_epoll_handler (struct event_pool *event_pool,
-                              struct epoll_event *events, int i)
+                              struct epoll_event *event)
 {
         struct event_data  *event_data = NULL;
         event_handler_t     handler = NULL;
         void               *data = NULL;
+        int                 fd = -1;
         int                 idx = -1;
+        int                 gen = 0;
         int                 ret = -1;
 
 
-        event_data = (void *)&events[i].data;
-        handler = NULL;
-        data = NULL;
+        event_data = (void *)&event->data;
+        idx = event_data->idx;
+        gen = event_data->gen;
 
         pthread_mutex_lock (&event_pool->mutex);
         {
-                idx = __event_getindex (event_pool, event_data->fd,
-                                        event_data->idx);
-
-                if (idx == -1) {
-                        gf_log ("epoll", GF_LOG_ERROR,
-                                "index not found for fd(=%d) (idx_hint=%d)",
-                                event_data->fd, event_data->idx);
+                if (idx < 0 || idx >= event_pool->used ||
+                    event_pool->reg[idx].gen != gen ||
+                    event_pool->reg[idx].fd == -1) {
+                        /* stale event of an fd unregistered after
+                           epoll_wait() returned */
+                        gf_log ("epoll", GF_LOG_DEBUG,
+                                "stale event on slot %d (gen=%d)", idx, gen);
                         goto unlock;
                 }
 
+                /* select_on() from a racing thread may have re-armed the
+                   fd before the first thread marked it busy. Drop this
+                   event; the fd is level triggered and the running
+                   handler re-arms it when done. */
+                if (event_pool->reg[idx].in_handler)
+                        goto unlock;
+
+                event_pool->reg[idx].in_handler = 1;
+
+                fd = event_pool->reg[idx].fd;
                 handler = event_pool->reg[idx].handler;
                 data = event_pool->reg[idx].data;
         }
 unlock:
         pthread_mutex_unlock (&event_pool->mutex);
 
-        if (handler)
-                ret = handler (event_data->fd, event_data->idx, data,
-                               (events[i].events & (EPOLLIN|EPOLLPRI)),
-                               (events[i].events & (EPOLLOUT)),
-                               (events[i].events & (EPOLLERR|EPOLLHUP)));
+        if (!handler)
+                goto out;
+
+        ret = handler (fd, idx, data,
+                       (event->events & (EPOLLIN|EPOLLPRI)),
+                       (event->events & (EPOLLOUT)),
+                       (event->events & (EPOLLERR|EPOLLHUP)));
+
+        event_handled_epoll (event_pool, idx, gen);
+out:
         return ret;
 }
 
 
-static int
-event_dispatch_epoll (struct event_pool *event_pool)
-{
-        struct epoll_event *events = NULL;
-        int                 size = 0;
-        int                 i = 0;
-        int                 ret = -1;
+struct event_thread_data {
+        struct event_pool *event_pool;
+        int                index;
+};
 
-        GF_VALIDATE_OR_GOTO ("event", event_pool, out);
 
-        while (1) {
-                pthread_mutex_lock (&event_pool->mutex);
-                {
-                        while (event_pool->used == 0)
-                                pthread_cond_wait (&event_pool->cond,
-                                                   &event_pool->mutex);
-
-                        if (event_pool->used > event_pool->evcache_size) {
-                                if (event_pool->evcache)
-                                        GF_FREE (event_pool->evcache);
+static void *
+event_dispatch_epoll_worker (void *data)
+{
+        struct event_thread_data *ev_data = data;
+        struct event_pool        *event_pool = NULL;
+        struct epoll_event        event = {0, };
+        int                       index = 0;
+        int                       ret = -1;
 
-                                event_pool->evcache = events = NULL;
+        event_pool = ev_data->event_pool;
+        index = ev_data->index;
+        GF_FREE (ev_data);
 
-                                event_pool->evcache_size =
-                                        event_pool->used + 256;
+        gf_log ("epoll", GF_LOG_DEBUG, "started event dispatcher thread %d",
+                index);
 
-                                events = GF_CALLOC (event_pool->evcache_size,
-                                                    sizeof (struct epoll_event),
-                                                    gf_common_mt_epoll_event);
-                                if (!events)
+        while (1) {
+                if (index > 0) {
+                        /* threads beyond the configured count retire */
+                        pthread_mutex_lock (&event_pool->mutex);
+                        {
+                                if (index >= event_pool->eventthreadcount) {
+                                        event_pool->poller_active[index] = 0;
+                                        pthread_mutex_unlock (&event_pool->mutex);
+                                        gf_log ("epoll", GF_LOG_DEBUG,
+                                                "exiting event dispatcher "
+                                                "thread %d", index);
                                         break;
-
-                                event_pool->evcache = events;
+                                }
                         }
+                        pthread_mutex_unlock (&event_pool->mutex);
                 }
-                pthread_mutex_unlock (&event_pool->mutex);
 
-                ret = epoll_wait (event_pool->fd, event_pool->evcache,
-                                  event_pool->evcache_size, -1);
+                /* one event per wakeup, so that a single thread never
+                   holds on to ready fds which other threads could serve */
+                ret = epoll_wait (event_pool->fd, &event, 1, -1);
 
                 if (ret == 0)
                         /* timeout */
@@ -838,28 +942,137 @@ event_dispatch_epoll (struct event_pool *event_pool)
                         /* sys call */
                         continue;
 
-                size = ret;
+                if (ret == -1) {
+                        gf_log ("epoll", GF_LOG_ERROR,
+                                "epoll_wait failed (%s)", strerror (errno));
+                        continue;
+                }
+
+                if (!event.events)
+                        continue;
+
+                event_dispatch_epoll_handler (event_pool, &event);
+        }
+
+        return NULL;
+}
 
-                for (i = 0; i < size; i++) {
-                        if (!events || !events[i].events)
-                                continue;
 
-                        ret = event_dispatch_epoll_handler (event_pool,
-                                                            events, i);
+static int
+__event_start_pollers (struct event_pool *event_pool)
+{
+        struct event_thread_data *ev_data = NULL;
+        int                       i = 0;
+        int                       ret = 0;
+
+        /* index 0 is the thread which called event_dispatch() */
+        for (i = 1; i < event_pool->eventthreadcount; i++) {
+                if (event_pool->poller_active[i])
+                        continue;
+
+                ev_data = GF_CALLOC (1, sizeof (*ev_data),
+                                     gf_common_mt_event_thread_data);
+                if (!ev_data) {
+                        ret = -1;
+                        break;
                 }
+
+                ev_data->event_pool = event_pool;
+                ev_data->index = i;
+
+                ret = pthread_create (&event_pool->pollers[i], NULL,
+                                      event_dispatch_epoll_worker, ev_data);
+                if (ret != 0) {
+                        gf_log ("epoll", GF_LOG_WARNING,
+                                "failed to start event dispatcher thread "
+                                "%d (%s)", i, strerror (ret));
+                        GF_FREE (ev_data);
+                        ret = -1;
+                        break;
+                }
+
+                pthread_detach (event_pool->pollers[i]);
+                event_pool->poller_active[i] = 1;
         }
 
+        return ret;
+}
+
+
+static int
+event_dispatch_epoll (struct event_pool *event_pool)
+{
+        struct event_thread_data *ev_data = NULL;
+        int                       ret = -1;
+
+        GF_VALIDATE_OR_GOTO ("event", event_pool, out);
+
+        ev_data = GF_CALLOC (1, sizeof (*ev_data),
+                             gf_common_mt_event_thread_data);
+        if (!ev_data)
+                goto out;
+
+        ev_data->event_pool = event_pool;
+        ev_data->index = 0;
+
+        pthread_mutex_lock (&event_pool->mutex);
+        {
+                event_pool->dispatching = 1;
+                event_pool->poller_active[0] = 1;
+                __event_start_pollers (event_pool);
+        }
+        pthread_mutex_unlock (&event_pool->mutex);
+
+        event_dispatch_epoll_worker (ev_data);
+        ret = 0;
 out:
         return ret;
 }
 
 
+static int
+event_reconfigure_threads_epoll (struct event_pool *event_pool, int value)
+{
+        int ret = 0;
+
+        if (value < 1)
+                value = 1;
+
+        if (value > EVENT_MAX_THREADS) {
+                gf_log ("epoll", GF_LOG_WARNING,
+                        "event threads %d exceeds maximum, using %d",
+                        value, EVENT_MAX_THREADS);
+                value = EVENT_MAX_THREADS;
+        }
+
+        pthread_mutex_lock (&event_pool->mutex);
+        {
+                if (event_pool->eventthreadcount != value)
+                        gf_log ("epoll", GF_LOG_INFO,
+                                "changing event dispatcher threads from "
+                                "%d to %d", event_pool->eventthreadcount,
+                                value);
+
+                event_pool->eventthreadcount = value;
+
+                /* surplus threads notice the lower count on their next
+                   wakeup and exit on their own */
+                if (event_pool->dispatching)
+                        ret = __event_start_pollers (event_pool);
+        }
+        pthread_mutex_unlock (&event_pool->mutex);
+
+        return ret;
+}
+
+
 static struct event_ops event_ops_epoll = {
         .new              = event_pool_new_epoll,
         .event_register   = event_register_epoll,
         .event_select_on  = event_select_on_epoll,
         .event_unregister = event_unregister_epoll,
-        .event_dispatch   = event_dispatch_epoll
+        .event_dispatch   = event_dispatch_epoll,
+        .event_reconfigure_threads = event_reconfigure_threads_epoll
 };
 
 #endif
@@ -949,3 +1162,17 @@ event_dispatch (struct event_pool *event_pool)
 out:
         return ret;
 }
+
+
+int
+event_reconfigure_threads (struct event_pool *event_pool, int value)
+{
+        int ret = -1;
+
+        GF_VALIDATE_OR_GOTO ("event", event_pool, out);
+
+        ret = event_pool->ops->event_reconfigure_threads (event_pool, value);
+
+out:
+        return ret;
+}
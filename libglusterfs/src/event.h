@@ -18,11 +18,13 @@
 
 #include <pthread.h>
 
+#define EVENT_MAX_THREADS 32
+
 struct event_pool;
 struct event_ops;
 struct event_data {
-  int fd;
   int idx;
+  int gen;
 } __attribute__ ((__packed__, __may_alias__));
 
 
@@ -41,6 +43,8 @@ struct event_pool {
     int events;
     void *data;
     event_handler_t handler;
+    int gen;        /* bumped on every (re)use of the slot */
+    int in_handler; /* a dispatcher thread is running the handler */
   } *reg;
 
   int used;
@@ -52,6 +56,12 @@ struct event_pool {
 
   void *evcache;
   int evcache_size;
+
+  /* multi-threaded dispatch (epoll only) */
+  int eventthreadcount;   /* number of dispatcher threads wanted */
+  int dispatching;        /* event_dispatch() has been called */
+  pthread_t pollers[EVENT_MAX_THREADS];
+  int poller_active[EVENT_MAX_THREADS];
 };
 
 struct event_ops {
@@ -67,6 +77,9 @@ struct event_ops {
         int (*event_unregister) (struct event_pool *event_pool, int fd, int idx);
 
         int (*event_dispatch) (struct event_pool *event_pool);
+
+        int (*event_reconfigure_threads) (struct event_pool *event_pool,
+                                          int newcount);
 };
 
 struct event_pool * event_pool_new (int count);
@@ -77,5 +90,6 @@ int event_register (struct event_pool *event_pool, int fd,
 		    void *data, int poll_in, int poll_out);
 int event_unregister (struct event_pool *event_pool, int fd, int idx);
 int event_dispatch (struct event_pool *event_pool);
+int event_reconfigure_threads (struct event_pool *event_pool, int value);
 
 #endif /* _EVENT_H_ */
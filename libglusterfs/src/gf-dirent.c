@@ -67,10 +67,11 @@ gf_dirent_free (gf_dirent_t *entries)
         }
 }
 
-/* TODO: Currently, with this function, we will be breaking the
-   policy of 1-1 mapping of kernel nlookup refs with our inode_t's
-   nlookup count.
-   Need more thoughts before finalizing this function
+/* Every entry carrying an inode takes one lookup count, so the caller
+   has to drop the inodes of entries it is not going to hand out (fuse
+   keeps a 1-1 mapping of kernel nlookup refs with our inode_t's nlookup
+   count).  On return entry->inode is the linked inode, or NULL if the
+   entry could not be linked.
 */
 int
 gf_link_inodes_from_dirent (xlator_t *this, inode_t *parent,
@@ -80,12 +81,15 @@ gf_link_inodes_from_dirent (xlator_t *this, inode_t *parent,
         inode_t     *link_inode = NULL;
 
         list_for_each_entry (entry, &entries->list, list) {
-                if (entry->inode) {
-                        link_inode = inode_link (entry->inode, parent,
-                                                 entry->d_name, &entry->d_stat);
+                if (!entry->inode)
+                        continue;
+
+                link_inode = inode_link (entry->inode, parent,
+                                         entry->d_name, &entry->d_stat);
+                inode_unref (entry->inode);
+                entry->inode = link_inode;
+                if (link_inode)
                         inode_lookup (link_inode);
-                        inode_unref (link_inode);
-                }
         }
 
         return 0;
@@ -85,6 +85,10 @@
 
 #define GLUSTERFS_INTERNAL_FOP_KEY  "glusterfs-internal-fop"
 
+/* zerofill request xdata: do not extend the file, as with
+   FALLOC_FL_ZERO_RANGE|FALLOC_FL_KEEP_SIZE */
+#define GF_ZEROFILL_KEEP_SIZE_KEY   "glusterfs.zerofill.keep-size"
+
 #define ZR_FILE_CONTENT_STR     "glusterfs.file."
 #define ZR_FILE_CONTENT_STRLEN 15
 
@@ -175,9 +179,20 @@ typedef enum {
         GF_FOP_RELEASEDIR,
         GF_FOP_GETSPEC,
         GF_FOP_FREMOVEXATTR,
+        GF_FOP_FALLOCATE,
+        GF_FOP_DISCARD,
+        GF_FOP_ZEROFILL,
+        GF_FOP_SEEK,
+        GF_FOP_COMPOUND,
         GF_FOP_MAXVALUE,
 } glusterfs_fop_t;
 
+/* what the seek fop looks for, mirrors lseek's SEEK_DATA/SEEK_HOLE */
+typedef enum {
+        GF_SEEK_DATA,
+        GF_SEEK_HOLE,
+} gf_seek_what_t;
+
 
 typedef enum {
         GF_MGMT_NULL = 0,
@@ -285,6 +300,7 @@ struct _cmd_args {
         int              selinux;
         int              worm;
         int              mac_compat;
+        int              event_threads;
 	struct list_head xlator_options;  /* list of xlator_option_t */
 
 	/* fuse options */
@@ -299,6 +315,11 @@ struct _cmd_args {
         pid_t            client_pid;
         int              client_pid_set;
         unsigned         uid_map_root;
+        int              reader_thread_count;
+        uint32_t         fuse_max_write;
+        uint32_t         fuse_max_readahead;
+        int              fuse_use_readdirp;
+        int              fuse_splice;
 
 
 	/* key args */
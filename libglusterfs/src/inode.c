@@ -78,6 +78,47 @@ hash_gfid (uuid_t uuid, int mod)
 }
 
 
+#define inode_hash_shard(table, hash)                                   \
+        (&(table)->inode_hash_lock[(hash) % INODE_TABLE_SHARDS])
+
+#define name_hash_shard(table, hash)                                    \
+        (&(table)->name_hash_lock[(hash) % INODE_TABLE_SHARDS])
+
+
+/* take a reference without table->lock, possible only as long as the
+   inode is active. returns 0 if the caller has to fall back to
+   __inode_ref() under table->lock */
+static int
+inode_ref_active (inode_t *inode)
+{
+        uint32_t ref = 0;
+
+        do {
+                ref = *(volatile uint32_t *)&inode->ref;
+                if (!ref)
+                        return 0;
+        } while (!__sync_bool_compare_and_swap (&inode->ref, ref, ref + 1));
+
+        return 1;
+}
+
+
+/* drop a reference without table->lock, unless it is the last one */
+static int
+inode_unref_active (inode_t *inode)
+{
+        uint32_t ref = 0;
+
+        do {
+                ref = *(volatile uint32_t *)&inode->ref;
+                if (ref <= 1)
+                        return 0;
+        } while (!__sync_bool_compare_and_swap (&inode->ref, ref, ref - 1));
+
+        return 1;
+}
+
+
 static void
 __dentry_hash (dentry_t *dentry)
 {
@@ -93,8 +134,12 @@ __dentry_hash (dentry_t *dentry)
         hash = hash_dentry (dentry->parent, dentry->name,
                             table->hashsize);
 
-        list_del_init (&dentry->hash);
-        list_add (&dentry->hash, &table->name_hash[hash]);
+        pthread_rwlock_wrlock (name_hash_shard (table, hash));
+        {
+                list_del_init (&dentry->hash);
+                list_add (&dentry->hash, &table->name_hash[hash]);
+        }
+        pthread_rwlock_unlock (name_hash_shard (table, hash));
 }
 
 
@@ -113,12 +158,26 @@ __is_dentry_hashed (dentry_t *dentry)
 static void
 __dentry_unhash (dentry_t *dentry)
 {
+        inode_table_t   *table = NULL;
+        int              hash = 0;
+
         if (!dentry) {
                 gf_log_callingfn (THIS->name, GF_LOG_WARNING, "dentry not found");
                 return;
         }
 
-        list_del_init (&dentry->hash);
+        if (list_empty (&dentry->hash))
+                return;
+
+        table = dentry->inode->table;
+        hash = hash_dentry (dentry->parent, dentry->name,
+                            table->hashsize);
+
+        pthread_rwlock_wrlock (name_hash_shard (table, hash));
+        {
+                list_del_init (&dentry->hash);
+        }
+        pthread_rwlock_unlock (name_hash_shard (table, hash));
 }
 
 
@@ -225,12 +284,23 @@ __is_dentry_cyclic (dentry_t *dentry)
 static void
 __inode_unhash (inode_t *inode)
 {
+        int            hash = 0;
+
         if (!inode) {
                 gf_log_callingfn (THIS->name, GF_LOG_WARNING, "inode not found");
                 return;
         }
 
-        list_del_init (&inode->hash);
+        if (list_empty (&inode->hash))
+                return;
+
+        hash = hash_gfid (inode->gfid, 65536);
+
+        pthread_rwlock_wrlock (inode_hash_shard (inode->table, hash));
+        {
+                list_del_init (&inode->hash);
+        }
+        pthread_rwlock_unlock (inode_hash_shard (inode->table, hash));
 }
 
 
@@ -260,8 +330,12 @@ __inode_hash (inode_t *inode)
         table = inode->table;
         hash = hash_gfid (inode->gfid, 65536);
 
-        list_del_init (&inode->hash);
-        list_add (&inode->hash, &table->inode_hash[hash]);
+        pthread_rwlock_wrlock (inode_hash_shard (table, hash));
+        {
+                list_del_init (&inode->hash);
+                list_add (&inode->hash, &table->inode_hash[hash]);
+        }
+        pthread_rwlock_unlock (inode_hash_shard (table, hash));
 }
 
 
@@ -395,9 +469,9 @@ __inode_unref (inode_t *inode)
 
         GF_ASSERT (inode->ref);
 
-        --inode->ref;
-
-        if (!inode->ref) {
+        /* lockless inode_ref_active() can race with us, but never takes
+           the count from 0, so the transition is decided here */
+        if (!__sync_sub_and_fetch (&inode->ref, 1)) {
                 inode->table->active_size--;
 
                 if (inode->nlookup)
@@ -420,7 +494,7 @@ __inode_ref (inode_t *inode)
                 inode->table->lru_size--;
                 __inode_activate (inode);
         }
-        inode->ref++;
+        __sync_add_and_fetch (&inode->ref, 1);
 
         return inode;
 }
@@ -434,6 +508,12 @@ inode_unref (inode_t *inode)
         if (!inode)
                 return NULL;
 
+        if (__is_root_gfid (inode->gfid))
+                return inode;
+
+        if (inode_unref_active (inode))
+                return inode;
+
         table = inode->table;
 
         pthread_mutex_lock (&table->lock);
@@ -456,6 +536,9 @@ inode_ref (inode_t *inode)
         if (!inode)
                 return NULL;
 
+        if (inode_ref_active (inode))
+                return inode;
+
         table = inode->table;
 
         pthread_mutex_lock (&table->lock);
@@ -629,6 +712,8 @@ inode_grep (inode_table_t *table, inode_t *parent, const char *name)
 {
         inode_t   *inode = NULL;
         dentry_t  *dentry = NULL;
+        int        hash = 0;
+        int        active = 0;
 
         if (!table || !parent || !name) {
                 gf_log_callingfn (THIS->name, GF_LOG_WARNING,
@@ -636,6 +721,25 @@ inode_grep (inode_table_t *table, inode_t *parent, const char *name)
                 return NULL;
         }
 
+        hash = hash_dentry (parent, name, table->hashsize);
+
+        pthread_rwlock_rdlock (name_hash_shard (table, hash));
+        {
+                dentry = __dentry_grep (table, parent, name);
+
+                if (dentry)
+                        inode = dentry->inode;
+
+                if (inode)
+                        active = inode_ref_active (inode);
+        }
+        pthread_rwlock_unlock (name_hash_shard (table, hash));
+
+        if (!inode || active)
+                return inode;
+
+        /* the inode is in lru, activating it needs the table lock */
+        inode = NULL;
         pthread_mutex_lock (&table->lock);
         {
                 dentry = __dentry_grep (table, parent, name);
@@ -701,6 +805,7 @@ inode_grep_for_gfid (inode_table_t *table, inode_t *parent, const char *name,
 {
         inode_t   *inode = NULL;
         dentry_t  *dentry = NULL;
+        int        hash = 0;
         int        ret = -1;
 
         if (!table || !parent || !name) {
@@ -709,7 +814,9 @@ inode_grep_for_gfid (inode_table_t *table, inode_t *parent, const char *name,
                 return ret;
         }
 
-        pthread_mutex_lock (&table->lock);
+        hash = hash_dentry (parent, name, table->hashsize);
+
+        pthread_rwlock_rdlock (name_hash_shard (table, hash));
         {
                 dentry = __dentry_grep (table, parent, name);
 
@@ -722,7 +829,7 @@ inode_grep_for_gfid (inode_table_t *table, inode_t *parent, const char *name,
                         ret = 0;
                 }
         }
-        pthread_mutex_unlock (&table->lock);
+        pthread_rwlock_unlock (name_hash_shard (table, hash));
 
         return ret;
 }
@@ -777,12 +884,28 @@ inode_t *
 inode_find (inode_table_t *table, uuid_t gfid)
 {
         inode_t   *inode = NULL;
+        int        hash = 0;
+        int        active = 0;
 
         if (!table) {
                 gf_log_callingfn (THIS->name, GF_LOG_WARNING, "table not found");
                 return NULL;
         }
 
+        hash = hash_gfid (gfid, 65536);
+
+        pthread_rwlock_rdlock (inode_hash_shard (table, hash));
+        {
+                inode = __inode_find (table, gfid);
+                if (inode)
+                        active = inode_ref_active (inode);
+        }
+        pthread_rwlock_unlock (inode_hash_shard (table, hash));
+
+        if (!inode || active)
+                return inode;
+
+        /* the inode is in lru, activating it needs the table lock */
         pthread_mutex_lock (&table->lock);
         {
                 inode = __inode_find (table, gfid);
@@ -951,6 +1074,50 @@ inode_forget (inode_t *inode, uint64_t nlookup)
 }
 
 
+/* Forget a batch of inodes with one table lock and one prune for each run
+   of inodes from the same table. The caller's lookup counts keep the
+   inodes alive, so no reference has to be held on them.
+*/
+int
+inode_forget_many (inode_forget_t *forgets, int count)
+{
+        inode_table_t *table = NULL;
+        inode_t       *inode = NULL;
+        int            i     = 0;
+
+        if (!forgets)
+                return -1;
+
+        for (i = 0; i < count; i++) {
+                inode = forgets[i].inode;
+                if (!inode || __is_root_gfid (inode->gfid))
+                        continue;
+
+                if (inode->table != table) {
+                        if (table) {
+                                pthread_mutex_unlock (&table->lock);
+                                inode_table_prune (table);
+                        }
+                        table = inode->table;
+                        pthread_mutex_lock (&table->lock);
+                }
+
+                /* the ref/unref pair retires an unreferenced inode whose
+                   last lookup is gone, as inode_unref() would */
+                __inode_ref (inode);
+                __inode_forget (inode, forgets[i].nlookup);
+                __inode_unref (inode);
+        }
+
+        if (table) {
+                pthread_mutex_unlock (&table->lock);
+                inode_table_prune (table);
+        }
+
+        return 0;
+}
+
+
 static void
 __inode_unlink (inode_t *inode, inode_t *parent, const char *name)
 {
@@ -1208,6 +1375,13 @@ inode_table_prune (inode_table_t *table)
         if (!table)
                 return -1;
 
+        /* called after every change of the table, unlocked peek so that
+           the common case of nothing to prune does not take the lock
+           again. a stale value only delays the pruning to the next call */
+        if (!table->purge_size &&
+            !(table->lru_limit && table->lru_size > table->lru_limit))
+                return 0;
+
         INIT_LIST_HEAD (&purge);
 
         pthread_mutex_lock (&table->lock);
@@ -1319,6 +1493,11 @@ inode_table_new (size_t lru_limit, xlator_t *xl)
                 INIT_LIST_HEAD (&new->name_hash[i]);
         }
 
+        for (i = 0; i < INODE_TABLE_SHARDS; i++) {
+                pthread_rwlock_init (&new->inode_hash_lock[i], NULL);
+                pthread_rwlock_init (&new->name_hash_lock[i], NULL);
+        }
+
         INIT_LIST_HEAD (&new->active);
         INIT_LIST_HEAD (&new->lru);
         INIT_LIST_HEAD (&new->purge);
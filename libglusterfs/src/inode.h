@@ -20,6 +20,7 @@
 #include <sys/types.h>
 
 #define DEFAULT_INODE_MEMPOOL_ENTRIES   32 * 1024
+#define INODE_TABLE_SHARDS              64
 #define INODE_PATH_FMT "<gfid:%s>"
 struct _inode_table;
 typedef struct _inode_table inode_table_t;
@@ -30,12 +31,28 @@ typedef struct _inode inode_t;
 struct _dentry;
 typedef struct _dentry dentry_t;
 
+struct _inode_forget;
+typedef struct _inode_forget inode_forget_t;
+
 #include "list.h"
 #include "xlator.h"
 #include "iatt.h"
 #include "uuid.h"
 
 
+/* Locking of the inode table:
+
+   - table->lock serializes all the changes of the table: linking and
+     unlinking of dentries, hashing and unhashing of inodes and the
+     active/lru/purge lists.
+   - the inode and name hash buckets are split into INODE_TABLE_SHARDS
+     shards, each with its own rwlock. Changes take the shard for write
+     while holding table->lock; inode_find() and inode_grep() take only
+     the shard for read, so lookups of different entries never contend.
+   - inode->ref is updated atomically. Taking or dropping a reference
+     which does not change the list of the inode (ref stays above 0) is
+     done without any lock, only the 0 <-> 1 transitions need table->lock.
+*/
 struct _inode_table {
         pthread_mutex_t    lock;
         size_t             hashsize;    /* bucket size of inode hash and dentry hash */
@@ -45,6 +62,8 @@ struct _inode_table {
         uint32_t           lru_limit;   /* maximum LRU cache size */
         struct list_head  *inode_hash;  /* buckets for inode hash table */
         struct list_head  *name_hash;   /* buckets for dentry hash table */
+        pthread_rwlock_t   inode_hash_lock[INODE_TABLE_SHARDS];
+        pthread_rwlock_t   name_hash_lock[INODE_TABLE_SHARDS];
         struct list_head   active;      /* list of inodes currently active (in an fop) */
         uint32_t           active_size; /* count of inodes in active list */
         struct list_head   lru;         /* list of inodes recently used.
@@ -67,6 +86,12 @@ struct _dentry {
         inode_t           *parent;       /* directory of the entry */
 };
 
+/* one entry of a batch handed to inode_forget_many() */
+struct _inode_forget {
+        inode_t  *inode;
+        uint64_t  nlookup;
+};
+
 struct _inode_ctx {
         union {
                 uint64_t    key;
@@ -130,6 +155,9 @@ inode_lookup (inode_t *inode);
 int
 inode_forget (inode_t *inode, uint64_t nlookup);
 
+int
+inode_forget_many (inode_forget_t *forgets, int count);
+
 int
 inode_rename (inode_table_t *table, inode_t *olddir, const char *oldname,
 	      inode_t *newdir, const char *newname,
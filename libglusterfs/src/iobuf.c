@@ -12,62 +12,139 @@
 #include "iobuf.h"
 #include "statedump.h"
 #include <stdio.h>
+#include <sched.h>
+
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif
 
 
 /*
   TODO: implement destroy margins and prefetching of arenas
 */
 
-#define IOBUF_ARENA_MAX_INDEX  (sizeof (gf_iobuf_init_config) /         \
-                                (sizeof (struct iobuf_init_config)))
+#define IOBUF_ARENA_MAX_INDEX(iobuf_pool) ((iobuf_pool)->class_cnt)
 
-/* Make sure this array is sorted based on pagesize */
+/* Make sure this array is sorted based on pagesize. Power of two classes,
+   so that a request never wastes more than half of the iobuf it gets */
 struct iobuf_init_config gf_iobuf_init_config[] = {
         /* { pagesize, num_pages }, */
         {128, 1024},
         {512, 512},
         {2 * 1024, 512},
+        {4 * 1024, 512},
         {8 * 1024, 128},
+        {16 * 1024, 128},
         {32 * 1024, 64},
+        {64 * 1024, 64},
         {128 * 1024, 32},
         {256 * 1024, 8},
+        {512 * 1024, 4},
         {1 * 1024 * 1024, 2},
 };
 
+#define IOBUF_INIT_CONFIG_COUNT (sizeof (gf_iobuf_init_config) /        \
+                                 (sizeof (struct iobuf_init_config)))
+
+/* index of the smallest enabled class which can hold @page_size */
 int
-gf_iobuf_get_arena_index (size_t page_size)
+gf_iobuf_get_arena_index (struct iobuf_pool *iobuf_pool, size_t page_size)
 {
         int i = -1;
 
-        for (i = 0; i < IOBUF_ARENA_MAX_INDEX; i++) {
-                if (page_size <= gf_iobuf_init_config[i].pagesize)
+        for (i = 0; i < IOBUF_ARENA_MAX_INDEX (iobuf_pool); i++) {
+                if (page_size <= iobuf_pool->config[i].pagesize &&
+                    iobuf_pool->config[i].num_pages)
                         break;
         }
 
-        if (i >= IOBUF_ARENA_MAX_INDEX)
+        if (i >= IOBUF_ARENA_MAX_INDEX (iobuf_pool))
                 i = -1;
 
         return i;
 }
 
 size_t
-gf_iobuf_get_pagesize (size_t page_size)
+gf_iobuf_get_pagesize (struct iobuf_pool *iobuf_pool, size_t page_size)
 {
         int    i    = 0;
-        size_t size = 0;
+        size_t size = -1;
 
-        for (i = 0; i < IOBUF_ARENA_MAX_INDEX; i++) {
-                size = gf_iobuf_init_config[i].pagesize;
-                if (page_size <= size)
-                        break;
+        i = gf_iobuf_get_arena_index (iobuf_pool, page_size);
+        if (i != -1)
+                size = iobuf_pool->config[i].pagesize;
+
+        return size;
+}
+
+
+static int
+iobuf_pool_current_node (struct iobuf_pool *iobuf_pool)
+{
+        int node = 0;
+#ifdef HAVE_LIBNUMA
+        int cpu  = -1;
+
+        if (!iobuf_pool->numa)
+                goto out;
+
+        cpu = sched_getcpu ();
+        if (cpu < 0 || cpu >= iobuf_pool->cpu_cnt)
+                goto out;
+
+        node = iobuf_pool->cpu_to_node[cpu];
+out:
+#endif
+        return node;
+}
+
+
+static void
+iobuf_pool_numa_init (struct iobuf_pool *iobuf_pool)
+{
+#ifdef HAVE_LIBNUMA
+        int cpu  = 0;
+        int node = 0;
+
+        if (numa_available () < 0)
+                return;
+
+        iobuf_pool->cpu_cnt = numa_num_configured_cpus ();
+        iobuf_pool->cpu_to_node = GF_CALLOC (iobuf_pool->cpu_cnt,
+                                             sizeof (int),
+                                             gf_common_mt_iobuf_node_map);
+        if (!iobuf_pool->cpu_to_node) {
+                iobuf_pool->cpu_cnt = 0;
+                return;
         }
 
-        if (i >= IOBUF_ARENA_MAX_INDEX)
-                size = -1;
+        for (cpu = 0; cpu < iobuf_pool->cpu_cnt; cpu++) {
+                node = numa_node_of_cpu (cpu);
+                if (node < 0 || node > numa_max_node ())
+                        node = 0;
+                iobuf_pool->cpu_to_node[cpu] = node;
+        }
 
-        return size;
+        iobuf_pool->node_cnt = numa_max_node () + 1;
+#endif
+        return;
 }
 
+
+static void
+iobuf_arena_bind_node (struct iobuf_arena *iobuf_arena)
+{
+#ifdef HAVE_LIBNUMA
+        if (!iobuf_arena->iobuf_pool->numa)
+                return;
+
+        numa_tonode_memory (iobuf_arena->mem_base, iobuf_arena->arena_size,
+                            iobuf_arena->node);
+#endif
+        return;
+}
+
+
 void
 __iobuf_arena_init_iobufs (struct iobuf_arena *iobuf_arena)
 {
@@ -155,11 +232,9 @@ out:
 
 
 struct iobuf_arena *
-__iobuf_arena_alloc (struct iobuf_pool *iobuf_pool, size_t page_size,
-                     int32_t num_iobufs)
+__iobuf_arena_alloc (struct iobuf_pool *iobuf_pool, int index, int node)
 {
         struct iobuf_arena *iobuf_arena = NULL;
-        size_t              rounded_size = 0;
 
         GF_VALIDATE_OR_GOTO ("iobuf", iobuf_pool, out);
 
@@ -173,12 +248,13 @@ __iobuf_arena_alloc (struct iobuf_pool *iobuf_pool, size_t page_size,
         INIT_LIST_HEAD (&iobuf_arena->passive.list);
         iobuf_arena->iobuf_pool = iobuf_pool;
 
-        rounded_size = gf_iobuf_get_pagesize (page_size);
+        iobuf_arena->index      = index;
+        iobuf_arena->node       = node;
+        iobuf_arena->page_size  = iobuf_pool->config[index].pagesize;
+        iobuf_arena->page_count = iobuf_pool->config[index].num_pages;
 
-        iobuf_arena->page_size  = rounded_size;
-        iobuf_arena->page_count = num_iobufs;
-
-        iobuf_arena->arena_size = rounded_size * num_iobufs;
+        iobuf_arena->arena_size = iobuf_arena->page_size *
+                                  iobuf_arena->page_count;
 
         iobuf_arena->mem_base = mmap (NULL, iobuf_arena->arena_size,
                                       PROT_READ|PROT_WRITE,
@@ -188,6 +264,8 @@ __iobuf_arena_alloc (struct iobuf_pool *iobuf_pool, size_t page_size,
                 goto err;
         }
 
+        iobuf_arena_bind_node (iobuf_arena);
+
         __iobuf_arena_init_iobufs (iobuf_arena);
         if (!iobuf_arena->iobufs) {
                 gf_log (THIS->name, GF_LOG_ERROR, "init failed");
@@ -195,6 +273,7 @@ __iobuf_arena_alloc (struct iobuf_pool *iobuf_pool, size_t page_size,
         }
 
         iobuf_pool->arena_cnt++;
+        iobuf_pool->stats[index].arena_adds++;
 
         return iobuf_arena;
 
@@ -207,23 +286,15 @@ out:
 
 
 struct iobuf_arena *
-__iobuf_arena_unprune (struct iobuf_pool *iobuf_pool, size_t page_size)
+__iobuf_arena_unprune (struct iobuf_pool *iobuf_pool, int index, int node)
 {
         struct iobuf_arena *iobuf_arena  = NULL;
         struct iobuf_arena *tmp          = NULL;
-        int                 index        = 0;
 
         GF_VALIDATE_OR_GOTO ("iobuf", iobuf_pool, out);
 
-        index = gf_iobuf_get_arena_index (page_size);
-        if (index == -1) {
-                gf_log ("iobuf", GF_LOG_ERROR, "page_size (%zu) of "
-                        "iobufs in arena being added is greater than max "
-                        "available", page_size);
-                return NULL;
-        }
-
-        list_for_each_entry (tmp, &iobuf_pool->purge[index], list) {
+        list_for_each_entry (tmp, iobuf_pool_list (iobuf_pool, purge,
+                                                   node, index), list) {
                 list_del_init (&tmp->list);
                 iobuf_arena = tmp;
                 break;
@@ -234,74 +305,57 @@ out:
 
 
 struct iobuf_arena *
-__iobuf_pool_add_arena (struct iobuf_pool *iobuf_pool, size_t page_size,
-                        int32_t num_pages)
+__iobuf_pool_add_arena (struct iobuf_pool *iobuf_pool, int index, int node)
 {
         struct iobuf_arena *iobuf_arena  = NULL;
-        int                 index        = 0;
-
-        index = gf_iobuf_get_arena_index (page_size);
-        if (index == -1) {
-                gf_log ("iobuf", GF_LOG_ERROR, "page_size (%zu) of "
-                        "iobufs in arena being added is greater than max "
-                        "available", page_size);
-                return NULL;
-        }
 
-        iobuf_arena = __iobuf_arena_unprune (iobuf_pool, page_size);
+        iobuf_arena = __iobuf_arena_unprune (iobuf_pool, index, node);
 
         if (!iobuf_arena)
-                iobuf_arena = __iobuf_arena_alloc (iobuf_pool, page_size,
-                                                   num_pages);
+                iobuf_arena = __iobuf_arena_alloc (iobuf_pool, index, node);
 
         if (!iobuf_arena) {
                 gf_log (THIS->name, GF_LOG_WARNING, "arena not found");
                 return NULL;
         }
 
-        list_add_tail (&iobuf_arena->list, &iobuf_pool->arenas[index]);
+        list_add_tail (&iobuf_arena->list,
+                       iobuf_pool_list (iobuf_pool, arenas, node, index));
 
         return iobuf_arena;
 }
 
 
-struct iobuf_arena *
-iobuf_pool_add_arena (struct iobuf_pool *iobuf_pool, size_t page_size,
-                      int32_t num_pages)
+static void
+__iobuf_pool_destroy_list (struct iobuf_pool *iobuf_pool,
+                           struct list_head *head)
 {
         struct iobuf_arena *iobuf_arena = NULL;
+        struct iobuf_arena *tmp         = NULL;
 
-        GF_VALIDATE_OR_GOTO ("iobuf", iobuf_pool, out);
-
-        pthread_mutex_lock (&iobuf_pool->mutex);
-        {
-                iobuf_arena = __iobuf_pool_add_arena (iobuf_pool, page_size,
-                                                      num_pages);
+        list_for_each_entry_safe (iobuf_arena, tmp, head, list) {
+                list_del_init (&iobuf_arena->list);
+                iobuf_pool->arena_cnt--;
+                __iobuf_arena_destroy (iobuf_arena);
         }
-        pthread_mutex_unlock (&iobuf_pool->mutex);
-
-out:
-        return iobuf_arena;
 }
 
 
 void
 iobuf_pool_destroy (struct iobuf_pool *iobuf_pool)
 {
-        struct iobuf_arena *iobuf_arena = NULL;
-        struct iobuf_arena *tmp         = NULL;
         int                 i           = 0;
+        int                 node        = 0;
 
         GF_VALIDATE_OR_GOTO ("iobuf", iobuf_pool, out);
 
-        for (i = 0; i < IOBUF_ARENA_MAX_INDEX; i++) {
-                list_for_each_entry_safe (iobuf_arena, tmp,
-                                          &iobuf_pool->arenas[i], list) {
-                        list_del_init (&iobuf_arena->list);
-                        iobuf_pool->arena_cnt--;
-                        __iobuf_arena_destroy (iobuf_arena);
+        for (node = 0; node < iobuf_pool->node_cnt; node++) {
+                for (i = 0; i < IOBUF_ARENA_MAX_INDEX (iobuf_pool); i++) {
+                        __iobuf_pool_destroy_list (iobuf_pool,
+                                iobuf_pool_list (iobuf_pool, arenas, node, i));
+                        __iobuf_pool_destroy_list (iobuf_pool,
+                                iobuf_pool_list (iobuf_pool, purge, node, i));
                 }
-
         }
 
 out:
@@ -326,9 +380,11 @@ iobuf_create_stdalloc_arena (struct iobuf_pool *iobuf_pool)
         iobuf_arena->iobuf_pool = iobuf_pool;
 
         iobuf_arena->page_size = 0x7fffffff;
+        iobuf_arena->index = IOBUF_ARENA_MAX_INDEX (iobuf_pool);
 
         list_add_tail (&iobuf_arena->list,
-                       &iobuf_pool->arenas[IOBUF_ARENA_MAX_INDEX]);
+                       iobuf_pool_list (iobuf_pool, arenas, 0,
+                                        IOBUF_ARENA_MAX_INDEX (iobuf_pool)));
 
 err:
         return;
@@ -339,9 +395,8 @@ iobuf_pool_new (void)
 {
         struct iobuf_pool  *iobuf_pool = NULL;
         int                 i          = 0;
-        size_t              page_size  = 0;
         size_t              arena_size = 0;
-        int32_t             num_pages  = 0;
+        int                 list_cnt   = 0;
 
         iobuf_pool = GF_CALLOC (sizeof (*iobuf_pool), 1,
                                 gf_common_mt_iobuf_pool);
@@ -349,7 +404,25 @@ iobuf_pool_new (void)
                 goto out;
 
         pthread_mutex_init (&iobuf_pool->mutex, NULL);
-        for (i = 0; i <= IOBUF_ARENA_MAX_INDEX; i++) {
+
+        iobuf_pool->class_cnt = IOBUF_INIT_CONFIG_COUNT;
+        memcpy (iobuf_pool->config, gf_iobuf_init_config,
+                sizeof (gf_iobuf_init_config));
+
+        iobuf_pool->node_cnt = 1;
+        iobuf_pool_numa_init (iobuf_pool);
+
+        list_cnt = iobuf_pool->node_cnt * (iobuf_pool->class_cnt + 1);
+        iobuf_pool->arenas = GF_CALLOC (list_cnt, sizeof (struct list_head),
+                                        gf_common_mt_list_head);
+        iobuf_pool->filled = GF_CALLOC (list_cnt, sizeof (struct list_head),
+                                        gf_common_mt_list_head);
+        iobuf_pool->purge = GF_CALLOC (list_cnt, sizeof (struct list_head),
+                                       gf_common_mt_list_head);
+        if (!iobuf_pool->arenas || !iobuf_pool->filled || !iobuf_pool->purge)
+                goto err;
+
+        for (i = 0; i < list_cnt; i++) {
                 INIT_LIST_HEAD (&iobuf_pool->arenas[i]);
                 INIT_LIST_HEAD (&iobuf_pool->filled[i]);
                 INIT_LIST_HEAD (&iobuf_pool->purge[i]);
@@ -357,15 +430,11 @@ iobuf_pool_new (void)
 
         iobuf_pool->default_page_size  = 128 * GF_UNIT_KB;
 
+        /* arenas are mapped lazily, on the first request of each class */
         arena_size = 0;
-        for (i = 0; i < IOBUF_ARENA_MAX_INDEX; i++) {
-                page_size = gf_iobuf_init_config[i].pagesize;
-                num_pages = gf_iobuf_init_config[i].num_pages;
-
-                iobuf_pool_add_arena (iobuf_pool, page_size, num_pages);
-
-                arena_size += page_size * num_pages;
-        }
+        for (i = 0; i < IOBUF_ARENA_MAX_INDEX (iobuf_pool); i++)
+                arena_size += iobuf_pool->config[i].pagesize *
+                              iobuf_pool->config[i].num_pages;
 
         /* Need an arena to handle all the bigger iobuf requests */
         iobuf_create_stdalloc_arena (iobuf_pool);
@@ -374,6 +443,118 @@ iobuf_pool_new (void)
 out:
 
         return iobuf_pool;
+
+err:
+        if (iobuf_pool->arenas)
+                GF_FREE (iobuf_pool->arenas);
+        if (iobuf_pool->filled)
+                GF_FREE (iobuf_pool->filled);
+        if (iobuf_pool->purge)
+                GF_FREE (iobuf_pool->purge);
+        if (iobuf_pool->cpu_to_node)
+                GF_FREE (iobuf_pool->cpu_to_node);
+        GF_FREE (iobuf_pool);
+
+        return NULL;
+}
+
+
+/* @page_counts is a comma separated list of "<pagesize>:<num_pages>"
+   pairs, eg. "4KB:1024,1MB:8". It changes the number of iobufs mapped per
+   arena for the given size classes; a count of 0 disables the class and
+   its requests are served from the next bigger one. Existing arenas are
+   left as they are, new arenas of the class use the new count.
+*/
+int
+iobuf_pool_reconfigure (struct iobuf_pool *iobuf_pool, const char *page_counts,
+                        int numa)
+{
+        char     *dup_str = NULL;
+        char     *pair = NULL;
+        char     *saveptr = NULL;
+        char     *count_str = NULL;
+        uint64_t  page_size = 0;
+        int32_t   num_pages = 0;
+        int       config[GF_VARIABLE_IOBUF_COUNT];
+        int       default_ok = 0;
+        int       i = 0;
+        int       ret = -1;
+
+        GF_VALIDATE_OR_GOTO ("iobuf", iobuf_pool, out);
+
+        for (i = 0; i < IOBUF_ARENA_MAX_INDEX (iobuf_pool); i++)
+                config[i] = iobuf_pool->config[i].num_pages;
+
+        if (page_counts) {
+                dup_str = gf_strdup (page_counts);
+                if (!dup_str)
+                        goto out;
+
+                pair = strtok_r (dup_str, ",", &saveptr);
+                while (pair) {
+                        count_str = strchr (pair, ':');
+                        if (!count_str)
+                                goto invalid;
+                        *count_str++ = '\0';
+
+                        if (gf_string2bytesize (pair, &page_size) ||
+                            gf_string2int32 (count_str, &num_pages) ||
+                            num_pages < 0)
+                                goto invalid;
+
+                        for (i = 0; i < IOBUF_ARENA_MAX_INDEX (iobuf_pool);
+                             i++) {
+                                if (iobuf_pool->config[i].pagesize ==
+                                    page_size)
+                                        break;
+                        }
+                        if (i == IOBUF_ARENA_MAX_INDEX (iobuf_pool))
+                                goto invalid;
+
+                        config[i] = num_pages;
+
+                        pair = strtok_r (NULL, ",", &saveptr);
+                }
+        }
+
+        /* the default page size must stay servable from the pool */
+        for (i = 0; i < IOBUF_ARENA_MAX_INDEX (iobuf_pool); i++) {
+                if (config[i] &&
+                    iobuf_pool->config[i].pagesize >=
+                    iobuf_pool->default_page_size)
+                        default_ok = 1;
+        }
+        if (!default_ok) {
+                gf_log ("iobuf", GF_LOG_ERROR, "iobuf classes \"%s\" leave "
+                        "no class for the default page size %zu", page_counts,
+                        iobuf_pool->default_page_size);
+                goto out;
+        }
+
+        pthread_mutex_lock (&iobuf_pool->mutex);
+        {
+                for (i = 0; i < IOBUF_ARENA_MAX_INDEX (iobuf_pool); i++)
+                        iobuf_pool->config[i].num_pages = config[i];
+
+                iobuf_pool->numa = (numa && iobuf_pool->node_cnt > 1);
+        }
+        pthread_mutex_unlock (&iobuf_pool->mutex);
+
+        if (numa && iobuf_pool->node_cnt == 1)
+                gf_log ("iobuf", GF_LOG_INFO, "NUMA local iobuf arenas "
+                        "are not available on this system");
+
+        ret = 0;
+        goto out;
+
+invalid:
+        gf_log ("iobuf", GF_LOG_ERROR, "invalid iobuf page count \"%s\"",
+                page_counts);
+out:
+        if (dup_str)
+                GF_FREE (dup_str);
+
+        return ret;
 }
 
 
@@ -388,12 +569,14 @@ __iobuf_arena_prune (struct iobuf_pool *iobuf_pool,
          * (ie, at least few iobufs free in arena), that way, there won't
          * be spurious mmap/unmap of buffers
          */
-        if (list_empty (&iobuf_pool->arenas[index]))
+        if (list_empty (iobuf_pool_list (iobuf_pool, arenas,
+                                         iobuf_arena->node, index)))
                 goto out;
 
         /* All cases matched, destroy */
         list_del_init (&iobuf_arena->list);
         iobuf_pool->arena_cnt--;
+        iobuf_pool->stats[index].arena_prunes++;
 
         __iobuf_arena_destroy (iobuf_arena);
 
@@ -408,21 +591,28 @@ iobuf_pool_prune (struct iobuf_pool *iobuf_pool)
         struct iobuf_arena *iobuf_arena = NULL;
         struct iobuf_arena *tmp         = NULL;
         int                 i           = 0;
+        int                 node        = 0;
 
         GF_VALIDATE_OR_GOTO ("iobuf", iobuf_pool, out);
 
         pthread_mutex_lock (&iobuf_pool->mutex);
         {
-                for (i = 0; i < IOBUF_ARENA_MAX_INDEX; i++) {
-                        if (list_empty (&iobuf_pool->arenas[i])) {
+                for (node = 0; node < iobuf_pool->node_cnt; node++) {
+                for (i = 0; i < IOBUF_ARENA_MAX_INDEX (iobuf_pool); i++) {
+                        if (list_empty (iobuf_pool_list (iobuf_pool, arenas,
+                                                         node, i))) {
                                 continue;
                         }
 
                         list_for_each_entry_safe (iobuf_arena, tmp,
-                                                  &iobuf_pool->purge[i], list) {
+                                                  iobuf_pool_list (iobuf_pool,
+                                                                   purge, node,
+                                                                   i),
+                                                  list) {
                                 __iobuf_arena_prune (iobuf_pool, iobuf_arena, i);
                         }
                 }
+                }
         }
         pthread_mutex_unlock (&iobuf_pool->mutex);
 
@@ -432,24 +622,19 @@ out:
 
 
 struct iobuf_arena *
-__iobuf_select_arena (struct iobuf_pool *iobuf_pool, size_t page_size)
+__iobuf_select_arena (struct iobuf_pool *iobuf_pool, int index)
 {
         struct iobuf_arena *iobuf_arena  = NULL;
         struct iobuf_arena *trav         = NULL;
-        int                 index        = 0;
+        int                 node         = 0;
 
         GF_VALIDATE_OR_GOTO ("iobuf", iobuf_pool, out);
 
-        index = gf_iobuf_get_arena_index (page_size);
-        if (index == -1) {
-                gf_log ("iobuf", GF_LOG_ERROR, "page_size (%zu) of "
-                        "iobufs in arena being added is greater than max "
-                        "available", page_size);
-                return NULL;
-        }
+        node = iobuf_pool_current_node (iobuf_pool);
 
         /* look for unused iobuf from the head-most arena */
-        list_for_each_entry (trav, &iobuf_pool->arenas[index], list) {
+        list_for_each_entry (trav, iobuf_pool_list (iobuf_pool, arenas,
+                                                    node, index), list) {
                 if (trav->passive_cnt) {
                         iobuf_arena = trav;
                         break;
@@ -458,8 +643,7 @@ __iobuf_select_arena (struct iobuf_pool *iobuf_pool, size_t page_size)
 
         if (!iobuf_arena) {
                 /* all arenas were full, find the right count to add */
-                iobuf_arena = __iobuf_pool_add_arena (iobuf_pool, page_size,
-                                                      gf_iobuf_init_config[index].num_pages);
+                iobuf_arena = __iobuf_pool_add_arena (iobuf_pool, index, node);
         }
 
 out:
@@ -485,11 +669,10 @@ __iobuf_unref (struct iobuf *iobuf)
 }
 
 struct iobuf *
-__iobuf_get (struct iobuf_arena *iobuf_arena, size_t page_size)
+__iobuf_get (struct iobuf_arena *iobuf_arena)
 {
         struct iobuf      *iobuf        = NULL;
         struct iobuf_pool *iobuf_pool   = NULL;
-        int                index        = 0;
 
         GF_VALIDATE_OR_GOTO ("iobuf", iobuf_arena, out);
 
@@ -506,21 +689,17 @@ __iobuf_get (struct iobuf_arena *iobuf_arena, size_t page_size)
 
         /* no resetting requied for this element */
         iobuf_arena->alloc_cnt++;
+        iobuf_pool->stats[iobuf_arena->index].alloc_cnt++;
 
         if (iobuf_arena->max_active < iobuf_arena->active_cnt)
                 iobuf_arena->max_active = iobuf_arena->active_cnt;
 
         if (iobuf_arena->passive_cnt == 0) {
-                index = gf_iobuf_get_arena_index (page_size);
-                if (index == -1) {
-                        gf_log ("iobuf", GF_LOG_ERROR, "page_size (%zu) of "
-                                "iobufs in arena being added is greater "
-                                "than max available", page_size);
-                        goto out;
-                }
-
                 list_del (&iobuf_arena->list);
-                list_add (&iobuf_arena->list, &iobuf_pool->filled[index]);
+                list_add (&iobuf_arena->list,
+                          iobuf_pool_list (iobuf_pool, filled,
+                                           iobuf_arena->node,
+                                           iobuf_arena->index));
         }
 
 out:
@@ -536,7 +715,9 @@ iobuf_get_from_stdalloc (struct iobuf_pool *iobuf_pool, size_t page_size)
         int                 ret         = -1;
 
         /* The first arena in the 'MAX-INDEX' will always be used for misc */
-        list_for_each_entry (trav, &iobuf_pool->arenas[IOBUF_ARENA_MAX_INDEX],
+        list_for_each_entry (trav,
+                             iobuf_pool_list (iobuf_pool, arenas, 0,
+                                              IOBUF_ARENA_MAX_INDEX (iobuf_pool)),
                              list) {
                 iobuf_arena = trav;
                 break;
@@ -572,18 +753,51 @@ out:
 }
 
 
+static struct iobuf *
+__iobuf_get_class (struct iobuf_pool *iobuf_pool, size_t page_size)
+{
+        struct iobuf       *iobuf        = NULL;
+        struct iobuf_arena *iobuf_arena  = NULL;
+        int                 index        = 0;
+
+        index = gf_iobuf_get_arena_index (iobuf_pool, page_size);
+        if (index == -1)
+                goto out;
+
+        /* the natural class of the request is disabled */
+        if (index > 0 && page_size <= iobuf_pool->config[index - 1].pagesize)
+                iobuf_pool->stats[index].fallbacks++;
+
+        /* most eligible arena for picking an iobuf */
+        iobuf_arena = __iobuf_select_arena (iobuf_pool, index);
+        if (!iobuf_arena) {
+                gf_log (THIS->name, GF_LOG_WARNING, "arena not found");
+                goto out;
+        }
+
+        iobuf = __iobuf_get (iobuf_arena);
+        if (!iobuf) {
+                gf_log (THIS->name, GF_LOG_WARNING, "iobuf not found");
+                goto out;
+        }
+
+        __iobuf_ref (iobuf);
+out:
+        return iobuf;
+}
+
+
 struct iobuf *
 iobuf_get2 (struct iobuf_pool *iobuf_pool, size_t page_size)
 {
         struct iobuf       *iobuf        = NULL;
-        struct iobuf_arena *iobuf_arena  = NULL;
         size_t              rounded_size = 0;
 
         if (page_size == 0) {
                 page_size = iobuf_pool->default_page_size;
         }
 
-        rounded_size = gf_iobuf_get_pagesize (page_size);
+        rounded_size = gf_iobuf_get_pagesize (iobuf_pool, page_size);
         if (rounded_size == -1) {
                 /* make sure to provide the requested buffer with standard
                    memory allocations */
@@ -600,18 +814,8 @@ iobuf_get2 (struct iobuf_pool *iobuf_pool, size_t page_size)
 
         pthread_mutex_lock (&iobuf_pool->mutex);
         {
-                /* most eligible arena for picking an iobuf */
-                iobuf_arena = __iobuf_select_arena (iobuf_pool, rounded_size);
-                if (!iobuf_arena)
-                        goto unlock;
-
-                iobuf = __iobuf_get (iobuf_arena, rounded_size);
-                if (!iobuf)
-                        goto unlock;
-
-                __iobuf_ref (iobuf);
-         }
-unlock:
+                iobuf = __iobuf_get_class (iobuf_pool, page_size);
+        }
         pthread_mutex_unlock (&iobuf_pool->mutex);
 
         return iobuf;
@@ -621,30 +825,14 @@ struct iobuf *
 iobuf_get (struct iobuf_pool *iobuf_pool)
 {
         struct iobuf       *iobuf        = NULL;
-        struct iobuf_arena *iobuf_arena  = NULL;
 
         GF_VALIDATE_OR_GOTO ("iobuf", iobuf_pool, out);
 
         pthread_mutex_lock (&iobuf_pool->mutex);
         {
-                /* most eligible arena for picking an iobuf */
-                iobuf_arena = __iobuf_select_arena (iobuf_pool,
-                                                    iobuf_pool->default_page_size);
-                if (!iobuf_arena) {
-                        gf_log (THIS->name, GF_LOG_WARNING, "arena not found");
-                        goto unlock;
-                }
-
-                iobuf = __iobuf_get (iobuf_arena,
-                                     iobuf_pool->default_page_size);
-                if (!iobuf) {
-                        gf_log (THIS->name, GF_LOG_WARNING, "iobuf not found");
-                        goto unlock;
-                }
-
-                __iobuf_ref (iobuf);
+                iobuf = __iobuf_get_class (iobuf_pool,
+                                           iobuf_pool->default_page_size);
         }
-unlock:
         pthread_mutex_unlock (&iobuf_pool->mutex);
 
 out:
@@ -656,14 +844,16 @@ __iobuf_put (struct iobuf *iobuf, struct iobuf_arena *iobuf_arena)
 {
         struct iobuf_pool *iobuf_pool = NULL;
         int                index      = 0;
+        int                node       = 0;
 
         GF_VALIDATE_OR_GOTO ("iobuf", iobuf_arena, out);
         GF_VALIDATE_OR_GOTO ("iobuf", iobuf, out);
 
         iobuf_pool = iobuf_arena->iobuf_pool;
 
-        index = gf_iobuf_get_arena_index (iobuf_arena->page_size);
-        if (index == -1) {
+        index = iobuf_arena->index;
+        node  = iobuf_arena->node;
+        if (index == IOBUF_ARENA_MAX_INDEX (iobuf_pool)) {
                 gf_log ("iobuf", GF_LOG_DEBUG, "freeing the iobuf (%p) "
                         "allocated with standard calloc()", iobuf);
 
@@ -676,7 +866,9 @@ __iobuf_put (struct iobuf *iobuf, struct iobuf_arena *iobuf_arena)
 
         if (iobuf_arena->passive_cnt == 0) {
                 list_del (&iobuf_arena->list);
-                list_add_tail (&iobuf_arena->list, &iobuf_pool->arenas[index]);
+                list_add_tail (&iobuf_arena->list,
+                               iobuf_pool_list (iobuf_pool, arenas,
+                                                node, index));
         }
 
         list_del_init (&iobuf->list);
@@ -687,7 +879,9 @@ __iobuf_put (struct iobuf *iobuf, struct iobuf_arena *iobuf_arena)
 
         if (iobuf_arena->active_cnt == 0) {
                 list_del (&iobuf_arena->list);
-                list_add_tail (&iobuf_arena->list, &iobuf_pool->purge[index]);
+                list_add_tail (&iobuf_arena->list,
+                               iobuf_pool_list (iobuf_pool, purge,
+                                                node, index));
                 __iobuf_arena_prune (iobuf_pool, iobuf_arena, index);
         }
 out:
@@ -1006,6 +1200,8 @@ iobuf_arena_info_dump (struct iobuf_arena *iobuf_arena, const char *key_prefix)
         gf_proc_dump_write(key, "%"PRIu64, iobuf_arena->max_active);
         gf_proc_dump_build_key(key, key_prefix, "page_size");
         gf_proc_dump_write(key, "%"PRIu64, iobuf_arena->page_size);
+        gf_proc_dump_build_key(key, key_prefix, "node");
+        gf_proc_dump_write(key, "%d", iobuf_arena->node);
         list_for_each_entry (trav, &iobuf_arena->active.list, list) {
                 gf_proc_dump_build_key(key, key_prefix,"active_iobuf.%d", i++);
                 gf_proc_dump_add_section(key);
@@ -1023,6 +1219,7 @@ iobuf_stats_dump (struct iobuf_pool *iobuf_pool)
         struct iobuf_arena *trav = NULL;
         int                i = 1;
         int                j = 0;
+        int                node = 0;
         int                ret = -1;
 
         GF_VALIDATE_OR_GOTO ("iobuf", iobuf_pool, out);
@@ -1045,29 +1242,54 @@ iobuf_stats_dump (struct iobuf_pool *iobuf_pool)
         gf_proc_dump_write("iobuf_pool.request_misses", "%"PRId64,
                            iobuf_pool->request_misses);
 
-        for (j = 0; j < IOBUF_ARENA_MAX_INDEX; j++) {
-                list_for_each_entry (trav, &iobuf_pool->arenas[j], list) {
+        gf_proc_dump_write("iobuf_pool.numa", "%d", iobuf_pool->numa);
+        gf_proc_dump_write("iobuf_pool.node_cnt", "%d",
+                           iobuf_pool->node_cnt);
+
+        for (j = 0; j < IOBUF_ARENA_MAX_INDEX (iobuf_pool); j++) {
+                snprintf(msg, sizeof(msg), "iobuf.class.%d", j);
+                gf_proc_dump_add_section(msg);
+                gf_proc_dump_write("page_size", "%zu",
+                                   iobuf_pool->config[j].pagesize);
+                gf_proc_dump_write("num_pages", "%d",
+                                   iobuf_pool->config[j].num_pages);
+                gf_proc_dump_write("alloc_cnt", "%"PRIu64,
+                                   iobuf_pool->stats[j].alloc_cnt);
+                gf_proc_dump_write("arena_adds", "%"PRIu64,
+                                   iobuf_pool->stats[j].arena_adds);
+                gf_proc_dump_write("arena_prunes", "%"PRIu64,
+                                   iobuf_pool->stats[j].arena_prunes);
+                gf_proc_dump_write("fallbacks", "%"PRIu64,
+                                   iobuf_pool->stats[j].fallbacks);
+        }
+
+        for (node = 0; node < iobuf_pool->node_cnt; node++) {
+        for (j = 0; j < IOBUF_ARENA_MAX_INDEX (iobuf_pool); j++) {
+                list_for_each_entry (trav, iobuf_pool_list (iobuf_pool, arenas,
+                                                            node, j), list) {
                         snprintf(msg, sizeof(msg),
                                  "arena.%d", i);
                         gf_proc_dump_add_section(msg);
                         iobuf_arena_info_dump(trav,msg);
                         i++;
                 }
-                list_for_each_entry (trav, &iobuf_pool->purge[j], list) {
+                list_for_each_entry (trav, iobuf_pool_list (iobuf_pool, purge,
+                                                            node, j), list) {
                         snprintf(msg, sizeof(msg),
                                  "purge.%d", i);
                         gf_proc_dump_add_section(msg);
                         iobuf_arena_info_dump(trav,msg);
                         i++;
                 }
-                list_for_each_entry (trav, &iobuf_pool->filled[j], list) {
+                list_for_each_entry (trav, iobuf_pool_list (iobuf_pool, filled,
+                                                            node, j), list) {
                         snprintf(msg, sizeof(msg),
                                  "filled.%d", i);
                         gf_proc_dump_add_section(msg);
                         iobuf_arena_info_dump(trav,msg);
                         i++;
                 }
-
+        }
         }
 
         pthread_mutex_unlock(&iobuf_pool->mutex);
@@ -101,6 +101,19 @@ struct iobuf_arena {
                                            (unused by itself) */
         uint64_t            alloc_cnt;  /* total allocs in this pool */
         int                 max_active; /* max active buffers at a given time */
+
+        int                 index;      /* size class of this arena */
+        int                 node;       /* NUMA node the memory is bound to */
+};
+
+
+/* per size class counters, reported in statedump */
+struct iobuf_class_stats {
+        uint64_t            alloc_cnt;  /* iobufs handed out */
+        uint64_t            arena_adds; /* arenas mmaped (lazy growth) */
+        uint64_t            arena_prunes; /* idle arenas unmapped */
+        uint64_t            fallbacks;  /* requests served by a bigger class
+                                           because this one is disabled */
 };
 
 
@@ -111,22 +124,43 @@ struct iobuf_pool {
         size_t              default_page_size; /* default size of iobuf */
 
         int                 arena_cnt;
-        struct list_head    arenas[GF_VARIABLE_IOBUF_COUNT];
-        /* array of arenas. Each element of the array is a list of arenas
-           holding iobufs of particular page_size */
 
-        struct list_head    filled[GF_VARIABLE_IOBUF_COUNT];
+        /* size classes of this pool, sorted on pagesize. num_pages is the
+           number of iobufs in each arena of the class, 0 disables it */
+        int                 class_cnt;
+        struct iobuf_init_config config[GF_VARIABLE_IOBUF_COUNT];
+        struct iobuf_class_stats stats[GF_VARIABLE_IOBUF_COUNT];
+
+        /* each NUMA node has its own set of arena lists, only node 0 is
+           used unless numa is set */
+        int                 node_cnt;
+        int                 numa;
+        int                 cpu_cnt;
+        int                *cpu_to_node;
+
+        struct list_head   *arenas;
+        /* array of arenas, [node_cnt][class_cnt + 1]. Each element of the
+           array is a list of arenas holding iobufs of particular
+           page_size. The last class of node 0 holds the stdalloc arena */
+
+        struct list_head   *filled;
         /* array of arenas without free iobufs */
 
-        struct list_head    purge[GF_VARIABLE_IOBUF_COUNT];
+        struct list_head   *purge;
         /* array of of arenas which can be purged */
 
         uint64_t            request_misses; /* mostly the requests for higher
                                                value of iobufs */
 };
 
+#define iobuf_pool_list(iobuf_pool, head, node, index)                   \
+        (&(iobuf_pool)->head[((node) * ((iobuf_pool)->class_cnt + 1)) +  \
+                             (index)])
+
 
 struct iobuf_pool *iobuf_pool_new (void);
+int iobuf_pool_reconfigure (struct iobuf_pool *iobuf_pool,
+                            const char *page_counts, int numa);
 void iobuf_pool_destroy (struct iobuf_pool *iobuf_pool);
 struct iobuf *iobuf_get (struct iobuf_pool *iobuf_pool);
 void iobuf_unref (struct iobuf *iobuf);
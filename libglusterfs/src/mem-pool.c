@@ -309,6 +309,114 @@ free:
 
 
 
+/* Per-thread caches: every thread using mem-pools grabs one of
+ * GF_MEM_POOL_MAX_THREADS slots on its first mem_get/mem_put. The slot is
+ * released when the thread exits, and the next thread which grabs it
+ * inherits the chunks cached in it.
+ */
+static pthread_key_t   mem_pool_thread_key;
+static pthread_once_t  mem_pool_thread_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t mem_pool_thread_lock = PTHREAD_MUTEX_INITIALIZER;
+static char            mem_pool_thread_slots[GF_MEM_POOL_MAX_THREADS];
+
+/* stored in the key of threads which found no free slot */
+#define GF_MEM_POOL_NO_SLOT  (GF_MEM_POOL_MAX_THREADS + 1)
+
+
+static void
+mem_pool_thread_release (void *val)
+{
+        long idx = (long) val - 1;
+
+        if (idx < 0 || idx >= GF_MEM_POOL_MAX_THREADS)
+                return;
+
+        pthread_mutex_lock (&mem_pool_thread_lock);
+        {
+                mem_pool_thread_slots[idx] = 0;
+        }
+        pthread_mutex_unlock (&mem_pool_thread_lock);
+}
+
+
+static void
+mem_pool_thread_key_init (void)
+{
+        if (pthread_key_create (&mem_pool_thread_key,
+                                mem_pool_thread_release) != 0)
+                gf_log ("mem-pool", GF_LOG_WARNING,
+                        "per-thread mem-pool caches disabled");
+}
+
+
+static int
+mem_pool_thread_index (void)
+{
+        long  idx = -1;
+        long  i = 0;
+        void *val = NULL;
+
+        pthread_once (&mem_pool_thread_once, mem_pool_thread_key_init);
+
+        val = pthread_getspecific (mem_pool_thread_key);
+        if (val) {
+                idx = (long) val - 1;
+                goto out;
+        }
+
+        pthread_mutex_lock (&mem_pool_thread_lock);
+        {
+                for (i = 0; i < GF_MEM_POOL_MAX_THREADS; i++) {
+                        if (!mem_pool_thread_slots[i]) {
+                                mem_pool_thread_slots[i] = 1;
+                                idx = i;
+                                break;
+                        }
+                }
+        }
+        pthread_mutex_unlock (&mem_pool_thread_lock);
+
+        if (idx == -1)
+                idx = GF_MEM_POOL_NO_SLOT - 1;
+
+        pthread_setspecific (mem_pool_thread_key, (void *) (idx + 1));
+out:
+        if (idx >= GF_MEM_POOL_MAX_THREADS)
+                idx = -1;
+
+        return idx;
+}
+
+
+static struct mem_pool_cache *
+mem_pool_cache_get (struct mem_pool *mem_pool)
+{
+        struct mem_pool_cache *cache = NULL;
+        int                    idx = -1;
+
+        if (!mem_pool->cache_max)
+                goto out;
+
+        idx = mem_pool_thread_index ();
+        if (idx == -1)
+                goto out;
+
+        cache = mem_pool->caches[idx];
+        if (cache)
+                goto out;
+
+        /* only the owner of the slot ever allocates it */
+        cache = CALLOC (1, sizeof (*cache));
+        if (!cache)
+                goto out;
+
+        INIT_LIST_HEAD (&cache->list);
+        mem_pool->caches[idx] = cache;
+out:
+        return cache;
+}
+
+
 struct mem_pool *
 mem_pool_new_fn (unsigned long sizeof_type,
                  unsigned long count, char *name)
@@ -348,6 +456,12 @@ mem_pool_new_fn (unsigned long sizeof_type,
         mem_pool->cold_count = count;
         mem_pool->real_sizeof_type = sizeof_type;
 
+        /* keep the chunks parked in per-thread caches a small share of the
+           pool, small pools are served from the shared list only */
+        mem_pool->cache_max = min (GF_MEM_POOL_CACHE_MAX, count / 8);
+        if (mem_pool->cache_max < 4)
+                mem_pool->cache_max = 0;
+
         pool = GF_CALLOC (count, padded_sizeof_type, gf_common_mt_long);
         if (!pool) {
                 GF_FREE (mem_pool->name);
@@ -393,22 +507,69 @@ mem_get0 (struct mem_pool *mem_pool)
         return ptr;
 }
 
+static void *
+mem_pool_chunk_prepare (struct mem_pool *mem_pool, void *ptr)
+{
+        int              *in_use = NULL;
+        struct mem_pool **pool_ptr = NULL;
+
+        in_use = (ptr + GF_MEM_POOL_LIST_BOUNDARY + GF_MEM_POOL_PTR);
+        *in_use = 1;
+
+        pool_ptr = mem_pool_from_ptr (ptr);
+        *pool_ptr = (struct mem_pool *)mem_pool;
+
+        return mem_pool_chunkhead2ptr (ptr);
+}
+
+
 void *
 mem_get (struct mem_pool *mem_pool)
 {
-        struct list_head *list = NULL;
-        void             *ptr = NULL;
-        int             *in_use = NULL;
-        struct mem_pool **pool_ptr = NULL;
+        struct list_head      *list = NULL;
+        void                  *ptr = NULL;
+        struct mem_pool      **pool_ptr = NULL;
+        struct mem_pool_cache *cache = NULL;
+        int                    batch = 0;
 
         if (!mem_pool) {
                 gf_log_callingfn ("mem-pool", GF_LOG_ERROR, "invalid argument");
                 return NULL;
         }
 
+        cache = mem_pool_cache_get (mem_pool);
+        if (cache && cache->count) {
+                /* fast path, no locking */
+                cache->hits++;
+                goto from_cache;
+        }
+
         LOCK (&mem_pool->lock);
         {
                 mem_pool->alloc_count++;
+                if (cache && mem_pool->cold_count) {
+                        cache->misses++;
+
+                        /* refill the thread cache with a batch of chunks
+                           under one lock acquisition */
+                        batch = min (mem_pool->cold_count,
+                                     mem_pool->cache_max / 2);
+                        while (batch--) {
+                                list = mem_pool->list.next;
+                                list_move (list, &cache->list);
+                                cache->count++;
+
+                                mem_pool->hot_count++;
+                                mem_pool->cold_count--;
+                        }
+
+                        if (mem_pool->max_alloc < mem_pool->hot_count)
+                                mem_pool->max_alloc = mem_pool->hot_count;
+
+                        UNLOCK (&mem_pool->lock);
+                        goto from_cache;
+                }
+
                 if (mem_pool->cold_count) {
                         list = mem_pool->list.next;
                         list_del (list);
@@ -419,12 +580,9 @@ mem_get (struct mem_pool *mem_pool)
                         if (mem_pool->max_alloc < mem_pool->hot_count)
                                 mem_pool->max_alloc = mem_pool->hot_count;
 
-                        ptr = list;
-                        in_use = (ptr + GF_MEM_POOL_LIST_BOUNDARY +
-                                  GF_MEM_POOL_PTR);
-                        *in_use = 1;
-
-                        goto fwd_addr_out;
+                        ptr = mem_pool_chunk_prepare (mem_pool, list);
+                        UNLOCK (&mem_pool->lock);
+                        goto out;
                 }
 
                 /* This is a problem area. If we've run out of
@@ -451,22 +609,38 @@ mem_get (struct mem_pool *mem_pool)
                 mem_pool->curr_stdalloc++;
                 if (mem_pool->max_stdalloc < mem_pool->curr_stdalloc)
                         mem_pool->max_stdalloc = mem_pool->curr_stdalloc;
-                ptr = GF_CALLOC (1, mem_pool->padded_sizeof_type,
-                                 gf_common_mt_mem_pool);
-                gf_log_callingfn ("mem-pool", GF_LOG_DEBUG, "Mem pool is full. "
-                                  "Callocing mem");
-
-                /* Memory coming from the heap need not be transformed from a
-                 * chunkhead to a usable pointer since it is not coming from
-                 * the pool.
-                 */
         }
-fwd_addr_out:
+        UNLOCK (&mem_pool->lock);
+
+        ptr = GF_CALLOC (1, mem_pool->padded_sizeof_type,
+                         gf_common_mt_mem_pool);
+        gf_log_callingfn ("mem-pool", GF_LOG_DEBUG, "Mem pool is full. "
+                          "Callocing mem");
+        if (!ptr) {
+                LOCK (&mem_pool->lock);
+                {
+                        mem_pool->curr_stdalloc--;
+                }
+                UNLOCK (&mem_pool->lock);
+                goto out;
+        }
+
+        /* Memory coming from the heap need not be transformed from a
+         * chunkhead to a usable pointer since it is not coming from
+         * the pool.
+         */
         pool_ptr = mem_pool_from_ptr (ptr);
         *pool_ptr = (struct mem_pool *)mem_pool;
         ptr = mem_pool_chunkhead2ptr (ptr);
-        UNLOCK (&mem_pool->lock);
+        goto out;
+
+from_cache:
+        list = cache->list.next;
+        list_del (list);
+        cache->count--;
 
+        ptr = mem_pool_chunk_prepare (mem_pool, list);
+out:
         return ptr;
 }
 
@@ -490,14 +664,39 @@ __is_member (struct mem_pool *pool, void *ptr)
 }
 
 
+static void
+mem_pool_cache_flush (struct mem_pool *pool, struct mem_pool_cache *cache,
+                      int count)
+{
+        struct list_head *list = NULL;
+
+        LOCK (&pool->lock);
+        {
+                while (count-- && cache->count) {
+                        list = cache->list.prev;
+                        list_move (list, &pool->list);
+                        cache->count--;
+
+                        pool->hot_count--;
+                        pool->cold_count++;
+                }
+        }
+        UNLOCK (&pool->lock);
+
+        cache->flushes++;
+}
+
+
 void
 mem_put (void *ptr)
 {
-        struct list_head *list = NULL;
-        int    *in_use = NULL;
-        void   *head = NULL;
-        struct mem_pool **tmp = NULL;
-        struct mem_pool *pool = NULL;
+        struct list_head      *list = NULL;
+        int                   *in_use = NULL;
+        void                  *head = NULL;
+        struct mem_pool      **tmp = NULL;
+        struct mem_pool       *pool = NULL;
+        struct mem_pool_cache *cache = NULL;
+        int                    member = 0;
 
         if (!ptr) {
                 gf_log_callingfn ("mem-pool", GF_LOG_ERROR, "invalid argument");
@@ -518,10 +717,37 @@ mem_put (void *ptr)
                                   "mem-pool ptr is NULL");
                 return;
         }
+
+        /* __is_member() only looks at the (immutable) slab boundaries */
+        member = __is_member (pool, ptr);
+        if (member == 1)
+                cache = mem_pool_cache_get (pool);
+
+        if (cache) {
+                in_use = (head + GF_MEM_POOL_LIST_BOUNDARY +
+                          GF_MEM_POOL_PTR);
+                if (!is_mem_chunk_in_use(in_use)) {
+                        gf_log_callingfn ("mem-pool", GF_LOG_CRITICAL,
+                                          "mem_put called on freed ptr %p of mem "
+                                          "pool %p", ptr, pool);
+                        return;
+                }
+                *in_use = 0;
+
+                list_add (list, &cache->list);
+                cache->count++;
+
+                /* hand the least recently freed half back in one go */
+                if (cache->count > pool->cache_max)
+                        mem_pool_cache_flush (pool, cache,
+                                              pool->cache_max / 2);
+                return;
+        }
+
         LOCK (&pool->lock);
         {
 
-                switch (__is_member (pool, ptr))
+                switch (member)
                 {
                 case 1:
                         in_use = (head + GF_MEM_POOL_LIST_BOUNDARY +
@@ -566,9 +792,40 @@ mem_put (void *ptr)
         UNLOCK (&pool->lock);
 }
 
+
+/* chunks parked in thread caches are counted as cold, and cache hits
+ * are counted as allocations */
+void
+mem_pool_stats_get (struct mem_pool *pool, int *hot_count, int *cold_count,
+                    uint64_t *alloc_count)
+{
+        struct mem_pool_cache *cache = NULL;
+        int                    cached = 0;
+        uint64_t               hits = 0;
+        int                    i = 0;
+
+        for (i = 0; i < GF_MEM_POOL_MAX_THREADS; i++) {
+                cache = pool->caches[i];
+                if (!cache)
+                        continue;
+
+                cached += cache->count;
+                hits += cache->hits;
+        }
+
+        if (hot_count)
+                *hot_count = pool->hot_count - cached;
+        if (cold_count)
+                *cold_count = pool->cold_count + cached;
+        if (alloc_count)
+                *alloc_count = pool->alloc_count + hits;
+}
+
 void
 mem_pool_destroy (struct mem_pool *pool)
 {
+        int i = 0;
+
         if (!pool)
                 return;
 
@@ -577,6 +834,12 @@ mem_pool_destroy (struct mem_pool *pool)
 
         list_del (&pool->global_list);
 
+        /* cached chunks live in the slab, only the caches are freed */
+        for (i = 0; i < GF_MEM_POOL_MAX_THREADS; i++) {
+                if (pool->caches[i])
+                        FREE (pool->caches[i]);
+        }
+
         LOCK_DESTROY (&pool->lock);
         GF_FREE (pool->name);
         GF_FREE (pool->pool);
@@ -128,6 +128,20 @@ char * gf_strdup (const char *src)
         return dup_str;
 }
 
+/* Threads which get a slot below get a private cache of cold chunks in
+ * front of every mem_pool, any other thread uses the shared list only.
+ */
+#define GF_MEM_POOL_MAX_THREADS  64
+#define GF_MEM_POOL_CACHE_MAX    64
+
+struct mem_pool_cache {
+        struct list_head  list;    /* cold chunks owned by one thread */
+        int               count;
+        uint64_t          hits;    /* mem_get served without pool->lock */
+        uint64_t          misses;  /* mem_get which had to refill */
+        uint64_t          flushes; /* batches handed back to the pool */
+};
+
 struct mem_pool {
         struct list_head  list;
         int               hot_count;
@@ -144,6 +158,8 @@ struct mem_pool {
         int               max_stdalloc;
         char             *name;
         struct list_head  global_list;
+        int               cache_max;  /* 0 disables the per-thread caches */
+        struct mem_pool_cache *caches[GF_MEM_POOL_MAX_THREADS];
 };
 
 struct mem_pool *
@@ -157,6 +173,9 @@ void *mem_get0 (struct mem_pool *pool);
 
 void mem_pool_destroy (struct mem_pool *pool);
 
+void mem_pool_stats_get (struct mem_pool *pool, int *hot_count,
+                         int *cold_count, uint64_t *alloc_count);
+
 int gf_mem_acct_is_enabled ();
 void gf_mem_acct_enable_set ();
 
@@ -102,6 +102,13 @@ enum gf_common_mem_types_ {
         gf_common_mt_buffer_t             = 86,
         gf_common_mt_circular_buffer_t    = 87,
         gf_common_mt_eh_t                 = 88,
-        gf_common_mt_end                  = 89
+        gf_common_mt_event_thread_data    = 89,
+        gf_common_mt_iobuf_node_map       = 90,
+        gf_common_mt_rpcclnt_frame_hash   = 91,
+        gf_common_mt_dict_table           = 92,
+        gf_common_mt_dict_arena           = 93,
+        gf_common_mt_data_buf             = 94,
+        gf_common_mt_compound_t           = 95,
+        gf_common_mt_end                  = 96
 };
 #endif
@@ -1071,3 +1071,30 @@ DEFINE_RECONF_OPT(uint64_t, percent_or_size, pc_or_size);
 DEFINE_RECONF_OPT(gf_boolean_t, bool, gf_string2boolean);
 DEFINE_RECONF_OPT(xlator_t *, xlator, xl_by_name);
 DEFINE_RECONF_OPT(char *, path, pass);
+
+
+void
+xlator_option_apply_event_threads (xlator_t *this, dict_t *options)
+{
+        int32_t event_threads = 0;
+
+        if (dict_get_int32 (options, "event-threads", &event_threads) == 0)
+                event_reconfigure_threads (this->ctx->event_pool,
+                                           event_threads);
+}
+
+
+void
+xlator_option_apply_iobuf (xlator_t *this, dict_t *options)
+{
+        char *page_count = NULL;
+
+        if (dict_get_str (options, "iobuf-page-count", &page_count))
+                page_count = NULL;
+        if (!page_count && !dict_get (options, "iobuf-numa"))
+                return;
+
+        iobuf_pool_reconfigure (this->ctx->iobuf_pool, page_count,
+                                dict_get_str_boolean (options, "iobuf-numa",
+                                                      0));
+}
@@ -251,4 +251,37 @@ xlator_option_reconf_##type (xlator_t *this, dict_t *options, char *key, \
         } while (0)
 
 
+/* Process wide settings which protocol/client and protocol/server both
+   take as options of their own; the volume_options entry and the code
+   applying it are kept here so the two stay alike. */
+#define GF_OPTION_EVENT_THREADS(process)                                \
+        { .key   = {"event-threads"},                                   \
+          .type  = GF_OPTION_TYPE_INT,                                  \
+          .min   = 1,                                                   \
+          .max   = EVENT_MAX_THREADS,                                   \
+          .description = "Number of threads dispatching network events " \
+                         "of the " process " process in parallel"       \
+        }
+
+#define GF_OPTION_IOBUF                                                 \
+        { .key   = {"iobuf-page-count"},                                \
+          .type  = GF_OPTION_TYPE_STR,                                  \
+          .description = "Comma separated list of <page-size>:<count> "  \
+                         "pairs, setting the number of iobufs in each "  \
+                         "arena of a size class (4KB..1MB). A count of " \
+                         "0 disables the class"                          \
+        },                                                              \
+        { .key   = {"iobuf-numa"},                                      \
+          .type  = GF_OPTION_TYPE_BOOL,                                 \
+          .default_value = "off",                                       \
+          .description = "Allocate iobuf arenas on the NUMA node of the " \
+                         "requesting thread"                            \
+        }
+
+void
+xlator_option_apply_event_threads (xlator_t *this, dict_t *options);
+
+void
+xlator_option_apply_iobuf (xlator_t *this, dict_t *options);
+
 #endif /* !_OPTIONS_H */
@@ -93,6 +93,7 @@ struct _call_stack_t {
         call_pool_t                  *pool;
         gf_lock_t                     stack_lock;
         void                         *trans;
+        const char                   *client_id; /* lives as long as trans */
         uint64_t                      unique;
         void                         *state;  /* pointer to request state */
         uid_t                         uid;
@@ -15,6 +15,7 @@
 #include "statedump.h"
 #include "stack.h"
 #include "common-utils.h"
+#include "timer.h"
 
 #ifdef HAVE_MALLOC_H
 #include <malloc.h>
@@ -284,37 +285,69 @@ gf_proc_dump_mem_info_to_dict (dict_t *dict)
 void
 gf_proc_dump_mempool_info (glusterfs_ctx_t *ctx)
 {
-        struct mem_pool *pool = NULL;
+        struct mem_pool       *pool = NULL;
+        struct mem_pool_cache *cache = NULL;
+        int                    hot_count = 0;
+        int                    cold_count = 0;
+        uint64_t               alloc_count = 0;
+        char                   key[GF_DUMP_MAX_BUF_LEN];
+        int                    i = 0;
 
         gf_proc_dump_add_section ("mempool");
 
         list_for_each_entry (pool, &ctx->mempool_list, global_list) {
+                mem_pool_stats_get (pool, &hot_count, &cold_count,
+                                    &alloc_count);
+
                 gf_proc_dump_write ("-----", "-----");
                 gf_proc_dump_write ("pool-name", "%s", pool->name);
-                gf_proc_dump_write ("hot-count", "%d", pool->hot_count);
-                gf_proc_dump_write ("cold-count", "%d", pool->cold_count);
+                gf_proc_dump_write ("hot-count", "%d", hot_count);
+                gf_proc_dump_write ("cold-count", "%d", cold_count);
                 gf_proc_dump_write ("padded_sizeof", "%lu",
                                     pool->padded_sizeof_type);
-                gf_proc_dump_write ("alloc-count", "%"PRIu64, pool->alloc_count);
+                gf_proc_dump_write ("alloc-count", "%"PRIu64, alloc_count);
                 gf_proc_dump_write ("max-alloc", "%d", pool->max_alloc);
 
                 gf_proc_dump_write ("pool-misses", "%"PRIu64, pool->pool_misses);
                 gf_proc_dump_write ("max-stdalloc", "%d", pool->max_stdalloc);
+                gf_proc_dump_write ("cache-size", "%d", pool->cache_max);
+
+                for (i = 0; i < GF_MEM_POOL_MAX_THREADS; i++) {
+                        cache = pool->caches[i];
+                        if (!cache)
+                                continue;
+
+                        snprintf (key, sizeof (key), "thread%d", i);
+                        gf_proc_dump_write (key, "cached=%d, hits=%"PRIu64
+                                            ", misses=%"PRIu64", flushes=%"
+                                            PRIu64, cache->count, cache->hits,
+                                            cache->misses, cache->flushes);
+                }
         }
 }
 
 void
 gf_proc_dump_mempool_info_to_dict (glusterfs_ctx_t *ctx, dict_t *dict)
 {
-        struct mem_pool *pool = NULL;
-        char            key[GF_DUMP_MAX_BUF_LEN] = {0,};
-        int             count = 0;
-        int             ret = -1;
+        struct mem_pool       *pool = NULL;
+        struct mem_pool_cache *cache = NULL;
+        char                   key[GF_DUMP_MAX_BUF_LEN] = {0,};
+        int                    count = 0;
+        int                    hot_count = 0;
+        int                    cold_count = 0;
+        uint64_t               alloc_count = 0;
+        uint64_t               hits = 0;
+        uint64_t               misses = 0;
+        int                    i = 0;
+        int                    ret = -1;
 
         if (!ctx || !dict)
                 return;
 
         list_for_each_entry (pool, &ctx->mempool_list, global_list) {
+                mem_pool_stats_get (pool, &hot_count, &cold_count,
+                                    &alloc_count);
+
                 memset (key, 0, sizeof (key));
                 snprintf (key, sizeof (key), "pool%d.name", count);
                 ret = dict_set_str (dict, key, pool->name);
@@ -323,13 +356,13 @@ gf_proc_dump_mempool_info_to_dict (glusterfs_ctx_t *ctx, dict_t *dict)
 
                 memset (key, 0, sizeof (key));
                 snprintf (key, sizeof (key), "pool%d.hotcount", count);
-                ret = dict_set_int32 (dict, key, pool->hot_count);
+                ret = dict_set_int32 (dict, key, hot_count);
                 if (ret)
                         return;
 
                 memset (key, 0, sizeof (key));
                 snprintf (key, sizeof (key), "pool%d.coldcount", count);
-                ret = dict_set_int32 (dict, key, pool->cold_count);
+                ret = dict_set_int32 (dict, key, cold_count);
                 if (ret)
                         return;
 
@@ -341,7 +374,7 @@ gf_proc_dump_mempool_info_to_dict (glusterfs_ctx_t *ctx, dict_t *dict)
 
                 memset (key, 0, sizeof (key));
                 snprintf (key, sizeof (key), "pool%d.alloccount", count);
-                ret = dict_set_uint64 (dict, key, pool->alloc_count);
+                ret = dict_set_uint64 (dict, key, alloc_count);
                 if (ret)
                         return;
 
@@ -360,6 +393,43 @@ gf_proc_dump_mempool_info_to_dict (glusterfs_ctx_t *ctx, dict_t *dict)
                 memset (key, 0, sizeof (key));
                 snprintf (key, sizeof (key), "pool%d.pool-misses", count);
                 ret = dict_set_uint64 (dict, key, pool->pool_misses);
+                if (ret)
+                        return;
+
+                /* per-thread cache counters, to help sizing the pools */
+                hits = misses = 0;
+                for (i = 0; i < GF_MEM_POOL_MAX_THREADS; i++) {
+                        cache = pool->caches[i];
+                        if (!cache)
+                                continue;
+
+                        memset (key, 0, sizeof (key));
+                        snprintf (key, sizeof (key),
+                                  "pool%d.thread%d.cache-hits", count, i);
+                        ret = dict_set_uint64 (dict, key, cache->hits);
+                        if (ret)
+                                return;
+
+                        memset (key, 0, sizeof (key));
+                        snprintf (key, sizeof (key),
+                                  "pool%d.thread%d.cache-misses", count, i);
+                        ret = dict_set_uint64 (dict, key, cache->misses);
+                        if (ret)
+                                return;
+
+                        hits += cache->hits;
+                        misses += cache->misses;
+                }
+
+                memset (key, 0, sizeof (key));
+                snprintf (key, sizeof (key), "pool%d.cache-hits", count);
+                ret = dict_set_uint64 (dict, key, hits);
+                if (ret)
+                        return;
+
+                memset (key, 0, sizeof (key));
+                snprintf (key, sizeof (key), "pool%d.cache-misses", count);
+                ret = dict_set_uint64 (dict, key, misses);
                 if (ret)
                         return;
                 count++;
@@ -652,6 +722,8 @@ gf_proc_dump_info (int signum)
         if (GF_PROC_DUMP_IS_OPTION_ENABLED (callpool))
                 gf_proc_dump_pending_frames (ctx->pool);
 
+        gf_timer_dump (ctx);
+
         if (ctx->master) {
                 gf_proc_dump_add_section ("fuse");
                 gf_proc_dump_xlator_info (ctx->master);
@@ -1193,6 +1193,40 @@ syncop_truncate (xlator_t *subvol, loc_t *loc, off_t offset)
         return args.op_ret;
 }
 
+int
+syncop_seek_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                 int op_ret, int op_errno, off_t offset, dict_t *xdata)
+{
+        struct syncargs *args = NULL;
+
+        args = cookie;
+
+        args->op_ret   = op_ret;
+        args->op_errno = op_errno;
+        if (op_ret == 0)
+                args->offset = offset;
+
+        __wake (args);
+
+        return 0;
+}
+
+int
+syncop_seek (xlator_t *subvol, fd_t *fd, off_t offset, gf_seek_what_t what,
+             off_t *off)
+{
+        struct syncargs args = {0, };
+
+        SYNCOP (subvol, (&args), syncop_seek_cbk, subvol->fops->seek,
+                fd, offset, what, NULL);
+
+        if (args.op_ret == 0 && off)
+                *off = args.offset;
+
+        errno = args.op_errno;
+        return args.op_ret;
+}
+
 int
 syncop_fsync_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
                   int32_t op_ret, int32_t op_errno,
@@ -109,6 +109,7 @@ struct syncargs {
         uuid_t              uuid;
         char               *errstr;
         dict_t             *dict;
+        off_t               offset;
 
         /* do not touch */
         struct synctask    *task;
@@ -191,6 +192,9 @@ int syncop_readv (xlator_t *subvol, fd_t *fd, size_t size, off_t off,
 int syncop_ftruncate (xlator_t *subvol, fd_t *fd, off_t offset);
 int syncop_truncate (xlator_t *subvol, loc_t *loc, off_t offset);
 
+int syncop_seek (xlator_t *subvol, fd_t *fd, off_t offset,
+                 gf_seek_what_t what, off_t *off);
+
 int syncop_unlink (xlator_t *subvol, loc_t *loc);
 
 int syncop_fsync (xlator_t *subvol, fd_t *fd);
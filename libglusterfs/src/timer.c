@@ -17,8 +17,181 @@
 #include "logging.h"
 #include "common-utils.h"
 #include "globals.h"
+#include "statedump.h"
+#include <time.h>
+
+#if defined(HAVE_CLOCK_GETTIME) && defined(HAVE_PTHREAD_CONDATTR_SETCLOCK) \
+        && defined(CLOCK_MONOTONIC)
+#define GF_TIMER_MONOTONIC 1
+#endif
+
+/* span, in ticks, covered by the wheels up to and including @level */
+#define GF_TIMER_SPAN(level) \
+        (1ULL << (GF_TIMER_ROOT_BITS + (level) * GF_TIMER_LEVEL_BITS))
+
+#define GF_TIMER_INDEX(tick, level)                                     \
+        (((tick) >> (GF_TIMER_ROOT_BITS + ((level) - 1) * GF_TIMER_LEVEL_BITS)) \
+         & GF_TIMER_LEVEL_MASK)
+
+
+/* current tick, in milliseconds of the clock the timer thread waits on */
+static uint64_t
+gf_timer_now (void)
+{
+#ifdef GF_TIMER_MONOTONIC
+        struct timespec ts = {0, };
+
+        clock_gettime (CLOCK_MONOTONIC, &ts);
+        return ((uint64_t) ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+#else
+        struct timeval  tv = {0, };
+
+        gettimeofday (&tv, NULL);
+        return ((uint64_t) tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+#endif
+}
+
+
+static void
+__gf_timer_add (gf_timer_registry_t *reg, gf_timer_t *event)
+{
+        uint64_t  delta = 0;
+        int       level = 0;
+
+        if (event->expires < reg->base)
+                event->expires = reg->base;
+
+        delta = event->expires - reg->base;
+        if (delta < GF_TIMER_ROOT_SIZE) {
+                event->level = 0;
+                list_add_tail (&event->list,
+                               &reg->root[event->expires & GF_TIMER_ROOT_MASK]);
+                reg->root_count++;
+                return;
+        }
+
+        if (delta >= GF_TIMER_SPAN (GF_TIMER_LEVELS)) {
+                delta = GF_TIMER_SPAN (GF_TIMER_LEVELS) - 1;
+                event->expires = reg->base + delta;
+        }
+
+        for (level = 1; delta >= GF_TIMER_SPAN (level); level++)
+                ;
+
+        event->level = level;
+        list_add_tail (&event->list,
+                       &reg->levels[level - 1][GF_TIMER_INDEX (event->expires,
+                                                               level)]);
+}
+
+
+static void
+__gf_timer_del (gf_timer_registry_t *reg, gf_timer_t *event)
+{
+        list_del_init (&event->list);
+
+        if (event->level == 0)
+                reg->root_count--;
+        if (event->level != GF_TIMER_STALE)
+                reg->pending--;
+}
+
+
+/* redistribute a slot of @level into the wheels below it, returns the
+   slot index so the caller knows whether the next level wrapped too */
+static int
+__gf_timer_cascade (gf_timer_registry_t *reg, int level)
+{
+        struct list_head  list;
+        gf_timer_t       *event = NULL;
+        gf_timer_t       *tmp   = NULL;
+        int               index = 0;
+
+        index = GF_TIMER_INDEX (reg->base, level);
+
+        INIT_LIST_HEAD (&list);
+        list_splice_init (&reg->levels[level - 1][index], &list);
+
+        list_for_each_entry_safe (event, tmp, &list, list) {
+                list_del_init (&event->list);
+                __gf_timer_add (reg, event);
+        }
+
+        return index;
+}
+
+
+/* called with reg->lock held, drops it around the callbacks */
+static void
+__gf_timer_run_tick (gf_timer_registry_t *reg)
+{
+        struct list_head  expired;
+        gf_timer_t       *event = NULL;
+        gf_timer_cbk_t    callbk = NULL;
+        void             *data = NULL;
+        xlator_t         *xl = NULL;
+        int               index = 0;
+        int               level = 0;
+
+        index = reg->base & GF_TIMER_ROOT_MASK;
+        if (index == 0) {
+                for (level = 1; level <= GF_TIMER_LEVELS; level++) {
+                        if (__gf_timer_cascade (reg, level) != 0)
+                                break;
+                }
+        }
+
+        INIT_LIST_HEAD (&expired);
+        list_splice_init (&reg->root[index], &expired);
+
+        /* anything added from a callback lands in a later tick */
+        reg->base++;
+
+        /* the callbacks may cancel events still on @expired, so pick them
+           off one at a time */
+        while (!list_empty (&expired)) {
+                event = list_entry (expired.next, gf_timer_t, list);
+                __gf_timer_del (reg, event);
+
+                event->level = GF_TIMER_STALE;
+                list_add_tail (&event->list, &reg->stale);
+                reg->fired++;
+
+                callbk = event->callbk;
+                data   = event->data;
+                xl     = event->xl;
+
+                pthread_mutex_unlock (&reg->lock);
+                {
+                        if (xl)
+                                THIS = xl;
+                        callbk (data);
+                }
+                pthread_mutex_lock (&reg->lock);
+        }
+}
+
+
+/* first tick that needs the timer thread: a due root slot or the next
+   cascade */
+static uint64_t
+__gf_timer_next_tick (gf_timer_registry_t *reg)
+{
+        uint64_t  tick = 0;
+        uint64_t  next = 0;
+
+        next = (reg->base + GF_TIMER_ROOT_MASK) & ~((uint64_t) GF_TIMER_ROOT_MASK);
+        if (!reg->root_count)
+                return next;
+
+        for (tick = reg->base; tick < next; tick++) {
+                if (!list_empty (&reg->root[tick & GF_TIMER_ROOT_MASK]))
+                        return tick;
+        }
+
+        return next;
+}
 
-#define TS(tv) ((((unsigned long long) tv.tv_sec) * 1000000) + (tv.tv_usec))
 
 gf_timer_t *
 gf_timer_call_after (glusterfs_ctx_t *ctx,
@@ -28,8 +201,7 @@ gf_timer_call_after (glusterfs_ctx_t *ctx,
 {
         gf_timer_registry_t *reg = NULL;
         gf_timer_t *event = NULL;
-        gf_timer_t *trav = NULL;
-        unsigned long long at = 0L;
+        uint64_t    msec  = 0;
 
         if (ctx == NULL)
         {
@@ -48,51 +220,28 @@ gf_timer_call_after (glusterfs_ctx_t *ctx,
         if (!event) {
                 return NULL;
         }
-        gettimeofday (&event->at, NULL);
-        event->at.tv_usec = ((event->at.tv_usec + delta.tv_usec) % 1000000);
-        event->at.tv_sec += ((event->at.tv_usec + delta.tv_usec) / 1000000);
-        event->at.tv_sec += delta.tv_sec;
-        at = TS (event->at);
+
+        msec = ((uint64_t) delta.tv_sec * 1000) + ((delta.tv_usec + 999) / 1000);
+
+        INIT_LIST_HEAD (&event->list);
+        /* now() rounds down, one more tick so we never fire early */
+        event->expires = gf_timer_now () + msec + 1;
         event->callbk = callbk;
         event->data = data;
         event->xl = THIS;
         pthread_mutex_lock (&reg->lock);
         {
-                trav = reg->active.prev;
-                while (trav != &reg->active) {
-                        if (TS (trav->at) < at)
-                                break;
-                        trav = trav->prev;
-                }
-                event->prev = trav;
-                event->next = event->prev->next;
-                event->prev->next = event;
-                event->next->prev = event;
+                __gf_timer_add (reg, event);
+                reg->pending++;
+                reg->armed++;
+
+                if (event->expires < reg->wake_at)
+                        pthread_cond_signal (&reg->cond);
         }
         pthread_mutex_unlock (&reg->lock);
         return event;
 }
 
-int32_t
-gf_timer_call_stale (gf_timer_registry_t *reg,
-                     gf_timer_t *event)
-{
-        if (reg == NULL || event == NULL)
-        {
-                gf_log_callingfn ("timer", GF_LOG_ERROR, "invalid argument");
-                return 0;
-        }
-
-        event->next->prev = event->prev;
-        event->prev->next = event->next;
-        event->next = &reg->stale;
-        event->prev = event->next->prev;
-        event->next->prev = event;
-        event->prev->next = event;
-
-        return 0;
-}
-
 int32_t
 gf_timer_call_cancel (glusterfs_ctx_t *ctx,
                       gf_timer_t *event)
@@ -114,8 +263,9 @@ gf_timer_call_cancel (glusterfs_ctx_t *ctx,
 
         pthread_mutex_lock (&reg->lock);
         {
-                event->next->prev = event->prev;
-                event->prev->next = event->next;
+                if (event->level != GF_TIMER_STALE)
+                        reg->cancelled++;
+                __gf_timer_del (reg, event);
         }
         pthread_mutex_unlock (&reg->lock);
 
@@ -127,7 +277,12 @@ void *
 gf_timer_proc (void *ctx)
 {
         gf_timer_registry_t *reg = NULL;
-	const struct timespec sleepts = {.tv_sec = 1, .tv_nsec = 0, };
+        gf_timer_t          *event = NULL;
+        struct timespec      sleep_till = {0, };
+        uint64_t             now = 0;
+        uint64_t             next = 0;
+        int                  i = 0;
+        int                  j = 0;
 
         if (ctx == NULL)
         {
@@ -141,50 +296,52 @@ gf_timer_proc (void *ctx)
                 return NULL;
         }
 
+        pthread_mutex_lock (&reg->lock);
         while (!reg->fin) {
-                unsigned long long now;
-                struct timeval now_tv;
-                gf_timer_t *event = NULL;
-
-                gettimeofday (&now_tv, NULL);
-                now = TS (now_tv);
-                while (1) {
-                        unsigned long long at;
-                        char need_cbk = 0;
-
-                        pthread_mutex_lock (&reg->lock);
-                        {
-                                event = reg->active.next;
-                                at = TS (event->at);
-                                if (event != &reg->active && now >= at) {
-                                        need_cbk = 1;
-                                        gf_timer_call_stale (reg, event);
-                                }
+                now = gf_timer_now ();
+                while (reg->base <= now) {
+                        if (reg->root_count) {
+                                __gf_timer_run_tick (reg);
+                                continue;
                         }
-                        pthread_mutex_unlock (&reg->lock);
-                        if (event->xl)
-                                THIS = event->xl;
-                        if (need_cbk)
-                                event->callbk  (event->data);
 
-                        else
-                                break;
+                        /* nothing in the root wheel, skip to the next
+                           cascade or to now, whichever comes first */
+                        next = __gf_timer_next_tick (reg);
+                        if (next > reg->base) {
+                                reg->base = min (next, now + 1);
+                                continue;
+                        }
+                        __gf_timer_run_tick (reg);
                 }
-                nanosleep (&sleepts, NULL);
-        }
 
-        pthread_mutex_lock (&reg->lock);
-        {
-                while (reg->active.next != &reg->active) {
-                        gf_timer_call_cancel (ctx, reg->active.next);
+                if (!reg->pending) {
+                        reg->wake_at = UINT64_MAX;
+                        pthread_cond_wait (&reg->cond, &reg->lock);
+                        continue;
                 }
 
-                while (reg->stale.next != &reg->stale) {
-                        gf_timer_call_cancel (ctx, reg->stale.next);
-                }
+                reg->wake_at = __gf_timer_next_tick (reg);
+                sleep_till.tv_sec  = reg->wake_at / 1000;
+                sleep_till.tv_nsec = (reg->wake_at % 1000) * 1000000;
+                pthread_cond_timedwait (&reg->cond, &reg->lock, &sleep_till);
+        }
+
+        for (i = 0; i < GF_TIMER_ROOT_SIZE; i++)
+                list_splice_init (&reg->root[i], &reg->stale);
+        for (i = 0; i < GF_TIMER_LEVELS; i++) {
+                for (j = 0; j < GF_TIMER_LEVEL_SIZE; j++)
+                        list_splice_init (&reg->levels[i][j], &reg->stale);
+        }
+        while (!list_empty (&reg->stale)) {
+                event = list_entry (reg->stale.next, gf_timer_t, list);
+                list_del_init (&event->list);
+                GF_FREE (event);
         }
         pthread_mutex_unlock (&reg->lock);
+
         pthread_mutex_destroy (&reg->lock);
+        pthread_cond_destroy (&reg->cond);
         GF_FREE (((glusterfs_ctx_t *)ctx)->timer);
 
         return NULL;
@@ -193,6 +350,9 @@ gf_timer_proc (void *ctx)
 gf_timer_registry_t *
 gf_timer_registry_init (glusterfs_ctx_t *ctx)
 {
+        int  i = 0;
+        int  j = 0;
+
         if (ctx == NULL) {
                 gf_log_callingfn ("timer", GF_LOG_ERROR, "invalid argument");
                 return NULL;
@@ -200,6 +360,9 @@ gf_timer_registry_init (glusterfs_ctx_t *ctx)
 
         if (!ctx->timer) {
                 gf_timer_registry_t *reg = NULL;
+#ifdef GF_TIMER_MONOTONIC
+                pthread_condattr_t   attr;
+#endif
 
                 reg = GF_CALLOC (1, sizeof (*reg),
                                  gf_common_mt_gf_timer_registry_t);
@@ -207,10 +370,24 @@ gf_timer_registry_init (glusterfs_ctx_t *ctx)
                         goto out;
 
                 pthread_mutex_init (&reg->lock, NULL);
-                reg->active.next = &reg->active;
-                reg->active.prev = &reg->active;
-                reg->stale.next = &reg->stale;
-                reg->stale.prev = &reg->stale;
+#ifdef GF_TIMER_MONOTONIC
+                pthread_condattr_init (&attr);
+                pthread_condattr_setclock (&attr, CLOCK_MONOTONIC);
+                pthread_cond_init (&reg->cond, &attr);
+                pthread_condattr_destroy (&attr);
+#else
+                pthread_cond_init (&reg->cond, NULL);
+#endif
+                for (i = 0; i < GF_TIMER_ROOT_SIZE; i++)
+                        INIT_LIST_HEAD (&reg->root[i]);
+                for (i = 0; i < GF_TIMER_LEVELS; i++) {
+                        for (j = 0; j < GF_TIMER_LEVEL_SIZE; j++)
+                                INIT_LIST_HEAD (&reg->levels[i][j]);
+                }
+                INIT_LIST_HEAD (&reg->stale);
+
+                reg->base = gf_timer_now ();
+                reg->wake_at = UINT64_MAX;
 
                 ctx->timer = reg;
                 pthread_create (&reg->th, NULL, gf_timer_proc, ctx);
@@ -218,3 +395,45 @@ gf_timer_registry_init (glusterfs_ctx_t *ctx)
 out:
         return ctx->timer;
 }
+
+/* the timer thread frees the registry on its way out */
+void
+gf_timer_registry_destroy (glusterfs_ctx_t *ctx)
+{
+        gf_timer_registry_t *reg = NULL;
+
+        if (ctx == NULL || ctx->timer == NULL)
+                return;
+
+        reg = ctx->timer;
+
+        pthread_mutex_lock (&reg->lock);
+        {
+                reg->fin = 1;
+                pthread_cond_signal (&reg->cond);
+        }
+        pthread_mutex_unlock (&reg->lock);
+}
+
+void
+gf_timer_dump (glusterfs_ctx_t *ctx)
+{
+        gf_timer_registry_t *reg = NULL;
+
+        if (!ctx || !ctx->timer)
+                return;
+
+        reg = ctx->timer;
+
+        gf_proc_dump_add_section ("timer");
+
+        if (pthread_mutex_trylock (&reg->lock) != 0)
+                return;
+        {
+                gf_proc_dump_write ("pending", "%"PRIu64, reg->pending);
+                gf_proc_dump_write ("armed", "%"PRIu64, reg->armed);
+                gf_proc_dump_write ("fired", "%"PRIu64, reg->fired);
+                gf_proc_dump_write ("cancelled", "%"PRIu64, reg->cancelled);
+        }
+        pthread_mutex_unlock (&reg->lock);
+}
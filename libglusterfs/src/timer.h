@@ -18,14 +18,29 @@
 
 #include "glusterfs.h"
 #include "xlator.h"
+#include "list.h"
 #include <sys/time.h>
 #include <pthread.h>
 
 typedef void (*gf_timer_cbk_t) (void *);
 
+/* hierarchical timing wheel with a resolution of one millisecond. the
+   root wheel covers the next 256 ticks, each upper level 64 times the
+   span of the one below it, for a horizon of about 49 days. */
+#define GF_TIMER_ROOT_BITS   8
+#define GF_TIMER_ROOT_SIZE   (1 << GF_TIMER_ROOT_BITS)
+#define GF_TIMER_ROOT_MASK   (GF_TIMER_ROOT_SIZE - 1)
+#define GF_TIMER_LEVEL_BITS  6
+#define GF_TIMER_LEVEL_SIZE  (1 << GF_TIMER_LEVEL_BITS)
+#define GF_TIMER_LEVEL_MASK  (GF_TIMER_LEVEL_SIZE - 1)
+#define GF_TIMER_LEVELS      4            /* above the root wheel */
+
+#define GF_TIMER_STALE       (GF_TIMER_LEVELS + 1)
+
 struct _gf_timer {
-        struct _gf_timer *next, *prev;
-        struct timeval    at;
+        struct list_head  list;
+        uint64_t          expires;  /* tick (ms) to fire at */
+        int               level;    /* 0 is the root wheel */
         gf_timer_cbk_t    callbk;
         void             *data;
         xlator_t         *xl;
@@ -34,9 +49,18 @@ struct _gf_timer {
 struct _gf_timer_registry {
         pthread_t        th;
         char             fin;
-        struct _gf_timer stale;
-        struct _gf_timer active;
         pthread_mutex_t  lock;
+        pthread_cond_t   cond;
+        uint64_t         base;      /* next tick to be run */
+        uint64_t         wake_at;   /* tick the timer thread sleeps till */
+        struct list_head root[GF_TIMER_ROOT_SIZE];
+        struct list_head levels[GF_TIMER_LEVELS][GF_TIMER_LEVEL_SIZE];
+        struct list_head stale;     /* fired, not yet cancelled */
+        uint32_t         root_count;
+        uint64_t         pending;
+        uint64_t         armed;
+        uint64_t         fired;
+        uint64_t         cancelled;
 };
 
 typedef struct _gf_timer gf_timer_t;
@@ -58,4 +82,10 @@ gf_timer_proc (void *data);
 gf_timer_registry_t *
 gf_timer_registry_init (glusterfs_ctx_t *ctx);
 
+void
+gf_timer_registry_destroy (glusterfs_ctx_t *ctx);
+
+void
+gf_timer_dump (glusterfs_ctx_t *ctx);
+
 #endif /* _TIMER_H */
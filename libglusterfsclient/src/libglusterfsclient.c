@@ -2053,7 +2053,7 @@ glusterfs_fini (glusterfs_handle_t handle)
 	 mem_pool_destroy (ctx->itable->dentry_pool);
 	 mem_pool_destroy (ctx->itable->fd_mem_pool);
         /* iobuf_pool_destroy (ctx->gf_ctx.iobuf_pool); */
-        ((gf_timer_registry_t *)ctx->gf_ctx.timer)->fin = 1;
+        gf_timer_registry_destroy (&ctx->gf_ctx);
 
 	xlator_graph_fini (ctx->gf_ctx.graph);
 	xlator_tree_free (ctx->gf_ctx.graph);
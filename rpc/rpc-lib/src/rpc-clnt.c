@@ -43,6 +43,52 @@ rpc_clnt_new_callid (struct rpc_clnt *clnt)
 }
 
 
+static inline struct list_head *
+__saved_frames_bucket (struct saved_frames *frames, uint32_t xid)
+{
+        return &frames->buckets[xid & (frames->bucket_count - 1)];
+}
+
+
+/* keep chains short by doubling the table once it averages two frames
+   per bucket. failing to grow only costs lookup speed. */
+static void
+__saved_frames_grow (struct saved_frames *frames)
+{
+        struct list_head   *buckets = NULL;
+        struct list_head   *old     = NULL;
+        struct saved_frame *trav    = NULL;
+        struct saved_frame *tmp     = NULL;
+        uint32_t            count   = 0;
+        uint32_t            i       = 0;
+
+        if (frames->count <= (int64_t) frames->bucket_count * 2)
+                return;
+
+        count = frames->bucket_count * 2;
+        buckets = GF_CALLOC (count, sizeof (*buckets),
+                             gf_common_mt_rpcclnt_frame_hash);
+        if (!buckets)
+                return;
+
+        for (i = 0; i < count; i++)
+                INIT_LIST_HEAD (&buckets[i]);
+
+        old = frames->buckets;
+        for (i = 0; i < frames->bucket_count; i++) {
+                list_for_each_entry_safe (trav, tmp, &old[i], hash) {
+                        list_move_tail (&trav->hash,
+                                        &buckets[trav->rpcreq->xid &
+                                                 (count - 1)]);
+                }
+        }
+
+        frames->buckets = buckets;
+        frames->bucket_count = count;
+        GF_FREE (old);
+}
+
+
 struct saved_frame *
 __saved_frames_get_timedout (struct saved_frames *frames, uint32_t timeout,
                              struct timeval *current)
@@ -54,6 +100,7 @@ __saved_frames_get_timedout (struct saved_frames *frames, uint32_t timeout,
 		if ((tmp->saved_at.tv_sec + timeout) < current->tv_sec) {
 			bailout_frame = tmp;
 			list_del_init (&bailout_frame->list);
+			list_del_init (&bailout_frame->hash);
 			frames->count--;
 		}
 	}
@@ -91,6 +138,7 @@ __saved_frames_put (struct saved_frames *frames, void *frame,
 
         memset (saved_frame, 0, sizeof (*saved_frame));
 	INIT_LIST_HEAD (&saved_frame->list);
+	INIT_LIST_HEAD (&saved_frame->hash);
 
 	saved_frame->capital_this = THIS;
 	saved_frame->frame        = frame;
@@ -102,8 +150,13 @@ __saved_frames_put (struct saved_frames *frames, void *frame,
         else
                 list_add_tail (&saved_frame->list, &frames->sf.list);
 
+        list_add_tail (&saved_frame->hash,
+                       __saved_frames_bucket (frames, rpcreq->xid));
+
 	frames->count++;
 
+        __saved_frames_grow (frames);
+
 out:
 	return saved_frame;
 }
@@ -119,6 +172,7 @@ saved_frames_delete (struct saved_frame *saved_frame,
         pthread_mutex_lock (&conn->lock);
         {
                 list_del_init (&saved_frame->list);
+                list_del_init (&saved_frame->hash);
                 conn->saved_frames->count--;
         }
         pthread_mutex_unlock (&conn->lock);
@@ -258,12 +312,26 @@ saved_frames_new (void)
 {
 	struct saved_frames *saved_frames = NULL;
 
+        uint32_t             i            = 0;
+
 	saved_frames = GF_CALLOC (1, sizeof (*saved_frames),
                                   gf_common_mt_rpcclnt_savedframe_t);
 	if (!saved_frames) {
 		return NULL;
 	}
 
+        saved_frames->buckets = GF_CALLOC (SAVED_FRAMES_MIN_BUCKETS,
+                                           sizeof (*saved_frames->buckets),
+                                           gf_common_mt_rpcclnt_frame_hash);
+        if (!saved_frames->buckets) {
+                GF_FREE (saved_frames);
+                return NULL;
+        }
+
+        saved_frames->bucket_count = SAVED_FRAMES_MIN_BUCKETS;
+        for (i = 0; i < saved_frames->bucket_count; i++)
+                INIT_LIST_HEAD (&saved_frames->buckets[i]);
+
 	INIT_LIST_HEAD (&saved_frames->sf.list);
 	INIT_LIST_HEAD (&saved_frames->lk_sf.list);
 
@@ -271,6 +339,21 @@ saved_frames_new (void)
 }
 
 
+static struct saved_frame *
+__saved_frame_lookup (struct saved_frames *frames, int64_t callid)
+{
+	struct saved_frame *tmp = NULL;
+
+	list_for_each_entry (tmp, __saved_frames_bucket (frames, callid),
+                             hash) {
+		if (tmp->rpcreq->xid == callid)
+			return tmp;
+	}
+
+        return NULL;
+}
+
+
 int
 __saved_frame_copy (struct saved_frames *frames, int64_t callid,
                     struct saved_frame *saved_frame)
@@ -283,21 +366,11 @@ __saved_frame_copy (struct saved_frames *frames, int64_t callid,
                 goto out;
         }
 
-	list_for_each_entry (tmp, &frames->sf.list, list) {
-		if (tmp->rpcreq->xid == callid) {
-			*saved_frame = *tmp;
-                        ret = 0;
-			goto out;
-		}
-	}
-
-	list_for_each_entry (tmp, &frames->lk_sf.list, list) {
-		if (tmp->rpcreq->xid == callid) {
-			*saved_frame = *tmp;
-                        ret = 0;
-			goto out;
-		}
-	}
+        tmp = __saved_frame_lookup (frames, callid);
+        if (tmp) {
+                *saved_frame = *tmp;
+                ret = 0;
+        }
 
 out:
 	return ret;
@@ -308,28 +381,12 @@ struct saved_frame *
 __saved_frame_get (struct saved_frames *frames, int64_t callid)
 {
 	struct saved_frame *saved_frame = NULL;
-	struct saved_frame *tmp = NULL;
-
-	list_for_each_entry (tmp, &frames->sf.list, list) {
-		if (tmp->rpcreq->xid == callid) {
-			list_del_init (&tmp->list);
-			frames->count--;
-			saved_frame = tmp;
-			goto out;
-		}
-	}
 
-	list_for_each_entry (tmp, &frames->lk_sf.list, list) {
-		if (tmp->rpcreq->xid == callid) {
-			list_del_init (&tmp->list);
-			frames->count--;
-			saved_frame = tmp;
-			goto out;
-		}
-	}
-
-out:
+        saved_frame = __saved_frame_lookup (frames, callid);
 	if (saved_frame) {
+                list_del_init (&saved_frame->list);
+                list_del_init (&saved_frame->hash);
+                frames->count--;
                 THIS  = saved_frame->capital_this;
         }
 
@@ -382,6 +439,7 @@ saved_frames_unwind (struct saved_frames *saved_frames)
 
                 clnt = rpc_clnt_unref (clnt);
 		list_del_init (&trav->list);
+		list_del_init (&trav->hash);
                 mem_put (trav);
 	}
 }
@@ -395,6 +453,7 @@ saved_frames_destroy (struct saved_frames *frames)
 
 	saved_frames_unwind (frames);
 
+        GF_FREE (frames->buckets);
 	GF_FREE (frames);
 }
 
@@ -460,7 +519,7 @@ rpc_clnt_reconnect (void *trans_ptr)
 int
 rpc_clnt_fill_request_info (struct rpc_clnt *clnt, rpc_request_info_t *info)
 {
-        struct saved_frame  saved_frame = {{}, 0};
+        struct saved_frame  saved_frame = {{}, {0, }, 0};
         int                 ret         = -1;
 
         pthread_mutex_lock (&clnt->conn.lock);
@@ -49,6 +49,7 @@ struct saved_frame {
 			struct saved_frame *frame_prev;
 		};
 	};
+        struct list_head         hash;   /* chain in saved_frames->buckets */
         void                    *capital_this;
 	void                    *frame;
 	struct timeval           saved_at;
@@ -56,10 +57,17 @@ struct saved_frame {
         rpc_transport_rsp_t      rsp;
 };
 
+#define SAVED_FRAMES_MIN_BUCKETS 64
+
+/* sf and lk_sf are kept in submission order, which for a fixed
+   frame-timeout is also bail-out order. replies are matched through
+   buckets, indexed by the low bits of the (sequential) xid. */
 struct saved_frames {
 	int64_t            count;
 	struct saved_frame sf;
 	struct saved_frame lk_sf;
+        struct list_head  *buckets;
+        uint32_t           bucket_count;  /* power of two */
 };
 
 
@@ -134,6 +134,404 @@ int socket_init (rpc_transport_t *this);
  * > 0 = incomplete
  */
 
+#ifdef HAVE_LIBSSL
+static void
+__socket_ssl_log_errors (rpc_transport_t *this, const char *op)
+{
+        unsigned long err = 0;
+        char          buf[256];
+
+        while ((err = ERR_get_error ()) != 0) {
+                ERR_error_string_n (err, buf, sizeof (buf));
+                gf_log (this->name, GF_LOG_ERROR, "%s: %s", op, buf);
+        }
+}
+
+
+/* records a session the server handed out, the next connect resumes it.
+ * A copy is kept: the one attached to the connection is invalidated if it
+ * dies on an error, which is exactly when we want to resume.
+ */
+static int
+socket_ssl_new_session (SSL *ssl, SSL_SESSION *session)
+{
+        rpc_transport_t  *this = NULL;
+        socket_private_t *priv = NULL;
+        SSL_SESSION      *copy = NULL;
+
+        this = SSL_get_app_data (ssl);
+        if (!this || !this->private)
+                return 0;
+
+        priv = this->private;
+
+        copy = SSL_SESSION_dup (session);
+        if (!copy)
+                return 0;
+
+        if (priv->ssl_session)
+                SSL_SESSION_free (priv->ssl_session);
+        priv->ssl_session = copy;
+
+        return 0;
+}
+
+
+static SSL_CTX *
+socket_ssl_ctx_new (rpc_transport_t *this, gf_boolean_t ktls)
+{
+        SSL_CTX *ctx      = NULL;
+        char    *own_cert = NULL;
+        char    *key      = NULL;
+        char    *ca_list  = NULL;
+
+        if (dict_get_str (this->options, "transport.socket.ssl-own-cert",
+                          &own_cert) != 0)
+                own_cert = SSL_OWN_CERT_DEFAULT;
+        if (dict_get_str (this->options, "transport.socket.ssl-private-key",
+                          &key) != 0)
+                key = SSL_PRIVATE_KEY_DEFAULT;
+        if (dict_get_str (this->options, "transport.socket.ssl-ca-list",
+                          &ca_list) != 0)
+                ca_list = SSL_CA_LIST_DEFAULT;
+
+        ctx = SSL_CTX_new (TLS_method ());
+        if (!ctx)
+                goto err;
+
+        SSL_CTX_set_min_proto_version (ctx, TLS1_2_VERSION);
+        SSL_CTX_set_options (ctx, SSL_OP_NO_COMPRESSION);
+#ifdef SSL_OP_NO_RENEGOTIATION
+        SSL_CTX_set_options (ctx, SSL_OP_NO_RENEGOTIATION);
+#endif
+#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+        /* peers just close the socket, that is not an attack on us */
+        SSL_CTX_set_options (ctx, SSL_OP_IGNORE_UNEXPECTED_EOF);
+#endif
+#ifdef SSL_OP_ENABLE_KTLS
+        if (ktls)
+                SSL_CTX_set_options (ctx, SSL_OP_ENABLE_KTLS);
+#endif
+        /* a record which did not go out is retried from the ioq, i.e.
+           possibly from a different (re-gathered) buffer */
+        SSL_CTX_set_mode (ctx, SSL_MODE_ENABLE_PARTIAL_WRITE |
+                          SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+        SSL_CTX_set_read_ahead (ctx, 1);
+
+        if (SSL_CTX_use_certificate_chain_file (ctx, own_cert) != 1) {
+                gf_log (this->name, GF_LOG_ERROR,
+                        "could not load our cert %s", own_cert);
+                goto err;
+        }
+
+        if (SSL_CTX_use_PrivateKey_file (ctx, key, SSL_FILETYPE_PEM) != 1) {
+                gf_log (this->name, GF_LOG_ERROR,
+                        "could not load private key %s", key);
+                goto err;
+        }
+
+        if (SSL_CTX_load_verify_locations (ctx, ca_list, NULL) != 1) {
+                gf_log (this->name, GF_LOG_ERROR,
+                        "could not load CA list %s", ca_list);
+                goto err;
+        }
+
+        /* both ends authenticate */
+        SSL_CTX_set_verify (ctx, SSL_VERIFY_PEER |
+                            SSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
+
+        /* resumption keeps reconnect storms from turning into a pile of
+           full handshakes */
+        SSL_CTX_set_session_id_context (ctx, (unsigned char *)"glusterfs",
+                                        strlen ("glusterfs"));
+        SSL_CTX_set_session_cache_mode (ctx, SSL_SESS_CACHE_BOTH);
+        SSL_CTX_sess_set_new_cb (ctx, socket_ssl_new_session);
+
+        return ctx;
+
+err:
+        __socket_ssl_log_errors (this, "SSL init");
+        if (ctx)
+                SSL_CTX_free (ctx);
+
+        return NULL;
+}
+
+
+/* sets up the TLS session on priv->sock, the handshake itself is driven by
+ * __socket_ssl_handshake() from the event handler */
+static int
+__socket_ssl_start (rpc_transport_t *this, socket_private_t *priv,
+                    gf_boolean_t server)
+{
+        SSL *ssl = NULL;
+
+        ssl = SSL_new (priv->ssl_ctx);
+        if (!ssl || SSL_set_fd (ssl, priv->sock) != 1)
+                goto err;
+
+        if (server) {
+                SSL_set_accept_state (ssl);
+        } else {
+                SSL_set_connect_state (ssl);
+                SSL_set_app_data (ssl, this);
+                if (priv->ssl_session)
+                        SSL_set_session (ssl, priv->ssl_session);
+        }
+
+        priv->ssl_ssl = ssl;
+        priv->ssl_ktls_send = 0;
+        priv->ssl_handshake = 1;
+
+        return 0;
+
+err:
+        __socket_ssl_log_errors (this, "SSL setup");
+        if (ssl)
+                SSL_free (ssl);
+
+        return -1;
+}
+
+
+/* runs the handshake as far as it gets without waiting for the peer.
+ * Returns 0 once it is done, 1 if the socket has to become readable or
+ * writable first (the fd is re-armed for that) and -1 on failure.
+ */
+static int
+__socket_ssl_handshake (rpc_transport_t *this, socket_private_t *priv)
+{
+        X509 *peer = NULL;
+        char  peer_cn[256] = {0, };
+        int   ret  = 0;
+        int   err  = 0;
+
+        ERR_clear_error ();
+        errno = 0;
+
+        ret = SSL_do_handshake (priv->ssl_ssl);
+        if (ret != 1) {
+                err = SSL_get_error (priv->ssl_ssl, ret);
+                if (err == SSL_ERROR_WANT_READ ||
+                    err == SSL_ERROR_WANT_WRITE) {
+                        priv->idx = event_select_on (this->ctx->event_pool,
+                                                     priv->sock, priv->idx,
+                                                     -1, (err ==
+                                                     SSL_ERROR_WANT_WRITE));
+                        return 1;
+                }
+
+                if (err == SSL_ERROR_SYSCALL && errno)
+                        gf_log (this->name, GF_LOG_ERROR,
+                                "SSL handshake failed (%s)",
+                                strerror (errno));
+                __socket_ssl_log_errors (this, SSL_is_server (priv->ssl_ssl) ?
+                                         "SSL accept" : "SSL connect");
+                return -1;
+        }
+
+        priv->ssl_handshake = 0;
+
+        peer = SSL_get1_peer_certificate (priv->ssl_ssl);
+        if (peer) {
+                X509_NAME_get_text_by_NID (X509_get_subject_name (peer),
+                                           NID_commonName, peer_cn,
+                                           sizeof (peer_cn));
+                X509_free (peer);
+        }
+
+        gf_log (this->name, GF_LOG_DEBUG,
+                "%s (%s) with \"%s\", %s", SSL_get_version (priv->ssl_ssl),
+                SSL_get_cipher (priv->ssl_ssl), peer_cn,
+                SSL_session_reused (priv->ssl_ssl) ? "resumed" :
+                "full handshake");
+
+#ifdef SSL_OP_ENABLE_KTLS
+        /* the kernel encrypts, so the ioq can be handed to writev as is */
+        if (BIO_get_ktls_send (SSL_get_wbio (priv->ssl_ssl))) {
+                priv->ssl_ktls_send = 1;
+                gf_log (this->name, GF_LOG_DEBUG,
+                        "kernel TLS offload enabled for sending");
+        }
+#endif
+
+        /* whatever got queued in the meantime goes out from poll_out */
+        priv->idx = event_select_on (this->ctx->event_pool, priv->sock,
+                                     priv->idx, -1, 1);
+
+        return 0;
+}
+
+
+static void
+__socket_ssl_detach (socket_private_t *priv)
+{
+        if (!priv->ssl_ssl)
+                return;
+
+        /* no close_notify on a dead socket, but keep the session
+           resumable */
+        SSL_set_shutdown (priv->ssl_ssl,
+                          SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+        SSL_free (priv->ssl_ssl);
+        priv->ssl_ssl = NULL;
+        priv->ssl_ktls_send = 0;
+        priv->ssl_handshake = 0;
+}
+
+
+/* readv/writev over the TLS session, same return convention */
+static ssize_t
+__socket_ssl_rwv (rpc_transport_t *this, struct iovec *vector, int count,
+                  int write)
+{
+        socket_private_t *priv = NULL;
+        char              buf[SOCKET_SSL_GATHER_SIZE];
+        char             *base = NULL;
+        size_t            len  = 0;
+        ssize_t           done = 0;
+        int               i    = 0;
+        int               ret  = 0;
+        int               err  = 0;
+
+        priv = this->private;
+
+        while (i < count) {
+                if (!write || vector[i].iov_len >= sizeof (buf)) {
+                        base = vector[i].iov_base;
+                        len = vector[i].iov_len;
+                        i++;
+                } else {
+                        /* one record for the small headers in a row */
+                        base = buf;
+                        len = 0;
+                        while (i < count &&
+                               len + vector[i].iov_len <= sizeof (buf)) {
+                                memcpy (buf + len, vector[i].iov_base,
+                                        vector[i].iov_len);
+                                len += vector[i].iov_len;
+                                i++;
+                        }
+                }
+
+                if (!len)
+                        continue;
+
+                ERR_clear_error ();
+                errno = 0;
+
+                ret = write ? SSL_write (priv->ssl_ssl, base, len)
+                        : SSL_read (priv->ssl_ssl, base, len);
+                if (ret > 0) {
+                        done += ret;
+                        if (ret < len)
+                                break;
+                        continue;
+                }
+
+                /* what went through is reported now, the error again on
+                   the next call */
+                if (done)
+                        break;
+
+                err = SSL_get_error (priv->ssl_ssl, ret);
+                switch (err) {
+                case SSL_ERROR_WANT_READ:
+                case SSL_ERROR_WANT_WRITE:
+                        errno = EAGAIN;
+                        return -1;
+                case SSL_ERROR_ZERO_RETURN:
+                        return 0;
+                case SSL_ERROR_SYSCALL:
+                        if (!errno)
+                                errno = ECONNRESET;
+                        return -1;
+                default:
+                        __socket_ssl_log_errors (this, write ? "SSL write"
+                                                 : "SSL read");
+                        errno = EIO;
+                        return -1;
+                }
+        }
+
+        return done;
+}
+#endif /* HAVE_LIBSSL */
+
+
+static ssize_t
+__socket_sys_readv (rpc_transport_t *this, int sock, struct iovec *vector,
+                    int count)
+{
+#ifdef HAVE_LIBSSL
+        socket_private_t *priv = this->private;
+
+        if (priv->ssl_ssl)
+                return __socket_ssl_rwv (this, vector, count, 0);
+#endif
+
+        return readv (sock, vector, count);
+}
+
+
+/* readv() replacement for the receive path: short reads are served from the
+   read-ahead buffer, refilled with a single recv, so that the headers of all
+   the records which arrived together cost one system call */
+static ssize_t
+__socket_readahead_readv (rpc_transport_t *this, int sock,
+                          struct iovec *vector, int count)
+{
+        socket_private_t *priv   = NULL;
+        struct iovec      iov    = {0, };
+        char             *buf    = NULL;
+        ssize_t           ret    = 0;
+        size_t            copied = 0;
+        size_t            len    = 0;
+        int               i      = 0;
+
+        priv = this->private;
+
+        if (!priv->readahead.len) {
+                if (iov_length (vector, count) >= SOCKET_READAHEAD_SIZE)
+                        return __socket_sys_readv (this, sock, vector, count);
+
+                if (!priv->readahead.iobuf) {
+                        priv->readahead.iobuf =
+                                iobuf_get2 (this->ctx->iobuf_pool,
+                                            SOCKET_READAHEAD_SIZE);
+                        if (!priv->readahead.iobuf)
+                                return __socket_sys_readv (this, sock, vector,
+                                                           count);
+                }
+
+                iov.iov_base = iobuf_ptr (priv->readahead.iobuf);
+                iov.iov_len = iobuf_pagesize (priv->readahead.iobuf);
+
+                ret = __socket_sys_readv (this, sock, &iov, 1);
+                if (ret <= 0)
+                        return ret;
+
+                priv->readahead.offset = 0;
+                priv->readahead.len = ret;
+        }
+
+        buf = iobuf_ptr (priv->readahead.iobuf) + priv->readahead.offset;
+
+        for (i = 0; i < count && priv->readahead.len; i++) {
+                len = min (vector[i].iov_len, priv->readahead.len);
+
+                memcpy (vector[i].iov_base, buf, len);
+
+                buf += len;
+                copied += len;
+                priv->readahead.offset += len;
+                priv->readahead.len -= len;
+        }
+
+        return copied;
+}
+
+
 int
 __socket_rwv (rpc_transport_t *this, struct iovec *vector, int count,
               struct iovec **pending_vector, int *pending_count, size_t *bytes,
@@ -161,7 +559,13 @@ __socket_rwv (rpc_transport_t *this, struct iovec *vector, int count,
 
         while (opcount) {
                 if (write) {
-                        ret = writev (sock, opvector, opcount);
+#ifdef HAVE_LIBSSL
+                        if (priv->ssl_ssl && !priv->ssl_ktls_send)
+                                ret = __socket_ssl_rwv (this, opvector,
+                                                        opcount, 1);
+                        else
+#endif
+                                ret = writev (sock, opvector, opcount);
 
                         if (ret == 0 || (ret == -1 && errno == EAGAIN)) {
                                 /* done for now */
@@ -169,7 +573,8 @@ __socket_rwv (rpc_transport_t *this, struct iovec *vector, int count,
                         }
                         this->total_bytes_write += ret;
                 } else {
-                        ret = readv (sock, opvector, opcount);
+                        ret = __socket_readahead_readv (this, sock, opvector,
+                                                        opcount);
                         if (ret == -1 && errno == EAGAIN) {
                                 /* done for now */
                                 break;
@@ -446,6 +851,31 @@ __socket_connect_finish (int fd)
 }
 
 
+/* ask for MSG_ZEROCOPY on @fd, clears priv->zerocopy if it is refused */
+static void
+__socket_zerocopy_enable (rpc_transport_t *this, socket_private_t *priv,
+                          int fd)
+{
+#ifdef SOCKET_ZEROCOPY
+        int on = 1;
+
+        if (!priv->zerocopy)
+                return;
+
+        priv->zc_seq = 0;
+        priv->zc_copied = 0;
+
+        if (setsockopt (fd, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof (on)) == 0)
+                return;
+
+        gf_log (this->name, GF_LOG_INFO,
+                "zero-copy sends not available on %d (%s)", fd,
+                strerror (errno));
+#endif
+        priv->zerocopy = 0;
+}
+
+
 void
 __socket_reset (rpc_transport_t *this)
 {
@@ -473,8 +903,20 @@ __socket_reset (rpc_transport_t *this)
 
         memset (&priv->incoming, 0, sizeof (priv->incoming));
 
+        /* whatever was read ahead belongs to the old connection */
+        if (priv->readahead.iobuf) {
+                iobuf_unref (priv->readahead.iobuf);
+                priv->readahead.iobuf = NULL;
+        }
+        priv->readahead.offset = 0;
+        priv->readahead.len = 0;
+
         event_unregister (this->ctx->event_pool, priv->sock, priv->idx);
 
+#ifdef HAVE_LIBSSL
+        __socket_ssl_detach (priv);
+#endif
+
         close (priv->sock);
         priv->sock = -1;
         priv->idx = -1;
@@ -509,12 +951,15 @@ socket_set_last_frag_header_size (uint32_t size, char *haddr)
 struct ioq *
 __socket_ioq_new (rpc_transport_t *this, rpc_transport_msg_t *msg)
 {
+        socket_private_t *priv  = NULL;
         struct ioq       *entry = NULL;
         int               count = 0;
         uint32_t          size  = 0;
 
         GF_VALIDATE_OR_GOTO ("socket", this, out);
 
+        priv = this->private;
+
         /* TODO: use mem-pool */
         entry = GF_CALLOC (1, sizeof (*entry), gf_common_mt_ioq);
         if (!entry)
@@ -563,6 +1008,12 @@ __socket_ioq_new (rpc_transport_t *this, rpc_transport_msg_t *msg)
         entry->pending_vector = entry->vector;
         entry->pending_count  = entry->count;
 
+        /* small records are cheaper to copy than to pin */
+        if (priv->zerocopy && !priv->zc_copied &&
+            iov_length (msg->progpayload, msg->progpayloadcount) >=
+            SOCKET_ZEROCOPY_MIN_SIZE)
+                entry->zerocopy = 1;
+
         if (msg->iobref != NULL)
                 entry->iobref = iobref_ref (msg->iobref);
 
@@ -606,25 +1057,202 @@ __socket_ioq_flush (rpc_transport_t *this)
                 __socket_ioq_entry_free (entry);
         }
 
+        /* the socket goes away with them, nothing will complete anymore */
+        while (!list_empty (&priv->zc_pending)) {
+                entry = list_entry (priv->zc_pending.next, struct ioq, list);
+                __socket_ioq_entry_free (entry);
+        }
+
 out:
         return;
 }
 
 
+/* account @bytes written from the front of @entry, returns what is left
+   over for the entries behind it */
+static size_t
+__socket_ioq_entry_consume (struct ioq *entry, size_t bytes)
+{
+        while (entry->pending_count &&
+               (bytes || !entry->pending_vector[0].iov_len)) {
+                if (bytes >= entry->pending_vector[0].iov_len) {
+                        bytes -= entry->pending_vector[0].iov_len;
+                        entry->pending_vector++;
+                        entry->pending_count--;
+                } else {
+                        entry->pending_vector[0].iov_base += bytes;
+                        entry->pending_vector[0].iov_len -= bytes;
+                        bytes = 0;
+                }
+        }
+
+        return bytes;
+}
+
+
+static void
+__socket_ioq_entry_done (rpc_transport_t *this, struct ioq *entry)
+{
+        socket_private_t *priv = NULL;
+
+        priv = this->private;
+
+        if (entry->zc_done < entry->zc_calls) {
+                /* the kernel still references the pages of the entry */
+                list_del_init (&entry->list);
+                list_add_tail (&entry->list, &priv->zc_pending);
+                return;
+        }
+
+        __socket_ioq_entry_free (entry);
+}
+
+
+#ifdef SOCKET_ZEROCOPY
+static int
+__socket_zerocopy_writev (rpc_transport_t *this, struct ioq *entry)
+{
+        socket_private_t *priv = NULL;
+        struct msghdr     msg  = {0, };
+        ssize_t           ret  = 0;
+
+        priv = this->private;
+
+        while (entry->pending_count) {
+                msg.msg_iov = entry->pending_vector;
+                msg.msg_iovlen = entry->pending_count;
+
+                ret = sendmsg (priv->sock, &msg, MSG_ZEROCOPY);
+                if (ret == -1) {
+                        if (errno == EINTR)
+                                continue;
+                        if (errno == EAGAIN)
+                                break;
+                        if (errno == ENOBUFS) {
+                                /* out of option memory for completions,
+                                   the rest goes by copy */
+                                entry->zerocopy = 0;
+                                break;
+                        }
+
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "sendmsg failed (%s)", strerror (errno));
+                        return -1;
+                }
+
+                /* every successful call is one completion to wait for */
+                if (!entry->zc_calls)
+                        entry->zc_first = priv->zc_seq;
+                entry->zc_calls++;
+                priv->zc_seq++;
+
+                this->total_bytes_write += ret;
+                __socket_ioq_entry_consume (entry, ret);
+        }
+
+        return entry->pending_count;
+}
+
+
+static void
+__socket_zerocopy_account (struct ioq *entry, uint32_t lo, uint32_t hi)
+{
+        uint32_t i   = 0;
+        uint32_t seq = 0;
+
+        for (i = 0; i < entry->zc_calls; i++) {
+                seq = entry->zc_first + i;
+                if ((uint32_t)(seq - lo) <= (uint32_t)(hi - lo))
+                        entry->zc_done++;
+        }
+}
+
+
+/* reap the completions queued on the error queue, returns how many */
+static int
+__socket_zerocopy_complete (rpc_transport_t *this)
+{
+        socket_private_t         *priv  = NULL;
+        struct sock_extended_err *serr  = NULL;
+        struct cmsghdr           *cmsg  = NULL;
+        struct msghdr             msg   = {0, };
+        struct ioq               *entry = NULL;
+        struct ioq               *tmp   = NULL;
+        char                      control[CMSG_SPACE (sizeof (*serr) +
+                                          sizeof (struct sockaddr_in6))];
+        int                       count = 0;
+
+        priv = this->private;
+
+        for (;;) {
+                memset (&msg, 0, sizeof (msg));
+                msg.msg_control = control;
+                msg.msg_controllen = sizeof (control);
+
+                if (recvmsg (priv->sock, &msg, MSG_ERRQUEUE) == -1)
+                        break;
+
+                cmsg = CMSG_FIRSTHDR (&msg);
+                if (!cmsg)
+                        continue;
+
+                serr = (struct sock_extended_err *) CMSG_DATA (cmsg);
+                if (serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY ||
+                    serr->ee_errno != 0)
+                        continue;
+
+                count++;
+
+                if ((serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) &&
+                    !priv->zc_copied) {
+                        /* e.g. loopback: pinning only adds overhead */
+                        gf_log (this->name, GF_LOG_DEBUG,
+                                "zero-copy sends were copied, not using "
+                                "them anymore");
+                        priv->zc_copied = 1;
+                }
+
+                /* a partially sent entry can have completions already */
+                if (!list_empty (&priv->ioq) && priv->ioq_next->zc_calls)
+                        __socket_zerocopy_account (priv->ioq_next,
+                                                   serr->ee_info,
+                                                   serr->ee_data);
+
+                list_for_each_entry_safe (entry, tmp, &priv->zc_pending,
+                                          list) {
+                        __socket_zerocopy_account (entry, serr->ee_info,
+                                                   serr->ee_data);
+                        if (entry->zc_done >= entry->zc_calls)
+                                __socket_ioq_entry_free (entry);
+                }
+        }
+
+        return count;
+}
+#endif /* SOCKET_ZEROCOPY */
+
+
 int
 __socket_ioq_churn_entry (rpc_transport_t *this, struct ioq *entry)
 {
         int ret = -1;
 
-        ret = __socket_writev (this, entry->pending_vector,
-                               entry->pending_count,
-                               &entry->pending_vector,
-                               &entry->pending_count);
+#ifdef SOCKET_ZEROCOPY
+        if (entry->zerocopy)
+                ret = __socket_zerocopy_writev (this, entry);
+#else
+        entry->zerocopy = 0;
+#endif
+        if (!entry->zerocopy)
+                ret = __socket_writev (this, entry->pending_vector,
+                                       entry->pending_count,
+                                       &entry->pending_vector,
+                                       &entry->pending_count);
 
         if (ret == 0) {
                 /* current entry was completely written */
                 GF_ASSERT (entry->pending_count == 0);
-                __socket_ioq_entry_free (entry);
+                __socket_ioq_entry_done (this, entry);
         }
 
         return ret;
@@ -634,20 +1262,56 @@ __socket_ioq_churn_entry (rpc_transport_t *this, struct ioq *entry)
 int
 __socket_ioq_churn (rpc_transport_t *this)
 {
-        socket_private_t *priv = NULL;
-        int               ret = 0;
-        struct ioq       *entry = NULL;
+        socket_private_t *priv    = NULL;
+        int               ret     = 0;
+        struct ioq       *entry   = NULL;
+        struct ioq       *tmp     = NULL;
+        struct iovec     *vector  = NULL;
+        int               count   = 0;
+        int               entries = 0;
+        size_t            bytes   = 0;
 
         GF_VALIDATE_OR_GOTO ("socket", this, out);
         GF_VALIDATE_OR_GOTO ("socket", this->private, out);
 
         priv = this->private;
+        vector = priv->ioq_vector;
 
         while (!list_empty (&priv->ioq)) {
-                /* pick next entry */
-                entry = priv->ioq_next;
+                /* gather the records queued up behind each other into one
+                   writev, a zero-copy record goes out on its own */
+                count = 0;
+                entries = 0;
+                list_for_each_entry (entry, &priv->ioq, list) {
+                        if (entry->zerocopy ||
+                            (count + entry->pending_count) > SOCKET_IOV_MAX)
+                                break;
 
-                ret = __socket_ioq_churn_entry (this, entry);
+                        memcpy (&vector[count], entry->pending_vector,
+                                entry->pending_count * sizeof (*vector));
+                        count += entry->pending_count;
+                        entries++;
+                }
+
+                if (entries <= 1) {
+                        ret = __socket_ioq_churn_entry (this, priv->ioq_next);
+                        if (ret != 0)
+                                break;
+                        continue;
+                }
+
+                bytes = 0;
+                ret = __socket_rwv (this, vector, count, NULL, NULL,
+                                    &bytes, 1);
+
+                /* retire the records that went out completely, the first
+                   one which did not keeps its place at the head */
+                list_for_each_entry_safe (entry, tmp, &priv->ioq, list) {
+                        bytes = __socket_ioq_entry_consume (entry, bytes);
+                        if (entry->pending_count)
+                                break;
+                        __socket_ioq_entry_done (this, entry);
+                }
 
                 if (ret != 0)
                         break;
@@ -1700,7 +2364,8 @@ out:
 
 int
 socket_proto_state_machine (rpc_transport_t *this,
-                            rpc_transport_pollin_t **pollin)
+                            rpc_transport_pollin_t **pollin,
+                            gf_boolean_t *more)
 {
         socket_private_t *priv = NULL;
         int               ret = 0;
@@ -1713,6 +2378,12 @@ socket_proto_state_machine (rpc_transport_t *this,
         pthread_mutex_lock (&priv->lock);
         {
                 ret = __socket_proto_state_machine (this, pollin);
+
+                *more = (priv->readahead.len != 0);
+#ifdef HAVE_LIBSSL
+                if (priv->ssl_ssl && SSL_has_pending (priv->ssl_ssl))
+                        *more = _gf_true;
+#endif
         }
         pthread_mutex_unlock (&priv->lock);
 
@@ -1726,20 +2397,63 @@ socket_event_poll_in (rpc_transport_t *this)
 {
         int                     ret    = -1;
         rpc_transport_pollin_t *pollin = NULL;
+        gf_boolean_t            more   = _gf_false;
 
-        ret = socket_proto_state_machine (this, &pollin);
+        /* the poller is not going to report the records which are already
+           in the read-ahead buffer, so keep going until it is drained */
+        do {
+                pollin = NULL;
+                more = _gf_false;
 
-        if (pollin != NULL) {
-                ret = rpc_transport_notify (this, RPC_TRANSPORT_MSG_RECEIVED,
-                                            pollin);
+                ret = socket_proto_state_machine (this, &pollin, &more);
 
-                rpc_transport_pollin_destroy (pollin);
-        }
+                if (pollin != NULL) {
+                        ret = rpc_transport_notify (this,
+                                                    RPC_TRANSPORT_MSG_RECEIVED,
+                                                    pollin);
+
+                        rpc_transport_pollin_destroy (pollin);
+                }
+        } while (more && ret >= 0);
 
         return ret;
 }
 
 
+#ifdef HAVE_LIBSSL
+/* one more step of the handshake of a transport which is not connected yet,
+ * sets @event once it is done. An accepted transport only gets announced
+ * to the listener then, it has nothing to tell anyone before.
+ */
+static int
+__socket_ssl_connect_step (rpc_transport_t *this, socket_private_t *priv,
+                           rpc_transport_event_t *event)
+{
+        int ret = -1;
+
+        ret = __socket_ssl_handshake (this, priv);
+        if (ret != 0)
+                return ret;
+
+        priv->connected = 1;
+        priv->connect_finish_log = 0;
+
+        if (this->listener) {
+                this->mydata = this->listener->mydata;
+                this->notify = this->listener->notify;
+                *event = RPC_TRANSPORT_ACCEPT;
+        } else {
+                *event = RPC_TRANSPORT_CONNECT;
+                get_transport_identifiers (this);
+        }
+
+        return 0;
+}
+#endif
+
+
+/* 0 once connected (or given up on), 1 while the TLS handshake is still
+ * running and -1 if it failed */
 int
 socket_connect_finish (rpc_transport_t *this)
 {
@@ -1747,6 +2461,7 @@ socket_connect_finish (rpc_transport_t *this)
         socket_private_t     *priv       = NULL;
         rpc_transport_event_t event      = 0;
         char                  notify_rpc = 0;
+        int                   handshake  = 0;
 
         GF_VALIDATE_OR_GOTO ("socket", this, out);
         GF_VALIDATE_OR_GOTO ("socket", this->private, out);
@@ -1758,6 +2473,15 @@ socket_connect_finish (rpc_transport_t *this)
                 if (priv->connected)
                         goto unlock;
 
+#ifdef HAVE_LIBSSL
+                if (priv->ssl_handshake) {
+                        handshake = __socket_ssl_connect_step (this, priv,
+                                                               &event);
+                        notify_rpc = (handshake == 0);
+                        goto unlock;
+                }
+#endif
+
                 ret = __socket_connect_finish (priv->sock);
 
                 if (ret == -1 && errno == EINPROGRESS)
@@ -1795,6 +2519,20 @@ socket_connect_finish (rpc_transport_t *this)
                                 goto unlock;
                         }
 
+#ifdef HAVE_LIBSSL
+                        if (priv->use_ssl) {
+                                /* not connected before the handshake is
+                                   done, it goes on from the next wakeups */
+                                handshake = __socket_ssl_start (this, priv,
+                                                                _gf_false);
+                                if (handshake == 0)
+                                        handshake = __socket_ssl_connect_step
+                                                (this, priv, &event);
+                                notify_rpc = (handshake == 0);
+                                goto unlock;
+                        }
+#endif
+
                         priv->connected = 1;
                         priv->connect_finish_log = 0;
                         event = RPC_TRANSPORT_CONNECT;
@@ -1805,10 +2543,13 @@ unlock:
         pthread_mutex_unlock (&priv->lock);
 
         if (notify_rpc) {
-                rpc_transport_notify (this, event, this);
+                if (event == RPC_TRANSPORT_ACCEPT)
+                        rpc_transport_notify (this->listener, event, this);
+                else
+                        rpc_transport_notify (this, event, this);
         }
 out:
-        return 0;
+        return handshake;
 }
 
 
@@ -1833,11 +2574,26 @@ socket_event_handler (int fd, int idx, void *data,
         pthread_mutex_lock (&priv->lock);
         {
                 priv->idx = idx;
+
+#ifdef SOCKET_ZEROCOPY
+                /* completions of zero-copy sends raise POLLERR too.  Leave
+                   SO_ERROR alone (reading it clears it): a real error keeps
+                   POLLERR up and is caught on the next wakeup, which has
+                   no completions to reap */
+                if (poll_err && priv->zerocopy && priv->connected == 1 &&
+                    priv->sock != -1 && __socket_zerocopy_complete (this) > 0)
+                        poll_err = 0;
+#endif
         }
         pthread_mutex_unlock (&priv->lock);
 
         if (!priv->connected) {
                 ret = socket_connect_finish (this);
+
+                /* records may have come in along with the end of the TLS
+                   handshake, the poller is not going to report them */
+                if (ret == 0 && priv->use_ssl && priv->connected == 1)
+                        poll_in = 1;
         }
 
         if (!ret && poll_out) {
@@ -1964,25 +2720,54 @@ socket_server_event_handler (int fd, int idx, void *data,
                         new_trans->fini = this->fini;
                         new_trans->ctx  = ctx;
                         new_trans->xl   = this->xl;
-                        new_trans->mydata = this->mydata;
-                        new_trans->notify = this->notify;
                         new_trans->listener = this;
+                        /* a TLS connection has nothing to tell anyone before
+                           its handshake is done, socket_connect_finish()
+                           hooks it up then */
+                        if (!priv->use_ssl) {
+                                new_trans->mydata = this->mydata;
+                                new_trans->notify = this->notify;
+                        }
                         new_priv = new_trans->private;
 
                         pthread_mutex_lock (&new_priv->lock);
                         {
                                 new_priv->sock = new_sock;
                                 new_priv->connected = 1;
-                                rpc_transport_ref (new_trans);
 
-                                new_priv->idx =
-                                        event_register (ctx->event_pool,
-                                                        new_sock,
-                                                        socket_event_handler,
-                                                        new_trans, 1, 0);
+#ifdef HAVE_LIBSSL
+                                if (priv->use_ssl) {
+                                        /* the session cache lives in the
+                                           listener's context */
+                                        SSL_CTX_up_ref (priv->ssl_ctx);
+                                        new_priv->ssl_ctx = priv->ssl_ctx;
+                                        new_priv->use_ssl = _gf_true;
+                                        /* the handshake runs from
+                                           socket_event_handler() */
+                                        new_priv->connected = 0;
+                                        ret = __socket_ssl_start (new_trans,
+                                                                  new_priv,
+                                                                  _gf_true);
+                                }
+#endif
 
-                                if (new_priv->idx == -1)
-                                        ret = -1;
+                                /* accepted sockets follow the listener */
+                                new_priv->zerocopy = priv->zerocopy;
+                                __socket_zerocopy_enable (new_trans, new_priv,
+                                                          new_sock);
+
+                                if (ret == 0) {
+                                        rpc_transport_ref (new_trans);
+
+                                        new_priv->idx =
+                                                event_register
+                                                (ctx->event_pool, new_sock,
+                                                 socket_event_handler,
+                                                 new_trans, 1, 0);
+
+                                        if (new_priv->idx == -1)
+                                                ret = -1;
+                                }
                         }
                         pthread_mutex_unlock (&new_priv->lock);
                         if (ret == -1) {
@@ -1991,8 +2776,10 @@ socket_server_event_handler (int fd, int idx, void *data,
                                 goto unlock;
                         }
 
-                        ret = rpc_transport_notify (this, RPC_TRANSPORT_ACCEPT,
-                                                    new_trans);
+                        if (!priv->use_ssl)
+                                ret = rpc_transport_notify
+                                        (this, RPC_TRANSPORT_ACCEPT,
+                                         new_trans);
                 }
         }
 unlock:
@@ -2150,6 +2937,8 @@ socket_connect (rpc_transport_t *this, int port)
                                         strerror (errno));
                 }
 
+                __socket_zerocopy_enable (this, priv, priv->sock);
+
                 SA (&this->myinfo.sockaddr)->sa_family =
                         SA (&this->peerinfo.sockaddr)->sa_family;
 
@@ -2646,6 +3435,7 @@ socket_init (rpc_transport_t *this)
         priv->bio = 0;
         priv->windowsize = GF_DEFAULT_SOCKET_WINDOW_SIZE;
         INIT_LIST_HEAD (&priv->ioq);
+        INIT_LIST_HEAD (&priv->zc_pending);
 
         /* All the below section needs 'this->options' to be present */
         if (!this->options)
@@ -2753,6 +3543,78 @@ socket_init (rpc_transport_t *this)
                 }
         }
 
+        optstr = NULL;
+        if (dict_get_str (this->options, "transport.socket.zerocopy",
+                          &optstr) == 0) {
+                if (gf_string2boolean (optstr, &tmp_bool) == -1) {
+                        gf_log (this->name, GF_LOG_ERROR,
+                                "'transport.socket.zerocopy' takes only "
+                                "boolean options, not taking any action");
+                        tmp_bool = 0;
+                }
+#ifndef SOCKET_ZEROCOPY
+                if (tmp_bool)
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "zero-copy sends are not supported on this "
+                                "platform");
+                tmp_bool = 0;
+#endif
+                priv->zerocopy = tmp_bool;
+        }
+
+        optstr = NULL;
+        if (dict_get_str (this->options, "transport.socket.ssl-enabled",
+                          &optstr) == 0) {
+                if (gf_string2boolean (optstr, &tmp_bool) == -1) {
+                        gf_log (this->name, GF_LOG_ERROR,
+                                "'transport.socket.ssl-enabled' takes only "
+                                "boolean options");
+                        GF_FREE (priv);
+                        return -1;
+                }
+                priv->use_ssl = tmp_bool;
+        }
+
+#ifndef HAVE_LIBSSL
+        if (priv->use_ssl) {
+                gf_log (this->name, GF_LOG_ERROR,
+                        "SSL requested but glusterfs was built without it");
+                GF_FREE (priv);
+                return -1;
+        }
+#endif
+
+        optstr = NULL;
+        priv->ssl_ktls = _gf_true;
+        if (dict_get_str (this->options, "transport.socket.ssl-ktls",
+                          &optstr) == 0) {
+                if (gf_string2boolean (optstr, &tmp_bool) == -1) {
+                        gf_log (this->name, GF_LOG_ERROR,
+                                "'transport.socket.ssl-ktls' takes only "
+                                "boolean options, not taking any action");
+                        tmp_bool = _gf_true;
+                }
+                priv->ssl_ktls = tmp_bool;
+        }
+
+#ifdef HAVE_LIBSSL
+        if (priv->use_ssl) {
+                /* refuse to fall back to clear text */
+                priv->ssl_ctx = socket_ssl_ctx_new (this, priv->ssl_ktls);
+                if (!priv->ssl_ctx) {
+                        GF_FREE (priv);
+                        return -1;
+                }
+
+                /* MSG_ZEROCOPY would bypass the TLS layer */
+                if (priv->zerocopy) {
+                        gf_log (this->name, GF_LOG_INFO,
+                                "zero-copy sends are not used with SSL");
+                        priv->zerocopy = 0;
+                }
+        }
+#endif
+
         optstr = NULL;
 out:
         this->private = priv;
@@ -2782,6 +3644,13 @@ fini (rpc_transport_t *this)
                 gf_log (this->name, GF_LOG_TRACE,
                         "transport %p destroyed", this);
 
+#ifdef HAVE_LIBSSL
+                if (priv->ssl_session)
+                        SSL_SESSION_free (priv->ssl_session);
+                if (priv->ssl_ctx)
+                        SSL_CTX_free (priv->ssl_ctx);
+#endif
+
                 pthread_mutex_destroy (&priv->lock);
                 GF_FREE (priv);
         }
@@ -2860,5 +3729,23 @@ struct volume_options options[] = {
         { .key   = {"transport.socket.read-fail-log"},
           .type  = GF_OPTION_TYPE_BOOL
         },
+        { .key   = {"transport.socket.zerocopy"},
+          .type  = GF_OPTION_TYPE_BOOL
+        },
+        { .key   = {"transport.socket.ssl-enabled"},
+          .type  = GF_OPTION_TYPE_BOOL
+        },
+        { .key   = {"transport.socket.ssl-own-cert"},
+          .type  = GF_OPTION_TYPE_PATH
+        },
+        { .key   = {"transport.socket.ssl-private-key"},
+          .type  = GF_OPTION_TYPE_PATH
+        },
+        { .key   = {"transport.socket.ssl-ca-list"},
+          .type  = GF_OPTION_TYPE_PATH
+        },
+        { .key   = {"transport.socket.ssl-ktls"},
+          .type  = GF_OPTION_TYPE_BOOL
+        },
         { .key = {NULL} }
 };
@@ -24,10 +24,50 @@
 #include "mem-pool.h"
 #include "globals.h"
 
+#include <limits.h>
+#include <sys/socket.h>
+#ifdef HAVE_LIBSSL
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+
+#if OPENSSL_VERSION_NUMBER < 0x30000000L
+#define SSL_get1_peer_certificate SSL_get_peer_certificate
+#endif
+#endif /* HAVE_LIBSSL */
+#ifdef GF_LINUX_HOST_OS
+#include <linux/errqueue.h>
+#endif
+
 #ifndef MAX_IOVEC
 #define MAX_IOVEC 16
 #endif /* MAX_IOVEC */
 
+/* most iovecs handed to one writev() when draining the ioq */
+#ifdef IOV_MAX
+#define SOCKET_IOV_MAX IOV_MAX
+#else
+#define SOCKET_IOV_MAX 1024
+#endif
+
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) && \
+        defined(SO_EE_ORIGIN_ZEROCOPY)
+#define SOCKET_ZEROCOPY 1
+#endif
+
+/* payloads below this are cheaper to copy than to pin and track */
+#define SOCKET_ZEROCOPY_MIN_SIZE (32 * 1024)
+
+/* reads shorter than this are served from one recv into the per-connection
+   read-ahead buffer, longer ones (payloads) go straight to their buffer */
+#define SOCKET_READAHEAD_SIZE (64 * 1024)
+
+#define SSL_OWN_CERT_DEFAULT    "/etc/ssl/glusterfs.pem"
+#define SSL_PRIVATE_KEY_DEFAULT "/etc/ssl/glusterfs.key"
+#define SSL_CA_LIST_DEFAULT     "/etc/ssl/glusterfs.ca"
+
+/* small iovecs are gathered up to one TLS record before SSL_write */
+#define SOCKET_SSL_GATHER_SIZE (16 * 1024)
+
 #define GF_DEFAULT_SOCKET_LISTEN_PORT  GF_DEFAULT_BASE_PORT
 
 #define RPC_MAX_FRAGMENT_SIZE 0x7fffffff
@@ -104,6 +144,13 @@ struct ioq {
         struct iovec      *pending_vector;
         int                pending_count;
         struct iobref     *iobref;
+
+        /* MSG_ZEROCOPY sends of this entry, numbered zc_first onwards; the
+           entry (and so its iobref) lives until all of them completed */
+        char               zerocopy;
+        uint32_t           zc_first;
+        uint32_t           zc_calls;
+        uint32_t           zc_done;
 };
 
 typedef struct {
@@ -155,6 +202,8 @@ typedef struct {
                         struct ioq        *ioq_prev;
                 };
         };
+        /* scratch for gathering the ioq into one writev, under lock */
+        struct iovec           ioq_vector[SOCKET_IOV_MAX];
         struct {
                 sp_rpcrecord_state_t  record_state;
                 struct {
@@ -186,6 +235,11 @@ typedef struct {
                 msg_type_t           msg_type;
                 size_t               total_bytes_read;
         } incoming;
+        struct {
+                struct iobuf        *iobuf;
+                size_t               offset;   /* first byte not consumed */
+                size_t               len;      /* bytes buffered at offset */
+        } readahead;
         pthread_mutex_t        lock;
         int                    windowsize;
         char                   lowlat;
@@ -195,6 +249,19 @@ typedef struct {
         int                    keepaliveintvl;
         uint32_t               backlog;
         gf_boolean_t           read_fail_log;
+        char                   zerocopy;      /* SO_ZEROCOPY is set */
+        char                   zc_copied;     /* kernel fell back to copy */
+        uint32_t               zc_seq;        /* next MSG_ZEROCOPY send */
+        struct list_head       zc_pending;    /* sent, not yet completed */
+        gf_boolean_t           use_ssl;
+        gf_boolean_t           ssl_ktls;      /* offload to kernel TLS */
+        char                   ssl_ktls_send; /* kernel encrypts writes */
+        char                   ssl_handshake; /* not done with it yet */
+#ifdef HAVE_LIBSSL
+        SSL_CTX               *ssl_ctx;       /* shared with accepted ones */
+        SSL                   *ssl_ssl;
+        SSL_SESSION           *ssl_session;   /* resumed on reconnect */
+#endif
 } socket_private_t;
 
 
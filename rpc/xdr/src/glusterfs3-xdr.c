@@ -1541,6 +1541,158 @@ xdr_gfs3_fsetattr_rsp (XDR *xdrs, gfs3_fsetattr_rsp *objp)
 	return TRUE;
 }
 
+bool_t
+xdr_gfs3_fallocate_req (XDR *xdrs, gfs3_fallocate_req *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_opaque (xdrs, objp->gfid, 16))
+		 return FALSE;
+	 if (!xdr_quad_t (xdrs, &objp->fd))
+		 return FALSE;
+	 if (!xdr_u_int (xdrs, &objp->flags))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->offset))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->size))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->xdata.xdata_val, (u_int *) &objp->xdata.xdata_len, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_gfs3_fallocate_rsp (XDR *xdrs, gfs3_fallocate_rsp *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_int (xdrs, &objp->op_ret))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->op_errno))
+		 return FALSE;
+	 if (!xdr_gf_iatt (xdrs, &objp->statpre))
+		 return FALSE;
+	 if (!xdr_gf_iatt (xdrs, &objp->statpost))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->xdata.xdata_val, (u_int *) &objp->xdata.xdata_len, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_gfs3_discard_req (XDR *xdrs, gfs3_discard_req *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_opaque (xdrs, objp->gfid, 16))
+		 return FALSE;
+	 if (!xdr_quad_t (xdrs, &objp->fd))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->offset))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->size))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->xdata.xdata_val, (u_int *) &objp->xdata.xdata_len, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_gfs3_discard_rsp (XDR *xdrs, gfs3_discard_rsp *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_int (xdrs, &objp->op_ret))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->op_errno))
+		 return FALSE;
+	 if (!xdr_gf_iatt (xdrs, &objp->statpre))
+		 return FALSE;
+	 if (!xdr_gf_iatt (xdrs, &objp->statpost))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->xdata.xdata_val, (u_int *) &objp->xdata.xdata_len, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_gfs3_zerofill_req (XDR *xdrs, gfs3_zerofill_req *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_opaque (xdrs, objp->gfid, 16))
+		 return FALSE;
+	 if (!xdr_quad_t (xdrs, &objp->fd))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->offset))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->size))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->xdata.xdata_val, (u_int *) &objp->xdata.xdata_len, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_gfs3_zerofill_rsp (XDR *xdrs, gfs3_zerofill_rsp *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_int (xdrs, &objp->op_ret))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->op_errno))
+		 return FALSE;
+	 if (!xdr_gf_iatt (xdrs, &objp->statpre))
+		 return FALSE;
+	 if (!xdr_gf_iatt (xdrs, &objp->statpost))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->xdata.xdata_val, (u_int *) &objp->xdata.xdata_len, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_gfs3_seek_req (XDR *xdrs, gfs3_seek_req *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_opaque (xdrs, objp->gfid, 16))
+		 return FALSE;
+	 if (!xdr_quad_t (xdrs, &objp->fd))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->offset))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->what))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->xdata.xdata_val, (u_int *) &objp->xdata.xdata_len, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_gfs3_seek_rsp (XDR *xdrs, gfs3_seek_rsp *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_int (xdrs, &objp->op_ret))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->op_errno))
+		 return FALSE;
+	 if (!xdr_u_quad_t (xdrs, &objp->offset))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->xdata.xdata_val, (u_int *) &objp->xdata.xdata_len, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
 bool_t
 xdr_gfs3_rchecksum_req (XDR *xdrs, gfs3_rchecksum_req *objp)
 {
@@ -1920,3 +2072,150 @@ xdr_gf_event_notify_rsp (XDR *xdrs, gf_event_notify_rsp *objp)
 		 return FALSE;
 	return TRUE;
 }
+
+bool_t
+xdr_gfs3_compound_fop (XDR *xdrs, gfs3_compound_fop *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_enum (xdrs, (enum_t *) objp))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_gfs3_compound_req_u (XDR *xdrs, gfs3_compound_req_u *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_gfs3_compound_fop (xdrs, &objp->fop))
+		 return FALSE;
+	switch (objp->fop) {
+	case GFS3_COMPOUND_INODELK:
+		 if (!xdr_gfs3_inodelk_req (xdrs, &objp->gfs3_compound_req_u_u.inodelk_req))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_FINODELK:
+		 if (!xdr_gfs3_finodelk_req (xdrs, &objp->gfs3_compound_req_u_u.finodelk_req))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_ENTRYLK:
+		 if (!xdr_gfs3_entrylk_req (xdrs, &objp->gfs3_compound_req_u_u.entrylk_req))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_FENTRYLK:
+		 if (!xdr_gfs3_fentrylk_req (xdrs, &objp->gfs3_compound_req_u_u.fentrylk_req))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_XATTROP:
+		 if (!xdr_gfs3_xattrop_req (xdrs, &objp->gfs3_compound_req_u_u.xattrop_req))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_FXATTROP:
+		 if (!xdr_gfs3_fxattrop_req (xdrs, &objp->gfs3_compound_req_u_u.fxattrop_req))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_SETXATTR:
+		 if (!xdr_gfs3_setxattr_req (xdrs, &objp->gfs3_compound_req_u_u.setxattr_req))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_FSETXATTR:
+		 if (!xdr_gfs3_fsetxattr_req (xdrs, &objp->gfs3_compound_req_u_u.fsetxattr_req))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_WRITE:
+		 if (!xdr_gfs3_write_req (xdrs, &objp->gfs3_compound_req_u_u.write_req))
+			 return FALSE;
+		break;
+	default:
+		return FALSE;
+	}
+	return TRUE;
+}
+
+bool_t
+xdr_gfs3_compound_req (XDR *xdrs, gfs3_compound_req *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_u_int (xdrs, &objp->flags))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->fops.fops_val, (u_int *) &objp->fops.fops_len, GF_COMPOUND_MAX_FOPS,
+		sizeof (gfs3_compound_req_u), (xdrproc_t) xdr_gfs3_compound_req_u))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->xdata.xdata_val, (u_int *) &objp->xdata.xdata_len, ~0))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_gfs3_compound_rsp_u (XDR *xdrs, gfs3_compound_rsp_u *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_gfs3_compound_fop (xdrs, &objp->fop))
+		 return FALSE;
+	switch (objp->fop) {
+	case GFS3_COMPOUND_INODELK:
+		 if (!xdr_gf_common_rsp (xdrs, &objp->gfs3_compound_rsp_u_u.inodelk_rsp))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_FINODELK:
+		 if (!xdr_gf_common_rsp (xdrs, &objp->gfs3_compound_rsp_u_u.finodelk_rsp))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_ENTRYLK:
+		 if (!xdr_gf_common_rsp (xdrs, &objp->gfs3_compound_rsp_u_u.entrylk_rsp))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_FENTRYLK:
+		 if (!xdr_gf_common_rsp (xdrs, &objp->gfs3_compound_rsp_u_u.fentrylk_rsp))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_XATTROP:
+		 if (!xdr_gfs3_xattrop_rsp (xdrs, &objp->gfs3_compound_rsp_u_u.xattrop_rsp))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_FXATTROP:
+		 if (!xdr_gfs3_fxattrop_rsp (xdrs, &objp->gfs3_compound_rsp_u_u.fxattrop_rsp))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_SETXATTR:
+		 if (!xdr_gf_common_rsp (xdrs, &objp->gfs3_compound_rsp_u_u.setxattr_rsp))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_FSETXATTR:
+		 if (!xdr_gf_common_rsp (xdrs, &objp->gfs3_compound_rsp_u_u.fsetxattr_rsp))
+			 return FALSE;
+		break;
+	case GFS3_COMPOUND_WRITE:
+		 if (!xdr_gfs3_write_rsp (xdrs, &objp->gfs3_compound_rsp_u_u.write_rsp))
+			 return FALSE;
+		break;
+	default:
+		return FALSE;
+	}
+	return TRUE;
+}
+
+bool_t
+xdr_gfs3_compound_rsp (XDR *xdrs, gfs3_compound_rsp *objp)
+{
+	register int32_t *buf;
+        buf = NULL;
+
+	 if (!xdr_int (xdrs, &objp->op_ret))
+		 return FALSE;
+	 if (!xdr_int (xdrs, &objp->op_errno))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->fops.fops_val, (u_int *) &objp->fops.fops_len, GF_COMPOUND_MAX_FOPS,
+		sizeof (gfs3_compound_rsp_u), (xdrproc_t) xdr_gfs3_compound_rsp_u))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->xdata.xdata_val, (u_int *) &objp->xdata.xdata_len, ~0))
+		 return FALSE;
+	return TRUE;
+}
@@ -914,6 +914,102 @@ struct gfs3_fsetattr_rsp {
 };
 typedef struct gfs3_fsetattr_rsp gfs3_fsetattr_rsp;
 
+struct gfs3_fallocate_req {
+	char gfid[16];
+	quad_t fd;
+	u_int flags;
+	u_quad_t offset;
+	u_quad_t size;
+	struct {
+		u_int xdata_len;
+		char *xdata_val;
+	} xdata;
+};
+typedef struct gfs3_fallocate_req gfs3_fallocate_req;
+
+struct gfs3_fallocate_rsp {
+	int op_ret;
+	int op_errno;
+	struct gf_iatt statpre;
+	struct gf_iatt statpost;
+	struct {
+		u_int xdata_len;
+		char *xdata_val;
+	} xdata;
+};
+typedef struct gfs3_fallocate_rsp gfs3_fallocate_rsp;
+
+struct gfs3_discard_req {
+	char gfid[16];
+	quad_t fd;
+	u_quad_t offset;
+	u_quad_t size;
+	struct {
+		u_int xdata_len;
+		char *xdata_val;
+	} xdata;
+};
+typedef struct gfs3_discard_req gfs3_discard_req;
+
+struct gfs3_discard_rsp {
+	int op_ret;
+	int op_errno;
+	struct gf_iatt statpre;
+	struct gf_iatt statpost;
+	struct {
+		u_int xdata_len;
+		char *xdata_val;
+	} xdata;
+};
+typedef struct gfs3_discard_rsp gfs3_discard_rsp;
+
+struct gfs3_zerofill_req {
+	char gfid[16];
+	quad_t fd;
+	u_quad_t offset;
+	u_quad_t size;
+	struct {
+		u_int xdata_len;
+		char *xdata_val;
+	} xdata;
+};
+typedef struct gfs3_zerofill_req gfs3_zerofill_req;
+
+struct gfs3_zerofill_rsp {
+	int op_ret;
+	int op_errno;
+	struct gf_iatt statpre;
+	struct gf_iatt statpost;
+	struct {
+		u_int xdata_len;
+		char *xdata_val;
+	} xdata;
+};
+typedef struct gfs3_zerofill_rsp gfs3_zerofill_rsp;
+
+struct gfs3_seek_req {
+	char gfid[16];
+	quad_t fd;
+	u_quad_t offset;
+	int what;
+	struct {
+		u_int xdata_len;
+		char *xdata_val;
+	} xdata;
+};
+typedef struct gfs3_seek_req gfs3_seek_req;
+
+struct gfs3_seek_rsp {
+	int op_ret;
+	int op_errno;
+	u_quad_t offset;
+	struct {
+		u_int xdata_len;
+		char *xdata_val;
+	} xdata;
+};
+typedef struct gfs3_seek_rsp gfs3_seek_rsp;
+
 struct gfs3_rchecksum_req {
 	quad_t fd;
 	u_quad_t offset;
@@ -1100,6 +1196,80 @@ struct gf_event_notify_rsp {
 };
 typedef struct gf_event_notify_rsp gf_event_notify_rsp;
 
+#define GF_COMPOUND_MAX_FOPS 16
+
+enum gfs3_compound_fop {
+	GFS3_COMPOUND_INODELK = 1,
+	GFS3_COMPOUND_FINODELK = 2,
+	GFS3_COMPOUND_ENTRYLK = 3,
+	GFS3_COMPOUND_FENTRYLK = 4,
+	GFS3_COMPOUND_XATTROP = 5,
+	GFS3_COMPOUND_FXATTROP = 6,
+	GFS3_COMPOUND_SETXATTR = 7,
+	GFS3_COMPOUND_FSETXATTR = 8,
+	GFS3_COMPOUND_WRITE = 9,
+};
+typedef enum gfs3_compound_fop gfs3_compound_fop;
+
+struct gfs3_compound_req_u {
+	gfs3_compound_fop fop;
+	union {
+		gfs3_inodelk_req inodelk_req;
+		gfs3_finodelk_req finodelk_req;
+		gfs3_entrylk_req entrylk_req;
+		gfs3_fentrylk_req fentrylk_req;
+		gfs3_xattrop_req xattrop_req;
+		gfs3_fxattrop_req fxattrop_req;
+		gfs3_setxattr_req setxattr_req;
+		gfs3_fsetxattr_req fsetxattr_req;
+		gfs3_write_req write_req;
+	} gfs3_compound_req_u_u;
+};
+typedef struct gfs3_compound_req_u gfs3_compound_req_u;
+
+struct gfs3_compound_req {
+	u_int flags;
+	struct {
+		u_int fops_len;
+		gfs3_compound_req_u *fops_val;
+	} fops;
+	struct {
+		u_int xdata_len;
+		char *xdata_val;
+	} xdata;
+};
+typedef struct gfs3_compound_req gfs3_compound_req;
+
+struct gfs3_compound_rsp_u {
+	gfs3_compound_fop fop;
+	union {
+		gf_common_rsp inodelk_rsp;
+		gf_common_rsp finodelk_rsp;
+		gf_common_rsp entrylk_rsp;
+		gf_common_rsp fentrylk_rsp;
+		gfs3_xattrop_rsp xattrop_rsp;
+		gfs3_fxattrop_rsp fxattrop_rsp;
+		gf_common_rsp setxattr_rsp;
+		gf_common_rsp fsetxattr_rsp;
+		gfs3_write_rsp write_rsp;
+	} gfs3_compound_rsp_u_u;
+};
+typedef struct gfs3_compound_rsp_u gfs3_compound_rsp_u;
+
+struct gfs3_compound_rsp {
+	int op_ret;
+	int op_errno;
+	struct {
+		u_int fops_len;
+		gfs3_compound_rsp_u *fops_val;
+	} fops;
+	struct {
+		u_int xdata_len;
+		char *xdata_val;
+	} xdata;
+};
+typedef struct gfs3_compound_rsp gfs3_compound_rsp;
+
 /* the xdr functions */
 
 #if defined(__STDC__) || defined(__cplusplus)
@@ -1175,6 +1345,14 @@ extern  bool_t xdr_gfs3_setattr_req (XDR *, gfs3_setattr_req*);
 extern  bool_t xdr_gfs3_setattr_rsp (XDR *, gfs3_setattr_rsp*);
 extern  bool_t xdr_gfs3_fsetattr_req (XDR *, gfs3_fsetattr_req*);
 extern  bool_t xdr_gfs3_fsetattr_rsp (XDR *, gfs3_fsetattr_rsp*);
+extern  bool_t xdr_gfs3_fallocate_req (XDR *, gfs3_fallocate_req*);
+extern  bool_t xdr_gfs3_fallocate_rsp (XDR *, gfs3_fallocate_rsp*);
+extern  bool_t xdr_gfs3_discard_req (XDR *, gfs3_discard_req*);
+extern  bool_t xdr_gfs3_discard_rsp (XDR *, gfs3_discard_rsp*);
+extern  bool_t xdr_gfs3_zerofill_req (XDR *, gfs3_zerofill_req*);
+extern  bool_t xdr_gfs3_zerofill_rsp (XDR *, gfs3_zerofill_rsp*);
+extern  bool_t xdr_gfs3_seek_req (XDR *, gfs3_seek_req*);
+extern  bool_t xdr_gfs3_seek_rsp (XDR *, gfs3_seek_rsp*);
 extern  bool_t xdr_gfs3_rchecksum_req (XDR *, gfs3_rchecksum_req*);
 extern  bool_t xdr_gfs3_rchecksum_rsp (XDR *, gfs3_rchecksum_rsp*);
 extern  bool_t xdr_gf_getspec_req (XDR *, gf_getspec_req*);
@@ -1194,6 +1372,11 @@ extern  bool_t xdr_gf_set_lk_ver_req (XDR *, gf_set_lk_ver_req*);
 extern  bool_t xdr_gf_event_notify_req (XDR *, gf_event_notify_req*);
 extern  bool_t xdr_gf_event_notify_rsp (XDR *, gf_event_notify_rsp*);
 
+extern  bool_t xdr_gfs3_compound_fop (XDR *, gfs3_compound_fop*);
+extern  bool_t xdr_gfs3_compound_req_u (XDR *, gfs3_compound_req_u*);
+extern  bool_t xdr_gfs3_compound_req (XDR *, gfs3_compound_req*);
+extern  bool_t xdr_gfs3_compound_rsp_u (XDR *, gfs3_compound_rsp_u*);
+extern  bool_t xdr_gfs3_compound_rsp (XDR *, gfs3_compound_rsp*);
 #else /* K&R C */
 extern bool_t xdr_gf_statfs ();
 extern bool_t xdr_gf_proto_flock ();
@@ -1267,6 +1450,14 @@ extern bool_t xdr_gfs3_setattr_req ();
 extern bool_t xdr_gfs3_setattr_rsp ();
 extern bool_t xdr_gfs3_fsetattr_req ();
 extern bool_t xdr_gfs3_fsetattr_rsp ();
+extern bool_t xdr_gfs3_fallocate_req ();
+extern bool_t xdr_gfs3_fallocate_rsp ();
+extern bool_t xdr_gfs3_discard_req ();
+extern bool_t xdr_gfs3_discard_rsp ();
+extern bool_t xdr_gfs3_zerofill_req ();
+extern bool_t xdr_gfs3_zerofill_rsp ();
+extern bool_t xdr_gfs3_seek_req ();
+extern bool_t xdr_gfs3_seek_rsp ();
 extern bool_t xdr_gfs3_rchecksum_req ();
 extern bool_t xdr_gfs3_rchecksum_rsp ();
 extern bool_t xdr_gf_getspec_req ();
@@ -1286,6 +1477,11 @@ extern bool_t xdr_gf_set_lk_ver_req ();
 extern bool_t xdr_gf_event_notify_req ();
 extern bool_t xdr_gf_event_notify_rsp ();
 
+extern bool_t xdr_gfs3_compound_fop ();
+extern bool_t xdr_gfs3_compound_req_u ();
+extern bool_t xdr_gfs3_compound_req ();
+extern bool_t xdr_gfs3_compound_rsp_u ();
+extern bool_t xdr_gfs3_compound_rsp ();
 #endif /* K&R C */
 
 #ifdef __cplusplus
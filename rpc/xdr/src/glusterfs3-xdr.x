@@ -575,6 +575,66 @@ struct gfs3_fstat_req {
         opaque   xdata<>; /* Extra data */
 }  ;
 
+ struct gfs3_fallocate_req {
+        opaque gfid[16];
+        hyper        fd;
+        unsigned int flags;
+        unsigned hyper offset;
+        unsigned hyper size;
+        opaque   xdata<>; /* Extra data */
+}  ;
+ struct gfs3_fallocate_rsp {
+        int    op_ret;
+        int    op_errno;
+        struct gf_iatt statpre;
+        struct gf_iatt statpost;
+        opaque   xdata<>; /* Extra data */
+}  ;
+
+ struct gfs3_discard_req {
+        opaque gfid[16];
+        hyper        fd;
+        unsigned hyper offset;
+        unsigned hyper size;
+        opaque   xdata<>; /* Extra data */
+}  ;
+ struct gfs3_discard_rsp {
+        int    op_ret;
+        int    op_errno;
+        struct gf_iatt statpre;
+        struct gf_iatt statpost;
+        opaque   xdata<>; /* Extra data */
+}  ;
+
+ struct gfs3_zerofill_req {
+        opaque gfid[16];
+        hyper        fd;
+        unsigned hyper offset;
+        unsigned hyper size;
+        opaque   xdata<>; /* Extra data */
+}  ;
+ struct gfs3_zerofill_rsp {
+        int    op_ret;
+        int    op_errno;
+        struct gf_iatt statpre;
+        struct gf_iatt statpost;
+        opaque   xdata<>; /* Extra data */
+}  ;
+
+ struct gfs3_seek_req {
+        opaque gfid[16];
+        hyper        fd;
+        unsigned hyper offset;
+        int          what;
+        opaque   xdata<>; /* Extra data */
+}  ;
+ struct gfs3_seek_rsp {
+        int    op_ret;
+        int    op_errno;
+        unsigned hyper offset;
+        opaque   xdata<>; /* Extra data */
+}  ;
+
  struct gfs3_rchecksum_req {
         hyper   fd;
         unsigned hyper  offset;
@@ -694,3 +754,57 @@ struct gf_event_notify_rsp {
 	int op_errno;
 	opaque dict<>;
 };
+
+/* the fops a compound request can carry, see compound-fops.h */
+const GF_COMPOUND_MAX_FOPS = 16;
+
+enum gfs3_compound_fop {
+        GFS3_COMPOUND_INODELK   = 1,
+        GFS3_COMPOUND_FINODELK  = 2,
+        GFS3_COMPOUND_ENTRYLK   = 3,
+        GFS3_COMPOUND_FENTRYLK  = 4,
+        GFS3_COMPOUND_XATTROP   = 5,
+        GFS3_COMPOUND_FXATTROP  = 6,
+        GFS3_COMPOUND_SETXATTR  = 7,
+        GFS3_COMPOUND_FSETXATTR = 8,
+        GFS3_COMPOUND_WRITE     = 9
+};
+
+union gfs3_compound_req_u switch (gfs3_compound_fop fop) {
+        case GFS3_COMPOUND_INODELK:   gfs3_inodelk_req   inodelk_req;
+        case GFS3_COMPOUND_FINODELK:  gfs3_finodelk_req  finodelk_req;
+        case GFS3_COMPOUND_ENTRYLK:   gfs3_entrylk_req   entrylk_req;
+        case GFS3_COMPOUND_FENTRYLK:  gfs3_fentrylk_req  fentrylk_req;
+        case GFS3_COMPOUND_XATTROP:   gfs3_xattrop_req   xattrop_req;
+        case GFS3_COMPOUND_FXATTROP:  gfs3_fxattrop_req  fxattrop_req;
+        case GFS3_COMPOUND_SETXATTR:  gfs3_setxattr_req  setxattr_req;
+        case GFS3_COMPOUND_FSETXATTR: gfs3_fsetxattr_req fsetxattr_req;
+        case GFS3_COMPOUND_WRITE:     gfs3_write_req     write_req;
+};
+
+/* the data of the write members follows the record, in their order */
+struct gfs3_compound_req {
+        unsigned int        flags;
+        gfs3_compound_req_u fops<GF_COMPOUND_MAX_FOPS>;
+        opaque   xdata<>; /* Extra data */
+};
+
+union gfs3_compound_rsp_u switch (gfs3_compound_fop fop) {
+        case GFS3_COMPOUND_INODELK:   gf_common_rsp      inodelk_rsp;
+        case GFS3_COMPOUND_FINODELK:  gf_common_rsp      finodelk_rsp;
+        case GFS3_COMPOUND_ENTRYLK:   gf_common_rsp      entrylk_rsp;
+        case GFS3_COMPOUND_FENTRYLK:  gf_common_rsp      fentrylk_rsp;
+        case GFS3_COMPOUND_XATTROP:   gfs3_xattrop_rsp   xattrop_rsp;
+        case GFS3_COMPOUND_FXATTROP:  gfs3_fxattrop_rsp  fxattrop_rsp;
+        case GFS3_COMPOUND_SETXATTR:  gf_common_rsp      setxattr_rsp;
+        case GFS3_COMPOUND_FSETXATTR: gf_common_rsp      fsetxattr_rsp;
+        case GFS3_COMPOUND_WRITE:     gfs3_write_rsp     write_rsp;
+};
+
+/* one reply per fop that ran */
+struct gfs3_compound_rsp {
+        int                 op_ret;
+        int                 op_errno;
+        gfs3_compound_rsp_u fops<GF_COMPOUND_MAX_FOPS>;
+        opaque   xdata<>; /* Extra data */
+};
@@ -837,6 +837,7 @@ void
 afr_local_transaction_cleanup (afr_local_t *local, xlator_t *this)
 {
         afr_private_t * priv = NULL;
+        int             i    = 0;
 
         priv = this->private;
 
@@ -860,6 +861,15 @@ afr_local_transaction_cleanup (afr_local_t *local, xlator_t *this)
         GF_FREE (local->transaction.pre_op);
         GF_FREE (local->transaction.eager_lock);
 
+        if (local->transaction.compound_xattr) {
+                for (i = 0; i < priv->child_count; i++)
+                        if (local->transaction.compound_xattr[i])
+                                dict_unref (local->transaction.compound_xattr[i]);
+                GF_FREE (local->transaction.compound_xattr);
+        }
+
+        GF_FREE (local->transaction.compound_write);
+
         GF_FREE (local->transaction.basename);
         GF_FREE (local->transaction.new_basename);
 
@@ -23,6 +23,10 @@ int32_t
 afr_fstat (call_frame_t *frame, xlator_t *this,
 	   fd_t *fd, dict_t *xdata);
 
+int32_t
+afr_seek (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
+          gf_seek_what_t what, dict_t *xdata);
+
 int32_t
 afr_readlink (call_frame_t *frame, xlator_t *this,
 	      loc_t *loc, size_t size, dict_t *xdata);
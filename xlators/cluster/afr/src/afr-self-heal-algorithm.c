@@ -571,6 +571,160 @@ sh_loop_read (call_frame_t *loop_frame, xlator_t *this)
 }
 
 
+static int
+sh_loop_discard_cbk (call_frame_t *loop_frame, void *cookie, xlator_t *this,
+                     int32_t op_ret, int32_t op_errno, struct iatt *preop,
+                     struct iatt *postop, dict_t *xdata)
+{
+        afr_private_t *             priv        = NULL;
+        afr_local_t *               loop_local  = NULL;
+        afr_self_heal_t *           loop_sh     = NULL;
+        call_frame_t               *sh_frame    = NULL;
+        afr_local_t *               sh_local    = NULL;
+        afr_self_heal_t            *sh          = NULL;
+        int                         call_count  = 0;
+        int                         child_index = 0;
+
+        priv       = this->private;
+        loop_local = loop_frame->local;
+        loop_sh    = &loop_local->self_heal;
+
+        sh_frame = loop_sh->sh_frame;
+        sh_local = sh_frame->local;
+        sh       = &sh_local->self_heal;
+
+        child_index = (long) cookie;
+
+        if (op_ret == 0) {
+                loop_sh->write_needed[child_index] = 0;
+        } else if ((op_errno != EOPNOTSUPP) && (op_errno != ENOSYS)) {
+                gf_log (this->name, GF_LOG_ERROR,
+                        "discard on %s failed on subvolume %s (%s)",
+                        sh_local->loc.path,
+                        priv->children[child_index]->name,
+                        strerror (op_errno));
+
+                loop_sh->write_needed[child_index] = 0;
+                sh->op_failed = 1;
+                afr_sh_set_error (loop_sh, op_errno);
+        }
+        /* else: the sink cannot punch holes, leave write_needed set so
+           the block is read and written out the usual way */
+
+        call_count = afr_frame_return (loop_frame);
+
+        if (call_count == 0) {
+                if (!sh->op_failed &&
+                    sh_number_of_writes_needed (loop_sh->write_needed,
+                                                priv->child_count))
+                        sh_loop_read (loop_frame, this);
+                else
+                        sh_loop_return (sh_frame, this, loop_frame,
+                                        loop_sh->op_ret, loop_sh->op_errno);
+        }
+
+        return 0;
+}
+
+static int
+sh_loop_seek_cbk (call_frame_t *loop_frame, void *cookie, xlator_t *this,
+                  int32_t op_ret, int32_t op_errno, off_t offset,
+                  dict_t *xdata)
+{
+        afr_private_t *               priv       = NULL;
+        afr_local_t *                 loop_local = NULL;
+        afr_self_heal_t *             loop_sh    = NULL;
+        call_frame_t                 *sh_frame   = NULL;
+        afr_local_t *                 sh_local   = NULL;
+        afr_self_heal_t *             sh         = NULL;
+        int                           call_count = 0;
+        int                           i          = 0;
+
+        priv       = this->private;
+        loop_local = loop_frame->local;
+        loop_sh    = &loop_local->self_heal;
+
+        sh_frame = loop_sh->sh_frame;
+        sh_local = sh_frame->local;
+        sh       = &sh_local->self_heal;
+
+        /* Anything but a clear "no data in this block" (including a
+           source that cannot seek) goes through the normal read. ENXIO
+           past the end of the source is left to readv to report eof. */
+        if (op_ret == -1) {
+                if ((op_errno != ENXIO) ||
+                    (loop_sh->offset >= sh->buf[loop_sh->source].ia_size))
+                        goto read;
+        } else if (offset < (loop_sh->offset + loop_sh->block_size)) {
+                goto read;
+        }
+
+        gf_log (this->name, GF_LOG_TRACE,
+                "block at offset %"PRId64" of %s is a hole on the source",
+                loop_sh->offset, sh_local->loc.path);
+
+        sh_prune_writes_needed (sh_frame, loop_frame, priv);
+
+        call_count = sh_number_of_writes_needed (loop_sh->write_needed,
+                                                 priv->child_count);
+        if (call_count == 0) {
+                sh_loop_return (sh_frame, this, loop_frame, 0, 0);
+                goto out;
+        }
+        loop_local->call_count = call_count;
+
+        for (i = 0; i < priv->child_count; i++) {
+                if (!loop_sh->write_needed[i])
+                        continue;
+                STACK_WIND_COOKIE (loop_frame, sh_loop_discard_cbk,
+                                   (void *) (long) i,
+                                   priv->children[i],
+                                   priv->children[i]->fops->discard,
+                                   loop_sh->healing_fd, loop_sh->offset,
+                                   loop_sh->block_size, NULL);
+
+                if (!--call_count)
+                        break;
+        }
+        goto out;
+
+read:
+        sh_loop_read (loop_frame, this);
+out:
+        return 0;
+}
+
+/* Fill the block on the sinks that need it. For sparse files the source
+ * is asked first whether the block holds any data at all; an all-hole
+ * block is punched out on the sinks instead of being read and written.
+ * The answer is only trusted for the block held under the current lock,
+ * a stale hole would have the sinks throw away real data.
+ */
+static int
+sh_loop_fill (call_frame_t *loop_frame, xlator_t *this)
+{
+        afr_private_t           *priv       = NULL;
+        afr_local_t             *loop_local = NULL;
+        afr_self_heal_t         *loop_sh    = NULL;
+
+        priv       = this->private;
+        loop_local = loop_frame->local;
+        loop_sh    = &loop_local->self_heal;
+
+        if (!loop_sh->file_has_holes)
+                return sh_loop_read (loop_frame, this);
+
+        STACK_WIND_COOKIE (loop_frame, sh_loop_seek_cbk,
+                           (void *) (long) loop_sh->source,
+                           priv->children[loop_sh->source],
+                           priv->children[loop_sh->source]->fops->seek,
+                           loop_sh->healing_fd, loop_sh->offset,
+                           GF_SEEK_DATA, NULL);
+
+        return 0;
+}
+
+
 static int
 sh_diff_checksum_cbk (call_frame_t *loop_frame, void *cookie, xlator_t *this,
                       int32_t op_ret, int32_t op_errno,
@@ -646,7 +800,7 @@ sh_diff_checksum_cbk (call_frame_t *loop_frame, void *cookie, xlator_t *this,
                 UNLOCK (&sh_priv->lock);
 
                 if (write_needed && !sh->op_failed) {
-                        sh_loop_read (loop_frame, this);
+                        sh_loop_fill (loop_frame, this);
                 } else {
                         sh_loop_return (sh_frame, this, loop_frame,
                                         op_ret, op_errno);
@@ -715,7 +869,7 @@ sh_full_read_write_to_sinks (call_frame_t *loop_frame, xlator_t *this)
                         continue;
                 loop_sh->write_needed[i] = 1;
         }
-        sh_loop_read (loop_frame, this);
+        sh_loop_fill (loop_frame, this);
         return 0;
 }
 
@@ -522,6 +522,161 @@ afr_set_postop_dict (afr_local_t *local, xlator_t *this, dict_t *xattr,
                         "failed to set pending entry");
 }
 
+/* post-op and unlock in one round trip, see use-compound-fops */
+
+/* the unlock can go along with the post-op when the lock is the
+   transaction's own, an eager lock outlives it */
+static gf_boolean_t
+afr_changelog_post_op_can_unlock (call_frame_t *frame, xlator_t *this)
+{
+        afr_private_t       *priv     = NULL;
+        afr_local_t         *local    = NULL;
+        afr_internal_lock_t *int_lock = NULL;
+        int                  i        = 0;
+
+        priv     = this->private;
+        local    = frame->local;
+        int_lock = &local->internal_lock;
+
+        if (!priv->use_compound_fops)
+                return _gf_false;
+
+        if (int_lock->transaction_lk_type != AFR_TRANSACTION_LK)
+                return _gf_false;
+
+        if ((local->transaction.type != AFR_DATA_TRANSACTION) &&
+            (local->transaction.type != AFR_METADATA_TRANSACTION))
+                return _gf_false;
+
+        for (i = 0; i < priv->child_count; i++) {
+                if (local->transaction.eager_lock &&
+                    local->transaction.eager_lock[i])
+                        return _gf_false;
+        }
+
+        return _gf_true;
+}
+
+
+static int32_t
+afr_changelog_post_op_unlock_cbk (call_frame_t *frame, void *cookie,
+                                  xlator_t *this, int32_t op_ret,
+                                  int32_t op_errno, compound_rsp_t *rsp,
+                                  dict_t *xdata)
+{
+        afr_private_t *priv        = NULL;
+        afr_local_t   *local       = NULL;
+        dict_t        *xattr       = NULL;
+        int            child_index = (long) cookie;
+
+        priv  = this->private;
+        local = frame->local;
+
+        /* the brick does not take compound fops and nothing was sent:
+           the post-op goes alone, the lock is still held for afr_unlock */
+        if (!rsp && op_errno == ENOTSUP) {
+                gf_log (this->name, GF_LOG_DEBUG,
+                        "%s does not take compound fops, sending the "
+                        "post-op alone", priv->children[child_index]->name);
+
+                xattr = local->transaction.compound_xattr[child_index];
+                if (local->fd &&
+                    ((local->transaction.type != AFR_DATA_TRANSACTION) ||
+                     afr_fd_ctx_get (local->fd, this)))
+                        STACK_WIND_COOKIE (frame, afr_changelog_post_op_cbk,
+                                           cookie, priv->children[child_index],
+                                           priv->children[child_index]->fops->fxattrop,
+                                           local->fd, GF_XATTROP_ADD_ARRAY,
+                                           xattr, NULL);
+                else
+                        STACK_WIND_COOKIE (frame, afr_changelog_post_op_cbk,
+                                           cookie, priv->children[child_index],
+                                           priv->children[child_index]->fops->xattrop,
+                                           &local->loc, GF_XATTROP_ADD_ARRAY,
+                                           xattr, NULL);
+                return 0;
+        }
+
+        /* without a reply the brick may have run both: the post-op is not
+           sent again, which at worst leaves the pre-op's pending count for
+           self-heal, and afr_unlock still sends the unlock */
+        if (rsp) {
+                op_ret = rsp->rsps[0].op_ret;
+                op_errno = rsp->rsps[0].op_errno;
+                xattr = rsp->rsps[0].dict;
+
+                /* afr_unlock leaves it out */
+                if (rsp->rsps[1].op_ret == 0)
+                        local->internal_lock.inode_locked_nodes[child_index]
+                                &= LOCKED_NO;
+        }
+
+        return afr_changelog_post_op_cbk (frame, cookie, this, op_ret,
+                                          op_errno, xattr, xdata);
+}
+
+
+/* winds the post-op of @child (on @fd if any, else on the loc) followed
+   by the unlock afr_unlock would send it, returns -1 if it could not */
+static int
+afr_changelog_post_op_unlock (call_frame_t *frame, xlator_t *this, int child,
+                              fd_t *fd, dict_t *xattr)
+{
+        afr_private_t       *priv     = NULL;
+        afr_local_t         *local    = NULL;
+        afr_internal_lock_t *int_lock = NULL;
+        compound_args_t     *args     = NULL;
+        struct gf_flock      flock    = {0,};
+        int                  ret      = -1;
+
+        priv     = this->private;
+        local    = frame->local;
+        int_lock = &local->internal_lock;
+
+        if ((int_lock->inode_locked_nodes[child] & LOCKED_YES) != LOCKED_YES)
+                goto out;
+
+        /* the lock goes even if the post-op fails, as with afr_unlock */
+        args = compound_args_new (2, GF_COMPOUND_CONTINUE);
+        if (!args)
+                goto out;
+
+        if (fd)
+                ret = compound_args_fxattrop (args, fd, GF_XATTROP_ADD_ARRAY,
+                                              xattr, NULL);
+        else
+                ret = compound_args_xattrop (args, &local->loc,
+                                             GF_XATTROP_ADD_ARRAY, xattr,
+                                             NULL);
+        if (ret)
+                goto out;
+
+        flock.l_start = int_lock->lk_flock.l_start;
+        flock.l_len   = int_lock->lk_flock.l_len;
+        flock.l_type  = F_UNLCK;
+
+        if (local->fd)
+                ret = compound_args_finodelk (args, this->name, local->fd,
+                                              F_SETLK, &flock, NULL);
+        else
+                ret = compound_args_inodelk (args, this->name, &local->loc,
+                                             F_SETLK, &flock, NULL);
+        if (ret)
+                goto out;
+
+        if (local->transaction.compound_xattr[child])
+                dict_unref (local->transaction.compound_xattr[child]);
+        local->transaction.compound_xattr[child] = dict_ref (xattr);
+
+        STACK_WIND_COOKIE (frame, afr_changelog_post_op_unlock_cbk,
+                           (void *) (long) child, priv->children[child],
+                           priv->children[child]->fops->compound, args, NULL);
+out:
+        compound_args_destroy (args);
+        return ret;
+}
+
+
 int
 afr_changelog_post_op (call_frame_t *frame, xlator_t *this)
 {
@@ -536,6 +691,7 @@ afr_changelog_post_op (call_frame_t *frame, xlator_t *this)
         int            piggyback = 0;
         int            index = 0;
         int            nothing_failed = 1;
+        gf_boolean_t   unlock = _gf_false;
 
         local    = frame->local;
         int_lock = &local->internal_lock;
@@ -581,6 +737,17 @@ afr_changelog_post_op (call_frame_t *frame, xlator_t *this)
 
         afr_compute_txn_changelog (local , priv);
 
+        unlock = afr_changelog_post_op_can_unlock (frame, this);
+        if (unlock && !local->transaction.compound_xattr) {
+                local->transaction.compound_xattr =
+                        GF_CALLOC (priv->child_count, sizeof (dict_t *),
+                                   gf_afr_mt_dict_t);
+                if (!local->transaction.compound_xattr)
+                        unlock = _gf_false;
+        }
+        if (unlock)
+                afr_set_lk_owner (frame, this, frame->root);
+
         for (i = 0; i < priv->child_count; i++) {
                 if (!local->transaction.pre_op[i])
                         continue;
@@ -594,6 +761,11 @@ afr_changelog_post_op (call_frame_t *frame, xlator_t *this)
                         if (!fdctx) {
                                 afr_set_postop_dict (local, this, xattr[i],
                                                      0, i);
+                                if (unlock &&
+                                    !afr_changelog_post_op_unlock (frame, this,
+                                                                   i, NULL,
+                                                                   xattr[i]))
+                                        break;
                                 STACK_WIND (frame, afr_changelog_post_op_cbk,
                                             priv->children[i],
                                             priv->children[i]->fops->xattrop,
@@ -621,6 +793,11 @@ afr_changelog_post_op (call_frame_t *frame, xlator_t *this)
                                                            this, 1, 0, xattr[i], NULL);
                         } else {
                                 __mark_pre_op_undone_on_fd (frame, this, i);
+                                if (unlock &&
+                                    !afr_changelog_post_op_unlock (frame, this,
+                                                                   i, local->fd,
+                                                                   xattr[i]))
+                                        break;
                                 STACK_WIND_COOKIE (frame,
                                                    afr_changelog_post_op_cbk,
                                                    (void *) (long) i,
@@ -641,6 +818,12 @@ afr_changelog_post_op (call_frame_t *frame, xlator_t *this)
                                 break;
                         }
 
+                        if (unlock &&
+                            !afr_changelog_post_op_unlock (frame, this, i,
+                                                           local->fd,
+                                                           xattr[i]))
+                                break;
+
                         if (local->fd)
                                 STACK_WIND (frame, afr_changelog_post_op_cbk,
                                             priv->children[i],
@@ -789,6 +972,148 @@ afr_changelog_pre_op_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
         return 0;
 }
 
+/* pre-op and write in one round trip, see use-compound-fops */
+
+/* the write of a writev transaction can go along with its pre-op: the
+   lock is already held and the brick only runs the write once the pre-op
+   made it, which is the order the fop phase would keep */
+static gf_boolean_t
+afr_changelog_pre_op_can_write (call_frame_t *frame, xlator_t *this)
+{
+        afr_private_t *priv  = NULL;
+        afr_local_t   *local = NULL;
+
+        priv  = this->private;
+        local = frame->local;
+
+        if (!priv->use_compound_fops)
+                return _gf_false;
+
+        if ((local->transaction.type != AFR_DATA_TRANSACTION) ||
+            (local->op != GF_FOP_WRITE) || !local->fd)
+                return _gf_false;
+
+        if (!local->transaction.compound_xattr) {
+                local->transaction.compound_xattr =
+                        GF_CALLOC (priv->child_count, sizeof (dict_t *),
+                                   gf_afr_mt_dict_t);
+                if (!local->transaction.compound_xattr)
+                        return _gf_false;
+        }
+
+        if (!local->transaction.compound_write) {
+                local->transaction.compound_write =
+                        GF_CALLOC (priv->child_count,
+                                   sizeof (afr_compound_write_t),
+                                   gf_afr_mt_compound_write_t);
+                if (!local->transaction.compound_write)
+                        return _gf_false;
+        }
+
+        return _gf_true;
+}
+
+
+static int32_t
+afr_changelog_pre_op_write_cbk (call_frame_t *frame, void *cookie,
+                                xlator_t *this, int32_t op_ret,
+                                int32_t op_errno, compound_rsp_t *rsp,
+                                dict_t *xdata)
+{
+        afr_private_t        *priv        = NULL;
+        afr_local_t          *local       = NULL;
+        afr_compound_write_t *cwrite      = NULL;
+        dict_t               *xattr       = NULL;
+        int                   child_index = (long) cookie;
+
+        priv  = this->private;
+        local = frame->local;
+
+        /* the brick does not take compound fops and nothing was sent:
+           the pre-op goes alone, the write follows in the fop phase */
+        if (!rsp && op_errno == ENOTSUP) {
+                gf_log (this->name, GF_LOG_DEBUG,
+                        "%s does not take compound fops, sending the "
+                        "pre-op alone", priv->children[child_index]->name);
+
+                STACK_WIND_COOKIE (frame, afr_changelog_pre_op_cbk, cookie,
+                                   priv->children[child_index],
+                                   priv->children[child_index]->fops->fxattrop,
+                                   local->fd, GF_XATTROP_ADD_ARRAY,
+                                   local->transaction.compound_xattr[child_index],
+                                   NULL);
+                return 0;
+        }
+
+        /* without a reply the pre-op counts as failed, as it does when the
+           reply to a plain one is lost, and the child gets no write from
+           the fop phase */
+        if (rsp) {
+                op_ret = rsp->rsps[0].op_ret;
+                op_errno = rsp->rsps[0].op_errno;
+                xattr = rsp->rsps[0].dict;
+
+                /* afr_writev_wind hands it over along with the others */
+                if (op_ret == 0) {
+                        cwrite = &local->transaction.compound_write[child_index];
+                        cwrite->op_ret = rsp->rsps[1].op_ret;
+                        cwrite->op_errno = rsp->rsps[1].op_errno;
+                        cwrite->prebuf = rsp->rsps[1].prebuf;
+                        cwrite->postbuf = rsp->rsps[1].postbuf;
+                        cwrite->done = _gf_true;
+                }
+        }
+
+        return afr_changelog_pre_op_cbk (frame, cookie, this, op_ret,
+                                         op_errno, xattr, xdata);
+}
+
+
+/* winds the pre-op of @child followed by the write of the transaction,
+   returns -1 if it could not */
+static int
+afr_changelog_pre_op_write (call_frame_t *frame, xlator_t *this, int child,
+                            dict_t *xattr)
+{
+        afr_private_t   *priv  = NULL;
+        afr_local_t     *local = NULL;
+        compound_args_t *args  = NULL;
+        int              ret   = -1;
+
+        priv  = this->private;
+        local = frame->local;
+
+        /* no write if the pre-op fails */
+        args = compound_args_new (2, 0);
+        if (!args)
+                goto out;
+
+        ret = compound_args_fxattrop (args, local->fd, GF_XATTROP_ADD_ARRAY,
+                                      xattr, NULL);
+        if (ret)
+                goto out;
+
+        ret = compound_args_writev (args, local->fd, local->cont.writev.vector,
+                                    local->cont.writev.count,
+                                    local->cont.writev.offset,
+                                    local->cont.writev.flags,
+                                    local->cont.writev.iobref, NULL);
+        if (ret)
+                goto out;
+
+        if (local->transaction.compound_xattr[child])
+                dict_unref (local->transaction.compound_xattr[child]);
+        local->transaction.compound_xattr[child] = dict_ref (xattr);
+
+        STACK_WIND_COOKIE (frame, afr_changelog_pre_op_write_cbk,
+                           (void *) (long) child, priv->children[child],
+                           priv->children[child]->fops->compound, args, NULL);
+out:
+        compound_args_destroy (args);
+        return ret;
+}
+
+
 int
 afr_changelog_pre_op (call_frame_t *frame, xlator_t *this)
 {
@@ -802,6 +1127,7 @@ afr_changelog_pre_op (call_frame_t *frame, xlator_t *this)
         int          piggyback = 0;
         afr_internal_lock_t *int_lock = NULL;
         unsigned char       *locked_nodes = NULL;
+        gf_boolean_t         with_write = _gf_false;
 
         local = frame->local;
         int_lock = &local->internal_lock;
@@ -831,6 +1157,8 @@ afr_changelog_pre_op (call_frame_t *frame, xlator_t *this)
         if (local->fd)
                 fdctx = afr_fd_ctx_get (local->fd, this);
 
+        with_write = afr_changelog_pre_op_can_write (frame, this);
+
         locked_nodes = afr_locked_nodes_get (local->transaction.type, int_lock);
         for (i = 0; i < priv->child_count; i++) {
                 if (!locked_nodes[i])
@@ -875,7 +1203,9 @@ afr_changelog_pre_op (call_frame_t *frame, xlator_t *this)
                                 afr_changelog_pre_op_cbk (frame, (void *)(long)i,
                                                           this, 1, 0, xattr[i],
                                                           NULL);
-                        else
+                        else if (!with_write ||
+                                 afr_changelog_pre_op_write (frame, this, i,
+                                                             xattr[i]))
                                 STACK_WIND_COOKIE (frame,
                                                    afr_changelog_pre_op_cbk,
                                                    (void *) (long) i,
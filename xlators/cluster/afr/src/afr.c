@@ -163,6 +163,8 @@ reconfigure (xlator_t *this, dict_t *options)
         }
 
         GF_OPTION_RECONF ("eager-lock", priv->eager_lock, options, bool, out);
+        GF_OPTION_RECONF ("use-compound-fops", priv->use_compound_fops,
+                          options, bool, out);
         GF_OPTION_RECONF ("quorum-type", qtype, options, str, out);
         GF_OPTION_RECONF ("quorum-count", priv->quorum_count, options,
                           uint32, out);
@@ -297,6 +299,8 @@ init (xlator_t *this)
         GF_OPTION_INIT ("strict-readdir", priv->strict_readdir, bool, out);
 
         GF_OPTION_INIT ("eager-lock", priv->eager_lock, bool, out);
+        GF_OPTION_INIT ("use-compound-fops", priv->use_compound_fops, bool,
+                        out);
         GF_OPTION_INIT ("quorum-type", qtype, str, out);
         GF_OPTION_INIT ("quorum-count", priv->quorum_count, uint32, out);
         fix_quorum_options(this,priv,qtype);
@@ -457,6 +461,7 @@ struct xlator_fops fops = {
         .getxattr    = afr_getxattr,
         .fgetxattr   = afr_fgetxattr,
         .readv       = afr_readv,
+        .seek        = afr_seek,
 
         /* inode write */
         .writev      = afr_writev,
@@ -468,6 +473,9 @@ struct xlator_fops fops = {
         .fsetattr    = afr_fsetattr,
         .removexattr = afr_removexattr,
         .fremovexattr = afr_fremovexattr,
+        .fallocate   = afr_fallocate,
+        .discard     = afr_discard,
+        .zerofill    = afr_zerofill,
 
         /* dir read */
         .opendir     = afr_opendir,
@@ -592,6 +600,15 @@ struct volume_options options[] = {
           .type = GF_OPTION_TYPE_BOOL,
           .default_value = "off",
         },
+        { .key = {"use-compound-fops"},
+          .type = GF_OPTION_TYPE_BOOL,
+          .default_value = "off",
+          .description = "Send the changelog pre-op of a write along with "
+                         "the write, and the post-op along with the unlock "
+                         "that follows it, as compound requests to the "
+                         "bricks that support compound fops, the others "
+                         "still get them one by one."
+        },
         { .key = {"self-heal-daemon"},
           .type = GF_OPTION_TYPE_BOOL,
           .default_value = "off",
@@ -151,6 +151,7 @@ typedef struct _afr_private {
         struct list_head saved_fds;   /* list of fds on which locks have succeeded */
         gf_boolean_t      optimistic_change_log;
         gf_boolean_t      eager_lock;
+        gf_boolean_t      use_compound_fops;
         unsigned int      quorum_count;
 
         char                   vol_uuid[UUID_SIZE + 1];
@@ -366,6 +367,15 @@ typedef struct _afr_locked_fd {
         struct list_head list;
 } afr_locked_fd_t;
 
+/* result of a write sent along with the pre-op, held until the fop phase */
+typedef struct {
+        gf_boolean_t done;
+        int32_t      op_ret;
+        int32_t      op_errno;
+        struct iatt  prebuf;
+        struct iatt  postbuf;
+} afr_compound_write_t;
+
 typedef struct _afr_local {
         int     uid;
         int     gid;
@@ -471,6 +481,12 @@ typedef struct _afr_local {
                         int last_index;
                 } fstat;
 
+                struct {
+                        off_t offset;
+                        gf_seek_what_t what;
+                        int last_index;
+                } seek;
+
                 struct {
                         size_t size;
                         int last_index;
@@ -540,6 +556,28 @@ typedef struct _afr_local {
                         struct iatt postbuf;
                 } ftruncate;
 
+                struct {
+                        int32_t mode;
+                        off_t offset;
+                        size_t len;
+                        struct iatt prebuf;
+                        struct iatt postbuf;
+                } fallocate;
+
+                struct {
+                        off_t offset;
+                        size_t len;
+                        struct iatt prebuf;
+                        struct iatt postbuf;
+                } discard;
+
+                struct {
+                        off_t offset;
+                        size_t len;
+                        struct iatt prebuf;
+                        struct iatt postbuf;
+                } zerofill;
+
                 struct {
                         struct iatt in_buf;
                         int32_t valid;
@@ -675,6 +713,10 @@ typedef struct _afr_local {
 
                 int32_t         **txn_changelog;//changelog after pre+post ops
                 unsigned char   *pre_op;
+                dict_t          **compound_xattr; /* changelog sent in a
+                                                     compound, kept for the
+                                                     plain xattrop */
+                afr_compound_write_t *compound_write;
 
                 call_frame_t *main_frame;
 
@@ -1793,6 +1793,79 @@ pump_ftruncate (call_frame_t *frame,
 }
 
 
+static int32_t
+pump_fallocate (call_frame_t *frame,
+               xlator_t *this,
+               fd_t *fd,
+               int32_t mode,
+               off_t offset,
+               size_t len, dict_t *xdata)
+{
+        afr_private_t *priv  = NULL;
+        priv = this->private;
+        if (!priv->use_afr_in_pump) {
+                STACK_WIND (frame,
+                            default_fallocate_cbk,
+                            FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->fallocate,
+                            fd,
+                            mode, offset, len, xdata);
+                return 0;
+        }
+
+        afr_fallocate (frame, this, fd, mode, offset, len, xdata);
+        return 0;
+}
+
+
+static int32_t
+pump_discard (call_frame_t *frame,
+             xlator_t *this,
+             fd_t *fd,
+             off_t offset,
+             size_t len, dict_t *xdata)
+{
+        afr_private_t *priv  = NULL;
+        priv = this->private;
+        if (!priv->use_afr_in_pump) {
+                STACK_WIND (frame,
+                            default_discard_cbk,
+                            FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->discard,
+                            fd,
+                            offset, len, xdata);
+                return 0;
+        }
+
+        afr_discard (frame, this, fd, offset, len, xdata);
+        return 0;
+}
+
+
+static int32_t
+pump_zerofill (call_frame_t *frame,
+              xlator_t *this,
+              fd_t *fd,
+              off_t offset,
+              size_t len, dict_t *xdata)
+{
+        afr_private_t *priv  = NULL;
+        priv = this->private;
+        if (!priv->use_afr_in_pump) {
+                STACK_WIND (frame,
+                            default_zerofill_cbk,
+                            FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->zerofill,
+                            fd,
+                            offset, len, xdata);
+                return 0;
+        }
+
+        afr_zerofill (frame, this, fd, offset, len, xdata);
+        return 0;
+}
+
+
 
 
 int
@@ -2599,6 +2672,9 @@ struct xlator_fops fops = {
 	.writev      = pump_writev,
 	.truncate    = pump_truncate,
 	.ftruncate   = pump_ftruncate,
+        .fallocate   = pump_fallocate,
+        .discard     = pump_discard,
+        .zerofill    = pump_zerofill,
 	.setxattr    = pump_setxattr,
         .setattr     = pump_setattr,
 	.fsetattr    = pump_fsetattr,
@@ -455,6 +455,31 @@ int32_t dht_ftruncate (call_frame_t *frame,
                        fd_t     *fd,
                        off_t     offset, dict_t *xdata);
 
+int32_t dht_fallocate (call_frame_t *frame,
+                       xlator_t *this,
+                       fd_t     *fd,
+                       int32_t   keep_size,
+                       off_t     offset,
+                       size_t    len, dict_t *xdata);
+
+int32_t dht_discard (call_frame_t *frame,
+                     xlator_t *this,
+                     fd_t     *fd,
+                     off_t     offset,
+                     size_t    len, dict_t *xdata);
+
+int32_t dht_zerofill (call_frame_t *frame,
+                      xlator_t *this,
+                      fd_t     *fd,
+                      off_t     offset,
+                      size_t    len, dict_t *xdata);
+
+int32_t dht_seek (call_frame_t *frame,
+                  xlator_t *this,
+                  fd_t     *fd,
+                  off_t     offset,
+                  gf_seek_what_t what, dict_t *xdata);
+
 int32_t dht_access (call_frame_t *frame,
                     xlator_t *this,
                     loc_t    *loc,
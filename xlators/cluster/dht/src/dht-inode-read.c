@@ -22,6 +22,7 @@ int dht_open2 (xlator_t *this, call_frame_t *frame, int ret);
 int dht_flush2 (xlator_t *this, call_frame_t *frame, int ret);
 int dht_lk2 (xlator_t *this, call_frame_t *frame, int ret);
 int dht_fsync2 (xlator_t *this, call_frame_t *frame, int ret);
+int dht_seek2 (xlator_t *this, call_frame_t *frame, int ret);
 
 int
 dht_open_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
@@ -492,6 +493,102 @@ err:
         return 0;
 }
 
+int
+dht_seek_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+              int op_ret, int op_errno, off_t offset, dict_t *xdata)
+{
+        dht_local_t *local = NULL;
+        int          ret   = -1;
+
+        local = frame->local;
+
+        if (local->call_cnt != 1)
+                goto out;
+
+        if ((op_ret == -1) && (op_errno == ENOENT)) {
+                /* File would be migrated to other node */
+                local->rebalance.target_op_fn = dht_seek2;
+                ret = dht_rebalance_complete_check (this, frame);
+                if (!ret)
+                        return 0;
+        }
+
+out:
+        DHT_STACK_UNWIND (seek, frame, op_ret, op_errno, offset, xdata);
+        return 0;
+}
+
+int
+dht_seek2 (xlator_t *this, call_frame_t *frame, int op_ret)
+{
+        dht_local_t *local  = NULL;
+        xlator_t    *subvol = NULL;
+        int          op_errno = EINVAL;
+
+        local = frame->local;
+        if (!local)
+                goto out;
+
+        op_errno = local->op_errno;
+        if (op_ret == -1)
+                goto out;
+
+        local->call_cnt = 2;
+        subvol = local->cached_subvol;
+
+        STACK_WIND (frame, dht_seek_cbk, subvol, subvol->fops->seek,
+                    local->fd, local->rebalance.offset,
+                    local->rebalance.flags, NULL);
+
+        return 0;
+
+out:
+        DHT_STACK_UNWIND (seek, frame, -1, op_errno, 0, NULL);
+        return 0;
+}
+
+int
+dht_seek (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
+          gf_seek_what_t what, dict_t *xdata)
+{
+        xlator_t     *subvol = NULL;
+        int           op_errno = -1;
+        dht_local_t  *local = NULL;
+
+        VALIDATE_OR_GOTO (frame, err);
+        VALIDATE_OR_GOTO (this, err);
+        VALIDATE_OR_GOTO (fd, err);
+
+        local = dht_local_init (frame, NULL, fd, GF_FOP_SEEK);
+        if (!local) {
+                op_errno = ENOMEM;
+                goto err;
+        }
+
+        subvol = local->cached_subvol;
+        if (!subvol) {
+                gf_log (this->name, GF_LOG_DEBUG,
+                        "no cached subvolume for fd=%p", fd);
+                op_errno = EINVAL;
+                goto err;
+        }
+
+        local->rebalance.offset = offset;
+        local->rebalance.flags  = what;
+        local->call_cnt = 1;
+
+        STACK_WIND (frame, dht_seek_cbk, subvol, subvol->fops->seek,
+                    fd, offset, what, xdata);
+
+        return 0;
+
+err:
+        op_errno = (op_errno == -1) ? errno : op_errno;
+        DHT_STACK_UNWIND (seek, frame, -1, op_errno, 0, NULL);
+
+        return 0;
+}
+
 int
 dht_access_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
                 int op_ret, int op_errno, dict_t *xdata)
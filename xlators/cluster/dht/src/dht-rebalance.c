@@ -375,26 +375,25 @@ out:
 }
 
 static inline int
-__dht_rebalance_migrate_data (xlator_t *from, xlator_t *to, fd_t *src, fd_t *dst,
-                             uint64_t ia_size, int hole_exists)
+__dht_rebalance_copy_range (xlator_t *from, xlator_t *to, fd_t *src, fd_t *dst,
+                            off_t offset, off_t end, int hole_exists)
 {
         int            ret    = 0;
         int            count  = 0;
-        off_t          offset = 0;
         struct iovec  *vector = NULL;
         struct iobref *iobref = NULL;
-        uint64_t       total  = 0;
         size_t         read_size = 0;
+        int            read_ret  = 0;
 
-        /* if file size is '0', no need to enter this loop */
-        while (total < ia_size) {
-                read_size = (((ia_size - total) > DHT_REBALANCE_BLKSIZE) ?
-                             DHT_REBALANCE_BLKSIZE : (ia_size - total));
+        while (offset < end) {
+                read_size = (((end - offset) > DHT_REBALANCE_BLKSIZE) ?
+                             DHT_REBALANCE_BLKSIZE : (end - offset));
                 ret = syncop_readv (from, src, read_size,
                                     offset, 0, &vector, &count, &iobref);
                 if (!ret || (ret < 0)) {
                         break;
                 }
+                read_ret = ret;
 
                 if (hole_exists)
                         ret = dht_write_with_holes (to, dst, vector, count,
@@ -405,8 +404,7 @@ __dht_rebalance_migrate_data (xlator_t *from, xlator_t *to, fd_t *src, fd_t *dst
                 if (ret < 0) {
                         break;
                 }
-                offset += ret;
-                total += ret;
+                offset += read_ret;
 
                 if (vector)
                         GF_FREE (vector);
@@ -426,6 +424,64 @@ __dht_rebalance_migrate_data (xlator_t *from, xlator_t *to, fd_t *src, fd_t *dst
         return ret;
 }
 
+static inline int
+__dht_rebalance_migrate_data (xlator_t *from, xlator_t *to, fd_t *src, fd_t *dst,
+                             uint64_t ia_size, int hole_exists)
+{
+        int            ret       = 0;
+        off_t          offset    = 0;
+        off_t          data      = 0;
+        off_t          hole      = 0;
+
+        if (!hole_exists)
+                return __dht_rebalance_copy_range (from, to, src, dst, 0,
+                                                   ia_size, 0);
+
+        /* sparse file: ask the source where its data lives and copy only
+           those extents, instead of reading (and zero-scanning) the holes */
+        while (offset < ia_size) {
+                ret = syncop_seek (from, src, offset, GF_SEEK_DATA, &data);
+                if (ret < 0) {
+                        if (errno == ENXIO) {
+                                /* only a hole left till the end */
+                                ret = 0;
+                                break;
+                        }
+                        /* seek is not supported all the way down, copy
+                           the rest the old way */
+                        gf_log (THIS->name, GF_LOG_DEBUG,
+                                "seek failed (%s), copying the remaining "
+                                "data in full", strerror (errno));
+                        ret = __dht_rebalance_copy_range (from, to, src, dst,
+                                                          offset, ia_size, 1);
+                        break;
+                }
+                if (data >= ia_size)
+                        break;
+
+                ret = syncop_seek (from, src, data, GF_SEEK_HOLE, &hole);
+                if ((ret < 0) || (hole > ia_size))
+                        hole = ia_size;
+
+                ret = __dht_rebalance_copy_range (from, to, src, dst, data,
+                                                  hole, 1);
+                if (ret < 0)
+                        break;
+
+                offset = hole;
+        }
+
+        /* holes are not written, make sure a trailing one still counts
+           towards the size of the destination */
+        if (ret == 0)
+                ret = syncop_ftruncate (to, dst, ia_size);
+
+        if (ret >= 0)
+                ret = 0;
+
+        return ret;
+}
+
 
 static inline int
 __dht_rebalance_open_src_file (xlator_t *from, xlator_t *to, loc_t *loc,
@@ -3703,6 +3703,287 @@ err:
 }
 
 
+/* fallocate(), discard() and zerofill() share the callback and the range
+   splitting below; local->fop selects what to wind and unwind. */
+int32_t
+stripe_fallocate_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                      int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                      struct iatt *postbuf, dict_t *xdata)
+{
+        int32_t         callcnt = 0;
+        stripe_local_t *local = NULL;
+        call_frame_t   *prev = NULL;
+
+        if (!this || !frame || !frame->local || !cookie) {
+                gf_log ("stripe", GF_LOG_DEBUG, "possible NULL deref");
+                goto out;
+        }
+
+        prev  = cookie;
+        local = frame->local;
+
+        LOCK(&frame->lock);
+        {
+                callcnt = ++local->call_count;
+
+                if (op_ret == -1) {
+                        gf_log (this->name, GF_LOG_DEBUG,
+                                "%s returned error %s",
+                                prev->this->name, strerror (op_errno));
+                        local->op_errno = op_errno;
+                        local->failed = 1;
+                }
+                if (op_ret >= 0) {
+                        local->post_buf = *postbuf;
+                        local->pre_buf = *prebuf;
+
+                        local->prebuf_blocks  += prebuf->ia_blocks;
+                        local->postbuf_blocks += postbuf->ia_blocks;
+
+                        correct_file_size(prebuf, local->fctx, prev);
+                        correct_file_size(postbuf, local->fctx, prev);
+
+                        if (local->prebuf_size < prebuf->ia_size)
+                                local->prebuf_size = prebuf->ia_size;
+                        if (local->postbuf_size < postbuf->ia_size)
+                                local->postbuf_size = postbuf->ia_size;
+                }
+        }
+        UNLOCK (&frame->lock);
+
+        if (callcnt != local->wind_count)
+                goto out;
+
+        if (local->failed) {
+                local->op_ret = -1;
+        } else {
+                local->op_ret = 0;
+                local->pre_buf.ia_size = local->prebuf_size;
+                local->pre_buf.ia_blocks = local->prebuf_blocks;
+                local->post_buf.ia_size = local->postbuf_size;
+                local->post_buf.ia_blocks = local->postbuf_blocks;
+        }
+
+        switch (local->fop) {
+        case GF_FOP_FALLOCATE:
+                STRIPE_STACK_UNWIND (fallocate, frame, local->op_ret,
+                                     local->op_errno, &local->pre_buf,
+                                     &local->post_buf, NULL);
+                break;
+        case GF_FOP_DISCARD:
+                STRIPE_STACK_UNWIND (discard, frame, local->op_ret,
+                                     local->op_errno, &local->pre_buf,
+                                     &local->post_buf, NULL);
+                break;
+        default:
+                STRIPE_STACK_UNWIND (zerofill, frame, local->op_ret,
+                                     local->op_errno, &local->pre_buf,
+                                     &local->post_buf, NULL);
+                break;
+        }
+out:
+        return 0;
+}
+
+static void
+stripe_fallocate_wind_one (call_frame_t *frame, xlator_t *subvol, fd_t *fd,
+                           off_t offset, size_t len, dict_t *xdata)
+{
+        stripe_local_t *local = frame->local;
+
+        switch (local->fop) {
+        case GF_FOP_FALLOCATE:
+                STACK_WIND (frame, stripe_fallocate_cbk, subvol,
+                            subvol->fops->fallocate, fd, local->flags,
+                            offset, len, xdata);
+                break;
+        case GF_FOP_DISCARD:
+                STACK_WIND (frame, stripe_fallocate_cbk, subvol,
+                            subvol->fops->discard, fd, offset, len, xdata);
+                break;
+        default:
+                STACK_WIND (frame, stripe_fallocate_cbk, subvol,
+                            subvol->fops->zerofill, fd, offset, len, xdata);
+                break;
+        }
+}
+
+/*
+ * With coalesced stripes every child stores its share of [offset, end)
+ * contiguously, so one call per child covers the whole range. Otherwise
+ * the children keep the file's own offsets and the range is split at
+ * stripe boundaries, the same way writev() does it.
+ */
+static int32_t
+stripe_fallocate_wind (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                       off_t offset, size_t len, dict_t *xdata)
+{
+        stripe_local_t  *local = frame->local;
+        stripe_fd_ctx_t *fctx = local->fctx;
+        uint64_t         ss = fctx->stripe_size;
+        int              sc = fctx->stripe_count;
+        uint64_t         first_chunk = 0;
+        uint64_t         last_chunk = 0;
+        uint64_t         chunk = 0;
+        off_t            start = 0;
+        off_t            last = 0;
+        off_t            end = offset + len;
+        off_t            dest_start = 0;
+        off_t            dest_end = 0;
+        off_t            fill_size = 0;
+        int              idx = 0;
+        int              i = 0;
+
+        first_chunk = offset / ss;
+        last_chunk  = (end - 1) / ss;
+
+        if (fctx->stripe_coalesce) {
+                /* child i owns chunks i, i + sc, i + 2 * sc, ... */
+                local->wind_count = last_chunk - first_chunk + 1;
+                if (local->wind_count > sc)
+                        local->wind_count = sc;
+
+                for (i = 0; i < sc; i++) {
+                        chunk = first_chunk + (i - first_chunk % sc + sc) % sc;
+                        if (chunk > last_chunk)
+                                continue;
+                        start = (chunk == first_chunk) ? offset : chunk * ss;
+
+                        chunk = last_chunk - (last_chunk % sc - i + sc) % sc;
+                        last = (chunk == last_chunk) ? end - 1
+                                                     : chunk * ss + ss - 1;
+
+                        dest_start = coalesced_offset (start, ss, sc);
+                        dest_end = coalesced_offset (last, ss, sc) + 1;
+                        stripe_fallocate_wind_one (frame, fctx->xl_array[i],
+                                                   fd, dest_start,
+                                                   dest_end - dest_start,
+                                                   xdata);
+                }
+                return 0;
+        }
+
+        local->wind_count = last_chunk - first_chunk + 1;
+
+        start = offset;
+        while (start < end) {
+                idx = (start / ss) % sc;
+                fill_size = ss - (start % ss);
+                if (fill_size > end - start)
+                        fill_size = end - start;
+
+                stripe_fallocate_wind_one (frame, fctx->xl_array[idx], fd,
+                                           start, fill_size, xdata);
+                start += fill_size;
+        }
+
+        return 0;
+}
+
+static int32_t
+stripe_fallocate_common (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                         glusterfs_fop_t fop, int32_t flags, off_t offset,
+                         size_t len, dict_t *xdata)
+{
+        stripe_local_t   *local = NULL;
+        stripe_fd_ctx_t  *fctx = NULL;
+        uint64_t          tmp_fctx = 0;
+        int32_t           op_errno = 1;
+
+        VALIDATE_OR_GOTO (frame, err);
+        VALIDATE_OR_GOTO (this, err);
+        VALIDATE_OR_GOTO (fd, err);
+        VALIDATE_OR_GOTO (fd->inode, err);
+
+        inode_ctx_get (fd->inode, this, &tmp_fctx);
+        if (!tmp_fctx) {
+                op_errno = EINVAL;
+                goto err;
+        }
+        fctx = (stripe_fd_ctx_t *)(long)tmp_fctx;
+
+        STRIPE_VALIDATE_FCTX (fctx, err);
+
+        if (!fctx->stripe_size) {
+                gf_log (this->name, GF_LOG_DEBUG,
+                        "Wrong stripe size for the file");
+                op_errno = EINVAL;
+                goto err;
+        }
+
+        if (!len) {
+                op_errno = EINVAL;
+                goto err;
+        }
+
+        local = mem_get0 (this->local_pool);
+        if (!local) {
+                op_errno = ENOMEM;
+                goto err;
+        }
+        frame->local = local;
+        local->fctx = fctx;
+        local->fop = fop;
+        local->flags = flags;
+        local->stripe_size = fctx->stripe_size;
+
+        stripe_fallocate_wind (frame, this, fd, offset, len, xdata);
+
+        return 0;
+err:
+        switch (fop) {
+        case GF_FOP_FALLOCATE:
+                STRIPE_STACK_UNWIND (fallocate, frame, -1, op_errno, NULL,
+                                     NULL, NULL);
+                break;
+        case GF_FOP_DISCARD:
+                STRIPE_STACK_UNWIND (discard, frame, -1, op_errno, NULL,
+                                     NULL, NULL);
+                break;
+        default:
+                STRIPE_STACK_UNWIND (zerofill, frame, -1, op_errno, NULL,
+                                     NULL, NULL);
+                break;
+        }
+        return 0;
+}
+
+int32_t
+stripe_fallocate (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                  int32_t keep_size, off_t offset, size_t len, dict_t *xdata)
+{
+        return stripe_fallocate_common (frame, this, fd, GF_FOP_FALLOCATE,
+                                        keep_size, offset, len, xdata);
+}
+
+int32_t
+stripe_discard (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                off_t offset, size_t len, dict_t *xdata)
+{
+        return stripe_fallocate_common (frame, this, fd, GF_FOP_DISCARD,
+                                        0, offset, len, xdata);
+}
+
+int32_t
+stripe_zerofill (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                 off_t offset, size_t len, dict_t *xdata)
+{
+        return stripe_fallocate_common (frame, this, fd, GF_FOP_ZEROFILL,
+                                        0, offset, len, xdata);
+}
+
+/* Data and holes are spread over all the children, and no single child
+   can answer for the whole file. Refuse it the way lseek does for an
+   unknown whence, so callers fall back to reading everything. */
+int32_t
+stripe_seek (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
+             gf_seek_what_t what, dict_t *xdata)
+{
+        STACK_UNWIND_STRICT (seek, frame, -1, EINVAL, 0, NULL);
+        return 0;
+}
+
+
 int32_t
 stripe_release (xlator_t *this, fd_t *fd)
 {
@@ -4919,6 +5200,10 @@ struct xlator_fops fops = {
         .flush          = stripe_flush,
         .fsync          = stripe_fsync,
         .ftruncate      = stripe_ftruncate,
+        .fallocate      = stripe_fallocate,
+        .discard        = stripe_discard,
+        .zerofill       = stripe_zerofill,
+        .seek           = stripe_seek,
         .fstat          = stripe_fstat,
         .mkdir          = stripe_mkdir,
         .rmdir          = stripe_rmdir,
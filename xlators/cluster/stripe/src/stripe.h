@@ -195,6 +195,7 @@ struct stripe_local {
         /* General usage */
         off_t                offset;
         off_t                stripe_size;
+        glusterfs_fop_t      fop;
 
         int xattr_self_heal_needed;
         int entry_self_heal_needed;
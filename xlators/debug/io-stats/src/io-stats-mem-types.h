@@ -29,6 +29,10 @@ enum gf_io_stats_mem_types_ {
         gf_io_stats_mt_ios_fd,
         gf_io_stats_mt_ios_stat,
         gf_io_stats_mt_ios_stat_list,
+        gf_io_stats_mt_ios_global_stats,
+        gf_io_stats_mt_ios_client,
+        gf_io_stats_mt_ios_lat_hist,
+        gf_io_stats_mt_ios_stats_block,
         gf_io_stats_mt_end
 };
 #endif
@@ -33,6 +33,7 @@
  *  c) counts of read IO block size - since process start, last interval and per fd
  *  d) counts of write IO block size - since process start, last interval and per fd
  *  e) counts of all FOP types passing through it
+ *  f) latency histograms of all FOP types, overall and per client
  *
  *  Usage: setfattr -n io-stats-dump /tmp/filename /mnt/gluster
  *
@@ -40,6 +41,7 @@
 
 #include <fnmatch.h>
 #include <errno.h>
+#include <sched.h>
 #include "glusterfs.h"
 #include "xlator.h"
 #include "io-stats-mem-types.h"
@@ -49,6 +51,30 @@
 
 #define MAX_LIST_MEMBERS 100
 
+/* Latencies (in usecs) are kept in log-linear histograms: every power of
+ * two is split into IOS_LAT_SUB_COUNT equal buckets, so a percentile read
+ * back from the histogram is within 1/IOS_LAT_SUB_COUNT of the real value.
+ * Anything slower than 2^IOS_LAT_MAX_LOG2 usecs (~71 mins) lands in the
+ * last bucket.
+ */
+#define IOS_LAT_SUB_BITS   3
+#define IOS_LAT_SUB_COUNT  (1 << IOS_LAT_SUB_BITS)
+#define IOS_LAT_MAX_LOG2   32
+#define IOS_LAT_BUCKETS    ((IOS_LAT_MAX_LOG2 - IOS_LAT_SUB_BITS + 1) \
+                            << IOS_LAT_SUB_BITS)
+
+#define IOS_LAT_PCT_MAX    4
+
+/* histogram of fop @i in @hists, NULL when there is none */
+#define IOS_LAT_HIST(hists, i) ((hists) ? &(hists)[i] : NULL)
+
+/* clients tracked by latency-per-client at a time, the least recently
+   active one is dropped to make room for a new one */
+#define IOS_MAX_CLIENTS    64
+
+/* upper bound on the per-cpu counter blocks */
+#define IOS_MAX_STATS_BLOCKS 64
+
 typedef enum {
         IOS_STATS_TYPE_NONE,
         IOS_STATS_TYPE_OPEN,
@@ -100,6 +126,22 @@ struct ios_lat {
         double  avg;
 };
 
+struct ios_lat_hist {
+        uint64_t        buckets[IOS_LAT_BUCKETS];
+};
+
+static double ios_lat_pct[IOS_LAT_PCT_MAX] = {50.0, 90.0, 99.0, 99.9};
+static char *ios_lat_pct_name[IOS_LAT_PCT_MAX] = {"p50", "p90", "p99",
+                                                  "p999"};
+
+struct ios_client {
+        struct list_head        list;
+        char                   *id;
+        uint64_t                fop_hits[GF_FOP_MAXVALUE];
+        struct ios_lat          latency[GF_FOP_MAXVALUE];
+        struct ios_lat_hist    *latency_hist[GF_FOP_MAXVALUE];
+};
+
 struct ios_global_stats {
         uint64_t        data_written;
         uint64_t        data_read;
@@ -113,15 +155,41 @@ struct ios_global_stats {
         struct timeval  max_openfd_time;
 };
 
+/* The fop path only ever adds to the counter block of the cpu it runs on,
+ * with atomic increments and no lock; io_stats_dump() sums the blocks up
+ * into the cumulative and incremental ios_global_stats.  Latency minima
+ * and maxima are those seen since the previous dump.  latency_hist points
+ * to GF_FOP_MAXVALUE histograms in conf->lat_hists and stays NULL until
+ * latency-measurement is turned on.
+ */
+struct ios_stats_block {
+        uint64_t        data_written;
+        uint64_t        data_read;
+        uint64_t        block_count_write[32];
+        uint64_t        block_count_read[32];
+        uint64_t        fop_hits[GF_FOP_MAXVALUE];
+        uint64_t        latency_sum[GF_FOP_MAXVALUE];
+        uint64_t        latency_min[GF_FOP_MAXVALUE];
+        uint64_t        latency_max[GF_FOP_MAXVALUE];
+        struct ios_lat_hist *latency_hist;
+};
+
 
 struct ios_conf {
         gf_lock_t                 lock;
         struct ios_global_stats   cumulative;
         uint64_t                  increment;
         struct ios_global_stats   incremental;
+        struct ios_stats_block   *blocks;
+        int                       block_count;
+        struct ios_stats_block    last_dump;
+        struct ios_lat_hist      *lat_hists;
         gf_boolean_t              dump_fd_stats;
         gf_boolean_t              count_fop_hits;
         gf_boolean_t              measure_latency;
+        gf_boolean_t              latency_per_client;
+        struct list_head          clients;
+        int                       client_count;
         struct ios_stat_head      list[IOS_STATS_TYPE_MAX];
         struct ios_stat_head      thru_list[IOS_STATS_THRU_MAX];
 };
@@ -169,6 +237,23 @@ is_fop_latency_started (call_frame_t *frame)
         return memcmp (&frame->begin, &epoch, sizeof (epoch));
 }
 
+static inline struct ios_stats_block *
+ios_stats_block_get (struct ios_conf *conf)
+{
+        int idx = -1;
+
+        if (conf->block_count == 1)
+                return &conf->blocks[0];
+
+#ifdef GF_LINUX_HOST_OS
+        idx = sched_getcpu ();
+#endif
+        if (idx < 0)
+                idx = 0;
+
+        return &conf->blocks[idx % conf->block_count];
+}
+
 #define END_FOP_LATENCY(frame, op)                                      \
         do {                                                            \
                 struct ios_conf  *conf = NULL;                          \
@@ -176,7 +261,8 @@ is_fop_latency_started (call_frame_t *frame)
                 conf = this->private;                                   \
                 if (conf && conf->measure_latency) {                    \
                         gettimeofday (&frame->end, NULL);               \
-                        update_ios_latency (conf, frame, GF_FOP_##op);  \
+                        update_ios_latency (this, conf, frame,          \
+                                            GF_FOP_##op);               \
                 }                                                       \
         } while (0)
 
@@ -195,13 +281,14 @@ is_fop_latency_started (call_frame_t *frame)
 
 #define BUMP_FOP(op)                                                    \
         do {                                                            \
-                struct ios_conf  *conf = NULL;                          \
+                struct ios_conf         *conf = NULL;                   \
+                struct ios_stats_block  *block = NULL;                  \
                                                                         \
                 conf = this->private;                                   \
                 if (!conf)                                              \
                         break;                                          \
-                conf->cumulative.fop_hits[GF_FOP_##op]++;               \
-                conf->incremental.fop_hits[GF_FOP_##op]++;              \
+                block = ios_stats_block_get (conf);                     \
+                __sync_fetch_and_add (&block->fop_hits[GF_FOP_##op], 1);\
         } while (0)
 
 #define UPDATE_PROFILE_STATS(frame, op)                                       \
@@ -211,23 +298,20 @@ is_fop_latency_started (call_frame_t *frame)
                 if (!is_fop_latency_started (frame))                          \
                         break;                                                \
                 conf = this->private;                                         \
-                LOCK (&conf->lock);                                           \
-                {                                                             \
-                        if (conf && conf->measure_latency &&                  \
-                            conf->count_fop_hits) {                           \
-                                BUMP_FOP(op);                                 \
-                                gettimeofday (&frame->end, NULL);             \
-                                update_ios_latency (conf, frame, GF_FOP_##op);\
-                        }                                                     \
+                if (conf && conf->measure_latency &&                          \
+                    conf->count_fop_hits) {                                   \
+                        BUMP_FOP(op);                                         \
+                        gettimeofday (&frame->end, NULL);                     \
+                        update_ios_latency (this, conf, frame, GF_FOP_##op);  \
                 }                                                             \
-                UNLOCK (&conf->lock);                                         \
         } while (0)
 
 #define BUMP_READ(fd, len)                                              \
         do {                                                            \
-                struct ios_conf  *conf = NULL;                          \
-                struct ios_fd    *iosfd = NULL;                         \
-                int               lb2 = 0;                              \
+                struct ios_conf         *conf = NULL;                   \
+                struct ios_stats_block  *block = NULL;                  \
+                struct ios_fd           *iosfd = NULL;                  \
+                int                      lb2 = 0;                       \
                                                                         \
                 conf = this->private;                                   \
                 lb2 = log_base2 (len);                                  \
@@ -235,27 +319,24 @@ is_fop_latency_started (call_frame_t *frame)
                 if (!conf)                                              \
                         break;                                          \
                                                                         \
-                LOCK (&conf->lock);                                     \
-                {                                                       \
-                        conf->cumulative.data_read += len;              \
-                        conf->incremental.data_read += len;             \
-                        conf->cumulative.block_count_read[lb2]++;       \
-                        conf->incremental.block_count_read[lb2]++;      \
+                block = ios_stats_block_get (conf);                     \
+                __sync_fetch_and_add (&block->data_read, len);          \
+                __sync_fetch_and_add (&block->block_count_read[lb2], 1);\
                                                                         \
-                        if (iosfd) {                                    \
-                                iosfd->data_read += len;                \
-                                iosfd->block_count_read[lb2]++;         \
-                        }                                               \
+                if (iosfd) {                                            \
+                        __sync_fetch_and_add (&iosfd->data_read, len);  \
+                        __sync_fetch_and_add (&iosfd->block_count_read[lb2],\
+                                              1);                       \
                 }                                                       \
-                UNLOCK (&conf->lock);                                   \
         } while (0)
 
 
 #define BUMP_WRITE(fd, len)                                             \
         do {                                                            \
-                struct ios_conf  *conf = NULL;                          \
-                struct ios_fd    *iosfd = NULL;                         \
-                int               lb2 = 0;                              \
+                struct ios_conf         *conf = NULL;                   \
+                struct ios_stats_block  *block = NULL;                  \
+                struct ios_fd           *iosfd = NULL;                  \
+                int                      lb2 = 0;                       \
                                                                         \
                 conf = this->private;                                   \
                 lb2 = log_base2 (len);                                  \
@@ -263,19 +344,15 @@ is_fop_latency_started (call_frame_t *frame)
                 if (!conf)                                              \
                         break;                                          \
                                                                         \
-                LOCK (&conf->lock);                                     \
-                {                                                       \
-                        conf->cumulative.data_written += len;           \
-                        conf->incremental.data_written += len;          \
-                        conf->cumulative.block_count_write[lb2]++;      \
-                        conf->incremental.block_count_write[lb2]++;     \
+                block = ios_stats_block_get (conf);                     \
+                __sync_fetch_and_add (&block->data_written, len);       \
+                __sync_fetch_and_add (&block->block_count_write[lb2], 1);\
                                                                         \
-                        if (iosfd) {                                    \
-                                iosfd->data_written += len;             \
-                                iosfd->block_count_write[lb2]++;        \
-                        }                                               \
+                if (iosfd) {                                            \
+                        __sync_fetch_and_add (&iosfd->data_written, len);\
+                        __sync_fetch_and_add (&iosfd->block_count_write[lb2],\
+                                              1);                       \
                 }                                                       \
-                UNLOCK (&conf->lock);                                   \
         } while (0)
 
 
@@ -591,8 +668,70 @@ ios_dump_throughput_stats (struct ios_stat_head *list_head, xlator_t *this,
         return 0;
 }
 
+static inline int
+ios_lat_bucket (uint64_t usec)
+{
+        int lb2 = 0;
+
+        if (usec < IOS_LAT_SUB_COUNT)
+                return usec;
+        if (usec >= (1ULL << IOS_LAT_MAX_LOG2))
+                return IOS_LAT_BUCKETS - 1;
+
+        lb2 = 63 - __builtin_clzll (usec);
+
+        return ((lb2 - IOS_LAT_SUB_BITS + 1) << IOS_LAT_SUB_BITS) +
+                (usec >> (lb2 - IOS_LAT_SUB_BITS)) - IOS_LAT_SUB_COUNT;
+}
+
+/* highest latency that falls in bucket @idx */
+static uint64_t
+ios_lat_bucket_high (int idx)
+{
+        int      lb2 = 0;
+        uint64_t sub = 0;
+
+        if (idx < 2 * IOS_LAT_SUB_COUNT)
+                return idx;
+
+        lb2 = (idx >> IOS_LAT_SUB_BITS) + IOS_LAT_SUB_BITS - 1;
+        sub = idx & (IOS_LAT_SUB_COUNT - 1);
+
+        return ((IOS_LAT_SUB_COUNT + sub + 1) << (lb2 - IOS_LAT_SUB_BITS)) - 1;
+}
+
+static double
+ios_lat_hist_percentile (struct ios_lat_hist *hist, double pct, double max)
+{
+        uint64_t total  = 0;
+        uint64_t seen   = 0;
+        double   target = 0;
+        double   value  = 0;
+        int      i      = 0;
+
+        if (!hist)
+                return 0;
+
+        for (i = 0; i < IOS_LAT_BUCKETS; i++)
+                total += hist->buckets[i];
+        if (!total)
+                return 0;
+
+        target = total * pct / 100;
+        for (i = 0; i < IOS_LAT_BUCKETS; i++) {
+                seen += hist->buckets[i];
+                if (seen >= target)
+                        break;
+        }
+
+        value = ios_lat_bucket_high (i);
+
+        return (value < max) ? value : max;
+}
+
 int
 io_stats_dump_global_to_logfp (xlator_t *this, struct ios_global_stats *stats,
+                               struct ios_lat_hist *hists,
                                struct timeval *now, int interval, FILE* logfp)
 {
         int                   i = 0;
@@ -691,6 +830,34 @@ io_stats_dump_global_to_logfp (xlator_t *this, struct ios_global_stats *stats,
         ios_log (this, logfp, "------ ----- ----- ----- ----- ----- ----- ----- "
                  " ----- ----- ----- -----\n");
 
+        ios_log (this, logfp, "%-13s %14s %14s %14s %14s", "Fop",
+                 "P50-Latency", "P90-Latency", "P99-Latency",
+                 "P99.9-Latency");
+        ios_log (this, logfp, "%-13s %14s %14s %14s %14s", "---",
+                 "-----------", "-----------", "-----------",
+                 "-------------");
+
+        for (i = 0; i < GF_FOP_MAXVALUE; i++) {
+                if (!stats->fop_hits[i] || !stats->latency[i].avg)
+                        continue;
+                ios_log (this, logfp, "%-13s %11.2lf us %11.2lf us "
+                         "%11.2lf us %11.2lf us", gf_fop_list[i],
+                         ios_lat_hist_percentile (IOS_LAT_HIST (hists, i),
+                                                  ios_lat_pct[0],
+                                                  stats->latency[i].max),
+                         ios_lat_hist_percentile (IOS_LAT_HIST (hists, i),
+                                                  ios_lat_pct[1],
+                                                  stats->latency[i].max),
+                         ios_lat_hist_percentile (IOS_LAT_HIST (hists, i),
+                                                  ios_lat_pct[2],
+                                                  stats->latency[i].max),
+                         ios_lat_hist_percentile (IOS_LAT_HIST (hists, i),
+                                                  ios_lat_pct[3],
+                                                  stats->latency[i].max));
+        }
+        ios_log (this, logfp, "------ ----- ----- ----- ----- ----- ----- ----- "
+                 " ----- ----- ----- -----\n");
+
         if (interval == -1) {
                 LOCK (&conf->lock);
                 {
@@ -748,13 +915,16 @@ io_stats_dump_global_to_logfp (xlator_t *this, struct ios_global_stats *stats,
 
 int
 io_stats_dump_global_to_dict (xlator_t *this, struct ios_global_stats *stats,
+                              struct ios_lat_hist *hists,
                               struct timeval *now, int interval, dict_t *dict)
 {
         int             ret = 0;
         char            key[256] = {0};
         uint64_t        sec = 0;
         int             i = 0;
+        int             p = 0;
         uint64_t        count = 0;
+        double          value = 0;
 
         GF_ASSERT (stats);
         GF_ASSERT (now);
@@ -866,14 +1036,162 @@ io_stats_dump_global_to_dict (xlator_t *this, struct ios_global_stats *stats,
                                 interval, stats->latency[i].max);
                         goto out;
                 }
+                for (p = 0; p < IOS_LAT_PCT_MAX; p++) {
+                        value = ios_lat_hist_percentile
+                                (IOS_LAT_HIST (hists, i), ios_lat_pct[p],
+                                 stats->latency[i].max);
+                        snprintf (key, sizeof (key), "%d-%d-%slatency",
+                                  interval, i, ios_lat_pct_name[p]);
+                        ret = dict_set_double (dict, key, value);
+                        if (ret) {
+                                gf_log (this->name, GF_LOG_ERROR, "failed to "
+                                        "set %s %slatency(%d) with %f",
+                                        gf_fop_list[i], ios_lat_pct_name[p],
+                                        interval, value);
+                                goto out;
+                        }
+                }
         }
 out:
         gf_log (this->name, GF_LOG_DEBUG, "returning %d", ret);
         return ret;
 }
 
+/* called with conf->lock held */
+int
+__io_stats_dump_clients_to_logfp (xlator_t *this, struct ios_conf *conf,
+                                  FILE *logfp)
+{
+        struct ios_client *client = NULL;
+        struct ios_lat    *lat    = NULL;
+        int                i      = 0;
+
+        ios_log (this, logfp, "\n=== Per client latency stats ===");
+
+        list_for_each_entry (client, &conf->clients, list) {
+                ios_log (this, logfp, "\nClient : %s", client->id);
+                ios_log (this, logfp, "%-13s %10s %14s %14s %14s %14s",
+                         "Fop", "Call Count", "P50-Latency", "P99-Latency",
+                         "P99.9-Latency", "Max-Latency");
+
+                for (i = 0; i < GF_FOP_MAXVALUE; i++) {
+                        if (!client->fop_hits[i])
+                                continue;
+                        lat = &client->latency[i];
+                        ios_log (this, logfp, "%-13s %10"PRId64" %11.2lf us "
+                                 "%11.2lf us %11.2lf us %11.2lf us",
+                                 gf_fop_list[i], client->fop_hits[i],
+                                 ios_lat_hist_percentile
+                                 (client->latency_hist[i], ios_lat_pct[0],
+                                  lat->max),
+                                 ios_lat_hist_percentile
+                                 (client->latency_hist[i], ios_lat_pct[2],
+                                  lat->max),
+                                 ios_lat_hist_percentile
+                                 (client->latency_hist[i], ios_lat_pct[3],
+                                  lat->max),
+                                 lat->max);
+                }
+        }
+
+        return 0;
+}
+
+/* called with conf->lock held */
+int
+__io_stats_dump_clients_to_dict (xlator_t *this, struct ios_conf *conf,
+                                 int interval, dict_t *dict)
+{
+        struct ios_client *client = NULL;
+        char               key[256] = {0};
+        int                count = 0;
+        int                ret = 0;
+        int                i = 0;
+        int                p = 0;
+        double             value = 0;
+
+        list_for_each_entry (client, &conf->clients, list) {
+                count++;
+
+                snprintf (key, sizeof (key), "%d-client-%d-id", interval,
+                          count);
+                ret = dict_set_str (dict, key, client->id);
+                if (ret)
+                        goto out;
+
+                for (i = 0; i < GF_FOP_MAXVALUE; i++) {
+                        if (!client->fop_hits[i])
+                                continue;
+
+                        snprintf (key, sizeof (key), "%d-client-%d-%d-hits",
+                                  interval, count, i);
+                        ret = dict_set_uint64 (dict, key,
+                                               client->fop_hits[i]);
+                        if (ret)
+                                goto out;
+
+                        for (p = 0; p < IOS_LAT_PCT_MAX; p++) {
+                                value = ios_lat_hist_percentile
+                                        (client->latency_hist[i],
+                                         ios_lat_pct[p],
+                                         client->latency[i].max);
+                                snprintf (key, sizeof (key),
+                                          "%d-client-%d-%d-%slatency",
+                                          interval, count, i,
+                                          ios_lat_pct_name[p]);
+                                ret = dict_set_double (dict, key, value);
+                                if (ret)
+                                        goto out;
+                        }
+                }
+        }
+
+        snprintf (key, sizeof (key), "%d-client-count", interval);
+        ret = dict_set_int32 (dict, key, count);
+out:
+        if (ret)
+                gf_log (this->name, GF_LOG_ERROR, "failed to set per client "
+                        "latency of client %d", count);
+        return ret;
+}
+
+int
+io_stats_dump_clients (xlator_t *this, struct ios_dump_args *args)
+{
+        struct ios_conf *conf = NULL;
+        int              ret  = 0;
+
+        conf = this->private;
+
+        LOCK (&conf->lock);
+        {
+                if (list_empty (&conf->clients))
+                        goto unlock;
+
+                switch (args->type) {
+                case IOS_DUMP_TYPE_FILE:
+                        ret = __io_stats_dump_clients_to_logfp (this, conf,
+                                                                args->u.logfp);
+                        break;
+                case IOS_DUMP_TYPE_DICT:
+                        ret = __io_stats_dump_clients_to_dict (this, conf, -1,
+                                                               args->u.dict);
+                        break;
+                default:
+                        GF_ASSERT (0);
+                        ret = -1;
+                        break;
+                }
+        }
+unlock:
+        UNLOCK (&conf->lock);
+
+        return ret;
+}
+
 int
 io_stats_dump_global (xlator_t *this, struct ios_global_stats *stats,
+                      struct ios_lat_hist *hists,
                       struct timeval *now, int interval,
                       struct ios_dump_args *args)
 {
@@ -888,11 +1206,11 @@ io_stats_dump_global (xlator_t *this, struct ios_global_stats *stats,
 
         switch (args->type) {
         case IOS_DUMP_TYPE_FILE:
-                ret = io_stats_dump_global_to_logfp (this, stats, now,
+                ret = io_stats_dump_global_to_logfp (this, stats, hists, now,
                                                      interval, args->u.logfp);
         break;
         case IOS_DUMP_TYPE_DICT:
-                ret = io_stats_dump_global_to_dict (this, stats, now,
+                ret = io_stats_dump_global_to_dict (this, stats, hists, now,
                                                     interval, args->u.dict);
         break;
         default:
@@ -929,12 +1247,117 @@ ios_dump_args_init (struct ios_dump_args *args, ios_dump_type_t type,
         return ret;
 }
 
+/* Adds up the per-cpu blocks into @sum.  The latency minima and maxima of
+ * the blocks are taken over (and reset) so that they always cover the time
+ * since the previous call.
+ */
+static void
+ios_stats_blocks_sum (struct ios_conf *conf, struct ios_stats_block *sum,
+                      struct ios_lat_hist *hists)
+{
+        struct ios_stats_block *block = NULL;
+        uint64_t                min   = 0;
+        uint64_t                max   = 0;
+        int                     b     = 0;
+        int                     i     = 0;
+        int                     j     = 0;
+
+        memset (sum, 0, sizeof (*sum));
+        sum->latency_hist = hists;
+
+        for (b = 0; b < conf->block_count; b++) {
+                block = &conf->blocks[b];
+
+                sum->data_written += block->data_written;
+                sum->data_read    += block->data_read;
+                for (i = 0; i < 32; i++) {
+                        sum->block_count_write[i] += block->block_count_write[i];
+                        sum->block_count_read[i]  += block->block_count_read[i];
+                }
+
+                for (i = 0; i < GF_FOP_MAXVALUE; i++) {
+                        sum->fop_hits[i]    += block->fop_hits[i];
+                        sum->latency_sum[i] += block->latency_sum[i];
+                        for (j = 0; hists && block->latency_hist &&
+                                    j < IOS_LAT_BUCKETS; j++)
+                                hists[i].buckets[j] +=
+                                        block->latency_hist[i].buckets[j];
+
+                        min = __sync_lock_test_and_set
+                                (&block->latency_min[i], 0);
+                        max = __sync_lock_test_and_set
+                                (&block->latency_max[i], 0);
+                        if (min && (!sum->latency_min[i] ||
+                                    min < sum->latency_min[i]))
+                                sum->latency_min[i] = min;
+                        if (max > sum->latency_max[i])
+                                sum->latency_max[i] = max;
+                }
+        }
+}
+
+#define IOS_DELTA(now, prev, field)                                     \
+        ((prev) ? (now)->field - (prev)->field : (now)->field)
+
+#define IOS_HIST_DELTA(now, prev, i, j)                                 \
+        (((prev) && (prev)->latency_hist) ?                             \
+         (now)->latency_hist[i].buckets[j] -                            \
+         (prev)->latency_hist[i].buckets[j] :                           \
+         (now)->latency_hist[i].buckets[j])
+
+/* sets the counters of @stats (and the histograms in @hists, if any) to
+ * @now - @prev (just @now if @prev is NULL) and folds the latency extremes
+ * of @now into those already in @stats */
+static void
+ios_global_stats_fill (struct ios_global_stats *stats,
+                       struct ios_lat_hist *hists,
+                       struct ios_stats_block *now,
+                       struct ios_stats_block *prev)
+{
+        struct ios_lat *lat  = NULL;
+        uint64_t        hits = 0;
+        int             i    = 0;
+        int             j    = 0;
+
+        stats->data_written = IOS_DELTA (now, prev, data_written);
+        stats->data_read    = IOS_DELTA (now, prev, data_read);
+        for (i = 0; i < 32; i++) {
+                stats->block_count_write[i] =
+                        IOS_DELTA (now, prev, block_count_write[i]);
+                stats->block_count_read[i] =
+                        IOS_DELTA (now, prev, block_count_read[i]);
+        }
+
+        for (i = 0; i < GF_FOP_MAXVALUE; i++) {
+                hits = IOS_DELTA (now, prev, fop_hits[i]);
+                stats->fop_hits[i] = hits;
+
+                for (j = 0; hists && now->latency_hist &&
+                            j < IOS_LAT_BUCKETS; j++)
+                        hists[i].buckets[j] = IOS_HIST_DELTA (now, prev,
+                                                              i, j);
+
+                lat = &stats->latency[i];
+                lat->avg = hits ? (double) IOS_DELTA (now, prev,
+                                                      latency_sum[i]) / hits
+                                : 0;
+                if (now->latency_min[i] &&
+                    (!lat->min || now->latency_min[i] < lat->min))
+                        lat->min = now->latency_min[i];
+                if (now->latency_max[i] > lat->max)
+                        lat->max = now->latency_max[i];
+        }
+}
+
 int
 io_stats_dump (xlator_t *this, struct ios_dump_args *args)
 {
         struct ios_conf         *conf = NULL;
-        struct ios_global_stats  cumulative = {0, };
-        struct ios_global_stats  incremental = {0, };
+        struct ios_global_stats *cumulative = NULL;
+        struct ios_global_stats *incremental = NULL;
+        struct ios_stats_block  *sum = NULL;
+        struct ios_lat_hist     *hists = NULL;
+        struct ios_lat_hist     *last_hists = NULL;
         int                      increment = 0;
         struct timeval           now;
 
@@ -945,11 +1368,42 @@ io_stats_dump (xlator_t *this, struct ios_dump_args *args)
 
         conf = this->private;
 
+        cumulative = GF_MALLOC (sizeof (*cumulative),
+                                gf_io_stats_mt_ios_global_stats);
+        incremental = GF_MALLOC (sizeof (*incremental),
+                                 gf_io_stats_mt_ios_global_stats);
+        sum = GF_MALLOC (sizeof (*sum), gf_io_stats_mt_ios_stats_block);
+        if (!cumulative || !incremental || !sum)
+                goto out;
+
+        /* the cumulative histograms followed by the incremental ones; the
+           blocks only get theirs once latency-measurement is on, and keep
+           them from then on */
+        if (conf->lat_hists) {
+                hists = GF_CALLOC (2 * GF_FOP_MAXVALUE, sizeof (*hists),
+                                   gf_io_stats_mt_ios_lat_hist);
+                if (!hists)
+                        goto out;
+        }
+
         gettimeofday (&now, NULL);
         LOCK (&conf->lock);
         {
-                cumulative  = conf->cumulative;
-                incremental = conf->incremental;
+                ios_stats_blocks_sum (conf, sum, hists);
+                ios_global_stats_fill (&conf->cumulative, NULL, sum, NULL);
+                ios_global_stats_fill (&conf->incremental,
+                                       hists ? hists + GF_FOP_MAXVALUE : NULL,
+                                       sum, &conf->last_dump);
+
+                last_hists = conf->last_dump.latency_hist;
+                conf->last_dump = *sum;
+                conf->last_dump.latency_hist = last_hists;
+                if (last_hists && hists)
+                        memcpy (last_hists, hists,
+                                GF_FOP_MAXVALUE * sizeof (*hists));
+
+                *cumulative  = conf->cumulative;
+                *incremental = conf->incremental;
 
                 increment = conf->increment++;
 
@@ -958,8 +1412,17 @@ io_stats_dump (xlator_t *this, struct ios_dump_args *args)
         }
         UNLOCK (&conf->lock);
 
-        io_stats_dump_global (this, &cumulative, &now, -1, args);
-        io_stats_dump_global (this, &incremental, &now, increment, args);
+        io_stats_dump_global (this, cumulative, hists, &now, -1, args);
+        io_stats_dump_global (this, incremental,
+                              hists ? hists + GF_FOP_MAXVALUE : NULL,
+                              &now, increment, args);
+
+        io_stats_dump_clients (this, args);
+out:
+        GF_FREE (cumulative);
+        GF_FREE (incremental);
+        GF_FREE (sum);
+        GF_FREE (hists);
 
         return 0;
 }
@@ -1031,40 +1494,180 @@ io_stats_dump_fd (xlator_t *this, struct ios_fd *iosfd)
 }
 
 static void
-update_ios_latency_stats (struct ios_global_stats   *stats, double elapsed,
-                          glusterfs_fop_t op)
+ios_lat_update (struct ios_lat *lat, uint64_t hits, double elapsed)
 {
         double avg;
 
-        GF_ASSERT (stats);
+        if (!lat->min)
+                lat->min = elapsed;
+        if (lat->min > elapsed)
+                lat->min = elapsed;
+        if (lat->max < elapsed)
+                lat->max = elapsed;
+
+        avg = lat->avg;
+
+        lat->avg = avg + (elapsed - avg) / hits;
+}
+
+static void
+update_ios_latency_stats (struct ios_stats_block *block, uint64_t elapsed,
+                          int bucket, glusterfs_fop_t op)
+{
+        struct ios_lat_hist *hists = NULL;
+        uint64_t             cur   = 0;
+
+        __sync_fetch_and_add (&block->latency_sum[op], elapsed);
+
+        /* still NULL if latency-measurement was only just turned on */
+        hists = block->latency_hist;
+        if (hists)
+                __sync_fetch_and_add (&hists[op].buckets[bucket], 1);
+
+        cur = block->latency_max[op];
+        while (elapsed > cur) {
+                if (__sync_bool_compare_and_swap (&block->latency_max[op],
+                                                  cur, elapsed))
+                        break;
+                cur = block->latency_max[op];
+        }
+
+        cur = block->latency_min[op];
+        while (!cur || elapsed < cur) {
+                if (__sync_bool_compare_and_swap (&block->latency_min[op],
+                                                  cur, elapsed))
+                        break;
+                cur = block->latency_min[op];
+        }
+}
+
+static void
+__ios_client_free (struct ios_client *client)
+{
+        int i = 0;
+
+        for (i = 0; i < GF_FOP_MAXVALUE; i++)
+                GF_FREE (client->latency_hist[i]);
+        GF_FREE (client->id);
+        GF_FREE (client);
+}
+
+/* called with conf->lock held */
+static struct ios_client *
+__ios_client_get (xlator_t *this, struct ios_conf *conf, const char *id)
+{
+        struct ios_client *client = NULL;
+
+        list_for_each_entry (client, &conf->clients, list) {
+                if (strcmp (client->id, id) == 0) {
+                        /* keep the busy clients at the front */
+                        list_move (&client->list, &conf->clients);
+                        return client;
+                }
+        }
+
+        /* connections come and go over the life of a brick, the one idle
+           the longest makes room for the new one */
+        if (conf->client_count >= IOS_MAX_CLIENTS) {
+                client = list_entry (conf->clients.prev, struct ios_client,
+                                     list);
+                list_del (&client->list);
+                conf->client_count--;
+
+                gf_log (this->name, GF_LOG_DEBUG, "dropping latency stats "
+                        "of idle client %s", client->id);
+                __ios_client_free (client);
+        }
+
+        client = GF_CALLOC (1, sizeof (*client), gf_io_stats_mt_ios_client);
+        if (!client)
+                return NULL;
+
+        client->id = gf_strdup (id);
+        if (!client->id) {
+                GF_FREE (client);
+                return NULL;
+        }
 
-        if (!stats->latency[op].min)
-                stats->latency[op].min = elapsed;
-        if (stats->latency[op].min > elapsed)
-                stats->latency[op].min = elapsed;
-        if (stats->latency[op].max < elapsed)
-                stats->latency[op].max = elapsed;
+        list_add (&client->list, &conf->clients);
+        conf->client_count++;
 
-        avg = stats->latency[op].avg;
+        gf_log (this->name, GF_LOG_DEBUG, "tracking latency of client %s",
+                id);
 
-        stats->latency[op].avg = avg + (elapsed - avg) / stats->fop_hits[op];
+        return client;
+}
+
+/* called with conf->lock held */
+static void
+__update_ios_client_latency (xlator_t *this, struct ios_conf *conf,
+                             const char *id, double elapsed, int bucket,
+                             glusterfs_fop_t op)
+{
+        struct ios_client   *client = NULL;
+        struct ios_lat_hist *hist   = NULL;
+
+        client = __ios_client_get (this, conf, id);
+        if (!client)
+                return;
+
+        hist = client->latency_hist[op];
+        if (!hist) {
+                hist = GF_CALLOC (1, sizeof (*hist),
+                                  gf_io_stats_mt_ios_lat_hist);
+                if (!hist)
+                        return;
+                client->latency_hist[op] = hist;
+        }
+
+        client->fop_hits[op]++;
+        ios_lat_update (&client->latency[op], client->fop_hits[op], elapsed);
+        hist->buckets[bucket]++;
+}
+
+static void
+ios_clients_destroy (struct ios_conf *conf)
+{
+        struct ios_client *client = NULL;
+        struct ios_client *tmp    = NULL;
+
+        list_for_each_entry_safe (client, tmp, &conf->clients, list) {
+                list_del (&client->list);
+                __ios_client_free (client);
+        }
+        conf->client_count = 0;
 }
 
 int
-update_ios_latency (struct ios_conf *conf, call_frame_t *frame,
-                    glusterfs_fop_t op)
+update_ios_latency (xlator_t *this, struct ios_conf *conf,
+                    call_frame_t *frame, glusterfs_fop_t op)
 {
         double elapsed;
         struct timeval *begin, *end;
+        int    bucket = 0;
 
         begin = &frame->begin;
         end   = &frame->end;
 
         elapsed = (end->tv_sec - begin->tv_sec) * 1e6
                 + (end->tv_usec - begin->tv_usec);
+        if (elapsed < 0)
+                elapsed = 0;
+
+        bucket = ios_lat_bucket ((uint64_t) elapsed);
+
+        update_ios_latency_stats (ios_stats_block_get (conf),
+                                  (uint64_t) elapsed, bucket, op);
 
-        update_ios_latency_stats (&conf->cumulative, elapsed, op);
-        update_ios_latency_stats (&conf->incremental, elapsed, op);
+        if (conf->latency_per_client && frame->root->client_id) {
+                LOCK (&conf->lock);
+                {
+                        __update_ios_client_latency (this, conf,
+                                                     frame->root->client_id,
+                                                     elapsed, bucket, op);
+                }
+                UNLOCK (&conf->lock);
+        }
 
         return 0;
 }
@@ -2542,6 +3145,41 @@ ios_destroy_top_stats (struct ios_conf *conf)
         return;
 }
 
+/* The histograms are only allocated once latency-measurement gets turned
+ * on, and are kept until fini as the fop path picks them up without the
+ * lock.  The last GF_FOP_MAXVALUE ones belong to conf->last_dump.
+ */
+static int
+ios_lat_hists_init (xlator_t *this, struct ios_conf *conf)
+{
+        struct ios_lat_hist *hists = NULL;
+        int                  b     = 0;
+
+        if (conf->lat_hists)
+                return 0;
+
+        hists = GF_CALLOC ((conf->block_count + 1) * GF_FOP_MAXVALUE,
+                           sizeof (*hists), gf_io_stats_mt_ios_lat_hist);
+        if (!hists) {
+                gf_log (this->name, GF_LOG_ERROR,
+                        "Out of memory.");
+                return -1;
+        }
+
+        LOCK (&conf->lock);
+        {
+                conf->lat_hists = hists;
+                conf->last_dump.latency_hist =
+                        hists + conf->block_count * GF_FOP_MAXVALUE;
+                for (b = 0; b < conf->block_count; b++)
+                        conf->blocks[b].latency_hist =
+                                hists + b * GF_FOP_MAXVALUE;
+        }
+        UNLOCK (&conf->lock);
+
+        return 0;
+}
+
 int
 reconfigure (xlator_t *this, dict_t *options)
 {
@@ -2565,6 +3203,11 @@ reconfigure (xlator_t *this, dict_t *options)
 
         GF_OPTION_RECONF ("latency-measurement", conf->measure_latency,
                           options, bool, out);
+        if (conf->measure_latency && ios_lat_hists_init (this, conf))
+                goto out;
+
+        GF_OPTION_RECONF ("latency-per-client", conf->latency_per_client,
+                          options, bool, out);
 
         GF_OPTION_RECONF ("sys-log-level", sys_log_str, options, str, out);
         if (sys_log_str) {
@@ -2640,6 +3283,22 @@ init (xlator_t *this)
         }
 
         LOCK_INIT (&conf->lock);
+        INIT_LIST_HEAD (&conf->clients);
+
+        conf->block_count = sysconf (_SC_NPROCESSORS_CONF);
+        if (conf->block_count < 1)
+                conf->block_count = 1;
+        if (conf->block_count > IOS_MAX_STATS_BLOCKS)
+                conf->block_count = IOS_MAX_STATS_BLOCKS;
+
+        conf->blocks = GF_CALLOC (conf->block_count, sizeof (*conf->blocks),
+                                  gf_io_stats_mt_ios_stats_block);
+        if (!conf->blocks) {
+                gf_log (this->name, GF_LOG_ERROR,
+                        "Out of memory.");
+                GF_FREE (conf);
+                return -1;
+        }
 
         gettimeofday (&conf->cumulative.started_at, NULL);
         gettimeofday (&conf->incremental.started_at, NULL);
@@ -2654,6 +3313,14 @@ init (xlator_t *this)
 
         GF_OPTION_INIT ("latency-measurement", conf->measure_latency,
                           bool, out);
+        if (conf->measure_latency) {
+                ret = ios_lat_hists_init (this, conf);
+                if (ret)
+                        goto out;
+        }
+
+        GF_OPTION_INIT ("latency-per-client", conf->latency_per_client,
+                        bool, out);
 
         GF_OPTION_INIT ("sys-log-level", sys_log_str, str, out);
         if (sys_log_str) {
@@ -2689,6 +3356,9 @@ fini (xlator_t *this)
         this->private = NULL;
 
         ios_destroy_top_stats (conf);
+        ios_clients_destroy (conf);
+        GF_FREE (conf->blocks);
+        GF_FREE (conf->lat_hists);
 
         if (conf)
                 GF_FREE(conf);
@@ -2846,6 +3516,13 @@ struct volume_options options[] = {
         { .key  = {"count-fop-hits"},
           .type = GF_OPTION_TYPE_BOOL,
         },
+        { .key  = {"latency-per-client"},
+          .type = GF_OPTION_TYPE_BOOL,
+          .default_value = "off",
+          .description = "If on, latency histograms are also kept for each "
+                         "client (up to 64 of them) that sends fops through "
+                         "the brick."
+        },
         { .key = {"log-level"},
           .type = GF_OPTION_TYPE_STR,
           .value = { "DEBUG", "WARNING", "ERROR", "INFO",
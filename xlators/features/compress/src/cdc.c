@@ -0,0 +1,1140 @@
+/*
+  Copyright (c) 2012 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+/*
+ * cdc: compresses writev payloads and readv replies on the wire.
+ *
+ * Loaded twice, in "client" mode right above protocol/client and in
+ * "server" mode below protocol/server.  The client offers compression in
+ * the xdata of its lookups and only starts using it once the brick side
+ * answered, so a brick without cdc just sees the plain stream.
+ */
+
+#ifndef _CONFIG_H
+#define _CONFIG_H
+#include "config.h"
+#endif
+
+#include "cdc.h"
+#include "byte-order.h"
+#include "statedump.h"
+
+static void
+cdc_stream_end (cdc_stream_t *stream)
+{
+        if (stream->def_ok)
+                deflateEnd (&stream->def);
+        if (stream->inf_ok)
+                inflateEnd (&stream->inf);
+
+        GF_FREE (stream);
+}
+
+
+/* a thread went away, fini takes care of the streams of those left */
+static void
+cdc_stream_destroy (void *data)
+{
+        cdc_stream_t *stream = data;
+
+        if (!stream)
+                return;
+
+        pthread_mutex_lock (&stream->priv->lock);
+        {
+                list_del_init (&stream->list);
+        }
+        pthread_mutex_unlock (&stream->priv->lock);
+
+        cdc_stream_end (stream);
+}
+
+
+static cdc_stream_t *
+cdc_stream_get (cdc_priv_t *priv)
+{
+        cdc_stream_t *stream = NULL;
+
+        stream = pthread_getspecific (priv->stream_key);
+        if (!stream) {
+                stream = GF_CALLOC (1, sizeof (*stream), gf_cdc_mt_stream_t);
+                if (!stream)
+                        return NULL;
+
+                if (pthread_setspecific (priv->stream_key, stream) != 0) {
+                        GF_FREE (stream);
+                        return NULL;
+                }
+
+                stream->priv = priv;
+                pthread_mutex_lock (&priv->lock);
+                {
+                        list_add_tail (&stream->list, &priv->streams);
+                }
+                pthread_mutex_unlock (&priv->lock);
+        }
+
+        /* compression-level was reconfigured */
+        if (stream->def_ok && stream->level != priv->level) {
+                deflateEnd (&stream->def);
+                stream->def_ok = _gf_false;
+        }
+
+        return stream;
+}
+
+
+/* bytes [@off, @off + @len) of the payload */
+static void
+cdc_copy_range (struct iovec *vector, int count, size_t off, size_t len,
+                char *out)
+{
+        size_t n = 0;
+        int    i = 0;
+
+        for (i = 0; i < count && len; i++) {
+                if (off >= vector[i].iov_len) {
+                        off -= vector[i].iov_len;
+                        continue;
+                }
+
+                n = min (vector[i].iov_len - off, len);
+                memcpy (out, vector[i].iov_base + off, n);
+
+                out += n;
+                len -= n;
+                off = 0;
+        }
+}
+
+
+static int
+cdc_deflate_range (cdc_stream_t *stream, struct iovec *vector, int count,
+                   size_t off, size_t len, char *out, size_t cap,
+                   uint32_t *outlen)
+{
+        z_stream *zs  = &stream->def;
+        size_t    n   = 0;
+        int       ret = Z_OK;
+        int       i   = 0;
+
+        deflateReset (zs);
+
+        zs->next_out = (Bytef *) out;
+        zs->avail_out = cap;
+
+        for (i = 0; i < count && len; i++) {
+                if (off >= vector[i].iov_len) {
+                        off -= vector[i].iov_len;
+                        continue;
+                }
+
+                n = min (vector[i].iov_len - off, len);
+                zs->next_in = (Bytef *) vector[i].iov_base + off;
+                zs->avail_in = n;
+
+                len -= n;
+                off = 0;
+
+                ret = deflate (zs, len ? Z_NO_FLUSH : Z_FINISH);
+                if (ret != Z_OK && ret != Z_STREAM_END)
+                        return -1;
+
+                /* output full before the input is gone: does not pay */
+                if (zs->avail_in)
+                        return -1;
+        }
+
+        if (ret != Z_STREAM_END)
+                return -1;
+
+        *outlen = cap - zs->avail_out;
+
+        return 0;
+}
+
+
+static void
+cdc_compress_chunk (cdc_priv_t *priv, cdc_stream_t *stream, cdc_job_t *job,
+                    int idx)
+{
+        size_t    off  = idx * job->chunk_size;
+        size_t    len  = min (job->chunk_size, job->size - off);
+        char     *out  = job->out + job->offs[idx];
+        uint32_t  clen = 0;
+
+        if (stream && !stream->def_ok) {
+                memset (&stream->def, 0, sizeof (stream->def));
+                /* raw deflate, the framing is ours */
+                if (deflateInit2 (&stream->def, priv->level, Z_DEFLATED, -15,
+                                  8, Z_DEFAULT_STRATEGY) == Z_OK) {
+                        stream->def_ok = _gf_true;
+                        stream->level = priv->level;
+                }
+        }
+
+        if (stream && stream->def_ok &&
+            cdc_deflate_range (stream, job->in, job->in_count, off, len, out,
+                               len - (len >> CDC_MIN_GAIN_SHIFT),
+                               &clen) == 0) {
+                job->lens[idx] = clen;
+                return;
+        }
+
+        cdc_copy_range (job->in, job->in_count, off, len, out);
+        job->lens[idx] = len | CDC_CHUNK_RAW;
+}
+
+
+static int
+cdc_decompress_chunk (cdc_stream_t *stream, cdc_job_t *job, int idx)
+{
+        size_t    off  = idx * job->chunk_size;
+        size_t    len  = min (job->chunk_size, job->size - off);
+        char     *in   = job->src + job->offs[idx];
+        uint32_t  clen = job->lens[idx] & ~CDC_CHUNK_RAW;
+        z_stream *zs   = NULL;
+
+        if (job->lens[idx] & CDC_CHUNK_RAW) {
+                if (clen != len)
+                        return -1;
+                memcpy (job->out + off, in, len);
+                return 0;
+        }
+
+        if (!stream)
+                return -1;
+
+        zs = &stream->inf;
+        if (!stream->inf_ok) {
+                memset (zs, 0, sizeof (*zs));
+                if (inflateInit2 (zs, -15) != Z_OK)
+                        return -1;
+                stream->inf_ok = _gf_true;
+        }
+
+        inflateReset (zs);
+
+        zs->next_in = (Bytef *) in;
+        zs->avail_in = clen;
+        zs->next_out = (Bytef *) job->out + off;
+        zs->avail_out = len;
+
+        if (inflate (zs, Z_FINISH) != Z_STREAM_END || zs->avail_out)
+                return -1;
+
+        return 0;
+}
+
+
+/* takes chunks of @job until none is left, returns how many */
+static int
+cdc_job_run (cdc_priv_t *priv, cdc_job_t *job)
+{
+        cdc_stream_t *stream = NULL;
+        int           idx    = 0;
+        int           n      = 0;
+
+        stream = cdc_stream_get (priv);
+
+        while ((idx = __sync_fetch_and_add (&job->next, 1)) < job->count) {
+                if (job->compress)
+                        cdc_compress_chunk (priv, stream, job, idx);
+                else if (cdc_decompress_chunk (stream, job, idx))
+                        job->failed = 1;
+                n++;
+        }
+
+        return n;
+}
+
+
+/* the caller works on its own job too, the pool only helps out: a busy
+   pool never holds up a request */
+static int
+cdc_job_exec (cdc_priv_t *priv, cdc_job_t *job)
+{
+        gf_boolean_t shared = _gf_false;
+        int          n      = 0;
+
+        INIT_LIST_HEAD (&job->list);
+
+        if (job->count > 1 && priv->thread_count) {
+                pthread_mutex_lock (&priv->lock);
+                {
+                        list_add_tail (&job->list, &priv->jobs);
+                        pthread_cond_broadcast (&priv->work_cond);
+                }
+                pthread_mutex_unlock (&priv->lock);
+                shared = _gf_true;
+        }
+
+        n = cdc_job_run (priv, job);
+
+        if (shared) {
+                pthread_mutex_lock (&priv->lock);
+                {
+                        job->done += n;
+                        while (job->done < job->count || job->helpers)
+                                pthread_cond_wait (&priv->done_cond,
+                                                   &priv->lock);
+                        list_del_init (&job->list);
+                }
+                pthread_mutex_unlock (&priv->lock);
+        }
+
+        return job->failed ? -1 : 0;
+}
+
+
+static void *
+cdc_worker (void *data)
+{
+        xlator_t     *this = NULL;
+        cdc_priv_t   *priv = NULL;
+        cdc_job_t    *job  = NULL;
+        cdc_job_t    *tmp  = NULL;
+        int           n    = 0;
+
+        this = data;
+        THIS = this;
+        priv = this->private;
+
+        pthread_mutex_lock (&priv->lock);
+        while (!priv->fini) {
+                /* ->next is only a hint here, cdc_job_run takes the
+                   chunks atomically */
+                job = NULL;
+                list_for_each_entry (tmp, &priv->jobs, list) {
+                        if (tmp->next < tmp->count) {
+                                job = tmp;
+                                break;
+                        }
+                }
+
+                if (!job) {
+                        pthread_cond_wait (&priv->work_cond, &priv->lock);
+                        continue;
+                }
+
+                job->helpers++;
+                pthread_mutex_unlock (&priv->lock);
+
+                n = cdc_job_run (priv, job);
+
+                pthread_mutex_lock (&priv->lock);
+                job->done += n;
+                job->helpers--;
+                if (job->done == job->count && !job->helpers)
+                        pthread_cond_broadcast (&priv->done_cond);
+        }
+        pthread_mutex_unlock (&priv->lock);
+
+        return NULL;
+}
+
+
+static gf_boolean_t
+cdc_skip (cdc_priv_t *priv)
+{
+        if (priv->skip <= 0)
+                return _gf_false;
+
+        __sync_fetch_and_sub (&priv->skip, 1);
+        __sync_fetch_and_add (&priv->stats.skipped, 1);
+
+        return _gf_true;
+}
+
+
+static void
+cdc_miss (cdc_priv_t *priv)
+{
+        priv->skip = CDC_SKIP_AFTER_MISS;
+        __sync_fetch_and_add (&priv->stats.skipped, 1);
+}
+
+
+/* returns the compressed payload in a new iobuf, -1 if it did not pay */
+static int
+cdc_compress (xlator_t *this, cdc_priv_t *priv, struct iovec *vector,
+              int count, struct iobuf **iobuf_p, size_t *len_p)
+{
+        struct iobuf *iobuf  = NULL;
+        cdc_job_t     job    = {{0, }, };
+        size_t        size   = 0;
+        size_t        table  = 0;
+        size_t        pos    = 0;
+        uint32_t      clen   = 0;
+        char         *out    = NULL;
+        int           raw    = 0;
+        int           i      = 0;
+        int           ret    = -1;
+
+        size = iov_length (vector, count);
+
+        job.compress = _gf_true;
+        job.chunk_size = priv->chunk_size;
+        job.size = size;
+        job.count = (size + job.chunk_size - 1) / job.chunk_size;
+        job.in = vector;
+        job.in_count = count;
+
+        if (!job.count || job.count > CDC_MAX_CHUNKS)
+                goto out;
+
+        table = CDC_HDR_SIZE + (job.count * sizeof (uint32_t));
+
+        iobuf = iobuf_get2 (this->ctx->iobuf_pool, table + size);
+        if (!iobuf)
+                goto out;
+
+        job.offs = GF_CALLOC (job.count, sizeof (*job.offs) +
+                              sizeof (*job.lens), gf_cdc_mt_chunk_t);
+        if (!job.offs)
+                goto out;
+        job.lens = (uint32_t *)(job.offs + job.count);
+
+        out = iobuf_ptr (iobuf);
+        job.out = out;
+
+        /* every chunk gets a slot it fits in uncompressed ... */
+        for (i = 0; i < job.count; i++)
+                job.offs[i] = table + (i * job.chunk_size);
+
+        cdc_job_exec (priv, &job);
+
+        /* ... and they are packed afterwards */
+        pos = table;
+        for (i = 0; i < job.count; i++) {
+                clen = job.lens[i] & ~CDC_CHUNK_RAW;
+                if (job.lens[i] & CDC_CHUNK_RAW)
+                        raw++;
+
+                if (job.offs[i] != pos)
+                        memmove (out + pos, out + job.offs[i], clen);
+                pos += clen;
+
+                *(uint32_t *)(out + CDC_HDR_SIZE + (i * sizeof (uint32_t)))
+                        = hton32 (job.lens[i]);
+        }
+
+        __sync_fetch_and_add (&priv->stats.raw_chunks, raw);
+
+        if (pos > size - (size >> CDC_MIN_GAIN_SHIFT))
+                goto out;
+
+        *(uint32_t *)(out) = hton32 (CDC_MAGIC);
+        out[4] = CDC_VERSION;
+        out[5] = CDC_CODEC_DEFLATE;
+        *(uint16_t *)(out + 6) = hton16 (job.count);
+        *(uint32_t *)(out + 8) = hton32 (size);
+        *(uint32_t *)(out + 12) = hton32 (job.chunk_size);
+
+        __sync_fetch_and_add (&priv->stats.compressed, 1);
+        __sync_fetch_and_add (&priv->stats.bytes_in, size);
+        __sync_fetch_and_add (&priv->stats.bytes_out, pos);
+
+        *iobuf_p = iobuf;
+        *len_p = pos;
+        iobuf = NULL;
+        ret = 0;
+out:
+        if (iobuf)
+                iobuf_unref (iobuf);
+        GF_FREE (job.offs);
+
+        return ret;
+}
+
+
+/* @max_size bounds what the header may claim, it comes from the peer */
+static int
+cdc_decompress (xlator_t *this, cdc_priv_t *priv, struct iovec *vector,
+                int count, size_t max_size, struct iobuf **iobuf_p,
+                size_t *len_p)
+{
+        struct iobuf *iobuf  = NULL;
+        struct iobuf *flat   = NULL;
+        cdc_job_t     job    = {{0, }, };
+        char         *in     = NULL;
+        size_t        len    = 0;
+        size_t        table  = 0;
+        size_t        pos    = 0;
+        uint32_t      clen   = 0;
+        int           i      = 0;
+        int           ret    = -1;
+
+        len = iov_length (vector, count);
+
+        /* it only went compressed if it shrank */
+        if (len >= max_size)
+                goto corrupt;
+
+        if (count == 1) {
+                in = vector[0].iov_base;
+        } else {
+                flat = iobuf_get2 (this->ctx->iobuf_pool, len);
+                if (!flat)
+                        goto out;
+                in = iobuf_ptr (flat);
+                iov_unload (in, vector, count);
+        }
+
+        if (len < CDC_HDR_SIZE ||
+            ntoh32 (*(uint32_t *)in) != CDC_MAGIC ||
+            in[4] != CDC_VERSION || in[5] != CDC_CODEC_DEFLATE) {
+                gf_log (this->name, GF_LOG_ERROR,
+                        "compressed payload with unknown format");
+                goto out;
+        }
+
+        job.compress = _gf_false;
+        job.count = ntoh16 (*(uint16_t *)(in + 6));
+        job.size = ntoh32 (*(uint32_t *)(in + 8));
+        job.chunk_size = ntoh32 (*(uint32_t *)(in + 12));
+        job.src = in;
+
+        table = CDC_HDR_SIZE + (job.count * sizeof (uint32_t));
+
+        if (!job.count || job.count > CDC_MAX_CHUNKS ||
+            job.chunk_size < CDC_MIN_CHUNK_SIZE ||
+            job.chunk_size > CDC_MAX_CHUNK_SIZE ||
+            job.size > max_size ||
+            len > job.size - (job.size >> CDC_MIN_GAIN_SHIFT) ||
+            (job.size + job.chunk_size - 1) / job.chunk_size != job.count ||
+            table > len)
+                goto corrupt;
+
+        job.offs = GF_CALLOC (job.count, sizeof (*job.offs) +
+                              sizeof (*job.lens), gf_cdc_mt_chunk_t);
+        if (!job.offs)
+                goto out;
+        job.lens = (uint32_t *)(job.offs + job.count);
+
+        pos = table;
+        for (i = 0; i < job.count; i++) {
+                job.lens[i] = ntoh32 (*(uint32_t *)(in + CDC_HDR_SIZE +
+                                                    (i * sizeof (uint32_t))));
+                clen = job.lens[i] & ~CDC_CHUNK_RAW;
+                if (clen > len - pos)
+                        goto corrupt;
+
+                job.offs[i] = pos;
+                pos += clen;
+        }
+
+        if (pos != len)
+                goto corrupt;
+
+        iobuf = iobuf_get2 (this->ctx->iobuf_pool, job.size);
+        if (!iobuf)
+                goto out;
+        job.out = iobuf_ptr (iobuf);
+
+        if (cdc_job_exec (priv, &job))
+                goto corrupt;
+
+        __sync_fetch_and_add (&priv->stats.decompressed, 1);
+
+        *iobuf_p = iobuf;
+        *len_p = job.size;
+        iobuf = NULL;
+        ret = 0;
+        goto out;
+
+corrupt:
+        gf_log (this->name, GF_LOG_ERROR, "corrupt compressed payload");
+out:
+        if (ret)
+                __sync_fetch_and_add (&priv->stats.errors, 1);
+        if (iobuf)
+                iobuf_unref (iobuf);
+        if (flat)
+                iobuf_unref (flat);
+        GF_FREE (job.offs);
+
+        return ret;
+}
+
+
+int32_t
+cdc_lookup_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                int32_t op_ret, int32_t op_errno, inode_t *inode,
+                struct iatt *buf, dict_t *xdata, struct iatt *postparent)
+{
+        cdc_priv_t *priv  = NULL;
+        dict_t     *rsp   = NULL;
+        int32_t     codec = 0;
+
+        priv = this->private;
+
+        if (!cookie)
+                goto unwind;
+
+        if (priv->server) {
+                if (!xdata)
+                        xdata = rsp = dict_new ();
+                if (xdata &&
+                    dict_set_int32 (xdata, CDC_HELLO_KEY, CDC_CODEC_DEFLATE))
+                        gf_log (this->name, GF_LOG_DEBUG,
+                                "failed to answer the compression offer");
+        } else if (xdata &&
+                   dict_get_int32 (xdata, CDC_HELLO_KEY, &codec) == 0) {
+                dict_del (xdata, CDC_HELLO_KEY);
+                if (codec == CDC_CODEC_DEFLATE && !priv->peer_ok) {
+                        gf_log (this->name, GF_LOG_INFO,
+                                "compressing the traffic with %s",
+                                FIRST_CHILD (this)->name);
+                        priv->peer_ok = 1;
+                }
+        }
+
+unwind:
+        STACK_UNWIND_STRICT (lookup, frame, op_ret, op_errno, inode, buf,
+                             xdata, postparent);
+
+        if (rsp)
+                dict_unref (rsp);
+
+        return 0;
+}
+
+
+int32_t
+cdc_lookup (call_frame_t *frame, xlator_t *this, loc_t *loc, dict_t *xdata)
+{
+        cdc_priv_t *priv  = NULL;
+        dict_t     *req   = NULL;
+        long        hello = 0;
+
+        priv = this->private;
+
+        if (priv->server) {
+                /* not an xattr the brick should go and fetch */
+                if (xdata && dict_get (xdata, CDC_HELLO_KEY)) {
+                        dict_del (xdata, CDC_HELLO_KEY);
+                        hello = 1;
+                }
+        } else if (!priv->peer_ok) {
+                req = xdata ? dict_copy_with_ref (xdata, NULL) : dict_new ();
+                if (req && dict_set_int32 (req, CDC_HELLO_KEY,
+                                           CDC_CODEC_DEFLATE) == 0)
+                        hello = 1;
+        }
+
+        STACK_WIND_COOKIE (frame, cdc_lookup_cbk, (void *) hello,
+                           FIRST_CHILD (this), FIRST_CHILD (this)->fops->lookup,
+                           loc, req ? req : xdata);
+
+        if (req)
+                dict_unref (req);
+
+        return 0;
+}
+
+
+int32_t
+cdc_readv_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+               int32_t op_ret, int32_t op_errno, struct iovec *vector,
+               int32_t count, struct iatt *stbuf, struct iobref *iobref,
+               dict_t *xdata)
+{
+        cdc_priv_t    *priv       = NULL;
+        struct iobuf  *iobuf      = NULL;
+        struct iobref *new_iobref = NULL;
+        dict_t        *rsp        = NULL;
+        struct iovec   iov        = {0, };
+        size_t         len        = 0;
+
+        priv = this->private;
+
+        if (op_ret <= 0 || !cookie)
+                goto unwind;
+
+        if (priv->server) {
+                if (op_ret < priv->min_size || op_ret > CDC_MAX_SIZE ||
+                    cdc_skip (priv))
+                        goto unwind;
+
+                if (cdc_compress (this, priv, vector, count, &iobuf, &len)) {
+                        cdc_miss (priv);
+                        goto unwind;
+                }
+
+                if (!xdata)
+                        xdata = rsp = dict_new ();
+                if (!xdata ||
+                    dict_set_int32 (xdata, CDC_PAYLOAD_KEY,
+                                    CDC_CODEC_DEFLATE) != 0)
+                        goto unwind;
+        } else {
+                if (!xdata || !dict_get (xdata, CDC_PAYLOAD_KEY))
+                        goto unwind;
+
+                dict_del (xdata, CDC_PAYLOAD_KEY);
+
+                /* the cookie is the size asked for */
+                if (cdc_decompress (this, priv, vector, count,
+                                    (size_t)(long) cookie, &iobuf, &len)) {
+                        op_ret = -1;
+                        op_errno = EIO;
+                        goto unwind;
+                }
+        }
+
+        new_iobref = iobref_new ();
+        if (!new_iobref) {
+                if (!priv->server) {
+                        op_ret = -1;
+                        op_errno = ENOMEM;
+                }
+                goto unwind;
+        }
+        iobref_add (new_iobref, iobuf);
+
+        iov.iov_base = iobuf_ptr (iobuf);
+        iov.iov_len = len;
+
+        vector = &iov;
+        count = 1;
+        iobref = new_iobref;
+        op_ret = len;
+
+unwind:
+        if (op_ret == -1) {
+                vector = NULL;
+                count = 0;
+        }
+
+        STACK_UNWIND_STRICT (readv, frame, op_ret, op_errno, vector, count,
+                             stbuf, iobref, xdata);
+
+        if (iobuf)
+                iobuf_unref (iobuf);
+        if (new_iobref)
+                iobref_unref (new_iobref);
+        if (rsp)
+                dict_unref (rsp);
+
+        return 0;
+}
+
+
+int32_t
+cdc_readv (call_frame_t *frame, xlator_t *this, fd_t *fd, size_t size,
+           off_t offset, uint32_t flags, dict_t *xdata)
+{
+        cdc_priv_t *priv   = NULL;
+        dict_t     *req    = NULL;
+        long        cookie = 0;
+
+        priv = this->private;
+
+        if (priv->server) {
+                if (xdata && dict_get (xdata, CDC_ACCEPT_KEY)) {
+                        dict_del (xdata, CDC_ACCEPT_KEY);
+                        cookie = 1;
+                }
+        } else if (priv->peer_ok && size >= priv->min_size &&
+                   size <= CDC_MAX_SIZE) {
+                req = xdata ? dict_copy_with_ref (xdata, NULL) : dict_new ();
+                if (req && dict_set_int32 (req, CDC_ACCEPT_KEY,
+                                           CDC_CODEC_DEFLATE) == 0)
+                        cookie = size;
+        }
+
+        STACK_WIND_COOKIE (frame, cdc_readv_cbk, (void *) cookie,
+                           FIRST_CHILD (this), FIRST_CHILD (this)->fops->readv,
+                           fd, size, offset, flags, req ? req : xdata);
+
+        if (req)
+                dict_unref (req);
+
+        return 0;
+}
+
+
+int32_t
+cdc_writev (call_frame_t *frame, xlator_t *this, fd_t *fd,
+            struct iovec *vector, int32_t count, off_t offset,
+            uint32_t flags, struct iobref *iobref, dict_t *xdata)
+{
+        cdc_priv_t    *priv       = NULL;
+        struct iobuf  *iobuf      = NULL;
+        struct iobref *new_iobref = NULL;
+        dict_t        *req        = NULL;
+        struct iovec   iov        = {0, };
+        size_t         len        = 0;
+        int32_t        op_errno   = EIO;
+
+        priv = this->private;
+
+        if (priv->server) {
+                if (!xdata || !dict_get (xdata, CDC_PAYLOAD_KEY))
+                        goto wind;
+
+                dict_del (xdata, CDC_PAYLOAD_KEY);
+
+                if (cdc_decompress (this, priv, vector, count, CDC_MAX_SIZE,
+                                    &iobuf, &len))
+                        goto err;
+        } else {
+                len = iov_length (vector, count);
+                if (!priv->peer_ok || len < priv->min_size ||
+                    len > CDC_MAX_SIZE || cdc_skip (priv))
+                        goto wind;
+
+                if (cdc_compress (this, priv, vector, count, &iobuf, &len)) {
+                        cdc_miss (priv);
+                        goto wind;
+                }
+
+                req = xdata ? dict_copy_with_ref (xdata, NULL) : dict_new ();
+                if (!req || dict_set_int32 (req, CDC_PAYLOAD_KEY,
+                                            CDC_CODEC_DEFLATE) != 0)
+                        goto wind;
+                xdata = req;
+        }
+
+        new_iobref = iobref_new ();
+        if (!new_iobref) {
+                op_errno = ENOMEM;
+                goto err;
+        }
+        iobref_add (new_iobref, iobuf);
+
+        iov.iov_base = iobuf_ptr (iobuf);
+        iov.iov_len = len;
+
+        vector = &iov;
+        count = 1;
+        iobref = new_iobref;
+
+wind:
+        STACK_WIND (frame, default_writev_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->writev, fd, vector, count,
+                    offset, flags, iobref, xdata);
+        goto out;
+
+err:
+        STACK_UNWIND_STRICT (writev, frame, -1, op_errno, NULL, NULL, NULL);
+out:
+        if (iobuf)
+                iobuf_unref (iobuf);
+        if (new_iobref)
+                iobref_unref (new_iobref);
+        if (req)
+                dict_unref (req);
+
+        return 0;
+}
+
+
+int
+cdc_priv_dump (xlator_t *this)
+{
+        cdc_priv_t  *priv                            = NULL;
+        char         key_prefix[GF_DUMP_MAX_BUF_LEN] = {0, };
+
+        if (!this || !this->private)
+                goto out;
+
+        priv = this->private;
+        gf_proc_dump_build_key (key_prefix, "xlator.features.cdc", "priv");
+        gf_proc_dump_add_section (key_prefix);
+
+        gf_proc_dump_write ("mode", "%s", priv->server ? "server" : "client");
+        gf_proc_dump_write ("compression-level", "%d", priv->level);
+        gf_proc_dump_write ("min-size", "%"PRIu64, priv->min_size);
+        gf_proc_dump_write ("chunk-size", "%"PRIu64, priv->chunk_size);
+        gf_proc_dump_write ("threads", "%d", priv->thread_count);
+        if (!priv->server)
+                gf_proc_dump_write ("peer", "%s",
+                                    priv->peer_ok ? "yes" : "no");
+        gf_proc_dump_write ("compressed", "%"PRIu64, priv->stats.compressed);
+        gf_proc_dump_write ("skipped", "%"PRIu64, priv->stats.skipped);
+        gf_proc_dump_write ("decompressed", "%"PRIu64,
+                            priv->stats.decompressed);
+        gf_proc_dump_write ("raw-chunks", "%"PRIu64, priv->stats.raw_chunks);
+        gf_proc_dump_write ("bytes-in", "%"PRIu64, priv->stats.bytes_in);
+        gf_proc_dump_write ("bytes-out", "%"PRIu64, priv->stats.bytes_out);
+        gf_proc_dump_write ("errors", "%"PRIu64, priv->stats.errors);
+out:
+        return 0;
+}
+
+
+int
+notify (xlator_t *this, int event, void *data, ...)
+{
+        cdc_priv_t *priv = NULL;
+
+        priv = this->private;
+
+        /* the brick may come back without us */
+        if (priv && event == GF_EVENT_CHILD_DOWN)
+                priv->peer_ok = 0;
+
+        return default_notify (this, event, data);
+}
+
+
+int32_t
+mem_acct_init (xlator_t *this)
+{
+        int     ret = -1;
+
+        if (!this)
+                return ret;
+
+        ret = xlator_mem_acct_init (this, gf_cdc_mt_end + 1);
+
+        if (ret != 0) {
+                gf_log (this->name, GF_LOG_ERROR, "Memory accounting init "
+                        "failed");
+                return ret;
+        }
+
+        return ret;
+}
+
+
+static void
+cdc_threads_start (xlator_t *this, cdc_priv_t *priv, int count)
+{
+        int i = 0;
+
+        if (!count)
+                return;
+
+        priv->threads = GF_CALLOC (count, sizeof (*priv->threads),
+                                   gf_cdc_mt_threads_t);
+        if (!priv->threads) {
+                gf_log (this->name, GF_LOG_WARNING,
+                        "no memory for %d threads, running without", count);
+                return;
+        }
+
+        for (i = 0; i < count; i++) {
+                if (pthread_create (&priv->threads[i], NULL, cdc_worker,
+                                    this) != 0) {
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "could only start %d of %d threads (%s)", i,
+                                count, strerror (errno));
+                        break;
+                }
+        }
+
+        priv->thread_count = i;
+}
+
+
+/* jobs in flight are finished by the fops they belong to */
+static void
+cdc_threads_stop (cdc_priv_t *priv)
+{
+        int count = priv->thread_count;
+        int i     = 0;
+
+        priv->thread_count = 0;
+
+        pthread_mutex_lock (&priv->lock);
+        {
+                priv->fini = _gf_true;
+                pthread_cond_broadcast (&priv->work_cond);
+        }
+        pthread_mutex_unlock (&priv->lock);
+
+        for (i = 0; i < count; i++)
+                pthread_join (priv->threads[i], NULL);
+
+        pthread_mutex_lock (&priv->lock);
+        {
+                priv->fini = _gf_false;
+        }
+        pthread_mutex_unlock (&priv->lock);
+
+        GF_FREE (priv->threads);
+        priv->threads = NULL;
+}
+
+
+int
+reconfigure (xlator_t *this, dict_t *options)
+{
+        cdc_priv_t *priv    = NULL;
+        int         threads = 0;
+        int         ret     = -1;
+
+        priv = this->private;
+
+        GF_OPTION_RECONF ("compression-level", priv->level, options, int32,
+                          out);
+        GF_OPTION_RECONF ("min-size", priv->min_size, options, size, out);
+        GF_OPTION_RECONF ("chunk-size", priv->chunk_size, options, size, out);
+        GF_OPTION_RECONF ("threads", threads, options, int32, out);
+
+        if (threads != priv->thread_count) {
+                cdc_threads_stop (priv);
+                cdc_threads_start (this, priv, threads);
+                gf_log (this->name, GF_LOG_DEBUG, "now %d threads",
+                        priv->thread_count);
+        }
+
+        ret = 0;
+out:
+        return ret;
+}
+
+
+int32_t
+init (xlator_t *this)
+{
+        cdc_priv_t *priv    = NULL;
+        char       *mode    = NULL;
+        int         threads = 0;
+        int         ret     = -1;
+
+        if (!this->children || this->children->next) {
+                gf_log (this->name, GF_LOG_ERROR,
+                        "'cdc' not configured with exactly one child");
+                goto out;
+        }
+
+        if (!this->parents) {
+                gf_log (this->name, GF_LOG_WARNING,
+                        "dangling volume. check volfile ");
+        }
+
+        priv = GF_CALLOC (1, sizeof (*priv), gf_cdc_mt_priv_t);
+        if (!priv)
+                goto out;
+
+        pthread_mutex_init (&priv->lock, NULL);
+        pthread_cond_init (&priv->work_cond, NULL);
+        pthread_cond_init (&priv->done_cond, NULL);
+        INIT_LIST_HEAD (&priv->jobs);
+        INIT_LIST_HEAD (&priv->streams);
+
+        GF_OPTION_INIT ("mode", mode, str, out);
+        priv->server = (strcmp (mode, "server") == 0);
+
+        GF_OPTION_INIT ("compression-level", priv->level, int32, out);
+        GF_OPTION_INIT ("min-size", priv->min_size, size, out);
+        GF_OPTION_INIT ("chunk-size", priv->chunk_size, size, out);
+        GF_OPTION_INIT ("threads", threads, int32, out);
+
+        if (pthread_key_create (&priv->stream_key, cdc_stream_destroy)) {
+                gf_log (this->name, GF_LOG_ERROR,
+                        "failed to create the stream key");
+                goto out;
+        }
+
+        this->private = priv;
+
+        cdc_threads_start (this, priv, threads);
+
+        gf_log (this->name, GF_LOG_DEBUG,
+                "%s side, level %d, %d threads", mode, priv->level,
+                priv->thread_count);
+
+        ret = 0;
+out:
+        if (ret && priv) {
+                this->private = NULL;
+                GF_FREE (priv);
+        }
+
+        return ret;
+}
+
+
+void
+fini (xlator_t *this)
+{
+        cdc_priv_t   *priv   = NULL;
+        cdc_stream_t *stream = NULL;
+        cdc_stream_t *tmp    = NULL;
+
+        priv = this->private;
+        if (!priv)
+                return;
+
+        cdc_threads_stop (priv);
+
+        /* does not run the destructor in the threads still around */
+        pthread_key_delete (priv->stream_key);
+
+        list_for_each_entry_safe (stream, tmp, &priv->streams, list) {
+                list_del_init (&stream->list);
+                cdc_stream_end (stream);
+        }
+
+        this->private = NULL;
+        GF_FREE (priv);
+
+        return;
+}
+
+
+struct xlator_fops fops = {
+        .lookup = cdc_lookup,
+        .readv  = cdc_readv,
+        .writev = cdc_writev,
+};
+
+struct xlator_cbks cbks = {
+};
+
+struct xlator_dumpops dumpops = {
+        .priv = cdc_priv_dump,
+};
+
+struct volume_options options[] = {
+        { .key  = {"mode"},
+          .type = GF_OPTION_TYPE_STR,
+          .value = {"client", "server"},
+          .default_value = "client",
+          .description = "Which end of the connection this is: \"client\" "
+          "right above protocol/client, \"server\" below protocol/server."
+        },
+        { .key  = {"compression-level"},
+          .type = GF_OPTION_TYPE_INT,
+          .min  = 1,
+          .max  = 9,
+          .default_value = "1",
+          .description = "zlib compression level, 1 is the fastest."
+        },
+        { .key  = {"min-size"},
+          .type = GF_OPTION_TYPE_SIZET,
+          .min  = 512,
+          .max  = 1 * GF_UNIT_MB,
+          .default_value = "4KB",
+          .description = "Payloads below this size are sent as is."
+        },
+        { .key  = {"chunk-size"},
+          .type = GF_OPTION_TYPE_SIZET,
+          .min  = CDC_MIN_CHUNK_SIZE,
+          .max  = CDC_MAX_CHUNK_SIZE,
+          .default_value = "64KB",
+          .description = "Payloads are compressed in chunks of this size, "
+          "which are spread over the threads."
+        },
+        { .key  = {"threads"},
+          .type = GF_OPTION_TYPE_INT,
+          .min  = 0,
+          .max  = 16,
+          .default_value = "2",
+          .description = "Threads helping with payloads of more than one "
+          "chunk, besides the one the fop arrived on."
+        },
+        { .key  = {NULL} },
+};
@@ -0,0 +1,124 @@
+/*
+  Copyright (c) 2012 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+#ifndef __CDC_H__
+#define __CDC_H__
+
+#ifndef _CONFIG_H
+#define _CONFIG_H
+#include "config.h"
+#endif
+
+#include <zlib.h>
+
+#include "xlator.h"
+#include "defaults.h"
+#include "list.h"
+#include "cdc-mem-types.h"
+
+/*
+ * Compressed payload, all fields in network byte order:
+ *
+ *   uint32_t magic
+ *   uint8_t  version
+ *   uint8_t  codec
+ *   uint16_t chunk count
+ *   uint32_t uncompressed size
+ *   uint32_t chunk size
+ *   uint32_t compressed size of each chunk, CDC_CHUNK_RAW if stored as is
+ *   chunk data
+ *
+ * Every chunk is compressed on its own so that both ends can spread the
+ * work over threads.
+ */
+#define CDC_MAGIC              0x47434443 /* "GCDC" */
+#define CDC_VERSION            1
+#define CDC_CODEC_DEFLATE      1
+#define CDC_HDR_SIZE           16
+#define CDC_CHUNK_RAW          0x80000000U
+#define CDC_MAX_CHUNKS         1024
+#define CDC_MIN_CHUNK_SIZE     (4 * GF_UNIT_KB)
+#define CDC_MAX_CHUNK_SIZE     (1 * GF_UNIT_MB)
+/* the largest iobuf class, nothing bigger is compressed nor accepted */
+#define CDC_MAX_SIZE           (1 * GF_UNIT_MB)
+
+/* xdata keys between the two ends */
+#define CDC_PAYLOAD_KEY        "glusterfs.cdc.payload" /* codec of payload */
+#define CDC_ACCEPT_KEY         "glusterfs.cdc.accept"  /* reply may be */
+#define CDC_HELLO_KEY          "glusterfs.cdc.hello"   /* codecs spoken */
+
+/* a payload that did not shrink by at least 1/8th is sent as is ... */
+#define CDC_MIN_GAIN_SHIFT     3
+/* ... and so are the next few, the data is likely more of the same */
+#define CDC_SKIP_AFTER_MISS    8
+
+typedef struct cdc_stats {
+        uint64_t        compressed;     /* payloads sent compressed */
+        uint64_t        skipped;        /* payloads sent as is */
+        uint64_t        decompressed;   /* payloads received compressed */
+        uint64_t        raw_chunks;     /* incompressible chunks */
+        uint64_t        bytes_in;       /* before compression */
+        uint64_t        bytes_out;      /* after compression */
+        uint64_t        errors;
+} cdc_stats_t;
+
+typedef struct cdc_job {
+        struct list_head   list;
+        gf_boolean_t       compress;
+        int                count;       /* chunks */
+        int                next;        /* next chunk to take */
+        int                done;        /* chunks finished, under lock */
+        int                helpers;     /* workers on it, under lock */
+        int                failed;
+        struct iovec      *in;          /* compress: the payload */
+        int                in_count;
+        char              *src;         /* decompress: the payload */
+        char              *out;
+        size_t            *offs;        /* of chunk i in out (compress)
+                                           or in src (decompress) */
+        uint32_t          *lens;        /* compressed, with CDC_CHUNK_RAW */
+        size_t             chunk_size;
+        size_t             size;        /* uncompressed */
+} cdc_job_t;
+
+/* per thread, a deflate state costs a few hundred KB to set up */
+typedef struct cdc_stream {
+        struct list_head   list;        /* in priv->streams */
+        struct cdc_priv   *priv;
+        z_stream           def;
+        z_stream           inf;
+        gf_boolean_t       def_ok;
+        gf_boolean_t       inf_ok;
+        int                level;
+} cdc_stream_t;
+
+typedef struct cdc_priv {
+        gf_boolean_t       server;
+        int                level;
+        uint64_t           min_size;
+        uint64_t           chunk_size;
+        int                thread_count;
+        pthread_t         *threads;
+        pthread_key_t      stream_key;
+        struct list_head   streams;     /* of every thread, under lock */
+
+        pthread_mutex_t    lock;
+        pthread_cond_t     work_cond;
+        pthread_cond_t     done_cond;
+        struct list_head   jobs;
+        gf_boolean_t       fini;        /* workers leave */
+
+        int                peer_ok;     /* client: server has cdc too */
+        int                skip;        /* payloads to send as is */
+
+        cdc_stats_t        stats;
+} cdc_priv_t;
+
+#endif /* __CDC_H__ */
@@ -820,29 +820,22 @@ out:
 }
 
 
-int32_t
-quota_writev_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
-                  int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
-                  struct iatt *postbuf, dict_t *xdata)
+/* account the blocks a write-like fop on local->loc.inode took or freed */
+static void
+quota_update_fd_op_size (xlator_t *this, quota_local_t *local,
+                         struct iatt *prebuf, struct iatt *postbuf)
 {
         int32_t                  ret            = 0;
         uint64_t                 ctx_int        = 0;
         quota_inode_ctx_t       *ctx            = NULL;
-        quota_local_t           *local          = NULL;
         quota_dentry_t          *dentry         = NULL;
         int64_t                  delta          = 0;
 
-        local = frame->local;
-
-        if ((op_ret < 0) || (local == NULL)) {
-                goto out;
-        }
-
         ret = inode_ctx_get (local->loc.inode, this, &ctx_int);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING,
                         "%s: failed to get the context", local->loc.path);
-                goto out;
+                return;
         }
 
         ctx = (quota_inode_ctx_t *)(unsigned long) ctx_int;
@@ -851,7 +844,7 @@ quota_writev_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
                 gf_log (this->name, GF_LOG_WARNING,
                         "quota context not set in %s (gfid:%s)",
                         local->loc.path, uuid_utoa (local->loc.inode->gfid));
-                goto out;
+                return;
         }
 
         LOCK (&ctx->lock);
@@ -865,6 +858,102 @@ quota_writev_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
                 quota_update_size (this, local->loc.inode,
                                    dentry->name, dentry->par, delta);
         }
+}
+
+
+/* check the limits of every directory above inode for @delta more bytes;
+   the stub is resumed once all of them are known to allow it, which may
+   be from the callback of a size validation */
+static void
+quota_check_limits_and_resume (call_frame_t *frame, xlator_t *this,
+                               inode_t *inode, quota_inode_ctx_t *ctx,
+                               call_stub_t *stub, int64_t delta)
+{
+        int32_t            ret     = -1;
+        int32_t            parents = 0;
+        quota_local_t     *local   = NULL;
+        quota_dentry_t    *dentry  = NULL;
+
+        local = frame->local;
+
+        LOCK (&ctx->lock);
+        {
+                list_for_each_entry (dentry, &ctx->parents, next) {
+                        parents++;
+                }
+        }
+        UNLOCK (&ctx->lock);
+
+        local->delta = delta;
+        local->stub = stub;
+        local->link_count = parents;
+
+        list_for_each_entry (dentry, &ctx->parents, next) {
+                ret = quota_check_limit (frame, inode, this, dentry->name,
+                                         dentry->par);
+                if (ret == -1) {
+                        break;
+                }
+        }
+
+        stub = NULL;
+
+        LOCK (&local->lock);
+        {
+                local->link_count = 0;
+                if (local->validate_count == 0) {
+                        stub = local->stub;
+                        local->stub = NULL;
+                }
+        }
+        UNLOCK (&local->lock);
+
+        if (stub != NULL) {
+                call_resume (stub);
+        }
+}
+
+
+/* the local and inode context of a write-like fop on fd */
+static quota_inode_ctx_t *
+quota_fd_op_init (call_frame_t *frame, xlator_t *this, fd_t *fd)
+{
+        quota_local_t     *local   = NULL;
+        quota_inode_ctx_t *ctx     = NULL;
+
+        local = quota_local_new ();
+        if (local == NULL) {
+                return NULL;
+        }
+
+        frame->local = local;
+        local->loc.inode = inode_ref (fd->inode);
+
+        quota_inode_ctx_get (fd->inode, -1, this, NULL, NULL, &ctx, 0);
+        if (ctx == NULL) {
+                gf_log (this->name, GF_LOG_WARNING,
+                        "quota context not set in inode (gfid:%s)",
+                        uuid_utoa (fd->inode->gfid));
+        }
+
+        return ctx;
+}
+
+
+int32_t
+quota_writev_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                  int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                  struct iatt *postbuf, dict_t *xdata)
+{
+        quota_local_t           *local          = NULL;
+
+        local = frame->local;
+
+        if ((op_ret < 0) || (local == NULL)) {
+                goto out;
+        }
+
+        quota_update_fd_op_size (this, local, prebuf, postbuf);
 
 out:
         QUOTA_STACK_UNWIND (writev, frame, op_ret, op_errno, prebuf, postbuf,
@@ -909,86 +998,263 @@ quota_writev (call_frame_t *frame, xlator_t *this, fd_t *fd,
               struct iovec *vector, int32_t count, off_t off,
               uint32_t flags, struct iobref *iobref, dict_t *xdata)
 {
-        int32_t            ret     = -1, op_errno = EINVAL;
-        int32_t            parents = 0;
-        uint64_t           size    = 0;
-        quota_local_t     *local   = NULL;
+        int32_t            op_errno = EINVAL;
         quota_inode_ctx_t *ctx     = NULL;
         quota_priv_t      *priv    = NULL;
         call_stub_t       *stub    = NULL;
-        quota_dentry_t    *dentry  = NULL;
 
         GF_ASSERT (frame);
         GF_VALIDATE_OR_GOTO ("quota", this, unwind);
         GF_VALIDATE_OR_GOTO (this->name, fd, unwind);
 
-        local = quota_local_new ();
+        ctx = quota_fd_op_init (frame, this, fd);
+        if (ctx == NULL) {
+                goto unwind;
+        }
+
+        stub = fop_writev_stub (frame, quota_writev_helper, fd, vector, count,
+                                off, flags, iobref, xdata);
+        if (stub == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        priv = this->private;
+        GF_VALIDATE_OR_GOTO (this->name, priv, unwind);
+
+        quota_check_limits_and_resume (frame, this, fd->inode, ctx, stub,
+                                       iov_length (vector, count));
+
+        return 0;
+
+unwind:
+        QUOTA_STACK_UNWIND (writev, frame, -1, op_errno, NULL, NULL, NULL);
+        return 0;
+}
+
+
+int32_t
+quota_fallocate_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                     int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                     struct iatt *postbuf, dict_t *xdata)
+{
+        quota_local_t           *local          = NULL;
+
+        local = frame->local;
+
+        if ((op_ret < 0) || (local == NULL)) {
+                goto out;
+        }
+
+        quota_update_fd_op_size (this, local, prebuf, postbuf);
+
+out:
+        QUOTA_STACK_UNWIND (fallocate, frame, op_ret, op_errno, prebuf,
+                            postbuf, xdata);
+
+        return 0;
+}
+
+
+int32_t
+quota_fallocate_helper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                        int32_t keep_size, off_t offset, size_t len,
+                        dict_t *xdata)
+{
+        quota_local_t *local    = NULL;
+        int32_t        op_errno = EINVAL;
+
+        local = frame->local;
         if (local == NULL) {
+                gf_log (this->name, GF_LOG_WARNING, "local is NULL");
                 goto unwind;
         }
 
-        frame->local = local;
-        local->loc.inode = inode_ref (fd->inode);
+        if (local->op_ret == -1) {
+                op_errno = local->op_errno;
+                goto unwind;
+        }
+
+        STACK_WIND (frame, quota_fallocate_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->fallocate, fd, keep_size,
+                    offset, len, xdata);
+        return 0;
+
+unwind:
+        QUOTA_STACK_UNWIND (fallocate, frame, -1, op_errno, NULL, NULL, NULL);
+        return 0;
+}
+
+
+/* preallocated blocks count against the limit whether or not the file
+   size changes, so keep_size makes no difference here */
+int32_t
+quota_fallocate (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                 int32_t keep_size, off_t offset, size_t len, dict_t *xdata)
+{
+        int32_t            op_errno = EINVAL;
+        quota_inode_ctx_t *ctx      = NULL;
+        call_stub_t       *stub     = NULL;
+
+        GF_ASSERT (frame);
+        GF_VALIDATE_OR_GOTO ("quota", this, unwind);
+        GF_VALIDATE_OR_GOTO (this->name, fd, unwind);
 
-        ret = quota_inode_ctx_get (fd->inode, -1, this, NULL, NULL, &ctx, 0);
+        ctx = quota_fd_op_init (frame, this, fd);
         if (ctx == NULL) {
-                gf_log (this->name, GF_LOG_WARNING,
-                        "quota context not set in inode (gfid:%s)",
-                        uuid_utoa (fd->inode->gfid));
                 goto unwind;
         }
 
-        stub = fop_writev_stub (frame, quota_writev_helper, fd, vector, count,
-                                off, flags, iobref, xdata);
+        stub = fop_fallocate_stub (frame, quota_fallocate_helper, fd,
+                                   keep_size, offset, len, xdata);
         if (stub == NULL) {
                 op_errno = ENOMEM;
                 goto unwind;
         }
 
-        priv = this->private;
-        GF_VALIDATE_OR_GOTO (this->name, priv, unwind);
+        quota_check_limits_and_resume (frame, this, fd->inode, ctx, stub,
+                                       len);
 
-        size = iov_length (vector, count);
-        LOCK (&ctx->lock);
-        {
-                list_for_each_entry (dentry, &ctx->parents, next) {
-                        parents++;
-                }
+        return 0;
+
+unwind:
+        QUOTA_STACK_UNWIND (fallocate, frame, -1, op_errno, NULL, NULL, NULL);
+        return 0;
+}
+
+
+int32_t
+quota_zerofill_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                    int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                    struct iatt *postbuf, dict_t *xdata)
+{
+        quota_local_t           *local          = NULL;
+
+        local = frame->local;
+
+        if ((op_ret < 0) || (local == NULL)) {
+                goto out;
         }
-        UNLOCK (&ctx->lock);
 
-        local->delta = size;
-        local->stub = stub;
-        local->link_count = parents;
+        quota_update_fd_op_size (this, local, prebuf, postbuf);
 
-        list_for_each_entry (dentry, &ctx->parents, next) {
-                ret = quota_check_limit (frame, fd->inode, this, dentry->name,
-                                         dentry->par);
-                if (ret == -1) {
-                        break;
-                }
+out:
+        QUOTA_STACK_UNWIND (zerofill, frame, op_ret, op_errno, prebuf,
+                            postbuf, xdata);
+
+        return 0;
+}
+
+
+int32_t
+quota_zerofill_helper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                       off_t offset, size_t len, dict_t *xdata)
+{
+        quota_local_t *local    = NULL;
+        int32_t        op_errno = EINVAL;
+
+        local = frame->local;
+        if (local == NULL) {
+                gf_log (this->name, GF_LOG_WARNING, "local is NULL");
+                goto unwind;
         }
 
-        stub = NULL;
+        if (local->op_ret == -1) {
+                op_errno = local->op_errno;
+                goto unwind;
+        }
 
-        LOCK (&local->lock);
-        {
-                local->link_count = 0;
-                if (local->validate_count == 0) {
-                        stub = local->stub;
-                        local->stub = NULL;
-                }
+        STACK_WIND (frame, quota_zerofill_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->zerofill, fd, offset, len,
+                    xdata);
+        return 0;
+
+unwind:
+        QUOTA_STACK_UNWIND (zerofill, frame, -1, op_errno, NULL, NULL, NULL);
+        return 0;
+}
+
+
+int32_t
+quota_zerofill (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
+                size_t len, dict_t *xdata)
+{
+        int32_t            op_errno = EINVAL;
+        quota_inode_ctx_t *ctx      = NULL;
+        call_stub_t       *stub     = NULL;
+
+        GF_ASSERT (frame);
+        GF_VALIDATE_OR_GOTO ("quota", this, unwind);
+        GF_VALIDATE_OR_GOTO (this->name, fd, unwind);
+
+        ctx = quota_fd_op_init (frame, this, fd);
+        if (ctx == NULL) {
+                goto unwind;
         }
-        UNLOCK (&local->lock);
 
-        if (stub != NULL) {
-                call_resume (stub);
+        stub = fop_zerofill_stub (frame, quota_zerofill_helper, fd, offset,
+                                  len, xdata);
+        if (stub == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
         }
 
+        quota_check_limits_and_resume (frame, this, fd->inode, ctx, stub,
+                                       len);
+
         return 0;
 
 unwind:
-        QUOTA_STACK_UNWIND (writev, frame, -1, op_errno, NULL, NULL, NULL);
+        QUOTA_STACK_UNWIND (zerofill, frame, -1, op_errno, NULL, NULL, NULL);
+        return 0;
+}
+
+
+int32_t
+quota_discard_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                   int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                   struct iatt *postbuf, dict_t *xdata)
+{
+        quota_local_t           *local          = NULL;
+
+        local = frame->local;
+
+        if ((op_ret < 0) || (local == NULL)) {
+                goto out;
+        }
+
+        quota_update_fd_op_size (this, local, prebuf, postbuf);
+
+out:
+        QUOTA_STACK_UNWIND (discard, frame, op_ret, op_errno, prebuf,
+                            postbuf, xdata);
+
+        return 0;
+}
+
+
+/* only frees blocks, nothing to check */
+int32_t
+quota_discard (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
+               size_t len, dict_t *xdata)
+{
+        quota_local_t   *local = NULL;
+
+        local = quota_local_new ();
+        if (local == NULL)
+                goto err;
+
+        frame->local = local;
+
+        local->loc.inode = inode_ref (fd->inode);
+
+        STACK_WIND (frame, quota_discard_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->discard, fd, offset, len, xdata);
+
+        return 0;
+err:
+        QUOTA_STACK_UNWIND (discard, frame, -1, ENOMEM, NULL, NULL, NULL);
+
         return 0;
 }
 
@@ -3284,6 +3550,9 @@ struct xlator_fops fops = {
         .mkdir        = quota_mkdir,
         .truncate     = quota_truncate,
         .ftruncate    = quota_ftruncate,
+        .fallocate    = quota_fallocate,
+        .discard      = quota_discard,
+        .zerofill     = quota_zerofill,
         .unlink       = quota_unlink,
         .symlink      = quota_symlink,
         .link         = quota_link,
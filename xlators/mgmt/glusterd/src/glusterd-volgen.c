@@ -136,6 +136,7 @@ static struct volopt_map_entry glusterd_volopt_map[] = {
         {"cluster.metadata-change-log",          "cluster/replicate",  NULL, NULL, NO_DOC, 0     },
         {"cluster.data-self-heal-algorithm",     "cluster/replicate",         "data-self-heal-algorithm", NULL,DOC, 0},
         {"cluster.eager-lock",                   "cluster/replicate",  NULL, NULL, NO_DOC, 0     },
+        {"cluster.use-compound-fops",            "cluster/replicate",  NULL, NULL, DOC, 0},
         {"cluster.quorum-type",                  "cluster/replicate",  "quorum-type", NULL, NO_DOC, 0},
         {"cluster.quorum-count",                 "cluster/replicate",  "quorum-count", NULL, NO_DOC, 0},
         {"cluster.choose-local",                 "cluster/replicate",  NULL, NULL, DOC, 0},
@@ -146,6 +147,7 @@ static struct volopt_map_entry glusterd_volopt_map[] = {
         {VKEY_DIAG_LAT_MEASUREMENT,              "debug/io-stats",     "latency-measurement", "off", NO_DOC, 0},
         {"diagnostics.dump-fd-stats",            "debug/io-stats",     NULL, NULL, NO_DOC, 0},
         {VKEY_DIAG_CNT_FOP_HITS,                 "debug/io-stats",     "count-fop-hits", "off", NO_DOC, 0},
+        {"diagnostics.latency-per-client",       "debug/io-stats",     NULL, NULL, NO_DOC, 0},
 
         {"diagnostics.brick-log-level",          "debug/io-stats",     "!brick-log-level", NULL, DOC, 0},
         {"diagnostics.client-log-level",         "debug/io-stats",     "!client-log-level", NULL, DOC, 0},
@@ -166,6 +168,8 @@ static struct volopt_map_entry glusterd_volopt_map[] = {
         {"performance.normal-prio-threads",      "performance/io-threads",    NULL, NULL, DOC, 0},
         {"performance.low-prio-threads",         "performance/io-threads",    NULL, NULL, DOC, 0},
         {"performance.least-prio-threads",       "performance/io-threads",    NULL, NULL, DOC, 0},
+        {"performance.io-thread-client-weights", "performance/io-threads",    "client-weights", NULL, NO_DOC, 0},
+        {"performance.io-thread-work-queues",    "performance/io-threads",    "work-queues", NULL, NO_DOC, 0},
         {"performance.disk-usage-limit",         "performance/quota",         NULL, NULL, NO_DOC, 0},
         {"performance.min-free-disk-limit",      "performance/quota",         NULL, NULL, NO_DOC, 0},
         {"performance.write-behind-window-size", "performance/write-behind",  "cache-size", NULL, DOC},
@@ -174,6 +178,14 @@ static struct volopt_map_entry glusterd_volopt_map[] = {
         {"network.frame-timeout",                "protocol/client",           NULL, NULL, NO_DOC, 0},
         {"network.ping-timeout",                 "protocol/client",           NULL, NULL, NO_DOC, 0},
         {"network.tcp-window-size",              "protocol/client",           NULL, NULL, NO_DOC, 0},
+        {"client.event-threads",                 "protocol/client",           "event-threads", NULL, NO_DOC, 0},
+        {"client.iobuf-page-count",              "protocol/client",           "iobuf-page-count", NULL, NO_DOC, 0},
+        {"client.iobuf-numa",                    "protocol/client",           "iobuf-numa", NULL, NO_DOC, 0},
+        {"client.ssl",                           "protocol/client",           "transport.socket.ssl-enabled", NULL, NO_DOC, 0},
+        {"ssl.own-cert",                         "protocol/client",           "transport.socket.ssl-own-cert", NULL, NO_DOC, 0},
+        {"ssl.private-key",                      "protocol/client",           "transport.socket.ssl-private-key", NULL, NO_DOC, 0},
+        {"ssl.ca-list",                          "protocol/client",           "transport.socket.ssl-ca-list", NULL, NO_DOC, 0},
+        {"ssl.ktls",                             "protocol/client",           "transport.socket.ssl-ktls", NULL, NO_DOC, 0},
 
         {"network.tcp-window-size",              "protocol/server",           NULL, NULL, NO_DOC, 0},
         {"network.inode-lru-limit",              "protocol/server",           NULL, NULL, NO_DOC, 0},
@@ -181,6 +193,21 @@ static struct volopt_map_entry glusterd_volopt_map[] = {
         {AUTH_REJECT_MAP_KEY,                    "protocol/server",           "!server-auth", NULL, DOC, 0},
         {"transport.keepalive",                  "protocol/server",           "transport.socket.keepalive", NULL, NO_DOC, 0},
         {"server.allow-insecure",                "protocol/server",           "rpc-auth-allow-insecure", NULL, NO_DOC, 0},
+        {"server.event-threads",                 "protocol/server",           "event-threads", NULL, NO_DOC, 0},
+        {"server.iobuf-page-count",              "protocol/server",           "iobuf-page-count", NULL, NO_DOC, 0},
+        {"server.iobuf-numa",                    "protocol/server",           "iobuf-numa", NULL, NO_DOC, 0},
+        {"server.ssl",                           "protocol/server",           "transport.socket.ssl-enabled", NULL, NO_DOC, 0},
+        {"ssl.own-cert",                         "protocol/server",           "transport.socket.ssl-own-cert", NULL, NO_DOC, 0},
+        {"ssl.private-key",                      "protocol/server",           "transport.socket.ssl-private-key", NULL, NO_DOC, 0},
+        {"ssl.ca-list",                          "protocol/server",           "transport.socket.ssl-ca-list", NULL, NO_DOC, 0},
+        {"ssl.ktls",                             "protocol/server",           "transport.socket.ssl-ktls", NULL, NO_DOC, 0},
+
+        {"storage.linux-aio",                    "storage/posix",             "linux-aio", NULL, NO_DOC, 0},
+
+        {"network.compression",                  "features/cdc",              "!compress", "off", NO_DOC, 0},
+        {"network.compression.level",            "features/cdc",              "compression-level", NULL, NO_DOC, 0},
+        {"network.compression.min-size",         "features/cdc",              "min-size", NULL, NO_DOC, 0},
+        {"network.compression.threads",          "features/cdc",              "threads", NULL, NO_DOC, 0},
 
         {"performance.write-behind",             "performance/write-behind",  "!perf", "on", NO_DOC, 0},
         {"performance.read-ahead",               "performance/read-ahead",    "!perf", "on", NO_DOC, 0},
@@ -1745,6 +1772,16 @@ server_graph_builder (volgen_graph_t *graph, glusterd_volinfo_t *volinfo,
                 }
         }
 
+        /* below io-stats, which has to stay named after the brick */
+        if (dict_get_str_boolean (set_dict, "network.compression", 0)) {
+                xl = volgen_graph_add (graph, "features/cdc", volname);
+                if (!xl)
+                        return -1;
+                ret = xlator_set_option (xl, "mode", "server");
+                if (ret)
+                        return -1;
+        }
+
         xl = volgen_graph_add_as (graph, "debug/io-stats", path);
         if (!xl)
                 return -1;
@@ -2205,6 +2242,20 @@ volgen_graph_build_clients (volgen_graph_t *graph, glusterd_volinfo_t *volinfo,
                         }
                 }
 
+                /* the clusters are built over the cdc xlators then */
+                if (dict_get_str_boolean (set_dict, "network.compression",
+                                          0)) {
+                        xl = volgen_graph_add_as (graph, "features/cdc",
+                                                  "%s-cdc-%d", volname, i);
+                        if (!xl) {
+                                ret = -1;
+                                goto out;
+                        }
+                        ret = xlator_set_option (xl, "mode", "client");
+                        if (ret)
+                                goto out;
+                }
+
                 i++;
         }
 
@@ -2239,9 +2290,17 @@ volgen_graph_build_clusters (volgen_graph_t *graph,
         if (child_count == 0)
                 goto out;
         volname = volinfo->volname;
+        /* skip what is already linked below an xlator of the list, e.g.
+           the clients under features/cdc */
         txl = first_of (graph);
-        for (trav = txl; --child_count; trav = trav->next);
+        for (trav = txl; --child_count; ) {
+                trav = trav->next;
+                while (trav->parents)
+                        trav = trav->next;
+        }
         for (;; trav = trav->prev) {
+                while (trav->parents)
+                        trav = trav->prev;
                 if ((i % sub_count) == 0) {
                         xl = volgen_graph_add_nolink (graph, xl_type,
                                                       xl_namefmt, volname, j);
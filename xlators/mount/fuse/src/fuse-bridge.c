@@ -18,6 +18,7 @@
 */
 
 #include <sys/wait.h>
+#include <sys/ioctl.h>
 #include "fuse-bridge.h"
 
 static int gf_fuse_conn_err_log;
@@ -92,6 +93,143 @@ out:
 }
 
 
+/* the /dev/fuse fd the request @finh came in on */
+static inline int
+fuse_reply_fd (fuse_private_t *priv, fuse_in_header_t *finh)
+{
+        uint32_t idx = FUSE_READER_IDX (finh);
+
+        if (priv->readers && idx < priv->reader_count &&
+            priv->readers[idx].fd != -1)
+                return priv->readers[idx].fd;
+
+        return priv->fd;
+}
+
+#ifdef FUSE_USE_SPLICE
+struct fuse_splice_pipe {
+        int     fd[2];
+        int     bufs;   /* pipe capacity in pages */
+};
+
+static void
+fuse_splice_pipe_destroy (void *data)
+{
+        struct fuse_splice_pipe *sp = data;
+
+        if (!sp)
+                return;
+
+        close (sp->fd[0]);
+        close (sp->fd[1]);
+        GF_FREE (sp);
+}
+
+/* the calling thread's pipe, created on first use */
+static struct fuse_splice_pipe *
+fuse_splice_pipe_get (fuse_private_t *priv)
+{
+        struct fuse_splice_pipe *sp   = NULL;
+        size_t                   want = 0;
+        int                      size = 0;
+
+        sp = pthread_getspecific (priv->splice_key);
+        if (sp)
+                return sp;
+
+        sp = GF_CALLOC (1, sizeof (*sp), gf_fuse_mt_splice_pipe_t);
+        if (!sp)
+                return NULL;
+
+        if (pipe (sp->fd) == -1) {
+                GF_FREE (sp);
+                return NULL;
+        }
+
+        fcntl (sp->fd[0], F_SETFD, FD_CLOEXEC);
+        fcntl (sp->fd[1], F_SETFD, FD_CLOEXEC);
+
+        /* unprivileged processes are held to fs.pipe-max-size */
+        want = priv->splice_pipe_size;
+        do {
+                size = fcntl (sp->fd[1], F_SETPIPE_SZ, want);
+                want /= 2;
+        } while (size == -1 && want >= FUSE_SPLICE_MIN_SIZE);
+        if (size == -1)
+                size = fcntl (sp->fd[1], F_GETPIPE_SZ);
+        if (size <= 0 || pthread_setspecific (priv->splice_key, sp) != 0) {
+                fuse_splice_pipe_destroy (sp);
+                return NULL;
+        }
+        sp->bufs = size / getpagesize ();
+
+        return sp;
+}
+
+static void
+fuse_splice_pipe_put (fuse_private_t *priv, struct fuse_splice_pipe *sp)
+{
+        /* whatever is left in the pipe goes with it */
+        pthread_setspecific (priv->splice_key, NULL);
+        fuse_splice_pipe_destroy (sp);
+}
+
+/*
+ * Map the reply pages into a pipe and splice them into /dev/fuse, so the
+ * payload is not copied through writev(2).  Returns 0 if the reply could
+ * not be staged and has to go through writev(2) instead.
+ */
+static ssize_t
+fuse_splice_iov (fuse_private_t *priv, int fd, struct iovec *iov_out,
+                 int count, size_t len)
+{
+        struct fuse_splice_pipe *sp       = NULL;
+        unsigned long            pagesize = 0;
+        unsigned long            start    = 0;
+        unsigned long            end      = 0;
+        ssize_t                  res      = 0;
+        int                      bufs     = 0;
+        int                      saved_errno = 0;
+        int                      i        = 0;
+
+        sp = fuse_splice_pipe_get (priv);
+        if (!sp)
+                return 0;
+
+        /* every page an iovec touches takes one pipe buffer */
+        pagesize = getpagesize ();
+        for (i = 0; i < count; i++) {
+                if (!iov_out[i].iov_len)
+                        continue;
+                start = (unsigned long)iov_out[i].iov_base / pagesize;
+                end = ((unsigned long)iov_out[i].iov_base +
+                       iov_out[i].iov_len - 1) / pagesize;
+                bufs += end - start + 1;
+        }
+        if (bufs > sp->bufs)
+                return 0;
+
+        res = vmsplice (sp->fd[1], iov_out, count, SPLICE_F_NONBLOCK);
+        if (res != len) {
+                fuse_splice_pipe_put (priv, sp);
+                return 0;
+        }
+
+        /* the device takes a whole message per call and is done with the
+           pages by the time it returns */
+        res = splice (sp->fd[0], NULL, fd, NULL, len, SPLICE_F_MOVE);
+        if (res != len) {
+                /* send_fuse_iov() reports errno, do not let close(2)
+                   clobber it */
+                saved_errno = errno;
+                fuse_splice_pipe_put (priv, sp);
+                errno = saved_errno;
+        }
+
+        return res;
+}
+#endif /* FUSE_USE_SPLICE */
+
 /*
  * iov_out should contain a fuse_out_header at zeroth position.
  * The error value of this header is sent to kernel.
@@ -117,7 +255,14 @@ send_fuse_iov (xlator_t *this, fuse_in_header_t *finh, struct iovec *iov_out,
                 fouh->len += iov_out[i].iov_len;
         fouh->unique = finh->unique;
 
-        res = writev (priv->fd, iov_out, count);
+        res = 0;
+#ifdef FUSE_USE_SPLICE
+        if (priv->splice && fouh->len >= FUSE_SPLICE_MIN_SIZE)
+                res = fuse_splice_iov (priv, fuse_reply_fd (priv, finh),
+                                       iov_out, count, fouh->len);
+#endif
+        if (res == 0)
+                res = writev (fuse_reply_fd (priv, finh), iov_out, count);
 
         if (res == -1)
                 return errno;
@@ -415,6 +560,69 @@ fuse_forget (xlator_t *this, fuse_in_header_t *finh, void *msg)
 }
 
 
+#ifdef GF_LINUX_HOST_OS
+static void
+fuse_batch_forget (xlator_t *this, fuse_in_header_t *finh, void *msg)
+{
+        struct fuse_batch_forget_in *fbfi    = msg;
+        struct fuse_forget_one      *ffo     = NULL;
+        inode_forget_t              *forgets = NULL;
+        inode_t                     *inode   = NULL;
+        uint32_t                     count   = 0;
+        uint32_t                     i       = 0;
+        int                          n       = 0;
+
+        ffo = (struct fuse_forget_one *)(fbfi + 1);
+
+        count = fbfi->count;
+        if (finh->len < sizeof (*finh) + sizeof (*fbfi) +
+                        (uint64_t)count * sizeof (*ffo)) {
+                gf_log ("glusterfs-fuse", GF_LOG_WARNING,
+                        "%"PRIu64": BATCH_FORGET with %"PRIu32" entries "
+                        "does not fit in %"PRIu32" bytes", finh->unique,
+                        count, finh->len);
+                count = 0;
+                if (finh->len > sizeof (*finh) + sizeof (*fbfi))
+                        count = (finh->len - sizeof (*finh) -
+                                 sizeof (*fbfi)) / sizeof (*ffo);
+        }
+
+        gf_log ("glusterfs-fuse", GF_LOG_TRACE,
+                "%"PRIu64": BATCH_FORGET %"PRIu32, finh->unique, count);
+
+        forgets = GF_CALLOC (count, sizeof (*forgets),
+                             gf_fuse_mt_inode_forget_t);
+        if (!forgets) {
+                /* still have to honour every entry, one at a time */
+                for (i = 0; i < count; i++) {
+                        if (ffo[i].nodeid == 1)
+                                continue;
+                        inode = fuse_ino_to_inode (ffo[i].nodeid, this);
+                        inode_forget (inode, ffo[i].nlookup);
+                        inode_unref (inode);
+                }
+                goto out;
+        }
+
+        /* the kernel's lookup counts keep these inodes in the table, no
+           ref is needed to hand them over */
+        for (i = 0; i < count; i++) {
+                if (ffo[i].nodeid == 1)
+                        continue;
+                forgets[n].inode = (inode_t *)(unsigned long) ffo[i].nodeid;
+                forgets[n].nlookup = ffo[i].nlookup;
+                n++;
+        }
+
+        inode_forget_many (forgets, n);
+
+out:
+        GF_FREE (forgets);
+        GF_FREE (finh);
+}
+#endif
+
+
 static int
 fuse_truncate_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
                    int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
@@ -986,6 +1194,17 @@ fuse_fsync_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
 }
 
 
+#ifdef GF_LINUX_HOST_OS
+static int
+fuse_fallocate_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                    int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                    struct iatt *postbuf, dict_t *xdata)
+{
+        return fuse_err_cbk (frame, cookie, this, op_ret, op_errno, xdata);
+}
+#endif
+
+
 static int
 fuse_setxattr_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
                    int32_t op_ret, int32_t op_errno, dict_t *xdata)
@@ -2051,7 +2270,7 @@ fuse_write_resume (fuse_state_t *state)
                 return;
         }
 
-        iobuf = ((fuse_private_t *) (state->this->private))->iobuf;
+        iobuf = state->iobuf;
         iobref_add (iobref, iobuf);
 
         gf_log ("glusterfs-fuse", GF_LOG_TRACE,
@@ -2105,6 +2324,12 @@ fuse_write (xlator_t *this, fuse_in_header_t *finh, void *msg)
         state->vector.iov_base = msg;
         state->vector.iov_len  = fwi->size;
 
+        /* msg lives in the iobuf the reader thread read the request into,
+           keep it around until the write is wound */
+        if (FUSE_READER_IDX (finh) < priv->reader_count)
+                state->iobuf = iobuf_ref
+                        (priv->readers[FUSE_READER_IDX (finh)].iobuf);
+
         fuse_resolve_and_resume (state, fuse_write_resume);
 
         return;
@@ -2223,6 +2448,89 @@ fuse_fsync (xlator_t *this, fuse_in_header_t *finh, void *msg)
 }
 
 
+#ifdef GF_LINUX_HOST_OS
+/* fallocate(2) mode bits, as the kernel passes them through */
+#ifndef FALLOC_FL_KEEP_SIZE
+#define FALLOC_FL_KEEP_SIZE  0x01
+#endif
+#ifndef FALLOC_FL_PUNCH_HOLE
+#define FALLOC_FL_PUNCH_HOLE 0x02
+#endif
+#ifndef FALLOC_FL_ZERO_RANGE
+#define FALLOC_FL_ZERO_RANGE 0x10
+#endif
+
+void
+fuse_fallocate_resume (fuse_state_t *state)
+{
+        gf_log ("glusterfs-fuse", GF_LOG_TRACE,
+                "%"PRIu64": FALLOCATE (%p, flags=%d, off=%"PRId64
+                ", size=%zu)", state->finh->unique, state->fd,
+                state->flags, state->off, state->size);
+
+        if (state->flags & FALLOC_FL_PUNCH_HOLE) {
+                FUSE_FOP (state, fuse_fallocate_cbk, GF_FOP_DISCARD,
+                          discard, state->fd, state->off, state->size,
+                          state->xdata);
+        } else if (state->flags & FALLOC_FL_ZERO_RANGE) {
+                if (state->flags & FALLOC_FL_KEEP_SIZE) {
+                        if (!state->xdata)
+                                state->xdata = dict_new ();
+                        if (!state->xdata ||
+                            dict_set_int8 (state->xdata,
+                                           GF_ZEROFILL_KEEP_SIZE_KEY, 1)) {
+                                send_fuse_err (state->this, state->finh,
+                                               ENOMEM);
+                                free_fuse_state (state);
+                                return;
+                        }
+                }
+                FUSE_FOP (state, fuse_fallocate_cbk, GF_FOP_ZEROFILL,
+                          zerofill, state->fd, state->off, state->size,
+                          state->xdata);
+        } else {
+                FUSE_FOP (state, fuse_fallocate_cbk, GF_FOP_FALLOCATE,
+                          fallocate, state->fd,
+                          (state->flags & FALLOC_FL_KEEP_SIZE), state->off,
+                          state->size, state->xdata);
+        }
+}
+
+
+static void
+fuse_fallocate (xlator_t *this, fuse_in_header_t *finh, void *msg)
+{
+        struct fuse_fallocate_in *ffi = msg;
+
+        fuse_state_t *state = NULL;
+        fd_t         *fd = NULL;
+
+        /* PUNCH_HOLE is only defined together with KEEP_SIZE; anything
+           else we do not understand is refused rather than guessed at. */
+        if ((ffi->mode & ~(FALLOC_FL_KEEP_SIZE | FALLOC_FL_PUNCH_HOLE |
+                           FALLOC_FL_ZERO_RANGE)) ||
+            ((ffi->mode & FALLOC_FL_PUNCH_HOLE) &&
+             !(ffi->mode & FALLOC_FL_KEEP_SIZE))) {
+                send_fuse_err (this, finh, EOPNOTSUPP);
+                GF_FREE (finh);
+                return;
+        }
+
+        GET_STATE (this, finh, state);
+        fd = FH_TO_FD (ffi->fh);
+        state->fd = fd;
+
+        fuse_resolve_fd_init (state, &state->resolve, fd);
+
+        state->flags = ffi->mode;
+        state->off = ffi->offset;
+        state->size = ffi->length;
+        fuse_resolve_and_resume (state, fuse_fallocate_resume);
+        return;
+}
+#endif
+
+
 void
 fuse_opendir_resume (fuse_state_t *state)
 {
@@ -2404,6 +2712,151 @@ fuse_readdir (xlator_t *this, fuse_in_header_t *finh, void *msg)
 }
 
 
+static int
+fuse_readdirp_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                   int32_t op_ret, int32_t op_errno, gf_dirent_t *entries,
+                   dict_t *xdata)
+{
+        fuse_state_t           *state      = NULL;
+        fuse_in_header_t       *finh       = NULL;
+        fuse_private_t         *priv       = NULL;
+        size_t                  size       = 0;
+        size_t                  entry_size = 0;
+        int                     count      = 0;
+        int                     sent       = 0;
+        char                   *buf        = NULL;
+        gf_dirent_t            *entry      = NULL;
+        struct fuse_direntplus *fde        = NULL;
+        struct fuse_entry_out  *feo        = NULL;
+
+        priv  = this->private;
+        state = frame->root->state;
+        finh  = state->finh;
+
+        if (op_ret < 0) {
+                gf_log ("glusterfs-fuse", GF_LOG_WARNING,
+                        "%"PRIu64": READDIRP => -1 (%s)", frame->root->unique,
+                        strerror (op_errno));
+
+                send_fuse_err (this, finh, op_errno);
+                goto out;
+        }
+
+        gf_log ("glusterfs-fuse", GF_LOG_TRACE,
+                "%"PRIu64": READDIRP => %d/%"GF_PRI_SIZET",%"PRId64,
+                frame->root->unique, op_ret, state->size, state->off);
+
+        list_for_each_entry (entry, &entries->list, list) {
+                entry_size = FUSE_DIRENT_ALIGN (FUSE_NAME_OFFSET_DIRENTPLUS +
+                                                strlen (entry->d_name));
+                if (size + entry_size > state->size)
+                        break;
+                size += entry_size;
+                sent++;
+        }
+
+        buf = GF_CALLOC (1, size, gf_fuse_mt_char);
+        if (!buf) {
+                gf_log ("glusterfs-fuse", GF_LOG_DEBUG,
+                        "%"PRIu64": READDIRP => -1 (%s)", frame->root->unique,
+                        strerror (ENOMEM));
+                send_fuse_err (this, finh, ENOMEM);
+                goto out;
+        }
+
+        /* The kernel takes a lookup count on every entry with a nodeid,
+           except "." and "..".  Entries that do not fit in the reply are
+           read again from their offset, so they must not be linked now.
+         */
+        list_for_each_entry (entry, &entries->list, list) {
+                if (entry->inode &&
+                    (count >= sent || !strcmp (entry->d_name, ".") ||
+                     !strcmp (entry->d_name, ".."))) {
+                        inode_unref (entry->inode);
+                        entry->inode = NULL;
+                }
+                count++;
+        }
+
+        gf_link_inodes_from_dirent (this, state->fd->inode, entries);
+
+        size = 0;
+        count = 0;
+        list_for_each_entry (entry, &entries->list, list) {
+                if (count++ == sent)
+                        break;
+
+                fde = (struct fuse_direntplus *)(buf + size);
+                fde->dirent.ino = entry->d_ino;
+                fde->dirent.off = entry->d_off;
+                fde->dirent.type = entry->d_type;
+                fde->dirent.namelen = strlen (entry->d_name);
+                strncpy (fde->dirent.name, entry->d_name,
+                         fde->dirent.namelen);
+                size += FUSE_DIRENTPLUS_SIZE (fde);
+
+                /* a zero nodeid makes the kernel treat it as a plain
+                   dirent */
+                if (!entry->inode)
+                        continue;
+
+                feo = &fde->entry_out;
+                entry->d_stat.ia_blksize = this->ctx->page_size;
+                gf_fuse_stat2attr (&entry->d_stat, &feo->attr);
+
+                feo->nodeid = inode_to_fuse_nodeid (entry->inode);
+                feo->entry_valid =
+                        calc_timeout_sec (priv->entry_timeout);
+                feo->entry_valid_nsec =
+                        calc_timeout_nsec (priv->entry_timeout);
+                feo->attr_valid =
+                        calc_timeout_sec (priv->attribute_timeout);
+                feo->attr_valid_nsec =
+                        calc_timeout_nsec (priv->attribute_timeout);
+        }
+
+        send_fuse_data (this, finh, buf, size);
+
+out:
+        free_fuse_state (state);
+        STACK_DESTROY (frame->root);
+        GF_FREE (buf);
+        return 0;
+}
+
+
+void
+fuse_readdirp_resume (fuse_state_t *state)
+{
+        gf_log ("glusterfs-fuse", GF_LOG_TRACE,
+                "%"PRIu64": READDIRP (%p, size=%zu, offset=%"PRId64")",
+                state->finh->unique, state->fd, state->size, state->off);
+
+        FUSE_FOP (state, fuse_readdirp_cbk, GF_FOP_READDIRP,
+                  readdirp, state->fd, state->size, state->off, state->xdata);
+}
+
+
+static void
+fuse_readdirp (xlator_t *this, fuse_in_header_t *finh, void *msg)
+{
+        struct fuse_read_in *fri = msg;
+
+        fuse_state_t *state = NULL;
+        fd_t         *fd = NULL;
+
+        GET_STATE (this, finh, state);
+        state->size = fri->size;
+        state->off = fri->offset;
+        fd = FH_TO_FD (fri->fh);
+        state->fd = fd;
+
+        fuse_resolve_fd_init (state, &state->resolve, fd);
+
+        fuse_resolve_and_resume (state, fuse_readdirp_resume);
+}
+
+
 static void
 fuse_releasedir (xlator_t *this, fuse_in_header_t *finh, void *msg)
 {
@@ -3283,6 +3736,73 @@ notify_kernel_loop (void *data)
 }
 
 
+static void *fuse_thread_proc (void *data);
+
+/* a /dev/fuse fd attached to the same connection as @fd, or -1 */
+static int
+fuse_clone_fd (xlator_t *this, int fd)
+{
+        int      clone_fd = -1;
+#ifdef GF_LINUX_HOST_OS
+        uint32_t master   = fd;
+
+        clone_fd = open ("/dev/fuse", O_RDWR | O_CLOEXEC);
+        if (clone_fd == -1) {
+                gf_log (this->name, GF_LOG_DEBUG,
+                        "cannot open /dev/fuse (%s)", strerror (errno));
+                return -1;
+        }
+
+        if (ioctl (clone_fd, FUSE_DEV_IOC_CLONE, &master) == -1) {
+                gf_log (this->name, GF_LOG_DEBUG,
+                        "cannot clone the fuse fd (%s)", strerror (errno));
+                close (clone_fd);
+                clone_fd = -1;
+        }
+#endif
+        return clone_fd;
+}
+
+/* The first reader takes care of the mount and of INIT, the others are
+ * only started once the kernel has been told what we can do.
+ */
+static void
+fuse_readers_start (xlator_t *this)
+{
+        fuse_private_t *priv   = NULL;
+        fuse_reader_t  *reader = NULL;
+        int             cloned = 0;
+        int             ret    = 0;
+        int             i      = 0;
+
+        priv = this->private;
+
+        for (i = 1; i < priv->reader_count; i++) {
+                reader = &priv->readers[i];
+
+                reader->fd = fuse_clone_fd (this, priv->fd);
+                if (reader->fd != -1)
+                        cloned++;
+
+                ret = pthread_create (&reader->thread, NULL, fuse_thread_proc,
+                                      reader);
+                if (ret != 0) {
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "failed to start fuse reader %d (%s)", i,
+                                strerror (ret));
+                        if (reader->fd != -1)
+                                close (reader->fd);
+                        reader->fd = -1;
+                        break;
+                }
+        }
+
+        if (priv->reader_count > 1)
+                gf_log (this->name, GF_LOG_INFO,
+                        "started %d fuse reader threads, %d on cloned fds",
+                        i, cloned);
+}
+
 static void
 fuse_init (xlator_t *this, fuse_in_header_t *finh, void *msg)
 {
@@ -3317,8 +3837,8 @@ fuse_init (xlator_t *this, fuse_in_header_t *finh, void *msg)
 
         fino.major = FUSE_KERNEL_VERSION;
         fino.minor = FUSE_KERNEL_MINOR_VERSION;
-        fino.max_readahead = 1 << 17;
-        fino.max_write = 1 << 17;
+        fino.max_readahead = min (fini->max_readahead, priv->max_readahead);
+        fino.max_write = priv->max_write;
         fino.flags = FUSE_ASYNC_READ | FUSE_POSIX_LOCKS;
 #if FUSE_KERNEL_MINOR_VERSION >= 12
         if (fini->minor >= 12) {
@@ -3336,6 +3856,17 @@ fuse_init (xlator_t *this, fuse_in_header_t *finh, void *msg)
                 fino.flags |= FUSE_BIG_WRITES;
         }
 
+#ifdef GF_LINUX_HOST_OS
+        /* let the kernel fetch attributes along with the entries, it
+           decides per directory whether that is worth it */
+        if (fini->minor >= 6 && (fini->flags & FUSE_DO_READDIRPLUS) &&
+            priv->use_readdirp) {
+                fino.flags |= FUSE_DO_READDIRPLUS;
+                if (fini->flags & FUSE_READDIRPLUS_AUTO)
+                        fino.flags |= FUSE_READDIRPLUS_AUTO;
+        }
+#endif
+
         /* Used for 'reverse invalidation of inode' */
         if (fini->minor >= 12) {
                 if (pipe(pfd) == -1) {
@@ -3366,9 +3897,21 @@ fuse_init (xlator_t *this, fuse_in_header_t *finh, void *msg)
                 fino.congestion_threshold = 48;
         }
         if (fini->minor < 9)
-                *priv->msg0_len_p = sizeof(*finh) + FUSE_COMPAT_WRITE_IN_SIZE;
+                priv->msg0_len = sizeof(*finh) + FUSE_COMPAT_WRITE_IN_SIZE;
 #endif
-        ret = send_fuse_obj (this, finh, &fino);
+        /* without this kernels cap requests at 32 pages, whatever
+           max_write says */
+        if (fini->minor >= 6 && fini->flags & FUSE_MAX_PAGES) {
+                fino.flags |= FUSE_MAX_PAGES;
+                fino.max_pages = (priv->max_write + getpagesize () - 1) /
+                                 getpagesize ();
+        }
+
+        if (fini->minor < 23)
+                ret = send_fuse_data (this, finh, &fino,
+                                      FUSE_COMPAT_22_INIT_OUT_SIZE);
+        else
+                ret = send_fuse_obj (this, finh, &fino);
         if (ret == 0)
                 gf_log ("glusterfs-fuse", GF_LOG_INFO,
                         "FUSE inited with protocol versions:"
@@ -3380,8 +3923,11 @@ fuse_init (xlator_t *this, fuse_in_header_t *finh, void *msg)
                         "FUSE init failed (%s)", strerror (ret));
 
                 close (priv->fd);
+                goto out;
         }
 
+        fuse_readers_start (this);
+
  out:
         GF_FREE (finh);
 }
@@ -3884,6 +4430,7 @@ static void *
 fuse_thread_proc (void *data)
 {
         char                     *mount_point = NULL;
+        fuse_reader_t            *reader = NULL;
         xlator_t                 *this = NULL;
         fuse_private_t           *priv = NULL;
         ssize_t                   res = 0;
@@ -3896,21 +4443,25 @@ fuse_thread_proc (void *data)
         struct pollfd             pfd[2] = {{0,}};
         gf_boolean_t              mount_finished = _gf_false;
 
-        this = data;
+        reader = data;
+        this = reader->this;
         priv = this->private;
         fuse_ops = priv->fuse_ops;
 
         THIS = this;
 
-        iov_in[0].iov_len = sizeof (*finh) + sizeof (struct fuse_write_in);
-        iov_in[1].iov_len = ((struct iobuf_pool *)this->ctx->iobuf_pool)
-                              ->default_page_size;
-        priv->msg0_len_p = &iov_in[0].iov_len;
+        /* only the first reader waits for the mount to complete */
+        if (reader->idx != 0)
+                mount_finished = _gf_true;
 
         for (;;) {
                 /* THIS has to be reset here */
                 THIS = this;
 
+                /* INIT may shrink the header part for old kernels */
+                iov_in[0].iov_len = priv->msg0_len;
+                iov_in[1].iov_len = priv->max_write;
+
                 if (!mount_finished) {
                         memset(pfd,0,sizeof(pfd));
                         pfd[0].fd = priv->status_pipe[0];
@@ -3949,11 +4500,9 @@ fuse_thread_proc (void *data)
                 if (priv->init_recvd)
                         fuse_graph_sync (this);
 
-                /* TODO: This place should always get maximum supported buffer
-                   size from 'fuse', which is as of today 128KB. If we bring in
-                   support for higher block sizes support, then we should be
-                   changing this one too */
-                iobuf = iobuf_get (this->ctx->iobuf_pool);
+                /* large enough for the biggest write we told the kernel
+                   about in INIT (max-write) */
+                iobuf = iobuf_get2 (this->ctx->iobuf_pool, priv->max_write);
 
                 /* Add extra 128 byte to the first iov so that it can
                  * accommodate "ordinary" non-write requests. It's not
@@ -3977,7 +4526,7 @@ fuse_thread_proc (void *data)
 
                 iov_in[1].iov_base = iobuf->ptr;
 
-                res = readv (priv->fd, iov_in, 2);
+                res = readv (reader->fd, iov_in, 2);
 
                 if (res == -1) {
                         if (errno == ENODEV || errno == EBADF) {
@@ -4020,7 +4569,8 @@ fuse_thread_proc (void *data)
                         break;
                 }
 
-                priv->iobuf = iobuf;
+                FUSE_READER_IDX (finh) = reader->idx;
+                reader->iobuf = iobuf;
 
                 if (finh->opcode == FUSE_WRITE)
                         msg = iov_in[1].iov_base;
@@ -4059,14 +4609,20 @@ fuse_thread_proc (void *data)
 #endif
                 fuse_ops[finh->opcode] (this, finh, msg);
 
+                reader->iobuf = NULL;
                 iobuf_unref (iobuf);
                 continue;
 
  cont_err:
+                reader->iobuf = NULL;
                 iobuf_unref (iobuf);
                 GF_FREE (iov_in[0].iov_base);
         }
 
+        /* the first reader owns the mount, the others just go away */
+        if (reader->idx != 0)
+                return NULL;
+
         /*
          * We could be in all sorts of states with respect to iobuf and iov_in
          * by the time we get here, and it's just not worth untangling them if
@@ -4123,8 +4679,16 @@ fuse_priv_dump (xlator_t  *this)
                             private->volfile_size);
         gf_proc_dump_write("mount_point", "%s",
                             private->mount_point);
-        gf_proc_dump_write("iobuf", "%u",
-                            private->iobuf);
+        gf_proc_dump_write("reader_thread_count", "%d",
+                            private->reader_count);
+        gf_proc_dump_write("max_write", "%u",
+                            private->max_write);
+        gf_proc_dump_write("max_readahead", "%u",
+                            private->max_readahead);
+        gf_proc_dump_write("use_readdirp", "%d",
+                            private->use_readdirp);
+        gf_proc_dump_write("splice", "%d",
+                            private->splice);
         gf_proc_dump_write("fuse_thread_started", "%d",
                             (int)private->fuse_thread_started);
         gf_proc_dump_write("direct_io_mode", "%d",
@@ -4228,7 +4792,8 @@ notify (xlator_t *this, int32_t event, void *data, ...)
                         private->fuse_thread_started = 1;
 
                         ret = pthread_create (&private->fuse_thread, NULL,
-                                              fuse_thread_proc, this);
+                                              fuse_thread_proc,
+                                              &private->readers[0]);
                         if (ret != 0) {
                                 gf_log (this->name, GF_LOG_DEBUG,
                                         "pthread_create() failed (%s)",
@@ -4280,6 +4845,9 @@ static fuse_handler_t *fuse_std_ops[FUSE_OP_HIGH] = {
         [FUSE_DESTROY]     = fuse_destroy,
         [FUSE_LOOKUP]      = fuse_lookup,
         [FUSE_FORGET]      = fuse_forget,
+#ifdef GF_LINUX_HOST_OS
+        [FUSE_BATCH_FORGET] = fuse_batch_forget,
+#endif
         [FUSE_GETATTR]     = fuse_getattr,
         [FUSE_SETATTR]     = fuse_setattr,
         [FUSE_OPENDIR]     = fuse_opendir,
@@ -4310,6 +4878,10 @@ static fuse_handler_t *fuse_std_ops[FUSE_OP_HIGH] = {
         [FUSE_GETLK]       = fuse_getlk,
         [FUSE_SETLK]       = fuse_setlk,
         [FUSE_SETLKW]      = fuse_setlk,
+#ifdef GF_LINUX_HOST_OS
+        [FUSE_FALLOCATE]   = fuse_fallocate,
+        [FUSE_READDIRPLUS] = fuse_readdirp,
+#endif
 };
 
 
@@ -4460,6 +5032,62 @@ init (xlator_t *this_xl)
         if (ret != 0)
                 priv->uid_map_root = 0;
 
+        ret = dict_get_int32 (options, "reader-thread-count",
+                              &priv->reader_count);
+        if (ret != 0)
+                priv->reader_count = 1;
+        if (priv->reader_count < 1 ||
+            priv->reader_count > FUSE_MAX_READER_THREADS) {
+                gf_log ("glusterfs-fuse", GF_LOG_WARNING,
+                        "reader-thread-count %d out of range, using %d",
+                        priv->reader_count,
+                        (priv->reader_count < 1) ? 1 :
+                        FUSE_MAX_READER_THREADS);
+                priv->reader_count = (priv->reader_count < 1) ? 1 :
+                                     FUSE_MAX_READER_THREADS;
+        }
+
+        ret = dict_get_uint32 (options, "max-write", &priv->max_write);
+        if (ret != 0)
+                priv->max_write = FUSE_DEFAULT_MAX_WRITE;
+        if (priv->max_write < 4096 || priv->max_write > FUSE_MAX_MAX_WRITE) {
+                gf_log ("glusterfs-fuse", GF_LOG_WARNING,
+                        "max-write %u out of range (4096 - %u), using %u",
+                        priv->max_write, FUSE_MAX_MAX_WRITE,
+                        FUSE_DEFAULT_MAX_WRITE);
+                priv->max_write = FUSE_DEFAULT_MAX_WRITE;
+        }
+
+        ret = dict_get_uint32 (options, "max-readahead",
+                               &priv->max_readahead);
+        if (ret != 0)
+                priv->max_readahead = FUSE_DEFAULT_MAX_WRITE;
+        if (priv->max_readahead < 4096 ||
+            priv->max_readahead > FUSE_MAX_MAX_WRITE) {
+                gf_log ("glusterfs-fuse", GF_LOG_WARNING,
+                        "max-readahead %u out of range (4096 - %u), "
+                        "using %u", priv->max_readahead, FUSE_MAX_MAX_WRITE,
+                        FUSE_DEFAULT_MAX_WRITE);
+                priv->max_readahead = FUSE_DEFAULT_MAX_WRITE;
+        }
+
+        priv->msg0_len = sizeof (fuse_in_header_t) +
+                         sizeof (struct fuse_write_in);
+
+        priv->readers = GF_CALLOC (priv->reader_count,
+                                   sizeof (*priv->readers),
+                                   gf_fuse_mt_fuse_reader_t);
+        if (!priv->readers) {
+                gf_log ("glusterfs-fuse", GF_LOG_ERROR,
+                        "Out of memory");
+                goto cleanup_exit;
+        }
+        for (i = 0; i < priv->reader_count; i++) {
+                priv->readers[i].this = this_xl;
+                priv->readers[i].idx  = i;
+                priv->readers[i].fd   = -1;
+        }
+
         priv->direct_io_mode = 2;
         ret = dict_get_str (options, ZR_DIRECT_IO_OPT, &value_string);
         if (ret == 0) {
@@ -4498,6 +5126,43 @@ init (xlator_t *this_xl)
                 GF_ASSERT (ret == 0);
         }
 
+        priv->use_readdirp = 1;
+        ret = dict_get_str (options, "use-readdirp", &value_string);
+        if (ret == 0) {
+                ret = gf_string2boolean (value_string, &priv->use_readdirp);
+                GF_ASSERT (ret == 0);
+        }
+
+        priv->splice = 0;
+        ret = dict_get_str (options, "splice", &value_string);
+        if (ret == 0) {
+                ret = gf_string2boolean (value_string, &priv->splice);
+                GF_ASSERT (ret == 0);
+        }
+
+#ifdef FUSE_USE_SPLICE
+        if (priv->splice) {
+                /* room for the largest reply even when the payload does not
+                   start on a page boundary */
+                priv->splice_pipe_size = 2 * (max (priv->max_write,
+                                                   priv->max_readahead) +
+                                              getpagesize ());
+                ret = pthread_key_create (&priv->splice_key,
+                                          fuse_splice_pipe_destroy);
+                if (ret != 0) {
+                        gf_log ("glusterfs-fuse", GF_LOG_WARNING,
+                                "splice disabled (%s)", strerror (ret));
+                        priv->splice = 0;
+                }
+        }
+#else
+        if (priv->splice) {
+                gf_log ("glusterfs-fuse", GF_LOG_WARNING,
+                        "splice is not supported on this platform");
+                priv->splice = 0;
+        }
+#endif
+
         priv->fuse_dump_fd = -1;
         ret = dict_get_str (options, "dump-fuse", &value_string);
         if (ret == 0) {
@@ -4552,9 +5217,10 @@ init (xlator_t *this_xl)
                 goto cleanup_exit;
         }
 
-        gf_asprintf (&mnt_args, "%s%sallow_other,max_read=131072",
+        gf_asprintf (&mnt_args, "%s%sallow_other,max_read=%u",
                      priv->read_only ? "ro," : "",
-                     priv->acl ? "" : "default_permissions,");
+                     priv->acl ? "" : "default_permissions,",
+                     max (priv->max_write, priv->max_readahead));
         if (!mnt_args)
                 goto cleanup_exit;
 
@@ -4569,6 +5235,7 @@ init (xlator_t *this_xl)
                                   priv->status_pipe[1]);
         if (priv->fd == -1)
                 goto cleanup_exit;
+        priv->readers[0].fd = priv->fd;
 
         pthread_mutex_init (&priv->fuse_dump_mutex, NULL);
         pthread_cond_init (&priv->sync_cond, NULL);
@@ -4603,6 +5270,7 @@ cleanup_exit:
                         close (priv->fd);
                 if (priv->fuse_dump_fd != -1)
                         close (priv->fuse_dump_fd);
+                GF_FREE (priv->readers);
                 GF_FREE (priv);
         }
         if (mnt_args)
@@ -4683,5 +5351,26 @@ struct volume_options options[] = {
         { .key = {"read-only"},
           .type = GF_OPTION_TYPE_BOOL
         },
+        { .key = {"use-readdirp"},
+          .type = GF_OPTION_TYPE_BOOL
+        },
+        { .key = {"splice"},
+          .type = GF_OPTION_TYPE_BOOL
+        },
+        { .key  = {"reader-thread-count"},
+          .type = GF_OPTION_TYPE_INT,
+          .min  = 1,
+          .max  = FUSE_MAX_READER_THREADS
+        },
+        { .key  = {"max-write"},
+          .type = GF_OPTION_TYPE_SIZET,
+          .min  = 4096,
+          .max  = FUSE_MAX_MAX_WRITE
+        },
+        { .key  = {"max-readahead"},
+          .type = GF_OPTION_TYPE_SIZET,
+          .min  = 4096,
+          .max  = FUSE_MAX_MAX_WRITE
+        },
         { .key = {NULL} },
 };
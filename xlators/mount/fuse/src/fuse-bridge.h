@@ -27,6 +27,7 @@
 #include <dirent.h>
 #include <sys/mount.h>
 #include <sys/time.h>
+#include <fcntl.h>
 #include <fnmatch.h>
 
 #ifndef _CONFIG_H
@@ -57,7 +58,7 @@
 #include "syncop.h"
 
 #if defined(GF_LINUX_HOST_OS) || defined(__NetBSD__)
-#define FUSE_OP_HIGH (FUSE_POLL + 1)
+#define FUSE_OP_HIGH (FUSE_READDIRPLUS + 1)
 #endif
 #ifdef GF_DARWIN_HOST_OS
 #define FUSE_OP_HIGH (FUSE_DESTROY + 1)
@@ -66,23 +67,55 @@
 
 #define MAX_FUSE_PROC_DELAY 1
 
+#if defined(GF_LINUX_HOST_OS) && defined(F_SETPIPE_SZ)
+#define FUSE_USE_SPLICE 1
+#endif
+
+/* replies smaller than this are not worth the extra syscall */
+#define FUSE_SPLICE_MIN_SIZE      (64 * 1024)
+
+#define FUSE_DEFAULT_MAX_WRITE    (128 * 1024)
+#define FUSE_MAX_MAX_WRITE        (1024 * 1024)
+#define FUSE_MAX_READER_THREADS   32
+
 typedef struct fuse_in_header fuse_in_header_t;
 typedef void (fuse_handler_t) (xlator_t *this, fuse_in_header_t *finh,
                                void *msg);
 
+/* A thread reading requests off /dev/fuse.  Readers other than the first
+ * one use a clone of the mount's fd where the kernel allows it, and the
+ * replies to a request have to go to the fd it was read from, so the
+ * reader index travels along in the (otherwise unused) padding of the
+ * request header.
+ */
+struct fuse_reader {
+        xlator_t            *this;
+        int                  idx;
+        int                  fd;
+        pthread_t            thread;
+        struct iobuf        *iobuf;   /* payload of the request in dispatch */
+};
+typedef struct fuse_reader fuse_reader_t;
+
+#define FUSE_READER_IDX(finh) ((finh)->padding)
+
 struct fuse_private {
         int                  fd;
         uint32_t             proto_minor;
         char                *volfile;
         size_t               volfile_size;
         char                *mount_point;
-        struct iobuf        *iobuf;
 
         pthread_t            fuse_thread;
         char                 fuse_thread_started;
 
+        fuse_reader_t       *readers;
+        int                  reader_count;
+        uint32_t             max_write;
+        uint32_t             max_readahead;
+
         uint32_t             direct_io_mode;
-        size_t              *msg0_len_p;
+        size_t               msg0_len;
 
         double               entry_timeout;
         double               attribute_timeout;
@@ -109,8 +142,15 @@ struct fuse_private {
         gf_boolean_t         acl;
         gf_boolean_t         selinux;
         gf_boolean_t         read_only;
+        gf_boolean_t         use_readdirp;
         fdtable_t           *fdtable;
 
+        /* large replies go through a per-thread pipe with vmsplice(2) and
+           splice(2) instead of writev(2) */
+        gf_boolean_t         splice;
+        pthread_key_t        splice_key;
+        size_t               splice_pipe_size;
+
         /* For fuse-reverse-validation */
         int                  revchan_in;
         int                  revchan_out;
@@ -326,6 +366,7 @@ typedef struct {
         uuid_t         gfid;
         uint32_t       io_flags;
         int32_t        fd_no;
+        struct iobuf  *iobuf;
 } fuse_state_t;
 
 typedef struct fuse_fd_ctx {
@@ -92,6 +92,10 @@ free_fuse_state (fuse_state_t *state)
                 GF_FREE (state->finh);
                 state->finh = NULL;
         }
+        if (state->iobuf) {
+                iobuf_unref (state->iobuf);
+                state->iobuf = NULL;
+        }
 
         fuse_resolve_wipe (&state->resolve);
         fuse_resolve_wipe (&state->resolve2);
@@ -31,6 +31,9 @@ enum gf_fuse_mem_types_ {
         gf_fuse_mt_fuse_state_t,
         gf_fuse_mt_fd_ctx_t,
         gf_fuse_mt_graph_switch_args_t,
+        gf_fuse_mt_fuse_reader_t,
+        gf_fuse_mt_splice_pipe_t,
+        gf_fuse_mt_inode_forget_t,
         gf_fuse_mt_end
 };
 #endif
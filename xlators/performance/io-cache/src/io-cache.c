@@ -17,6 +17,7 @@
 #include "logging.h"
 #include "dict.h"
 #include "xlator.h"
+#include "defaults.h"
 #include "io-cache.h"
 #include "ioc-mem-types.h"
 #include "statedump.h"
@@ -1338,6 +1339,87 @@ ioc_ftruncate (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
         return 0;
 }
 
+/*
+ * ioc_fallocate -
+ *
+ * @frame:
+ * @this:
+ * @fd:
+ * @offset:
+ * @len:
+ *
+ */
+int32_t
+ioc_fallocate (call_frame_t *frame, xlator_t *this, fd_t *fd,
+               int32_t keep_size, off_t offset, size_t len, dict_t *xdata)
+{
+        uint64_t ioc_inode = 0;
+
+        inode_ctx_get (fd->inode, this, &ioc_inode);
+
+        if (ioc_inode)
+                ioc_inode_flush ((ioc_inode_t *)(long)ioc_inode);
+
+        STACK_WIND (frame, default_fallocate_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->fallocate, fd, keep_size, offset, len,
+                    xdata);
+        return 0;
+}
+
+/*
+ * ioc_discard -
+ *
+ * @frame:
+ * @this:
+ * @fd:
+ * @offset:
+ * @len:
+ *
+ */
+int32_t
+ioc_discard (call_frame_t *frame, xlator_t *this, fd_t *fd,
+             off_t offset, size_t len, dict_t *xdata)
+{
+        uint64_t ioc_inode = 0;
+
+        inode_ctx_get (fd->inode, this, &ioc_inode);
+
+        if (ioc_inode)
+                ioc_inode_flush ((ioc_inode_t *)(long)ioc_inode);
+
+        STACK_WIND (frame, default_discard_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->discard, fd, offset, len,
+                    xdata);
+        return 0;
+}
+
+/*
+ * ioc_zerofill -
+ *
+ * @frame:
+ * @this:
+ * @fd:
+ * @offset:
+ * @len:
+ *
+ */
+int32_t
+ioc_zerofill (call_frame_t *frame, xlator_t *this, fd_t *fd,
+              off_t offset, size_t len, dict_t *xdata)
+{
+        uint64_t ioc_inode = 0;
+
+        inode_ctx_get (fd->inode, this, &ioc_inode);
+
+        if (ioc_inode)
+                ioc_inode_flush ((ioc_inode_t *)(long)ioc_inode);
+
+        STACK_WIND (frame, default_zerofill_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->zerofill, fd, offset, len,
+                    xdata);
+        return 0;
+}
+
 int32_t
 ioc_lk_cbk (call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
             int32_t op_errno, struct gf_flock *lock, dict_t *xdata)
@@ -1963,6 +2045,9 @@ struct xlator_fops fops = {
         .writev      = ioc_writev,
         .truncate    = ioc_truncate,
         .ftruncate   = ioc_ftruncate,
+        .fallocate   = ioc_fallocate,
+        .discard     = ioc_discard,
+        .zerofill    = ioc_zerofill,
         .lookup      = ioc_lookup,
         .lk          = ioc_lk,
         .setattr     = ioc_setattr,
@@ -23,52 +23,242 @@
 #include <sys/time.h>
 #include <time.h>
 #include "locking.h"
+#include "statedump.h"
+#include <fnmatch.h>
+#include <sched.h>
 
 void *iot_worker (void *arg);
 int iot_workers_scale (iot_conf_t *conf);
 int __iot_workers_scale (iot_conf_t *conf);
 struct volume_options options[];
 
-call_stub_t *
-__iot_dequeue (iot_conf_t *conf, int *pri)
+static inline int
+iot_client_hash (void *key)
 {
-        call_stub_t  *stub = NULL;
-        int           i = 0;
+        return ((unsigned long) key >> 6) % IOT_CLIENT_HASH_SIZE;
+}
 
-        *pri = -1;
+
+static int
+iot_client_weight (iot_conf_t *conf, const char *id)
+{
+        int weight = IOT_DEFAULT_WEIGHT;
+        int i      = 0;
+
+        /* weights are rarely configured, skip the lock when they are not */
+        if (!id || !conf->weight_count)
+                return weight;
+
+        pthread_mutex_lock (&conf->mutex);
+        {
+                for (i = 0; i < conf->weight_count; i++) {
+                        if (fnmatch (conf->weights[i].pattern, id, 0) == 0) {
+                                weight = conf->weights[i].weight;
+                                break;
+                        }
+                }
+        }
+        pthread_mutex_unlock (&conf->mutex);
+
+        return weight;
+}
+
+
+static iot_client_t *
+__iot_client_get (iot_conf_t *conf, iot_queue_t *queue, call_stub_t *stub)
+{
+        iot_client_t  *client = NULL;
+        void          *key    = NULL;
+        int            bucket = 0;
+        int            i      = 0;
+
+        key = stub->frame->root->trans;
+        bucket = iot_client_hash (key);
+
+        list_for_each_entry (client, &queue->client_hash[bucket], hash) {
+                if (client->key == key)
+                        return client;
+        }
+
+        client = mem_get0 (conf->client_pool);
+        if (!client)
+                return NULL;
+
+        INIT_LIST_HEAD (&client->hash);
         for (i = 0; i < IOT_PRI_MAX; i++) {
-                if (list_empty (&conf->reqs[i]) ||
-                   (conf->ac_iot_count[i] >= conf->ac_iot_limit[i]))
-                        continue;
-                stub = list_entry (conf->reqs[i].next, call_stub_t, list);
-                conf->ac_iot_count[i]++;
-                *pri = i;
-                break;
+                INIT_LIST_HEAD (&client->ring[i]);
+                INIT_LIST_HEAD (&client->reqs[i]);
         }
+        client->key    = key;
+        client->id     = stub->frame->root->client_id;
+        client->weight = iot_client_weight (conf, client->id);
+
+        list_add (&client->hash, &queue->client_hash[bucket]);
 
-        if (!stub)
+        return client;
+}
+
+
+/* Take the next request of priority @pri from @queue, which is locked.
+   The caller has already reserved a slot in ac_iot_count[pri]. */
+static call_stub_t *
+__iot_dequeue (iot_conf_t *conf, iot_queue_t *queue, int pri)
+{
+        call_stub_t  *stub = NULL;
+        iot_client_t *client = NULL;
+
+        if (list_empty (&queue->clients[pri]))
                 return NULL;
 
-        conf->queue_size--;
-        conf->queue_sizes[*pri]--;
+        client = list_entry (queue->clients[pri].next, iot_client_t,
+                             ring[pri]);
+        stub = list_entry (client->reqs[pri].next, call_stub_t, list);
         list_del_init (&stub->list);
 
+        queue->queue_size--;
+        queue->queue_sizes[pri]--;
+        __sync_fetch_and_sub (&conf->queue_size, 1);
+        __sync_fetch_and_sub (&conf->queue_sizes[pri], 1);
+
+        /* leave the ring when out of requests, go to its back when the
+           turn is used up */
+        if (--client->queue_sizes[pri] == 0) {
+                list_del_init (&client->ring[pri]);
+        } else if (--client->deficit[pri] <= 0) {
+                client->deficit[pri] = client->weight;
+                list_move_tail (&client->ring[pri], &queue->clients[pri]);
+        }
+
+        if (--client->queue_size == 0) {
+                list_del_init (&client->hash);
+                mem_put (client);
+        }
+
         return stub;
 }
 
 
-void
-__iot_enqueue (iot_conf_t *conf, call_stub_t *stub, int pri)
+int
+__iot_enqueue (iot_conf_t *conf, iot_queue_t *queue, call_stub_t *stub,
+               int pri)
 {
+        iot_client_t *client = NULL;
+
         if (pri < 0 || pri >= IOT_PRI_MAX)
                 pri = IOT_PRI_MAX-1;
 
-        list_add_tail (&stub->list, &conf->reqs[pri]);
+        client = __iot_client_get (conf, queue, stub);
+        if (!client)
+                return -ENOMEM;
+
+        list_add_tail (&stub->list, &client->reqs[pri]);
+
+        if (client->queue_sizes[pri]++ == 0) {
+                client->deficit[pri] = client->weight;
+                list_add_tail (&client->ring[pri], &queue->clients[pri]);
+        }
+        client->queue_size++;
 
-        conf->queue_size++;
-        conf->queue_sizes[pri]++;
+        queue->queue_size++;
+        queue->queue_sizes[pri]++;
+        /* full barriers: pairs with the sleep_count check in iot_sleep */
+        __sync_fetch_and_add (&conf->queue_sizes[pri], 1);
+        __sync_fetch_and_add (&conf->queue_size, 1);
 
-        return;
+        return 0;
+}
+
+
+/* is there anything queued that the per-priority limits let us run? */
+static int
+iot_runnable (iot_conf_t *conf)
+{
+        int i = 0;
+
+        for (i = 0; i < IOT_PRI_MAX; i++) {
+                if (conf->queue_sizes[i] &&
+                    (conf->ac_iot_count[i] < conf->ac_iot_limit[i]))
+                        return 1;
+        }
+
+        return 0;
+}
+
+
+/* Find work in priority order. For each priority the home queue is tried
+   first, then the other queues are robbed as long as their lock is free.
+   The unlocked size checks only decide where to look. */
+static call_stub_t *
+iot_get_work (iot_conf_t *conf, int home, int *pri)
+{
+        call_stub_t *stub  = NULL;
+        iot_queue_t *queue = NULL;
+        int          i     = 0;
+        int          n     = 0;
+
+        *pri = -1;
+        for (i = 0; i < IOT_PRI_MAX; i++) {
+                if (!conf->queue_sizes[i])
+                        continue;
+
+                if (__sync_add_and_fetch (&conf->ac_iot_count[i], 1) >
+                    conf->ac_iot_limit[i]) {
+                        __sync_fetch_and_sub (&conf->ac_iot_count[i], 1);
+                        continue;
+                }
+
+                for (n = 0; n < conf->queue_count; n++) {
+                        queue = conf->queues[(home + n) % conf->queue_count];
+                        if (!queue->queue_sizes[i])
+                                continue;
+
+                        if (n == 0)
+                                pthread_mutex_lock (&queue->mutex);
+                        else if (pthread_mutex_trylock (&queue->mutex))
+                                continue;
+
+                        stub = __iot_dequeue (conf, queue, i);
+
+                        pthread_mutex_unlock (&queue->mutex);
+
+                        if (stub) {
+                                *pri = i;
+                                return stub;
+                        }
+                }
+
+                __sync_fetch_and_sub (&conf->ac_iot_count[i], 1);
+        }
+
+        return NULL;
+}
+
+
+/* returns ETIMEDOUT if nothing showed up for idle-time */
+static int
+iot_sleep (iot_conf_t *conf, iot_queue_t *queue)
+{
+        struct timespec   sleep_till = {0, };
+        int               ret = 0;
+
+        sleep_till.tv_sec = time (NULL) + conf->idle_time;
+
+        pthread_mutex_lock (&queue->mutex);
+        {
+                /* full barrier before looking at the queues, an enqueuer
+                   either sees us sleeping or we see its request */
+                __sync_fetch_and_add (&queue->sleep_count, 1);
+
+                if (!iot_runnable (conf))
+                        ret = pthread_cond_timedwait (&queue->cond,
+                                                      &queue->mutex,
+                                                      &sleep_till);
+
+                __sync_fetch_and_sub (&queue->sleep_count, 1);
+        }
+        pthread_mutex_unlock (&queue->mutex);
+
+        return ret;
 }
 
 
@@ -78,89 +268,133 @@ iot_worker (void *data)
         iot_conf_t       *conf = NULL;
         xlator_t         *this = NULL;
         call_stub_t      *stub = NULL;
-        struct timespec   sleep_till = {0, };
         int               ret = 0;
         int               pri = -1;
-        char              timeout = 0;
+        int               home = 0;
+        int               spin = IOT_MIN_SPIN;
+        int               i = 0;
         char              bye = 0;
 
         conf = data;
         this = conf->this;
         THIS = this;
 
+        home = __sync_fetch_and_add (&conf->next_home, 1) % conf->queue_count;
+
         for (;;) {
-                sleep_till.tv_sec = time (NULL) + conf->idle_time;
+                if (pri != -1) {
+                        __sync_fetch_and_sub (&conf->ac_iot_count[pri], 1);
+                        pri = -1;
+                }
 
-                pthread_mutex_lock (&conf->mutex);
-                {
-                        if (pri != -1) {
-                                conf->ac_iot_count[pri]--;
-                                pri = -1;
-                        }
-                        while (conf->queue_size == 0) {
-                                conf->sleep_count++;
+                stub = iot_get_work (conf, home, &pri);
+                if (stub) {
+                        call_resume (stub);
+                        continue;
+                }
 
-                                ret = pthread_cond_timedwait (&conf->cond,
-                                                              &conf->mutex,
-                                                              &sleep_till);
-                                conf->sleep_count--;
+                /* poll a little before going to sleep, spin longer when
+                   that paid off last time and shorter when it did not */
+                for (i = 0; i < spin && !iot_runnable (conf); i++)
+                        sched_yield ();
 
-                                if (ret == ETIMEDOUT) {
-                                        timeout = 1;
-                                        break;
-                                }
-                        }
+                if (i < spin) {
+                        spin = min (spin * 2, IOT_MAX_SPIN);
+                        continue;
+                }
+                spin = max (spin / 2, IOT_MIN_SPIN);
 
-                        if (timeout) {
-                                if (conf->curr_count > IOT_MIN_THREADS) {
-                                        conf->curr_count--;
-                                        bye = 1;
-                                        gf_log (conf->this->name, GF_LOG_DEBUG,
-                                                "timeout, terminated. conf->curr_count=%d",
-                                                conf->curr_count);
-                                } else {
-                                        timeout = 0;
-                                }
-                        }
+                ret = iot_sleep (conf, conf->queues[home]);
+                if (ret != ETIMEDOUT || iot_runnable (conf))
+                        continue;
 
-                        stub = __iot_dequeue (conf, &pri);
+                pthread_mutex_lock (&conf->mutex);
+                {
+                        if (conf->curr_count > IOT_MIN_THREADS) {
+                                conf->curr_count--;
+                                bye = 1;
+                                gf_log (conf->this->name, GF_LOG_DEBUG,
+                                        "timeout, terminated. conf->curr_count=%d",
+                                        conf->curr_count);
+                        }
                 }
                 pthread_mutex_unlock (&conf->mutex);
 
-                if (stub) /* guard against spurious wakeups */
-                        call_resume (stub);
-
                 if (bye)
                         break;
         }
 
-        if (pri != -1) {
-                pthread_mutex_lock (&conf->mutex);
+        return NULL;
+}
+
+
+static iot_queue_t *
+iot_pick_queue (iot_conf_t *conf)
+{
+        int idx = -1;
+
+        if (conf->queue_count == 1)
+                return conf->queues[0];
+
+#ifdef GF_LINUX_HOST_OS
+        idx = sched_getcpu ();
+#endif
+        if (idx < 0)
+                idx = __sync_fetch_and_add (&conf->next_queue, 1);
+
+        return conf->queues[idx % conf->queue_count];
+}
+
+
+/* wake a sleeper, preferably one whose home is @queue */
+static void
+iot_wake_one (iot_conf_t *conf, iot_queue_t *queue)
+{
+        iot_queue_t *other = NULL;
+        int          n     = 0;
+
+        for (n = 0; n < conf->queue_count; n++) {
+                other = conf->queues[n];
+                if (other == queue || !other->sleep_count)
+                        continue;
+
+                pthread_mutex_lock (&other->mutex);
                 {
-                        conf->ac_iot_count[pri]--;
+                        if (other->sleep_count)
+                                pthread_cond_signal (&other->cond);
                 }
-                pthread_mutex_unlock (&conf->mutex);
+                pthread_mutex_unlock (&other->mutex);
+                break;
         }
-        return NULL;
 }
 
 
 int
 do_iot_schedule (iot_conf_t *conf, call_stub_t *stub, int pri)
 {
-        int   ret = 0;
+        iot_queue_t *queue = NULL;
+        int          woken = 0;
+        int          ret   = 0;
 
-        pthread_mutex_lock (&conf->mutex);
+        queue = iot_pick_queue (conf);
+
+        pthread_mutex_lock (&queue->mutex);
         {
-                __iot_enqueue (conf, stub, pri);
+                ret = __iot_enqueue (conf, queue, stub, pri);
+                if ((ret == 0) && queue->sleep_count) {
+                        pthread_cond_signal (&queue->cond);
+                        woken = 1;
+                }
+        }
+        pthread_mutex_unlock (&queue->mutex);
 
-                pthread_cond_signal (&conf->cond);
+        if (ret < 0)
+                return ret;
 
-                ret = __iot_workers_scale (conf);
-        }
-        pthread_mutex_unlock (&conf->mutex);
+        if (!woken)
+                iot_wake_one (conf, queue);
 
-        return ret;
+        return iot_workers_scale (conf);
 }
 
 char*
@@ -234,6 +468,7 @@ iot_schedule (call_frame_t *frame, xlator_t *this, call_stub_t *stub)
         case GF_FOP_FSETXATTR:
         case GF_FOP_REMOVEXATTR:
         case GF_FOP_FREMOVEXATTR:
+        case GF_FOP_SEEK:
                 pri = IOT_PRI_NORMAL;
                 break;
 
@@ -245,6 +480,9 @@ iot_schedule (call_frame_t *frame, xlator_t *this, call_stub_t *stub)
         case GF_FOP_FSYNCDIR:
         case GF_FOP_XATTROP:
         case GF_FOP_FXATTROP:
+        case GF_FOP_FALLOCATE:
+        case GF_FOP_DISCARD:
+        case GF_FOP_ZEROFILL:
                 pri = IOT_PRI_LO;
                 break;
 
@@ -257,6 +495,7 @@ iot_schedule (call_frame_t *frame, xlator_t *this, call_stub_t *stub)
         case GF_FOP_RELEASE:
         case GF_FOP_RELEASEDIR:
         case GF_FOP_GETSPEC:
+        case GF_FOP_COMPOUND:
         case GF_FOP_MAXVALUE:
                 //fail compilation on missing fop
                 //new fop must choose priority.
@@ -428,6 +667,211 @@ out:
 }
 
 
+int
+iot_fallocate_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                   int32_t op_ret, int32_t op_errno, struct iatt *preop,
+                   struct iatt *postop, dict_t *xdata)
+{
+        STACK_UNWIND_STRICT (fallocate, frame, op_ret, op_errno, preop, postop,
+                             xdata);
+        return 0;
+}
+
+
+int
+iot_fallocate_wrapper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                       int32_t keep_size, off_t offset, size_t len,
+                       dict_t *xdata)
+{
+        STACK_WIND (frame, iot_fallocate_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->fallocate, fd, keep_size,
+                    offset, len, xdata);
+        return 0;
+}
+
+
+int
+iot_fallocate (call_frame_t *frame, xlator_t *this, fd_t *fd,
+               int32_t keep_size, off_t offset, size_t len, dict_t *xdata)
+{
+        call_stub_t     *stub = NULL;
+        int              ret = -1;
+
+        stub = fop_fallocate_stub (frame, iot_fallocate_wrapper, fd,
+                                   keep_size, offset, len, xdata);
+        if (!stub) {
+                gf_log (this->name, GF_LOG_ERROR, "cannot create fallocate stub"
+                        "(out of memory)");
+                ret = -ENOMEM;
+                goto out;
+        }
+
+        ret = iot_schedule (frame, this, stub);
+
+out:
+        if (ret < 0) {
+                STACK_UNWIND_STRICT (fallocate, frame, -1, -ret, NULL, NULL,
+                                     NULL);
+                if (stub != NULL) {
+                        call_stub_destroy (stub);
+                }
+        }
+        return 0;
+}
+
+
+int
+iot_discard_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                 int32_t op_ret, int32_t op_errno, struct iatt *preop,
+                 struct iatt *postop, dict_t *xdata)
+{
+        STACK_UNWIND_STRICT (discard, frame, op_ret, op_errno, preop, postop,
+                             xdata);
+        return 0;
+}
+
+
+int
+iot_discard_wrapper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                     off_t offset, size_t len, dict_t *xdata)
+{
+        STACK_WIND (frame, iot_discard_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->discard, fd, offset, len,
+                    xdata);
+        return 0;
+}
+
+
+int
+iot_discard (call_frame_t *frame, xlator_t *this, fd_t *fd,
+             off_t offset, size_t len, dict_t *xdata)
+{
+        call_stub_t     *stub = NULL;
+        int              ret = -1;
+
+        stub = fop_discard_stub (frame, iot_discard_wrapper, fd, offset, len,
+                                xdata);
+        if (!stub) {
+                gf_log (this->name, GF_LOG_ERROR, "cannot create discard stub"
+                        "(out of memory)");
+                ret = -ENOMEM;
+                goto out;
+        }
+
+        ret = iot_schedule (frame, this, stub);
+
+out:
+        if (ret < 0) {
+                STACK_UNWIND_STRICT (discard, frame, -1, -ret, NULL, NULL,
+                                     NULL);
+                if (stub != NULL) {
+                        call_stub_destroy (stub);
+                }
+        }
+        return 0;
+}
+
+
+int
+iot_zerofill_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                  int32_t op_ret, int32_t op_errno, struct iatt *preop,
+                  struct iatt *postop, dict_t *xdata)
+{
+        STACK_UNWIND_STRICT (zerofill, frame, op_ret, op_errno, preop, postop,
+                             xdata);
+        return 0;
+}
+
+
+int
+iot_zerofill_wrapper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                      off_t offset, size_t len, dict_t *xdata)
+{
+        STACK_WIND (frame, iot_zerofill_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->zerofill, fd, offset, len,
+                    xdata);
+        return 0;
+}
+
+
+int
+iot_zerofill (call_frame_t *frame, xlator_t *this, fd_t *fd,
+              off_t offset, size_t len, dict_t *xdata)
+{
+        call_stub_t     *stub = NULL;
+        int              ret = -1;
+
+        stub = fop_zerofill_stub (frame, iot_zerofill_wrapper, fd, offset, len,
+                                 xdata);
+        if (!stub) {
+                gf_log (this->name, GF_LOG_ERROR, "cannot create zerofill stub"
+                        "(out of memory)");
+                ret = -ENOMEM;
+                goto out;
+        }
+
+        ret = iot_schedule (frame, this, stub);
+
+out:
+        if (ret < 0) {
+                STACK_UNWIND_STRICT (zerofill, frame, -1, -ret, NULL, NULL,
+                                     NULL);
+                if (stub != NULL) {
+                        call_stub_destroy (stub);
+                }
+        }
+        return 0;
+}
+
+
+int
+iot_seek_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+              int32_t op_ret, int32_t op_errno, off_t offset, dict_t *xdata)
+{
+        STACK_UNWIND_STRICT (seek, frame, op_ret, op_errno, offset, xdata);
+        return 0;
+}
+
+
+int
+iot_seek_wrapper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                  off_t offset, gf_seek_what_t what, dict_t *xdata)
+{
+        STACK_WIND (frame, iot_seek_cbk, FIRST_CHILD (this),
+                    FIRST_CHILD (this)->fops->seek, fd, offset, what, xdata);
+        return 0;
+}
+
+
+int
+iot_seek (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
+          gf_seek_what_t what, dict_t *xdata)
+{
+        call_stub_t     *stub = NULL;
+        int              ret = -1;
+
+        stub = fop_seek_stub (frame, iot_seek_wrapper, fd, offset, what,
+                              xdata);
+        if (!stub) {
+                gf_log (this->name, GF_LOG_ERROR, "cannot create seek stub"
+                        "(out of memory)");
+                ret = -ENOMEM;
+                goto out;
+        }
+
+        ret = iot_schedule (frame, this, stub);
+
+out:
+        if (ret < 0) {
+                STACK_UNWIND_STRICT (seek, frame, -1, -ret, 0, NULL);
+                if (stub != NULL) {
+                        call_stub_destroy (stub);
+                }
+        }
+        return 0;
+}
+
+
 int
 iot_access_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
                 int32_t op_ret, int32_t op_errno, dict_t *xdata)
@@ -2349,13 +2793,10 @@ out:
 }
 
 
-int
-__iot_workers_scale (iot_conf_t *conf)
+static int
+iot_workers_wanted (iot_conf_t *conf)
 {
         int       scale = 0;
-        int       diff = 0;
-        pthread_t thread;
-        int       ret = 0;
         int       i = 0;
 
         for (i = 0; i < IOT_PRI_MAX; i++)
@@ -2367,6 +2808,20 @@ __iot_workers_scale (iot_conf_t *conf)
         if (scale > conf->max_count)
                 scale = conf->max_count;
 
+        return scale;
+}
+
+
+int
+__iot_workers_scale (iot_conf_t *conf)
+{
+        int       scale = 0;
+        int       diff = 0;
+        pthread_t thread;
+        int       ret = 0;
+
+        scale = iot_workers_wanted (conf);
+
         if (conf->curr_count < scale) {
                 diff = scale - conf->curr_count;
         }
@@ -2399,6 +2854,12 @@ iot_workers_scale (iot_conf_t *conf)
                 goto out;
         }
 
+        /* nothing to do most of the time, find that out without the lock */
+        if (conf->curr_count >= iot_workers_wanted (conf)) {
+                ret = 0;
+                goto out;
+        }
+
         pthread_mutex_lock (&conf->mutex);
         {
                 ret = __iot_workers_scale (conf);
@@ -2425,6 +2886,182 @@ set_stack_size (iot_conf_t *conf)
 }
 
 
+/* "client-weights" is a comma separated list of <pattern>:<weight>, the
+   first pattern matching a client id decides its weight */
+static int
+iot_weights_parse (xlator_t *this, char *str, iot_weight_t **weights_p,
+                   int *count_p)
+{
+        iot_weight_t *weights  = NULL;
+        char         *dup_str  = NULL;
+        char         *entry    = NULL;
+        char         *saveptr  = NULL;
+        char         *sep      = NULL;
+        int           count    = 0;
+        int           weight   = 0;
+        int           ret      = -1;
+
+        *weights_p = NULL;
+        *count_p = 0;
+
+        if (!str || !strlen (str))
+                return 0;
+
+        for (entry = str, count = 1; *entry; entry++)
+                if (*entry == ',')
+                        count++;
+
+        weights = GF_CALLOC (count, sizeof (*weights), gf_iot_mt_weight_t);
+        dup_str = gf_strdup (str);
+        if (!weights || !dup_str)
+                goto out;
+
+        count = 0;
+        for (entry = strtok_r (dup_str, ",", &saveptr); entry;
+             entry = strtok_r (NULL, ",", &saveptr)) {
+                sep = strrchr (entry, ':');
+                if (!sep || sep == entry ||
+                    gf_string2int (sep + 1, &weight) ||
+                    weight < 1 || weight > IOT_MAX_WEIGHT) {
+                        gf_log (this->name, GF_LOG_ERROR,
+                                "invalid client weight '%s', expected "
+                                "<pattern>:<1-%d>", entry, IOT_MAX_WEIGHT);
+                        goto out;
+                }
+                *sep = '\0';
+
+                weights[count].pattern = gf_strdup (entry);
+                if (!weights[count].pattern)
+                        goto out;
+                weights[count].weight = weight;
+                count++;
+        }
+
+        *weights_p = weights;
+        *count_p = count;
+        weights = NULL;
+        ret = 0;
+out:
+        if (weights) {
+                while (count--)
+                        GF_FREE (weights[count].pattern);
+                GF_FREE (weights);
+        }
+        GF_FREE (dup_str);
+
+        return ret;
+}
+
+
+static void
+iot_weights_free (iot_weight_t *weights, int count)
+{
+        while (count--)
+                GF_FREE (weights[count].pattern);
+        GF_FREE (weights);
+}
+
+
+static int
+iot_weights_set (xlator_t *this, iot_conf_t *conf, char *str)
+{
+        iot_weight_t *weights     = NULL;
+        iot_weight_t *old_weights = NULL;
+        int           count       = 0;
+        int           old_count   = 0;
+        int           ret         = -1;
+
+        ret = iot_weights_parse (this, str, &weights, &count);
+        if (ret)
+                return ret;
+
+        /* clients already queued keep their weight until they drain */
+        pthread_mutex_lock (&conf->mutex);
+        {
+                old_weights = conf->weights;
+                old_count = conf->weight_count;
+                conf->weights = weights;
+                conf->weight_count = count;
+        }
+        pthread_mutex_unlock (&conf->mutex);
+
+        iot_weights_free (old_weights, old_count);
+
+        return 0;
+}
+
+
+int
+iot_priv_dump (xlator_t *this)
+{
+        iot_conf_t    *conf   = NULL;
+        iot_queue_t   *queue  = NULL;
+        iot_client_t  *client = NULL;
+        char           key_prefix[GF_DUMP_MAX_BUF_LEN];
+        char           key[GF_DUMP_MAX_BUF_LEN];
+        int            i      = 0;
+        int            n      = 0;
+        int            q      = 0;
+        int            sleepers = 0;
+
+        if (!this)
+                return 0;
+
+        conf = this->private;
+        if (!conf)
+                return 0;
+
+        snprintf (key_prefix, GF_DUMP_MAX_BUF_LEN, "%s.%s", this->type,
+                  this->name);
+        gf_proc_dump_add_section (key_prefix);
+
+        for (q = 0; q < conf->queue_count; q++)
+                sleepers += conf->queues[q]->sleep_count;
+
+        gf_proc_dump_write ("maximum_threads_count", "%d", conf->max_count);
+        gf_proc_dump_write ("current_threads_count", "%d", conf->curr_count);
+        gf_proc_dump_write ("sleep_count", "%d", sleepers);
+        gf_proc_dump_write ("idle_time", "%d", conf->idle_time);
+        gf_proc_dump_write ("work_queues", "%d", conf->queue_count);
+        gf_proc_dump_write ("queue_size", "%d", conf->queue_size);
+        for (i = 0; i < IOT_PRI_MAX; i++) {
+                snprintf (key, sizeof (key), "%s_queue_size",
+                          iot_get_pri_meaning (i));
+                gf_proc_dump_write (key, "%d", conf->queue_sizes[i]);
+        }
+
+        for (q = 0; q < conf->queue_count; q++) {
+                queue = conf->queues[q];
+                if (pthread_mutex_trylock (&queue->mutex) != 0)
+                        continue;
+
+                for (n = 0; n < IOT_CLIENT_HASH_SIZE; n++) {
+                        list_for_each_entry (client, &queue->client_hash[n],
+                                             hash) {
+                                gf_proc_dump_build_key (key, key_prefix,
+                                                        "queue%d.client.%p",
+                                                        q, client->key);
+                                gf_proc_dump_add_section (key);
+                                gf_proc_dump_write ("id", "%s", client->id ?
+                                                    client->id : "(local)");
+                                gf_proc_dump_write ("weight", "%d",
+                                                    client->weight);
+                                for (i = 0; i < IOT_PRI_MAX; i++) {
+                                        snprintf (key, sizeof (key),
+                                                  "%s_queue_depth",
+                                                  iot_get_pri_meaning (i));
+                                        gf_proc_dump_write (key, "%d",
+                                                            client->queue_sizes[i]);
+                                }
+                        }
+                }
+                pthread_mutex_unlock (&queue->mutex);
+        }
+
+        return 0;
+}
+
+
 int32_t
 mem_acct_init (xlator_t *this)
 {
@@ -2450,6 +3087,7 @@ reconfigure (xlator_t *this, dict_t *options)
 {
 	iot_conf_t      *conf = NULL;
 	int		 ret = -1;
+        char            *weights = NULL;
 
         conf = this->private;
         if (!conf)
@@ -2471,18 +3109,92 @@ reconfigure (xlator_t *this, dict_t *options)
                           conf->ac_iot_limit[IOT_PRI_LEAST], options, int32,
                           out);
 
+        GF_OPTION_RECONF ("client-weights", weights, options, str, out);
+        if (iot_weights_set (this, conf, weights))
+                goto out;
+
 	ret = 0;
 out:
 	return ret;
 }
 
 
+static void
+iot_queues_fini (iot_conf_t *conf)
+{
+        iot_queue_t *queue = NULL;
+        int          q     = 0;
+
+        if (!conf->queues)
+                return;
+
+        for (q = 0; q < conf->queue_count; q++) {
+                queue = conf->queues[q];
+                pthread_mutex_destroy (&queue->mutex);
+                pthread_cond_destroy (&queue->cond);
+                GF_FREE (queue);
+        }
+
+        GF_FREE (conf->queues);
+        conf->queues = NULL;
+        conf->queue_count = 0;
+}
+
+
+/* count 0 means one queue per online cpu */
+static int
+iot_queues_init (xlator_t *this, iot_conf_t *conf, int count)
+{
+        iot_queue_t *queue = NULL;
+        int          q     = 0;
+        int          i     = 0;
+
+        if (count <= 0) {
+                count = sysconf (_SC_NPROCESSORS_ONLN);
+                if (count <= 0)
+                        count = 1;
+        }
+        if (count > IOT_MAX_QUEUES)
+                count = IOT_MAX_QUEUES;
+
+        conf->queues = GF_CALLOC (count, sizeof (*conf->queues),
+                                  gf_iot_mt_iot_queue_t);
+        if (!conf->queues)
+                goto err;
+
+        for (q = 0; q < count; q++) {
+                queue = GF_CALLOC (1, sizeof (*queue), gf_iot_mt_iot_queue_t);
+                if (!queue)
+                        goto err;
+
+                pthread_mutex_init (&queue->mutex, NULL);
+                pthread_cond_init (&queue->cond, NULL);
+                for (i = 0; i < IOT_PRI_MAX; i++)
+                        INIT_LIST_HEAD (&queue->clients[i]);
+                for (i = 0; i < IOT_CLIENT_HASH_SIZE; i++)
+                        INIT_LIST_HEAD (&queue->client_hash[i]);
+
+                conf->queues[q] = queue;
+                conf->queue_count = q + 1;
+        }
+
+        gf_log (this->name, GF_LOG_DEBUG, "using %d work queue(s)", count);
+        return 0;
+
+err:
+        gf_log (this->name, GF_LOG_ERROR, "out of memory");
+        iot_queues_fini (conf);
+        return -1;
+}
+
+
 int
 init (xlator_t *this)
 {
-        iot_conf_t *conf = NULL;
-        int         ret  = -1;
-        int         i    = 0;
+        iot_conf_t *conf    = NULL;
+        char       *weights = NULL;
+        int32_t     queue_count = 0;
+        int         ret     = -1;
 
 	if (!this->children || this->children->next) {
 		gf_log ("io-threads", GF_LOG_ERROR,
@@ -2503,12 +3215,6 @@ init (xlator_t *this)
                 goto out;
         }
 
-        if ((ret = pthread_cond_init(&conf->cond, NULL)) != 0) {
-                gf_log (this->name, GF_LOG_ERROR,
-                        "pthread_cond_init failed (%d)", ret);
-                goto out;
-        }
-
         if ((ret = pthread_mutex_init(&conf->mutex, NULL)) != 0) {
                 gf_log (this->name, GF_LOG_ERROR,
                         "pthread_mutex_init failed (%d)", ret);
@@ -2535,10 +3241,24 @@ init (xlator_t *this)
 
         conf->this = this;
 
-        for (i = 0; i < IOT_PRI_MAX; i++) {
-                INIT_LIST_HEAD (&conf->reqs[i]);
+        GF_OPTION_INIT ("work-queues", queue_count, int32, out);
+        ret = iot_queues_init (this, conf, queue_count);
+        if (ret)
+                goto out;
+
+        conf->client_pool = mem_pool_new (iot_client_t, 64);
+        if (!conf->client_pool) {
+                gf_log (this->name, GF_LOG_ERROR,
+                        "failed to create client pool");
+                ret = -1;
+                goto out;
         }
 
+        GF_OPTION_INIT ("client-weights", weights, str, out);
+        ret = iot_weights_set (this, conf, weights);
+        if (ret)
+                goto out;
+
 	ret = iot_workers_scale (conf);
 
         if (ret == -1) {
@@ -2550,8 +3270,13 @@ init (xlator_t *this)
 	this->private = conf;
         ret = 0;
 out:
-        if (ret)
+        if (ret && conf) {
+                if (conf->client_pool)
+                        mem_pool_destroy (conf->client_pool);
+                iot_weights_free (conf->weights, conf->weight_count);
+                iot_queues_fini (conf);
                 GF_FREE (conf);
+        }
 
 	return ret;
 }
@@ -2562,6 +3287,12 @@ fini (xlator_t *this)
 {
 	iot_conf_t *conf = this->private;
 
+        if (conf) {
+                iot_weights_free (conf->weights, conf->weight_count);
+                iot_queues_fini (conf);
+                if (conf->client_pool)
+                        mem_pool_destroy (conf->client_pool);
+        }
 	GF_FREE (conf);
 
 	this->private = NULL;
@@ -2611,11 +3342,19 @@ struct xlator_fops fops = {
         .xattrop     = iot_xattrop,
 	.fxattrop    = iot_fxattrop,
         .rchecksum   = iot_rchecksum,
+        .fallocate   = iot_fallocate,
+        .discard     = iot_discard,
+        .zerofill    = iot_zerofill,
+        .seek        = iot_seek,
 };
 
 struct xlator_cbks cbks = {
 };
 
+struct xlator_dumpops dumpops = {
+        .priv    = iot_priv_dump,
+};
+
 struct volume_options options[] = {
 	{ .key  = {"thread-count"},
 	  .type = GF_OPTION_TYPE_INT,
@@ -2667,6 +3406,22 @@ struct volume_options options[] = {
          .max   = 0x7fffffff,
          .default_value = "120",
         },
+        {.key   = {"work-queues"},
+         .type  = GF_OPTION_TYPE_INT,
+         .min   = 0,
+         .max   = IOT_MAX_QUEUES,
+         .default_value = "1",
+         .description = "Number of run queues requests are spread over. "
+                        "Workers prefer their own queue and steal from the "
+                        "others when it runs dry. 0 means one queue per "
+                        "online CPU. Only read when the volume starts."
+        },
+        {.key   = {"client-weights"},
+         .type  = GF_OPTION_TYPE_STR,
+         .description = "Comma separated <pattern>:<weight> pairs. Clients "
+                        "whose id matches the pattern get that many requests "
+                        "per round-robin turn within a priority (default 1)"
+        },
 	{ .key  = {NULL},
         },
 };
@@ -43,6 +43,14 @@ struct iot_conf;
 
 #define IOT_THREAD_STACK_SIZE   ((size_t)(1024*1024))
 
+#define IOT_CLIENT_HASH_SIZE    64
+#define IOT_DEFAULT_WEIGHT      1
+#define IOT_MAX_WEIGHT          1024
+
+#define IOT_MAX_QUEUES          64
+#define IOT_MIN_SPIN            4       /* polls before sleeping, adapted */
+#define IOT_MAX_SPIN            256     /* between these two per worker */
+
 
 typedef enum {
         IOT_PRI_HI = 0, /* low latency */
@@ -53,18 +61,66 @@ typedef enum {
 } iot_pri_t;
 
 
-struct iot_conf {
+/* Requests are queued per client (the connection on a brick, everything
+   else shares one) and the clients with work at a priority are served
+   round-robin, each taking up to 'weight' requests per turn. A client
+   only exists while it has requests queued. */
+struct iot_client {
+        struct list_head     hash;
+        struct list_head     ring[IOT_PRI_MAX];  /* in queue->clients[] */
+        struct list_head     reqs[IOT_PRI_MAX];
+        int                  queue_sizes[IOT_PRI_MAX];
+        int                  deficit[IOT_PRI_MAX];
+        int                  queue_size;
+        int                  weight;
+        void                *key;
+        const char          *id;
+};
+
+typedef struct iot_client iot_client_t;
+
+struct iot_weight {
+        char                *pattern;   /* fnmatch(3) on the client id */
+        int                  weight;
+};
+
+typedef struct iot_weight iot_weight_t;
+
+/* A run queue. Requests are enqueued on the queue of the cpu that
+   schedules them, every worker has a home queue it sleeps on and steals
+   from the others when its own has nothing runnable. With a single
+   queue this is the classic shared list. */
+struct iot_queue {
         pthread_mutex_t      mutex;
         pthread_cond_t       cond;
+        struct list_head     clients[IOT_PRI_MAX];
+        struct list_head     client_hash[IOT_CLIENT_HASH_SIZE];
+        int                  queue_sizes[IOT_PRI_MAX];
+        int                  queue_size;
+        int                  sleep_count;
+};
+
+typedef struct iot_queue iot_queue_t;
+
+struct iot_conf {
+        pthread_mutex_t      mutex;       /* thread count and weights */
 
         int32_t              max_count;   /* configured maximum */
         int32_t              curr_count;  /* actual number of threads running */
-        int32_t              sleep_count;
 
         int32_t              idle_time;   /* in seconds */
 
-        struct list_head     reqs[IOT_PRI_MAX];
+        iot_queue_t        **queues;
+        int                  queue_count;
+        int                  next_queue;  /* round-robin without a cpu */
+        int                  next_home;   /* home queue of the next worker */
+
+        struct mem_pool     *client_pool;
+
+        iot_weight_t        *weights;
+        int                  weight_count;
 
+        /* totals over all queues, updated atomically */
         int32_t              ac_iot_limit[IOT_PRI_MAX];
         int32_t              ac_iot_count[IOT_PRI_MAX];
         int                  queue_sizes[IOT_PRI_MAX];
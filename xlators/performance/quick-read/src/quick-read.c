@@ -3003,6 +3003,657 @@ ret:
 }
 
 
+int32_t
+qr_fallocate_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                  int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                  struct iatt *postbuf, dict_t *xdata)
+{
+        int32_t           ret      = 0;
+        uint64_t          value    = 0;
+        qr_inode_t       *qr_inode = NULL;
+        qr_local_t       *local    = NULL;
+        qr_private_t     *priv     = NULL;
+        qr_inode_table_t *table    = NULL;
+
+        GF_ASSERT (frame);
+
+        if (op_ret == -1) {
+                goto out;
+        }
+
+        local = frame->local;
+        if ((local == NULL) || (local->fd == NULL)
+            || (local->fd->inode == NULL)) {
+                op_ret = -1;
+                op_errno = EINVAL;
+                gf_log (frame->this->name, GF_LOG_WARNING, "cannot get inode");
+                goto out;
+        }
+
+        if ((this == NULL) || (this->private == NULL)) {
+                gf_log (frame->this->name, GF_LOG_WARNING,
+                        (this == NULL) ? "xlator object (this) is NULL"
+                        : "cannot get quick read configuration from xlator "
+                        "object");
+                op_ret = -1;
+                op_errno = EINVAL;
+                goto out;
+        }
+
+        priv = this->private;
+        table = &priv->table;
+
+        LOCK (&table->lock);
+        {
+                ret = inode_ctx_get (local->fd->inode, this, &value);
+                if (ret == 0) {
+                        qr_inode = (qr_inode_t *)(long) value;
+
+                        /* the cached content no longer matches the
+                           file, whether or not its size changed */
+                        if (qr_inode) {
+                                inode_ctx_del (local->fd->inode, this, NULL);
+                                __qr_inode_free (qr_inode);
+                        }
+                }
+        }
+        UNLOCK (&table->lock);
+
+out:
+        QR_STACK_UNWIND (fallocate, frame, op_ret, op_errno, prebuf,
+                         postbuf, xdata);
+        return 0;
+}
+
+
+int32_t
+qr_fallocate_helper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                     int32_t keep_size, off_t offset, size_t len, dict_t *xdata)
+{
+        qr_local_t  *local    = NULL;
+        qr_fd_ctx_t *fdctx    = NULL;
+        uint64_t     value    = 0;
+        int32_t      ret      = 0;
+        int32_t      op_errno = EINVAL;
+
+        GF_ASSERT (frame);
+
+        local = frame->local;
+        GF_VALIDATE_OR_GOTO (frame->this->name, local, unwind);
+        GF_VALIDATE_OR_GOTO (frame->this->name, this, unwind);
+        GF_VALIDATE_OR_GOTO (frame->this->name, fd, unwind);
+
+        if (local->op_ret < 0) {
+                op_errno = local->op_errno;
+
+                ret = fd_ctx_get (fd, this, &value);
+                if (ret == 0) {
+                        fdctx = (qr_fd_ctx_t *)(long) value;
+                }
+
+                gf_log (this->name, GF_LOG_WARNING,
+                        "open failed on path (%s) (%s), unwinding fallocate "
+                        "call",
+                        fdctx ? fdctx->path : NULL, strerror (op_errno));
+                goto unwind;
+        }
+
+        STACK_WIND (frame, qr_fallocate_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->fallocate, fd, keep_size, offset, len,
+                    xdata);
+        return 0;
+
+unwind:
+        QR_STACK_UNWIND (fallocate, frame, -1, op_errno, NULL, NULL, NULL);
+        return 0;
+}
+
+
+int32_t
+qr_fallocate (call_frame_t *frame, xlator_t *this, fd_t *fd,
+              int32_t keep_size, off_t offset, size_t len, dict_t *xdata)
+{
+        int           flags      = 0;
+        uint64_t      value      = 0;
+        call_stub_t  *stub       = NULL;
+        char         *path       = NULL;
+        loc_t         loc        = {0, };
+        qr_local_t   *local      = NULL;
+        qr_fd_ctx_t  *qr_fd_ctx  = NULL;
+        int32_t       ret        = -1, op_ret = -1, op_errno = EINVAL;
+        char          need_open  = 0, can_wind = 0, need_unwind = 0;
+        call_frame_t *open_frame = NULL;
+
+        GF_ASSERT (frame);
+        if ((this == NULL) || (fd == NULL)) {
+                gf_log (frame->this->name, GF_LOG_WARNING,
+                        (this == NULL) ? "xlator object (this) is NULL"
+                        : "fd is NULL");
+                need_unwind = 1;
+                goto out;
+        }
+
+        ret = fd_ctx_get (fd, this, &value);
+        if (ret == 0) {
+                qr_fd_ctx = (qr_fd_ctx_t *)(long)value;
+        }
+
+        local = qr_local_new (this);
+        if (local == NULL) {
+                op_ret = -1;
+                op_errno = ENOMEM;
+                need_unwind = 1;
+                goto out;
+        }
+
+        local->fd = fd;
+        frame->local = local;
+
+        if (qr_fd_ctx) {
+                LOCK (&qr_fd_ctx->lock);
+                {
+                        path = qr_fd_ctx->path;
+                        flags = qr_fd_ctx->flags;
+
+                        if (!(qr_fd_ctx->opened
+                              || qr_fd_ctx->open_in_transit)) {
+                                need_open = 1;
+                                qr_fd_ctx->open_in_transit = 1;
+                        }
+
+                        if (qr_fd_ctx->opened) {
+                                can_wind = 1;
+                        } else {
+                                stub = fop_fallocate_stub (frame,
+                                                           qr_fallocate_helper,
+                                                           fd, keep_size, offset, len,
+                                                           xdata);
+                                if (stub == NULL) {
+                                        op_ret = -1;
+                                        op_errno = ENOMEM;
+                                        need_unwind = 1;
+                                        qr_fd_ctx->open_in_transit = 0;
+                                        goto unlock;
+                                }
+
+                                list_add_tail (&stub->list,
+                                               &qr_fd_ctx->waiting_ops);
+                        }
+                }
+        unlock:
+                UNLOCK (&qr_fd_ctx->lock);
+        } else {
+                can_wind = 1;
+        }
+
+out:
+        if (need_unwind) {
+                QR_STACK_UNWIND (fallocate, frame, op_ret, op_errno, NULL,
+                                 NULL, NULL);
+        } else if (can_wind) {
+                STACK_WIND (frame, qr_fallocate_cbk, FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->fallocate, fd, keep_size, offset, len,
+                            xdata);
+        } else if (need_open) {
+                op_ret = qr_loc_fill (&loc, fd->inode, path);
+                if (op_ret == -1) {
+                        qr_resume_pending_ops (qr_fd_ctx, -1, errno);
+                        goto ret;
+                }
+
+                open_frame = create_frame (this, this->ctx->pool);
+                if (open_frame == NULL) {
+                        qr_resume_pending_ops (qr_fd_ctx, -1, ENOMEM);
+                        qr_loc_wipe (&loc);
+                        goto ret;
+                }
+
+                STACK_WIND (open_frame, qr_open_cbk, FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->open, &loc, flags, fd,
+                            NULL);
+
+                qr_loc_wipe (&loc);
+        }
+
+ret:
+        return 0;
+}
+
+
+int32_t
+qr_discard_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                struct iatt *postbuf, dict_t *xdata)
+{
+        int32_t           ret      = 0;
+        uint64_t          value    = 0;
+        qr_inode_t       *qr_inode = NULL;
+        qr_local_t       *local    = NULL;
+        qr_private_t     *priv     = NULL;
+        qr_inode_table_t *table    = NULL;
+
+        GF_ASSERT (frame);
+
+        if (op_ret == -1) {
+                goto out;
+        }
+
+        local = frame->local;
+        if ((local == NULL) || (local->fd == NULL)
+            || (local->fd->inode == NULL)) {
+                op_ret = -1;
+                op_errno = EINVAL;
+                gf_log (frame->this->name, GF_LOG_WARNING, "cannot get inode");
+                goto out;
+        }
+
+        if ((this == NULL) || (this->private == NULL)) {
+                gf_log (frame->this->name, GF_LOG_WARNING,
+                        (this == NULL) ? "xlator object (this) is NULL"
+                        : "cannot get quick read configuration from xlator "
+                        "object");
+                op_ret = -1;
+                op_errno = EINVAL;
+                goto out;
+        }
+
+        priv = this->private;
+        table = &priv->table;
+
+        LOCK (&table->lock);
+        {
+                ret = inode_ctx_get (local->fd->inode, this, &value);
+                if (ret == 0) {
+                        qr_inode = (qr_inode_t *)(long) value;
+
+                        /* the cached content no longer matches the
+                           file, whether or not its size changed */
+                        if (qr_inode) {
+                                inode_ctx_del (local->fd->inode, this, NULL);
+                                __qr_inode_free (qr_inode);
+                        }
+                }
+        }
+        UNLOCK (&table->lock);
+
+out:
+        QR_STACK_UNWIND (discard, frame, op_ret, op_errno, prebuf,
+                         postbuf, xdata);
+        return 0;
+}
+
+
+int32_t
+qr_discard_helper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                   off_t offset, size_t len, dict_t *xdata)
+{
+        qr_local_t  *local    = NULL;
+        qr_fd_ctx_t *fdctx    = NULL;
+        uint64_t     value    = 0;
+        int32_t      ret      = 0;
+        int32_t      op_errno = EINVAL;
+
+        GF_ASSERT (frame);
+
+        local = frame->local;
+        GF_VALIDATE_OR_GOTO (frame->this->name, local, unwind);
+        GF_VALIDATE_OR_GOTO (frame->this->name, this, unwind);
+        GF_VALIDATE_OR_GOTO (frame->this->name, fd, unwind);
+
+        if (local->op_ret < 0) {
+                op_errno = local->op_errno;
+
+                ret = fd_ctx_get (fd, this, &value);
+                if (ret == 0) {
+                        fdctx = (qr_fd_ctx_t *)(long) value;
+                }
+
+                gf_log (this->name, GF_LOG_WARNING,
+                        "open failed on path (%s) (%s), unwinding discard "
+                        "call",
+                        fdctx ? fdctx->path : NULL, strerror (op_errno));
+                goto unwind;
+        }
+
+        STACK_WIND (frame, qr_discard_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->discard, fd, offset, len,
+                    xdata);
+        return 0;
+
+unwind:
+        QR_STACK_UNWIND (discard, frame, -1, op_errno, NULL, NULL, NULL);
+        return 0;
+}
+
+
+int32_t
+qr_discard (call_frame_t *frame, xlator_t *this, fd_t *fd,
+            off_t offset, size_t len, dict_t *xdata)
+{
+        int           flags      = 0;
+        uint64_t      value      = 0;
+        call_stub_t  *stub       = NULL;
+        char         *path       = NULL;
+        loc_t         loc        = {0, };
+        qr_local_t   *local      = NULL;
+        qr_fd_ctx_t  *qr_fd_ctx  = NULL;
+        int32_t       ret        = -1, op_ret = -1, op_errno = EINVAL;
+        char          need_open  = 0, can_wind = 0, need_unwind = 0;
+        call_frame_t *open_frame = NULL;
+
+        GF_ASSERT (frame);
+        if ((this == NULL) || (fd == NULL)) {
+                gf_log (frame->this->name, GF_LOG_WARNING,
+                        (this == NULL) ? "xlator object (this) is NULL"
+                        : "fd is NULL");
+                need_unwind = 1;
+                goto out;
+        }
+
+        ret = fd_ctx_get (fd, this, &value);
+        if (ret == 0) {
+                qr_fd_ctx = (qr_fd_ctx_t *)(long)value;
+        }
+
+        local = qr_local_new (this);
+        if (local == NULL) {
+                op_ret = -1;
+                op_errno = ENOMEM;
+                need_unwind = 1;
+                goto out;
+        }
+
+        local->fd = fd;
+        frame->local = local;
+
+        if (qr_fd_ctx) {
+                LOCK (&qr_fd_ctx->lock);
+                {
+                        path = qr_fd_ctx->path;
+                        flags = qr_fd_ctx->flags;
+
+                        if (!(qr_fd_ctx->opened
+                              || qr_fd_ctx->open_in_transit)) {
+                                need_open = 1;
+                                qr_fd_ctx->open_in_transit = 1;
+                        }
+
+                        if (qr_fd_ctx->opened) {
+                                can_wind = 1;
+                        } else {
+                                stub = fop_discard_stub (frame,
+                                                         qr_discard_helper,
+                                                         fd, offset, len,
+                                                         xdata);
+                                if (stub == NULL) {
+                                        op_ret = -1;
+                                        op_errno = ENOMEM;
+                                        need_unwind = 1;
+                                        qr_fd_ctx->open_in_transit = 0;
+                                        goto unlock;
+                                }
+
+                                list_add_tail (&stub->list,
+                                               &qr_fd_ctx->waiting_ops);
+                        }
+                }
+        unlock:
+                UNLOCK (&qr_fd_ctx->lock);
+        } else {
+                can_wind = 1;
+        }
+
+out:
+        if (need_unwind) {
+                QR_STACK_UNWIND (discard, frame, op_ret, op_errno, NULL,
+                                 NULL, NULL);
+        } else if (can_wind) {
+                STACK_WIND (frame, qr_discard_cbk, FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->discard, fd, offset, len,
+                            xdata);
+        } else if (need_open) {
+                op_ret = qr_loc_fill (&loc, fd->inode, path);
+                if (op_ret == -1) {
+                        qr_resume_pending_ops (qr_fd_ctx, -1, errno);
+                        goto ret;
+                }
+
+                open_frame = create_frame (this, this->ctx->pool);
+                if (open_frame == NULL) {
+                        qr_resume_pending_ops (qr_fd_ctx, -1, ENOMEM);
+                        qr_loc_wipe (&loc);
+                        goto ret;
+                }
+
+                STACK_WIND (open_frame, qr_open_cbk, FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->open, &loc, flags, fd,
+                            NULL);
+
+                qr_loc_wipe (&loc);
+        }
+
+ret:
+        return 0;
+}
+
+
+int32_t
+qr_zerofill_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                 int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                 struct iatt *postbuf, dict_t *xdata)
+{
+        int32_t           ret      = 0;
+        uint64_t          value    = 0;
+        qr_inode_t       *qr_inode = NULL;
+        qr_local_t       *local    = NULL;
+        qr_private_t     *priv     = NULL;
+        qr_inode_table_t *table    = NULL;
+
+        GF_ASSERT (frame);
+
+        if (op_ret == -1) {
+                goto out;
+        }
+
+        local = frame->local;
+        if ((local == NULL) || (local->fd == NULL)
+            || (local->fd->inode == NULL)) {
+                op_ret = -1;
+                op_errno = EINVAL;
+                gf_log (frame->this->name, GF_LOG_WARNING, "cannot get inode");
+                goto out;
+        }
+
+        if ((this == NULL) || (this->private == NULL)) {
+                gf_log (frame->this->name, GF_LOG_WARNING,
+                        (this == NULL) ? "xlator object (this) is NULL"
+                        : "cannot get quick read configuration from xlator "
+                        "object");
+                op_ret = -1;
+                op_errno = EINVAL;
+                goto out;
+        }
+
+        priv = this->private;
+        table = &priv->table;
+
+        LOCK (&table->lock);
+        {
+                ret = inode_ctx_get (local->fd->inode, this, &value);
+                if (ret == 0) {
+                        qr_inode = (qr_inode_t *)(long) value;
+
+                        /* the cached content no longer matches the
+                           file, whether or not its size changed */
+                        if (qr_inode) {
+                                inode_ctx_del (local->fd->inode, this, NULL);
+                                __qr_inode_free (qr_inode);
+                        }
+                }
+        }
+        UNLOCK (&table->lock);
+
+out:
+        QR_STACK_UNWIND (zerofill, frame, op_ret, op_errno, prebuf,
+                         postbuf, xdata);
+        return 0;
+}
+
+
+int32_t
+qr_zerofill_helper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                    off_t offset, size_t len, dict_t *xdata)
+{
+        qr_local_t  *local    = NULL;
+        qr_fd_ctx_t *fdctx    = NULL;
+        uint64_t     value    = 0;
+        int32_t      ret      = 0;
+        int32_t      op_errno = EINVAL;
+
+        GF_ASSERT (frame);
+
+        local = frame->local;
+        GF_VALIDATE_OR_GOTO (frame->this->name, local, unwind);
+        GF_VALIDATE_OR_GOTO (frame->this->name, this, unwind);
+        GF_VALIDATE_OR_GOTO (frame->this->name, fd, unwind);
+
+        if (local->op_ret < 0) {
+                op_errno = local->op_errno;
+
+                ret = fd_ctx_get (fd, this, &value);
+                if (ret == 0) {
+                        fdctx = (qr_fd_ctx_t *)(long) value;
+                }
+
+                gf_log (this->name, GF_LOG_WARNING,
+                        "open failed on path (%s) (%s), unwinding zerofill "
+                        "call",
+                        fdctx ? fdctx->path : NULL, strerror (op_errno));
+                goto unwind;
+        }
+
+        STACK_WIND (frame, qr_zerofill_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->zerofill, fd, offset, len,
+                    xdata);
+        return 0;
+
+unwind:
+        QR_STACK_UNWIND (zerofill, frame, -1, op_errno, NULL, NULL, NULL);
+        return 0;
+}
+
+
+int32_t
+qr_zerofill (call_frame_t *frame, xlator_t *this, fd_t *fd,
+             off_t offset, size_t len, dict_t *xdata)
+{
+        int           flags      = 0;
+        uint64_t      value      = 0;
+        call_stub_t  *stub       = NULL;
+        char         *path       = NULL;
+        loc_t         loc        = {0, };
+        qr_local_t   *local      = NULL;
+        qr_fd_ctx_t  *qr_fd_ctx  = NULL;
+        int32_t       ret        = -1, op_ret = -1, op_errno = EINVAL;
+        char          need_open  = 0, can_wind = 0, need_unwind = 0;
+        call_frame_t *open_frame = NULL;
+
+        GF_ASSERT (frame);
+        if ((this == NULL) || (fd == NULL)) {
+                gf_log (frame->this->name, GF_LOG_WARNING,
+                        (this == NULL) ? "xlator object (this) is NULL"
+                        : "fd is NULL");
+                need_unwind = 1;
+                goto out;
+        }
+
+        ret = fd_ctx_get (fd, this, &value);
+        if (ret == 0) {
+                qr_fd_ctx = (qr_fd_ctx_t *)(long)value;
+        }
+
+        local = qr_local_new (this);
+        if (local == NULL) {
+                op_ret = -1;
+                op_errno = ENOMEM;
+                need_unwind = 1;
+                goto out;
+        }
+
+        local->fd = fd;
+        frame->local = local;
+
+        if (qr_fd_ctx) {
+                LOCK (&qr_fd_ctx->lock);
+                {
+                        path = qr_fd_ctx->path;
+                        flags = qr_fd_ctx->flags;
+
+                        if (!(qr_fd_ctx->opened
+                              || qr_fd_ctx->open_in_transit)) {
+                                need_open = 1;
+                                qr_fd_ctx->open_in_transit = 1;
+                        }
+
+                        if (qr_fd_ctx->opened) {
+                                can_wind = 1;
+                        } else {
+                                stub = fop_zerofill_stub (frame,
+                                                          qr_zerofill_helper,
+                                                          fd, offset, len,
+                                                          xdata);
+                                if (stub == NULL) {
+                                        op_ret = -1;
+                                        op_errno = ENOMEM;
+                                        need_unwind = 1;
+                                        qr_fd_ctx->open_in_transit = 0;
+                                        goto unlock;
+                                }
+
+                                list_add_tail (&stub->list,
+                                               &qr_fd_ctx->waiting_ops);
+                        }
+                }
+        unlock:
+                UNLOCK (&qr_fd_ctx->lock);
+        } else {
+                can_wind = 1;
+        }
+
+out:
+        if (need_unwind) {
+                QR_STACK_UNWIND (zerofill, frame, op_ret, op_errno, NULL,
+                                 NULL, NULL);
+        } else if (can_wind) {
+                STACK_WIND (frame, qr_zerofill_cbk, FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->zerofill, fd, offset, len,
+                            xdata);
+        } else if (need_open) {
+                op_ret = qr_loc_fill (&loc, fd->inode, path);
+                if (op_ret == -1) {
+                        qr_resume_pending_ops (qr_fd_ctx, -1, errno);
+                        goto ret;
+                }
+
+                open_frame = create_frame (this, this->ctx->pool);
+                if (open_frame == NULL) {
+                        qr_resume_pending_ops (qr_fd_ctx, -1, ENOMEM);
+                        qr_loc_wipe (&loc);
+                        goto ret;
+                }
+
+                STACK_WIND (open_frame, qr_open_cbk, FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->open, &loc, flags, fd,
+                            NULL);
+
+                qr_loc_wipe (&loc);
+        }
+
+ret:
+        return 0;
+}
+
+
 int32_t
 qr_lk_cbk (call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
            int32_t op_errno, struct gf_flock *lock, dict_t *xdata)
@@ -3931,6 +4582,9 @@ struct xlator_fops fops = {
         .finodelk    = qr_finodelk,
         .fsync       = qr_fsync,
         .ftruncate   = qr_ftruncate,
+        .fallocate   = qr_fallocate,
+        .discard     = qr_discard,
+        .zerofill    = qr_zerofill,
         .lk          = qr_lk,
         .fsetattr    = qr_fsetattr,
         .unlink      = qr_unlink,
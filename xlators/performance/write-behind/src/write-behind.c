@@ -886,6 +886,136 @@ unwind:
 }
 
 
+int32_t
+wb_seek_cbk (call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
+             int32_t op_errno, off_t offset, dict_t *xdata)
+{
+        wb_local_t   *local   = NULL;
+        wb_request_t *request = NULL;
+        wb_file_t    *file    = NULL;
+        int32_t       ret     = -1;
+
+        GF_ASSERT (frame);
+
+        local = frame->local;
+        file = local->file;
+
+        request = local->request;
+        if ((file != NULL) && (request != NULL)) {
+                wb_request_unref (request);
+                ret = wb_process_queue (frame, file);
+                if (ret == -1) {
+                        if (errno == ENOMEM) {
+                                op_ret = -1;
+                                op_errno = ENOMEM;
+                        }
+
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "request queue processing failed");
+                }
+        }
+
+        STACK_UNWIND_STRICT (seek, frame, op_ret, op_errno, offset, xdata);
+
+        return 0;
+}
+
+
+int32_t
+wb_seek_helper (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
+                gf_seek_what_t what, dict_t *xdata)
+{
+        GF_ASSERT (frame);
+        GF_ASSERT (this);
+
+        STACK_WIND (frame, wb_seek_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->seek, fd, offset, what, xdata);
+        return 0;
+}
+
+
+int32_t
+wb_seek (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
+         gf_seek_what_t what, dict_t *xdata)
+{
+        wb_file_t    *file     = NULL;
+        wb_local_t   *local    = NULL;
+        uint64_t      tmp_file = 0;
+        call_stub_t  *stub     = NULL;
+        wb_request_t *request  = NULL;
+        int32_t       ret      = -1;
+        int           op_errno = EINVAL;
+
+        GF_ASSERT (frame);
+        GF_VALIDATE_OR_GOTO (frame->this->name, this, unwind);
+        GF_VALIDATE_OR_GOTO (frame->this->name, fd, unwind);
+
+
+        if ((!IA_ISDIR (fd->inode->ia_type))
+            && fd_ctx_get (fd, this, &tmp_file)) {
+                file = wb_file_create (this, fd, 0);
+        } else {
+                file = (wb_file_t *)(long)tmp_file;
+                if ((!IA_ISDIR (fd->inode->ia_type)) && (file == NULL)) {
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "wb_file not found for fd %p", fd);
+                        op_errno = EBADFD;
+                        goto unwind;
+                }
+        }
+
+        local = mem_get0 (this->local_pool);
+        if (local == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        local->file = file;
+
+        frame->local = local;
+
+        /* pending writes decide where data and holes are, so the
+           seek has to queue behind them like fstat does */
+        if (file) {
+                stub = fop_seek_stub (frame, wb_seek_helper, fd, offset, what,
+                                      xdata);
+                if (stub == NULL) {
+                        op_errno = ENOMEM;
+                        goto unwind;
+                }
+
+                request = wb_enqueue (file, stub);
+                if (request == NULL) {
+                        op_errno = ENOMEM;
+                        goto unwind;
+                }
+
+                /*
+                  FIXME:should the request queue be emptied in case of error?
+                */
+                ret = wb_process_queue (frame, file);
+                if (ret == -1) {
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "request queue processing failed");
+                }
+        } else {
+                STACK_WIND (frame, wb_seek_cbk, FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->seek, fd, offset, what, xdata);
+        }
+
+        return 0;
+
+unwind:
+        STACK_UNWIND_STRICT (seek, frame, -1, op_errno, 0, NULL);
+
+        if (stub) {
+                call_stub_destroy (stub);
+        }
+
+        return 0;
+}
+
+
 int32_t
 wb_truncate_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
                  int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
@@ -1171,6 +1301,393 @@ unwind:
 }
 
 
+int32_t
+wb_fallocate_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                  int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                  struct iatt *postbuf, dict_t *xdata)
+{
+        wb_local_t   *local   = NULL;
+        wb_request_t *request = NULL;
+        wb_file_t    *file    = NULL;
+        int32_t       ret     = -1;
+
+        GF_ASSERT (frame);
+
+        local = frame->local;
+        file = local->file;
+        request = local->request;
+
+        if ((request != NULL) && (file != NULL)) {
+                wb_request_unref (request);
+                ret = wb_process_queue (frame, file);
+                if (ret == -1) {
+                        if (errno == ENOMEM) {
+                                op_ret = -1;
+                                op_errno = ENOMEM;
+                        }
+
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "request queue processing failed");
+                }
+        }
+
+        STACK_UNWIND_STRICT (fallocate, frame, op_ret, op_errno, prebuf,
+                             postbuf, xdata);
+
+        return 0;
+}
+
+
+static int32_t
+wb_fallocate_helper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                     int32_t keep_size, off_t offset, size_t len, dict_t *xdata)
+{
+        GF_ASSERT (frame);
+        GF_ASSERT (this);
+
+        STACK_WIND (frame, wb_fallocate_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->fallocate, fd, keep_size, offset, len,
+                    xdata);
+        return 0;
+}
+
+
+int32_t
+wb_fallocate (call_frame_t *frame, xlator_t *this, fd_t *fd,
+              int32_t keep_size, off_t offset, size_t len, dict_t *xdata)
+{
+        wb_file_t    *file     = NULL;
+        wb_local_t   *local    = NULL;
+        uint64_t      tmp_file = 0;
+        call_stub_t  *stub     = NULL;
+        wb_request_t *request  = NULL;
+        int32_t       ret      = -1;
+        int           op_errno = EINVAL;
+
+        GF_ASSERT (frame);
+        GF_VALIDATE_OR_GOTO (frame->this->name, this, unwind);
+        GF_VALIDATE_OR_GOTO (frame->this->name, fd, unwind);
+
+
+        if ((!IA_ISDIR (fd->inode->ia_type))
+            && fd_ctx_get (fd, this, &tmp_file)) {
+                file = wb_file_create (this, fd, 0);
+        } else {
+                file = (wb_file_t *)(long)tmp_file;
+                if ((!IA_ISDIR (fd->inode->ia_type)) && (file == NULL)) {
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "wb_file not found for fd %p", fd);
+                        op_errno = EBADFD;
+                        goto unwind;
+                }
+        }
+
+        local = mem_get0 (this->local_pool);
+        if (local == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        local->file = file;
+
+        frame->local = local;
+
+        if (file) {
+                stub = fop_fallocate_stub (frame, wb_fallocate_helper, fd,
+                                           keep_size, offset, len, xdata);
+                if (stub == NULL) {
+                        op_errno = ENOMEM;
+                        goto unwind;
+                }
+
+                request = wb_enqueue (file, stub);
+                if (request == NULL) {
+                        op_errno = ENOMEM;
+                        goto unwind;
+                }
+
+                ret = wb_process_queue (frame, file);
+                if (ret == -1) {
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "request queue processing failed");
+                }
+        } else {
+                STACK_WIND (frame, wb_fallocate_cbk, FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->fallocate, fd, keep_size, offset, len,
+                            xdata);
+        }
+
+        return 0;
+
+unwind:
+        STACK_UNWIND_STRICT (fallocate, frame, -1, op_errno, NULL, NULL, NULL);
+
+        if (stub) {
+                call_stub_destroy (stub);
+        }
+
+        return 0;
+}
+
+
+int32_t
+wb_discard_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                struct iatt *postbuf, dict_t *xdata)
+{
+        wb_local_t   *local   = NULL;
+        wb_request_t *request = NULL;
+        wb_file_t    *file    = NULL;
+        int32_t       ret     = -1;
+
+        GF_ASSERT (frame);
+
+        local = frame->local;
+        file = local->file;
+        request = local->request;
+
+        if ((request != NULL) && (file != NULL)) {
+                wb_request_unref (request);
+                ret = wb_process_queue (frame, file);
+                if (ret == -1) {
+                        if (errno == ENOMEM) {
+                                op_ret = -1;
+                                op_errno = ENOMEM;
+                        }
+
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "request queue processing failed");
+                }
+        }
+
+        STACK_UNWIND_STRICT (discard, frame, op_ret, op_errno, prebuf,
+                             postbuf, xdata);
+
+        return 0;
+}
+
+
+static int32_t
+wb_discard_helper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                   off_t offset, size_t len, dict_t *xdata)
+{
+        GF_ASSERT (frame);
+        GF_ASSERT (this);
+
+        STACK_WIND (frame, wb_discard_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->discard, fd, offset, len,
+                    xdata);
+        return 0;
+}
+
+
+int32_t
+wb_discard (call_frame_t *frame, xlator_t *this, fd_t *fd,
+            off_t offset, size_t len, dict_t *xdata)
+{
+        wb_file_t    *file     = NULL;
+        wb_local_t   *local    = NULL;
+        uint64_t      tmp_file = 0;
+        call_stub_t  *stub     = NULL;
+        wb_request_t *request  = NULL;
+        int32_t       ret      = -1;
+        int           op_errno = EINVAL;
+
+        GF_ASSERT (frame);
+        GF_VALIDATE_OR_GOTO (frame->this->name, this, unwind);
+        GF_VALIDATE_OR_GOTO (frame->this->name, fd, unwind);
+
+
+        if ((!IA_ISDIR (fd->inode->ia_type))
+            && fd_ctx_get (fd, this, &tmp_file)) {
+                file = wb_file_create (this, fd, 0);
+        } else {
+                file = (wb_file_t *)(long)tmp_file;
+                if ((!IA_ISDIR (fd->inode->ia_type)) && (file == NULL)) {
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "wb_file not found for fd %p", fd);
+                        op_errno = EBADFD;
+                        goto unwind;
+                }
+        }
+
+        local = mem_get0 (this->local_pool);
+        if (local == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        local->file = file;
+
+        frame->local = local;
+
+        if (file) {
+                stub = fop_discard_stub (frame, wb_discard_helper, fd,
+                                         offset, len, xdata);
+                if (stub == NULL) {
+                        op_errno = ENOMEM;
+                        goto unwind;
+                }
+
+                request = wb_enqueue (file, stub);
+                if (request == NULL) {
+                        op_errno = ENOMEM;
+                        goto unwind;
+                }
+
+                ret = wb_process_queue (frame, file);
+                if (ret == -1) {
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "request queue processing failed");
+                }
+        } else {
+                STACK_WIND (frame, wb_discard_cbk, FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->discard, fd, offset, len,
+                            xdata);
+        }
+
+        return 0;
+
+unwind:
+        STACK_UNWIND_STRICT (discard, frame, -1, op_errno, NULL, NULL, NULL);
+
+        if (stub) {
+                call_stub_destroy (stub);
+        }
+
+        return 0;
+}
+
+
+int32_t
+wb_zerofill_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                 int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                 struct iatt *postbuf, dict_t *xdata)
+{
+        wb_local_t   *local   = NULL;
+        wb_request_t *request = NULL;
+        wb_file_t    *file    = NULL;
+        int32_t       ret     = -1;
+
+        GF_ASSERT (frame);
+
+        local = frame->local;
+        file = local->file;
+        request = local->request;
+
+        if ((request != NULL) && (file != NULL)) {
+                wb_request_unref (request);
+                ret = wb_process_queue (frame, file);
+                if (ret == -1) {
+                        if (errno == ENOMEM) {
+                                op_ret = -1;
+                                op_errno = ENOMEM;
+                        }
+
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "request queue processing failed");
+                }
+        }
+
+        STACK_UNWIND_STRICT (zerofill, frame, op_ret, op_errno, prebuf,
+                             postbuf, xdata);
+
+        return 0;
+}
+
+
+static int32_t
+wb_zerofill_helper (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                    off_t offset, size_t len, dict_t *xdata)
+{
+        GF_ASSERT (frame);
+        GF_ASSERT (this);
+
+        STACK_WIND (frame, wb_zerofill_cbk, FIRST_CHILD(this),
+                    FIRST_CHILD(this)->fops->zerofill, fd, offset, len,
+                    xdata);
+        return 0;
+}
+
+
+int32_t
+wb_zerofill (call_frame_t *frame, xlator_t *this, fd_t *fd,
+             off_t offset, size_t len, dict_t *xdata)
+{
+        wb_file_t    *file     = NULL;
+        wb_local_t   *local    = NULL;
+        uint64_t      tmp_file = 0;
+        call_stub_t  *stub     = NULL;
+        wb_request_t *request  = NULL;
+        int32_t       ret      = -1;
+        int           op_errno = EINVAL;
+
+        GF_ASSERT (frame);
+        GF_VALIDATE_OR_GOTO (frame->this->name, this, unwind);
+        GF_VALIDATE_OR_GOTO (frame->this->name, fd, unwind);
+
+
+        if ((!IA_ISDIR (fd->inode->ia_type))
+            && fd_ctx_get (fd, this, &tmp_file)) {
+                file = wb_file_create (this, fd, 0);
+        } else {
+                file = (wb_file_t *)(long)tmp_file;
+                if ((!IA_ISDIR (fd->inode->ia_type)) && (file == NULL)) {
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "wb_file not found for fd %p", fd);
+                        op_errno = EBADFD;
+                        goto unwind;
+                }
+        }
+
+        local = mem_get0 (this->local_pool);
+        if (local == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        local->file = file;
+
+        frame->local = local;
+
+        if (file) {
+                stub = fop_zerofill_stub (frame, wb_zerofill_helper, fd,
+                                          offset, len, xdata);
+                if (stub == NULL) {
+                        op_errno = ENOMEM;
+                        goto unwind;
+                }
+
+                request = wb_enqueue (file, stub);
+                if (request == NULL) {
+                        op_errno = ENOMEM;
+                        goto unwind;
+                }
+
+                ret = wb_process_queue (frame, file);
+                if (ret == -1) {
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "request queue processing failed");
+                }
+        } else {
+                STACK_WIND (frame, wb_zerofill_cbk, FIRST_CHILD(this),
+                            FIRST_CHILD(this)->fops->zerofill, fd, offset, len,
+                            xdata);
+        }
+
+        return 0;
+
+unwind:
+        STACK_UNWIND_STRICT (zerofill, frame, -1, op_errno, NULL, NULL, NULL);
+
+        if (stub) {
+                call_stub_destroy (stub);
+        }
+
+        return 0;
+}
+
+
 int32_t
 wb_setattr_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
                 int32_t op_ret, int32_t op_errno, struct iatt *statpre,
@@ -3001,6 +3518,10 @@ struct xlator_fops fops = {
         .fstat       = wb_fstat,
         .truncate    = wb_truncate,
         .ftruncate   = wb_ftruncate,
+        .fallocate   = wb_fallocate,
+        .discard     = wb_discard,
+        .zerofill    = wb_zerofill,
+        .seek        = wb_seek,
         .setattr     = wb_setattr,
 };
 
@@ -1294,6 +1294,7 @@ client_setvolume_cbk (struct rpc_req *req, struct iovec *iov, int count, void *m
         int32_t               op_errno      = 0;
         gf_boolean_t          auth_fail     = _gf_false;
         uint32_t              lk_ver        = 0;
+        uint32_t              compound_fops = 0;
 
         frame = myframe;
         this  = frame->this;
@@ -1383,6 +1384,13 @@ client_setvolume_cbk (struct rpc_req *req, struct iovec *iov, int count, void *m
 
         gf_log (this->name, GF_LOG_DEBUG, "clnt-lk-version = %d, "
                 "server-lk-version = %d", client_get_lk_ver (conf), lk_ver);
+
+        ret = dict_get_uint32 (reply, "compound-fops", &compound_fops);
+        if (ret)
+                compound_fops = 0;
+        conf->compound_fops = compound_fops;
+        gf_log (this->name, GF_LOG_DEBUG, "compound-fops = %u",
+                compound_fops);
         /* TODO: currently setpeer path is broken */
         /*
         if (process_uuid && req->conn &&
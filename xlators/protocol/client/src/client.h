@@ -109,6 +109,9 @@ typedef struct clnt_conf {
                                                       means dont register, true
                                                       means register */
         char                   parent_down;
+        uint32_t               compound_fops; /* most fops the server takes
+                                                 in a compound, 0 if it
+                                                 knows none */
 } clnt_conf_t;
 
 typedef struct _client_fd_ctx {
@@ -154,6 +157,7 @@ typedef struct client_local {
         struct list_head     lock_list;
         pthread_mutex_t      mutex;
         char           *name;
+        int32_t              count;     /* compound: fops sent */
 } clnt_local_t;
 
 typedef struct client_args {
@@ -187,6 +191,7 @@ typedef struct client_args {
 
         mode_t              umask;
         dict_t             *xdata;
+        compound_args_t    *compound;
 } clnt_args_t;
 
 typedef ssize_t (*gfs_serialize_t) (struct iovec outmsg, void *args);
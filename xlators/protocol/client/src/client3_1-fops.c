@@ -1964,18 +1964,17 @@ out:
         return 0;
 }
 
-
 int
-client3_1_setattr_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                       void *myframe)
+client3_1_fallocate_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                         void *myframe)
 {
         call_frame_t    *frame      = NULL;
-        gfs3_setattr_rsp rsp        = {0,};
+        gfs3_fallocate_rsp rsp        = {0,};
         struct iatt      prestat    = {0,};
         struct iatt      poststat   = {0,};
         int              ret        = 0;
-        xlator_t *this       = NULL;
-        dict_t  *xdata       = NULL;
+        xlator_t        *this       = NULL;
+        dict_t          *xdata      = NULL;
 
 
         this = THIS;
@@ -1987,8 +1986,7 @@ client3_1_setattr_cbk (struct rpc_req *req, struct iovec *iov, int count,
                 rsp.op_errno = ENOTCONN;
                 goto out;
         }
-
-        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_setattr_rsp);
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_fallocate_rsp);
         if (ret < 0) {
                 gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
                 rsp.op_ret   = -1;
@@ -2010,7 +2008,7 @@ out:
                 gf_log (this->name, GF_LOG_WARNING, "remote operation failed: %s",
                         strerror (gf_error_to_errno (rsp.op_errno)));
         }
-        CLIENT_STACK_UNWIND (setattr, frame, rsp.op_ret,
+        CLIENT_STACK_UNWIND (fallocate, frame, rsp.op_ret,
                              gf_error_to_errno (rsp.op_errno), &prestat,
                              &poststat, xdata);
 
@@ -2024,35 +2022,28 @@ out:
 }
 
 int
-client3_1_create_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                      void *myframe)
+client3_1_discard_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                       void *myframe)
 {
         call_frame_t    *frame      = NULL;
-        fd_t            *fd         = NULL;
-        inode_t         *inode      = NULL;
-        struct iatt      stbuf      = {0, };
-        struct iatt      preparent  = {0, };
-        struct iatt      postparent = {0, };
-        int32_t          ret        = -1;
-        clnt_local_t    *local      = NULL;
-        gfs3_create_rsp  rsp        = {0,};
-        xlator_t *this       = NULL;
-        dict_t  *xdata       = NULL;
+        gfs3_discard_rsp rsp        = {0,};
+        struct iatt      prestat    = {0,};
+        struct iatt      poststat   = {0,};
+        int              ret        = 0;
+        xlator_t        *this       = NULL;
+        dict_t          *xdata      = NULL;
+
 
         this = THIS;
 
         frame = myframe;
-        local = frame->local;
-        fd    = local->fd;
-        inode = local->loc.inode;
 
         if (-1 == req->rpc_status) {
                 rsp.op_ret   = -1;
                 rsp.op_errno = ENOTCONN;
                 goto out;
         }
-
-        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_create_rsp);
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_discard_rsp);
         if (ret < 0) {
                 gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
                 rsp.op_ret   = -1;
@@ -2061,19 +2052,8 @@ client3_1_create_cbk (struct rpc_req *req, struct iovec *iov, int count,
         }
 
         if (-1 != rsp.op_ret) {
-                gf_stat_to_iatt (&rsp.stat, &stbuf);
-
-                gf_stat_to_iatt (&rsp.preparent, &preparent);
-                gf_stat_to_iatt (&rsp.postparent, &postparent);
-                uuid_copy (local->loc.gfid, stbuf.ia_gfid);
-                ret = client_add_fd_to_saved_fds (frame->this, fd, &local->loc,
-                                                  local->flags, 0,
-                                                  rsp.fd, 0);
-                if (ret) {
-                        rsp.op_ret = -1;
-                        rsp.op_errno = -ret;
-                        goto out;
-                }
+                gf_stat_to_iatt (&rsp.statpre, &prestat);
+                gf_stat_to_iatt (&rsp.statpost, &poststat);
         }
 
         GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
@@ -2082,17 +2062,12 @@ client3_1_create_cbk (struct rpc_req *req, struct iovec *iov, int count,
 
 out:
         if (rsp.op_ret == -1) {
-                gf_log (this->name, GF_LOG_WARNING,
-                        "remote operation failed: %s. Path: %s (%s)",
-                        strerror (gf_error_to_errno (rsp.op_errno)),
-                        (local) ? local->loc.path : "--",
-                        (local && local->loc.inode) ?
-                        uuid_utoa (local->loc.inode->gfid) : "--");
+                gf_log (this->name, GF_LOG_WARNING, "remote operation failed: %s",
+                        strerror (gf_error_to_errno (rsp.op_errno)));
         }
-
-        CLIENT_STACK_UNWIND (create, frame, rsp.op_ret,
-                             gf_error_to_errno (rsp.op_errno), fd, inode,
-                             &stbuf, &preparent, &postparent, xdata);
+        CLIENT_STACK_UNWIND (discard, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno), &prestat,
+                             &poststat, xdata);
 
         if (rsp.xdata.xdata_val)
                 free (rsp.xdata.xdata_val);
@@ -2103,16 +2078,17 @@ out:
         return 0;
 }
 
-
 int
-client3_1_rchecksum_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                         void *myframe)
+client3_1_zerofill_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                        void *myframe)
 {
-        call_frame_t *frame = NULL;
-        gfs3_rchecksum_rsp rsp        = {0,};
+        call_frame_t    *frame      = NULL;
+        gfs3_zerofill_rsp rsp        = {0,};
+        struct iatt      prestat    = {0,};
+        struct iatt      poststat   = {0,};
         int              ret        = 0;
-        xlator_t *this       = NULL;
-        dict_t  *xdata       = NULL;
+        xlator_t        *this       = NULL;
+        dict_t          *xdata      = NULL;
 
 
         this = THIS;
@@ -2124,8 +2100,7 @@ client3_1_rchecksum_cbk (struct rpc_req *req, struct iovec *iov, int count,
                 rsp.op_errno = ENOTCONN;
                 goto out;
         }
-
-        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_rchecksum_rsp);
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_zerofill_rsp);
         if (ret < 0) {
                 gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
                 rsp.op_ret   = -1;
@@ -2133,6 +2108,11 @@ client3_1_rchecksum_cbk (struct rpc_req *req, struct iovec *iov, int count,
                 goto out;
         }
 
+        if (-1 != rsp.op_ret) {
+                gf_stat_to_iatt (&rsp.statpre, &prestat);
+                gf_stat_to_iatt (&rsp.statpost, &poststat);
+        }
+
         GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
                                       (rsp.xdata.xdata_len), ret,
                                       rsp.op_errno, out);
@@ -2142,17 +2122,9 @@ out:
                 gf_log (this->name, GF_LOG_WARNING, "remote operation failed: %s",
                         strerror (gf_error_to_errno (rsp.op_errno)));
         }
-        CLIENT_STACK_UNWIND (rchecksum, frame, rsp.op_ret,
-                             gf_error_to_errno (rsp.op_errno),
-                             rsp.weak_checksum,
-                             (uint8_t *)rsp.strong_checksum.strong_checksum_val,
-                             xdata);
-
-        if (rsp.strong_checksum.strong_checksum_val) {
-                /* This is allocated by the libc while decoding RPC msg */
-                /* Hence no 'GF_FREE', but just 'free' */
-                free (rsp.strong_checksum.strong_checksum_val);
-        }
+        CLIENT_STACK_UNWIND (zerofill, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno), &prestat,
+                             &poststat, xdata);
 
         if (rsp.xdata.xdata_val)
                 free (rsp.xdata.xdata_val);
@@ -2164,29 +2136,26 @@ out:
 }
 
 int
-client3_1_lk_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                  void *myframe)
+client3_1_seek_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                    void *myframe)
 {
         call_frame_t    *frame      = NULL;
-        clnt_local_t  *local      = NULL;
-        struct gf_flock     lock       = {0,};
-        gfs3_lk_rsp      rsp        = {0,};
+        gfs3_seek_rsp    rsp        = {0,};
         int              ret        = 0;
-        xlator_t *this       = NULL;
-        dict_t  *xdata       = NULL;
+        xlator_t        *this       = NULL;
+        dict_t          *xdata      = NULL;
+
 
         this = THIS;
 
         frame = myframe;
-        local = frame->local;
 
         if (-1 == req->rpc_status) {
                 rsp.op_ret   = -1;
                 rsp.op_errno = ENOTCONN;
                 goto out;
         }
-
-        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_lk_rsp);
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_seek_rsp);
         if (ret < 0) {
                 gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
                 rsp.op_ret   = -1;
@@ -2194,45 +2163,25 @@ client3_1_lk_cbk (struct rpc_req *req, struct iovec *iov, int count,
                 goto out;
         }
 
-        if (rsp.op_ret >= 0) {
-                gf_proto_flock_to_flock (&rsp.flock, &lock);
-        }
-
-        /* Save the lock to the client lock cache to be able
-           to recover in the case of server reboot.*/
-        /*
-          temporarily
-        if (local->cmd == F_SETLK || local->cmd == F_SETLKW) {
-                ret = client_add_lock_for_recovery (local->fd, &lock,
-                                                    local->owner, local->cmd);
-                if (ret < 0) {
-                        rsp.op_ret = -1;
-                        rsp.op_errno = -ret;
-                }
-        }
-        */
-
         GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
                                       (rsp.xdata.xdata_len), ret,
                                       rsp.op_errno, out);
 
 out:
+        /* ENXIO only says there is no more data (or hole) past the
+           offset, which the callers use to stop scanning */
         if ((rsp.op_ret == -1) &&
-            (EAGAIN != gf_error_to_errno (rsp.op_errno))) {
-                gf_log (this->name, GF_LOG_WARNING,
-                        "remote operation failed: %s",
+            (gf_error_to_errno (rsp.op_errno) != ENXIO)) {
+                gf_log (this->name, GF_LOG_WARNING, "remote operation failed: %s",
                         strerror (gf_error_to_errno (rsp.op_errno)));
         }
-
-        CLIENT_STACK_UNWIND (lk, frame, rsp.op_ret,
-                             gf_error_to_errno (rsp.op_errno), &lock, xdata);
+        CLIENT_STACK_UNWIND (seek, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno), rsp.offset,
+                             xdata);
 
         if (rsp.xdata.xdata_val)
                 free (rsp.xdata.xdata_val);
 
-        if (rsp.flock.lk_owner.lk_owner_val)
-                free (rsp.flock.lk_owner.lk_owner_val);
-
         if (xdata)
                 dict_unref (xdata);
 
@@ -2240,16 +2189,29 @@ out:
 }
 
 int
-client3_1_readdir_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                       void *myframe)
+client3_1_compound_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                        void *myframe)
 {
-        call_frame_t     *frame    = NULL;
-        gfs3_readdir_rsp  rsp      = {0,};
-        int32_t           ret      = 0;
-        clnt_local_t     *local    = NULL;
-        gf_dirent_t       entries;
-        xlator_t         *this     = NULL;
-        dict_t           *xdata    = NULL;
+        call_frame_t        *frame     = NULL;
+        gfs3_compound_rsp    rsp       = {0,};
+        gfs3_compound_rsp_u *wire      = NULL;
+        gf_common_rsp       *common    = NULL;
+        gfs3_xattrop_rsp    *xrsp      = NULL;
+        gfs3_fxattrop_rsp   *fxrsp     = NULL;
+        gfs3_write_rsp      *wrsp      = NULL;
+        compound_rsp_t      *crsp      = NULL;
+        compound_rsp_t      *reply     = NULL;
+        compound_fop_rsp_t  *frsp      = NULL;
+        clnt_local_t        *local     = NULL;
+        char               **dict_val  = NULL;
+        u_int                dict_len  = 0;
+        char               **xdata_val = NULL;
+        u_int                xdata_len = 0;
+        dict_t              *xdata     = NULL;
+        int                  op_errno  = 0;
+        int                  ret       = 0;
+        int                  i         = 0;
+        xlator_t            *this      = NULL;
 
         this = THIS;
 
@@ -2258,70 +2220,159 @@ client3_1_readdir_cbk (struct rpc_req *req, struct iovec *iov, int count,
 
         if (-1 == req->rpc_status) {
                 rsp.op_ret   = -1;
-                rsp.op_errno = ENOTCONN;
+                op_errno = ENOTCONN;
                 goto out;
         }
 
-        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_readdir_rsp);
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_compound_rsp);
         if (ret < 0) {
                 gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
                 rsp.op_ret   = -1;
-                rsp.op_errno = EINVAL;
+                op_errno = EINVAL;
                 goto out;
         }
 
-        INIT_LIST_HEAD (&entries.list);
-        if (rsp.op_ret > 0) {
-                unserialize_rsp_dirent (&rsp, &entries);
+        if (rsp.fops.fops_len > local->count) {
+                gf_log (this->name, GF_LOG_ERROR, "%u replies for %d fops",
+                        rsp.fops.fops_len, local->count);
+                rsp.op_ret   = -1;
+                op_errno = EINVAL;
+                goto out;
         }
 
-        GF_PROTOCOL_DICT_UNSERIALIZE (frame->this, xdata,
-                                      (rsp.xdata.xdata_val),
+        crsp = compound_rsp_new (local->count);
+        if (!crsp) {
+                rsp.op_ret   = -1;
+                op_errno = ENOMEM;
+                goto out;
+        }
+
+        for (i = 0; i < rsp.fops.fops_len; i++) {
+                wire = &rsp.fops.fops_val[i];
+                frsp = &crsp->rsps[i];
+                common = NULL;
+                dict_val = NULL;
+                xdata_val = NULL;
+
+                switch (wire->fop) {
+                case GFS3_COMPOUND_XATTROP:
+                        xrsp = &wire->gfs3_compound_rsp_u_u.xattrop_rsp;
+                        frsp->op_ret = xrsp->op_ret;
+                        frsp->op_errno = xrsp->op_errno;
+                        dict_val = &xrsp->dict.dict_val;
+                        dict_len = xrsp->dict.dict_len;
+                        xdata_val = &xrsp->xdata.xdata_val;
+                        xdata_len = xrsp->xdata.xdata_len;
+                        break;
+                case GFS3_COMPOUND_FXATTROP:
+                        fxrsp = &wire->gfs3_compound_rsp_u_u.fxattrop_rsp;
+                        frsp->op_ret = fxrsp->op_ret;
+                        frsp->op_errno = fxrsp->op_errno;
+                        dict_val = &fxrsp->dict.dict_val;
+                        dict_len = fxrsp->dict.dict_len;
+                        xdata_val = &fxrsp->xdata.xdata_val;
+                        xdata_len = fxrsp->xdata.xdata_len;
+                        break;
+                case GFS3_COMPOUND_WRITE:
+                        wrsp = &wire->gfs3_compound_rsp_u_u.write_rsp;
+                        frsp->op_ret = wrsp->op_ret;
+                        frsp->op_errno = wrsp->op_errno;
+                        if (wrsp->op_ret != -1) {
+                                gf_stat_to_iatt (&wrsp->prestat,
+                                                 &frsp->prebuf);
+                                gf_stat_to_iatt (&wrsp->poststat,
+                                                 &frsp->postbuf);
+                        }
+                        xdata_val = &wrsp->xdata.xdata_val;
+                        xdata_len = wrsp->xdata.xdata_len;
+                        break;
+                case GFS3_COMPOUND_INODELK:
+                        common = &wire->gfs3_compound_rsp_u_u.inodelk_rsp;
+                        break;
+                case GFS3_COMPOUND_FINODELK:
+                        common = &wire->gfs3_compound_rsp_u_u.finodelk_rsp;
+                        break;
+                case GFS3_COMPOUND_ENTRYLK:
+                        common = &wire->gfs3_compound_rsp_u_u.entrylk_rsp;
+                        break;
+                case GFS3_COMPOUND_FENTRYLK:
+                        common = &wire->gfs3_compound_rsp_u_u.fentrylk_rsp;
+                        break;
+                case GFS3_COMPOUND_SETXATTR:
+                        common = &wire->gfs3_compound_rsp_u_u.setxattr_rsp;
+                        break;
+                case GFS3_COMPOUND_FSETXATTR:
+                        common = &wire->gfs3_compound_rsp_u_u.fsetxattr_rsp;
+                        break;
+                }
+
+                if (common) {
+                        frsp->op_ret = common->op_ret;
+                        frsp->op_errno = common->op_errno;
+                        xdata_val = &common->xdata.xdata_val;
+                        xdata_len = common->xdata.xdata_len;
+                }
+                frsp->op_errno = gf_error_to_errno (frsp->op_errno);
+
+                if (dict_val && (frsp->op_ret != -1)) {
+                        GF_PROTOCOL_DICT_UNSERIALIZE (this, frsp->dict,
+                                                      (*dict_val), dict_len,
+                                                      rsp.op_ret, op_errno,
+                                                      out);
+                }
+
+                if (xdata_val) {
+                        GF_PROTOCOL_DICT_UNSERIALIZE (this, frsp->xdata,
+                                                      (*xdata_val), xdata_len,
+                                                      rsp.op_ret, op_errno,
+                                                      out);
+                }
+        }
+
+        GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
                                       (rsp.xdata.xdata_len), rsp.op_ret,
-                                      rsp.op_errno, out);
+                                      op_errno, out);
 
+        /* the reply is complete, hand the results over */
+        op_errno = rsp.op_errno;
+        reply = crsp;
 out:
         if (rsp.op_ret == -1) {
                 gf_log (this->name, GF_LOG_WARNING,
-                        "remote operation failed: %s remote_fd = %d",
-                        strerror (gf_error_to_errno (rsp.op_errno)),
-                                  local->cmd);
+                        "remote operation failed: %s",
+                        strerror (gf_error_to_errno (op_errno)));
         }
-        CLIENT_STACK_UNWIND (readdir, frame, rsp.op_ret,
-                             gf_error_to_errno (rsp.op_errno), &entries, xdata);
+        CLIENT_STACK_UNWIND (compound, frame, rsp.op_ret,
+                             gf_error_to_errno (op_errno), reply, xdata);
 
-        if (rsp.op_ret != -1) {
-                gf_dirent_free (&entries);
-        }
+        xdr_free ((xdrproc_t)xdr_gfs3_compound_rsp, (char *)&rsp);
 
-        if (rsp.xdata.xdata_val)
-                free (rsp.xdata.xdata_val);
+        if (crsp)
+                compound_rsp_destroy (crsp);
 
         if (xdata)
                 dict_unref (xdata);
 
-        clnt_readdir_rsp_cleanup (&rsp);
-
         return 0;
 }
 
 
 int
-client3_1_readdirp_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                        void *myframe)
+client3_1_setattr_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                       void *myframe)
 {
-        call_frame_t      *frame = NULL;
-        gfs3_readdirp_rsp  rsp   = {0,};
-        int32_t            ret   = 0;
-        clnt_local_t      *local = NULL;
-        gf_dirent_t        entries;
-        xlator_t          *this  = NULL;
-        dict_t            *xdata = NULL;
+        call_frame_t    *frame      = NULL;
+        gfs3_setattr_rsp rsp        = {0,};
+        struct iatt      prestat    = {0,};
+        struct iatt      poststat   = {0,};
+        int              ret        = 0;
+        xlator_t *this       = NULL;
+        dict_t  *xdata       = NULL;
+
 
         this = THIS;
 
         frame = myframe;
-        local = frame->local;
 
         if (-1 == req->rpc_status) {
                 rsp.op_ret   = -1;
@@ -2329,7 +2380,7 @@ client3_1_readdirp_cbk (struct rpc_req *req, struct iovec *iov, int count,
                 goto out;
         }
 
-        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_readdirp_rsp);
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_setattr_rsp);
         if (ret < 0) {
                 gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
                 rsp.op_ret   = -1;
@@ -2337,9 +2388,9 @@ client3_1_readdirp_cbk (struct rpc_req *req, struct iovec *iov, int count,
                 goto out;
         }
 
-        INIT_LIST_HEAD (&entries.list);
-        if (rsp.op_ret > 0) {
-                unserialize_rsp_direntp (this, local->fd, &rsp, &entries);
+        if (-1 != rsp.op_ret) {
+                gf_stat_to_iatt (&rsp.statpre, &prestat);
+                gf_stat_to_iatt (&rsp.statpost, &poststat);
         }
 
         GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
@@ -2348,54 +2399,52 @@ client3_1_readdirp_cbk (struct rpc_req *req, struct iovec *iov, int count,
 
 out:
         if (rsp.op_ret == -1) {
-                gf_log (this->name, GF_LOG_WARNING,
-                        "remote operation failed: %s",
+                gf_log (this->name, GF_LOG_WARNING, "remote operation failed: %s",
                         strerror (gf_error_to_errno (rsp.op_errno)));
         }
-        CLIENT_STACK_UNWIND (readdirp, frame, rsp.op_ret,
-                             gf_error_to_errno (rsp.op_errno), &entries, xdata);
+        CLIENT_STACK_UNWIND (setattr, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno), &prestat,
+                             &poststat, xdata);
 
-        if (rsp.op_ret != -1) {
-                gf_dirent_free (&entries);
-        }
         if (rsp.xdata.xdata_val)
                 free (rsp.xdata.xdata_val);
 
         if (xdata)
                 dict_unref (xdata);
 
-        clnt_readdirp_rsp_cleanup (&rsp);
-
         return 0;
 }
 
-
 int
-client3_1_rename_cbk (struct rpc_req *req, struct iovec *iov, int count,
+client3_1_create_cbk (struct rpc_req *req, struct iovec *iov, int count,
                       void *myframe)
 {
-        call_frame_t     *frame      = NULL;
-        gfs3_rename_rsp   rsp        = {0,};
-        struct iatt       stbuf      = {0,};
-        struct iatt       preoldparent  = {0,};
-        struct iatt       postoldparent = {0,};
-        struct iatt       prenewparent  = {0,};
-        struct iatt       postnewparent = {0,};
-        int               ret        = 0;
-        xlator_t *this       = NULL;
-        dict_t  *xdata       = NULL;
-
-        this = THIS;
-
-        frame = myframe;
-
+        call_frame_t    *frame      = NULL;
+        fd_t            *fd         = NULL;
+        inode_t         *inode      = NULL;
+        struct iatt      stbuf      = {0, };
+        struct iatt      preparent  = {0, };
+        struct iatt      postparent = {0, };
+        int32_t          ret        = -1;
+        clnt_local_t    *local      = NULL;
+        gfs3_create_rsp  rsp        = {0,};
+        xlator_t *this       = NULL;
+        dict_t  *xdata       = NULL;
+
+        this = THIS;
+
+        frame = myframe;
+        local = frame->local;
+        fd    = local->fd;
+        inode = local->loc.inode;
+
         if (-1 == req->rpc_status) {
                 rsp.op_ret   = -1;
                 rsp.op_errno = ENOTCONN;
                 goto out;
         }
 
-        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_rename_rsp);
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_create_rsp);
         if (ret < 0) {
                 gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
                 rsp.op_ret   = -1;
@@ -2406,11 +2455,17 @@ client3_1_rename_cbk (struct rpc_req *req, struct iovec *iov, int count,
         if (-1 != rsp.op_ret) {
                 gf_stat_to_iatt (&rsp.stat, &stbuf);
 
-                gf_stat_to_iatt (&rsp.preoldparent, &preoldparent);
-                gf_stat_to_iatt (&rsp.postoldparent, &postoldparent);
-
-                gf_stat_to_iatt (&rsp.prenewparent, &prenewparent);
-                gf_stat_to_iatt (&rsp.postnewparent, &postnewparent);
+                gf_stat_to_iatt (&rsp.preparent, &preparent);
+                gf_stat_to_iatt (&rsp.postparent, &postparent);
+                uuid_copy (local->loc.gfid, stbuf.ia_gfid);
+                ret = client_add_fd_to_saved_fds (frame->this, fd, &local->loc,
+                                                  local->flags, 0,
+                                                  rsp.fd, 0);
+                if (ret) {
+                        rsp.op_ret = -1;
+                        rsp.op_errno = -ret;
+                        goto out;
+                }
         }
 
         GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
@@ -2419,13 +2474,17 @@ client3_1_rename_cbk (struct rpc_req *req, struct iovec *iov, int count,
 
 out:
         if (rsp.op_ret == -1) {
-                gf_log (this->name, GF_LOG_WARNING, "remote operation failed: %s",
-                        strerror (gf_error_to_errno (rsp.op_errno)));
+                gf_log (this->name, GF_LOG_WARNING,
+                        "remote operation failed: %s. Path: %s (%s)",
+                        strerror (gf_error_to_errno (rsp.op_errno)),
+                        (local) ? local->loc.path : "--",
+                        (local && local->loc.inode) ?
+                        uuid_utoa (local->loc.inode->gfid) : "--");
         }
-        CLIENT_STACK_UNWIND (rename, frame, rsp.op_ret,
-                             gf_error_to_errno (rsp.op_errno),
-                             &stbuf, &preoldparent, &postoldparent,
-                             &prenewparent, &postnewparent, xdata);
+
+        CLIENT_STACK_UNWIND (create, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno), fd, inode,
+                             &stbuf, &preparent, &postparent, xdata);
 
         if (rsp.xdata.xdata_val)
                 free (rsp.xdata.xdata_val);
@@ -2436,18 +2495,14 @@ out:
         return 0;
 }
 
+
 int
-client3_1_link_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                    void *myframe)
+client3_1_rchecksum_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                         void *myframe)
 {
-        call_frame_t     *frame      = NULL;
-        gfs3_link_rsp     rsp        = {0,};
-        struct iatt       stbuf      = {0,};
-        struct iatt       preparent  = {0,};
-        struct iatt       postparent = {0,};
-        int               ret        = 0;
-        clnt_local_t     *local      = NULL;
-        inode_t          *inode      = NULL;
+        call_frame_t *frame = NULL;
+        gfs3_rchecksum_rsp rsp        = {0,};
+        int              ret        = 0;
         xlator_t *this       = NULL;
         dict_t  *xdata       = NULL;
 
@@ -2456,16 +2511,13 @@ client3_1_link_cbk (struct rpc_req *req, struct iovec *iov, int count,
 
         frame = myframe;
 
-        local = frame->local;
-        inode = local->loc.inode;
-
         if (-1 == req->rpc_status) {
                 rsp.op_ret   = -1;
                 rsp.op_errno = ENOTCONN;
                 goto out;
         }
 
-        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_link_rsp);
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_rchecksum_rsp);
         if (ret < 0) {
                 gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
                 rsp.op_ret   = -1;
@@ -2473,31 +2525,26 @@ client3_1_link_cbk (struct rpc_req *req, struct iovec *iov, int count,
                 goto out;
         }
 
-        if (-1 != rsp.op_ret) {
-                gf_stat_to_iatt (&rsp.stat, &stbuf);
-
-                gf_stat_to_iatt (&rsp.preparent, &preparent);
-                gf_stat_to_iatt (&rsp.postparent, &postparent);
-        }
-
         GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
                                       (rsp.xdata.xdata_len), ret,
                                       rsp.op_errno, out);
 
 out:
         if (rsp.op_ret == -1) {
-                gf_log (this->name, GF_LOG_WARNING,
-                        "remote operation failed: %s (%s -> %s)",
-                        strerror (gf_error_to_errno (rsp.op_errno)),
-                        (local) ? ((local->loc.path)? local->loc.path :
-                                   uuid_utoa (local->loc.inode->gfid)) : "--",
-                        (local) ? ((local->loc2.path)? local->loc2.path :
-                                   local->loc2.name) : "--");
+                gf_log (this->name, GF_LOG_WARNING, "remote operation failed: %s",
+                        strerror (gf_error_to_errno (rsp.op_errno)));
         }
+        CLIENT_STACK_UNWIND (rchecksum, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno),
+                             rsp.weak_checksum,
+                             (uint8_t *)rsp.strong_checksum.strong_checksum_val,
+                             xdata);
 
-        CLIENT_STACK_UNWIND (link, frame, rsp.op_ret,
-                             gf_error_to_errno (rsp.op_errno), inode,
-                             &stbuf, &preparent, &postparent, xdata);
+        if (rsp.strong_checksum.strong_checksum_val) {
+                /* This is allocated by the libc while decoding RPC msg */
+                /* Hence no 'GF_FREE', but just 'free' */
+                free (rsp.strong_checksum.strong_checksum_val);
+        }
 
         if (rsp.xdata.xdata_val)
                 free (rsp.xdata.xdata_val);
@@ -2508,17 +2555,15 @@ out:
         return 0;
 }
 
-
 int
-client3_1_opendir_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                       void *myframe)
+client3_1_lk_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                  void *myframe)
 {
-        clnt_local_t      *local = NULL;
-        clnt_conf_t       *conf = NULL;
-        call_frame_t      *frame = NULL;
-        fd_t              *fd = NULL;
-        int ret = 0;
-        gfs3_opendir_rsp  rsp = {0,};
+        call_frame_t    *frame      = NULL;
+        clnt_local_t  *local      = NULL;
+        struct gf_flock     lock       = {0,};
+        gfs3_lk_rsp      rsp        = {0,};
+        int              ret        = 0;
         xlator_t *this       = NULL;
         dict_t  *xdata       = NULL;
 
@@ -2527,16 +2572,13 @@ client3_1_opendir_cbk (struct rpc_req *req, struct iovec *iov, int count,
         frame = myframe;
         local = frame->local;
 
-        conf  = frame->this->private;
-        fd    = local->fd;
-
         if (-1 == req->rpc_status) {
                 rsp.op_ret   = -1;
                 rsp.op_errno = ENOTCONN;
                 goto out;
         }
 
-        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_opendir_rsp);
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_lk_rsp);
         if (ret < 0) {
                 gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
                 rsp.op_ret   = -1;
@@ -2544,147 +2586,132 @@ client3_1_opendir_cbk (struct rpc_req *req, struct iovec *iov, int count,
                 goto out;
         }
 
-        if (-1 != rsp.op_ret) {
-                ret = client_add_fd_to_saved_fds (frame->this, fd, &local->loc,
-                                                  0, 0, rsp.fd, 1);
-                if (ret) {
+        if (rsp.op_ret >= 0) {
+                gf_proto_flock_to_flock (&rsp.flock, &lock);
+        }
+
+        /* Save the lock to the client lock cache to be able
+           to recover in the case of server reboot.*/
+        /*
+          temporarily
+        if (local->cmd == F_SETLK || local->cmd == F_SETLKW) {
+                ret = client_add_lock_for_recovery (local->fd, &lock,
+                                                    local->owner, local->cmd);
+                if (ret < 0) {
                         rsp.op_ret = -1;
                         rsp.op_errno = -ret;
-                        goto out;
                 }
         }
+        */
 
         GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
                                       (rsp.xdata.xdata_len), ret,
                                       rsp.op_errno, out);
 
 out:
-        if (rsp.op_ret == -1) {
+        if ((rsp.op_ret == -1) &&
+            (EAGAIN != gf_error_to_errno (rsp.op_errno))) {
                 gf_log (this->name, GF_LOG_WARNING,
-                        "remote operation failed: %s. Path: %s (%s)",
-                        strerror (gf_error_to_errno (rsp.op_errno)),
-                        (local) ? local->loc.path : "--",
-                        (local && local->loc.inode) ?
-                        uuid_utoa (local->loc.inode->gfid) : "--");
+                        "remote operation failed: %s",
+                        strerror (gf_error_to_errno (rsp.op_errno)));
         }
-        CLIENT_STACK_UNWIND (opendir, frame, rsp.op_ret,
-                             gf_error_to_errno (rsp.op_errno), fd, xdata);
+
+        CLIENT_STACK_UNWIND (lk, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno), &lock, xdata);
 
         if (rsp.xdata.xdata_val)
                 free (rsp.xdata.xdata_val);
 
+        if (rsp.flock.lk_owner.lk_owner_val)
+                free (rsp.flock.lk_owner.lk_owner_val);
+
         if (xdata)
                 dict_unref (xdata);
 
         return 0;
 }
 
-
 int
-client3_1_lookup_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                      void *myframe)
+client3_1_readdir_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                       void *myframe)
 {
-        clnt_local_t    *local      = NULL;
-        call_frame_t    *frame      = NULL;
-        int              ret        = 0;
-        gfs3_lookup_rsp  rsp        = {0,};
-        struct iatt      stbuf      = {0,};
-        struct iatt      postparent = {0,};
-        int              op_errno   = EINVAL;
-        dict_t          *xdata      = NULL;
-        inode_t         *inode      = NULL;
-        xlator_t        *this       = NULL;
+        call_frame_t     *frame    = NULL;
+        gfs3_readdir_rsp  rsp      = {0,};
+        int32_t           ret      = 0;
+        clnt_local_t     *local    = NULL;
+        gf_dirent_t       entries;
+        xlator_t         *this     = NULL;
+        dict_t           *xdata    = NULL;
 
         this = THIS;
 
         frame = myframe;
         local = frame->local;
-        inode = local->loc.inode;
 
         if (-1 == req->rpc_status) {
                 rsp.op_ret   = -1;
-                op_errno = ENOTCONN;
+                rsp.op_errno = ENOTCONN;
                 goto out;
         }
 
-        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_lookup_rsp);
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_readdir_rsp);
         if (ret < 0) {
                 gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
                 rsp.op_ret   = -1;
-                op_errno = EINVAL;
+                rsp.op_errno = EINVAL;
                 goto out;
         }
 
-        op_errno = gf_error_to_errno (rsp.op_errno);
-        gf_stat_to_iatt (&rsp.postparent, &postparent);
-
-        if (rsp.op_ret == -1)
-                goto out;
-
-        rsp.op_ret = -1;
-        gf_stat_to_iatt (&rsp.stat, &stbuf);
-
-        GF_PROTOCOL_DICT_UNSERIALIZE (frame->this, xdata, (rsp.xdata.xdata_val),
-                                      (rsp.xdata.xdata_len), rsp.op_ret,
-                                      op_errno, out);
-
-        if ((!uuid_is_null (inode->gfid))
-            && (uuid_compare (stbuf.ia_gfid, inode->gfid) != 0)) {
-                gf_log (frame->this->name, GF_LOG_DEBUG,
-                        "gfid changed for %s", local->loc.path);
-                rsp.op_ret = -1;
-                op_errno = ESTALE;
-                goto out;
+        INIT_LIST_HEAD (&entries.list);
+        if (rsp.op_ret > 0) {
+                unserialize_rsp_dirent (&rsp, &entries);
         }
 
-        rsp.op_ret = 0;
+        GF_PROTOCOL_DICT_UNSERIALIZE (frame->this, xdata,
+                                      (rsp.xdata.xdata_val),
+                                      (rsp.xdata.xdata_len), rsp.op_ret,
+                                      rsp.op_errno, out);
 
 out:
-        rsp.op_errno = op_errno;
         if (rsp.op_ret == -1) {
-                /* any error other than ENOENT */
-                if (rsp.op_errno != ENOENT)
-                        gf_log (this->name, GF_LOG_WARNING,
-                                "remote operation failed: %s. Path: %s (%s)",
-                                strerror (rsp.op_errno),
-                                (local) ? local->loc.path : "--",
-                                (local && local->loc.inode) ?
-                                uuid_utoa (local->loc.inode->gfid) : "--");
-                else
-                        gf_log (this->name, GF_LOG_TRACE, "not found on remote node");
+                gf_log (this->name, GF_LOG_WARNING,
+                        "remote operation failed: %s remote_fd = %d",
+                        strerror (gf_error_to_errno (rsp.op_errno)),
+                                  local->cmd);
+        }
+        CLIENT_STACK_UNWIND (readdir, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno), &entries, xdata);
 
+        if (rsp.op_ret != -1) {
+                gf_dirent_free (&entries);
         }
 
-        CLIENT_STACK_UNWIND (lookup, frame, rsp.op_ret, rsp.op_errno, inode,
-                             &stbuf, xdata, &postparent);
+        if (rsp.xdata.xdata_val)
+                free (rsp.xdata.xdata_val);
 
         if (xdata)
                 dict_unref (xdata);
 
-        if (rsp.xdata.xdata_val)
-                free (rsp.xdata.xdata_val);
+        clnt_readdir_rsp_cleanup (&rsp);
 
         return 0;
 }
 
+
 int
-client3_1_readv_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                     void *myframe)
+client3_1_readdirp_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                        void *myframe)
 {
-        call_frame_t   *frame  = NULL;
-        struct iobref  *iobref = NULL;
-        struct iovec    vector[MAX_IOVEC] = {{0}, };
-        struct iatt     stat   = {0,};
-        gfs3_read_rsp   rsp    = {0,};
-        int             ret    = 0, rspcount = 0;
-        clnt_local_t   *local  = NULL;
-        xlator_t *this       = NULL;
-        dict_t  *xdata       = NULL;
+        call_frame_t      *frame = NULL;
+        gfs3_readdirp_rsp  rsp   = {0,};
+        int32_t            ret   = 0;
+        clnt_local_t      *local = NULL;
+        gf_dirent_t        entries;
+        xlator_t          *this  = NULL;
+        dict_t            *xdata = NULL;
 
         this = THIS;
 
-        memset (vector, 0, sizeof (vector));
-
         frame = myframe;
         local = frame->local;
 
@@ -2694,7 +2721,7 @@ client3_1_readv_cbk (struct rpc_req *req, struct iovec *iov, int count,
                 goto out;
         }
 
-        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_read_rsp);
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_readdirp_rsp);
         if (ret < 0) {
                 gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
                 rsp.op_ret   = -1;
@@ -2702,201 +2729,566 @@ client3_1_readv_cbk (struct rpc_req *req, struct iovec *iov, int count,
                 goto out;
         }
 
-        if (rsp.op_ret != -1) {
-                iobref = req->rsp_iobref;
-                gf_stat_to_iatt (&rsp.stat, &stat);
-
-                vector[0].iov_len = rsp.op_ret;
-                if (rsp.op_ret > 0)
-                        vector[0].iov_base = req->rsp[1].iov_base;
-                rspcount = 1;
+        INIT_LIST_HEAD (&entries.list);
+        if (rsp.op_ret > 0) {
+                unserialize_rsp_direntp (this, local->fd, &rsp, &entries);
         }
+
         GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
                                       (rsp.xdata.xdata_len), ret,
                                       rsp.op_errno, out);
 
-#ifdef GF_TESTING_IO_XDATA
-        dict_dump (xdata);
-#endif
-
 out:
         if (rsp.op_ret == -1) {
                 gf_log (this->name, GF_LOG_WARNING,
                         "remote operation failed: %s",
                         strerror (gf_error_to_errno (rsp.op_errno)));
         }
-        CLIENT_STACK_UNWIND (readv, frame, rsp.op_ret,
-                             gf_error_to_errno (rsp.op_errno), vector, rspcount,
-                             &stat, iobref, xdata);
+        CLIENT_STACK_UNWIND (readdirp, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno), &entries, xdata);
 
+        if (rsp.op_ret != -1) {
+                gf_dirent_free (&entries);
+        }
         if (rsp.xdata.xdata_val)
                 free (rsp.xdata.xdata_val);
 
         if (xdata)
                 dict_unref (xdata);
 
-        return 0;
-}
-
-int
-client3_1_release_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                       void *myframe)
-{
-        call_frame_t   *frame = NULL;
+        clnt_readdirp_rsp_cleanup (&rsp);
 
-        frame = myframe;
-        STACK_DESTROY (frame->root);
         return 0;
 }
-int
-client3_1_releasedir_cbk (struct rpc_req *req, struct iovec *iov, int count,
-                          void *myframe)
-{
-        call_frame_t   *frame = NULL;
 
-        frame = myframe;
-        STACK_DESTROY (frame->root);
-        return 0;
-}
 
 int
-client_fdctx_destroy (xlator_t *this, clnt_fd_ctx_t *fdctx)
+client3_1_rename_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                      void *myframe)
 {
-        clnt_conf_t  *conf        = NULL;
-        call_frame_t *fr          = NULL;
-        int32_t       ret         = -1;
-        char          parent_down = 0;
-        fd_lk_ctx_t  *lk_ctx      = NULL;
+        call_frame_t     *frame      = NULL;
+        gfs3_rename_rsp   rsp        = {0,};
+        struct iatt       stbuf      = {0,};
+        struct iatt       preoldparent  = {0,};
+        struct iatt       postoldparent = {0,};
+        struct iatt       prenewparent  = {0,};
+        struct iatt       postnewparent = {0,};
+        int               ret        = 0;
+        xlator_t *this       = NULL;
+        dict_t  *xdata       = NULL;
 
-        GF_VALIDATE_OR_GOTO ("client", this, out);
-        GF_VALIDATE_OR_GOTO (this->name, fdctx, out);
+        this = THIS;
 
-        conf = (clnt_conf_t *) this->private;
+        frame = myframe;
 
-        if (fdctx->remote_fd == -1) {
-                gf_log (this->name, GF_LOG_DEBUG, "not a valid fd");
+        if (-1 == req->rpc_status) {
+                rsp.op_ret   = -1;
+                rsp.op_errno = ENOTCONN;
                 goto out;
         }
 
-        pthread_mutex_lock (&conf->lock);
-        {
-                parent_down   = conf->parent_down;
-                lk_ctx        = fdctx->lk_ctx;
-                fdctx->lk_ctx = NULL;
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_rename_rsp);
+        if (ret < 0) {
+                gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
+                rsp.op_ret   = -1;
+                rsp.op_errno = EINVAL;
+                goto out;
         }
-        pthread_mutex_unlock (&conf->lock);
 
-        if (lk_ctx)
-                fd_lk_ctx_unref (lk_ctx);
+        if (-1 != rsp.op_ret) {
+                gf_stat_to_iatt (&rsp.stat, &stbuf);
 
-        if (!parent_down)
-                rpc_clnt_ref (conf->rpc);
-        else
-                goto out;
+                gf_stat_to_iatt (&rsp.preoldparent, &preoldparent);
+                gf_stat_to_iatt (&rsp.postoldparent, &postoldparent);
 
-        fr = create_frame (this, this->ctx->pool);
-        if (fr == NULL) {
-                goto out;
+                gf_stat_to_iatt (&rsp.prenewparent, &prenewparent);
+                gf_stat_to_iatt (&rsp.postnewparent, &postnewparent);
         }
 
-        ret = 0;
-
-        if (fdctx->is_dir) {
-                gfs3_releasedir_req  req = {{0,},};
-                req.fd = fdctx->remote_fd;
-                gf_log (this->name, GF_LOG_DEBUG, "sending releasedir on fd");
-                client_submit_request (this, &req, fr, &clnt3_1_fop_prog,
-                                       GFS3_OP_RELEASEDIR,
-                                       client3_1_releasedir_cbk,
-                                       NULL, NULL, 0, NULL, 0, NULL,
-                                       (xdrproc_t)xdr_gfs3_releasedir_req);
-        } else {
-                gfs3_release_req  req = {{0,},};
-                req.fd = fdctx->remote_fd;
-                gf_log (this->name, GF_LOG_DEBUG, "sending release on fd");
-                client_submit_request (this, &req, fr, &clnt3_1_fop_prog,
-                                       GFS3_OP_RELEASE,
-                                       client3_1_release_cbk, NULL,
-                                       NULL, 0, NULL, 0, NULL,
-                                       (xdrproc_t)xdr_gfs3_release_req);
-        }
+        GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
+                                      (rsp.xdata.xdata_len), ret,
+                                      rsp.op_errno, out);
 
-        rpc_clnt_unref (conf->rpc);
 out:
-        if (fdctx) {
-                fdctx->remote_fd = -1;
-                GF_FREE (fdctx);
+        if (rsp.op_ret == -1) {
+                gf_log (this->name, GF_LOG_WARNING, "remote operation failed: %s",
+                        strerror (gf_error_to_errno (rsp.op_errno)));
         }
+        CLIENT_STACK_UNWIND (rename, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno),
+                             &stbuf, &preoldparent, &postoldparent,
+                             &prenewparent, &postnewparent, xdata);
 
-        if (ret && fr)
-                STACK_DESTROY (fr->root);
+        if (rsp.xdata.xdata_val)
+                free (rsp.xdata.xdata_val);
 
-        return ret;
+        if (xdata)
+                dict_unref (xdata);
+
+        return 0;
 }
 
-int32_t
-client3_1_releasedir (call_frame_t *frame, xlator_t *this,
-                      void *data)
+int
+client3_1_link_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                    void *myframe)
 {
-        clnt_conf_t         *conf        = NULL;
-        clnt_fd_ctx_t       *fdctx       = NULL;
-        clnt_args_t         *args        = NULL;
-        int64_t              remote_fd   = -1;
+        call_frame_t     *frame      = NULL;
+        gfs3_link_rsp     rsp        = {0,};
+        struct iatt       stbuf      = {0,};
+        struct iatt       preparent  = {0,};
+        struct iatt       postparent = {0,};
+        int               ret        = 0;
+        clnt_local_t     *local      = NULL;
+        inode_t          *inode      = NULL;
+        xlator_t *this       = NULL;
+        dict_t  *xdata       = NULL;
 
-        if (!this || !data)
-                goto out;
 
-        args = data;
-        conf = this->private;
+        this = THIS;
 
-        pthread_mutex_lock (&conf->lock);
-        {
-                fdctx = this_fd_del_ctx (args->fd, this);
-                if (fdctx != NULL) {
-                        remote_fd = fdctx->remote_fd;
+        frame = myframe;
 
-                        /* fdctx->remote_fd == -1 indicates a reopen attempt
-                           in progress. Just mark ->released = 1 and let
-                           reopen_cbk handle releasing
-                        */
+        local = frame->local;
+        inode = local->loc.inode;
 
-                        if (remote_fd != -1)
-                                list_del_init (&fdctx->sfd_pos);
+        if (-1 == req->rpc_status) {
+                rsp.op_ret   = -1;
+                rsp.op_errno = ENOTCONN;
+                goto out;
+        }
 
-                        fdctx->released = 1;
-                }
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_link_rsp);
+        if (ret < 0) {
+                gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
+                rsp.op_ret   = -1;
+                rsp.op_errno = EINVAL;
+                goto out;
         }
-        pthread_mutex_unlock (&conf->lock);
 
-        if (remote_fd != -1)
-                client_fdctx_destroy (this, fdctx);
-out:
+        if (-1 != rsp.op_ret) {
+                gf_stat_to_iatt (&rsp.stat, &stbuf);
 
-        return 0;
-}
+                gf_stat_to_iatt (&rsp.preparent, &preparent);
+                gf_stat_to_iatt (&rsp.postparent, &postparent);
+        }
 
-int32_t
-client3_1_release (call_frame_t *frame, xlator_t *this,
-                   void *data)
-{
-        int64_t           remote_fd     = -1;
-        clnt_conf_t      *conf          = NULL;
-        clnt_fd_ctx_t    *fdctx         = NULL;
-        clnt_args_t      *args          = NULL;
-        lk_heal_state_t   lk_heal_state = GF_LK_HEAL_DONE;
+        GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
+                                      (rsp.xdata.xdata_len), ret,
+                                      rsp.op_errno, out);
 
-        if (!this || !data)
-                goto out;
+out:
+        if (rsp.op_ret == -1) {
+                gf_log (this->name, GF_LOG_WARNING,
+                        "remote operation failed: %s (%s -> %s)",
+                        strerror (gf_error_to_errno (rsp.op_errno)),
+                        (local) ? ((local->loc.path)? local->loc.path :
+                                   uuid_utoa (local->loc.inode->gfid)) : "--",
+                        (local) ? ((local->loc2.path)? local->loc2.path :
+                                   local->loc2.name) : "--");
+        }
 
-        args = data;
-        conf = this->private;
+        CLIENT_STACK_UNWIND (link, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno), inode,
+                             &stbuf, &preparent, &postparent, xdata);
 
-        pthread_mutex_lock (&conf->lock);
-        {
-                fdctx = this_fd_del_ctx (args->fd, this);
-                if (fdctx != NULL) {
-                        remote_fd     = fdctx->remote_fd;
-                        lk_heal_state = fdctx->lk_heal_state;
+        if (rsp.xdata.xdata_val)
+                free (rsp.xdata.xdata_val);
+
+        if (xdata)
+                dict_unref (xdata);
+
+        return 0;
+}
+
+
+int
+client3_1_opendir_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                       void *myframe)
+{
+        clnt_local_t      *local = NULL;
+        clnt_conf_t       *conf = NULL;
+        call_frame_t      *frame = NULL;
+        fd_t              *fd = NULL;
+        int ret = 0;
+        gfs3_opendir_rsp  rsp = {0,};
+        xlator_t *this       = NULL;
+        dict_t  *xdata       = NULL;
+
+        this = THIS;
+
+        frame = myframe;
+        local = frame->local;
+
+        conf  = frame->this->private;
+        fd    = local->fd;
+
+        if (-1 == req->rpc_status) {
+                rsp.op_ret   = -1;
+                rsp.op_errno = ENOTCONN;
+                goto out;
+        }
+
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_opendir_rsp);
+        if (ret < 0) {
+                gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
+                rsp.op_ret   = -1;
+                rsp.op_errno = EINVAL;
+                goto out;
+        }
+
+        if (-1 != rsp.op_ret) {
+                ret = client_add_fd_to_saved_fds (frame->this, fd, &local->loc,
+                                                  0, 0, rsp.fd, 1);
+                if (ret) {
+                        rsp.op_ret = -1;
+                        rsp.op_errno = -ret;
+                        goto out;
+                }
+        }
+
+        GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
+                                      (rsp.xdata.xdata_len), ret,
+                                      rsp.op_errno, out);
+
+out:
+        if (rsp.op_ret == -1) {
+                gf_log (this->name, GF_LOG_WARNING,
+                        "remote operation failed: %s. Path: %s (%s)",
+                        strerror (gf_error_to_errno (rsp.op_errno)),
+                        (local) ? local->loc.path : "--",
+                        (local && local->loc.inode) ?
+                        uuid_utoa (local->loc.inode->gfid) : "--");
+        }
+        CLIENT_STACK_UNWIND (opendir, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno), fd, xdata);
+
+        if (rsp.xdata.xdata_val)
+                free (rsp.xdata.xdata_val);
+
+        if (xdata)
+                dict_unref (xdata);
+
+        return 0;
+}
+
+
+int
+client3_1_lookup_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                      void *myframe)
+{
+        clnt_local_t    *local      = NULL;
+        call_frame_t    *frame      = NULL;
+        int              ret        = 0;
+        gfs3_lookup_rsp  rsp        = {0,};
+        struct iatt      stbuf      = {0,};
+        struct iatt      postparent = {0,};
+        int              op_errno   = EINVAL;
+        dict_t          *xdata      = NULL;
+        inode_t         *inode      = NULL;
+        xlator_t        *this       = NULL;
+
+        this = THIS;
+
+        frame = myframe;
+        local = frame->local;
+        inode = local->loc.inode;
+
+        if (-1 == req->rpc_status) {
+                rsp.op_ret   = -1;
+                op_errno = ENOTCONN;
+                goto out;
+        }
+
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_lookup_rsp);
+        if (ret < 0) {
+                gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
+                rsp.op_ret   = -1;
+                op_errno = EINVAL;
+                goto out;
+        }
+
+        op_errno = gf_error_to_errno (rsp.op_errno);
+        gf_stat_to_iatt (&rsp.postparent, &postparent);
+
+        if (rsp.op_ret == -1)
+                goto out;
+
+        rsp.op_ret = -1;
+        gf_stat_to_iatt (&rsp.stat, &stbuf);
+
+        GF_PROTOCOL_DICT_UNSERIALIZE (frame->this, xdata, (rsp.xdata.xdata_val),
+                                      (rsp.xdata.xdata_len), rsp.op_ret,
+                                      op_errno, out);
+
+        if ((!uuid_is_null (inode->gfid))
+            && (uuid_compare (stbuf.ia_gfid, inode->gfid) != 0)) {
+                gf_log (frame->this->name, GF_LOG_DEBUG,
+                        "gfid changed for %s", local->loc.path);
+                rsp.op_ret = -1;
+                op_errno = ESTALE;
+                goto out;
+        }
+
+        rsp.op_ret = 0;
+
+out:
+        rsp.op_errno = op_errno;
+        if (rsp.op_ret == -1) {
+                /* any error other than ENOENT */
+                if (rsp.op_errno != ENOENT)
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "remote operation failed: %s. Path: %s (%s)",
+                                strerror (rsp.op_errno),
+                                (local) ? local->loc.path : "--",
+                                (local && local->loc.inode) ?
+                                uuid_utoa (local->loc.inode->gfid) : "--");
+                else
+                        gf_log (this->name, GF_LOG_TRACE, "not found on remote node");
+
+        }
+
+        CLIENT_STACK_UNWIND (lookup, frame, rsp.op_ret, rsp.op_errno, inode,
+                             &stbuf, xdata, &postparent);
+
+        if (xdata)
+                dict_unref (xdata);
+
+        if (rsp.xdata.xdata_val)
+                free (rsp.xdata.xdata_val);
+
+        return 0;
+}
+
+int
+client3_1_readv_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                     void *myframe)
+{
+        call_frame_t   *frame  = NULL;
+        struct iobref  *iobref = NULL;
+        struct iovec    vector[MAX_IOVEC] = {{0}, };
+        struct iatt     stat   = {0,};
+        gfs3_read_rsp   rsp    = {0,};
+        int             ret    = 0, rspcount = 0;
+        clnt_local_t   *local  = NULL;
+        xlator_t *this       = NULL;
+        dict_t  *xdata       = NULL;
+
+        this = THIS;
+
+        memset (vector, 0, sizeof (vector));
+
+        frame = myframe;
+        local = frame->local;
+
+        if (-1 == req->rpc_status) {
+                rsp.op_ret   = -1;
+                rsp.op_errno = ENOTCONN;
+                goto out;
+        }
+
+        ret = xdr_to_generic (*iov, &rsp, (xdrproc_t)xdr_gfs3_read_rsp);
+        if (ret < 0) {
+                gf_log (this->name, GF_LOG_ERROR, "XDR decoding failed");
+                rsp.op_ret   = -1;
+                rsp.op_errno = EINVAL;
+                goto out;
+        }
+
+        if (rsp.op_ret != -1) {
+                iobref = req->rsp_iobref;
+                gf_stat_to_iatt (&rsp.stat, &stat);
+
+                vector[0].iov_len = rsp.op_ret;
+                if (rsp.op_ret > 0)
+                        vector[0].iov_base = req->rsp[1].iov_base;
+                rspcount = 1;
+        }
+        GF_PROTOCOL_DICT_UNSERIALIZE (this, xdata, (rsp.xdata.xdata_val),
+                                      (rsp.xdata.xdata_len), ret,
+                                      rsp.op_errno, out);
+
+#ifdef GF_TESTING_IO_XDATA
+        dict_dump (xdata);
+#endif
+
+out:
+        if (rsp.op_ret == -1) {
+                gf_log (this->name, GF_LOG_WARNING,
+                        "remote operation failed: %s",
+                        strerror (gf_error_to_errno (rsp.op_errno)));
+        }
+        CLIENT_STACK_UNWIND (readv, frame, rsp.op_ret,
+                             gf_error_to_errno (rsp.op_errno), vector, rspcount,
+                             &stat, iobref, xdata);
+
+        if (rsp.xdata.xdata_val)
+                free (rsp.xdata.xdata_val);
+
+        if (xdata)
+                dict_unref (xdata);
+
+        return 0;
+}
+
+int
+client3_1_release_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                       void *myframe)
+{
+        call_frame_t   *frame = NULL;
+
+        frame = myframe;
+        STACK_DESTROY (frame->root);
+        return 0;
+}
+int
+client3_1_releasedir_cbk (struct rpc_req *req, struct iovec *iov, int count,
+                          void *myframe)
+{
+        call_frame_t   *frame = NULL;
+
+        frame = myframe;
+        STACK_DESTROY (frame->root);
+        return 0;
+}
+
+int
+client_fdctx_destroy (xlator_t *this, clnt_fd_ctx_t *fdctx)
+{
+        clnt_conf_t  *conf        = NULL;
+        call_frame_t *fr          = NULL;
+        int32_t       ret         = -1;
+        char          parent_down = 0;
+        fd_lk_ctx_t  *lk_ctx      = NULL;
+
+        GF_VALIDATE_OR_GOTO ("client", this, out);
+        GF_VALIDATE_OR_GOTO (this->name, fdctx, out);
+
+        conf = (clnt_conf_t *) this->private;
+
+        if (fdctx->remote_fd == -1) {
+                gf_log (this->name, GF_LOG_DEBUG, "not a valid fd");
+                goto out;
+        }
+
+        pthread_mutex_lock (&conf->lock);
+        {
+                parent_down   = conf->parent_down;
+                lk_ctx        = fdctx->lk_ctx;
+                fdctx->lk_ctx = NULL;
+        }
+        pthread_mutex_unlock (&conf->lock);
+
+        if (lk_ctx)
+                fd_lk_ctx_unref (lk_ctx);
+
+        if (!parent_down)
+                rpc_clnt_ref (conf->rpc);
+        else
+                goto out;
+
+        fr = create_frame (this, this->ctx->pool);
+        if (fr == NULL) {
+                goto out;
+        }
+
+        ret = 0;
+
+        if (fdctx->is_dir) {
+                gfs3_releasedir_req  req = {{0,},};
+                req.fd = fdctx->remote_fd;
+                gf_log (this->name, GF_LOG_DEBUG, "sending releasedir on fd");
+                client_submit_request (this, &req, fr, &clnt3_1_fop_prog,
+                                       GFS3_OP_RELEASEDIR,
+                                       client3_1_releasedir_cbk,
+                                       NULL, NULL, 0, NULL, 0, NULL,
+                                       (xdrproc_t)xdr_gfs3_releasedir_req);
+        } else {
+                gfs3_release_req  req = {{0,},};
+                req.fd = fdctx->remote_fd;
+                gf_log (this->name, GF_LOG_DEBUG, "sending release on fd");
+                client_submit_request (this, &req, fr, &clnt3_1_fop_prog,
+                                       GFS3_OP_RELEASE,
+                                       client3_1_release_cbk, NULL,
+                                       NULL, 0, NULL, 0, NULL,
+                                       (xdrproc_t)xdr_gfs3_release_req);
+        }
+
+        rpc_clnt_unref (conf->rpc);
+out:
+        if (fdctx) {
+                fdctx->remote_fd = -1;
+                GF_FREE (fdctx);
+        }
+
+        if (ret && fr)
+                STACK_DESTROY (fr->root);
+
+        return ret;
+}
+
+int32_t
+client3_1_releasedir (call_frame_t *frame, xlator_t *this,
+                      void *data)
+{
+        clnt_conf_t         *conf        = NULL;
+        clnt_fd_ctx_t       *fdctx       = NULL;
+        clnt_args_t         *args        = NULL;
+        int64_t              remote_fd   = -1;
+
+        if (!this || !data)
+                goto out;
+
+        args = data;
+        conf = this->private;
+
+        pthread_mutex_lock (&conf->lock);
+        {
+                fdctx = this_fd_del_ctx (args->fd, this);
+                if (fdctx != NULL) {
+                        remote_fd = fdctx->remote_fd;
+
+                        /* fdctx->remote_fd == -1 indicates a reopen attempt
+                           in progress. Just mark ->released = 1 and let
+                           reopen_cbk handle releasing
+                        */
+
+                        if (remote_fd != -1)
+                                list_del_init (&fdctx->sfd_pos);
+
+                        fdctx->released = 1;
+                }
+        }
+        pthread_mutex_unlock (&conf->lock);
+
+        if (remote_fd != -1)
+                client_fdctx_destroy (this, fdctx);
+out:
+
+        return 0;
+}
+
+int32_t
+client3_1_release (call_frame_t *frame, xlator_t *this,
+                   void *data)
+{
+        int64_t           remote_fd     = -1;
+        clnt_conf_t      *conf          = NULL;
+        clnt_fd_ctx_t    *fdctx         = NULL;
+        clnt_args_t      *args          = NULL;
+        lk_heal_state_t   lk_heal_state = GF_LK_HEAL_DONE;
+
+        if (!this || !data)
+                goto out;
+
+        args = data;
+        conf = this->private;
+
+        pthread_mutex_lock (&conf->lock);
+        {
+                fdctx = this_fd_del_ctx (args->fd, this);
+                if (fdctx != NULL) {
+                        remote_fd     = fdctx->remote_fd;
+                        lk_heal_state = fdctx->lk_heal_state;
 
                         /* fdctx->remote_fd == -1 indicates a reopen attempt
                            in progress. Just mark ->released = 1 and let
@@ -4290,47 +4682,284 @@ client3_1_opendir (call_frame_t *frame, xlator_t *this,
 
         args = data;
 
-        local = mem_get0 (this->local_pool);
-        if (!local) {
-                op_errno = ENOMEM;
-                goto unwind;
-        }
-        if (!(args->loc && args->loc->inode))
-                goto unwind;
-
-        local->fd = fd_ref (args->fd);
-        loc_copy (&local->loc, args->loc);
-        frame->local = local;
-
-        if (!uuid_is_null (args->loc->inode->gfid))
-                memcpy (req.gfid,  args->loc->inode->gfid, 16);
-        else
-                memcpy (req.gfid, args->loc->gfid, 16);
+        local = mem_get0 (this->local_pool);
+        if (!local) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+        if (!(args->loc && args->loc->inode))
+                goto unwind;
+
+        local->fd = fd_ref (args->fd);
+        loc_copy (&local->loc, args->loc);
+        frame->local = local;
+
+        if (!uuid_is_null (args->loc->inode->gfid))
+                memcpy (req.gfid,  args->loc->inode->gfid, 16);
+        else
+                memcpy (req.gfid, args->loc->gfid, 16);
+
+        GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
+                                       !uuid_is_null (*((uuid_t*)req.gfid)),
+                                       unwind, op_errno, EINVAL);
+
+        conf = this->private;
+
+        GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
+                                    req.xdata.xdata_len, op_errno, unwind);
+
+        ret = client_submit_request (this, &req, frame, conf->fops,
+                                     GFS3_OP_OPENDIR, client3_1_opendir_cbk,
+                                     NULL, NULL, 0, NULL, 0, NULL,
+                                     (xdrproc_t)xdr_gfs3_opendir_req);
+        if (ret) {
+                gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
+        }
+
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
+
+        return 0;
+
+unwind:
+        CLIENT_STACK_UNWIND (opendir, frame, -1, op_errno, NULL, NULL);
+
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
+
+        return 0;
+}
+
+
+
+int32_t
+client3_1_fsyncdir (call_frame_t *frame, xlator_t *this, void *data)
+{
+        clnt_args_t       *args      = NULL;
+        int64_t            remote_fd = -1;
+        clnt_conf_t       *conf      = NULL;
+        gfs3_fsyncdir_req  req       = {{0,},};
+        int                ret       = 0;
+        int32_t            op_errno  = ESTALE;
+
+        if (!frame || !this || !data)
+                goto unwind;
+
+        args = data;
+        conf = this->private;
+
+        CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
+
+        req.fd   = remote_fd;
+        req.data = args->flags;
+        memcpy (req.gfid, args->fd->inode->gfid, 16);
+
+        conf = this->private;
+
+        GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
+                                    req.xdata.xdata_len, op_errno, unwind);
+
+        ret = client_submit_request (this, &req, frame, conf->fops,
+                                     GFS3_OP_FSYNCDIR, client3_1_fsyncdir_cbk,
+                                     NULL, NULL, 0,
+                                     NULL, 0, NULL,
+                                     (xdrproc_t)xdr_gfs3_fsyncdir_req);
+        if (ret) {
+                gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
+        }
+
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
+
+        return 0;
+
+unwind:
+        CLIENT_STACK_UNWIND (fsyncdir, frame, -1, op_errno, NULL);
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
+
+        return 0;
+}
+
+
+
+int32_t
+client3_1_statfs (call_frame_t *frame, xlator_t *this,
+                  void *data)
+{
+        clnt_conf_t     *conf     = NULL;
+        clnt_args_t     *args     = NULL;
+        gfs3_statfs_req  req      = {{0,},};
+        int              ret      = 0;
+        int              op_errno = ESTALE;
+
+        if (!frame || !this || !data)
+                goto unwind;
+
+        args = data;
+
+        if (!args->loc)
+                goto unwind;
+
+        if (args->loc->inode) {
+                if (!uuid_is_null (args->loc->inode->gfid))
+                        memcpy (req.gfid,  args->loc->inode->gfid, 16);
+                else
+                        memcpy (req.gfid, args->loc->gfid, 16);
+        } else
+                req.gfid[15] = 1;
+
+        GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
+                                       !uuid_is_null (*((uuid_t*)req.gfid)),
+                                       unwind, op_errno, EINVAL);
+
+        conf = this->private;
+
+        GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
+                                    req.xdata.xdata_len, op_errno, unwind);
+
+        ret = client_submit_request (this, &req, frame, conf->fops,
+                                     GFS3_OP_STATFS, client3_1_statfs_cbk, NULL,
+                                     NULL, 0, NULL, 0,
+                                     NULL, (xdrproc_t)xdr_gfs3_statfs_req);
+        if (ret) {
+                gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
+        }
+
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
+
+        return 0;
+
+unwind:
+        CLIENT_STACK_UNWIND (statfs, frame, -1, op_errno, NULL, NULL);
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
+
+        return 0;
+}
+
+
+
+int32_t
+client3_1_setxattr (call_frame_t *frame, xlator_t *this,
+                    void *data)
+{
+        clnt_conf_t       *conf     = NULL;
+        clnt_args_t       *args     = NULL;
+        gfs3_setxattr_req  req      = {{0,},};
+        int                ret      = 0;
+        int                op_errno = ESTALE;
+
+        if (!frame || !this || !data)
+                goto unwind;
+
+        args = data;
+
+        if (!(args->loc && args->loc->inode))
+                goto unwind;
+
+        if (!uuid_is_null (args->loc->inode->gfid))
+                memcpy (req.gfid,  args->loc->inode->gfid, 16);
+        else
+                memcpy (req.gfid, args->loc->gfid, 16);
+
+        GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
+                                       !uuid_is_null (*((uuid_t*)req.gfid)),
+                                       unwind, op_errno, EINVAL);
+        if (args->xattr) {
+                GF_PROTOCOL_DICT_SERIALIZE (this, args->xattr,
+                                            (&req.dict.dict_val),
+                                            req.dict.dict_len,
+                                            op_errno, unwind);
+        }
+
+        req.flags = args->flags;
+
+        conf = this->private;
+
+        GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
+                                    req.xdata.xdata_len, op_errno, unwind);
+
+        ret = client_submit_request (this, &req, frame, conf->fops,
+                                     GFS3_OP_SETXATTR, client3_1_setxattr_cbk,
+                                     NULL, NULL, 0, NULL, 0, NULL,
+                                     (xdrproc_t)xdr_gfs3_setxattr_req);
+        if (ret) {
+                gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
+        }
+        if (req.dict.dict_val)
+                GF_FREE (req.dict.dict_val);
+
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
+
+        return 0;
+unwind:
+        CLIENT_STACK_UNWIND (setxattr, frame, -1, op_errno, NULL);
+        if (req.dict.dict_val)
+                GF_FREE (req.dict.dict_val);
+
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
+
+        return 0;
+}
+
+
+
+int32_t
+client3_1_fsetxattr (call_frame_t *frame, xlator_t *this,
+                     void *data)
+{
+        clnt_args_t        *args     = NULL;
+        int64_t             remote_fd = -1;
+        clnt_conf_t        *conf     = NULL;
+        gfs3_fsetxattr_req  req      = {{0,},};
+        int                 op_errno = ESTALE;
+        int                 ret      = 0;
+
+        if (!frame || !this || !data)
+                goto unwind;
+
+        args = data;
+        conf = this->private;
+
+        CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
-                                       !uuid_is_null (*((uuid_t*)req.gfid)),
-                                       unwind, op_errno, EINVAL);
+        req.fd    = remote_fd;
+        req.flags = args->flags;
+        memcpy (req.gfid, args->fd->inode->gfid, 16);
 
-        conf = this->private;
+        if (args->xattr) {
+                GF_PROTOCOL_DICT_SERIALIZE (this, args->xattr,
+                                            (&req.dict.dict_val),
+                                            req.dict.dict_len,
+                                            op_errno, unwind);
+        }
 
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_OPENDIR, client3_1_opendir_cbk,
+                                     GFS3_OP_FSETXATTR, client3_1_fsetxattr_cbk,
                                      NULL, NULL, 0, NULL, 0, NULL,
-                                     (xdrproc_t)xdr_gfs3_opendir_req);
+                                     (xdrproc_t)xdr_gfs3_fsetxattr_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
 
+        if (req.dict.dict_val)
+                GF_FREE (req.dict.dict_val);
+
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
         return 0;
-
 unwind:
-        CLIENT_STACK_UNWIND (opendir, frame, -1, op_errno, NULL, NULL);
+        CLIENT_STACK_UNWIND (fsetxattr, frame, -1, op_errno, NULL);
+        if (req.dict.dict_val)
+                GF_FREE (req.dict.dict_val);
 
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
@@ -4340,15 +4969,23 @@ unwind:
 
 
 
+
 int32_t
-client3_1_fsyncdir (call_frame_t *frame, xlator_t *this, void *data)
+client3_1_fgetxattr (call_frame_t *frame, xlator_t *this,
+                     void *data)
 {
-        clnt_args_t       *args      = NULL;
-        int64_t            remote_fd = -1;
-        clnt_conf_t       *conf      = NULL;
-        gfs3_fsyncdir_req  req       = {{0,},};
-        int                ret       = 0;
-        int32_t            op_errno  = ESTALE;
+        clnt_args_t        *args       = NULL;
+        int64_t             remote_fd  = -1;
+        clnt_conf_t        *conf       = NULL;
+        gfs3_fgetxattr_req  req        = {{0,},};
+        int                 op_errno   = ESTALE;
+        int                 ret        = 0;
+        int                 count      = 0;
+        clnt_local_t       *local      = NULL;
+        struct iobref      *rsp_iobref = NULL;
+        struct iobuf       *rsp_iobuf  = NULL;
+        struct iovec       *rsphdr     = NULL;
+        struct iovec        vector[MAX_IOVEC] = {{0}, };
 
         if (!frame || !this || !data)
                 goto unwind;
@@ -4358,20 +4995,55 @@ client3_1_fsyncdir (call_frame_t *frame, xlator_t *this, void *data)
 
         CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
+        local = mem_get0 (this->local_pool);
+        if (!local) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+        frame->local = local;
+
+        rsp_iobref = iobref_new ();
+        if (rsp_iobref == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        /* TODO: what is the size we should send ? */
+        rsp_iobuf = iobuf_get2 (this->ctx->iobuf_pool, 8 * GF_UNIT_KB);
+        if (rsp_iobuf == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        iobref_add (rsp_iobref, rsp_iobuf);
+        iobuf_unref (rsp_iobuf);
+
+        rsphdr = &vector[0];
+        rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
+        rsphdr->iov_len = iobuf_pagesize (rsp_iobuf);;
+        count = 1;
+        local->iobref = rsp_iobref;
+        rsp_iobuf = NULL;
+        rsp_iobref = NULL;
+
+        req.namelen = 1; /* Use it as a flag */
         req.fd   = remote_fd;
-        req.data = args->flags;
+        req.name = (char *)args->name;
+        if (!req.name) {
+                req.name = "";
+                req.namelen = 0;
+        }
         memcpy (req.gfid, args->fd->inode->gfid, 16);
 
-        conf = this->private;
-
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_FSYNCDIR, client3_1_fsyncdir_cbk,
-                                     NULL, NULL, 0,
-                                     NULL, 0, NULL,
-                                     (xdrproc_t)xdr_gfs3_fsyncdir_req);
+                                     GFS3_OP_FGETXATTR,
+                                     client3_1_fgetxattr_cbk, NULL,
+                                     rsphdr, count,
+                                     NULL, 0, local->iobref,
+                                     (xdrproc_t)xdr_gfs3_fgetxattr_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -4379,10 +5051,22 @@ client3_1_fsyncdir (call_frame_t *frame, xlator_t *this, void *data)
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
-        return 0;
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
 
+        return 0;
 unwind:
-        CLIENT_STACK_UNWIND (fsyncdir, frame, -1, op_errno, NULL);
+        CLIENT_STACK_UNWIND (fgetxattr, frame, -1, op_errno, NULL, NULL);
+
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
+
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
@@ -4392,55 +5076,139 @@ unwind:
 
 
 int32_t
-client3_1_statfs (call_frame_t *frame, xlator_t *this,
-                  void *data)
+client3_1_getxattr (call_frame_t *frame, xlator_t *this,
+                    void *data)
 {
-        clnt_conf_t     *conf     = NULL;
-        clnt_args_t     *args     = NULL;
-        gfs3_statfs_req  req      = {{0,},};
-        int              ret      = 0;
-        int              op_errno = ESTALE;
+        clnt_conf_t       *conf       = NULL;
+        clnt_args_t       *args       = NULL;
+        gfs3_getxattr_req  req        = {{0,},};
+        dict_t            *dict       = NULL;
+        int                ret        = 0;
+        int32_t            op_ret     = -1;
+        int                op_errno   = ESTALE;
+        int                count      = 0;
+        clnt_local_t      *local      = NULL;
+        struct iobref     *rsp_iobref = NULL;
+        struct iobuf      *rsp_iobuf  = NULL;
+        struct iovec      *rsphdr     = NULL;
+        struct iovec       vector[MAX_IOVEC] = {{0}, };
 
-        if (!frame || !this || !data)
+        if (!frame || !this || !data) {
+                op_errno = 0;
                 goto unwind;
-
+        }
         args = data;
 
-        if (!args->loc)
+        if (!args->loc) {
+                op_errno = EINVAL;
                 goto unwind;
+        }
 
-        if (args->loc->inode) {
-                if (!uuid_is_null (args->loc->inode->gfid))
-                        memcpy (req.gfid,  args->loc->inode->gfid, 16);
-                else
-                        memcpy (req.gfid, args->loc->gfid, 16);
-        } else
-                req.gfid[15] = 1;
+        local = mem_get0 (this->local_pool);
+        if (!local) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        loc_copy (&local->loc, args->loc);
+        if (args->name)
+                local->name = gf_strdup (args->name);
+
+        frame->local = local;
+
+        rsp_iobref = iobref_new ();
+        if (rsp_iobref == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        /* TODO: what is the size we should send ? */
+        rsp_iobuf = iobuf_get2 (this->ctx->iobuf_pool, 8 * GF_UNIT_KB);
+        if (rsp_iobuf == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        iobref_add (rsp_iobref, rsp_iobuf);
+        iobuf_unref (rsp_iobuf);
+
+        rsphdr = &vector[0];
+        rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
+        rsphdr->iov_len = iobuf_pagesize (rsp_iobuf);
+        count = 1;
+        local->iobref = rsp_iobref;
+        rsp_iobuf = NULL;
+        rsp_iobref = NULL;
+
+        if (args->loc->inode && !uuid_is_null (args->loc->inode->gfid))
+                memcpy (req.gfid,  args->loc->inode->gfid, 16);
+        else
+                memcpy (req.gfid, args->loc->gfid, 16);
 
         GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
                                        !uuid_is_null (*((uuid_t*)req.gfid)),
                                        unwind, op_errno, EINVAL);
+        req.namelen = 1; /* Use it as a flag */
+
+        req.name = (char *)args->name;
+        if (!req.name) {
+                req.name = "";
+                req.namelen = 0;
+        }
 
         conf = this->private;
 
+        if (args && args->name) {
+                if (is_client_dump_locks_cmd ((char *)args->name)) {
+                        dict = dict_new ();
+                        ret = client_dump_locks ((char *)args->name,
+                                                 args->loc->inode,
+                                                 dict);
+                        if (ret) {
+                                gf_log (this->name, GF_LOG_WARNING,
+                                        "Client dump locks failed");
+                                op_errno = EINVAL;
+                        }
+
+                        GF_ASSERT (dict);
+                        op_ret = 0;
+                        op_errno = 0;
+                        goto unwind;
+                }
+        }
+
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_STATFS, client3_1_statfs_cbk, NULL,
-                                     NULL, 0, NULL, 0,
-                                     NULL, (xdrproc_t)xdr_gfs3_statfs_req);
+                                     GFS3_OP_GETXATTR,
+                                     client3_1_getxattr_cbk, NULL,
+                                     rsphdr, count,
+                                     NULL, 0, local->iobref,
+                                     (xdrproc_t)xdr_gfs3_getxattr_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
 
-        if (req.xdata.xdata_val)
-                GF_FREE (req.xdata.xdata_val);
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
+
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
 
         return 0;
-
 unwind:
-        CLIENT_STACK_UNWIND (statfs, frame, -1, op_errno, NULL, NULL);
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
+
+        CLIENT_STACK_UNWIND (getxattr, frame, op_ret, op_errno, dict, NULL);
+
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
@@ -4450,14 +5218,20 @@ unwind:
 
 
 int32_t
-client3_1_setxattr (call_frame_t *frame, xlator_t *this,
-                    void *data)
+client3_1_xattrop (call_frame_t *frame, xlator_t *this,
+                   void *data)
 {
-        clnt_conf_t       *conf     = NULL;
-        clnt_args_t       *args     = NULL;
-        gfs3_setxattr_req  req      = {{0,},};
-        int                ret      = 0;
-        int                op_errno = ESTALE;
+        clnt_conf_t      *conf       = NULL;
+        clnt_args_t      *args       = NULL;
+        gfs3_xattrop_req  req        = {{0,},};
+        int               ret        = 0;
+        int               op_errno   = ESTALE;
+        int               count      = 0;
+        clnt_local_t   *local      = NULL;
+        struct iobref    *rsp_iobref = NULL;
+        struct iobuf     *rsp_iobuf  = NULL;
+        struct iovec     *rsphdr     = NULL;
+        struct iovec      vector[MAX_IOVEC] = {{0}, };
 
         if (!frame || !this || !data)
                 goto unwind;
@@ -4467,6 +5241,37 @@ client3_1_setxattr (call_frame_t *frame, xlator_t *this,
         if (!(args->loc && args->loc->inode))
                 goto unwind;
 
+        local = mem_get0 (this->local_pool);
+        if (!local) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+        frame->local = local;
+
+        rsp_iobref = iobref_new ();
+        if (rsp_iobref == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        /* TODO: what is the size we should send ? */
+        rsp_iobuf = iobuf_get2 (this->ctx->iobuf_pool, 8 * GF_UNIT_KB);
+        if (rsp_iobuf == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        iobref_add (rsp_iobref, rsp_iobuf);
+        iobuf_unref (rsp_iobuf);
+
+        rsphdr = &vector[0];
+        rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
+        rsphdr->iov_len = iobuf_pagesize (rsp_iobuf);
+        count = 1;
+        local->iobref = rsp_iobref;
+        rsp_iobuf = NULL;
+        rsp_iobref = NULL;
+
         if (!uuid_is_null (args->loc->inode->gfid))
                 memcpy (req.gfid,  args->loc->inode->gfid, 16);
         else
@@ -4490,23 +5295,40 @@ client3_1_setxattr (call_frame_t *frame, xlator_t *this,
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_SETXATTR, client3_1_setxattr_cbk,
-                                     NULL, NULL, 0, NULL, 0, NULL,
-                                     (xdrproc_t)xdr_gfs3_setxattr_req);
+                                     GFS3_OP_XATTROP,
+                                     client3_1_xattrop_cbk, NULL,
+                                     rsphdr, count,
+                                     NULL, 0, local->iobref,
+                                     (xdrproc_t)xdr_gfs3_xattrop_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
+
         if (req.dict.dict_val)
                 GF_FREE (req.dict.dict_val);
 
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
+
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (setxattr, frame, -1, op_errno, NULL);
-        if (req.dict.dict_val)
+        CLIENT_STACK_UNWIND (xattrop, frame, -1, op_errno, NULL, NULL);
+
+        if (req.dict.dict_val) {
                 GF_FREE (req.dict.dict_val);
+        }
+
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
 
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
@@ -4517,15 +5339,21 @@ unwind:
 
 
 int32_t
-client3_1_fsetxattr (call_frame_t *frame, xlator_t *this,
-                     void *data)
+client3_1_fxattrop (call_frame_t *frame, xlator_t *this,
+                    void *data)
 {
-        clnt_args_t        *args     = NULL;
-        int64_t             remote_fd = -1;
-        clnt_conf_t        *conf     = NULL;
-        gfs3_fsetxattr_req  req      = {{0,},};
-        int                 op_errno = ESTALE;
-        int                 ret      = 0;
+        clnt_args_t       *args       = NULL;
+        int64_t            remote_fd  = -1;
+        clnt_conf_t       *conf       = NULL;
+        gfs3_fxattrop_req  req        = {{0,},};
+        int                op_errno   = ESTALE;
+        int                ret        = 0;
+        int                count      = 0;
+        clnt_local_t    *local      = NULL;
+        struct iobref     *rsp_iobref = NULL;
+        struct iobuf      *rsp_iobuf  = NULL;
+        struct iovec      *rsphdr     = NULL;
+        struct iovec       vector[MAX_IOVEC] = {{0}, };
 
         if (!frame || !this || !data)
                 goto unwind;
@@ -4535,10 +5363,40 @@ client3_1_fsetxattr (call_frame_t *frame, xlator_t *this,
 
         CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        req.fd    = remote_fd;
-        req.flags = args->flags;
+        req.fd     = remote_fd;
+        req.flags  = args->flags;
         memcpy (req.gfid, args->fd->inode->gfid, 16);
 
+        local = mem_get0 (this->local_pool);
+        if (!local) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+        frame->local = local;
+
+        rsp_iobref = iobref_new ();
+        if (rsp_iobref == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        /* TODO: what is the size we should send ? */
+        rsp_iobuf = iobuf_get2 (this->ctx->iobuf_pool, 8 * GF_UNIT_KB);
+        if (rsp_iobuf == NULL) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        iobref_add (rsp_iobref, rsp_iobuf);
+        iobuf_unref (rsp_iobuf);
+        rsphdr = &vector[0];
+        rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
+        rsphdr->iov_len = iobuf_pagesize (rsp_iobuf);
+        count = 1;
+        local->iobref = rsp_iobref;
+        rsp_iobuf = NULL;
+        rsp_iobref = NULL;
+
         if (args->xattr) {
                 GF_PROTOCOL_DICT_SERIALIZE (this, args->xattr,
                                             (&req.dict.dict_val),
@@ -4550,9 +5408,11 @@ client3_1_fsetxattr (call_frame_t *frame, xlator_t *this,
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_FSETXATTR, client3_1_fsetxattr_cbk,
-                                     NULL, NULL, 0, NULL, 0, NULL,
-                                     (xdrproc_t)xdr_gfs3_fsetxattr_req);
+                                     GFS3_OP_FXATTROP,
+                                     client3_1_fxattrop_cbk, NULL,
+                                     rsphdr, count,
+                                     NULL, 0, local->iobref,
+                                     (xdrproc_t)xdr_gfs3_fxattrop_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -4563,12 +5423,25 @@ client3_1_fsetxattr (call_frame_t *frame, xlator_t *this,
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
+
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (fsetxattr, frame, -1, op_errno, NULL);
+        CLIENT_STACK_UNWIND (fxattrop, frame, -1, op_errno, NULL, NULL);
+
         if (req.dict.dict_val)
                 GF_FREE (req.dict.dict_val);
 
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
+
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
@@ -4576,82 +5449,95 @@ unwind:
 }
 
 
-
-
 int32_t
-client3_1_fgetxattr (call_frame_t *frame, xlator_t *this,
-                     void *data)
+client3_1_removexattr (call_frame_t *frame, xlator_t *this,
+                       void *data)
 {
-        clnt_args_t        *args       = NULL;
-        int64_t             remote_fd  = -1;
-        clnt_conf_t        *conf       = NULL;
-        gfs3_fgetxattr_req  req        = {{0,},};
-        int                 op_errno   = ESTALE;
-        int                 ret        = 0;
-        int                 count      = 0;
-        clnt_local_t       *local      = NULL;
-        struct iobref      *rsp_iobref = NULL;
-        struct iobuf       *rsp_iobuf  = NULL;
-        struct iovec       *rsphdr     = NULL;
-        struct iovec        vector[MAX_IOVEC] = {{0}, };
+        clnt_conf_t          *conf     = NULL;
+        clnt_args_t          *args     = NULL;
+        gfs3_removexattr_req  req      = {{0,},};
+        int                   ret      = 0;
+        int                   op_errno = ESTALE;
 
         if (!frame || !this || !data)
                 goto unwind;
 
         args = data;
+
+        if (!(args->loc && args->loc->inode))
+                goto unwind;
+
+        if (!uuid_is_null (args->loc->inode->gfid))
+                memcpy (req.gfid,  args->loc->inode->gfid, 16);
+        else
+                memcpy (req.gfid, args->loc->gfid, 16);
+
+        GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
+                                       !uuid_is_null (*((uuid_t*)req.gfid)),
+                                       unwind, op_errno, EINVAL);
+        req.name = (char *)args->name;
+
         conf = this->private;
 
-        CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
+        GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
+                                    req.xdata.xdata_len, op_errno, unwind);
 
-        local = mem_get0 (this->local_pool);
-        if (!local) {
-                op_errno = ENOMEM;
-                goto unwind;
+        ret = client_submit_request (this, &req, frame, conf->fops,
+                                     GFS3_OP_REMOVEXATTR,
+                                     client3_1_removexattr_cbk, NULL,
+                                     NULL, 0, NULL, 0, NULL,
+                                     (xdrproc_t)xdr_gfs3_removexattr_req);
+        if (ret) {
+                gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
-        frame->local = local;
 
-        rsp_iobref = iobref_new ();
-        if (rsp_iobref == NULL) {
-                op_errno = ENOMEM;
-                goto unwind;
-        }
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
 
-        /* TODO: what is the size we should send ? */
-        rsp_iobuf = iobuf_get2 (this->ctx->iobuf_pool, 8 * GF_UNIT_KB);
-        if (rsp_iobuf == NULL) {
-                op_errno = ENOMEM;
+        return 0;
+unwind:
+        CLIENT_STACK_UNWIND (removexattr, frame, -1, op_errno, NULL);
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
+
+        return 0;
+}
+
+int32_t
+client3_1_fremovexattr (call_frame_t *frame, xlator_t *this,
+                        void *data)
+{
+        clnt_conf_t           *conf     = NULL;
+        clnt_args_t           *args     = NULL;
+        gfs3_fremovexattr_req  req      = {{0,},};
+        int                    ret      = 0;
+        int64_t                remote_fd = -1;
+        int                    op_errno = ESTALE;
+
+        if (!frame || !this || !data)
+                goto unwind;
+
+        args = data;
+
+        if (!(args->fd && args->fd->inode))
                 goto unwind;
-        }
 
-        iobref_add (rsp_iobref, rsp_iobuf);
-        iobuf_unref (rsp_iobuf);
+        conf = this->private;
 
-        rsphdr = &vector[0];
-        rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
-        rsphdr->iov_len = iobuf_pagesize (rsp_iobuf);;
-        count = 1;
-        local->iobref = rsp_iobref;
-        rsp_iobuf = NULL;
-        rsp_iobref = NULL;
+        CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        req.namelen = 1; /* Use it as a flag */
-        req.fd   = remote_fd;
+        memcpy (req.gfid,  args->fd->inode->gfid, 16);
         req.name = (char *)args->name;
-        if (!req.name) {
-                req.name = "";
-                req.namelen = 0;
-        }
-        memcpy (req.gfid, args->fd->inode->gfid, 16);
+        req.fd = remote_fd;
 
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_FGETXATTR,
-                                     client3_1_fgetxattr_cbk, NULL,
-                                     rsphdr, count,
-                                     NULL, 0, local->iobref,
-                                     (xdrproc_t)xdr_gfs3_fgetxattr_req);
+                                     GFS3_OP_FREMOVEXATTR,
+                                     client3_1_fremovexattr_cbk, NULL,
+                                     NULL, 0, NULL, 0, NULL,
+                                     (xdrproc_t)xdr_gfs3_fremovexattr_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -4659,141 +5545,81 @@ client3_1_fgetxattr (call_frame_t *frame, xlator_t *this,
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
-
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (fgetxattr, frame, -1, op_errno, NULL, NULL);
-
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
-
+        CLIENT_STACK_UNWIND (fremovexattr, frame, -1, op_errno, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
         return 0;
 }
 
-
-
 int32_t
-client3_1_getxattr (call_frame_t *frame, xlator_t *this,
-                    void *data)
+client3_1_lk (call_frame_t *frame, xlator_t *this,
+              void *data)
 {
-        clnt_conf_t       *conf       = NULL;
-        clnt_args_t       *args       = NULL;
-        gfs3_getxattr_req  req        = {{0,},};
-        dict_t            *dict       = NULL;
-        int                ret        = 0;
-        int32_t            op_ret     = -1;
-        int                op_errno   = ESTALE;
-        int                count      = 0;
-        clnt_local_t      *local      = NULL;
-        struct iobref     *rsp_iobref = NULL;
-        struct iobuf      *rsp_iobuf  = NULL;
-        struct iovec      *rsphdr     = NULL;
-        struct iovec       vector[MAX_IOVEC] = {{0}, };
-
-        if (!frame || !this || !data) {
-                op_errno = 0;
-                goto unwind;
-        }
-        args = data;
+        clnt_args_t     *args       = NULL;
+        gfs3_lk_req      req        = {{0,},};
+        int32_t          gf_cmd     = 0;
+        int32_t          gf_type    = 0;
+        int64_t          remote_fd  = -1;
+        clnt_local_t    *local      = NULL;
+        clnt_conf_t     *conf       = NULL;
+        int              op_errno   = ESTALE;
+        int              ret        = 0;
 
-        if (!args->loc) {
-                op_errno = EINVAL;
+        if (!frame || !this || !data)
                 goto unwind;
-        }
 
+        args = data;
+        conf = this->private;
         local = mem_get0 (this->local_pool);
         if (!local) {
                 op_errno = ENOMEM;
                 goto unwind;
         }
 
-        loc_copy (&local->loc, args->loc);
-        if (args->name)
-                local->name = gf_strdup (args->name);
-
-        frame->local = local;
-
-        rsp_iobref = iobref_new ();
-        if (rsp_iobref == NULL) {
-                op_errno = ENOMEM;
-                goto unwind;
-        }
+        CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        /* TODO: what is the size we should send ? */
-        rsp_iobuf = iobuf_get2 (this->ctx->iobuf_pool, 8 * GF_UNIT_KB);
-        if (rsp_iobuf == NULL) {
-                op_errno = ENOMEM;
+        ret = client_cmd_to_gf_cmd (args->cmd, &gf_cmd);
+        if (ret) {
+                op_errno = EINVAL;
+                gf_log (this->name, GF_LOG_WARNING,
+                        "Unknown cmd (%d)!", gf_cmd);
                 goto unwind;
         }
 
-        iobref_add (rsp_iobref, rsp_iobuf);
-        iobuf_unref (rsp_iobuf);
-
-        rsphdr = &vector[0];
-        rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
-        rsphdr->iov_len = iobuf_pagesize (rsp_iobuf);
-        count = 1;
-        local->iobref = rsp_iobref;
-        rsp_iobuf = NULL;
-        rsp_iobref = NULL;
-
-        if (args->loc->inode && !uuid_is_null (args->loc->inode->gfid))
-                memcpy (req.gfid,  args->loc->inode->gfid, 16);
-        else
-                memcpy (req.gfid, args->loc->gfid, 16);
-
-        GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
-                                       !uuid_is_null (*((uuid_t*)req.gfid)),
-                                       unwind, op_errno, EINVAL);
-        req.namelen = 1; /* Use it as a flag */
-
-        req.name = (char *)args->name;
-        if (!req.name) {
-                req.name = "";
-                req.namelen = 0;
+        switch (args->flock->l_type) {
+        case F_RDLCK:
+                gf_type = GF_LK_F_RDLCK;
+                break;
+        case F_WRLCK:
+                gf_type = GF_LK_F_WRLCK;
+                break;
+        case F_UNLCK:
+                gf_type = GF_LK_F_UNLCK;
+                break;
         }
 
-        conf = this->private;
+        local->owner = frame->root->lk_owner;
+        local->cmd   = args->cmd;
+        local->fd    = fd_ref (args->fd);
+        frame->local = local;
 
-        if (args && args->name) {
-                if (is_client_dump_locks_cmd ((char *)args->name)) {
-                        dict = dict_new ();
-                        ret = client_dump_locks ((char *)args->name,
-                                                 args->loc->inode,
-                                                 dict);
-                        if (ret) {
-                                gf_log (this->name, GF_LOG_WARNING,
-                                        "Client dump locks failed");
-                                op_errno = EINVAL;
-                        }
+        req.fd    = remote_fd;
+        req.cmd   = gf_cmd;
+        req.type  = gf_type;
+        gf_proto_flock_from_flock (&req.flock, args->flock);
 
-                        GF_ASSERT (dict);
-                        op_ret = 0;
-                        op_errno = 0;
-                        goto unwind;
-                }
-        }
+        memcpy (req.gfid, args->fd->inode->gfid, 16);
 
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
-        ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_GETXATTR,
-                                     client3_1_getxattr_cbk, NULL,
-                                     rsphdr, count,
-                                     NULL, 0, local->iobref,
-                                     (xdrproc_t)xdr_gfs3_getxattr_req);
+        ret = client_submit_request (this, &req, frame, conf->fops, GFS3_OP_LK,
+                                     client3_1_lk_cbk, NULL,
+                                     NULL, 0, NULL, 0, NULL,
+                                     (xdrproc_t)xdr_gfs3_lk_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -4801,22 +5627,9 @@ client3_1_getxattr (call_frame_t *frame, xlator_t *this,
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
-
         return 0;
 unwind:
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
-
-        CLIENT_STACK_UNWIND (getxattr, frame, op_ret, op_errno, dict, NULL);
-
+        CLIENT_STACK_UNWIND (lk, frame, -1, op_errno, NULL, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
@@ -4824,61 +5637,24 @@ unwind:
 }
 
 
-
 int32_t
-client3_1_xattrop (call_frame_t *frame, xlator_t *this,
+client3_1_inodelk (call_frame_t *frame, xlator_t *this,
                    void *data)
 {
-        clnt_conf_t      *conf       = NULL;
-        clnt_args_t      *args       = NULL;
-        gfs3_xattrop_req  req        = {{0,},};
-        int               ret        = 0;
-        int               op_errno   = ESTALE;
-        int               count      = 0;
-        clnt_local_t   *local      = NULL;
-        struct iobref    *rsp_iobref = NULL;
-        struct iobuf     *rsp_iobuf  = NULL;
-        struct iovec     *rsphdr     = NULL;
-        struct iovec      vector[MAX_IOVEC] = {{0}, };
-
-        if (!frame || !this || !data)
-                goto unwind;
-
-        args = data;
-
-        if (!(args->loc && args->loc->inode))
-                goto unwind;
-
-        local = mem_get0 (this->local_pool);
-        if (!local) {
-                op_errno = ENOMEM;
-                goto unwind;
-        }
-        frame->local = local;
-
-        rsp_iobref = iobref_new ();
-        if (rsp_iobref == NULL) {
-                op_errno = ENOMEM;
-                goto unwind;
-        }
-
-        /* TODO: what is the size we should send ? */
-        rsp_iobuf = iobuf_get2 (this->ctx->iobuf_pool, 8 * GF_UNIT_KB);
-        if (rsp_iobuf == NULL) {
-                op_errno = ENOMEM;
-                goto unwind;
-        }
-
-        iobref_add (rsp_iobref, rsp_iobuf);
-        iobuf_unref (rsp_iobuf);
+        clnt_conf_t      *conf     = NULL;
+        clnt_args_t      *args    = NULL;
+        gfs3_inodelk_req  req     = {{0,},};
+        int               ret     = 0;
+        int32_t           gf_cmd  = 0;
+        int32_t           gf_type = 0;
+        int               op_errno = ESTALE;
 
-        rsphdr = &vector[0];
-        rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
-        rsphdr->iov_len = iobuf_pagesize (rsp_iobuf);
-        count = 1;
-        local->iobref = rsp_iobref;
-        rsp_iobuf = NULL;
-        rsp_iobref = NULL;
+        if (!frame || !this || !data)
+                goto unwind;
+
+        args = data;
+        if (!(args->loc && args->loc->inode))
+                goto unwind;
 
         if (!uuid_is_null (args->loc->inode->gfid))
                 memcpy (req.gfid,  args->loc->inode->gfid, 16);
@@ -4888,14 +5664,35 @@ client3_1_xattrop (call_frame_t *frame, xlator_t *this,
         GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
                                        !uuid_is_null (*((uuid_t*)req.gfid)),
                                        unwind, op_errno, EINVAL);
-        if (args->xattr) {
-                GF_PROTOCOL_DICT_SERIALIZE (this, args->xattr,
-                                            (&req.dict.dict_val),
-                                            req.dict.dict_len,
-                                            op_errno, unwind);
+        if (args->cmd == F_GETLK || args->cmd == F_GETLK64)
+                gf_cmd = GF_LK_GETLK;
+        else if (args->cmd == F_SETLK || args->cmd == F_SETLK64)
+                gf_cmd = GF_LK_SETLK;
+        else if (args->cmd == F_SETLKW || args->cmd == F_SETLKW64)
+                gf_cmd = GF_LK_SETLKW;
+        else {
+                gf_log (this->name, GF_LOG_WARNING,
+                        "Unknown cmd (%d)!", gf_cmd);
+                op_errno = EINVAL;
+                goto unwind;
         }
 
-        req.flags = args->flags;
+        switch (args->flock->l_type) {
+        case F_RDLCK:
+                gf_type = GF_LK_F_RDLCK;
+                break;
+        case F_WRLCK:
+                gf_type = GF_LK_F_WRLCK;
+                break;
+        case F_UNLCK:
+                gf_type = GF_LK_F_UNLCK;
+                break;
+        }
+
+        req.volume = (char *)args->volume;
+        req.cmd    = gf_cmd;
+        req.type   = gf_type;
+        gf_proto_flock_from_flock (&req.flock, args->flock);
 
         conf = this->private;
 
@@ -4903,41 +5700,20 @@ client3_1_xattrop (call_frame_t *frame, xlator_t *this,
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_XATTROP,
-                                     client3_1_xattrop_cbk, NULL,
-                                     rsphdr, count,
-                                     NULL, 0, local->iobref,
-                                     (xdrproc_t)xdr_gfs3_xattrop_req);
+                                     GFS3_OP_INODELK,
+                                     client3_1_inodelk_cbk, NULL,
+                                     NULL, 0, NULL, 0,
+                                     NULL, (xdrproc_t)xdr_gfs3_inodelk_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
 
-        if (req.dict.dict_val)
-                GF_FREE (req.dict.dict_val);
-
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
-
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (xattrop, frame, -1, op_errno, NULL, NULL);
-
-        if (req.dict.dict_val) {
-                GF_FREE (req.dict.dict_val);
-        }
-
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
-
+        CLIENT_STACK_UNWIND (inodelk, frame, -1, op_errno, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
@@ -4947,21 +5723,17 @@ unwind:
 
 
 int32_t
-client3_1_fxattrop (call_frame_t *frame, xlator_t *this,
+client3_1_finodelk (call_frame_t *frame, xlator_t *this,
                     void *data)
 {
-        clnt_args_t       *args       = NULL;
-        int64_t            remote_fd  = -1;
-        clnt_conf_t       *conf       = NULL;
-        gfs3_fxattrop_req  req        = {{0,},};
-        int                op_errno   = ESTALE;
-        int                ret        = 0;
-        int                count      = 0;
-        clnt_local_t    *local      = NULL;
-        struct iobref     *rsp_iobref = NULL;
-        struct iobuf      *rsp_iobuf  = NULL;
-        struct iovec      *rsphdr     = NULL;
-        struct iovec       vector[MAX_IOVEC] = {{0}, };
+        clnt_args_t       *args     = NULL;
+        gfs3_finodelk_req  req      = {{0,},};
+        int32_t            gf_cmd   = 0;
+        int32_t            gf_type  = 0;
+        int64_t            remote_fd = -1;
+        clnt_conf_t       *conf     = NULL;
+        int                op_errno = ESTALE;
+        int           ret        = 0;
 
         if (!frame || !this || !data)
                 goto unwind;
@@ -4971,85 +5743,54 @@ client3_1_fxattrop (call_frame_t *frame, xlator_t *this,
 
         CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        req.fd     = remote_fd;
-        req.flags  = args->flags;
-        memcpy (req.gfid, args->fd->inode->gfid, 16);
-
-        local = mem_get0 (this->local_pool);
-        if (!local) {
-                op_errno = ENOMEM;
-                goto unwind;
-        }
-        frame->local = local;
-
-        rsp_iobref = iobref_new ();
-        if (rsp_iobref == NULL) {
-                op_errno = ENOMEM;
+        if (args->cmd == F_GETLK || args->cmd == F_GETLK64)
+                gf_cmd = GF_LK_GETLK;
+        else if (args->cmd == F_SETLK || args->cmd == F_SETLK64)
+                gf_cmd = GF_LK_SETLK;
+        else if (args->cmd == F_SETLKW || args->cmd == F_SETLKW64)
+                gf_cmd = GF_LK_SETLKW;
+        else {
+                gf_log (this->name, GF_LOG_WARNING,
+                        "Unknown cmd (%d)!", gf_cmd);
                 goto unwind;
         }
 
-        /* TODO: what is the size we should send ? */
-        rsp_iobuf = iobuf_get2 (this->ctx->iobuf_pool, 8 * GF_UNIT_KB);
-        if (rsp_iobuf == NULL) {
-                op_errno = ENOMEM;
-                goto unwind;
+        switch (args->flock->l_type) {
+        case F_RDLCK:
+                gf_type = GF_LK_F_RDLCK;
+                break;
+        case F_WRLCK:
+                gf_type = GF_LK_F_WRLCK;
+                break;
+        case F_UNLCK:
+                gf_type = GF_LK_F_UNLCK;
+                break;
         }
 
-        iobref_add (rsp_iobref, rsp_iobuf);
-        iobuf_unref (rsp_iobuf);
-        rsphdr = &vector[0];
-        rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
-        rsphdr->iov_len = iobuf_pagesize (rsp_iobuf);
-        count = 1;
-        local->iobref = rsp_iobref;
-        rsp_iobuf = NULL;
-        rsp_iobref = NULL;
-
-        if (args->xattr) {
-                GF_PROTOCOL_DICT_SERIALIZE (this, args->xattr,
-                                            (&req.dict.dict_val),
-                                            req.dict.dict_len,
-                                            op_errno, unwind);
-        }
+        req.volume = (char *)args->volume;
+        req.fd    = remote_fd;
+        req.cmd   = gf_cmd;
+        req.type  = gf_type;
+        gf_proto_flock_from_flock (&req.flock, args->flock);
+        memcpy (req.gfid, args->fd->inode->gfid, 16);
 
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_FXATTROP,
-                                     client3_1_fxattrop_cbk, NULL,
-                                     rsphdr, count,
-                                     NULL, 0, local->iobref,
-                                     (xdrproc_t)xdr_gfs3_fxattrop_req);
+                                     GFS3_OP_FINODELK,
+                                     client3_1_finodelk_cbk, NULL,
+                                     NULL, 0, NULL, 0,
+                                     NULL, (xdrproc_t)xdr_gfs3_finodelk_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
 
-        if (req.dict.dict_val)
-                GF_FREE (req.dict.dict_val);
-
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
-
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
-
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (fxattrop, frame, -1, op_errno, NULL, NULL);
-
-        if (req.dict.dict_val)
-                GF_FREE (req.dict.dict_val);
-
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
-
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
+        CLIENT_STACK_UNWIND (finodelk, frame, -1, op_errno, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
@@ -5058,14 +5799,14 @@ unwind:
 
 
 int32_t
-client3_1_removexattr (call_frame_t *frame, xlator_t *this,
-                       void *data)
+client3_1_entrylk (call_frame_t *frame, xlator_t *this,
+                   void *data)
 {
-        clnt_conf_t          *conf     = NULL;
-        clnt_args_t          *args     = NULL;
-        gfs3_removexattr_req  req      = {{0,},};
-        int                   ret      = 0;
-        int                   op_errno = ESTALE;
+        clnt_conf_t      *conf     = NULL;
+        clnt_args_t      *args     = NULL;
+        gfs3_entrylk_req  req      = {{0,},};
+        int               ret      = 0;
+        int               op_errno = ESTALE;
 
         if (!frame || !this || !data)
                 goto unwind;
@@ -5083,7 +5824,14 @@ client3_1_removexattr (call_frame_t *frame, xlator_t *this,
         GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
                                        !uuid_is_null (*((uuid_t*)req.gfid)),
                                        unwind, op_errno, EINVAL);
-        req.name = (char *)args->name;
+        req.cmd = args->cmd_entrylk;
+        req.type = args->type;
+        req.volume = (char *)args->volume;
+        req.name = "";
+        if (args->basename) {
+                req.name = (char *)args->basename;
+                req.namelen = 1;
+        }
 
         conf = this->private;
 
@@ -5091,10 +5839,10 @@ client3_1_removexattr (call_frame_t *frame, xlator_t *this,
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_REMOVEXATTR,
-                                     client3_1_removexattr_cbk, NULL,
-                                     NULL, 0, NULL, 0, NULL,
-                                     (xdrproc_t)xdr_gfs3_removexattr_req);
+                                     GFS3_OP_ENTRYLK,
+                                     client3_1_entrylk_cbk, NULL,
+                                     NULL, 0, NULL, 0,
+                                     NULL, (xdrproc_t)xdr_gfs3_entrylk_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -5104,48 +5852,53 @@ client3_1_removexattr (call_frame_t *frame, xlator_t *this,
 
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (removexattr, frame, -1, op_errno, NULL);
+        CLIENT_STACK_UNWIND (entrylk, frame, -1, op_errno, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
         return 0;
 }
 
+
+
 int32_t
-client3_1_fremovexattr (call_frame_t *frame, xlator_t *this,
-                        void *data)
+client3_1_fentrylk (call_frame_t *frame, xlator_t *this,
+                    void *data)
 {
-        clnt_conf_t           *conf     = NULL;
-        clnt_args_t           *args     = NULL;
-        gfs3_fremovexattr_req  req      = {{0,},};
-        int                    ret      = 0;
-        int64_t                remote_fd = -1;
-        int                    op_errno = ESTALE;
+        clnt_args_t       *args     = NULL;
+        gfs3_fentrylk_req  req      = {{0,},};
+        int64_t            remote_fd = -1;
+        clnt_conf_t       *conf     = NULL;
+        int                op_errno = ESTALE;
+        int           ret        = 0;
 
         if (!frame || !this || !data)
                 goto unwind;
 
         args = data;
-
-        if (!(args->fd && args->fd->inode))
-                goto unwind;
-
         conf = this->private;
 
         CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        memcpy (req.gfid,  args->fd->inode->gfid, 16);
-        req.name = (char *)args->name;
-        req.fd = remote_fd;
+        req.fd  = remote_fd;
+        req.cmd = args->cmd_entrylk;
+        req.type = args->type;
+        req.volume = (char *)args->volume;
+        req.name = "";
+        if (args->basename) {
+                req.name = (char *)args->basename;
+                req.namelen = 1;
+        }
+        memcpy (req.gfid, args->fd->inode->gfid, 16);
 
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_FREMOVEXATTR,
-                                     client3_1_fremovexattr_cbk, NULL,
-                                     NULL, 0, NULL, 0, NULL,
-                                     (xdrproc_t)xdr_gfs3_fremovexattr_req);
+                                     GFS3_OP_FENTRYLK,
+                                     client3_1_fentrylk_cbk, NULL,
+                                     NULL, 0, NULL, 0,
+                                     NULL, (xdrproc_t)xdr_gfs3_fentrylk_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -5155,79 +5908,46 @@ client3_1_fremovexattr (call_frame_t *frame, xlator_t *this,
 
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (fremovexattr, frame, -1, op_errno, NULL);
+        CLIENT_STACK_UNWIND (fentrylk, frame, -1, op_errno, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
         return 0;
 }
 
+
 int32_t
-client3_1_lk (call_frame_t *frame, xlator_t *this,
-              void *data)
+client3_1_rchecksum (call_frame_t *frame, xlator_t *this,
+                     void *data)
 {
-        clnt_args_t     *args       = NULL;
-        gfs3_lk_req      req        = {{0,},};
-        int32_t          gf_cmd     = 0;
-        int32_t          gf_type    = 0;
-        int64_t          remote_fd  = -1;
-        clnt_local_t    *local      = NULL;
-        clnt_conf_t     *conf       = NULL;
-        int              op_errno   = ESTALE;
-        int              ret        = 0;
+        clnt_args_t        *args     = NULL;
+        int64_t             remote_fd = -1;
+        clnt_conf_t        *conf     = NULL;
+        gfs3_rchecksum_req  req      = {0,};
+        int                 op_errno = ESTALE;
+        int                 ret        = 0;
 
         if (!frame || !this || !data)
                 goto unwind;
 
         args = data;
         conf = this->private;
-        local = mem_get0 (this->local_pool);
-        if (!local) {
-                op_errno = ENOMEM;
-                goto unwind;
-        }
 
         CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        ret = client_cmd_to_gf_cmd (args->cmd, &gf_cmd);
-        if (ret) {
-                op_errno = EINVAL;
-                gf_log (this->name, GF_LOG_WARNING,
-                        "Unknown cmd (%d)!", gf_cmd);
-                goto unwind;
-        }
-
-        switch (args->flock->l_type) {
-        case F_RDLCK:
-                gf_type = GF_LK_F_RDLCK;
-                break;
-        case F_WRLCK:
-                gf_type = GF_LK_F_WRLCK;
-                break;
-        case F_UNLCK:
-                gf_type = GF_LK_F_UNLCK;
-                break;
-        }
-
-        local->owner = frame->root->lk_owner;
-        local->cmd   = args->cmd;
-        local->fd    = fd_ref (args->fd);
-        frame->local = local;
-
-        req.fd    = remote_fd;
-        req.cmd   = gf_cmd;
-        req.type  = gf_type;
-        gf_proto_flock_from_flock (&req.flock, args->flock);
-
-        memcpy (req.gfid, args->fd->inode->gfid, 16);
+        req.len    = args->len;
+        req.offset = args->offset;
+        req.fd     = remote_fd;
 
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
-        ret = client_submit_request (this, &req, frame, conf->fops, GFS3_OP_LK,
-                                     client3_1_lk_cbk, NULL,
-                                     NULL, 0, NULL, 0, NULL,
-                                     (xdrproc_t)xdr_gfs3_lk_req);
+        ret = client_submit_request (this, &req, frame, conf->fops,
+                                     GFS3_OP_RCHECKSUM,
+                                     client3_1_rchecksum_cbk, NULL,
+                                     NULL, 0, NULL,
+                                     0, NULL,
+                                     (xdrproc_t)xdr_gfs3_rchecksum_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -5237,7 +5957,7 @@ client3_1_lk (call_frame_t *frame, xlator_t *this,
 
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (lk, frame, -1, op_errno, NULL, NULL);
+        CLIENT_STACK_UNWIND (rchecksum, frame, -1, op_errno, 0, NULL, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
@@ -5245,73 +5965,88 @@ unwind:
 }
 
 
+
 int32_t
-client3_1_inodelk (call_frame_t *frame, xlator_t *this,
+client3_1_readdir (call_frame_t *frame, xlator_t *this,
                    void *data)
 {
-        clnt_conf_t      *conf     = NULL;
-        clnt_args_t      *args    = NULL;
-        gfs3_inodelk_req  req     = {{0,},};
-        int               ret     = 0;
-        int32_t           gf_cmd  = 0;
-        int32_t           gf_type = 0;
-        int               op_errno = ESTALE;
+        clnt_args_t      *args       = NULL;
+        int64_t           remote_fd  = -1;
+        clnt_conf_t      *conf       = NULL;
+        gfs3_readdir_req  req        = {{0,},};
+        gfs3_readdir_rsp  rsp        = {0, };
+        clnt_local_t     *local      = NULL;
+        int               op_errno   = ESTALE;
+        int               ret        = 0;
+        int               count      = 0;
+        struct iobref    *rsp_iobref = NULL;
+        struct iobuf     *rsp_iobuf  = NULL;
+        struct iovec     *rsphdr     = NULL;
+        struct iovec      vector[MAX_IOVEC] = {{0}, };
+        int               readdir_rsp_size  = 0;
 
         if (!frame || !this || !data)
                 goto unwind;
 
         args = data;
-        if (!(args->loc && args->loc->inode))
-                goto unwind;
+        conf = this->private;
 
-        if (!uuid_is_null (args->loc->inode->gfid))
-                memcpy (req.gfid,  args->loc->inode->gfid, 16);
-        else
-                memcpy (req.gfid, args->loc->gfid, 16);
+        CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
-                                       !uuid_is_null (*((uuid_t*)req.gfid)),
-                                       unwind, op_errno, EINVAL);
-        if (args->cmd == F_GETLK || args->cmd == F_GETLK64)
-                gf_cmd = GF_LK_GETLK;
-        else if (args->cmd == F_SETLK || args->cmd == F_SETLK64)
-                gf_cmd = GF_LK_SETLK;
-        else if (args->cmd == F_SETLKW || args->cmd == F_SETLKW64)
-                gf_cmd = GF_LK_SETLKW;
-        else {
-                gf_log (this->name, GF_LOG_WARNING,
-                        "Unknown cmd (%d)!", gf_cmd);
-                op_errno = EINVAL;
-                goto unwind;
-        }
+        readdir_rsp_size = xdr_sizeof ((xdrproc_t) xdr_gfs3_readdir_rsp, &rsp)
+                + args->size;
 
-        switch (args->flock->l_type) {
-        case F_RDLCK:
-                gf_type = GF_LK_F_RDLCK;
-                break;
-        case F_WRLCK:
-                gf_type = GF_LK_F_WRLCK;
-                break;
-        case F_UNLCK:
-                gf_type = GF_LK_F_UNLCK;
-                break;
+        if ((readdir_rsp_size + GLUSTERFS_RPC_REPLY_SIZE + GLUSTERFS_RDMA_MAX_HEADER_SIZE)
+            > (GLUSTERFS_RDMA_INLINE_THRESHOLD)) {
+                local = mem_get0 (this->local_pool);
+                if (!local) {
+                        op_errno = ENOMEM;
+                        goto unwind;
+                }
+                frame->local = local;
+
+                rsp_iobref = iobref_new ();
+                if (rsp_iobref == NULL) {
+                        goto unwind;
+                }
+
+                /* TODO: what is the size we should send ? */
+                /* This iobuf will live for only receiving the response,
+                   so not harmful */
+                rsp_iobuf = iobuf_get (this->ctx->iobuf_pool);
+                if (rsp_iobuf == NULL) {
+                        goto unwind;
+                }
+
+                iobref_add (rsp_iobref, rsp_iobuf);
+                iobuf_unref (rsp_iobuf);
+
+                rsphdr = &vector[0];
+                rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
+                rsphdr->iov_len  = iobuf_pagesize (rsp_iobuf);
+                count = 1;
+                local->iobref = rsp_iobref;
+                rsp_iobuf = NULL;
+                rsp_iobref = NULL;
         }
 
-        req.volume = (char *)args->volume;
-        req.cmd    = gf_cmd;
-        req.type   = gf_type;
-        gf_proto_flock_from_flock (&req.flock, args->flock);
+        req.size = args->size;
+        req.offset = args->offset;
+        req.fd = remote_fd;
 
-        conf = this->private;
+        local->cmd = remote_fd;
 
+        memcpy (req.gfid, args->fd->inode->gfid, 16);
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_INODELK,
-                                     client3_1_inodelk_cbk, NULL,
-                                     NULL, 0, NULL, 0,
-                                     NULL, (xdrproc_t)xdr_gfs3_inodelk_req);
+                                     GFS3_OP_READDIR,
+                                     client3_1_readdir_cbk, NULL,
+                                     rsphdr, count,
+                                     NULL, 0, rsp_iobref,
+                                     (xdrproc_t)xdr_gfs3_readdir_req);
+
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -5319,9 +6054,22 @@ client3_1_inodelk (call_frame_t *frame, xlator_t *this,
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
+
         return 0;
+
 unwind:
-        CLIENT_STACK_UNWIND (inodelk, frame, -1, op_errno, NULL);
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
+
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
+        CLIENT_STACK_UNWIND (readdir, frame, -1, op_errno, NULL, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
@@ -5329,19 +6077,24 @@ unwind:
 }
 
 
-
 int32_t
-client3_1_finodelk (call_frame_t *frame, xlator_t *this,
+client3_1_readdirp (call_frame_t *frame, xlator_t *this,
                     void *data)
 {
-        clnt_args_t       *args     = NULL;
-        gfs3_finodelk_req  req      = {{0,},};
-        int32_t            gf_cmd   = 0;
-        int32_t            gf_type  = 0;
-        int64_t            remote_fd = -1;
-        clnt_conf_t       *conf     = NULL;
-        int                op_errno = ESTALE;
-        int           ret        = 0;
+        clnt_args_t      *args              = NULL;
+        gfs3_readdirp_req req               = {{0,},};
+        gfs3_readdirp_rsp rsp               = {0,};
+        int64_t           remote_fd         = -1;
+        clnt_conf_t      *conf              = NULL;
+        int               op_errno          = ESTALE;
+        int               ret               = 0;
+        int               count             = 0;
+        int               readdirp_rsp_size = 0;
+        struct iobref    *rsp_iobref        = NULL;
+        struct iobuf     *rsp_iobuf         = NULL;
+        struct iovec     *rsphdr            = NULL;
+        struct iovec      vector[MAX_IOVEC] = {{0}, };
+        clnt_local_t     *local             = NULL;
 
         if (!frame || !this || !data)
                 goto unwind;
@@ -5351,68 +6104,97 @@ client3_1_finodelk (call_frame_t *frame, xlator_t *this,
 
         CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        if (args->cmd == F_GETLK || args->cmd == F_GETLK64)
-                gf_cmd = GF_LK_GETLK;
-        else if (args->cmd == F_SETLK || args->cmd == F_SETLK64)
-                gf_cmd = GF_LK_SETLK;
-        else if (args->cmd == F_SETLKW || args->cmd == F_SETLKW64)
-                gf_cmd = GF_LK_SETLKW;
-        else {
-                gf_log (this->name, GF_LOG_WARNING,
-                        "Unknown cmd (%d)!", gf_cmd);
+        readdirp_rsp_size = xdr_sizeof ((xdrproc_t) xdr_gfs3_readdirp_rsp, &rsp)
+                + args->size;
+
+        local = mem_get0 (this->local_pool);
+        if (!local) {
+                op_errno = ENOMEM;
                 goto unwind;
         }
+        frame->local = local;
+
+        if ((readdirp_rsp_size + GLUSTERFS_RPC_REPLY_SIZE
+             + GLUSTERFS_RDMA_MAX_HEADER_SIZE)
+            > (GLUSTERFS_RDMA_INLINE_THRESHOLD)) {
+                rsp_iobref = iobref_new ();
+                if (rsp_iobref == NULL) {
+                        goto unwind;
+                }
+
+                /* TODO: what is the size we should send ? */
+                /* This iobuf will live for only receiving the response,
+                   so not harmful */
+                rsp_iobuf = iobuf_get (this->ctx->iobuf_pool);
+                if (rsp_iobuf == NULL) {
+                        goto unwind;
+                }
 
-        switch (args->flock->l_type) {
-        case F_RDLCK:
-                gf_type = GF_LK_F_RDLCK;
-                break;
-        case F_WRLCK:
-                gf_type = GF_LK_F_WRLCK;
-                break;
-        case F_UNLCK:
-                gf_type = GF_LK_F_UNLCK;
-                break;
+                iobref_add (rsp_iobref, rsp_iobuf);
+                iobuf_unref (rsp_iobuf);
+
+                rsphdr = &vector[0];
+                rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
+                rsphdr->iov_len  = iobuf_pagesize (rsp_iobuf);
+                count = 1;
+                local->iobref = rsp_iobref;
+                rsp_iobuf = NULL;
+                rsp_iobref = NULL;
         }
 
-        req.volume = (char *)args->volume;
-        req.fd    = remote_fd;
-        req.cmd   = gf_cmd;
-        req.type  = gf_type;
-        gf_proto_flock_from_flock (&req.flock, args->flock);
+        local->fd = fd_ref (args->fd);
+
+        req.size = args->size;
+        req.offset = args->offset;
+        req.fd = remote_fd;
         memcpy (req.gfid, args->fd->inode->gfid, 16);
 
-        GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
-                                    req.xdata.xdata_len, op_errno, unwind);
+        /* dict itself is 'xdata' here */
+        GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.dict.dict_val),
+                                    req.dict.dict_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_FINODELK,
-                                     client3_1_finodelk_cbk, NULL,
-                                     NULL, 0, NULL, 0,
-                                     NULL, (xdrproc_t)xdr_gfs3_finodelk_req);
+                                     GFS3_OP_READDIRP,
+                                     client3_1_readdirp_cbk, NULL,
+                                     rsphdr, count, NULL,
+                                     0, rsp_iobref,
+                                     (xdrproc_t)xdr_gfs3_readdirp_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
 
-        if (req.xdata.xdata_val)
-                GF_FREE (req.xdata.xdata_val);
+        if (req.dict.dict_val)
+                GF_FREE (req.dict.dict_val);
+
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
+
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (finodelk, frame, -1, op_errno, NULL);
-        if (req.xdata.xdata_val)
-                GF_FREE (req.xdata.xdata_val);
+        if (rsp_iobref)
+                iobref_unref (rsp_iobref);
+
+        if (rsp_iobuf)
+                iobuf_unref (rsp_iobuf);
+
+        if (req.dict.dict_val)
+                GF_FREE (req.dict.dict_val);
 
+        CLIENT_STACK_UNWIND (readdirp, frame, -1, op_errno, NULL, NULL);
         return 0;
 }
 
 
 int32_t
-client3_1_entrylk (call_frame_t *frame, xlator_t *this,
+client3_1_setattr (call_frame_t *frame, xlator_t *this,
                    void *data)
 {
         clnt_conf_t      *conf     = NULL;
         clnt_args_t      *args     = NULL;
-        gfs3_entrylk_req  req      = {{0,},};
+        gfs3_setattr_req  req      = {{0,},};
         int               ret      = 0;
         int               op_errno = ESTALE;
 
@@ -5425,21 +6207,15 @@ client3_1_entrylk (call_frame_t *frame, xlator_t *this,
                 goto unwind;
 
         if (!uuid_is_null (args->loc->inode->gfid))
-                memcpy (req.gfid,  args->loc->inode->gfid, 16);
+                memcpy (req.gfid, args->loc->inode->gfid, 16);
         else
                 memcpy (req.gfid, args->loc->gfid, 16);
 
         GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
                                        !uuid_is_null (*((uuid_t*)req.gfid)),
                                        unwind, op_errno, EINVAL);
-        req.cmd = args->cmd_entrylk;
-        req.type = args->type;
-        req.volume = (char *)args->volume;
-        req.name = "";
-        if (args->basename) {
-                req.name = (char *)args->basename;
-                req.namelen = 1;
-        }
+        req.valid = args->valid;
+        gf_stat_from_iatt (&req.stbuf, args->stbuf);
 
         conf = this->private;
 
@@ -5447,10 +6223,10 @@ client3_1_entrylk (call_frame_t *frame, xlator_t *this,
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_ENTRYLK,
-                                     client3_1_entrylk_cbk, NULL,
+                                     GFS3_OP_SETATTR,
+                                     client3_1_setattr_cbk, NULL,
                                      NULL, 0, NULL, 0,
-                                     NULL, (xdrproc_t)xdr_gfs3_entrylk_req);
+                                     NULL, (xdrproc_t)xdr_gfs3_setattr_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -5460,25 +6236,22 @@ client3_1_entrylk (call_frame_t *frame, xlator_t *this,
 
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (entrylk, frame, -1, op_errno, NULL);
+        CLIENT_STACK_UNWIND (setattr, frame, -1, op_errno, NULL, NULL, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
         return 0;
 }
 
-
-
 int32_t
-client3_1_fentrylk (call_frame_t *frame, xlator_t *this,
-                    void *data)
+client3_1_fsetattr (call_frame_t *frame, xlator_t *this, void *data)
 {
         clnt_args_t       *args     = NULL;
-        gfs3_fentrylk_req  req      = {{0,},};
         int64_t            remote_fd = -1;
         clnt_conf_t       *conf     = NULL;
+        gfs3_fsetattr_req  req      = {0,};
         int                op_errno = ESTALE;
-        int           ret        = 0;
+        int                ret        = 0;
 
         if (!frame || !this || !data)
                 goto unwind;
@@ -5488,25 +6261,18 @@ client3_1_fentrylk (call_frame_t *frame, xlator_t *this,
 
         CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        req.fd  = remote_fd;
-        req.cmd = args->cmd_entrylk;
-        req.type = args->type;
-        req.volume = (char *)args->volume;
-        req.name = "";
-        if (args->basename) {
-                req.name = (char *)args->basename;
-                req.namelen = 1;
-        }
-        memcpy (req.gfid, args->fd->inode->gfid, 16);
+        req.fd = remote_fd;
+        req.valid = args->valid;
+        gf_stat_from_iatt (&req.stbuf, args->stbuf);
 
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_FENTRYLK,
-                                     client3_1_fentrylk_cbk, NULL,
+                                     GFS3_OP_FSETATTR,
+                                     client3_1_fsetattr_cbk, NULL,
                                      NULL, 0, NULL, 0,
-                                     NULL, (xdrproc_t)xdr_gfs3_fentrylk_req);
+                                     NULL, (xdrproc_t)xdr_gfs3_fsetattr_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -5516,24 +6282,22 @@ client3_1_fentrylk (call_frame_t *frame, xlator_t *this,
 
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (fentrylk, frame, -1, op_errno, NULL);
+        CLIENT_STACK_UNWIND (fsetattr, frame, -1, op_errno, NULL, NULL, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
         return 0;
 }
 
-
 int32_t
-client3_1_rchecksum (call_frame_t *frame, xlator_t *this,
-                     void *data)
+client3_1_fallocate (call_frame_t *frame, xlator_t *this, void *data)
 {
-        clnt_args_t        *args     = NULL;
-        int64_t             remote_fd = -1;
-        clnt_conf_t        *conf     = NULL;
-        gfs3_rchecksum_req  req      = {0,};
-        int                 op_errno = ESTALE;
-        int                 ret        = 0;
+        clnt_args_t       *args      = NULL;
+        int64_t            remote_fd = -1;
+        clnt_conf_t       *conf      = NULL;
+        gfs3_fallocate_req  req       = {{0,},};
+        int                op_errno  = ESTALE;
+        int                ret       = 0;
 
         if (!frame || !this || !data)
                 goto unwind;
@@ -5543,19 +6307,20 @@ client3_1_rchecksum (call_frame_t *frame, xlator_t *this,
 
         CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        req.len    = args->len;
-        req.offset = args->offset;
         req.fd     = remote_fd;
+        req.flags  = args->flags;
+        req.offset = args->offset;
+        req.size   = args->size;
+        memcpy (req.gfid, args->fd->inode->gfid, 16);
 
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_RCHECKSUM,
-                                     client3_1_rchecksum_cbk, NULL,
-                                     NULL, 0, NULL,
-                                     0, NULL,
-                                     (xdrproc_t)xdr_gfs3_rchecksum_req);
+                                     GFS3_OP_FALLOCATE,
+                                     client3_1_fallocate_cbk, NULL,
+                                     NULL, 0, NULL, 0,
+                                     NULL, (xdrproc_t)xdr_gfs3_fallocate_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -5565,33 +6330,22 @@ client3_1_rchecksum (call_frame_t *frame, xlator_t *this,
 
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (rchecksum, frame, -1, op_errno, 0, NULL, NULL);
+        CLIENT_STACK_UNWIND (fallocate, frame, -1, op_errno, NULL, NULL, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
         return 0;
 }
 
-
-
 int32_t
-client3_1_readdir (call_frame_t *frame, xlator_t *this,
-                   void *data)
+client3_1_discard (call_frame_t *frame, xlator_t *this, void *data)
 {
-        clnt_args_t      *args       = NULL;
-        int64_t           remote_fd  = -1;
-        clnt_conf_t      *conf       = NULL;
-        gfs3_readdir_req  req        = {{0,},};
-        gfs3_readdir_rsp  rsp        = {0, };
-        clnt_local_t     *local      = NULL;
-        int               op_errno   = ESTALE;
-        int               ret        = 0;
-        int               count      = 0;
-        struct iobref    *rsp_iobref = NULL;
-        struct iobuf     *rsp_iobuf  = NULL;
-        struct iovec     *rsphdr     = NULL;
-        struct iovec      vector[MAX_IOVEC] = {{0}, };
-        int               readdir_rsp_size  = 0;
+        clnt_args_t       *args      = NULL;
+        int64_t            remote_fd = -1;
+        clnt_conf_t       *conf      = NULL;
+        gfs3_discard_req  req       = {{0,},};
+        int                op_errno  = ESTALE;
+        int                ret       = 0;
 
         if (!frame || !this || !data)
                 goto unwind;
@@ -5601,60 +6355,19 @@ client3_1_readdir (call_frame_t *frame, xlator_t *this,
 
         CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        readdir_rsp_size = xdr_sizeof ((xdrproc_t) xdr_gfs3_readdir_rsp, &rsp)
-                + args->size;
-
-        if ((readdir_rsp_size + GLUSTERFS_RPC_REPLY_SIZE + GLUSTERFS_RDMA_MAX_HEADER_SIZE)
-            > (GLUSTERFS_RDMA_INLINE_THRESHOLD)) {
-                local = mem_get0 (this->local_pool);
-                if (!local) {
-                        op_errno = ENOMEM;
-                        goto unwind;
-                }
-                frame->local = local;
-
-                rsp_iobref = iobref_new ();
-                if (rsp_iobref == NULL) {
-                        goto unwind;
-                }
-
-                /* TODO: what is the size we should send ? */
-                /* This iobuf will live for only receiving the response,
-                   so not harmful */
-                rsp_iobuf = iobuf_get (this->ctx->iobuf_pool);
-                if (rsp_iobuf == NULL) {
-                        goto unwind;
-                }
-
-                iobref_add (rsp_iobref, rsp_iobuf);
-                iobuf_unref (rsp_iobuf);
-
-                rsphdr = &vector[0];
-                rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
-                rsphdr->iov_len  = iobuf_pagesize (rsp_iobuf);
-                count = 1;
-                local->iobref = rsp_iobref;
-                rsp_iobuf = NULL;
-                rsp_iobref = NULL;
-        }
-
-        req.size = args->size;
+        req.fd     = remote_fd;
         req.offset = args->offset;
-        req.fd = remote_fd;
-
-        local->cmd = remote_fd;
-
+        req.size   = args->size;
         memcpy (req.gfid, args->fd->inode->gfid, 16);
+
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_READDIR,
-                                     client3_1_readdir_cbk, NULL,
-                                     rsphdr, count,
-                                     NULL, 0, rsp_iobref,
-                                     (xdrproc_t)xdr_gfs3_readdir_req);
-
+                                     GFS3_OP_DISCARD,
+                                     client3_1_discard_cbk, NULL,
+                                     NULL, 0, NULL, 0,
+                                     NULL, (xdrproc_t)xdr_gfs3_discard_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -5662,47 +6375,24 @@ client3_1_readdir (call_frame_t *frame, xlator_t *this,
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
-
         return 0;
-
 unwind:
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
-
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
-        CLIENT_STACK_UNWIND (readdir, frame, -1, op_errno, NULL, NULL);
+        CLIENT_STACK_UNWIND (discard, frame, -1, op_errno, NULL, NULL, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
         return 0;
 }
 
-
 int32_t
-client3_1_readdirp (call_frame_t *frame, xlator_t *this,
-                    void *data)
+client3_1_zerofill (call_frame_t *frame, xlator_t *this, void *data)
 {
-        clnt_args_t      *args              = NULL;
-        gfs3_readdirp_req req               = {{0,},};
-        gfs3_readdirp_rsp rsp               = {0,};
-        int64_t           remote_fd         = -1;
-        clnt_conf_t      *conf              = NULL;
-        int               op_errno          = ESTALE;
-        int               ret               = 0;
-        int               count             = 0;
-        int               readdirp_rsp_size = 0;
-        struct iobref    *rsp_iobref        = NULL;
-        struct iobuf     *rsp_iobuf         = NULL;
-        struct iovec     *rsphdr            = NULL;
-        struct iovec      vector[MAX_IOVEC] = {{0}, };
-        clnt_local_t     *local             = NULL;
+        clnt_args_t       *args      = NULL;
+        int64_t            remote_fd = -1;
+        clnt_conf_t       *conf      = NULL;
+        gfs3_zerofill_req  req       = {{0,},};
+        int                op_errno  = ESTALE;
+        int                ret       = 0;
 
         if (!frame || !this || !data)
                 goto unwind;
@@ -5712,129 +6402,66 @@ client3_1_readdirp (call_frame_t *frame, xlator_t *this,
 
         CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        readdirp_rsp_size = xdr_sizeof ((xdrproc_t) xdr_gfs3_readdirp_rsp, &rsp)
-                + args->size;
-
-        local = mem_get0 (this->local_pool);
-        if (!local) {
-                op_errno = ENOMEM;
-                goto unwind;
-        }
-        frame->local = local;
-
-        if ((readdirp_rsp_size + GLUSTERFS_RPC_REPLY_SIZE
-             + GLUSTERFS_RDMA_MAX_HEADER_SIZE)
-            > (GLUSTERFS_RDMA_INLINE_THRESHOLD)) {
-                rsp_iobref = iobref_new ();
-                if (rsp_iobref == NULL) {
-                        goto unwind;
-                }
-
-                /* TODO: what is the size we should send ? */
-                /* This iobuf will live for only receiving the response,
-                   so not harmful */
-                rsp_iobuf = iobuf_get (this->ctx->iobuf_pool);
-                if (rsp_iobuf == NULL) {
-                        goto unwind;
-                }
-
-                iobref_add (rsp_iobref, rsp_iobuf);
-                iobuf_unref (rsp_iobuf);
-
-                rsphdr = &vector[0];
-                rsphdr->iov_base = iobuf_ptr (rsp_iobuf);
-                rsphdr->iov_len  = iobuf_pagesize (rsp_iobuf);
-                count = 1;
-                local->iobref = rsp_iobref;
-                rsp_iobuf = NULL;
-                rsp_iobref = NULL;
-        }
-
-        local->fd = fd_ref (args->fd);
-
-        req.size = args->size;
+        req.fd     = remote_fd;
         req.offset = args->offset;
-        req.fd = remote_fd;
+        req.size   = args->size;
         memcpy (req.gfid, args->fd->inode->gfid, 16);
 
-        /* dict itself is 'xdata' here */
-        GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.dict.dict_val),
-                                    req.dict.dict_len, op_errno, unwind);
+        GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
+                                    req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_READDIRP,
-                                     client3_1_readdirp_cbk, NULL,
-                                     rsphdr, count, NULL,
-                                     0, rsp_iobref,
-                                     (xdrproc_t)xdr_gfs3_readdirp_req);
+                                     GFS3_OP_ZEROFILL,
+                                     client3_1_zerofill_cbk, NULL,
+                                     NULL, 0, NULL, 0,
+                                     NULL, (xdrproc_t)xdr_gfs3_zerofill_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
 
-        if (req.dict.dict_val)
-                GF_FREE (req.dict.dict_val);
-
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
 
         return 0;
 unwind:
-        if (rsp_iobref)
-                iobref_unref (rsp_iobref);
-
-        if (rsp_iobuf)
-                iobuf_unref (rsp_iobuf);
-
-        if (req.dict.dict_val)
-                GF_FREE (req.dict.dict_val);
+        CLIENT_STACK_UNWIND (zerofill, frame, -1, op_errno, NULL, NULL, NULL);
+        if (req.xdata.xdata_val)
+                GF_FREE (req.xdata.xdata_val);
 
-        CLIENT_STACK_UNWIND (readdirp, frame, -1, op_errno, NULL, NULL);
         return 0;
 }
 
-
 int32_t
-client3_1_setattr (call_frame_t *frame, xlator_t *this,
-                   void *data)
+client3_1_seek (call_frame_t *frame, xlator_t *this, void *data)
 {
-        clnt_conf_t      *conf     = NULL;
-        clnt_args_t      *args     = NULL;
-        gfs3_setattr_req  req      = {{0,},};
-        int               ret      = 0;
-        int               op_errno = ESTALE;
+        clnt_args_t       *args      = NULL;
+        int64_t            remote_fd = -1;
+        clnt_conf_t       *conf      = NULL;
+        gfs3_seek_req      req       = {{0,},};
+        int                op_errno  = ESTALE;
+        int                ret       = 0;
 
         if (!frame || !this || !data)
                 goto unwind;
 
         args = data;
+        conf = this->private;
 
-        if (!(args->loc && args->loc->inode))
-                goto unwind;
-
-        if (!uuid_is_null (args->loc->inode->gfid))
-                memcpy (req.gfid, args->loc->inode->gfid, 16);
-        else
-                memcpy (req.gfid, args->loc->gfid, 16);
-
-        GF_ASSERT_AND_GOTO_WITH_ERROR (this->name,
-                                       !uuid_is_null (*((uuid_t*)req.gfid)),
-                                       unwind, op_errno, EINVAL);
-        req.valid = args->valid;
-        gf_stat_from_iatt (&req.stbuf, args->stbuf);
+        CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
 
-        conf = this->private;
+        req.fd     = remote_fd;
+        req.offset = args->offset;
+        req.what   = args->flags;
+        memcpy (req.gfid, args->fd->inode->gfid, 16);
 
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
         ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_SETATTR,
-                                     client3_1_setattr_cbk, NULL,
+                                     GFS3_OP_SEEK,
+                                     client3_1_seek_cbk, NULL,
                                      NULL, 0, NULL, 0,
-                                     NULL, (xdrproc_t)xdr_gfs3_setattr_req);
+                                     NULL, (xdrproc_t)xdr_gfs3_seek_req);
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
@@ -5844,55 +6471,441 @@ client3_1_setattr (call_frame_t *frame, xlator_t *this,
 
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (setattr, frame, -1, op_errno, NULL, NULL, NULL);
+        CLIENT_STACK_UNWIND (seek, frame, -1, op_errno, 0, NULL);
         if (req.xdata.xdata_val)
                 GF_FREE (req.xdata.xdata_val);
 
         return 0;
 }
 
+/* lock command and type of an [f]inodelk in their wire form */
+static int
+client_compound_lk_args (compound_fop_t *cfop, u_int *gf_cmd,
+                         u_int *gf_type)
+{
+        if (cfop->cmd == F_GETLK || cfop->cmd == F_GETLK64)
+                *gf_cmd = GF_LK_GETLK;
+        else if (cfop->cmd == F_SETLK || cfop->cmd == F_SETLK64)
+                *gf_cmd = GF_LK_SETLK;
+        else if (cfop->cmd == F_SETLKW || cfop->cmd == F_SETLKW64)
+                *gf_cmd = GF_LK_SETLKW;
+        else
+                return -1;
+
+        switch (cfop->flock.l_type) {
+        case F_RDLCK:
+                *gf_type = GF_LK_F_RDLCK;
+                break;
+        case F_WRLCK:
+                *gf_type = GF_LK_F_WRLCK;
+                break;
+        case F_UNLCK:
+                *gf_type = GF_LK_F_UNLCK;
+                break;
+        }
+
+        return 0;
+}
+
+
+static int
+client_compound_loc_gfid (compound_fop_t *cfop, char *gfid)
+{
+        if (!cfop->loc.inode)
+                return -1;
+
+        if (!uuid_is_null (cfop->loc.inode->gfid))
+                memcpy (gfid, cfop->loc.inode->gfid, 16);
+        else
+                memcpy (gfid, cfop->loc.gfid, 16);
+
+        return uuid_is_null (*((uuid_t *)gfid)) ? -1 : 0;
+}
+
+
+/* where the serialized dicts of a request entry go, dict is NULL for the
+   fops without one */
+static void
+client_compound_req_bufs (gfs3_compound_req_u *req, char ***dict_val,
+                          u_int **dict_len, char ***xdata_val,
+                          u_int **xdata_len)
+{
+        gfs3_inodelk_req   *inodelk   = NULL;
+        gfs3_finodelk_req  *finodelk  = NULL;
+        gfs3_entrylk_req   *entrylk   = NULL;
+        gfs3_fentrylk_req  *fentrylk  = NULL;
+        gfs3_xattrop_req   *xattrop   = NULL;
+        gfs3_fxattrop_req  *fxattrop  = NULL;
+        gfs3_setxattr_req  *setxattr  = NULL;
+        gfs3_fsetxattr_req *fsetxattr = NULL;
+        gfs3_write_req     *wreq      = NULL;
+
+        *dict_val = NULL;
+        *dict_len = NULL;
+        *xdata_val = NULL;
+        *xdata_len = NULL;
+
+        switch (req->fop) {
+        case GFS3_COMPOUND_INODELK:
+                inodelk = &req->gfs3_compound_req_u_u.inodelk_req;
+                *xdata_val = &inodelk->xdata.xdata_val;
+                *xdata_len = &inodelk->xdata.xdata_len;
+                break;
+        case GFS3_COMPOUND_FINODELK:
+                finodelk = &req->gfs3_compound_req_u_u.finodelk_req;
+                *xdata_val = &finodelk->xdata.xdata_val;
+                *xdata_len = &finodelk->xdata.xdata_len;
+                break;
+        case GFS3_COMPOUND_ENTRYLK:
+                entrylk = &req->gfs3_compound_req_u_u.entrylk_req;
+                *xdata_val = &entrylk->xdata.xdata_val;
+                *xdata_len = &entrylk->xdata.xdata_len;
+                break;
+        case GFS3_COMPOUND_FENTRYLK:
+                fentrylk = &req->gfs3_compound_req_u_u.fentrylk_req;
+                *xdata_val = &fentrylk->xdata.xdata_val;
+                *xdata_len = &fentrylk->xdata.xdata_len;
+                break;
+        case GFS3_COMPOUND_XATTROP:
+                xattrop = &req->gfs3_compound_req_u_u.xattrop_req;
+                *dict_val = &xattrop->dict.dict_val;
+                *dict_len = &xattrop->dict.dict_len;
+                *xdata_val = &xattrop->xdata.xdata_val;
+                *xdata_len = &xattrop->xdata.xdata_len;
+                break;
+        case GFS3_COMPOUND_FXATTROP:
+                fxattrop = &req->gfs3_compound_req_u_u.fxattrop_req;
+                *dict_val = &fxattrop->dict.dict_val;
+                *dict_len = &fxattrop->dict.dict_len;
+                *xdata_val = &fxattrop->xdata.xdata_val;
+                *xdata_len = &fxattrop->xdata.xdata_len;
+                break;
+        case GFS3_COMPOUND_SETXATTR:
+                setxattr = &req->gfs3_compound_req_u_u.setxattr_req;
+                *dict_val = &setxattr->dict.dict_val;
+                *dict_len = &setxattr->dict.dict_len;
+                *xdata_val = &setxattr->xdata.xdata_val;
+                *xdata_len = &setxattr->xdata.xdata_len;
+                break;
+        case GFS3_COMPOUND_FSETXATTR:
+                fsetxattr = &req->gfs3_compound_req_u_u.fsetxattr_req;
+                *dict_val = &fsetxattr->dict.dict_val;
+                *dict_len = &fsetxattr->dict.dict_len;
+                *xdata_val = &fsetxattr->xdata.xdata_val;
+                *xdata_len = &fsetxattr->xdata.xdata_len;
+                break;
+        case GFS3_COMPOUND_WRITE:
+                wreq = &req->gfs3_compound_req_u_u.write_req;
+                *xdata_val = &wreq->xdata.xdata_val;
+                *xdata_len = &wreq->xdata.xdata_len;
+                break;
+        }
+}
+
+
+/* fills @req the way the fop on its own would, returns an errno */
+static int
+client_compound_fill_req (xlator_t *this, compound_fop_t *cfop,
+                          gfs3_compound_req_u *req)
+{
+        clnt_conf_t        *conf      = NULL;
+        gfs3_inodelk_req   *inodelk   = NULL;
+        gfs3_finodelk_req  *finodelk  = NULL;
+        gfs3_entrylk_req   *entrylk   = NULL;
+        gfs3_fentrylk_req  *fentrylk  = NULL;
+        gfs3_xattrop_req   *xattrop   = NULL;
+        gfs3_fxattrop_req  *fxattrop  = NULL;
+        gfs3_setxattr_req  *setxattr  = NULL;
+        gfs3_fsetxattr_req *fsetxattr = NULL;
+        gfs3_write_req     *wreq      = NULL;
+        char              **dict_val  = NULL;
+        u_int              *dict_len  = NULL;
+        char              **xdata_val = NULL;
+        u_int              *xdata_len = NULL;
+        int64_t             remote_fd = -1;
+        int                 op_errno  = EINVAL;
+
+        conf = this->private;
+
+        if (cfop->fd)
+                CLIENT_GET_REMOTE_FD (conf, cfop->fd, remote_fd, op_errno,
+                                      out);
+
+        switch (cfop->fop) {
+        case GF_FOP_INODELK:
+                req->fop = GFS3_COMPOUND_INODELK;
+                inodelk = &req->gfs3_compound_req_u_u.inodelk_req;
+                if (client_compound_loc_gfid (cfop, inodelk->gfid) ||
+                    client_compound_lk_args (cfop, &inodelk->cmd,
+                                             &inodelk->type))
+                        goto out;
+                inodelk->volume = cfop->volume;
+                gf_proto_flock_from_flock (&inodelk->flock, &cfop->flock);
+                break;
+
+        case GF_FOP_FINODELK:
+                req->fop = GFS3_COMPOUND_FINODELK;
+                finodelk = &req->gfs3_compound_req_u_u.finodelk_req;
+                if (client_compound_lk_args (cfop, &finodelk->cmd,
+                                             &finodelk->type))
+                        goto out;
+                finodelk->volume = cfop->volume;
+                finodelk->fd = remote_fd;
+                memcpy (finodelk->gfid, cfop->fd->inode->gfid, 16);
+                gf_proto_flock_from_flock (&finodelk->flock, &cfop->flock);
+                break;
+
+        case GF_FOP_ENTRYLK:
+                req->fop = GFS3_COMPOUND_ENTRYLK;
+                entrylk = &req->gfs3_compound_req_u_u.entrylk_req;
+                if (client_compound_loc_gfid (cfop, entrylk->gfid))
+                        goto out;
+                entrylk->cmd = cfop->entrylk_cmd;
+                entrylk->type = cfop->entrylk_type;
+                entrylk->volume = cfop->volume;
+                entrylk->name = "";
+                if (cfop->name) {
+                        entrylk->name = cfop->name;
+                        entrylk->namelen = 1;
+                }
+                break;
+
+        case GF_FOP_FENTRYLK:
+                req->fop = GFS3_COMPOUND_FENTRYLK;
+                fentrylk = &req->gfs3_compound_req_u_u.fentrylk_req;
+                fentrylk->fd = remote_fd;
+                memcpy (fentrylk->gfid, cfop->fd->inode->gfid, 16);
+                fentrylk->cmd = cfop->entrylk_cmd;
+                fentrylk->type = cfop->entrylk_type;
+                fentrylk->volume = cfop->volume;
+                fentrylk->name = "";
+                if (cfop->name) {
+                        fentrylk->name = cfop->name;
+                        fentrylk->namelen = 1;
+                }
+                break;
+
+        case GF_FOP_XATTROP:
+                req->fop = GFS3_COMPOUND_XATTROP;
+                xattrop = &req->gfs3_compound_req_u_u.xattrop_req;
+                if (client_compound_loc_gfid (cfop, xattrop->gfid))
+                        goto out;
+                xattrop->flags = cfop->optype;
+                break;
+
+        case GF_FOP_FXATTROP:
+                req->fop = GFS3_COMPOUND_FXATTROP;
+                fxattrop = &req->gfs3_compound_req_u_u.fxattrop_req;
+                fxattrop->fd = remote_fd;
+                memcpy (fxattrop->gfid, cfop->fd->inode->gfid, 16);
+                fxattrop->flags = cfop->optype;
+                break;
+
+        case GF_FOP_SETXATTR:
+                req->fop = GFS3_COMPOUND_SETXATTR;
+                setxattr = &req->gfs3_compound_req_u_u.setxattr_req;
+                if (client_compound_loc_gfid (cfop, setxattr->gfid))
+                        goto out;
+                setxattr->flags = cfop->flags;
+                break;
+
+        case GF_FOP_FSETXATTR:
+                req->fop = GFS3_COMPOUND_FSETXATTR;
+                fsetxattr = &req->gfs3_compound_req_u_u.fsetxattr_req;
+                fsetxattr->fd = remote_fd;
+                memcpy (fsetxattr->gfid, cfop->fd->inode->gfid, 16);
+                fsetxattr->flags = cfop->flags;
+                break;
+
+        case GF_FOP_WRITE:
+                req->fop = GFS3_COMPOUND_WRITE;
+                wreq = &req->gfs3_compound_req_u_u.write_req;
+                wreq->fd = remote_fd;
+                memcpy (wreq->gfid, cfop->fd->inode->gfid, 16);
+                wreq->offset = cfop->offset;
+                wreq->size = iov_length (cfop->vector, cfop->count);
+                wreq->flag = cfop->flags;
+                break;
+
+        default:
+                gf_log (this->name, GF_LOG_WARNING,
+                        "%s cannot be part of a compound",
+                        gf_fop_list[cfop->fop]);
+                goto out;
+        }
+
+        client_compound_req_bufs (req, &dict_val, &dict_len, &xdata_val,
+                                  &xdata_len);
+
+        if (dict_val) {
+                GF_PROTOCOL_DICT_SERIALIZE (this, cfop->dict, dict_val,
+                                            *dict_len, op_errno, out);
+        }
+
+        GF_PROTOCOL_DICT_SERIALIZE (this, cfop->xdata, xdata_val, *xdata_len,
+                                    op_errno, out);
+
+        op_errno = 0;
+out:
+        return op_errno;
+}
+
+
+static void
+client_compound_req_cleanup (gfs3_compound_req *req)
+{
+        char **dict_val  = NULL;
+        u_int *dict_len  = NULL;
+        char **xdata_val = NULL;
+        u_int *xdata_len = NULL;
+        int    i         = 0;
+
+        for (i = 0; i < req->fops.fops_len; i++) {
+                client_compound_req_bufs (&req->fops.fops_val[i], &dict_val,
+                                          &dict_len, &xdata_val, &xdata_len);
+
+                if (dict_val && *dict_val)
+                        GF_FREE (*dict_val);
+                if (xdata_val && *xdata_val)
+                        GF_FREE (*xdata_val);
+        }
+
+        GF_FREE (req->fops.fops_val);
+
+        if (req->xdata.xdata_val)
+                GF_FREE (req->xdata.xdata_val);
+}
+
+
 int32_t
-client3_1_fsetattr (call_frame_t *frame, xlator_t *this, void *data)
+client3_1_compound (call_frame_t *frame, xlator_t *this, void *data)
 {
         clnt_args_t       *args     = NULL;
-        int64_t            remote_fd = -1;
         clnt_conf_t       *conf     = NULL;
-        gfs3_fsetattr_req  req      = {0,};
+        clnt_local_t      *local    = NULL;
+        compound_args_t   *compound = NULL;
+        compound_fop_t    *cfop     = NULL;
+        gfs3_compound_req  req      = {0,};
+        struct iovec      *payload  = NULL;
+        int                paycnt   = 0;
+        struct iobref     *iobref   = NULL;
         int                op_errno = ESTALE;
-        int                ret        = 0;
+        int                ret      = 0;
+        int                i        = 0;
 
         if (!frame || !this || !data)
                 goto unwind;
 
         args = data;
         conf = this->private;
+        compound = args->compound;
 
-        CLIENT_GET_REMOTE_FD(conf, args->fd, remote_fd, op_errno, unwind);
+        if (!compound || (compound->count <= 0) ||
+            (compound->count > GF_COMPOUND_MAX_FOPS)) {
+                op_errno = EINVAL;
+                goto unwind;
+        }
 
-        req.fd = remote_fd;
-        req.valid = args->valid;
-        gf_stat_from_iatt (&req.stbuf, args->stbuf);
+        /* not negotiated at SETVOLUME: nothing goes out and the caller
+           sends the fops one by one */
+        if (compound->count > conf->compound_fops) {
+                op_errno = ENOTSUP;
+                goto unwind;
+        }
+
+        local = mem_get0 (this->local_pool);
+        if (!local) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+        local->count = compound->count;
+        frame->local = local;
+
+        req.fops.fops_val = GF_CALLOC (compound->count,
+                                       sizeof (*req.fops.fops_val),
+                                       gf_client_mt_compound_req_t);
+        if (!req.fops.fops_val) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        for (i = 0; i < compound->count; i++) {
+                /* counted first, so that a partly filled entry is freed */
+                req.fops.fops_len++;
+                op_errno = client_compound_fill_req (this,
+                                                     &compound->fops[i],
+                                                     &req.fops.fops_val[i]);
+                if (op_errno)
+                        goto unwind;
+        }
+
+        req.flags = compound->flags;
 
         GF_PROTOCOL_DICT_SERIALIZE (this, args->xdata, (&req.xdata.xdata_val),
                                     req.xdata.xdata_len, op_errno, unwind);
 
-        ret = client_submit_request (this, &req, frame, conf->fops,
-                                     GFS3_OP_FSETATTR,
-                                     client3_1_fsetattr_cbk, NULL,
-                                     NULL, 0, NULL, 0,
-                                     NULL, (xdrproc_t)xdr_gfs3_fsetattr_req);
+        /* the data of the write members goes out after the record, in
+           their order, the way a plain write carries its own */
+        for (i = 0; i < compound->count; i++) {
+                if (compound->fops[i].fop == GF_FOP_WRITE)
+                        paycnt += compound->fops[i].count;
+        }
+
+        if (!paycnt) {
+                ret = client_submit_request (this, &req, frame, conf->fops,
+                                             GFS3_OP_COMPOUND,
+                                             client3_1_compound_cbk, NULL,
+                                             NULL, 0, NULL, 0, NULL,
+                                             (xdrproc_t)xdr_gfs3_compound_req);
+                goto sent;
+        }
+
+        payload = GF_CALLOC (paycnt, sizeof (*payload),
+                             gf_client_mt_compound_req_t);
+        iobref = iobref_new ();
+        if (!payload || !iobref) {
+                op_errno = ENOMEM;
+                goto unwind;
+        }
+
+        paycnt = 0;
+        for (i = 0; i < compound->count; i++) {
+                cfop = &compound->fops[i];
+                if (cfop->fop != GF_FOP_WRITE)
+                        continue;
+
+                memcpy (&payload[paycnt], cfop->vector,
+                        cfop->count * sizeof (*payload));
+                paycnt += cfop->count;
+
+                if (cfop->iobref && iobref_merge (iobref, cfop->iobref)) {
+                        op_errno = ENOMEM;
+                        goto unwind;
+                }
+        }
+
+        ret = client_submit_vec_request (this, &req, frame, conf->fops,
+                                         GFS3_OP_COMPOUND,
+                                         client3_1_compound_cbk, payload,
+                                         paycnt, iobref,
+                                         (xdrproc_t)xdr_gfs3_compound_req);
+sent:
         if (ret) {
                 gf_log (this->name, GF_LOG_WARNING, "failed to send the fop");
         }
 
-        if (req.xdata.xdata_val)
-                GF_FREE (req.xdata.xdata_val);
+        client_compound_req_cleanup (&req);
+        GF_FREE (payload);
+        if (iobref)
+                iobref_unref (iobref);
 
         return 0;
 unwind:
-        CLIENT_STACK_UNWIND (fsetattr, frame, -1, op_errno, NULL, NULL, NULL);
-        if (req.xdata.xdata_val)
-                GF_FREE (req.xdata.xdata_val);
+        CLIENT_STACK_UNWIND (compound, frame, -1, op_errno, NULL, NULL);
+        client_compound_req_cleanup (&req);
+        GF_FREE (payload);
+        if (iobref)
+                iobref_unref (iobref);
 
         return 0;
 }
@@ -5948,6 +6961,11 @@ rpc_clnt_procedure_t clnt3_1_fop_actors[GF_FOP_MAXVALUE] = {
         [GF_FOP_RELEASEDIR]  = { "RELEASEDIR",  client3_1_releasedir },
         [GF_FOP_GETSPEC]     = { "GETSPEC",     client3_getspec },
         [GF_FOP_FREMOVEXATTR] = { "FREMOVEXATTR", client3_1_fremovexattr },
+        [GF_FOP_FALLOCATE]   = { "FALLOCATE",   client3_1_fallocate },
+        [GF_FOP_DISCARD]     = { "DISCARD",     client3_1_discard },
+        [GF_FOP_ZEROFILL]    = { "ZEROFILL",    client3_1_zerofill },
+        [GF_FOP_SEEK]        = { "SEEK",        client3_1_seek },
+        [GF_FOP_COMPOUND]    = { "COMPOUND",    client3_1_compound },
 };
 
 /* Used From RPC-CLNT library to log proper name of procedure based on number */
@@ -5996,6 +7014,11 @@ char *clnt3_1_fop_names[GFS3_OP_MAXVALUE] = {
         [GFS3_OP_RELEASE]     = "RELEASE",
         [GFS3_OP_RELEASEDIR]  = "RELEASEDIR",
         [GFS3_OP_FREMOVEXATTR] = "FREMOVEXATTR",
+        [GFS3_OP_FALLOCATE]   = "FALLOCATE",
+        [GFS3_OP_DISCARD]     = "DISCARD",
+        [GFS3_OP_ZEROFILL]    = "ZEROFILL",
+        [GFS3_OP_SEEK]        = "SEEK",
+        [GFS3_OP_COMPOUND]    = "COMPOUND",
 };
 
 rpc_clnt_prog_t clnt3_1_fop_prog = {
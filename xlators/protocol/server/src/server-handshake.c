@@ -639,6 +639,13 @@ server_setvolume (rpcsvc_request_t *req)
                 gf_log (this->name, GF_LOG_DEBUG,
                         "failed to set 'transport-ptr'");
 
+        /* an older server leaves it out, the client then never sends
+           GFS3_OP_COMPOUND */
+        ret = dict_set_uint32 (reply, "compound-fops", GF_COMPOUND_MAX_FOPS);
+        if (ret)
+                gf_log (this->name, GF_LOG_DEBUG,
+                        "failed to set 'compound-fops'");
+
 fail:
         rsp.dict.dict_len = dict_serialized_length (reply);
         if (rsp.dict.dict_len < 0) {
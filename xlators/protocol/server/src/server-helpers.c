@@ -79,18 +79,10 @@ server_resolve_wipe (server_resolve_t *resolve)
 }
 
 
+/* drops what a fop left in @state, which can then take another one */
 void
-free_state (server_state_t *state)
+server_state_wipe (server_state_t *state)
 {
-        if (state->conn) {
-                //xprt_svc_unref (state->conn);
-                state->conn = NULL;
-        }
-
-        if (state->xprt) {
-                rpc_transport_unref (state->xprt);
-                state->xprt = NULL;
-        }
         if (state->fd) {
                 fd_unref (state->fd);
                 state->fd = NULL;
@@ -121,17 +113,47 @@ free_state (server_state_t *state)
                 state->xdata = NULL;
         }
 
-        if (state->volume)
+        if (state->volume) {
                 GF_FREE ((void *)state->volume);
+                state->volume = NULL;
+        }
 
-        if (state->name)
+        if (state->name) {
                 GF_FREE ((void *)state->name);
+                state->name = NULL;
+        }
 
         server_loc_wipe (&state->loc);
         server_loc_wipe (&state->loc2);
+        memset (&state->loc, 0, sizeof (state->loc));
+        memset (&state->loc2, 0, sizeof (state->loc2));
 
         server_resolve_wipe (&state->resolve);
         server_resolve_wipe (&state->resolve2);
+        memset (&state->resolve, 0, sizeof (state->resolve));
+        memset (&state->resolve2, 0, sizeof (state->resolve2));
+        state->resolve.fd_no = -1;
+        state->resolve2.fd_no = -1;
+
+        state->loc_now = NULL;
+        state->resolve_now = NULL;
+}
+
+
+void
+free_state (server_state_t *state)
+{
+        if (state->conn) {
+                //xprt_svc_unref (state->conn);
+                state->conn = NULL;
+        }
+
+        if (state->xprt) {
+                rpc_transport_unref (state->xprt);
+                state->xprt = NULL;
+        }
+
+        server_state_wipe (state);
 
         GF_FREE (state);
 }
@@ -809,6 +831,7 @@ get_frame_from_request (rpcsvc_request_t *req)
         frame->root->gid      = req->gid;
         frame->root->pid      = req->pid;
         frame->root->trans    = server_conn_ref (req->trans->xl_private);
+        frame->root->client_id = ((server_connection_t *)frame->root->trans)->id;
         frame->root->lk_owner = req->lk_owner;
 
         server_decode_groups (frame, req);
@@ -45,6 +45,8 @@
 
 void free_state (server_state_t *state);
 
+void server_state_wipe (server_state_t *state);
+
 void server_loc_wipe (loc_t *loc);
 
 int32_t
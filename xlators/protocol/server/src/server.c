@@ -35,6 +35,7 @@
 #include "defaults.h"
 #include "authenticate.h"
 #include "rpcsvc.h"
+#include "event.h"
 
 void
 grace_time_handler (void *data)
@@ -846,6 +847,10 @@ reconfigure (xlator_t *this, dict_t *options)
                         " to %d", conf->inode_lru_limit);
         }
 
+        xlator_option_apply_event_threads (this, options);
+
+        xlator_option_apply_iobuf (this, options);
+
         data = dict_get (options, "trace");
         if (data) {
                 ret = gf_string2boolean (data->data, &trace);
@@ -981,6 +986,10 @@ init (xlator_t *this)
                 goto out;
         }
 
+        xlator_option_apply_event_threads (this, this->options);
+
+        xlator_option_apply_iobuf (this, this->options);
+
         /* Authentication modules */
         conf->auth_modules = dict_new ();
         GF_VALIDATE_OR_GOTO(this->name, conf->auth_modules, out);
@@ -1208,6 +1217,8 @@ struct volume_options options[] = {
          .min  = GF_MIN_SOCKET_WINDOW_SIZE,
          .max  = GF_MAX_SOCKET_WINDOW_SIZE
         },
+        GF_OPTION_EVENT_THREADS ("brick"),
+        GF_OPTION_IOBUF,
 
         /*  The following two options are defined in addr.c, redifined here *
          * for the sake of validation during volume set from cli            */
@@ -1838,6 +1838,166 @@ out:
         return 0;
 }
 
+int
+server_fallocate_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                      int32_t op_ret, int32_t op_errno,
+                      struct iatt *statpre, struct iatt *statpost, dict_t *xdata)
+{
+        gfs3_fallocate_rsp  rsp   = {0,};
+        server_state_t    *state = NULL;
+        rpcsvc_request_t  *req   = NULL;
+
+        req = frame->local;
+        state  = CALL_STATE (frame);
+
+        if (op_ret) {
+                gf_log (this->name, GF_LOG_INFO,
+                        "%"PRId64": FALLOCATE %"PRId64" (%s) ==> (%s)",
+                        frame->root->unique, state->resolve.fd_no,
+                        uuid_utoa (state->resolve.gfid),
+                        strerror (op_errno));
+                goto out;
+        }
+
+        gf_stat_from_iatt (&rsp.statpre, statpre);
+        gf_stat_from_iatt (&rsp.statpost, statpost);
+
+        GF_PROTOCOL_DICT_SERIALIZE (this, xdata, (&rsp.xdata.xdata_val),
+                                    rsp.xdata.xdata_len, op_errno, out);
+
+out:
+        rsp.op_ret    = op_ret;
+        rsp.op_errno  = gf_errno_to_error (op_errno);
+
+        server_submit_reply (frame, req, &rsp, NULL, 0, NULL,
+                             (xdrproc_t)xdr_gfs3_fallocate_rsp);
+
+        if (rsp.xdata.xdata_val)
+                GF_FREE (rsp.xdata.xdata_val);
+
+        return 0;
+}
+
+int
+server_discard_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                    int32_t op_ret, int32_t op_errno,
+                    struct iatt *statpre, struct iatt *statpost, dict_t *xdata)
+{
+        gfs3_discard_rsp  rsp   = {0,};
+        server_state_t    *state = NULL;
+        rpcsvc_request_t  *req   = NULL;
+
+        req = frame->local;
+        state  = CALL_STATE (frame);
+
+        if (op_ret) {
+                gf_log (this->name, GF_LOG_INFO,
+                        "%"PRId64": DISCARD %"PRId64" (%s) ==> (%s)",
+                        frame->root->unique, state->resolve.fd_no,
+                        uuid_utoa (state->resolve.gfid),
+                        strerror (op_errno));
+                goto out;
+        }
+
+        gf_stat_from_iatt (&rsp.statpre, statpre);
+        gf_stat_from_iatt (&rsp.statpost, statpost);
+
+        GF_PROTOCOL_DICT_SERIALIZE (this, xdata, (&rsp.xdata.xdata_val),
+                                    rsp.xdata.xdata_len, op_errno, out);
+
+out:
+        rsp.op_ret    = op_ret;
+        rsp.op_errno  = gf_errno_to_error (op_errno);
+
+        server_submit_reply (frame, req, &rsp, NULL, 0, NULL,
+                             (xdrproc_t)xdr_gfs3_discard_rsp);
+
+        if (rsp.xdata.xdata_val)
+                GF_FREE (rsp.xdata.xdata_val);
+
+        return 0;
+}
+
+int
+server_zerofill_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                     int32_t op_ret, int32_t op_errno,
+                     struct iatt *statpre, struct iatt *statpost, dict_t *xdata)
+{
+        gfs3_zerofill_rsp  rsp   = {0,};
+        server_state_t    *state = NULL;
+        rpcsvc_request_t  *req   = NULL;
+
+        req = frame->local;
+        state  = CALL_STATE (frame);
+
+        if (op_ret) {
+                gf_log (this->name, GF_LOG_INFO,
+                        "%"PRId64": ZEROFILL %"PRId64" (%s) ==> (%s)",
+                        frame->root->unique, state->resolve.fd_no,
+                        uuid_utoa (state->resolve.gfid),
+                        strerror (op_errno));
+                goto out;
+        }
+
+        gf_stat_from_iatt (&rsp.statpre, statpre);
+        gf_stat_from_iatt (&rsp.statpost, statpost);
+
+        GF_PROTOCOL_DICT_SERIALIZE (this, xdata, (&rsp.xdata.xdata_val),
+                                    rsp.xdata.xdata_len, op_errno, out);
+
+out:
+        rsp.op_ret    = op_ret;
+        rsp.op_errno  = gf_errno_to_error (op_errno);
+
+        server_submit_reply (frame, req, &rsp, NULL, 0, NULL,
+                             (xdrproc_t)xdr_gfs3_zerofill_rsp);
+
+        if (rsp.xdata.xdata_val)
+                GF_FREE (rsp.xdata.xdata_val);
+
+        return 0;
+}
+
+int
+server_seek_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                 int32_t op_ret, int32_t op_errno, off_t offset,
+                 dict_t *xdata)
+{
+        gfs3_seek_rsp      rsp   = {0,};
+        server_state_t    *state = NULL;
+        rpcsvc_request_t  *req   = NULL;
+
+        req = frame->local;
+        state  = CALL_STATE (frame);
+
+        if (op_ret) {
+                gf_log (this->name,
+                        ((op_errno == ENXIO) ? GF_LOG_TRACE : GF_LOG_INFO),
+                        "%"PRId64": SEEK %"PRId64" (%s) ==> (%s)",
+                        frame->root->unique, state->resolve.fd_no,
+                        uuid_utoa (state->resolve.gfid),
+                        strerror (op_errno));
+                goto out;
+        }
+
+        rsp.offset = offset;
+
+        GF_PROTOCOL_DICT_SERIALIZE (this, xdata, (&rsp.xdata.xdata_val),
+                                    rsp.xdata.xdata_len, op_errno, out);
+
+out:
+        rsp.op_ret    = op_ret;
+        rsp.op_errno  = gf_errno_to_error (op_errno);
+
+        server_submit_reply (frame, req, &rsp, NULL, 0, NULL,
+                             (xdrproc_t)xdr_gfs3_seek_rsp);
+
+        if (rsp.xdata.xdata_val)
+                GF_FREE (rsp.xdata.xdata_val);
+
+        return 0;
+}
+
 
 int
 server_xattrop_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
@@ -2857,6 +3017,98 @@ err:
 }
 
 
+int
+server_fallocate_resume (call_frame_t *frame, xlator_t *bound_xl)
+{
+        server_state_t *state = NULL;
+
+        state = CALL_STATE (frame);
+
+        if (state->resolve.op_ret != 0)
+                goto err;
+
+        STACK_WIND (frame, server_fallocate_cbk,
+                    bound_xl, bound_xl->fops->fallocate,
+                    state->fd,
+                    state->flags,
+                    state->offset, state->size, state->xdata);
+        return 0;
+err:
+        server_fallocate_cbk (frame, NULL, frame->this, state->resolve.op_ret,
+                              state->resolve.op_errno, NULL, NULL, NULL);
+
+        return 0;
+}
+
+
+int
+server_discard_resume (call_frame_t *frame, xlator_t *bound_xl)
+{
+        server_state_t *state = NULL;
+
+        state = CALL_STATE (frame);
+
+        if (state->resolve.op_ret != 0)
+                goto err;
+
+        STACK_WIND (frame, server_discard_cbk,
+                    bound_xl, bound_xl->fops->discard,
+                    state->fd,
+                    state->offset, state->size, state->xdata);
+        return 0;
+err:
+        server_discard_cbk (frame, NULL, frame->this, state->resolve.op_ret,
+                            state->resolve.op_errno, NULL, NULL, NULL);
+
+        return 0;
+}
+
+
+int
+server_zerofill_resume (call_frame_t *frame, xlator_t *bound_xl)
+{
+        server_state_t *state = NULL;
+
+        state = CALL_STATE (frame);
+
+        if (state->resolve.op_ret != 0)
+                goto err;
+
+        STACK_WIND (frame, server_zerofill_cbk,
+                    bound_xl, bound_xl->fops->zerofill,
+                    state->fd,
+                    state->offset, state->size, state->xdata);
+        return 0;
+err:
+        server_zerofill_cbk (frame, NULL, frame->this, state->resolve.op_ret,
+                             state->resolve.op_errno, NULL, NULL, NULL);
+
+        return 0;
+}
+
+
+int
+server_seek_resume (call_frame_t *frame, xlator_t *bound_xl)
+{
+        server_state_t *state = NULL;
+
+        state = CALL_STATE (frame);
+
+        if (state->resolve.op_ret != 0)
+                goto err;
+
+        STACK_WIND (frame, server_seek_cbk,
+                    bound_xl, bound_xl->fops->seek,
+                    state->fd, state->offset, state->flags, state->xdata);
+        return 0;
+err:
+        server_seek_cbk (frame, NULL, frame->this, state->resolve.op_ret,
+                         state->resolve.op_errno, 0, NULL);
+
+        return 0;
+}
+
+
 int
 server_setattr_resume (call_frame_t *frame, xlator_t *bound_xl)
 {
@@ -3105,18 +3357,18 @@ out:
 
 
 int
-server_readlink (rpcsvc_request_t *req)
+server_fallocate (rpcsvc_request_t *req)
 {
-        server_state_t    *state                 = NULL;
-        call_frame_t      *frame                 = NULL;
-        gfs3_readlink_req  args                  = {{0,},};
-        int                ret                   = -1;
+        server_state_t    *state = NULL;
+        call_frame_t      *frame = NULL;
+        gfs3_fallocate_req  args  = {{0,},};
+        int                ret   = -1;
         int                op_errno = 0;
 
         if (!req)
                 return ret;
 
-        if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_readlink_req)) {
+        if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_fallocate_req)) {
                 //failed to decode msg;
                 req->rpc_err = GARBAGE_ARGS;
                 goto out;
@@ -3128,7 +3380,7 @@ server_readlink (rpcsvc_request_t *req)
                 req->rpc_err = GARBAGE_ARGS; /* TODO */
                 goto out;
         }
-        frame->root->op = GF_FOP_READLINK;
+        frame->root->op = GF_FOP_FALLOCATE;
 
         state = CALL_STATE (frame);
         if (!state->conn->bound_xl) {
@@ -3137,18 +3389,20 @@ server_readlink (rpcsvc_request_t *req)
                 goto out;
         }
 
-        state->resolve.type = RESOLVE_MUST;
+        state->resolve.type   = RESOLVE_MUST;
+        state->resolve.fd_no  = args.fd;
+        state->flags          = args.flags;
+        state->offset         = args.offset;
+        state->size           = args.size;
         memcpy (state->resolve.gfid, args.gfid, 16);
 
-        state->size  = args.size;
-
         GF_PROTOCOL_DICT_UNSERIALIZE (state->conn->bound_xl, state->xdata,
                                       (args.xdata.xdata_val),
                                       (args.xdata.xdata_len), ret,
                                       op_errno, out);
 
         ret = 0;
-        resolve_and_resume (frame, server_readlink_resume);
+        resolve_and_resume (frame, server_fallocate_resume);
 
 out:
         if (args.xdata.xdata_val)
@@ -3162,20 +3416,18 @@ out:
 
 
 int
-server_create (rpcsvc_request_t *req)
+server_discard (rpcsvc_request_t *req)
 {
-        server_state_t  *state    = NULL;
-        call_frame_t    *frame    = NULL;
-        gfs3_create_req  args     = {{0,},};
-        int              ret      = -1;
-        int              op_errno = 0;
+        server_state_t    *state = NULL;
+        call_frame_t      *frame = NULL;
+        gfs3_discard_req  args  = {{0,},};
+        int                ret   = -1;
+        int                op_errno = 0;
 
         if (!req)
                 return ret;
 
-        args.bname = alloca (req->msg[0].iov_len);
-
-        if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_create_req)) {
+        if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_discard_req)) {
                 //failed to decode msg;
                 req->rpc_err = GARBAGE_ARGS;
                 goto out;
@@ -3187,7 +3439,7 @@ server_create (rpcsvc_request_t *req)
                 req->rpc_err = GARBAGE_ARGS; /* TODO */
                 goto out;
         }
-        frame->root->op = GF_FOP_CREATE;
+        frame->root->op = GF_FOP_DISCARD;
 
         state = CALL_STATE (frame);
         if (!state->conn->bound_xl) {
@@ -3196,14 +3448,247 @@ server_create (rpcsvc_request_t *req)
                 goto out;
         }
 
+        state->resolve.type   = RESOLVE_MUST;
+        state->resolve.fd_no  = args.fd;
+        state->offset         = args.offset;
+        state->size           = args.size;
+        memcpy (state->resolve.gfid, args.gfid, 16);
 
-        state->resolve.bname  = gf_strdup (args.bname);
-        state->mode           = args.mode;
-        state->umask          = args.umask;
-        state->flags          = gf_flags_to_flags (args.flags);
-        memcpy (state->resolve.pargfid, args.pargfid, 16);
+        GF_PROTOCOL_DICT_UNSERIALIZE (state->conn->bound_xl, state->xdata,
+                                      (args.xdata.xdata_val),
+                                      (args.xdata.xdata_len), ret,
+                                      op_errno, out);
 
-        if (state->flags & O_EXCL) {
+        ret = 0;
+        resolve_and_resume (frame, server_discard_resume);
+
+out:
+        if (args.xdata.xdata_val)
+                free (args.xdata.xdata_val);
+
+        if (op_errno)
+                req->rpc_err = GARBAGE_ARGS;
+
+        return ret;
+}
+
+
+int
+server_zerofill (rpcsvc_request_t *req)
+{
+        server_state_t    *state = NULL;
+        call_frame_t      *frame = NULL;
+        gfs3_zerofill_req  args  = {{0,},};
+        int                ret   = -1;
+        int                op_errno = 0;
+
+        if (!req)
+                return ret;
+
+        if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_zerofill_req)) {
+                //failed to decode msg;
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+        frame = get_frame_from_request (req);
+        if (!frame) {
+                // something wrong, mostly insufficient memory
+                req->rpc_err = GARBAGE_ARGS; /* TODO */
+                goto out;
+        }
+        frame->root->op = GF_FOP_ZEROFILL;
+
+        state = CALL_STATE (frame);
+        if (!state->conn->bound_xl) {
+                /* auth failure, request on subvolume without setvolume */
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+        state->resolve.type   = RESOLVE_MUST;
+        state->resolve.fd_no  = args.fd;
+        state->offset         = args.offset;
+        state->size           = args.size;
+        memcpy (state->resolve.gfid, args.gfid, 16);
+
+        GF_PROTOCOL_DICT_UNSERIALIZE (state->conn->bound_xl, state->xdata,
+                                      (args.xdata.xdata_val),
+                                      (args.xdata.xdata_len), ret,
+                                      op_errno, out);
+
+        ret = 0;
+        resolve_and_resume (frame, server_zerofill_resume);
+
+out:
+        if (args.xdata.xdata_val)
+                free (args.xdata.xdata_val);
+
+        if (op_errno)
+                req->rpc_err = GARBAGE_ARGS;
+
+        return ret;
+}
+
+
+int
+server_seek (rpcsvc_request_t *req)
+{
+        server_state_t    *state = NULL;
+        call_frame_t      *frame = NULL;
+        gfs3_seek_req      args  = {{0,},};
+        int                ret   = -1;
+        int                op_errno = 0;
+
+        if (!req)
+                return ret;
+
+        if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_seek_req)) {
+                //failed to decode msg;
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+        frame = get_frame_from_request (req);
+        if (!frame) {
+                // something wrong, mostly insufficient memory
+                req->rpc_err = GARBAGE_ARGS; /* TODO */
+                goto out;
+        }
+        frame->root->op = GF_FOP_SEEK;
+
+        state = CALL_STATE (frame);
+        if (!state->conn->bound_xl) {
+                /* auth failure, request on subvolume without setvolume */
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+        state->resolve.type   = RESOLVE_MUST;
+        state->resolve.fd_no  = args.fd;
+        state->offset         = args.offset;
+        state->flags          = args.what;
+        memcpy (state->resolve.gfid, args.gfid, 16);
+
+        GF_PROTOCOL_DICT_UNSERIALIZE (state->conn->bound_xl, state->xdata,
+                                      (args.xdata.xdata_val),
+                                      (args.xdata.xdata_len), ret,
+                                      op_errno, out);
+
+        ret = 0;
+        resolve_and_resume (frame, server_seek_resume);
+
+out:
+        if (args.xdata.xdata_val)
+                free (args.xdata.xdata_val);
+
+        if (op_errno)
+                req->rpc_err = GARBAGE_ARGS;
+
+        return ret;
+}
+
+
+int
+server_readlink (rpcsvc_request_t *req)
+{
+        server_state_t    *state                 = NULL;
+        call_frame_t      *frame                 = NULL;
+        gfs3_readlink_req  args                  = {{0,},};
+        int                ret                   = -1;
+        int                op_errno = 0;
+
+        if (!req)
+                return ret;
+
+        if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_readlink_req)) {
+                //failed to decode msg;
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+        frame = get_frame_from_request (req);
+        if (!frame) {
+                // something wrong, mostly insufficient memory
+                req->rpc_err = GARBAGE_ARGS; /* TODO */
+                goto out;
+        }
+        frame->root->op = GF_FOP_READLINK;
+
+        state = CALL_STATE (frame);
+        if (!state->conn->bound_xl) {
+                /* auth failure, request on subvolume without setvolume */
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+        state->resolve.type = RESOLVE_MUST;
+        memcpy (state->resolve.gfid, args.gfid, 16);
+
+        state->size  = args.size;
+
+        GF_PROTOCOL_DICT_UNSERIALIZE (state->conn->bound_xl, state->xdata,
+                                      (args.xdata.xdata_val),
+                                      (args.xdata.xdata_len), ret,
+                                      op_errno, out);
+
+        ret = 0;
+        resolve_and_resume (frame, server_readlink_resume);
+
+out:
+        if (args.xdata.xdata_val)
+                free (args.xdata.xdata_val);
+
+        if (op_errno)
+                req->rpc_err = GARBAGE_ARGS;
+
+        return ret;
+}
+
+
+int
+server_create (rpcsvc_request_t *req)
+{
+        server_state_t  *state    = NULL;
+        call_frame_t    *frame    = NULL;
+        gfs3_create_req  args     = {{0,},};
+        int              ret      = -1;
+        int              op_errno = 0;
+
+        if (!req)
+                return ret;
+
+        args.bname = alloca (req->msg[0].iov_len);
+
+        if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_create_req)) {
+                //failed to decode msg;
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+        frame = get_frame_from_request (req);
+        if (!frame) {
+                // something wrong, mostly insufficient memory
+                req->rpc_err = GARBAGE_ARGS; /* TODO */
+                goto out;
+        }
+        frame->root->op = GF_FOP_CREATE;
+
+        state = CALL_STATE (frame);
+        if (!state->conn->bound_xl) {
+                /* auth failure, request on subvolume without setvolume */
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+
+        state->resolve.bname  = gf_strdup (args.bname);
+        state->mode           = args.mode;
+        state->umask          = args.umask;
+        state->flags          = gf_flags_to_flags (args.flags);
+        memcpy (state->resolve.pargfid, args.pargfid, 16);
+
+        if (state->flags & O_EXCL) {
                 state->resolve.type = RESOLVE_NOT;
         } else {
                 state->resolve.type = RESOLVE_DONTCARE;
@@ -3905,8 +4390,6 @@ server_setxattr (rpcsvc_request_t *req)
         if (!req)
                 return ret;
 
-        args.dict.dict_val = alloca (req->msg[0].iov_len);
-
         if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_setxattr_req)) {
                 //failed to decode msg;
                 req->rpc_err = GARBAGE_ARGS;
@@ -3952,6 +4435,9 @@ server_setxattr (rpcsvc_request_t *req)
 
         return ret;
 out:
+        if (args.dict.dict_val)
+                free (args.dict.dict_val);
+
         if (args.xdata.xdata_val)
                 free (args.xdata.xdata_val);
 
@@ -3979,7 +4465,6 @@ server_fsetxattr (rpcsvc_request_t *req)
         if (!req)
                 return ret;
 
-        args.dict.dict_val = alloca (req->msg[0].iov_len);
         if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_fsetxattr_req)) {
                 //failed to decode msg;
                 req->rpc_err = GARBAGE_ARGS;
@@ -4023,6 +4508,9 @@ server_fsetxattr (rpcsvc_request_t *req)
 
         return ret;
 out:
+        if (args.dict.dict_val)
+                free (args.dict.dict_val);
+
         if (args.xdata.xdata_val)
                 free (args.xdata.xdata_val);
 
@@ -4050,7 +4538,6 @@ server_fxattrop (rpcsvc_request_t *req)
         if (!req)
                 return ret;
 
-        args.dict.dict_val = alloca (req->msg[0].iov_len);
         if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_fxattrop_req)) {
                 //failed to decode msg;
                 req->rpc_err = GARBAGE_ARGS;
@@ -4095,6 +4582,9 @@ server_fxattrop (rpcsvc_request_t *req)
         return ret;
 
 out:
+        if (args.dict.dict_val)
+                free (args.dict.dict_val);
+
         if (args.xdata.xdata_val)
                 free (args.xdata.xdata_val);
 
@@ -4122,8 +4612,6 @@ server_xattrop (rpcsvc_request_t *req)
         if (!req)
                 return ret;
 
-        args.dict.dict_val = alloca (req->msg[0].iov_len);
-
         if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_xattrop_req)) {
                 //failed to decode msg;
                 req->rpc_err = GARBAGE_ARGS;
@@ -4166,6 +4654,9 @@ server_xattrop (rpcsvc_request_t *req)
 
         return ret;
 out:
+        if (args.dict.dict_val)
+                free (args.dict.dict_val);
+
         if (args.xdata.xdata_val)
                 free (args.xdata.xdata_val);
 
@@ -5582,7 +6073,6 @@ server_lookup (rpcsvc_request_t *req)
         GF_VALIDATE_OR_GOTO ("server", req, err);
 
         args.bname           = alloca (req->msg[0].iov_len);
-        args.xdata.xdata_val = alloca (req->msg[0].iov_len);
 
         if (!xdr_to_generic (req->msg[0], &args, (xdrproc_t)xdr_gfs3_lookup_req)) {
                 //failed to decode msg;
@@ -5633,6 +6123,9 @@ out:
                            NULL, NULL);
         ret = 0;
 err:
+        if (args.xdata.xdata_val)
+                free (args.xdata.xdata_val);
+
         return ret;
 }
 
@@ -5687,6 +6180,745 @@ out:
 }
 
 
+/* compound: the fops of the request run one after the other on the same
+   frame and state, the state being wiped before each of them */
+
+typedef struct {
+        rpcsvc_request_t  *req;
+        gfs3_compound_req  args;
+        gfs3_compound_rsp  rsp;
+        int                index;       /* fop running */
+        struct iovec       payload[MAX_IOVEC]; /* data of the write members
+                                                  not handed out yet */
+        int                payload_count;
+        int                payload_index;
+} server_compound_t;
+
+
+static int
+server_compound_next (call_frame_t *frame);
+
+
+/* where the result of a fop goes in the reply, dict is NULL for the fops
+   without one */
+static void
+server_compound_rsp_fields (gfs3_compound_rsp_u *rsp, int **op_ret,
+                            int **op_errno, char ***dict_val,
+                            u_int **dict_len, char ***xdata_val,
+                            u_int **xdata_len)
+{
+        gfs3_xattrop_rsp  *xattrop  = NULL;
+        gfs3_fxattrop_rsp *fxattrop = NULL;
+        gfs3_write_rsp    *wrsp     = NULL;
+        gf_common_rsp     *common   = NULL;
+
+        *dict_val = NULL;
+        *dict_len = NULL;
+
+        switch (rsp->fop) {
+        case GFS3_COMPOUND_WRITE:
+                wrsp = &rsp->gfs3_compound_rsp_u_u.write_rsp;
+                *op_ret = &wrsp->op_ret;
+                *op_errno = &wrsp->op_errno;
+                *xdata_val = &wrsp->xdata.xdata_val;
+                *xdata_len = &wrsp->xdata.xdata_len;
+                return;
+        case GFS3_COMPOUND_XATTROP:
+                xattrop = &rsp->gfs3_compound_rsp_u_u.xattrop_rsp;
+                *op_ret = &xattrop->op_ret;
+                *op_errno = &xattrop->op_errno;
+                *dict_val = &xattrop->dict.dict_val;
+                *dict_len = &xattrop->dict.dict_len;
+                *xdata_val = &xattrop->xdata.xdata_val;
+                *xdata_len = &xattrop->xdata.xdata_len;
+                return;
+        case GFS3_COMPOUND_FXATTROP:
+                fxattrop = &rsp->gfs3_compound_rsp_u_u.fxattrop_rsp;
+                *op_ret = &fxattrop->op_ret;
+                *op_errno = &fxattrop->op_errno;
+                *dict_val = &fxattrop->dict.dict_val;
+                *dict_len = &fxattrop->dict.dict_len;
+                *xdata_val = &fxattrop->xdata.xdata_val;
+                *xdata_len = &fxattrop->xdata.xdata_len;
+                return;
+        case GFS3_COMPOUND_INODELK:
+                common = &rsp->gfs3_compound_rsp_u_u.inodelk_rsp;
+                break;
+        case GFS3_COMPOUND_FINODELK:
+                common = &rsp->gfs3_compound_rsp_u_u.finodelk_rsp;
+                break;
+        case GFS3_COMPOUND_ENTRYLK:
+                common = &rsp->gfs3_compound_rsp_u_u.entrylk_rsp;
+                break;
+        case GFS3_COMPOUND_FENTRYLK:
+                common = &rsp->gfs3_compound_rsp_u_u.fentrylk_rsp;
+                break;
+        case GFS3_COMPOUND_SETXATTR:
+                common = &rsp->gfs3_compound_rsp_u_u.setxattr_rsp;
+                break;
+        case GFS3_COMPOUND_FSETXATTR:
+                common = &rsp->gfs3_compound_rsp_u_u.fsetxattr_rsp;
+                break;
+        }
+
+        *op_ret = &common->op_ret;
+        *op_errno = &common->op_errno;
+        *xdata_val = &common->xdata.xdata_val;
+        *xdata_len = &common->xdata.xdata_len;
+}
+
+
+static void
+server_compound_reply (call_frame_t *frame)
+{
+        server_compound_t *compound  = NULL;
+        int               *op_ret    = NULL;
+        int               *op_errno  = NULL;
+        char             **dict_val  = NULL;
+        u_int             *dict_len  = NULL;
+        char             **xdata_val = NULL;
+        u_int             *xdata_len = NULL;
+        int                i         = 0;
+
+        compound = frame->local;
+
+        server_submit_reply (frame, compound->req, &compound->rsp, NULL, 0,
+                             NULL, (xdrproc_t)xdr_gfs3_compound_rsp);
+
+        for (i = 0; i < compound->rsp.fops.fops_len; i++) {
+                server_compound_rsp_fields (&compound->rsp.fops.fops_val[i],
+                                            &op_ret, &op_errno, &dict_val,
+                                            &dict_len, &xdata_val,
+                                            &xdata_len);
+                if (dict_val && *dict_val)
+                        GF_FREE (*dict_val);
+                if (*xdata_val)
+                        GF_FREE (*xdata_val);
+        }
+
+        GF_FREE (compound->rsp.fops.fops_val);
+        xdr_free ((xdrproc_t)xdr_gfs3_compound_req, (char *)&compound->args);
+        GF_FREE (compound);
+}
+
+
+/* records the result of the running fop, then moves to the next one */
+static int
+server_compound_done (call_frame_t *frame, xlator_t *this, int32_t op_ret,
+                      int32_t op_errno, dict_t *dict, dict_t *xdata)
+{
+        server_compound_t   *compound  = NULL;
+        server_connection_t *conn      = NULL;
+        server_state_t      *state     = NULL;
+        gfs3_compound_rsp_u *rsp       = NULL;
+        int                 *rsp_ret   = NULL;
+        int                 *rsp_errno = NULL;
+        char               **dict_val  = NULL;
+        u_int               *dict_len  = NULL;
+        char               **xdata_val = NULL;
+        u_int               *xdata_len = NULL;
+
+        compound = frame->local;
+        conn = SERVER_CONNECTION (frame);
+        state = CALL_STATE (frame);
+
+        rsp = &compound->rsp.fops.fops_val[compound->index];
+        rsp->fop = compound->args.fops.fops_val[compound->index].fop;
+        server_compound_rsp_fields (rsp, &rsp_ret, &rsp_errno, &dict_val,
+                                    &dict_len, &xdata_val, &xdata_len);
+
+        if (op_ret < 0) {
+                if ((op_errno != ENOSYS) && (op_errno != EAGAIN)) {
+                        gf_log (this->name, GF_LOG_INFO,
+                                "%"PRId64": COMPOUND %d/%u %s %s (%s) ==> "
+                                "(%s)", frame->root->unique,
+                                compound->index + 1,
+                                compound->args.fops.fops_len,
+                                gf_fop_list[frame->root->op],
+                                state->loc.path,
+                                uuid_utoa (state->resolve.gfid),
+                                strerror (op_errno));
+                }
+                goto out;
+        }
+
+        switch (rsp->fop) {
+        case GFS3_COMPOUND_INODELK:
+                if (state->flock.l_type == F_UNLCK)
+                        gf_del_locker (conn, state->volume,
+                                       &state->loc, NULL,
+                                       &frame->root->lk_owner,
+                                       GF_FOP_INODELK);
+                else
+                        gf_add_locker (conn, state->volume,
+                                       &state->loc, NULL, frame->root->pid,
+                                       &frame->root->lk_owner,
+                                       GF_FOP_INODELK);
+                break;
+        case GFS3_COMPOUND_FINODELK:
+                if (state->flock.l_type == F_UNLCK)
+                        gf_del_locker (conn, state->volume,
+                                       NULL, state->fd,
+                                       &frame->root->lk_owner,
+                                       GF_FOP_INODELK);
+                else
+                        gf_add_locker (conn, state->volume,
+                                       NULL, state->fd, frame->root->pid,
+                                       &frame->root->lk_owner,
+                                       GF_FOP_INODELK);
+                break;
+        case GFS3_COMPOUND_ENTRYLK:
+                if (state->cmd == ENTRYLK_UNLOCK)
+                        gf_del_locker (conn, state->volume,
+                                       &state->loc, NULL,
+                                       &frame->root->lk_owner,
+                                       GF_FOP_ENTRYLK);
+                else
+                        gf_add_locker (conn, state->volume,
+                                       &state->loc, NULL, frame->root->pid,
+                                       &frame->root->lk_owner,
+                                       GF_FOP_ENTRYLK);
+                break;
+        case GFS3_COMPOUND_FENTRYLK:
+                if (state->cmd == ENTRYLK_UNLOCK)
+                        gf_del_locker (conn, state->volume,
+                                       NULL, state->fd,
+                                       &frame->root->lk_owner,
+                                       GF_FOP_ENTRYLK);
+                else
+                        gf_add_locker (conn, state->volume,
+                                       NULL, state->fd, frame->root->pid,
+                                       &frame->root->lk_owner,
+                                       GF_FOP_ENTRYLK);
+                break;
+        default:
+                break;
+        }
+
+        if (dict_val) {
+                GF_PROTOCOL_DICT_SERIALIZE (this, dict, dict_val, *dict_len,
+                                            op_errno, fail);
+        }
+
+        GF_PROTOCOL_DICT_SERIALIZE (this, xdata, xdata_val, *xdata_len,
+                                    op_errno, fail);
+
+        goto out;
+fail:
+        op_ret = -1;
+out:
+        *rsp_ret = op_ret;
+        *rsp_errno = gf_errno_to_error (op_errno);
+
+        compound->rsp.op_ret = op_ret;
+        compound->rsp.op_errno = gf_errno_to_error (op_errno);
+        compound->rsp.fops.fops_len = ++compound->index;
+
+        if ((op_ret < 0) && !(compound->args.flags & GF_COMPOUND_CONTINUE))
+                server_compound_reply (frame);
+        else
+                server_compound_next (frame);
+
+        return 0;
+}
+
+
+static int
+server_compound_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                     int32_t op_ret, int32_t op_errno, dict_t *xdata)
+{
+        return server_compound_done (frame, this, op_ret, op_errno, NULL,
+                                     xdata);
+}
+
+
+static int
+server_compound_xattrop_cbk (call_frame_t *frame, void *cookie,
+                             xlator_t *this, int32_t op_ret, int32_t op_errno,
+                             dict_t *dict, dict_t *xdata)
+{
+        return server_compound_done (frame, this, op_ret, op_errno, dict,
+                                     xdata);
+}
+
+
+static int
+server_compound_writev_cbk (call_frame_t *frame, void *cookie, xlator_t *this,
+                            int32_t op_ret, int32_t op_errno,
+                            struct iatt *prebuf, struct iatt *postbuf,
+                            dict_t *xdata)
+{
+        server_compound_t *compound = NULL;
+        gfs3_write_rsp    *rsp      = NULL;
+
+        compound = frame->local;
+        rsp = &compound->rsp.fops.fops_val[compound->index]
+                .gfs3_compound_rsp_u_u.write_rsp;
+
+        if (op_ret >= 0) {
+                gf_stat_from_iatt (&rsp->prestat, prebuf);
+                gf_stat_from_iatt (&rsp->poststat, postbuf);
+        }
+
+        return server_compound_done (frame, this, op_ret, op_errno, NULL,
+                                     xdata);
+}
+
+
+static int
+server_compound_resume (call_frame_t *frame, xlator_t *bound_xl)
+{
+        server_compound_t *compound = NULL;
+        server_state_t    *state    = NULL;
+
+        compound = frame->local;
+        state = CALL_STATE (frame);
+
+        if (state->resolve.op_ret != 0)
+                goto err;
+
+        switch (compound->args.fops.fops_val[compound->index].fop) {
+        case GFS3_COMPOUND_INODELK:
+                STACK_WIND (frame, server_compound_cbk, bound_xl,
+                            bound_xl->fops->inodelk, state->volume,
+                            &state->loc, state->cmd, &state->flock,
+                            state->xdata);
+                break;
+        case GFS3_COMPOUND_FINODELK:
+                STACK_WIND (frame, server_compound_cbk, bound_xl,
+                            bound_xl->fops->finodelk, state->volume,
+                            state->fd, state->cmd, &state->flock,
+                            state->xdata);
+                break;
+        case GFS3_COMPOUND_ENTRYLK:
+                STACK_WIND (frame, server_compound_cbk, bound_xl,
+                            bound_xl->fops->entrylk, state->volume,
+                            &state->loc, state->name, state->cmd,
+                            state->type, state->xdata);
+                break;
+        case GFS3_COMPOUND_FENTRYLK:
+                STACK_WIND (frame, server_compound_cbk, bound_xl,
+                            bound_xl->fops->fentrylk, state->volume,
+                            state->fd, state->name, state->cmd,
+                            state->type, state->xdata);
+                break;
+        case GFS3_COMPOUND_XATTROP:
+                STACK_WIND (frame, server_compound_xattrop_cbk, bound_xl,
+                            bound_xl->fops->xattrop, &state->loc,
+                            state->flags, state->dict, state->xdata);
+                break;
+        case GFS3_COMPOUND_FXATTROP:
+                STACK_WIND (frame, server_compound_xattrop_cbk, bound_xl,
+                            bound_xl->fops->fxattrop, state->fd,
+                            state->flags, state->dict, state->xdata);
+                break;
+        case GFS3_COMPOUND_SETXATTR:
+                STACK_WIND (frame, server_compound_cbk, bound_xl,
+                            bound_xl->fops->setxattr, &state->loc,
+                            state->dict, state->flags, state->xdata);
+                break;
+        case GFS3_COMPOUND_FSETXATTR:
+                STACK_WIND (frame, server_compound_cbk, bound_xl,
+                            bound_xl->fops->fsetxattr, state->fd,
+                            state->dict, state->flags, state->xdata);
+                break;
+        case GFS3_COMPOUND_WRITE:
+                STACK_WIND (frame, server_compound_writev_cbk, bound_xl,
+                            bound_xl->fops->writev, state->fd,
+                            state->payload_vector, state->payload_count,
+                            state->offset, state->flags, state->iobref,
+                            state->xdata);
+                break;
+        }
+
+        return 0;
+err:
+        server_compound_done (frame, frame->this, state->resolve.op_ret,
+                              state->resolve.op_errno, NULL, NULL);
+        return 0;
+}
+
+
+static void
+server_compound_lk_state (server_state_t *state, int cmd, int type,
+                          gf_proto_flock *flock)
+{
+        switch (cmd) {
+        case GF_LK_GETLK:
+                state->cmd = F_GETLK;
+                break;
+        case GF_LK_SETLK:
+                state->cmd = F_SETLK;
+                break;
+        case GF_LK_SETLKW:
+                state->cmd = F_SETLKW;
+                break;
+        }
+
+        state->type = type;
+
+        gf_proto_flock_to_flock (flock, &state->flock);
+
+        switch (state->type) {
+        case GF_LK_F_RDLCK:
+                state->flock.l_type = F_RDLCK;
+                break;
+        case GF_LK_F_WRLCK:
+                state->flock.l_type = F_WRLCK;
+                break;
+        case GF_LK_F_UNLCK:
+                state->flock.l_type = F_UNLCK;
+                break;
+        }
+}
+
+
+/* hands the next @size bytes of data over to the write member about to
+   run, returns an errno */
+static int
+server_compound_take_payload (server_compound_t *compound,
+                              server_state_t *state, size_t size)
+{
+        struct iovec *iov = NULL;
+        size_t        len = 0;
+
+        state->payload_count = 0;
+        state->size = 0;
+
+        while (size) {
+                if ((compound->payload_index == compound->payload_count) ||
+                    (state->payload_count == MAX_IOVEC))
+                        return EINVAL;
+
+                iov = &compound->payload[compound->payload_index];
+                len = min (iov->iov_len, size);
+
+                state->payload_vector[state->payload_count].iov_base =
+                        iov->iov_base;
+                state->payload_vector[state->payload_count].iov_len = len;
+                state->payload_count++;
+                state->size += len;
+
+                iov->iov_base += len;
+                iov->iov_len -= len;
+                if (!iov->iov_len)
+                        compound->payload_index++;
+
+                size -= len;
+        }
+
+        state->iobref = iobref_ref (compound->req->iobref);
+
+        return 0;
+}
+
+
+/* sets up the state as the decoder of the fop on its own would, returns an
+   errno */
+static int
+server_compound_fill_state (call_frame_t *frame, gfs3_compound_req_u *fop)
+{
+        server_compound_t  *compound  = NULL;
+        server_state_t     *state     = NULL;
+        xlator_t           *bound_xl  = NULL;
+        gfs3_inodelk_req   *inodelk   = NULL;
+        gfs3_finodelk_req  *finodelk  = NULL;
+        gfs3_entrylk_req   *entrylk   = NULL;
+        gfs3_fentrylk_req  *fentrylk  = NULL;
+        gfs3_xattrop_req   *xattrop   = NULL;
+        gfs3_fxattrop_req  *fxattrop  = NULL;
+        gfs3_setxattr_req  *setxattr  = NULL;
+        gfs3_fsetxattr_req *fsetxattr = NULL;
+        gfs3_write_req     *wreq      = NULL;
+        char              **dict_val  = NULL;
+        u_int               dict_len  = 0;
+        char              **xdata_val = NULL;
+        u_int               xdata_len = 0;
+        int                 ret       = 0;
+        int                 op_errno  = 0;
+
+        compound = frame->local;
+        state = CALL_STATE (frame);
+        bound_xl = state->conn->bound_xl;
+
+        switch (fop->fop) {
+        case GFS3_COMPOUND_INODELK:
+                inodelk = &fop->gfs3_compound_req_u_u.inodelk_req;
+                frame->root->op = GF_FOP_INODELK;
+                state->resolve.type = RESOLVE_EXACT;
+                memcpy (state->resolve.gfid, inodelk->gfid, 16);
+                state->volume = gf_strdup (inodelk->volume);
+                server_compound_lk_state (state, inodelk->cmd, inodelk->type,
+                                          &inodelk->flock);
+                xdata_val = &inodelk->xdata.xdata_val;
+                xdata_len = inodelk->xdata.xdata_len;
+                break;
+
+        case GFS3_COMPOUND_FINODELK:
+                finodelk = &fop->gfs3_compound_req_u_u.finodelk_req;
+                frame->root->op = GF_FOP_FINODELK;
+                state->resolve.type = RESOLVE_EXACT;
+                state->resolve.fd_no = finodelk->fd;
+                memcpy (state->resolve.gfid, finodelk->gfid, 16);
+                state->volume = gf_strdup (finodelk->volume);
+                server_compound_lk_state (state, finodelk->cmd,
+                                          finodelk->type, &finodelk->flock);
+                xdata_val = &finodelk->xdata.xdata_val;
+                xdata_len = finodelk->xdata.xdata_len;
+                break;
+
+        case GFS3_COMPOUND_ENTRYLK:
+                entrylk = &fop->gfs3_compound_req_u_u.entrylk_req;
+                frame->root->op = GF_FOP_ENTRYLK;
+                state->resolve.type = RESOLVE_EXACT;
+                memcpy (state->resolve.gfid, entrylk->gfid, 16);
+                if (entrylk->namelen)
+                        state->name = gf_strdup (entrylk->name);
+                state->volume = gf_strdup (entrylk->volume);
+                state->cmd = entrylk->cmd;
+                state->type = entrylk->type;
+                xdata_val = &entrylk->xdata.xdata_val;
+                xdata_len = entrylk->xdata.xdata_len;
+                break;
+
+        case GFS3_COMPOUND_FENTRYLK:
+                fentrylk = &fop->gfs3_compound_req_u_u.fentrylk_req;
+                frame->root->op = GF_FOP_FENTRYLK;
+                state->resolve.type = RESOLVE_EXACT;
+                state->resolve.fd_no = fentrylk->fd;
+                memcpy (state->resolve.gfid, fentrylk->gfid, 16);
+                if (fentrylk->namelen)
+                        state->name = gf_strdup (fentrylk->name);
+                state->volume = gf_strdup (fentrylk->volume);
+                state->cmd = fentrylk->cmd;
+                state->type = fentrylk->type;
+                xdata_val = &fentrylk->xdata.xdata_val;
+                xdata_len = fentrylk->xdata.xdata_len;
+                break;
+
+        case GFS3_COMPOUND_XATTROP:
+                xattrop = &fop->gfs3_compound_req_u_u.xattrop_req;
+                frame->root->op = GF_FOP_XATTROP;
+                state->resolve.type = RESOLVE_MUST;
+                memcpy (state->resolve.gfid, xattrop->gfid, 16);
+                state->flags = xattrop->flags;
+                dict_val = &xattrop->dict.dict_val;
+                dict_len = xattrop->dict.dict_len;
+                xdata_val = &xattrop->xdata.xdata_val;
+                xdata_len = xattrop->xdata.xdata_len;
+                break;
+
+        case GFS3_COMPOUND_FXATTROP:
+                fxattrop = &fop->gfs3_compound_req_u_u.fxattrop_req;
+                frame->root->op = GF_FOP_FXATTROP;
+                state->resolve.type = RESOLVE_MUST;
+                state->resolve.fd_no = fxattrop->fd;
+                memcpy (state->resolve.gfid, fxattrop->gfid, 16);
+                state->flags = fxattrop->flags;
+                dict_val = &fxattrop->dict.dict_val;
+                dict_len = fxattrop->dict.dict_len;
+                xdata_val = &fxattrop->xdata.xdata_val;
+                xdata_len = fxattrop->xdata.xdata_len;
+                break;
+
+        case GFS3_COMPOUND_SETXATTR:
+                setxattr = &fop->gfs3_compound_req_u_u.setxattr_req;
+                frame->root->op = GF_FOP_SETXATTR;
+                state->resolve.type = RESOLVE_MUST;
+                memcpy (state->resolve.gfid, setxattr->gfid, 16);
+                state->flags = setxattr->flags;
+                dict_val = &setxattr->dict.dict_val;
+                dict_len = setxattr->dict.dict_len;
+                xdata_val = &setxattr->xdata.xdata_val;
+                xdata_len = setxattr->xdata.xdata_len;
+                break;
+
+        case GFS3_COMPOUND_FSETXATTR:
+                fsetxattr = &fop->gfs3_compound_req_u_u.fsetxattr_req;
+                frame->root->op = GF_FOP_FSETXATTR;
+                state->resolve.type = RESOLVE_MUST;
+                state->resolve.fd_no = fsetxattr->fd;
+                memcpy (state->resolve.gfid, fsetxattr->gfid, 16);
+                state->flags = fsetxattr->flags;
+                dict_val = &fsetxattr->dict.dict_val;
+                dict_len = fsetxattr->dict.dict_len;
+                xdata_val = &fsetxattr->xdata.xdata_val;
+                xdata_len = fsetxattr->xdata.xdata_len;
+                break;
+
+        case GFS3_COMPOUND_WRITE:
+                wreq = &fop->gfs3_compound_req_u_u.write_req;
+                frame->root->op = GF_FOP_WRITE;
+                state->resolve.type = RESOLVE_MUST;
+                state->resolve.fd_no = wreq->fd;
+                memcpy (state->resolve.gfid, wreq->gfid, 16);
+                state->offset = wreq->offset;
+                state->flags = wreq->flag;
+                /* first thing, so that the data of the next write
+                   members stays in place whatever happens to this one */
+                op_errno = server_compound_take_payload (compound, state,
+                                                         wreq->size);
+                if (op_errno)
+                        goto out;
+                xdata_val = &wreq->xdata.xdata_val;
+                xdata_len = wreq->xdata.xdata_len;
+                break;
+        }
+
+        if (dict_val) {
+                GF_PROTOCOL_DICT_UNSERIALIZE (bound_xl, state->dict,
+                                              (*dict_val), dict_len, ret,
+                                              op_errno, out);
+        }
+
+        GF_PROTOCOL_DICT_UNSERIALIZE (bound_xl, state->xdata, (*xdata_val),
+                                      xdata_len, ret, op_errno, out);
+
+        /* There can be some commands hidden in key, check and proceed */
+        if (fop->fop == GFS3_COMPOUND_SETXATTR)
+                gf_server_check_setxattr_cmd (frame, state->dict);
+
+out:
+        return op_errno;
+}
+
+
+static int
+server_compound_next (call_frame_t *frame)
+{
+        server_compound_t   *compound = NULL;
+        server_state_t      *state    = NULL;
+        gfs3_compound_req_u *fop      = NULL;
+        int                  op_errno = 0;
+
+        compound = frame->local;
+        state = CALL_STATE (frame);
+
+        if (compound->index == compound->args.fops.fops_len) {
+                server_compound_reply (frame);
+                return 0;
+        }
+
+        server_state_wipe (state);
+
+        fop = &compound->args.fops.fops_val[compound->index];
+        op_errno = server_compound_fill_state (frame, fop);
+        if (op_errno) {
+                server_compound_done (frame, frame->this, -1, op_errno, NULL,
+                                      NULL);
+                return 0;
+        }
+
+        resolve_and_resume (frame, server_compound_resume);
+
+        return 0;
+}
+
+
+int
+server_compound (rpcsvc_request_t *req)
+{
+        server_compound_t   *compound = NULL;
+        server_state_t      *state    = NULL;
+        call_frame_t        *frame    = NULL;
+        gfs3_compound_req_u *fop      = NULL;
+        ssize_t              len      = 0;
+        size_t               size     = 0;
+        size_t               data     = 0;
+        int                  i        = 0;
+        int                  ret      = -1;
+
+        if (!req)
+                return ret;
+
+        compound = GF_CALLOC (1, sizeof (*compound), gf_server_mt_compound_t);
+        if (!compound) {
+                req->rpc_err = GARBAGE_ARGS; /* TODO */
+                goto out;
+        }
+
+        len = xdr_to_generic (req->msg[0], &compound->args,
+                              (xdrproc_t)xdr_gfs3_compound_req);
+        if (len == 0) {
+                //failed to decode msg;
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+        if ((compound->args.fops.fops_len == 0) ||
+            (compound->args.fops.fops_len > GF_COMPOUND_MAX_FOPS)) {
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+        /* the data of the write members follows the record, as it does
+           for a plain write */
+        if (len < req->msg[0].iov_len) {
+                compound->payload[0].iov_base = req->msg[0].iov_base + len;
+                compound->payload[0].iov_len = req->msg[0].iov_len - len;
+                compound->payload_count = 1;
+        }
+
+        for (i = 1; (i < req->count) &&
+                     (compound->payload_count < MAX_IOVEC); i++)
+                compound->payload[compound->payload_count++] = req->msg[i];
+
+        for (i = 0; i < compound->args.fops.fops_len; i++) {
+                fop = &compound->args.fops.fops_val[i];
+                if (fop->fop == GFS3_COMPOUND_WRITE)
+                        size += fop->gfs3_compound_req_u_u.write_req.size;
+        }
+
+        data = iov_length (compound->payload, compound->payload_count);
+        if (size != data) {
+                gf_log ("server", GF_LOG_WARNING, "compound carries %zu "
+                        "bytes of data for %zu bytes of writes", data, size);
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+        compound->rsp.fops.fops_val = GF_CALLOC (compound->args.fops.fops_len,
+                                                 sizeof (gfs3_compound_rsp_u),
+                                                 gf_server_mt_compound_t);
+        if (!compound->rsp.fops.fops_val) {
+                req->rpc_err = GARBAGE_ARGS; /* TODO */
+                goto out;
+        }
+
+        frame = get_frame_from_request (req);
+        if (!frame) {
+                // something wrong, mostly insufficient memory
+                req->rpc_err = GARBAGE_ARGS; /* TODO */
+                goto out;
+        }
+        frame->root->op = GF_FOP_COMPOUND;
+
+        state = CALL_STATE (frame);
+        if (!state->conn->bound_xl) {
+                /* auth failure, request on subvolume without setvolume */
+                req->rpc_err = GARBAGE_ARGS;
+                goto out;
+        }
+
+        compound->req = req;
+        frame->local = compound;
+
+        ret = 0;
+        server_compound_next (frame);
+
+        return ret;
+out:
+        if (compound) {
+                GF_FREE (compound->rsp.fops.fops_val);
+                xdr_free ((xdrproc_t)xdr_gfs3_compound_req,
+                          (char *)&compound->args);
+                GF_FREE (compound);
+        }
+
+        return ret;
+}
+
+
 rpcsvc_actor_t glusterfs3_1_fop_actors[] = {
         [GFS3_OP_NULL]        = { "NULL",       GFS3_OP_NULL, server_null, NULL, NULL, 0},
         [GFS3_OP_STAT]        = { "STAT",       GFS3_OP_STAT, server_stat, NULL, NULL, 0},
@@ -5732,6 +6964,11 @@ rpcsvc_actor_t glusterfs3_1_fop_actors[] = {
         [GFS3_OP_RELEASE]     = { "RELEASE",    GFS3_OP_RELEASE, server_release, NULL, NULL, 0},
         [GFS3_OP_RELEASEDIR]  = { "RELEASEDIR", GFS3_OP_RELEASEDIR, server_releasedir, NULL, NULL, 0},
         [GFS3_OP_FREMOVEXATTR] = { "FREMOVEXATTR", GFS3_OP_FREMOVEXATTR, server_fremovexattr, NULL, NULL, 0},
+        [GFS3_OP_FALLOCATE]   = { "FALLOCATE",  GFS3_OP_FALLOCATE, server_fallocate, NULL, NULL, 0},
+        [GFS3_OP_DISCARD]     = { "DISCARD",    GFS3_OP_DISCARD, server_discard, NULL, NULL, 0},
+        [GFS3_OP_ZEROFILL]    = { "ZEROFILL",   GFS3_OP_ZEROFILL, server_zerofill, NULL, NULL, 0},
+        [GFS3_OP_SEEK]        = { "SEEK",       GFS3_OP_SEEK, server_seek, NULL, NULL, 0},
+        [GFS3_OP_COMPOUND]    = { "COMPOUND",   GFS3_OP_COMPOUND, server_compound, NULL, NULL, 0},
 };
 
 
@@ -0,0 +1,758 @@
+/*
+   Copyright (c) 2012 Gluster, Inc. <http://www.gluster.com>
+   This file is part of GlusterFS.
+
+   GlusterFS is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 3 of the License,
+   or (at your option) any later version.
+
+   GlusterFS is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see
+   <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _CONFIG_H
+#define _CONFIG_H
+#include "config.h"
+#endif
+
+#include "xlator.h"
+#include "glusterfs.h"
+#include "posix.h"
+#include "posix-aio.h"
+
+#ifdef HAVE_LINUX_AIO
+
+#include <sys/syscall.h>
+
+/* libaio is not required, the handful of syscalls are used directly */
+
+static inline int
+sys_io_setup (unsigned nr_events, aio_context_t *ctx)
+{
+        return syscall (__NR_io_setup, nr_events, ctx);
+}
+
+static inline int
+sys_io_destroy (aio_context_t ctx)
+{
+        return syscall (__NR_io_destroy, ctx);
+}
+
+static inline int
+sys_io_submit (aio_context_t ctx, long nr, struct iocb **iocbs)
+{
+        return syscall (__NR_io_submit, ctx, nr, iocbs);
+}
+
+static inline int
+sys_io_getevents (aio_context_t ctx, long min_nr, long nr,
+                  struct io_event *events, struct timespec *timeout)
+{
+        return syscall (__NR_io_getevents, ctx, min_nr, nr, events, timeout);
+}
+
+
+struct posix_aio_cb {
+        struct iocb     iocb;
+        call_frame_t   *frame;
+        xlator_t       *this;
+        fd_t           *fd;
+        int             _fd;
+        glusterfs_fop_t op;
+        off_t           offset;
+        struct iobuf   *iobuf;
+        struct iobref  *iobref;
+        struct iovec   *vector;
+        struct iatt     prebuf;
+        int             flushwrites;
+};
+
+
+static void
+posix_aio_cb_destroy (struct posix_aio_cb *paiocb)
+{
+        if (paiocb->fd)
+                fd_unref (paiocb->fd);
+        if (paiocb->iobuf)
+                iobuf_unref (paiocb->iobuf);
+        if (paiocb->iobref)
+                iobref_unref (paiocb->iobref);
+
+        GF_FREE (paiocb->vector);
+        GF_FREE (paiocb);
+}
+
+
+static struct posix_aio_cb *
+posix_aio_cb_new (call_frame_t *frame, xlator_t *this, fd_t *fd, int _fd,
+                  glusterfs_fop_t op, off_t offset)
+{
+        struct posix_aio_cb *paiocb = NULL;
+
+        paiocb = GF_CALLOC (1, sizeof (*paiocb), gf_posix_mt_paiocb);
+        if (!paiocb)
+                return NULL;
+
+        paiocb->frame  = frame;
+        paiocb->this   = this;
+        paiocb->fd     = fd_ref (fd);
+        paiocb->_fd    = _fd;
+        paiocb->op     = op;
+        paiocb->offset = offset;
+
+        paiocb->iocb.aio_data   = (uint64_t) (unsigned long) paiocb;
+        paiocb->iocb.aio_fildes = _fd;
+
+        return paiocb;
+}
+
+
+/* a request the kernel owned is done with, wake up posix_aio_off if it
+   waits for the last one */
+static void
+posix_aio_put (struct posix_private *priv)
+{
+        pthread_mutex_lock (&priv->aio_lock);
+        {
+                if (--priv->aio_inflight == 0 && priv->aio_draining)
+                        pthread_cond_broadcast (&priv->aio_cond);
+        }
+        pthread_mutex_unlock (&priv->aio_lock);
+}
+
+
+/* returns 0 once the kernel owns the request, -errno otherwise; once
+   posix_aio_off has started nothing new is submitted and the caller
+   falls back to the synchronous path */
+static int
+posix_aio_submit (xlator_t *this, struct posix_aio_cb *paiocb)
+{
+        struct posix_private *priv     = NULL;
+        struct iocb          *iocbs[1] = {NULL, };
+        int                   ret      = -1;
+
+        priv = this->private;
+        iocbs[0] = &paiocb->iocb;
+
+        pthread_mutex_lock (&priv->aio_lock);
+        {
+                if (priv->aio_capable && !priv->aio_draining) {
+                        priv->aio_inflight++;
+                        ret = 0;
+                }
+        }
+        pthread_mutex_unlock (&priv->aio_lock);
+
+        if (ret)
+                return -EAGAIN;
+
+        ret = sys_io_submit (priv->aio_ctx, 1, iocbs);
+        if (ret != 1) {
+                ret = (ret < 0) ? -errno : -EAGAIN;
+                posix_aio_put (priv);
+                return ret;
+        }
+
+        return 0;
+}
+
+
+static int
+posix_aio_is_aligned (off_t offset, size_t size, struct iovec *vector,
+                      int count)
+{
+        int i = 0;
+
+        if ((offset % POSIX_AIO_ALIGN) || (size % POSIX_AIO_ALIGN))
+                return 0;
+
+        for (i = 0; i < count; i++) {
+                if (((unsigned long) vector[i].iov_base % POSIX_AIO_ALIGN) ||
+                    (vector[i].iov_len % POSIX_AIO_ALIGN))
+                        return 0;
+        }
+
+        return 1;
+}
+
+
+static void
+posix_aio_readv_complete (struct posix_aio_cb *paiocb, long res)
+{
+        call_frame_t         *frame    = NULL;
+        xlator_t             *this     = NULL;
+        struct posix_private *priv     = NULL;
+        struct iovec          vec      = {0,};
+        struct iatt           stbuf    = {0,};
+        int                   op_ret   = -1;
+        int                   op_errno = 0;
+        int                   ret      = 0;
+
+        frame = paiocb->frame;
+        this  = paiocb->this;
+        priv  = this->private;
+
+        if (res < 0) {
+                op_errno = -res;
+                gf_log (this->name, GF_LOG_ERROR,
+                        "readv(async) failed fd=%p: %s", paiocb->fd,
+                        strerror (op_errno));
+                goto out;
+        }
+
+        LOCK (&priv->lock);
+        {
+                priv->read_value += res;
+        }
+        UNLOCK (&priv->lock);
+
+        ret = posix_fdstat (this, paiocb->_fd, &stbuf);
+        if (ret == -1) {
+                op_errno = errno;
+                gf_log (this->name, GF_LOG_ERROR,
+                        "fstat failed on fd=%p: %s", paiocb->fd,
+                        strerror (op_errno));
+                goto out;
+        }
+
+        vec.iov_base = paiocb->iobuf->ptr;
+        vec.iov_len  = res;
+
+        /* Hack to notify higher layers of EOF, same as posix_readv */
+        if (stbuf.ia_size == 0)
+                op_errno = ENOENT;
+        else if ((paiocb->offset + vec.iov_len) == stbuf.ia_size)
+                op_errno = ENOENT;
+        else if (paiocb->offset > stbuf.ia_size)
+                op_errno = ENOENT;
+
+        op_ret = vec.iov_len;
+out:
+        STACK_UNWIND_STRICT (readv, frame, op_ret, op_errno, &vec, 1, &stbuf,
+                             paiocb->iobref, NULL);
+
+        posix_aio_cb_destroy (paiocb);
+}
+
+
+int
+posix_aio_readv (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                 size_t size, off_t offset, uint32_t flags, dict_t *xdata)
+{
+        struct posix_fd     *pfd      = NULL;
+        struct posix_aio_cb *paiocb   = NULL;
+        struct iobuf        *iobuf    = NULL;
+        struct iobref       *iobref   = NULL;
+        int                  op_errno = EINVAL;
+        int                  ret      = -1;
+
+        VALIDATE_OR_GOTO (frame, err);
+        VALIDATE_OR_GOTO (this, err);
+        VALIDATE_OR_GOTO (fd, err);
+
+        ret = posix_fd_ctx_get (fd, this, &pfd);
+        if (ret < 0) {
+                op_errno = -ret;
+                gf_log (this->name, GF_LOG_WARNING,
+                        "pfd is NULL from fd=%p", fd);
+                goto err;
+        }
+
+        if (!size)
+                goto sync;
+
+        if ((pfd->flags & O_DIRECT) &&
+            ((offset % POSIX_AIO_ALIGN) || (size % POSIX_AIO_ALIGN)))
+                goto sync;
+
+        iobuf = iobuf_get2 (this->ctx->iobuf_pool, size);
+        if (!iobuf) {
+                op_errno = ENOMEM;
+                goto err;
+        }
+
+        if ((pfd->flags & O_DIRECT) &&
+            ((unsigned long) iobuf->ptr % POSIX_AIO_ALIGN)) {
+                iobuf_unref (iobuf);
+                goto sync;
+        }
+
+        iobref = iobref_new ();
+        if (!iobref) {
+                iobuf_unref (iobuf);
+                op_errno = ENOMEM;
+                goto err;
+        }
+        iobref_add (iobref, iobuf);
+
+        paiocb = posix_aio_cb_new (frame, this, fd, pfd->fd, GF_FOP_READ,
+                                   offset);
+        if (!paiocb) {
+                iobuf_unref (iobuf);
+                iobref_unref (iobref);
+                op_errno = ENOMEM;
+                goto err;
+        }
+        paiocb->iobuf  = iobuf;
+        paiocb->iobref = iobref;
+
+        paiocb->iocb.aio_lio_opcode = IOCB_CMD_PREAD;
+        paiocb->iocb.aio_buf        = (uint64_t) (unsigned long) iobuf->ptr;
+        paiocb->iocb.aio_nbytes     = size;
+        paiocb->iocb.aio_offset     = offset;
+
+        ret = posix_aio_submit (this, paiocb);
+        if (ret < 0) {
+                gf_log (this->name, GF_LOG_DEBUG,
+                        "io_submit() returned %d, falling back to pread",
+                        ret);
+                posix_aio_cb_destroy (paiocb);
+                goto sync;
+        }
+
+        return 0;
+
+sync:
+        return posix_readv (frame, this, fd, size, offset, flags, xdata);
+err:
+        STACK_UNWIND_STRICT (readv, frame, -1, op_errno, NULL, 0, NULL, NULL,
+                             NULL);
+        return 0;
+}
+
+
+static void
+posix_aio_writev_complete (struct posix_aio_cb *paiocb, long res)
+{
+        call_frame_t         *frame    = NULL;
+        xlator_t             *this     = NULL;
+        struct posix_private *priv     = NULL;
+        struct iatt           postbuf  = {0,};
+        int                   op_ret   = -1;
+        int                   op_errno = 0;
+        int                   ret      = 0;
+
+        frame = paiocb->frame;
+        this  = paiocb->this;
+        priv  = this->private;
+
+        if (res < 0) {
+                op_errno = -res;
+                gf_log (this->name, GF_LOG_ERROR,
+                        "writev(async) failed fd=%p: offset %"PRIu64", %s",
+                        paiocb->fd, paiocb->offset, strerror (op_errno));
+                goto out;
+        }
+
+        LOCK (&priv->lock);
+        {
+                priv->write_value += res;
+        }
+        UNLOCK (&priv->lock);
+
+        if (paiocb->flushwrites) {
+                /* NOTE: ignore the error, if one occurs at this point */
+                fsync (paiocb->_fd);
+        }
+
+        ret = posix_fdstat (this, paiocb->_fd, &postbuf);
+        if (ret == -1) {
+                op_errno = errno;
+                gf_log (this->name, GF_LOG_ERROR,
+                        "post-operation fstat failed on fd=%p: %s",
+                        paiocb->fd, strerror (op_errno));
+                goto out;
+        }
+
+        op_ret = res;
+out:
+        STACK_UNWIND_STRICT (writev, frame, op_ret, op_errno, &paiocb->prebuf,
+                             &postbuf, NULL);
+
+        posix_aio_cb_destroy (paiocb);
+}
+
+
+int
+posix_aio_writev (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                  struct iovec *vector, int32_t count, off_t offset,
+                  uint32_t flags, struct iobref *iobref, dict_t *xdata)
+{
+        struct posix_fd     *pfd      = NULL;
+        struct posix_aio_cb *paiocb   = NULL;
+        int                  op_errno = EINVAL;
+        int                  ret      = -1;
+
+        VALIDATE_OR_GOTO (frame, err);
+        VALIDATE_OR_GOTO (this, err);
+        VALIDATE_OR_GOTO (fd, err);
+        VALIDATE_OR_GOTO (vector, err);
+
+        ret = posix_fd_ctx_get (fd, this, &pfd);
+        if (ret < 0) {
+                op_errno = -ret;
+                gf_log (this->name, GF_LOG_WARNING,
+                        "pfd is NULL from fd=%p", fd);
+                goto err;
+        }
+
+        /* unaligned O_DIRECT writes need the bounce buffer of the
+           synchronous path */
+        if ((pfd->flags & O_DIRECT) &&
+            !posix_aio_is_aligned (offset, iov_length (vector, count),
+                                   vector, count))
+                goto sync;
+
+        paiocb = posix_aio_cb_new (frame, this, fd, pfd->fd, GF_FOP_WRITE,
+                                   offset);
+        if (!paiocb) {
+                op_errno = ENOMEM;
+                goto err;
+        }
+
+        /* the caller's vector does not outlive this call, the buffers it
+           points to are kept by the iobref */
+        paiocb->vector = GF_CALLOC (count, sizeof (*vector),
+                                    gf_posix_mt_iovec);
+        if (!paiocb->vector) {
+                op_errno = ENOMEM;
+                goto err;
+        }
+        memcpy (paiocb->vector, vector, count * sizeof (*vector));
+
+        if (iobref)
+                paiocb->iobref = iobref_ref (iobref);
+        paiocb->flushwrites = pfd->flushwrites;
+
+        ret = posix_fdstat (this, pfd->fd, &paiocb->prebuf);
+        if (ret == -1) {
+                op_errno = errno;
+                gf_log (this->name, GF_LOG_ERROR,
+                        "pre-operation fstat failed on fd=%p: %s", fd,
+                        strerror (op_errno));
+                goto err;
+        }
+
+        paiocb->iocb.aio_lio_opcode = IOCB_CMD_PWRITEV;
+        paiocb->iocb.aio_buf        = (uint64_t) (unsigned long) paiocb->vector;
+        paiocb->iocb.aio_nbytes     = count;
+        paiocb->iocb.aio_offset     = offset;
+
+        ret = posix_aio_submit (this, paiocb);
+        if (ret < 0) {
+                gf_log (this->name, GF_LOG_DEBUG,
+                        "io_submit() returned %d, falling back to pwrite",
+                        ret);
+                posix_aio_cb_destroy (paiocb);
+                goto sync;
+        }
+
+        return 0;
+
+sync:
+        return posix_writev (frame, this, fd, vector, count, offset, flags,
+                             iobref, xdata);
+err:
+        STACK_UNWIND_STRICT (writev, frame, -1, op_errno, NULL, NULL, NULL);
+        if (paiocb)
+                posix_aio_cb_destroy (paiocb);
+        return 0;
+}
+
+
+static void
+posix_aio_fsync_complete (struct posix_aio_cb *paiocb, long res)
+{
+        call_frame_t *frame    = NULL;
+        xlator_t     *this     = NULL;
+        struct iatt   postbuf  = {0,};
+        int           op_ret   = -1;
+        int           op_errno = 0;
+        int           ret      = 0;
+
+        frame = paiocb->frame;
+        this  = paiocb->this;
+
+        if (res < 0) {
+                op_errno = -res;
+                gf_log (this->name, GF_LOG_ERROR,
+                        "fsync(async) on fd=%p failed: %s", paiocb->fd,
+                        strerror (op_errno));
+                goto out;
+        }
+
+        ret = posix_fdstat (this, paiocb->_fd, &postbuf);
+        if (ret == -1) {
+                op_errno = errno;
+                gf_log (this->name, GF_LOG_WARNING,
+                        "post-operation fstat failed on fd=%p: %s",
+                        paiocb->fd, strerror (op_errno));
+                goto out;
+        }
+
+        op_ret = 0;
+out:
+        STACK_UNWIND_STRICT (fsync, frame, op_ret, op_errno, &paiocb->prebuf,
+                             &postbuf, NULL);
+
+        posix_aio_cb_destroy (paiocb);
+}
+
+
+int
+posix_aio_fsync (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                 int32_t datasync, dict_t *xdata)
+{
+        struct posix_fd     *pfd      = NULL;
+        struct posix_aio_cb *paiocb   = NULL;
+        int                  op_errno = EINVAL;
+        int                  ret      = -1;
+
+        VALIDATE_OR_GOTO (frame, err);
+        VALIDATE_OR_GOTO (this, err);
+        VALIDATE_OR_GOTO (fd, err);
+
+        ret = posix_fd_ctx_get (fd, this, &pfd);
+        if (ret < 0) {
+                op_errno = -ret;
+                gf_log (this->name, GF_LOG_WARNING,
+                        "pfd not found in fd's ctx");
+                goto err;
+        }
+
+        paiocb = posix_aio_cb_new (frame, this, fd, pfd->fd, GF_FOP_FSYNC, 0);
+        if (!paiocb) {
+                op_errno = ENOMEM;
+                goto err;
+        }
+
+        ret = posix_fdstat (this, pfd->fd, &paiocb->prebuf);
+        if (ret == -1) {
+                op_errno = errno;
+                gf_log (this->name, GF_LOG_WARNING,
+                        "pre-operation fstat failed on fd=%p: %s", fd,
+                        strerror (op_errno));
+                goto err;
+        }
+
+        paiocb->iocb.aio_lio_opcode = datasync ? IOCB_CMD_FDSYNC :
+                                                 IOCB_CMD_FSYNC;
+
+        /* older kernels and many filesystems reject async fsync with
+           EINVAL, do those inline */
+        ret = posix_aio_submit (this, paiocb);
+        if (ret < 0) {
+                posix_aio_cb_destroy (paiocb);
+                goto sync;
+        }
+
+        return 0;
+
+sync:
+        return posix_fsync (frame, this, fd, datasync, xdata);
+err:
+        STACK_UNWIND_STRICT (fsync, frame, -1, op_errno, NULL, NULL, NULL);
+        if (paiocb)
+                posix_aio_cb_destroy (paiocb);
+        return 0;
+}
+
+
+static void *
+posix_aio_thread (void *data)
+{
+        xlator_t             *this   = NULL;
+        struct posix_private *priv   = NULL;
+        struct posix_aio_cb  *paiocb = NULL;
+        struct io_event       events[POSIX_AIO_MAX_NR_GET];
+        int                   ret    = 0;
+        int                   i      = 0;
+
+        this = data;
+        THIS = this;
+        priv = this->private;
+
+        for (;;) {
+                memset (&events[0], 0, sizeof (events));
+                ret = sys_io_getevents (priv->aio_ctx, 1,
+                                        POSIX_AIO_MAX_NR_GET, &events[0],
+                                        NULL);
+                if (ret <= 0) {
+                        if (ret < 0 && errno == EINTR)
+                                continue;
+                        if (ret < 0 && errno == EINVAL)
+                                /* context went away in posix_aio_off */
+                                break;
+                        gf_log (this->name, GF_LOG_ERROR,
+                                "io_getevents() returned %d", ret);
+                        continue;
+                }
+
+                for (i = 0; i < ret; i++) {
+                        paiocb = (void *) (unsigned long) events[i].data;
+
+                        switch (paiocb->op) {
+                        case GF_FOP_READ:
+                                posix_aio_readv_complete (paiocb,
+                                                          events[i].res);
+                                break;
+                        case GF_FOP_WRITE:
+                                posix_aio_writev_complete (paiocb,
+                                                           events[i].res);
+                                break;
+                        case GF_FOP_FSYNC:
+                                posix_aio_fsync_complete (paiocb,
+                                                          events[i].res);
+                                break;
+                        default:
+                                /* nothing submits other ops, the frame
+                                   cannot be unwound without knowing it */
+                                gf_log (this->name, GF_LOG_ERROR,
+                                        "unknown op %d found in paiocb",
+                                        paiocb->op);
+                                posix_aio_cb_destroy (paiocb);
+                                break;
+                        }
+
+                        posix_aio_put (priv);
+                }
+        }
+
+        return NULL;
+}
+
+
+static int
+posix_aio_init (xlator_t *this)
+{
+        struct posix_private *priv = NULL;
+        int                   ret  = 0;
+
+        priv = this->private;
+
+        ret = sys_io_setup (POSIX_AIO_MAX_NR_EVENTS, &priv->aio_ctx);
+        if (ret == -1) {
+                if (errno == ENOSYS) {
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "Linux AIO not available at run-time."
+                                " Continuing with synchronous IO");
+                        ret = 0;
+                        goto out;
+                }
+
+                gf_log (this->name, GF_LOG_WARNING,
+                        "io_setup() failed: %s", strerror (errno));
+                goto out;
+        }
+
+        ret = pthread_create (&priv->aio_thread, NULL, posix_aio_thread,
+                              this);
+        if (ret != 0) {
+                sys_io_destroy (priv->aio_ctx);
+                goto out;
+        }
+
+        pthread_mutex_lock (&priv->aio_lock);
+        {
+                priv->aio_capable = _gf_true;
+        }
+        pthread_mutex_unlock (&priv->aio_lock);
+out:
+        return ret;
+}
+
+
+int
+posix_aio_on (xlator_t *this)
+{
+        struct posix_private *priv = NULL;
+        int                   ret  = 0;
+
+        priv = this->private;
+
+        if (!priv->aio_capable)
+                ret = posix_aio_init (this);
+
+        if (!ret && priv->aio_capable) {
+                this->fops->readv  = posix_aio_readv;
+                this->fops->writev = posix_aio_writev;
+                this->fops->fsync  = posix_aio_fsync;
+                gf_log (this->name, GF_LOG_INFO,
+                        "Linux AIO enabled for readv, writev and fsync");
+        }
+
+        return ret;
+}
+
+
+int
+posix_aio_off (xlator_t *this)
+{
+        struct posix_private *priv = NULL;
+
+        priv = this->private;
+
+        this->fops->readv  = posix_readv;
+        this->fops->writev = posix_writev;
+        this->fops->fsync  = posix_fsync;
+
+        if (!priv->aio_capable)
+                return 0;
+
+        /* io_destroy() would cancel or wait for whatever is in flight
+           and throw the completions away, leaving their frames hanging:
+           let the reaper unwind all of them first */
+        pthread_mutex_lock (&priv->aio_lock);
+        {
+                priv->aio_draining = _gf_true;
+                while (priv->aio_inflight)
+                        pthread_cond_wait (&priv->aio_cond, &priv->aio_lock);
+        }
+        pthread_mutex_unlock (&priv->aio_lock);
+
+        /* wakes the reaper up with EINVAL */
+        sys_io_destroy (priv->aio_ctx);
+        pthread_join (priv->aio_thread, NULL);
+
+        pthread_mutex_lock (&priv->aio_lock);
+        {
+                priv->aio_capable = _gf_false;
+                priv->aio_draining = _gf_false;
+        }
+        pthread_mutex_unlock (&priv->aio_lock);
+
+        gf_log (this->name, GF_LOG_INFO,
+                "Linux AIO disabled for readv, writev and fsync");
+
+        return 0;
+}
+
+
+#else /* !HAVE_LINUX_AIO */
+
+int
+posix_aio_on (xlator_t *this)
+{
+        gf_log (this->name, GF_LOG_INFO,
+                "Linux AIO not available at build-time."
+                " Continuing with synchronous IO");
+        return 0;
+}
+
+int
+posix_aio_off (xlator_t *this)
+{
+        gf_log (this->name, GF_LOG_INFO,
+                "Linux AIO not available at build-time."
+                " Continuing with synchronous IO");
+        return 0;
+}
+
+#endif /* !HAVE_LINUX_AIO */
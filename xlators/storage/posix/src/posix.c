@@ -42,6 +42,10 @@
 #include <fcntl.h>
 #endif /* HAVE_LINKAT */
 
+#ifdef HAVE_LINUX_FALLOC_H
+#include <linux/falloc.h>
+#endif /* HAVE_LINUX_FALLOC_H */
+
 #include "glusterfs.h"
 #include "checksum.h"
 #include "dict.h"
@@ -59,6 +63,17 @@
 #include "timer.h"
 #include "glusterfs3-xdr.h"
 #include "hashfn.h"
+#include "posix-aio.h"
+#include <limits.h>
+#include <sys/uio.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/* iovecs __posix_pwritev copies on the stack, larger vectors are
+   copied to the heap */
+#define POSIX_PWRITEV_STACK_IOVS 16
 
 extern char *marker_xattrs[];
 
@@ -1999,14 +2014,61 @@ int32_t
 __posix_pwritev (int fd, struct iovec *vector, int count, off_t offset)
 {
         int32_t         op_ret = 0;
-        int             idx = 0;
         int             retval = 0;
         off_t           internal_off = 0;
+#ifdef HAVE_PWRITEV
+        struct iovec    small_iov[POSIX_PWRITEV_STACK_IOVS];
+        struct iovec   *alloc_iov = NULL;
+        struct iovec   *iov = NULL;
+#else
+        int             idx = 0;
+#endif
 
         if (!vector)
                 return -EFAULT;
 
         internal_off = offset;
+
+#ifdef HAVE_PWRITEV
+        /* work on a copy, a short write means trimming the vector; the
+           count comes from the caller, so only small ones go on the
+           stack */
+        if (count <= POSIX_PWRITEV_STACK_IOVS) {
+                iov = small_iov;
+        } else {
+                alloc_iov = GF_CALLOC (count, sizeof (*iov),
+                                       gf_posix_mt_iovec);
+                if (!alloc_iov)
+                        return -ENOMEM;
+                iov = alloc_iov;
+        }
+        memcpy (iov, vector, count * sizeof (*iov));
+
+        while (count > 0) {
+                retval = pwritev (fd, iov, min (count, IOV_MAX),
+                                  internal_off);
+                if (retval == -1) {
+                        if (errno == EINTR)
+                                continue;
+                        op_ret = -errno;
+                        goto err;
+                }
+                if (retval == 0)
+                        break;
+
+                op_ret += retval;
+                internal_off += retval;
+
+                /* drop the elements that made it, and whatever part of
+                   the next one did */
+                for (; count > 0 && retval >= iov->iov_len; count--, iov++)
+                        retval -= iov->iov_len;
+                if (count > 0) {
+                        iov->iov_base = (char *)iov->iov_base + retval;
+                        iov->iov_len -= retval;
+                }
+        }
+#else
         for (idx = 0; idx < count; idx++) {
                 retval = pwrite (fd, vector[idx].iov_base, vector[idx].iov_len,
                                  internal_off);
@@ -2017,8 +2079,12 @@ __posix_pwritev (int fd, struct iovec *vector, int count, off_t offset)
                 op_ret += retval;
                 internal_off += retval;
         }
+#endif
 
 err:
+#ifdef HAVE_PWRITEV
+        GF_FREE (alloc_iov);
+#endif
         return op_ret;
 }
 
@@ -2030,43 +2096,58 @@ __posix_writev (int fd, struct iovec *vector, int count, off_t startoff,
         int32_t         op_ret = 0;
         int             idx = 0;
         int             align = 4096;
-        int             max_buf_size = 0;
+        size_t          total_size = 0;
+        size_t          copied = 0;
         int             retval = 0;
         char            *buf = NULL;
         char            *alloc_buf = NULL;
-        off_t           internal_off = 0;
+        int             aligned = 1;
 
         /* Check for the O_DIRECT flag during open() */
         if (!odirect)
                 return __posix_pwritev (fd, vector, count, startoff);
 
         for (idx = 0; idx < count; idx++) {
-                if (max_buf_size < vector[idx].iov_len)
-                        max_buf_size = vector[idx].iov_len;
+                total_size += vector[idx].iov_len;
+                if (((unsigned long) vector[idx].iov_base % align) ||
+                    (vector[idx].iov_len % align))
+                        aligned = 0;
         }
 
-        alloc_buf = GF_MALLOC (1 * (max_buf_size + align), gf_posix_mt_char);
+        /* buffers that already satisfy O_DIRECT go straight down */
+        if (aligned)
+                return __posix_pwritev (fd, vector, count, startoff);
+
+        /* otherwise gather everything into one aligned buffer and
+           write it with a single call */
+        alloc_buf = GF_MALLOC (1 * (total_size + align), gf_posix_mt_char);
         if (!alloc_buf) {
                 op_ret = -errno;
                 goto err;
         }
 
-        internal_off = startoff;
-        for (idx = 0; idx < count; idx++) {
-                /* page aligned buffer */
-                buf = GF_ALIGN_BUF (alloc_buf, align);
+        /* page aligned buffer */
+        buf = GF_ALIGN_BUF (alloc_buf, align);
 
-                memcpy (buf, vector[idx].iov_base, vector[idx].iov_len);
+        for (idx = 0; idx < count; idx++) {
+                memcpy (buf + copied, vector[idx].iov_base,
+                        vector[idx].iov_len);
+                copied += vector[idx].iov_len;
+        }
 
-                /* not sure whether writev works on O_DIRECT'd fd */
-                retval = pwrite (fd, buf, vector[idx].iov_len, internal_off);
+        while ((size_t) op_ret < total_size) {
+                retval = pwrite (fd, buf + op_ret, total_size - op_ret,
+                                 startoff + op_ret);
                 if (retval == -1) {
+                        if (errno == EINTR)
+                                continue;
                         op_ret = -errno;
                         goto err;
                 }
+                if (retval == 0)
+                        break;
 
                 op_ret += retval;
-                internal_off += retval;
         }
 
 err:
@@ -3371,6 +3452,304 @@ out:
 }
 
 
+#define GF_POSIX_ZERO_CHUNK (128 * GF_UNIT_KB)
+
+/* zero the range by writing, for backends without FALLOC_FL_ZERO_RANGE */
+static int
+posix_zero_write (int fd, off_t offset, size_t len)
+{
+        char    *zeros = NULL;
+        size_t   chunk = 0;
+        ssize_t  ret   = 0;
+
+        zeros = GF_CALLOC (1, GF_POSIX_ZERO_CHUNK, gf_common_mt_char);
+        if (!zeros) {
+                errno = ENOMEM;
+                return -1;
+        }
+
+        while (len) {
+                chunk = min (len, GF_POSIX_ZERO_CHUNK);
+                ret = pwrite (fd, zeros, chunk, offset);
+                if (ret <= 0) {
+                        if (ret == 0)
+                                errno = EIO;
+                        ret = -1;
+                        break;
+                }
+                offset += ret;
+                len -= ret;
+                ret = 0;
+        }
+
+        GF_FREE (zeros);
+
+        return ret;
+}
+
+
+enum posix_fallocate_op {
+        POSIX_FALLOCATE,
+        POSIX_DISCARD,
+        POSIX_ZEROFILL,
+};
+
+static const char *posix_fallocate_op_names[] = {
+        [POSIX_FALLOCATE] = "fallocate",
+        [POSIX_DISCARD]   = "discard",
+        [POSIX_ZEROFILL]  = "zerofill",
+};
+
+/* common part of fallocate, discard and zerofill: returns 0 or -errno */
+static int
+posix_do_fallocate (xlator_t *this, fd_t *fd, enum posix_fallocate_op op,
+                    int32_t keep_size, off_t offset, size_t len,
+                    struct iatt *preop, struct iatt *postop)
+{
+        struct posix_fd *pfd  = NULL;
+        int              _fd  = -1;
+        int              ret  = -1;
+        int              mode = 0;
+
+        ret = posix_fd_ctx_get (fd, this, &pfd);
+        if (ret < 0) {
+                gf_log (this->name, GF_LOG_WARNING,
+                        "pfd is NULL, fd=%p", fd);
+                return ret;
+        }
+
+        _fd = pfd->fd;
+
+        ret = posix_fdstat (this, _fd, preop);
+        if (ret == -1) {
+                ret = -errno;
+                gf_log (this->name, GF_LOG_ERROR,
+                        "pre-operation fstat failed on fd=%p: %s", fd,
+                        strerror (errno));
+                return ret;
+        }
+
+#ifdef HAVE_FALLOCATE
+        switch (op) {
+        case POSIX_FALLOCATE:
+                mode = keep_size ? FALLOC_FL_KEEP_SIZE : 0;
+                break;
+        case POSIX_DISCARD:
+                mode = FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE;
+                break;
+        case POSIX_ZEROFILL:
+#ifdef FALLOC_FL_ZERO_RANGE
+                mode = FALLOC_FL_ZERO_RANGE;
+                if (keep_size)
+                        mode |= FALLOC_FL_KEEP_SIZE;
+#else
+                mode = -1;
+#endif
+                break;
+        }
+
+        ret = -1;
+        errno = EOPNOTSUPP;
+        if (mode != -1)
+                ret = fallocate (_fd, mode, offset, len);
+#else
+        ret = -1;
+        errno = ENOSYS;
+#endif
+        if (ret == -1 && op == POSIX_ZEROFILL &&
+            (errno == EOPNOTSUPP || errno == ENOSYS)) {
+                /* writing zeroes past EOF would extend the file */
+                if (keep_size)
+                        len = (offset >= preop->ia_size) ? 0 :
+                                min (len, preop->ia_size - offset);
+                ret = len ? posix_zero_write (_fd, offset, len) : 0;
+        }
+
+        if (ret == -1) {
+                ret = -errno;
+                gf_log (this->name, ((errno == EOPNOTSUPP) ? GF_LOG_DEBUG :
+                        GF_LOG_ERROR), "%s failed on fd=%p (%"PRId64", %zu): "
+                        "%s", posix_fallocate_op_names[op], fd, offset, len,
+                        strerror (errno));
+                return ret;
+        }
+
+        ret = posix_fdstat (this, _fd, postop);
+        if (ret == -1) {
+                ret = -errno;
+                gf_log (this->name, GF_LOG_ERROR,
+                        "post-operation fstat failed on fd=%p: %s",
+                        fd, strerror (errno));
+                return ret;
+        }
+
+        return 0;
+}
+
+
+int32_t
+posix_glfallocate (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                   int32_t keep_size, off_t offset, size_t len, dict_t *xdata)
+{
+        int32_t     op_ret   = -1;
+        int32_t     op_errno = 0;
+        struct iatt preop    = {0,};
+        struct iatt postop   = {0,};
+
+        DECLARE_OLD_FS_ID_VAR;
+        SET_FS_ID (frame->root->uid, frame->root->gid);
+
+        VALIDATE_OR_GOTO (frame, out);
+        VALIDATE_OR_GOTO (this, out);
+        VALIDATE_OR_GOTO (fd, out);
+
+        op_ret = posix_do_fallocate (this, fd, POSIX_FALLOCATE, keep_size,
+                                     offset, len, &preop, &postop);
+        if (op_ret < 0) {
+                op_errno = -op_ret;
+                op_ret = -1;
+        }
+
+out:
+        SET_TO_OLD_FS_ID ();
+
+        STACK_UNWIND_STRICT (fallocate, frame, op_ret, op_errno, &preop,
+                             &postop, NULL);
+
+        return 0;
+}
+
+
+int32_t
+posix_discard (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
+               size_t len, dict_t *xdata)
+{
+        int32_t     op_ret   = -1;
+        int32_t     op_errno = 0;
+        struct iatt preop    = {0,};
+        struct iatt postop   = {0,};
+
+        DECLARE_OLD_FS_ID_VAR;
+        SET_FS_ID (frame->root->uid, frame->root->gid);
+
+        VALIDATE_OR_GOTO (frame, out);
+        VALIDATE_OR_GOTO (this, out);
+        VALIDATE_OR_GOTO (fd, out);
+
+        op_ret = posix_do_fallocate (this, fd, POSIX_DISCARD, 0,
+                                     offset, len, &preop, &postop);
+        if (op_ret < 0) {
+                op_errno = -op_ret;
+                op_ret = -1;
+        }
+
+out:
+        SET_TO_OLD_FS_ID ();
+
+        STACK_UNWIND_STRICT (discard, frame, op_ret, op_errno, &preop,
+                             &postop, NULL);
+
+        return 0;
+}
+
+
+int32_t
+posix_zerofill (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
+                size_t len, dict_t *xdata)
+{
+        int32_t     op_ret    = -1;
+        int32_t     op_errno  = 0;
+        int32_t     keep_size = 0;
+        struct iatt preop     = {0,};
+        struct iatt postop    = {0,};
+
+        DECLARE_OLD_FS_ID_VAR;
+        SET_FS_ID (frame->root->uid, frame->root->gid);
+
+        VALIDATE_OR_GOTO (frame, out);
+        VALIDATE_OR_GOTO (this, out);
+        VALIDATE_OR_GOTO (fd, out);
+
+        if (xdata && dict_get (xdata, GF_ZEROFILL_KEEP_SIZE_KEY))
+                keep_size = 1;
+
+        op_ret = posix_do_fallocate (this, fd, POSIX_ZEROFILL, keep_size,
+                                     offset, len, &preop, &postop);
+        if (op_ret < 0) {
+                op_errno = -op_ret;
+                op_ret = -1;
+        }
+
+out:
+        SET_TO_OLD_FS_ID ();
+
+        STACK_UNWIND_STRICT (zerofill, frame, op_ret, op_errno, &preop,
+                             &postop, NULL);
+
+        return 0;
+}
+
+
+int32_t
+posix_seek (call_frame_t *frame, xlator_t *this, fd_t *fd, off_t offset,
+            gf_seek_what_t what, dict_t *xdata)
+{
+        struct posix_fd *pfd      = NULL;
+        int32_t          op_ret   = -1;
+        int32_t          op_errno = 0;
+        off_t            found    = 0;
+        int              whence   = 0;
+        int              ret      = -1;
+
+        VALIDATE_OR_GOTO (frame, out);
+        VALIDATE_OR_GOTO (this, out);
+        VALIDATE_OR_GOTO (fd, out);
+
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+        switch (what) {
+        case GF_SEEK_DATA:
+                whence = SEEK_DATA;
+                break;
+        case GF_SEEK_HOLE:
+                whence = SEEK_HOLE;
+                break;
+        default:
+                op_errno = EINVAL;
+                goto out;
+        }
+
+        ret = posix_fd_ctx_get (fd, this, &pfd);
+        if (ret < 0) {
+                op_errno = -ret;
+                gf_log (this->name, GF_LOG_WARNING,
+                        "pfd is NULL, fd=%p", fd);
+                goto out;
+        }
+
+        found = lseek (pfd->fd, offset, whence);
+        if (found == -1) {
+                op_errno = errno;
+                /* ENXIO just means there is nothing more to find */
+                gf_log (this->name, ((errno == ENXIO) ? GF_LOG_TRACE :
+                        GF_LOG_ERROR), "seek (%s) failed on fd=%p at "
+                        "%"PRId64": %s", (what == GF_SEEK_DATA) ? "data" :
+                        "hole", fd, offset, strerror (errno));
+                goto out;
+        }
+
+        op_ret = 0;
+#else
+        op_errno = EINVAL;
+        goto out;
+#endif
+
+out:
+        STACK_UNWIND_STRICT (seek, frame, op_ret, op_errno, found, NULL);
+
+        return 0;
+}
+
+
 int32_t
 posix_fstat (call_frame_t *frame, xlator_t *this,
              fd_t *fd, dict_t *xdata)
@@ -3763,6 +4142,7 @@ posix_priv (xlator_t *this)
         gf_proc_dump_write("max_read","%d", priv->read_value);
         gf_proc_dump_write("max_write","%d", priv->write_value);
         gf_proc_dump_write("nr_files","%ld", priv->nr_files);
+        gf_proc_dump_write("linux_aio","%d", priv->aio_capable);
 
         return 0;
 }
@@ -4115,6 +4495,17 @@ init (xlator_t *this)
                                 "unlinks will be performed in background");
         }
 
+        tmp_data = dict_get (this->options, "linux-aio");
+        if (tmp_data) {
+                if (gf_string2boolean (tmp_data->data,
+                                       &_private->aio_configured) == -1) {
+                        ret = -1;
+                        gf_log (this->name, GF_LOG_ERROR,
+                                "'linux-aio' takes only boolean options");
+                        goto out;
+                }
+        }
+
         tmp_data = dict_get (this->options, "o-direct");
         if (tmp_data) {
                 if (gf_string2boolean (tmp_data->data,
@@ -4214,6 +4605,48 @@ init (xlator_t *this)
         INIT_LIST_HEAD (&_private->janitor_fds);
 
         posix_spawn_janitor_thread (this);
+
+#ifdef HAVE_LINUX_AIO
+        pthread_mutex_init (&_private->aio_lock, NULL);
+        pthread_cond_init (&_private->aio_cond, NULL);
+#endif
+
+        if (_private->aio_configured) {
+                op_ret = posix_aio_on (this);
+                if (op_ret) {
+                        gf_log (this->name, GF_LOG_ERROR,
+                                "Posix AIO init failed");
+                        ret = -1;
+                        goto out;
+                }
+        }
+out:
+        return ret;
+}
+
+int
+reconfigure (xlator_t *this, dict_t *options)
+{
+        struct posix_private *priv = NULL;
+        int                   ret  = -1;
+
+        priv = this->private;
+
+        GF_OPTION_RECONF ("linux-aio", priv->aio_configured, options, bool,
+                          out);
+
+        if (priv->aio_configured && !priv->aio_capable) {
+                /* keep serving synchronously rather than failing the
+                   whole graph */
+                if (posix_aio_on (this))
+                        gf_log (this->name, GF_LOG_WARNING,
+                                "Posix AIO init failed, continuing with "
+                                "synchronous IO");
+        } else if (!priv->aio_configured && priv->aio_capable) {
+                posix_aio_off (this);
+        }
+
+        ret = 0;
 out:
         return ret;
 }
@@ -4224,6 +4657,8 @@ fini (xlator_t *this)
         struct posix_private *priv = this->private;
         if (!priv)
                 return;
+        if (priv->aio_capable)
+                posix_aio_off (this);
         this->private = NULL;
         /*unlock brick dir*/
         if (priv->mount_lock)
@@ -4279,6 +4714,10 @@ struct xlator_fops fops = {
         .fxattrop    = posix_fxattrop,
         .setattr     = posix_setattr,
         .fsetattr    = posix_fsetattr,
+        .fallocate   = posix_glfallocate,
+        .discard     = posix_discard,
+        .zerofill    = posix_zerofill,
+        .seek        = posix_seek,
 };
 
 struct xlator_cbks cbks = {
@@ -4306,5 +4745,10 @@ struct volume_options options[] = {
           .type = GF_OPTION_TYPE_ANY },
         { .key  = {"glusterd-uuid"},
           .type = GF_OPTION_TYPE_STR },
+        { .key  = {"linux-aio"},
+          .type = GF_OPTION_TYPE_BOOL,
+          .default_value = "off",
+          .description = "Submit reads, writes and fsyncs with Linux AIO "
+                         "and complete them from a separate thread"},
         { .key  = {NULL} }
 };
@@ -54,6 +54,10 @@
 #include "posix-mem-types.h"
 #include "posix-handle.h"
 
+#ifdef HAVE_LINUX_AIO
+#include <linux/aio_abi.h>
+#endif
+
 /**
  * posix_fd - internal structure common to file and directory fd's
  */
@@ -124,6 +128,21 @@ struct posix_private {
 /* uuid of glusterd that swapned the brick process */
         uuid_t glusterd_uuid;
 
+/* linux-aio: submit readv/writev/fsync to the kernel and complete them
+   from a reaper thread instead of blocking the calling io-thread */
+        gf_boolean_t    aio_configured;
+        gf_boolean_t    aio_capable;
+#ifdef HAVE_LINUX_AIO
+        aio_context_t   aio_ctx;
+        pthread_t       aio_thread;
+        /* requests the kernel owns; posix_aio_off waits for them to
+           complete before the context goes away */
+        pthread_mutex_t aio_lock;
+        pthread_cond_t  aio_cond;
+        int             aio_inflight;
+        gf_boolean_t    aio_draining;
+#endif
+
 };
 
 #define POSIX_BASE_PATH(this) (((struct posix_private *)this->private)->base_path)
@@ -159,4 +178,13 @@ int posix_fd_ctx_get_off (fd_t *fd, xlator_t *this, struct posix_fd **pfd,
 void posix_fill_ino_from_gfid (xlator_t *this, struct iatt *buf);
 
 gf_boolean_t posix_special_xattr (char **pattern, char *key);
+
+/* synchronous versions, linux-aio falls back to these */
+int posix_readv (call_frame_t *frame, xlator_t *this, fd_t *fd, size_t size,
+                 off_t offset, uint32_t flags, dict_t *xdata);
+int32_t posix_writev (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                      struct iovec *vector, int32_t count, off_t offset,
+                      uint32_t flags, struct iobref *iobref, dict_t *xdata);
+int32_t posix_fsync (call_frame_t *frame, xlator_t *this, fd_t *fd,
+                     int32_t datasync, dict_t *xdata);
 #endif /* _POSIX_H */